@@ -2,7 +2,7 @@
 #
 # PAD processor for Rivendell
 #
-#   (C) Copyright 2018-2023 Fred Gleason <fredg@paravelsystems.com>
+#   (C) Copyright 2018-2023,2026 Fred Gleason <fredg@paravelsystems.com>
 #
 #   This program is free software; you can redistribute it and/or modify
 #   it under the terms of the GNU General Public License version 2 as
@@ -82,6 +82,18 @@ FIELD_EXTERNAL_ANNC_TYPE='externalAnncType'
 #
 PAD_TCP_PORT=34289
 
+#
+# Set by pypad_host when scripts are run inside a shared interpreter
+#
+_host=None
+
+class HostedStart(Exception):
+    """
+       Raised by Receiver.start() when running under pypad_host, to return
+       control to the host once a script has completed its setup.
+    """
+    pass
+
 class Update(object):
     def __init__(self,pad_data,config,rd_config):
         self.__fields=pad_data
@@ -829,6 +841,27 @@ class Receiver(object):
                                    host=creds[2],database=creds[3],
                                    charset='utf8mb4')
 
+    def _accepts(self,jdata):
+        if not self.__active_now_groups and not self.__active_next_groups:
+            return True
+        if jdata['padUpdate'] is None:
+            return False
+        if jdata['padUpdate']['now'] is not None and jdata['padUpdate']['now']['groupName'] in self.__active_now_groups:
+            return True
+        if jdata['padUpdate']['next'] is not None and jdata['padUpdate']['next']['groupName'] in self.__active_next_groups:
+            return True
+        return False
+
+    def _processUpdate(self,jdata,rd_config):
+        if self._accepts(jdata):
+            self.__pypad_Process(Update(jdata,self.__config_parser,rd_config))
+
+    def _processTimer(self):
+        self.__pypad_TimerProcess(self.__config_parser)
+
+    def _timerInterval(self):
+        return self.__timer_interval
+
     def setPadCallback(self,callback):
         """
            Set the processing callback.
@@ -916,6 +949,11 @@ class Receiver(object):
            port - The TCP port to connect to. For most cases, just use
                   'pypad.PAD_TCP_PORT'.
         """
+        # Hand over to the host when sharing an interpreter
+        if _host is not None:
+            _host.register(self,hostname,port)
+            raise HostedStart()
+
         # So we exit cleanly when shutdown by rdpadengined(8)
         signal.signal(signal.SIGTERM,SigHandler)
 
@@ -957,8 +995,7 @@ class Receiver(object):
                     msg+=linebytes
                     if linebytes=='\r\n':
                         jdata=json.loads(msg)
-                        if (not self.__active_now_groups and not self.__active_next_groups) or (jdata['padUpdate'] is not None and jdata['padUpdate']['now'] is not None and jdata['padUpdate']['now']['groupName'] in self.__active_now_groups) or (jdata['padUpdate'] is not None and jdata['padUpdate']['next'] is not None and jdata['padUpdate']['next']['groupName'] in self.__active_next_groups):
-                            self.__pypad_Process(Update(jdata,self.__config_parser,rd_config))
+                        self._processUpdate(jdata,rd_config)
                         msg=""
                     line=bytes()
                 if self.__timer_interval!=None:
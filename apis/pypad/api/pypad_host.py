@@ -0,0 +1,234 @@
+# pypad_host.py
+#
+# Run many PyPAD script instances in a single Python interpreter
+#
+#   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+#
+#   This program is free software; you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License version 2 as
+#   published by the Free Software Foundation.
+#
+#   This program is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public
+#   License along with this program; if not, write to the Free Software
+#   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+#
+
+#
+# Started by rdpadengined(8) as 'python3 -m pypad_host <hostname> <port>'.
+# The host makes a single connection to the PAD service and hands each
+# update to every script instance loaded into it.
+#
+# Instances are controlled by tab-separated lines on standard input:
+#
+#   LOAD <id> <script-path> <config>
+#   UNLOAD <id>
+#
+# The host exits at end of file on standard input. Status is reported by
+# tab-separated lines on standard output:
+#
+#   STARTED <id>
+#   STOPPED <id>
+#   FAILED <id> <exit-code> <error-text>
+#   RUN <id>      (about to call into instance <id>)
+#   IDLE          (all calls have returned)
+#
+# Newlines, tabs and backslashes in <error-text> are escaped as '\n', '\t'
+# and '\\'. Anything written to standard output by a script is sent to
+# standard error instead.
+#
+
+import configparser
+import datetime
+import json
+import os
+import selectors
+import socket
+import sys
+import syslog
+import traceback
+
+import pypad
+
+def eprint(*args,**kwargs):
+    print(*args,file=sys.stderr,**kwargs)
+
+class Instance(object):
+    def __init__(self,id,path,receiver,globs):
+        self.id=id
+        self.path=path
+        self.name=path.split('/')[-1]
+        self.receiver=receiver
+        self.globs=globs
+        self.deadline=None
+        if receiver._timerInterval()!=None:
+            self.deadline=datetime.datetime.now()+datetime.timedelta(seconds=receiver._timerInterval())
+
+
+class Host(object):
+    def __init__(self,hostname,port):
+        self.__hostname=hostname
+        self.__port=port
+        self.__instances={}
+        self.__registered=None
+        self.__control=bytes()
+        self.__pad=bytes()
+        self.__rd_config=configparser.ConfigParser(interpolation=None)
+        self.__rd_config.read_file(open('/etc/rd.conf'))
+        self.__facility=int(self.__rd_config.get('Identity','SyslogFacility',fallback=syslog.LOG_USER))
+
+        # Keep the real standard output for status reports
+        self.__status=os.fdopen(os.dup(1),'w')
+        os.dup2(2,1)
+        sys.stdout=sys.stderr
+
+    def register(self,receiver,hostname,port):
+        """
+           Called by pypad.Receiver.start() in place of connecting.
+        """
+        self.__registered=receiver
+
+    def load(self,id,path,config):
+        if id in self.__instances:
+            return
+        self.__registered=None
+        globs={'__name__': '__main__','__file__': path,
+               '__builtins__': __builtins__}
+        argv=sys.argv
+        sys.argv=[path,self.__hostname,str(self.__port),config]
+        self.__send('RUN',str(id))
+        self.__openlog(path.split('/')[-1])
+        try:
+            f=open(path)
+            code=compile(f.read(),path,'exec')
+            f.close()
+            exec(code,globs)
+        except pypad.HostedStart:
+            pass
+        except BaseException as e:
+            self.__fail(id,e)
+            return
+        finally:
+            sys.argv=argv
+            self.__send('IDLE')
+        if self.__registered is None:
+            self.__send('FAILED',str(id),'1',
+                        self.__escape('script did not call pypad.Receiver.start()'))
+            return
+        self.__instances[id]=Instance(id,path,self.__registered,globs)
+        self.__registered=None
+        self.__send('STARTED',str(id))
+
+    def unload(self,id):
+        if id in self.__instances:
+            del self.__instances[id]
+        self.__send('STOPPED',str(id))
+
+    def run(self):
+        sock=socket.socket(socket.AF_INET)
+        try:
+            sock.connect((self.__hostname,self.__port))
+        except OSError as e:
+            eprint('pypad_host: unable to connect to PAD service ['+str(e)+']')
+            sys.exit(1)
+        sel=selectors.DefaultSelector()
+        sel.register(sys.stdin.fileno(),selectors.EVENT_READ)
+        sel.register(sock,selectors.EVENT_READ)
+
+        while 1<2:
+            for key,mask in sel.select(self.__timeout()):
+                if key.fileobj==sock:
+                    data=sock.recv(65536)
+                    if len(data)==0:
+                        eprint('pypad_host: lost connection to PAD service')
+                        sys.exit(1)
+                    self.__pad+=data
+                    while self.__pad.find(b'\r\n\r\n')>=0:
+                        msg,self.__pad=self.__pad.split(b'\r\n\r\n',1)
+                        self.__dispatch(msg)
+                else:
+                    data=os.read(sys.stdin.fileno(),4096)
+                    if len(data)==0:
+                        sys.exit(0)
+                    self.__control+=data
+                    while self.__control.find(b'\n')>=0:
+                        line,self.__control=self.__control.split(b'\n',1)
+                        self.__command(line.decode('utf-8').split('\t'))
+            self.__runTimers()
+
+    def __command(self,fields):
+        if (fields[0]=='LOAD') and (len(fields)==4):
+            self.load(int(fields[1]),fields[2],fields[3])
+        if (fields[0]=='UNLOAD') and (len(fields)==2):
+            self.unload(int(fields[1]))
+
+    def __dispatch(self,msg):
+        jdata=json.loads(msg.decode('utf-8','replace'))
+        for inst in list(self.__instances.values()):
+            self.__call(inst,inst.receiver._processUpdate,jdata,
+                        self.__rd_config)
+        self.__send('IDLE')
+
+    def __runTimers(self):
+        now=datetime.datetime.now()
+        called=False
+        for inst in list(self.__instances.values()):
+            if (inst.deadline!=None) and (now>=inst.deadline):
+                inst.deadline=now+datetime.timedelta(seconds=inst.receiver._timerInterval())
+                self.__call(inst,inst.receiver._processTimer)
+                called=True
+        if called:
+            self.__send('IDLE')
+
+    def __timeout(self):
+        ret=None
+        now=datetime.datetime.now()
+        for inst in self.__instances.values():
+            if inst.deadline!=None:
+                secs=max(0.0,(inst.deadline-now).total_seconds())
+                if (ret is None) or (secs<ret):
+                    ret=secs
+        return ret
+
+    def __call(self,inst,func,*args):
+        self.__send('RUN',str(inst.id))
+        self.__openlog(inst.name)
+        try:
+            func(*args)
+        except BaseException as e:
+            self.__fail(inst.id,e)
+
+    def __fail(self,id,e):
+        code=1
+        if isinstance(e,SystemExit):
+            if e.code is None:
+                code=0
+            if isinstance(e.code,int):
+                code=e.code
+        if id in self.__instances:
+            del self.__instances[id]
+        self.__send('FAILED',str(id),str(code),
+                    self.__escape(''.join(traceback.format_exception(type(e),e,e.__traceback__))))
+
+    def __openlog(self,name):
+        syslog.openlog(name,logoption=syslog.LOG_PID,facility=self.__facility)
+
+    def __escape(self,string):
+        return string.replace('\\','\\\\').replace('\n','\\n').replace('\t','\\t')
+
+    def __send(self,*fields):
+        self.__status.write('\t'.join(fields)+'\n')
+        self.__status.flush()
+
+
+if __name__=='__main__':
+    if len(sys.argv)!=3:
+        eprint('pypad_host.py: USAGE: python3 -m pypad_host <hostname> <port>')
+        sys.exit(1)
+    host=Host(sys.argv[1],int(sys.argv[2]))
+    pypad._host=host
+    host.run()
@@ -2,7 +2,7 @@
 //
 // The Core Audio Engine component of Rivendell
 //
-//   (C) Copyright 2002-2019 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2019,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -124,6 +124,9 @@ MainObject::MainObject(QObject *parent,const char *name)
     play_handle[i].owner=-1;
   }
   next_play_handle=0;
+  batch_active=false;
+  batch_delay=0;
+  batch_serial=0;
 
   for(int i=0;i<RD_MAX_CARDS;i++) {
     cae_driver[i]=RDStation::None;
@@ -168,6 +171,10 @@ MainObject::MainObject(QObject *parent,const char *name)
 	  this,SLOT(playData(int,unsigned,unsigned,unsigned,unsigned)));
   connect(cae_server,SIGNAL(stopPlaybackReq(int,unsigned)),
 	  this,SLOT(stopPlaybackData(int,unsigned)));
+  connect(cae_server,SIGNAL(playMarkerReq(int,unsigned,int,unsigned)),
+	  this,SLOT(playMarkerData(int,unsigned,int,unsigned)));
+  connect(cae_server,SIGNAL(clearPlayMarkersReq(int,unsigned)),
+	  this,SLOT(clearPlayMarkersData(int,unsigned)));
   connect(cae_server,SIGNAL(timescalingSupportReq(int,unsigned)),
 	  this,SLOT(timescalingSupportData(int,unsigned)));
   connect(cae_server,
@@ -226,6 +233,10 @@ MainObject::MainObject(QObject *parent,const char *name)
 	  SIGNAL(meterEnableReq(int,uint16_t,const QList<unsigned> &)),
 	  this,
 	  SLOT(meterEnableData(int,uint16_t,const QList<unsigned> &)));
+  connect(cae_server,SIGNAL(beginBatchReq(int,unsigned)),
+	  this,SLOT(beginBatchData(int,unsigned)));
+  connect(cae_server,SIGNAL(endBatchReq(int)),
+	  this,SLOT(endBatchData(int)));
 
   signal(SIGHUP,SigHandler);
   signal(SIGINT,SigHandler);
@@ -290,6 +301,12 @@ MainObject::MainObject(QObject *parent,const char *name)
   connect(timer,SIGNAL(timeout()),this,SLOT(updateMeters()));
   timer->start(RD_METER_UPDATE_INTERVAL);
 
+  //
+  // Play Marker Timer
+  //
+  marker_timer=new QTimer(this);
+  connect(marker_timer,SIGNAL(timeout()),this,SLOT(markerTimerData()));
+
   //
   // Initialize Thread Priorities
   //
@@ -512,6 +529,7 @@ void MainObject::unloadPlaybackData(int id,unsigned handle)
       cae_server->sendCommand(id,QString().sprintf("UP %d -!",handle));
       return;
     }
+    ClearPlayMarkers(card,stream);
     play_handle[handle].card=-1;
     play_handle[handle].stream=-1;
     play_handle[handle].owner=-1;
@@ -693,6 +711,111 @@ void MainObject::stopPlaybackData(int id,unsigned handle)
 }
 
 
+void MainObject::playMarkerData(int id,unsigned handle,int marker,
+				unsigned pos)
+{
+  int card=-1;
+  int stream=-1;
+  int count=0;
+  PlayMarker m;
+
+  if(handle<256) {
+    card=play_handle[handle].card;
+    stream=play_handle[handle].stream;
+  }
+  if((card<0)||(stream<0)||(play_owner[card][stream]!=id)) {
+    cae_server->sendCommand(id,QString().sprintf("MK %u %d %u -!",
+						 handle,marker,pos));
+    return;
+  }
+
+  //
+  // A marker replaces any earlier one with the same ID on the stream
+  //
+  for(int i=play_markers.size()-1;i>=0;i--) {
+    if(play_markers.at(i).handle==handle) {
+      if(play_markers.at(i).id==marker) {
+	play_markers.removeAt(i);
+      }
+      else {
+	count++;
+      }
+    }
+  }
+  if(count>=CAE_MAX_PLAY_MARKERS) {
+    cae_server->sendCommand(id,QString().sprintf("MK %u %d %u -!",
+						 handle,marker,pos));
+    return;
+  }
+
+  //
+  // Kept in order of position, so that markers reached together are
+  // reported in the order they occur in the audio
+  //
+  m.handle=handle;
+  m.card=card;
+  m.stream=stream;
+  m.owner=id;
+  m.id=marker;
+  m.pos=pos;
+  int index=0;
+  while((index<play_markers.size())&&(play_markers.at(index).pos<=pos)) {
+    index++;
+  }
+  play_markers.insert(index,m);
+  if(!marker_timer->isActive()) {
+    marker_timer->start(CAE_MARKER_INTERVAL);
+  }
+}
+
+
+void MainObject::clearPlayMarkersData(int id,unsigned handle)
+{
+  for(int i=play_markers.size()-1;i>=0;i--) {
+    if((play_markers.at(i).handle==handle)&&
+       (play_markers.at(i).owner==id)) {
+      play_markers.removeAt(i);
+    }
+  }
+  cae_server->sendCommand(id,QString().sprintf("MC %u +!",handle));
+}
+
+
+void MainObject::markerTimerData()
+{
+  unsigned positions[RD_MAX_CARDS][RD_MAX_STREAMS];
+  bool scanned[RD_MAX_CARDS];
+
+  //
+  // Positions come from the sample counts kept by the drivers, so a
+  // marker is reported within one timer interval of the audio actually
+  // reaching it, whatever the state of the client's event loop.
+  //
+  for(int i=0;i<RD_MAX_CARDS;i++) {
+    scanned[i]=false;
+  }
+  int i=0;
+  while(i<play_markers.size()) {
+    const PlayMarker &m=play_markers.at(i);
+    if(!scanned[m.card]) {
+      GetOutputPosition(m.card,positions[m.card]);
+      scanned[m.card]=true;
+    }
+    if(positions[m.card][m.stream]>=m.pos) {
+      cae_server->sendCommand(m.owner,QString().sprintf("MK %u %d %u %u!",
+			     m.handle,m.id,m.pos,positions[m.card][m.stream]));
+      play_markers.removeAt(i);
+    }
+    else {
+      i++;
+    }
+  }
+  if(play_markers.size()==0) {
+    marker_timer->stop();
+  }
+}
+
+
 void MainObject::timescalingSupportData(int id,unsigned card)
 {
   bool state=false;
@@ -797,6 +920,9 @@ void MainObject::unloadRecordingData(int id,unsigned card,unsigned stream)
 {
   if((record_owner[card][stream]==-1)||(record_owner[card][stream]==id)) {
     unsigned len=0;
+    int peak=0;
+    int loudness=0;
+    bool analyzed=false;
     switch(cae_driver[card]) {
     case RDStation::Hpi:
       if(!hpiUnloadRecord(card,stream,&len)) {
@@ -806,10 +932,11 @@ void MainObject::unloadRecordingData(int id,unsigned card,unsigned stream)
       break;
 
     case RDStation::Alsa:
-      if(!alsaUnloadRecord(card,stream,&len)) {
+      if(!alsaUnloadRecord(card,stream,&len,&peak,&loudness)) {
 	cae_server->sendCommand(id,QString().sprintf("UR %u %u -!",card,stream));
 	return;
       }
+      analyzed=true;
       break;
 
     case RDStation::Jack:
@@ -824,6 +951,18 @@ void MainObject::unloadRecordingData(int id,unsigned card,unsigned stream)
       return;
     }
     record_owner[card][stream]=-1;
+    if(analyzed) {
+      RDApplication::syslog(rd_config,LOG_INFO,
+			    "UnloadRecord - Card: %d  Stream: %d, Length: %u, "
+			    "Peak: %5.2lf dBFS, Loudness: %5.2lf LUFS",
+			    card,stream,len,(double)peak/100.0,
+			    (double)loudness/100.0);
+      cae_server->
+	sendCommand(id,QString().sprintf("UR %u %u %u + %d %d!",card,stream,
+		   (unsigned)((double)len*1000.0/(double)system_sample_rate),
+					 peak,loudness));
+      return;
+    }
     RDApplication::syslog(rd_config,LOG_INFO,
 			  "UnloadRecord - Card: %d  Stream: %d, Length: %u",
 	   card,stream,len);
@@ -1441,6 +1580,31 @@ void MainObject::meterEnableData(int id,uint16_t udp_port,
 }
 
 
+void MainObject::beginBatchData(int id,unsigned delay)
+{
+  //
+  // Play requests until the end of the batch are held back and then
+  // released to the drivers together
+  //
+  batch_active=true;
+  batch_delay=delay;
+  if(++batch_serial==0) {
+    batch_serial=1;
+  }
+}
+
+
+void MainObject::endBatchData(int id)
+{
+  //
+  // HPI streams are started as their play requests arrive
+  //
+  alsaStartBatch();
+  jackStartBatch();
+  batch_active=false;
+}
+
+
 void MainObject::connectionDroppedData(int id)
 {
   KillSocket(id);
@@ -1454,6 +1618,10 @@ void MainObject::statePlayUpdate(int card,int stream,int state)
   if(handle<0) {
     return;
   }
+  if(state!=1) {
+    markerTimerData();
+    ClearPlayMarkers(card,stream);
+  }
   if(play_owner[card][stream]!=-1) {
     switch(state) {
 	case 1:   // Playing
@@ -1765,6 +1933,7 @@ void MainObject::KillSocket(int ch)
 	record_owner[i][j]=-1;
       }
       if(play_owner[i][j]==ch) {
+	ClearPlayMarkers(i,j);
 	switch(cae_driver[i]) {
 	    case RDStation::Hpi:
 	      hpiUnloadPlayback(i,j);
@@ -2183,6 +2352,40 @@ void MainObject::SendMeterUpdate(const QString &msg,int conn_id)
 }
 
 
+void MainObject::GetOutputPosition(int card,unsigned pos[])
+{
+  switch(cae_driver[card]) {
+  case RDStation::Hpi:
+    hpiGetOutputPosition(card,pos);
+    break;
+
+  case RDStation::Jack:
+    jackGetOutputPosition(card,pos);
+    break;
+
+  case RDStation::Alsa:
+    alsaGetOutputPosition(card,pos);
+    break;
+
+  case RDStation::None:
+    for(int i=0;i<RD_MAX_STREAMS;i++) {
+      pos[i]=0;
+    }
+    break;
+  }
+}
+
+
+void MainObject::ClearPlayMarkers(int card,int stream)
+{
+  for(int i=play_markers.size()-1;i>=0;i--) {
+    if((play_markers.at(i).card==card)&&(play_markers.at(i).stream==stream)) {
+      play_markers.removeAt(i);
+    }
+  }
+}
+
+
 int main(int argc,char *argv[])
 {
   int rc;
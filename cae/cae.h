@@ -2,7 +2,7 @@
 //
 // The Core Audio Engine component of Rivendell
 //
-//   (C) Copyright 2002-2019 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2019,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -93,6 +93,8 @@ void src_float_to_int_array (const float *in, int *out, int len);
 // Global CAE Definitions
 //
 #define RINGBUFFER_SIZE 262144
+#define CAE_MARKER_INTERVAL 5
+#define CAE_MAX_PLAY_MARKERS 32
 #define CAED_USAGE "[-d]\n\nSupplying the '-d' flag will set 'debug' mode, causing caed(8) to stay\nin the foreground and print debugging info on standard output.\n" 
 
 //
@@ -114,6 +116,9 @@ class MainObject : public QObject
   void playData(int id,unsigned handle,unsigned length,unsigned speed,
 		unsigned pitch_flag);
   void stopPlaybackData(int id,unsigned handle);
+  void playMarkerData(int id,unsigned handle,int marker,unsigned pos);
+  void clearPlayMarkersData(int id,unsigned handle);
+  void markerTimerData();
   void timescalingSupportData(int id,unsigned card);
   void loadRecordingData(int id,unsigned card,unsigned port,unsigned coding,
 			unsigned channels,unsigned samprate,unsigned bitrate,
@@ -143,6 +148,8 @@ class MainObject : public QObject
 				 uint16_t udp_port,unsigned samprate,
 				 unsigned chans);
   void meterEnableData(int id,uint16_t udp_port,const QList<unsigned> &cards);
+  void beginBatchData(int id,unsigned delay);
+  void endBatchData(int id);
   void statePlayUpdate(int card,int stream,int state);
   void stateRecordUpdate(int card,int stream,int state);
   void updateMeters();
@@ -165,6 +172,8 @@ class MainObject : public QObject
   void SendMeterOutputStatusUpdate();
   void SendMeterOutputStatusUpdate(int card,int port,int stream);
   void SendMeterUpdate(const QString &msg,int conn_id);
+  void GetOutputPosition(int card,unsigned pos[]);
+  void ClearPlayMarkers(int card,int stream);
   bool debug;
   unsigned system_sample_rate;
   CaeServer *cae_server;
@@ -186,6 +195,19 @@ class MainObject : public QObject
     int owner;
   } play_handle[256];
   int next_play_handle;
+  struct PlayMarker {
+    unsigned handle;
+    int card;
+    int stream;
+    int owner;
+    int id;
+    unsigned pos;
+  };
+  QList<PlayMarker> play_markers;
+  QTimer *marker_timer;
+  bool batch_active;
+  unsigned batch_delay;
+  unsigned batch_serial;
   RDStation *cae_station;
 
   //
@@ -268,6 +290,7 @@ class MainObject : public QObject
   bool jackGetStreamOutputMeters(int card,int stream,short levels[2]);
   bool jackSetPassthroughLevel(int card,int in_port,int out_port,int level);
   void jackGetOutputPosition(int card,unsigned *pos);
+  void jackStartBatch();
   void jackConnectPorts(const QString &out,const QString &in);
   void jackDisconnectPorts(const QString &out,const QString &in);
   int GetJackOutputStream();
@@ -328,7 +351,8 @@ class MainObject : public QObject
   bool alsaTimescaleSupported(int card);
   bool alsaLoadRecord(int card,int port,int coding,int chans,int samprate,
 		     int bitrate,QString wavename);
-  bool alsaUnloadRecord(int card,int stream,unsigned *len);
+  bool alsaUnloadRecord(int card,int stream,unsigned *len,int *peak,
+			int *loudness);
   bool alsaRecord(int card,int stream,int length,int thres);
   bool alsaStopRecord(int card,int stream);
   bool alsaSetInputVolume(int card,int stream,int level);
@@ -346,6 +370,7 @@ class MainObject : public QObject
   bool alsaGetStreamOutputMeters(int card,int stream,short levels[2]);
   bool alsaSetPassthroughLevel(int card,int in_port,int out_port,int level);
   void alsaGetOutputPosition(int card,unsigned *pos);
+  void alsaStartBatch();
   void AlsaClock();
 #ifdef ALSA
   bool AlsaStartCaptureDevice(QString &dev,int card,snd_pcm_t *pcm);
@@ -353,8 +378,6 @@ class MainObject : public QObject
   void AlsaInitCallback();
   int GetAlsaOutputStream(int card);
   void FreeAlsaOutputStream(int card,int stream);
-  void EmptyAlsaInputStream(int card,int stream);
-  void WriteAlsaBuffer(int card,int stream,short *buffer,unsigned len);
   void FillAlsaOutputStream(int card,int stream);
   struct alsa_format alsa_play_format[RD_MAX_CARDS];
   struct alsa_format alsa_capture_format[RD_MAX_CARDS];
@@ -373,7 +396,6 @@ class MainObject : public QObject
   short alsa_fade_volume_db[RD_MAX_CARDS][RD_MAX_STREAMS];
   short alsa_fade_increment[RD_MAX_CARDS][RD_MAX_STREAMS];
   int alsa_fade_port[RD_MAX_CARDS][RD_MAX_STREAMS];
-  unsigned alsa_samples_recorded[RD_MAX_CARDS][RD_MAX_STREAMS];
 #endif  // ALSA
 
   bool CheckLame();
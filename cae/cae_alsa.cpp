@@ -2,7 +2,7 @@
 //
 // The ALSA Driver for the Core Audio Engine component of Rivendell
 //
-//   (C) Copyright 2002-2019 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2019,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -20,6 +20,7 @@
 
 #include <math.h>
 #include <signal.h>
+#include <time.h>
 
 #include <samplerate.h>
 
@@ -27,6 +28,7 @@
 
 #include <rd.h>
 #include <rdapplication.h>
+#include <rdcapturewriter.h>
 #include <rdmeteraverage.h>
 #include <rdringbuffer.h>
 
@@ -47,7 +49,7 @@ volatile double
   alsa_passthrough_volume[RD_MAX_CARDS][RD_MAX_PORTS][RD_MAX_PORTS];
 volatile double alsa_input_vox[RD_MAX_CARDS][RD_MAX_PORTS];
 RDRingBuffer *alsa_play_ring[RD_MAX_CARDS][RD_MAX_STREAMS];
-RDRingBuffer *alsa_record_ring[RD_MAX_CARDS][RD_MAX_PORTS];
+RDCaptureWriter *alsa_record_writer[RD_MAX_CARDS][RD_MAX_PORTS];
 RDRingBuffer *alsa_passthrough_ring[RD_MAX_CARDS][RD_MAX_PORTS];
 volatile bool alsa_playing[RD_MAX_CARDS][RD_MAX_STREAMS];
 volatile bool alsa_stopping[RD_MAX_CARDS][RD_MAX_STREAMS];
@@ -55,11 +57,51 @@ volatile bool alsa_eof[RD_MAX_CARDS][RD_MAX_STREAMS];
 volatile int alsa_output_pos[RD_MAX_CARDS][RD_MAX_STREAMS];
 volatile bool alsa_recording[RD_MAX_CARDS][RD_MAX_PORTS];
 volatile bool alsa_ready[RD_MAX_CARDS][RD_MAX_PORTS];
+volatile unsigned alsa_start_serial[RD_MAX_CARDS][RD_MAX_STREAMS];
+volatile uint64_t alsa_start_time[RD_MAX_CARDS][RD_MAX_STREAMS];
+volatile unsigned alsa_released_serial;
+
+#ifdef HAVE_TWOLAME
+//
+// Capture writer that encodes MPEG Layer 2 as it goes
+//
+class AlsaMpegWriter : public RDCaptureWriter
+{
+ public:
+  AlsaMpegWriter(RDWaveFile *wave,unsigned chans,twolame_options *opts,
+		 int (*encode)(twolame_options *,const float[],int,
+			       unsigned char *,int),
+		 int (*flush)(twolame_options *,unsigned char *,int))
+    : RDCaptureWriter(wave,RDCaptureWriter::Encoded,chans)
+  {
+    mpeg_opts=opts;
+    mpeg_encode=encode;
+    mpeg_flush=flush;
+  }
+
+ protected:
+  int encodeData(const float *pcm,unsigned frames,unsigned char *data,
+		 int maxlen)
+  {
+    return mpeg_encode(mpeg_opts,pcm,frames,data,maxlen);
+  }
+  int flushEncoder(unsigned char *data,int maxlen)
+  {
+    return mpeg_flush(mpeg_opts,data,maxlen);
+  }
+
+ private:
+  twolame_options *mpeg_opts;
+  int (*mpeg_encode)(twolame_options *,const float[],int,unsigned char *,int);
+  int (*mpeg_flush)(twolame_options *,unsigned char *,int);
+};
+#endif  // HAVE_TWOLAME
 
 void *AlsaCaptureCallback(void *ptr)
 {
-  char alsa_buffer[RINGBUFFER_SIZE];
+  float alsa_buffer[RINGBUFFER_SIZE/sizeof(float)];
   int modulo;
+  double gain;
   int16_t in_meter[RD_MAX_PORTS][2];
   struct alsa_format *alsa_format=(struct alsa_format *)ptr;
 
@@ -84,38 +126,31 @@ void *AlsaCaptureCallback(void *ptr)
 	for(unsigned i=0;i<(alsa_format->channels/2);i++) {
 	  if(alsa_recording[alsa_format->card][i]) {
 	    if(alsa_input_volume[alsa_format->card][i]!=0.0) {
+	      gain=alsa_input_volume[alsa_format->card][i]/32768.0;
 	      switch(alsa_input_channels[alsa_format->card][i]) {
 	      case 1:
-		for(int k=0;k<(2*s);k++) {
-		  ((int16_t *)alsa_buffer)[k]=
-		    (int16_t)(alsa_input_volume[alsa_format->card][i]*
-			      (double)(((int16_t *)alsa_format->
-					card_buffer)
-				       [modulo*k+2*i]))+
-		    (int16_t)(alsa_input_volume[alsa_format->card][i]*
-			      (double)(((int16_t *)alsa_format->
-					card_buffer)
-				       [modulo*k+2*i+1]));
+		for(int k=0;k<s;k++) {
+		  alsa_buffer[k]=gain*
+		    ((double)((int16_t *)alsa_format->card_buffer)
+		     [modulo*k+2*i]+
+		     (double)((int16_t *)alsa_format->card_buffer)
+		     [modulo*k+2*i+1]);
 		}
-		alsa_record_ring[alsa_format->card][i]->
-		  write(alsa_buffer,s*sizeof(int16_t));
+		alsa_record_writer[alsa_format->card][i]->
+		  writeFrames(alsa_buffer,s);
 		break;
 
 	      case 2:
 		for(int k=0;k<s;k++) {
-		  ((int16_t *)alsa_buffer)[2*k]=
-		    (int16_t)(alsa_input_volume[alsa_format->card][i]*
-			      (double)(((int16_t *)alsa_format->
-					card_buffer)
-				       [modulo*k+2*i]));
-		  ((int16_t *)alsa_buffer)[2*k+1]=
-		    (int16_t)(alsa_input_volume[alsa_format->card][i]*
-			      (double)(((int16_t *)alsa_format->
-					card_buffer)
-				       [modulo*k+2*i+1]));
+		  alsa_buffer[2*k]=gain*
+		    (double)((int16_t *)alsa_format->card_buffer)
+		    [modulo*k+2*i];
+		  alsa_buffer[2*k+1]=gain*
+		    (double)((int16_t *)alsa_format->card_buffer)
+		    [modulo*k+2*i+1];
 		}
-		alsa_record_ring[alsa_format->card][i]->
-		  write(alsa_buffer,s*2*sizeof(int16_t));
+		alsa_record_writer[alsa_format->card][i]->
+		  writeFrames(alsa_buffer,s);
 		break;
 	      }
 	    }
@@ -159,40 +194,39 @@ void *AlsaCaptureCallback(void *ptr)
 	break;
 
       case SND_PCM_FORMAT_S32_LE:
-	modulo=alsa_format->channels*2;
+	modulo=alsa_format->channels;
 	for(unsigned i=0;i<(alsa_format->channels/2);i++) {
 	  if(alsa_recording[alsa_format->card][i]) {
 	    if(alsa_input_volume[alsa_format->card][i]!=0.0) {
+	      //
+	      // Keep the full sample word; the writer reduces it to the
+	      // resolution of the output file.
+	      //
+	      gain=alsa_input_volume[alsa_format->card][i]/2147483648.0;
 	      switch(alsa_input_channels[alsa_format->card][i]) {
 	      case 1:
-		for(int k=0;k<(2*s);k++) {
-		  ((int16_t *)alsa_buffer)[k]=
-		    (int16_t)(alsa_input_volume[alsa_format->card][i]*
-			      (double)(((int16_t *)alsa_format->
-					card_buffer)
-				       [modulo*k+4*i+1]))+
-		    (int16_t)(alsa_input_volume[alsa_format->card][i]*
-			      (double)(((int16_t *)alsa_format->
-					card_buffer)
-				       [modulo*k+4*i+3]));
+		for(int k=0;k<s;k++) {
+		  alsa_buffer[k]=gain*
+		    ((double)((int32_t *)alsa_format->card_buffer)
+		     [modulo*k+2*i]+
+		     (double)((int32_t *)alsa_format->card_buffer)
+		     [modulo*k+2*i+1]);
 		}
-		alsa_record_ring[alsa_format->card][i]->
-		  write(alsa_buffer,s*sizeof(int16_t));
+		alsa_record_writer[alsa_format->card][i]->
+		  writeFrames(alsa_buffer,s);
 		break;
 
 	      case 2:
 		for(int k=0;k<s;k++) {
-		  ((int16_t *)alsa_buffer)[2*k]=
-		    (int16_t)(alsa_input_volume[alsa_format->card][i]*
-			      (double)(((int16_t *)alsa_format->card_buffer)
-				       [modulo*k+4*i+1]));
-		  ((int16_t *)alsa_buffer)[2*k+1]=
-		    (int16_t)(alsa_input_volume[alsa_format->card][i]*
-			      (double)(((int16_t *)alsa_format->card_buffer)
-				       [modulo*k+4*i+3]));
+		  alsa_buffer[2*k]=gain*
+		    (double)((int32_t *)alsa_format->card_buffer)
+		    [modulo*k+2*i];
+		  alsa_buffer[2*k+1]=gain*
+		    (double)((int32_t *)alsa_format->card_buffer)
+		    [modulo*k+2*i+1];
 		}
-		alsa_record_ring[alsa_format->card][i]->
-		  write(alsa_buffer,s*2*sizeof(int16_t));
+		alsa_record_writer[alsa_format->card][i]->
+		  writeFrames(alsa_buffer,s);
 		break;
 	      }
 	    }
@@ -254,6 +288,10 @@ void *AlsaPlayCallback(void *ptr)
   int16_t out_meter[RD_MAX_PORTS][2];
   int16_t stream_out_meter=0;
 
+  struct timespec ts;
+  uint64_t now;
+  unsigned released;
+
   struct alsa_format *alsa_format=(struct alsa_format *)ptr;
 
   signal(SIGTERM,SigHandler);
@@ -262,6 +300,22 @@ void *AlsaPlayCallback(void *ptr)
   while(!alsa_format->exiting) {
     memset(alsa_format->card_buffer,0,alsa_format->card_buffer_size);
 
+    //
+    // Start streams from a released batch in the first period at or after
+    // their start time
+    //
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    now=1000000*(uint64_t)ts.tv_sec+(uint64_t)ts.tv_nsec/1000;
+    released=alsa_released_serial;
+    for(unsigned j=0;j<RD_MAX_STREAMS;j++) {
+      unsigned serial=alsa_start_serial[alsa_format->card][j];
+      if((serial!=0)&&(serial<=released)&&
+	 (now>=alsa_start_time[alsa_format->card][j])) {
+	alsa_start_serial[alsa_format->card][j]=0;
+	alsa_playing[alsa_format->card][j]=true;
+      }
+    }
+
     switch(alsa_format->format) {
     case SND_PCM_FORMAT_S16_LE:
       for(unsigned j=0;j<RD_MAX_STREAMS;j++) {
@@ -552,7 +606,7 @@ void MainObject::AlsaInitCallback()
       }
       alsa_passthrough_ring[i][j]=new RDRingBuffer(RINGBUFFER_SIZE);
       alsa_passthrough_ring[i][j]->reset();
-      alsa_record_ring[i][j]=NULL;
+      alsa_record_writer[i][j]=NULL;
       for(int k=0;k<RD_MAX_PORTS;k++) {
 	alsa_passthrough_volume[i][j][k]=0.0;
       }
@@ -560,6 +614,8 @@ void MainObject::AlsaInitCallback()
     for(int j=0;j<RD_MAX_STREAMS;j++) {
       alsa_play_ring[i][j]=NULL;
       alsa_playing[i][j]=false;
+      alsa_start_serial[i][j]=0;
+      alsa_start_time[i][j]=0;
       for(int k=0;k<2;k++) {
 	alsa_stream_output_meter[i][j][k]=new RDMeterAverage(avg_periods);
       }
@@ -638,7 +694,6 @@ void MainObject::alsaInit(RDStation *station)
   for(int i=0;i<RD_MAX_CARDS;i++) {
     for(int j=0;j<RD_MAX_STREAMS;j++) {
       alsa_input_volume_db[i][j]=0;
-      alsa_samples_recorded[i][j]=0;
 #ifdef HAVE_MAD
       mad_mpeg[i][j]=new unsigned char[16384];
 #endif  // HAVE_MAD
@@ -841,6 +896,7 @@ bool MainObject::alsaUnloadPlayback(int card,int stream)
   if(alsa_play_ring[card][stream]==NULL) {
     return false;
   }
+  alsa_start_serial[card][stream]=0;
   alsa_playing[card][stream]=false;
   switch(alsa_play_wave[card][stream]->getFormatTag()) {
   case WAVE_FORMAT_MPEG:
@@ -914,12 +970,21 @@ bool MainObject::alsaPlay(int card,int stream,int length,int speed,bool pitch,
 {
 #ifdef ALSA
   if((alsa_play_ring[card][stream]==NULL)||
-     alsa_playing[card][stream]||(speed!=RD_TIMESCALE_DIVISOR)) {
+     alsa_playing[card][stream]||(alsa_start_serial[card][stream]!=0)||
+     (speed!=RD_TIMESCALE_DIVISOR)) {
     return false;
   }
-  alsa_playing[card][stream]=true;
-  if(length>0) {
-    alsa_stop_timer[card][stream]->start(length,true);
+  if(batch_active) {
+    alsa_start_serial[card][stream]=batch_serial;  // See alsaStartBatch()
+    if(length>0) {
+      alsa_stop_timer[card][stream]->start(length+batch_delay,true);
+    }
+  }
+  else {
+    alsa_playing[card][stream]=true;
+    if(length>0) {
+      alsa_stop_timer[card][stream]->start(length,true);
+    }
   }
   statePlayUpdate(card,stream,1);
   return true;
@@ -942,9 +1007,11 @@ bool MainObject::alsaTimescaleSupported(int card)
 bool MainObject::alsaStopPlayback(int card,int stream)
 {
 #ifdef ALSA
-  if((alsa_play_ring[card][stream]==NULL)||(!alsa_playing[card][stream])) {
+  if((alsa_play_ring[card][stream]==NULL)||
+     ((!alsa_playing[card][stream])&&(alsa_start_serial[card][stream]==0))) {
     return false;
   }
+  alsa_start_serial[card][stream]=0;
   alsa_playing[card][stream]=false;
   alsa_play_ring[card][stream]->reset();
   alsa_stop_timer[card][stream]->stop();
@@ -1037,12 +1104,51 @@ bool MainObject::alsaLoadRecord(int card,int stream,int coding,int chans,
   if(!alsa_record_wave[card][stream]->createWave()) {
     delete alsa_record_wave[card][stream];
     alsa_record_wave[card][stream]=NULL;
+    FreeTwoLameEncoder(card,stream);
     return false;
   }
   chown((const char *)wavename,rd_config->uid(),rd_config->gid());
   alsa_input_channels[card][stream]=chans;
-  alsa_record_ring[card][stream]=new RDRingBuffer(RINGBUFFER_SIZE);
-  alsa_record_ring[card][stream]->reset();
+
+  //
+  // Start the Writer
+  //
+  switch(coding) {
+  case 2:  // MPEG Layer 2
+#ifdef HAVE_TWOLAME
+    alsa_record_writer[card][stream]=
+      new AlsaMpegWriter(alsa_record_wave[card][stream],chans,
+			 twolame_lameopts[card][stream],
+			 twolame_encode_buffer_float32_interleaved,
+			 twolame_encode_flush);
+#endif  // HAVE_TWOLAME
+    break;
+
+  case 4:  // PCM24
+    alsa_record_writer[card][stream]=
+      new RDCaptureWriter(alsa_record_wave[card][stream],
+			  RDCaptureWriter::Pcm24,chans);
+    break;
+
+  default:  // PCM16
+    alsa_record_writer[card][stream]=
+      new RDCaptureWriter(alsa_record_wave[card][stream],
+			  RDCaptureWriter::Pcm16,chans);
+    break;
+  }
+  if((alsa_record_writer[card][stream]==NULL)||
+     (!alsa_record_writer[card][stream]->start())) {
+    RDApplication::syslog(rd_config,LOG_WARNING,
+	   "unable to start capture writer, card: %d, stream: %d",
+			  card,stream);
+    delete alsa_record_writer[card][stream];
+    alsa_record_writer[card][stream]=NULL;
+    alsa_record_wave[card][stream]->closeWave(0);
+    delete alsa_record_wave[card][stream];
+    alsa_record_wave[card][stream]=NULL;
+    FreeTwoLameEncoder(card,stream);
+    return false;
+  }
   alsa_ready[card][stream]=true;
   return true;
 #else
@@ -1051,19 +1157,33 @@ bool MainObject::alsaLoadRecord(int card,int stream,int coding,int chans,
 }
 
 
-bool MainObject::alsaUnloadRecord(int card,int stream,unsigned *len)
+bool MainObject::alsaUnloadRecord(int card,int stream,unsigned *len,
+				  int *peak,int *loudness)
 {
 #ifdef ALSA
   alsa_recording[card][stream]=false;
   alsa_ready[card][stream]=false;
-  EmptyAlsaInputStream(card,stream);
-  *len=alsa_samples_recorded[card][stream];
-  alsa_samples_recorded[card][stream]=0;
+  alsa_record_writer[card][stream]->stop();
+  if(alsa_record_writer[card][stream]->overruns()>0) {
+    RDApplication::syslog(rd_config,LOG_WARNING,
+	   "capture overrun, %lu frames dropped, card: %d, stream: %d",
+	   (unsigned long)alsa_record_writer[card][stream]->framesDropped(),
+			  card,stream);
+  }
+  if(alsa_record_writer[card][stream]->writeError()) {
+    RDApplication::syslog(rd_config,LOG_WARNING,
+	   "error writing capture file, card: %d, stream: %d",card,stream);
+  }
+  *len=alsa_record_writer[card][stream]->framesWritten();
+  *peak=(int)lrint(100.0*alsa_record_writer[card][stream]->
+		   loudnessMeter()->peakLevel());
+  *loudness=(int)lrint(100.0*alsa_record_writer[card][stream]->
+		       loudnessMeter()->integratedLoudness());
+  delete alsa_record_writer[card][stream];
+  alsa_record_writer[card][stream]=NULL;
   alsa_record_wave[card][stream]->closeWave(*len);
   delete alsa_record_wave[card][stream];
   alsa_record_wave[card][stream]=NULL;
-  delete alsa_record_ring[card][stream];
-  alsa_record_ring[card][stream]=NULL;
   FreeTwoLameEncoder(card,stream);
   return true;
 #else
@@ -1330,6 +1450,41 @@ void MainObject::alsaGetOutputPosition(int card,unsigned *pos)
 }
 
 
+void MainObject::alsaStartBatch()
+{
+#ifdef ALSA
+  struct timespec ts;
+  bool found=false;
+
+  for(int i=0;i<RD_MAX_CARDS;i++) {
+    for(int j=0;j<RD_MAX_STREAMS;j++) {
+      found=found||(alsa_start_serial[i][j]==batch_serial);
+    }
+  }
+  if(!found) {
+    return;
+  }
+
+  //
+  // All streams of the batch get the same start time, and none of them
+  // are seen by AlsaPlayCallback() until the batch serial is released
+  //
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  uint64_t start=1000000*(uint64_t)ts.tv_sec+(uint64_t)ts.tv_nsec/1000+
+    1000*(uint64_t)batch_delay;
+  for(int i=0;i<RD_MAX_CARDS;i++) {
+    for(int j=0;j<RD_MAX_STREAMS;j++) {
+      if(alsa_start_serial[i][j]==batch_serial) {
+	alsa_start_time[i][j]=start;
+      }
+    }
+  }
+  __sync_synchronize();
+  alsa_released_serial=batch_serial;
+#endif  // ALSA
+}
+
+
 bool MainObject::alsaSetPassthroughLevel(int card,int in_port,int out_port,
 					 int level)
 {
@@ -1695,68 +1850,6 @@ void MainObject::FreeAlsaOutputStream(int card,int stream)
 }
 
 
-void MainObject::EmptyAlsaInputStream(int card,int stream)
-{
-  unsigned n=alsa_record_ring[card][stream]->
-    read((char *)alsa_wave_buffer,alsa_record_ring[card][stream]->
-	 readSpace());
-  WriteAlsaBuffer(card,stream,alsa_wave_buffer,n);
-}
-
-
-void MainObject::WriteAlsaBuffer(int card,int stream,int16_t *buffer,unsigned len)
-{
-  ssize_t s;
-  unsigned char mpeg[2048];
-  unsigned frames;
-  unsigned n;
-
-  frames=len/(2*alsa_record_wave[card][stream]->getChannels());
-  alsa_samples_recorded[card][stream]+=frames;
-  switch(alsa_record_wave[card][stream]->getFormatTag()) {
-  case WAVE_FORMAT_PCM:
-    switch(alsa_record_wave[card][stream]->getBitsPerSample()) {
-    case 16:   // PCM16
-      alsa_record_wave[card][stream]->writeWave(buffer,len);
-      break;
-
-    case 24:   // PCM24
-      for(unsigned i=0;i<(len/2);i++) {
-	alsa_wave24_buffer[3*i]=0;      // FIXME: we lose eight bits here!
-	alsa_wave24_buffer[3*i+1]=((uint8_t *)buffer)[2*i];
-	alsa_wave24_buffer[3*i+2]=((uint8_t *)buffer)[2*i+1];
-      }
-      alsa_record_wave[card][stream]->writeWave(alsa_wave24_buffer,3*len/2);
-      break;
-    }
-    break;
-
-  case WAVE_FORMAT_MPEG:
-#ifdef HAVE_TWOLAME
-    for(unsigned i=0;i<frames;i+=1152) {
-      if((i+1152)>frames) {
-	n=frames-i;
-      }
-      else {
-	n=1152;
-      }
-      if((s=twolame_encode_buffer_interleaved(twolame_lameopts[card][stream],
-		   buffer+i*alsa_record_wave[card][stream]->getChannels(),
-					      n,mpeg,2048))>=0) {
-	alsa_record_wave[card][stream]->writeWave(mpeg,s);
-      }
-      else {
-	RDApplication::syslog(rd_config,LOG_WARNING,
-			      "TwoLAME encode error, card: %d, stream: %d",
-	       card,stream);
-      }
-    }
-#endif  // HAVE_TWOLAME
-    break;
-  }
-}
-
-
 void MainObject::FillAlsaOutputStream(int card,int stream)
 {
   unsigned mpeg_frames=0;
@@ -1885,11 +1978,6 @@ void MainObject::AlsaClock()
 	  FillAlsaOutputStream(i,j);
 	}
       }
-      for(int j=0;j<RD_MAX_PORTS;j++) {
-	if(alsa_recording[i][j]) {
-	  EmptyAlsaInputStream(i,j);
-	}
-      }
     }
   }
 #endif  // ALSA
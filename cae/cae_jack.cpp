@@ -2,7 +2,7 @@
 //
 // The JACK Driver for the Core Audio Engine component of Rivendell
 //
-//   (C) Copyright 2002-2019 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2019,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -32,6 +32,7 @@
 #include <rdringbuffer.h>
 #include <rdprofile.h>
 #include <rdmeteraverage.h>
+#include <rdmixkernel.h>
 
 #include <cae.h>
 
@@ -66,6 +67,9 @@ volatile bool jack_ready[RD_MAX_PORTS];
 volatile int jack_output_pos[RD_MAX_STREAMS];
 volatile unsigned jack_output_sample_rate[RD_MAX_STREAMS];
 volatile unsigned jack_sample_rate;
+volatile unsigned jack_start_serial[RD_MAX_STREAMS];
+volatile jack_nframes_t jack_start_frame[RD_MAX_STREAMS];
+volatile unsigned jack_released_serial;
 int jack_input_mode[RD_MAX_CARDS][RD_MAX_PORTS];
 int jack_card_process;  // local copy of object member jack_card, for use by the callback process.
 
@@ -80,7 +84,13 @@ int JackProcess(jack_nframes_t nframes, void *arg)
   unsigned n=0;
   jack_default_audio_sample_t in_meter[2];
   jack_default_audio_sample_t out_meter[2];
-  jack_default_audio_sample_t stream_out_meter;
+  jack_default_audio_sample_t stream_out_meter[2];
+  const float *pass_ins[RD_MAX_PORTS];
+  float pass_gains[RD_MAX_PORTS];
+  unsigned inputs;
+  jack_nframes_t frame=jack_last_frame_time(jack_client);
+  unsigned released=jack_released_serial;
+  unsigned skip;
 
   //
   // Ensure Buffers are Valid
@@ -104,9 +114,8 @@ int JackProcess(jack_nframes_t nframes, void *arg)
   for(int i=0;i<RD_MAX_PORTS;i++) {
     for(int j=0;j<2;j++) {
       if(jack_output_port[i][j]!=NULL) {
-	for(unsigned k=0;k<nframes;k++) {
-	  jack_output_buffer[i][j][k]=0.0;
-	}
+	memset((void *)jack_output_buffer[i][j],0,
+	       nframes*sizeof(jack_default_audio_sample_t));
       }
     } 
   }
@@ -114,17 +123,22 @@ int JackProcess(jack_nframes_t nframes, void *arg)
   //
   // Process Passthroughs
   //
-  for(int i=0;i<RD_MAX_PORTS;i++) {
-    for(int j=0;j<RD_MAX_PORTS;j++) {
-      if(jack_passthrough_volume[i][j]>0.0) {
-	for(int k=0;k<2;k++) {
-	  if((jack_output_port[j][k]!=NULL)&&(jack_input_port[i][k]!=NULL)) {
-	    for(unsigned l=0;l<nframes;l++) {
-	      jack_output_buffer[j][k][l]+=
-		jack_input_buffer[i][k][l]*jack_passthrough_volume[i][j];
-	    }
+  // All of the inputs feeding an output are summed in one pass over it.
+  //
+  for(int j=0;j<RD_MAX_PORTS;j++) {
+    for(int k=0;k<2;k++) {
+      if(jack_output_port[j][k]!=NULL) {
+	inputs=0;
+	for(int i=0;i<RD_MAX_PORTS;i++) {
+	  if((jack_passthrough_volume[i][j]>0.0)&&
+	     (jack_input_port[i][k]!=NULL)) {
+	    pass_ins[inputs]=(const float *)jack_input_buffer[i][k];
+	    pass_gains[inputs]=jack_passthrough_volume[i][j];
+	    inputs++;
 	  }
 	}
+	RDMixKernel::mix((float *)jack_output_buffer[j][k],pass_ins,
+			 pass_gains,inputs,nframes);
       }
     }
   }
@@ -135,26 +149,25 @@ int JackProcess(jack_nframes_t nframes, void *arg)
   for(int i=0;i<RD_MAX_PORTS;i++) {
     if(jack_input_port[i][0]!=NULL) {
       if(jack_recording[i]) {
+	const float *in_left=(const float *)jack_input_buffer[i][0];
+	const float *in_right=(const float *)jack_input_buffer[i][1];
+	float vol=jack_input_volume[i];
 	switch(jack_input_channels[i]) {
 	case 1: // mono
-	  for(unsigned j=0;j<nframes;j++) {
-	    switch(jack_input_mode[jack_card_process][i]) {
-	    case 3: // R only
-	      jack_callback_buffer[j]=jack_input_volume[i]*
-		jack_input_buffer[i][1][j];
-	      break;
-	    case 2: // L only
-	      jack_callback_buffer[j]=jack_input_volume[i]*
-		jack_input_buffer[i][0][j];
-	      break;
-	    case 1: // swap, sum R+L
-	    case 0: // normal, sum L+R
-	    default:
-	      jack_callback_buffer[j]=jack_input_volume[i]*
-		(jack_input_buffer[i][0][j]+jack_input_buffer[i][1][j]);
-	      break;
-	    }
-	  } // for nframes
+	  switch(jack_input_mode[jack_card_process][i]) {
+	  case 3: // R only
+	    RDMixKernel::gainCopy(jack_callback_buffer,in_right,vol,nframes);
+	    break;
+	  case 2: // L only
+	    RDMixKernel::gainCopy(jack_callback_buffer,in_left,vol,nframes);
+	    break;
+	  case 1: // swap, sum R+L
+	  case 0: // normal, sum L+R
+	  default:
+	    RDMixKernel::gainSum(jack_callback_buffer,in_left,in_right,vol,
+				 nframes);
+	    break;
+	  }
 	  n=jack_record_ring[i]->
 	    write((char *)jack_callback_buffer,
 		  nframes*sizeof(jack_default_audio_sample_t))/
@@ -162,35 +175,25 @@ int JackProcess(jack_nframes_t nframes, void *arg)
 	  break;
 
 	case 2: // stereo
-	  for(unsigned j=0;j<nframes;j++) {
-	    switch(jack_input_mode[jack_card_process][i]) {
-	    case 3: // R only
-	      memset(&jack_callback_buffer[2*j],0,
-		     sizeof(jack_input_buffer[i][0][j]));
-	      jack_callback_buffer[2*j+1]=jack_input_volume[i]*
-		jack_input_buffer[i][1][j];
-	      break;
-	    case 2: // L only
-	      jack_callback_buffer[2*j]=jack_input_volume[i]*
-		jack_input_buffer[i][0][j];
-	      memset(&jack_callback_buffer[2*j+1],0,
-		     sizeof(jack_input_buffer[i][1][j]));
-	      break;
-	    case 1: // swap
-	      jack_callback_buffer[2*j]=jack_input_volume[i]*
-		jack_input_buffer[i][1][j];
-	      jack_callback_buffer[2*j+1]=jack_input_volume[i]*
-		jack_input_buffer[i][0][j];
-	      break;
-	    case 0: // normal
-	    default:
-	      jack_callback_buffer[2*j]=jack_input_volume[i]*
-		jack_input_buffer[i][0][j];
-	      jack_callback_buffer[2*j+1]=jack_input_volume[i]*
-		jack_input_buffer[i][1][j];
-	      break;
-	    }
-	  } // for nframes
+	  switch(jack_input_mode[jack_card_process][i]) {
+	  case 3: // R only
+	    RDMixKernel::interleave(jack_callback_buffer,in_right,in_right,
+				    0.0,vol,nframes);
+	    break;
+	  case 2: // L only
+	    RDMixKernel::interleave(jack_callback_buffer,in_left,in_left,
+				    vol,0.0,nframes);
+	    break;
+	  case 1: // swap
+	    RDMixKernel::interleave(jack_callback_buffer,in_right,in_left,
+				    vol,vol,nframes);
+	    break;
+	  case 0: // normal
+	  default:
+	    RDMixKernel::interleave(jack_callback_buffer,in_left,in_right,
+				    vol,vol,nframes);
+	    break;
+	  }
 	  n=jack_record_ring[i]->
 	    write((char *)jack_callback_buffer,
 		  2*nframes*sizeof(jack_default_audio_sample_t))/
@@ -205,68 +208,67 @@ int JackProcess(jack_nframes_t nframes, void *arg)
   // Process Output Streams
   //
   for(int i=0;i<RD_MAX_STREAMS;i++) {
+    //
+    // Start streams from a released batch on their start frame
+    //
+    skip=0;
+    if((jack_start_serial[i]!=0)&&(jack_start_serial[i]<=released)) {
+      int32_t wait=(int32_t)(jack_start_frame[i]-frame);
+      if(wait<(int32_t)nframes) {
+	if(wait>0) {
+	  skip=wait;
+	}
+	jack_start_serial[i]=0;
+	jack_playing[i]=true;
+      }
+    }
     if(jack_playing[i]) {
       switch(jack_output_channels[i]) {
       case 1:
 	n=jack_play_ring[i]->
 	  read((char *)jack_callback_buffer,
-	       nframes*sizeof(jack_default_audio_sample_t))/
+	       (nframes-skip)*sizeof(jack_default_audio_sample_t))/
 	  sizeof(jack_default_audio_sample_t);
-	stream_out_meter=0.0;
-	for(unsigned j=0;j<n;j++) {  // Stream Output Meters
-	  if(fabsf(jack_callback_buffer[j])>stream_out_meter) {
-	    stream_out_meter=fabsf(jack_callback_buffer[j]);
-	  }
-	}
-	jack_stream_output_meter[i][0]->addValue(stream_out_meter);
-	jack_stream_output_meter[i][1]->addValue(stream_out_meter);
+	// Stream Output Meters
+	stream_out_meter[0]=RDMixKernel::peak(jack_callback_buffer,n);
+	jack_stream_output_meter[i][0]->addValue(stream_out_meter[0]);
+	jack_stream_output_meter[i][1]->addValue(stream_out_meter[0]);
 	break;
 
       case 2:
 	n=jack_play_ring[i]->
 	  read((char *)jack_callback_buffer,
-	       2*nframes*sizeof(jack_default_audio_sample_t))/
+	       2*(nframes-skip)*sizeof(jack_default_audio_sample_t))/
 	  (2*sizeof(jack_default_audio_sample_t));
-	for(unsigned j=0;j<2;j++) {  // Stream Output Meters
-	  stream_out_meter=0.0;
-	  for(unsigned k=0;k<n;k+=2) {
-	    if(fabsf(jack_callback_buffer[k+j])>stream_out_meter) {
-	      stream_out_meter=fabsf(jack_callback_buffer[k+j]);
-	    }
-	  }
-	  jack_stream_output_meter[i][j]->addValue(stream_out_meter);
-	}
+	// Stream Output Meters
+	RDMixKernel::peakInterleaved(stream_out_meter,stream_out_meter+1,
+				     jack_callback_buffer,n);
+	jack_stream_output_meter[i][0]->addValue(stream_out_meter[0]);
+	jack_stream_output_meter[i][1]->addValue(stream_out_meter[1]);
 	break;
       }
       for(int j=0;j<RD_MAX_PORTS;j++) {
 	if(jack_output_port[j][0]!=NULL) {
 	  if(jack_output_volume[j][i]>0.0) {
+	    float *out_left=(float *)jack_output_buffer[j][0]+skip;
+	    float *out_right=(float *)jack_output_buffer[j][1]+skip;
 	    switch(jack_output_channels[i]) {
 	    case 1:
-	      for(unsigned k=0;k<n;k++) {
-		jack_output_buffer[j][0][k]=
-		  jack_output_buffer[j][0][k]+jack_output_volume[j][i]*
-		  jack_callback_buffer[k];
-		jack_output_buffer[j][1][k]=
-		  jack_output_buffer[j][1][k]+jack_output_volume[j][i]*
-		  jack_callback_buffer[k];
-	      }
-	      if(n!=nframes && jack_eof[i]) {
+	      RDMixKernel::gainAccumulate(out_left,jack_callback_buffer,
+					  jack_output_volume[j][i],n);
+	      RDMixKernel::gainAccumulate(out_right,jack_callback_buffer,
+					  jack_output_volume[j][i],n);
+	      if(n!=(nframes-skip) && jack_eof[i]) {
 		jack_stopping[i]=true;
 		jack_playing[i]=false;
 	      }
 	      break;
 
 	    case 2:
-	      for(unsigned k=0;k<n;k++) {
-		jack_output_buffer[j][0][k]=
-		  jack_output_buffer[j][0][k]+jack_output_volume[j][i]*
-		  jack_callback_buffer[k*2];
-		jack_output_buffer[j][1][k]=
-		  jack_output_buffer[j][1][k]+jack_output_volume[j][i]*
-		  jack_callback_buffer[k*2+1];
-	      }
-	      if(n!=nframes && jack_eof[i]) {
+	      RDMixKernel::deinterleaveAccumulate(out_left,out_right,
+						  jack_callback_buffer,
+						  jack_output_volume[j][i],n);
+	      if(n!=(nframes-skip) && jack_eof[i]) {
 		jack_stopping[i]=true;
 		jack_playing[i]=false;
 	      }
@@ -286,44 +288,35 @@ int JackProcess(jack_nframes_t nframes, void *arg)
   for(int i=0;i<RD_MAX_PORTS;i++) {
     if(jack_input_port[i][0]!=NULL) {
       // input meters (taking input mode into account)
+      const float *in_left=(const float *)jack_input_buffer[i][0];
+      const float *in_right=(const float *)jack_input_buffer[i][1];
       in_meter[0]=0.0;
       in_meter[1]=0.0;
-      for(unsigned k=0;k<nframes;k++) {
-	switch(jack_input_mode[jack_card_process][i]) {
-	case 3: // R only
-	  if(jack_input_buffer[i][1][k]>in_meter[1]) 
-	    in_meter[1]=jack_input_buffer[i][1][k];
-	  break;
-	case 2: // L only
-	  if(jack_input_buffer[i][0][k]>in_meter[0]) 
-	    in_meter[0]=jack_input_buffer[i][0][k];
-	  break;
-	case 1: // swap
-	  if(jack_input_buffer[i][0][k]>in_meter[1]) 
-	    in_meter[1]=jack_input_buffer[i][0][k];
-	  if(jack_input_buffer[i][1][k]>in_meter[0]) 
-	    in_meter[0]=jack_input_buffer[i][1][k];
-	  break;
-	case 0: // normal
-	default:
-	  if(jack_input_buffer[i][0][k]>in_meter[0]) 
-	    in_meter[0]=jack_input_buffer[i][0][k];
-	  if(jack_input_buffer[i][1][k]>in_meter[1]) 
-	    in_meter[1]=jack_input_buffer[i][1][k];
-	  break;
-	}
-      } // for nframes
+      switch(jack_input_mode[jack_card_process][i]) {
+      case 3: // R only
+	in_meter[1]=RDMixKernel::maximum(in_right,nframes);
+	break;
+      case 2: // L only
+	in_meter[0]=RDMixKernel::maximum(in_left,nframes);
+	break;
+      case 1: // swap
+	in_meter[1]=RDMixKernel::maximum(in_left,nframes);
+	in_meter[0]=RDMixKernel::maximum(in_right,nframes);
+	break;
+      case 0: // normal
+      default:
+	in_meter[0]=RDMixKernel::maximum(in_left,nframes);
+	in_meter[1]=RDMixKernel::maximum(in_right,nframes);
+	break;
+      }
       jack_input_meter[i][0]->addValue(in_meter[0]);
       jack_input_meter[i][1]->addValue(in_meter[1]);
     }
     if(jack_output_port[i][0]!=NULL) {
       // output meters
       for(int j=0;j<2;j++) {
-	out_meter[j]=0.0;
-	for(unsigned k=0;k<nframes;k++) {
-	  if(jack_output_buffer[i][j][k]>out_meter[j]) 
-	    out_meter[j]=jack_output_buffer[i][j][k];
-	}
+	out_meter[j]=RDMixKernel::
+	  maximum((const float *)jack_output_buffer[i][j],nframes);
 	jack_output_meter[i][j]->addValue(out_meter[j]);
       }
     }
@@ -377,6 +370,8 @@ void JackInitCallback()
   for(int i=0;i<RD_MAX_STREAMS;i++) {
     jack_play_ring[i]=NULL;
     jack_playing[i]=false;
+    jack_start_serial[i]=0;
+    jack_start_frame[i]=0;
     for(int j=0;j<2;j++) {
       jack_stream_output_meter[i][j]=new RDMeterAverage(avg_periods);
     }
@@ -807,6 +802,7 @@ bool MainObject::jackUnloadPlayback(int card,int stream)
   if(jack_play_ring[stream]==NULL) {
     return false;
   }
+  jack_start_serial[stream]=0;
   jack_playing[stream]=false;
   switch(jack_play_wave[stream]->getFormatTag()) {
   case WAVE_FORMAT_MPEG:
@@ -879,7 +875,8 @@ bool MainObject::jackPlay(int card,int stream,int length,int speed,bool pitch,
 {
 #ifdef JACK
   if((stream <0) || (stream >= RD_MAX_STREAMS) || 
-     (jack_play_ring[stream]==NULL)||jack_playing[stream]) {
+     (jack_play_ring[stream]==NULL)||jack_playing[stream]||
+     (jack_start_serial[stream]!=0)) {
     return false;
   }
   if(speed!=RD_TIMESCALE_DIVISOR) {
@@ -888,9 +885,17 @@ bool MainObject::jackPlay(int card,int stream,int length,int speed,bool pitch,
     jack_st_conv[stream]->setSampleRate(jack_output_sample_rate[stream]);
     jack_st_conv[stream]->setChannels(jack_output_channels[stream]);
   }
-  jack_playing[stream]=true;
-  if(length>0) {
-    jack_stop_timer[stream]->start(length,true);
+  if(batch_active) {
+    jack_start_serial[stream]=batch_serial;  // Started by jackStartBatch()
+    if(length>0) {
+      jack_stop_timer[stream]->start(length+batch_delay,true);
+    }
+  }
+  else {
+    jack_playing[stream]=true;
+    if(length>0) {
+      jack_stop_timer[stream]->start(length,true);
+    }
   }
   statePlayUpdate(card,stream,1);
   return true;
@@ -904,9 +909,11 @@ bool MainObject::jackStopPlayback(int card,int stream)
 {
 #ifdef JACK
   if((stream <0) || (stream>=RD_MAX_STREAMS) || 
-     (jack_play_ring[stream]==NULL)||(!jack_playing[stream])) {
+     (jack_play_ring[stream]==NULL)||
+     ((!jack_playing[stream])&&(jack_start_serial[stream]==0))) {
     return false;
   }
+  jack_start_serial[stream]=0;
   jack_playing[stream]=false;
   jack_stop_timer[stream]->stop();
   statePlayUpdate(card,stream,2);
@@ -1352,6 +1359,35 @@ void MainObject::jackGetOutputPosition(int card,unsigned *pos)
 #endif  // JACK
 }
 
+
+void MainObject::jackStartBatch()
+{
+#ifdef JACK
+  bool found=false;
+
+  for(int i=0;i<RD_MAX_STREAMS;i++) {
+    found=found||(jack_start_serial[i]==batch_serial);
+  }
+  if((jack_client==NULL)||(!found)) {
+    return;
+  }
+
+  //
+  // All streams of the batch get the same start frame, and none of them
+  // are seen by JackProcess() until the batch serial is released
+  //
+  jack_nframes_t frame=jack_frame_time(jack_client)+
+    (jack_nframes_t)((uint64_t)batch_delay*jack_sample_rate/1000);
+  for(int i=0;i<RD_MAX_STREAMS;i++) {
+    if(jack_start_serial[i]==batch_serial) {
+      jack_start_frame[i]=frame;
+    }
+  }
+  __sync_synchronize();
+  jack_released_serial=batch_serial;
+#endif  // JACK
+}
+
 bool MainObject::jackSetPassthroughLevel(int card,int in_port,int out_port,
 					int level)
 {
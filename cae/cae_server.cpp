@@ -2,7 +2,7 @@
 //
 // Network server for caed(8).
 //
-//   (C) Copyright 2019 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2019,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -42,6 +42,9 @@ CaeServerConnection::CaeServerConnection(QTcpSocket *sock)
   for(int i=0;i<RD_MAX_CARDS;i++) {
     meters_enabled[i]=false;
   }
+  batch_id=-1;
+  batch_delay=0;
+  batch_valid=false;
 }
 
 
@@ -202,7 +205,6 @@ void CaeServer::connectionClosedData(int id)
 bool CaeServer::ProcessCommand(int id,const QString &cmd)
 {
   CaeServerConnection *conn=cae_connections.value(id);
-  bool ok=false;
   QStringList f0=cmd.split(" ",QString::SkipEmptyParts);
 
   if(f0.size()==0) {
@@ -242,6 +244,90 @@ bool CaeServer::ProcessCommand(int id,const QString &cmd)
   if(!conn->authenticated) {
     return false;
   }
+  if(ProcessBatch(id,f0)) {
+    return false;
+  }
+  if(!DispatchCommand(id,f0)) {  // Send generic error response
+    sendCommand(id,f0.join(" ")+"-!");
+  }
+
+  return false;
+}
+
+
+bool CaeServer::ProcessBatch(int id,const QStringList &f0)
+{
+  CaeServerConnection *conn=cae_connections.value(id);
+  bool ok=false;
+
+  if(f0.at(0)=="BB") {  // Begin Batch
+    int batch_id=-1;
+    unsigned delay=0;
+    if((f0.size()==2)||(f0.size()==3)) {
+      batch_id=f0.at(1).toInt(&ok);
+      if(ok&&(f0.size()==3)) {
+	delay=f0.at(2).toUInt(&ok);
+      }
+    }
+    if((!ok)||(batch_id<0)||(delay>CAE_SERVER_MAX_BATCH_DELAY)||
+       (conn->batch_id>=0)) {
+      sendCommand(id,f0.join(" ")+" -!");
+      return true;
+    }
+    conn->batch_id=batch_id;
+    conn->batch_delay=delay;
+    conn->batch_valid=true;
+    conn->batch_cmds.clear();
+    return true;
+  }
+
+  if(f0.at(0)=="BE") {  // End Batch
+    if((f0.size()!=2)||(conn->batch_id<0)||
+       (f0.at(1).toInt(&ok)!=conn->batch_id)||(!ok)) {
+      sendCommand(id,f0.join(" ")+" -!");
+      return true;
+    }
+
+    //
+    // Check every command before running any of them
+    //
+    QList<QStringList> cmds=conn->batch_cmds;
+    blockSignals(true);
+    for(int i=0;i<cmds.size();i++) {
+      conn->batch_valid=conn->batch_valid&&DispatchCommand(id,cmds.at(i));
+    }
+    blockSignals(false);
+    if(conn->batch_valid) {
+      emit beginBatchReq(id,conn->batch_delay);
+      for(int i=0;i<cmds.size();i++) {
+	DispatchCommand(id,cmds.at(i));
+      }
+      emit endBatchReq(id);
+    }
+    sendCommand(id,QString().sprintf("BE %d ",conn->batch_id)+
+		(conn->batch_valid?"+!":"-!"));
+    conn->batch_id=-1;
+    conn->batch_cmds.clear();
+    return true;
+  }
+
+  if(conn->batch_id>=0) {  // Queue for the batch
+    if(conn->batch_cmds.size()<CAE_SERVER_MAX_BATCH_COMMANDS) {
+      conn->batch_cmds.push_back(f0);
+    }
+    else {
+      conn->batch_valid=false;
+    }
+    return true;
+  }
+
+  return false;
+}
+
+
+bool CaeServer::DispatchCommand(int id,const QStringList &f0)
+{
+  bool ok=false;
   bool was_processed=false;
 
   if((f0.at(0)=="LP")&&(f0.size()==3)) {  // Load Playback
@@ -268,6 +354,26 @@ bool CaeServer::ProcessCommand(int id,const QString &cmd)
       }
     }
   }
+  if((f0.at(0)=="MK")&&(f0.size()==4)) {  // Set Play Marker
+    unsigned handle=f0.at(1).toUInt(&ok);
+    if(ok) {
+      int marker=f0.at(2).toInt(&ok);
+      if(ok&&(marker>=0)) {
+	unsigned pos=f0.at(3).toUInt(&ok);
+	if(ok) {
+	  emit playMarkerReq(id,handle,marker,pos);
+	  was_processed=true;
+	}
+      }
+    }
+  }
+  if((f0.at(0)=="MC")&&(f0.size()==2)) {  // Clear Play Markers
+    unsigned handle=f0.at(1).toUInt(&ok);
+    if(ok) {
+      emit clearPlayMarkersReq(id,handle);
+      was_processed=true;
+    }
+  }
   if((f0.at(0)=="PY")&&(f0.size()==5)) {  // Play
     unsigned handle=f0.at(1).toUInt(&ok);
     if(ok) {
@@ -555,9 +661,5 @@ bool CaeServer::ProcessCommand(int id,const QString &cmd)
     }
   }
 
-  if(!was_processed) {  // Send generic error response
-    sendCommand(id,f0.join(" ")+"-!");
-  }
-
-  return false;
+  return was_processed;
 }
@@ -2,7 +2,7 @@
 //
 // Network server for caed(8).
 //
-//   (C) Copyright 2019 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2019,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -27,11 +27,15 @@
 #include <qmap.h>
 #include <qobject.h>
 #include <qsignalmapper.h>
+#include <qstringlist.h>
 #include <qtcpserver.h>
 #include <qtcpsocket.h>
 
 #include <rdconfig.h>
 
+#define CAE_SERVER_MAX_BATCH_COMMANDS 256
+#define CAE_SERVER_MAX_BATCH_DELAY 10000
+
 class CaeServerConnection
 {
  public:
@@ -42,6 +46,10 @@ class CaeServerConnection
   QString accum;
   uint16_t meter_port;
   bool meters_enabled[RD_MAX_CARDS];
+  int batch_id;
+  unsigned batch_delay;
+  bool batch_valid;
+  QList<QStringList> batch_cmds;
 };
 
 
@@ -70,6 +78,8 @@ class CaeServer : public QObject
   void playPositionReq(int id,unsigned handle,unsigned pos);
   void playReq(int id,unsigned handle,unsigned length,unsigned speed,unsigned pitch_flag);
   void stopPlaybackReq(int id,unsigned handle);
+  void playMarkerReq(int id,unsigned handle,int marker,unsigned pos);
+  void clearPlayMarkersReq(int id,unsigned handle);
   void timescalingSupportReq(int id,unsigned card);
   void loadRecordingReq(int id,unsigned card,unsigned port,unsigned coding,
 			unsigned channels,unsigned samprate,unsigned bitrate,
@@ -98,6 +108,8 @@ class CaeServer : public QObject
   void openRtpCaptureChannelReq(int id,unsigned card,unsigned port,uint16_t udp_port,
 				unsigned samprate,unsigned chans);
   void meterEnableReq(int id,uint16_t udp_port,const QList<unsigned> &cards);
+  void beginBatchReq(int id,unsigned delay);
+  void endBatchReq(int id);
 
  private slots:
   void newConnectionData();
@@ -106,6 +118,8 @@ class CaeServer : public QObject
 
  private:
   bool ProcessCommand(int id,const QString &cmd);
+  bool ProcessBatch(int id,const QStringList &f0);
+  bool DispatchCommand(int id,const QStringList &f0);
   QMap<int,CaeServerConnection *> cae_connections;
   QTcpServer *cae_server;
   QSignalMapper *cae_ready_read_mapper;
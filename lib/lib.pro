@@ -50,14 +50,17 @@ SOURCES += rdbusydialog.cpp
 SOURCES += rdbutton_dialog.cpp
 SOURCES += rdbutton_panel.cpp
 SOURCES += rdcae.cpp
+SOURCES += rdcapturewriter.cpp
 SOURCES += rdcardselector.cpp
 SOURCES += rdcart.cpp
 SOURCES += rdcart_dialog.cpp
 SOURCES += rdcart_search_text.cpp
 SOURCES += rdcartdrag.cpp
+SOURCES += rdcartsearchindex.cpp
 SOURCES += rdcatch_connect.cpp
 SOURCES += rdcddblookup.cpp
 SOURCES += rdcdplayer.cpp
+SOURCES += rdcutrotation.cpp
 SOURCES += rddiscrecord.cpp
 SOURCES += rdcheck_version.cpp
 SOURCES += rdclock.cpp
@@ -89,12 +92,14 @@ SOURCES += rddropbox.cpp
 SOURCES += rddummylookup.cpp
 SOURCES += rdedit_audio.cpp
 SOURCES += rdedit_panel_name.cpp
+SOURCES += rdelrjournal.cpp
 SOURCES += rdemptycart.cpp
 SOURCES += rdescape_string.cpp
 SOURCES += rdevent.cpp
 SOURCES += rdevent_line.cpp
 SOURCES += rdeventimportlist.cpp
 SOURCES += rdexport_settings_dialog.cpp
+SOURCES += rdexportcache.cpp
 SOURCES += rdframe.cpp
 SOURCES += rdfontengine.cpp
 SOURCES += rdget_ath.cpp
@@ -108,6 +113,7 @@ SOURCES += rdidvalidator.cpp
 SOURCES += rdimagepickerbox.cpp
 SOURCES += rdimagepickermodel.cpp
 SOURCES += rdimport_audio.cpp
+SOURCES += rdimportline.cpp
 SOURCES += rdkernelgpio.cpp
 SOURCES += rdlibrary_conf.cpp
 SOURCES += rdlineedit.cpp
@@ -124,21 +130,28 @@ SOURCES += rdlogedit_conf.cpp
 SOURCES += rdlogfilter.cpp
 SOURCES += rdloglock.cpp
 SOURCES += rdlogplay.cpp
+SOURCES += rdlogtemplatecache.cpp
+SOURCES += rdloudnessmeter.cpp
 SOURCES += rdmacro.cpp
 SOURCES += rdmacro_event.cpp
+SOURCES += rdmacrocartcache.cpp
 SOURCES += rdmarker_button.cpp
 SOURCES += rdmarker_edit.cpp
 SOURCES += rdmatrix.cpp
 SOURCES += rdmblookup.cpp
+SOURCES += rdmixkernel.cpp
 SOURCES += rdmonitor_config.cpp
 SOURCES += rdnotification.cpp
+SOURCES += rdnotificationcoalescer.cpp
 SOURCES += rdoneshot.cpp
 SOURCES += rdpanel_button.cpp
+SOURCES += rdpanelmodel.cpp
 SOURCES += rdpasswd.cpp
 SOURCES += rdplay_deck.cpp
 SOURCES += rdplaymeter.cpp
 SOURCES += rdprocess.cpp
 SOURCES += rdprofile.cpp
+SOURCES += rdpurgeengine.cpp
 SOURCES += rdpushbutton.cpp
 SOURCES += rdrecording.cpp
 SOURCES += rdrehash.cpp
@@ -153,12 +166,15 @@ SOURCES += rdsendmail.cpp
 SOURCES += rdsettings.cpp
 SOURCES += rdsimpleplayer.cpp
 SOURCES += rdslider.cpp
+SOURCES += rdsnapshot.cpp
 SOURCES += rdsocket.cpp
 SOURCES += rdsocketstrings.cpp
 SOURCES += rdsound_panel.cpp
+SOURCES += rdsqlprofiler.cpp
 SOURCES += rdstation.cpp
 SOURCES += rdstatus.cpp
 SOURCES += rdstereometer.cpp
+SOURCES += rdstringpool.cpp
 SOURCES += rdsvc.cpp
 SOURCES += rdsystem.cpp
 SOURCES += rdtempdirectory.cpp
@@ -194,14 +210,17 @@ HEADERS += rdbusydialog.h
 HEADERS += rdbutton_dialog.h
 HEADERS += rdbutton_panel.h
 HEADERS += rdcae.h
+HEADERS += rdcapturewriter.h
 HEADERS += rdcardselector.h
 HEADERS += rdcart.h
 HEADERS += rdcart_dialog.h
 HEADERS += rdcart_search_text.h
 HEADERS += rdcartdrag.h
+HEADERS += rdcartsearchindex.h
 HEADERS += rdcatch_connect.h
 HEADERS += rdcddblookup.h
 HEADERS += rdcdplayer.h
+HEADERS += rdcutrotation.h
 HEADERS += rddatapacer.h
 HEADERS += rddiscrecord.h
 HEADERS += rddisclookup.h
@@ -233,12 +252,14 @@ HEADERS += rddropbox.h
 HEADERS += rddummylookup.h
 HEADERS += rdedit_audio.h
 HEADERS += rdedit_panel_name.h
+HEADERS += rdelrjournal.h
 HEADERS += rdemptycart.h
 HEADERS += rdescape_string.h
 HEADERS += rdevent.h
 HEADERS += rdevent_line.h
 HEADERS += rdeventimportlist.h
 HEADERS += rdexport_settings_dialog.h
+HEADERS += rdexportcache.h
 HEADERS += rdframe.h
 HEADERS += rdfontengine.h
 HEADERS += rdget_ath.h
@@ -253,6 +274,7 @@ HEADERS += rdidvalidator.h
 HEADERS += rdimagepickerbox.h
 HEADERS += rdimagepickermodel.h
 HEADERS += rdimport_audio.h
+HEADERS += rdimportline.h
 HEADERS += rdkernelgpio.h
 HEADERS += rdlibrary_conf.h
 HEADERS += rdlineedit.h
@@ -269,22 +291,29 @@ HEADERS += rdlogedit_conf.h
 HEADERS += rdlogfilter.h
 HEADERS += rdloglock.h
 HEADERS += rdlogplay.h
+HEADERS += rdlogtemplatecache.h
+HEADERS += rdloudnessmeter.h
 HEADERS += rdmacro.h
 HEADERS += rdmacro_event.h
+HEADERS += rdmacrocartcache.h
 HEADERS += rdmarker_button.h
 HEADERS += rdmarker_edit.h
 HEADERS += rdmatrix.h
 HEADERS += rdmblookup.h
+HEADERS += rdmixkernel.h
 HEADERS += rdmonitor_config.h
 HEADERS += rdnotification.h
+HEADERS += rdnotificationcoalescer.h
 HEADERS += rdoneshot.h
 HEADERS += rdpanel_button.h
+HEADERS += rdpanelmodel.h
 HEADERS += rdpaths.h
 HEADERS += rdpasswd.h
 HEADERS += rdplay_deck.h
 HEADERS += rdplaymeter.h
 HEADERS += rdprocess.h
 HEADERS += rdprofile.h
+HEADERS += rdpurgeengine.h
 HEADERS += rdpushbutton.h
 HEADERS += rdrecording.h
 HEADERS += rdrehash.h
@@ -299,12 +328,15 @@ HEADERS += rdsendmail.h
 HEADERS += rdsettings.h
 HEADERS += rdsimpleplayer.h
 HEADERS += rdslider.h
+HEADERS += rdsnapshot.h
 HEADERS += rdsocket.h
 HEADERS += rdsocketstrings.h
 HEADERS += rdsound_panel.h
+HEADERS += rdsqlprofiler.h
 HEADERS += rdstation.h
 HEADERS += rdstatus.h
 HEADERS += rdstereometer.h
+HEADERS += rdstringpool.h
 HEADERS += rdsvc.h
 HEADERS += rdsystem.h
 HEADERS += rdtempdirectory.h
@@ -2,7 +2,7 @@
 //
 // System-Wide Values for Rivendell
 //
-//   (C) Copyright 2002-2023 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2023,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -276,6 +276,11 @@
  */
 #define RD_LOCKFILE_DIR "/var/lock"
 
+/*
+ * Default spool for as-played (ELR) records, relative to $HOME
+ */
+#define RD_ELR_SPOOL_DIR ".rivendell-elr"
+
 /*
  * Rivendell Macro Language (RML)
  */
@@ -615,6 +620,22 @@
  */
 #define RD_DEFAULT_SERVICE_TIMEOUT 30
 
+/*
+ * Default 'ExportCacheSize=' value in rd.conf(5) (MB)
+ */
+#define RD_DEFAULT_EXPORT_CACHE_SIZE 1024
+
+/*
+ * Default 'NotificationWindow=' value in rd.conf(5) (mS)
+ */
+#define RD_DEFAULT_NOTIFICATION_WINDOW 200
+
+/*
+ * Longest time a hosted PyPAD script may run without returning before
+ * its host is killed (seconds)
+ */
+#define RD_PYPAD_HOST_TIMEOUT 10
+
 /*
  * File Extension for RSS XML Feed Files
  */
@@ -637,4 +658,10 @@
  */
 #define RD_METER_SOCKET_PORT_RANGE 100
 
+/*
+ * Range of cut play gain (1/100 dB)
+ */
+#define RD_MIN_PLAY_GAIN -1000
+#define RD_MAX_PLAY_GAIN 1000
+
 #endif  // RD_H
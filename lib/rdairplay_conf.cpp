@@ -2,7 +2,7 @@
 //
 // Abstract an RDAirPlay Configuration.
 //
-//   (C) Copyright 2002-2003,2016 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2003,2016,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -24,15 +24,21 @@
 #include <rdconf.h>
 #include <rdairplay_conf.h>
 #include <rdescape_string.h>
+#include <rdsnapshot.h>
 
 RDAirPlayConf::RDAirPlayConf(const QString &station,const QString &tablename)
 {
   RDSqlQuery *q;
   QString sql;
+  QVariant id;
 
   air_station=station;
   air_tablename=tablename;
 
+  if(RDSnapshot::value(air_tablename,"STATION",air_station,"ID",&id)) {
+    air_id=id.toUInt();
+    return;
+  }
   sql=QString("select ID from `")+air_tablename+"` where "+
     "STATION=\""+RDEscapeString(air_station)+"\"";
   q=new RDSqlQuery(sql);
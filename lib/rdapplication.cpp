@@ -2,7 +2,7 @@
 //
 // Base Application Class
 //
-//   (C) Copyright 2018-2019 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2018-2019,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -24,18 +24,28 @@
 #include <qapplication.h>
 #include <qobject.h>
 #include <qprocess.h>
+#include <qtimer.h>
 
 #include "rdescape_string.h"
 
 #include "dbversion.h"
 #include "rdapplication.h"
 #include "rdcmd_switch.h"
+#include "rdsnapshot.h"
 
 RDApplication *rda=NULL;
 QStringList __rdapplication_temp_files;
+RDElrJournal *__rdapplication_elr_journal=NULL;
+RDRipc *__rdapplication_ripc=NULL;
 
 void __RDApplication_ExitCallback()
 {
+  if(__rdapplication_elr_journal!=NULL) {
+    __rdapplication_elr_journal->close();
+  }
+  if(__rdapplication_ripc!=NULL) {
+    __rdapplication_ripc->flushNotifications(RIPC_FLUSH_TIMEOUT);
+  }
   for(int i=0;i<__rdapplication_temp_files.size();i++) {
     unlink(__rdapplication_temp_files.at(i).toUtf8());
   }
@@ -55,6 +65,7 @@ RDApplication::RDApplication(const QString &module_name,const QString &cmdname,
   app_cae=NULL;
   app_cmd_switch=NULL;
   app_config=NULL;
+  app_elr_journal=NULL;
   app_library_conf=NULL;
   app_logedit_conf=NULL;
   app_panel_conf=NULL;
@@ -69,6 +80,10 @@ RDApplication::RDApplication(const QString &module_name,const QString &cmdname,
 
 RDApplication::~RDApplication()
 {
+  if(app_elr_journal!=NULL) {
+    __rdapplication_elr_journal=NULL;
+    delete app_elr_journal;
+  }
   if(app_heartbeat!=NULL) {
     delete app_heartbeat;
   }
@@ -103,6 +118,7 @@ RDApplication::~RDApplication()
     delete app_cmd_switch;
   }
   if(app_ripc!=NULL) {
+    __rdapplication_ripc=NULL;
     delete app_ripc;
   }
 }
@@ -192,6 +208,14 @@ bool RDApplication::open(QString *err_msg,RDApplication::ErrorType *err_type,
   }
   app_heartbeat=new RDDbHeartbeat(app_config->mysqlHeartbeatInterval(),this);
 
+  //
+  // Read the configuration rows used by the accessors with a few bulk
+  // queries. The snapshot is dropped once the event loop starts, so
+  // later reads see changes made elsewhere as before.
+  //
+  RDSnapshot::bootstrap(app_config->stationName());
+  QTimer::singleShot(0,this,SLOT(releaseSnapshotData()));
+
   //
   // Open Accessors
   //
@@ -205,6 +229,7 @@ bool RDApplication::open(QString *err_msg,RDApplication::ErrorType *err_type,
   app_user=new RDUser();
   app_cae=new RDCae(app_station,app_config,this);
   app_ripc=new RDRipc(app_station,app_config,this);
+  __rdapplication_ripc=app_ripc;
   connect(app_ripc,SIGNAL(userChanged()),this,SLOT(userChangedData()));
 
   if(!app_station->exists()) {
@@ -245,6 +270,25 @@ RDConfig *RDApplication::config()
 }
 
 
+RDElrJournal *RDApplication::elrJournal()
+{
+  QString err_msg;
+
+  if(app_elr_journal==NULL) {
+    app_elr_journal=new RDElrJournal(app_config,
+				     app_config->elrSpoolDirectory(),
+				     app_command_name);
+    if(!app_elr_journal->open(&err_msg)) {
+      syslog(LOG_WARNING,
+	     "unable to open ELR spool, writing ELR records directly [%s]",
+	     err_msg.toUtf8().constData());
+    }
+    __rdapplication_elr_journal=app_elr_journal;
+  }
+  return app_elr_journal;
+}
+
+
 RDLibraryConf *RDApplication::libraryConf()
 {
   return app_library_conf;
@@ -448,6 +492,12 @@ QString RDApplication::exitCodeText(RDApplication::ExitCode code)
 }
 
 
+void RDApplication::releaseSnapshotData()
+{
+  RDSnapshot::clear();
+}
+
+
 void RDApplication::userChangedData()
 {
   QString sql;
@@ -2,7 +2,7 @@
 //
 // Base Application Class
 //
-//   (C) Copyright 2018-2019 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2018-2019,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -33,6 +33,7 @@
 #include <rdconfig.h>
 #include <rddb.h>
 #include <rddbheartbeat.h>
+#include <rdelrjournal.h>
 #include <rdlibrary_conf.h>
 #include <rdlogedit_conf.h>
 #include <rdripc.h>
@@ -62,6 +63,7 @@ class RDApplication : public QObject
   RDCae *cae();
   RDCmdSwitch *cmdSwitch();
   RDConfig *config();
+  RDElrJournal *elrJournal();
   RDLibraryConf *libraryConf();
   RDLogeditConf *logeditConf();
   RDAirPlayConf *panelConf();
@@ -79,6 +81,7 @@ class RDApplication : public QObject
   static QString exitCodeText(ExitCode code);
 
  private slots:
+  void releaseSnapshotData();
   void userChangedData();
 
  signals:
@@ -91,6 +94,7 @@ class RDApplication : public QObject
   RDCae *app_cae;
   RDCmdSwitch *app_cmd_switch;
   RDConfig  *app_config;
+  RDElrJournal *app_elr_journal;
   RDLibraryConf *app_library_conf;
   RDLogeditConf *app_logedit_conf;
   RDRipc *app_ripc;
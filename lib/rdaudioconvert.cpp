@@ -2,7 +2,7 @@
 //
 // Convert Audio File Formats
 //
-//   (C) Copyright 2010-2019 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2010-2019,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -69,6 +69,7 @@ RDAudioConvert::RDAudioConvert(QObject *parent)
   conv_end_point=-1;
   conv_speed_ratio=1.0;
   conv_peak_sample=0.0;
+  conv_meter=NULL;
   conv_settings=NULL;
   conv_src_wavedata=new RDWaveData();
   conv_dst_wavedata=NULL;
@@ -86,6 +87,9 @@ RDAudioConvert::RDAudioConvert(QObject *parent)
 
 RDAudioConvert::~RDAudioConvert()
 {
+  if(conv_meter!=NULL) {
+    delete conv_meter;
+  }
   delete conv_src_wavedata;
 }
 
@@ -223,6 +227,21 @@ RDAudioConvert::ErrorCode RDAudioConvert::convert()
 }
 
 
+float RDAudioConvert::peakSample() const
+{
+  return conv_peak_sample;
+}
+
+
+double RDAudioConvert::integratedLoudness() const
+{
+  if(conv_meter==NULL) {
+    return RD_LOUDNESS_SILENCE;
+  }
+  return conv_meter->integratedLoudness();
+}
+
+
 bool RDAudioConvert::settingsValid(RDSettings *settings)
 {
   return true;
@@ -294,11 +313,19 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage1Convert(const QString &srcfile,
   RDWaveFile *wave=NULL;
   RDAudioConvert::ErrorCode err=RDAudioConvert::ErrorInvalidSource;
 
+  conv_peak_sample=0.0;
+  if(conv_meter!=NULL) {
+    delete conv_meter;
+    conv_meter=NULL;
+  }
+
   //
   // Try RDWaveFile
   //
   wave=new RDWaveFile(srcfile);
   if(wave->openWave(conv_src_wavedata)) {
+    conv_meter=
+      new RDLoudnessMeter(wave->getChannels(),wave->getSamplesPerSec());
     switch(wave->type()) {
     case RDWaveFile::Wave:
       if(wave->getFormatTag()==WAVE_FORMAT_MPEG) {
@@ -337,12 +364,18 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage1Convert(const QString &srcfile,
     }
   }
   delete wave;
+  if(conv_meter!=NULL) {
+    delete conv_meter;
+    conv_meter=NULL;
+  }
 
   //
   // Try Libsndfile
   //
   memset(&sf_src_info,0,sizeof(sf_src_info));
   if((sf_src=sf_open(srcfile.toUtf8(),SFM_READ,&sf_src_info))!=NULL) {
+    conv_meter=
+      new RDLoudnessMeter(sf_src_info.channels,sf_src_info.samplerate);
     err=Stage1SndFile(dstfile,sf_src,&sf_src_info);
     sf_close(sf_src);
     return RDAudioConvert::ErrorOk;
@@ -376,7 +409,7 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage1Flac(const QString &dstfile,
   //
   flac=new RDFlacDecode(sf_dst);
   flac->setRange(conv_start_point,conv_end_point);
-  flac->decode(wave,&conv_peak_sample);
+  flac->decode(wave,&conv_peak_sample,conv_meter);
 
   //
   // Clean Up
@@ -1944,10 +1977,20 @@ void RDAudioConvert::ApplyId3Tag(const QString &filename,RDWaveData *wavedata)
   }
   tag->setProperties(*map);
 
-  RDCart *cart=new RDCart(wavedata->cartNumber());
-  if(cart->exists()) {
-    QString xml=
-      cart->xml(true,conv_start_point<0,conv_settings,wavedata->cutNumber());
+  //
+  // Use the XML given with setDestinationRdxl() when there is one, so
+  // that conversions run from worker threads stay off the database
+  //
+  QString xml=conv_dst_rdxl;
+  if(xml.isEmpty()) {
+    RDCart *cart=new RDCart(wavedata->cartNumber());
+    if(cart->exists()) {
+      xml=cart->
+	xml(true,conv_start_point<0,conv_settings,wavedata->cutNumber());
+    }
+    delete cart;
+  }
+  if(!xml.isEmpty()) {
     TagLib::ID3v2::UserTextIdentificationFrame *frame=
       new TagLib::ID3v2::UserTextIdentificationFrame(TagLib::String::UTF8);
     frame->setDescription("rdxl");
@@ -1955,7 +1998,6 @@ void RDAudioConvert::ApplyId3Tag(const QString &filename,RDWaveData *wavedata)
     				  TagLib::String::UTF8));
     tag->addFrame(frame);
   }
-  delete cart;
 
   file->save();
   delete map;
@@ -1983,6 +2025,9 @@ void RDAudioConvert::UpdatePeak(const float data[],ssize_t len)
       conv_peak_sample=peak;
     }
   }
+  if((conv_meter!=NULL)&&(conv_meter->channels()>0)) {
+    conv_meter->process(data,len/conv_meter->channels());
+  }
 }
 
 
@@ -1995,6 +2040,9 @@ void RDAudioConvert::UpdatePeak(const double data[],ssize_t len)
       conv_peak_sample=peak;
     }
   }
+  if((conv_meter!=NULL)&&(conv_meter->channels()>0)) {
+    conv_meter->process(data,len/conv_meter->channels());
+  }
 }
 
 
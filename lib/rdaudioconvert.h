@@ -39,6 +39,7 @@
 #include <qobject.h>
 
 #include "rdconfig.h"
+#include "rdloudnessmeter.h"
 #include "rdsettings.h"
 #include "rdwavedata.h"
 #include "rdwavefile.h"
@@ -63,6 +64,8 @@ class RDAudioConvert : public QObject
   void setRange(int start_pt,int end_pt);
   void setSpeedRatio(float ratio);
   RDAudioConvert::ErrorCode convert();
+  float peakSample() const;
+  double integratedLoudness() const;
   static bool settingsValid(RDSettings *settings);
   static QString errorText(RDAudioConvert::ErrorCode err);
 
@@ -119,6 +122,7 @@ class RDAudioConvert : public QObject
   QString conv_src_rdxl;
   QString conv_dst_rdxl;
   float conv_peak_sample;
+  RDLoudnessMeter *conv_meter;
   int conv_src_converter;
   void *conv_mad_handle;
   void *conv_lame_handle;
@@ -2,7 +2,7 @@
 //
 // Connection to the Rivendell Core Audio Engine
 //
-//   (C) Copyright 2002-2019 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2019,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -44,6 +44,9 @@ RDCae::RDCae(RDStation *station,RDConfig *config,QObject *parent)
   cae_connected=false;
   argnum=0;
   argptr=0;
+  cae_batch_depth=0;
+  cae_batch_delay=0;
+  cae_batch_id=0;
 
   //
   // TCP Connection
@@ -152,8 +155,11 @@ bool RDCae::loadPlay(int card,QString name,int *stream,int *handle)
 {
   int count=0;
 
-  SendCommand(QString().sprintf("LP %d %s!",
-				card,(const char *)name));
+  //
+  // Never held back in a batch, as we wait for the reply here
+  //
+  WriteCommand(QString().sprintf("LP %d %s!",
+				 card,(const char *)name));
 
   //
   // This is really warty, but needed to make the method 'synchronous'
@@ -217,6 +223,22 @@ void RDCae::stopPlay(int handle)
 }
 
 
+void RDCae::setPlayMarker(int handle,int marker,unsigned pos)
+{
+  //
+  // caed(8) reports the marker with playMarker() once the audio played
+  // on the stream reaches 'pos' msecs into the file
+  //
+  SendCommand(QString().sprintf("MK %d %d %u!",handle,marker,pos));
+}
+
+
+void RDCae::clearPlayMarkers(int handle)
+{
+  SendCommand(QString().sprintf("MC %d!",handle));
+}
+
+
 void RDCae::loadRecord(int card,int stream,QString name,
 		       AudioCoding coding,int chan,int samp_rate,
 		       int bit_rate)
@@ -382,6 +404,32 @@ void RDCae::setPlayPortActive(int card,int port,int stream)
 }
 
 
+void RDCae::beginBatch(unsigned delay)
+{
+  if(cae_batch_depth++==0) {
+    cae_batch_delay=delay;
+    cae_batch_cmds="";
+  }
+}
+
+
+unsigned RDCae::commitBatch()
+{
+  if((cae_batch_depth==0)||(--cae_batch_depth>0)||cae_batch_cmds.isEmpty()) {
+    return 0;
+  }
+  if(++cae_batch_id==0) {
+    cae_batch_id=1;
+  }
+  WriteCommand(QString().sprintf("BB %u %u!",cae_batch_id,cae_batch_delay)+
+	       cae_batch_cmds+
+	       QString().sprintf("BE %u!",cae_batch_id));
+  cae_batch_cmds="";
+
+  return cae_batch_id;
+}
+
+
 void RDCae::readyData()
 {
   readyData(0,0,"");
@@ -482,6 +530,16 @@ void RDCae::clockData()
 
 
 void RDCae::SendCommand(QString cmd)
+{
+  if(cae_batch_depth>0) {
+    cae_batch_cmds+=cmd;
+    return;
+  }
+  WriteCommand(cmd);
+}
+
+
+void RDCae::WriteCommand(const QString &cmd)
 {
   cae_socket->writeBlock((const char *)cmd,cmd.length());
 }
@@ -555,6 +613,25 @@ void RDCae::DispatchCommand(RDCmdCache *cmd)
     }
   }
 
+  if(!strcmp(cmd->arg(0),"MK")) {   // Play Marker Reached
+    if((cmd->argNum()>=5)&&(cmd->arg(4)[0]!='-')) {
+      emit playMarker(GetHandle(cmd->arg(1)),QString(cmd->arg(2)).toInt(),
+		      QString(cmd->arg(3)).toUInt(),
+		      QString(cmd->arg(4)).toUInt());
+    }
+  }
+
+  if(!strcmp(cmd->arg(0),"BE")) {   // End Batch
+    if(cmd->argNum()>=3) {
+      emit batchCommitted(QString(cmd->arg(1)).toUInt(),
+			  cmd->arg(2)[0]=='+');
+    }
+  }
+
+  if(!strcmp(cmd->arg(0),"BB")) {   // Begin Batch (failure only)
+    emit batchCommitted(QString(cmd->arg(1)).toUInt(),false);
+  }
+
   if(!strcmp(cmd->arg(0),"TS")) {   // Timescale Supported
     if(sscanf(cmd->arg(1),"%d",&card)==1) {
       if(cmd->arg(2)[0]=='+') {
@@ -574,6 +651,11 @@ void RDCae::DispatchCommand(RDCmdCache *cmd)
 
   if(!strcmp(cmd->arg(0),"UR")) {   // Unload Record
     if(cmd->arg(4)[0]=='+') {
+      if(cmd->argNum()>=7) {
+	emit recordAnalyzed(CardNumber(cmd->arg(1)),StreamNumber(cmd->arg(2)),
+			    QString(cmd->arg(5)).toInt(),
+			    QString(cmd->arg(6)).toInt());
+      }
       emit recordUnloaded(CardNumber(cmd->arg(1)),StreamNumber(cmd->arg(2)),
 			  QString(cmd->arg(3)).toUInt());
     }
@@ -2,7 +2,7 @@
 //
 // Connection to the Rivendell Core Audio Engine
 //
-//   (C) Copyright 2002-2016 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2016,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -49,6 +49,8 @@ class RDCae : public QObject
   void positionPlay(int handle,int pos);
   void play(int handle,unsigned length,int speed,bool pitch);
   void stopPlay(int handle);
+  void setPlayMarker(int handle,int marker,unsigned pos);
+  void clearPlayMarkers(int handle);
   void loadRecord(int card,int stream,QString name,AudioCoding coding,
 		  int chan,int samp_rate,int bit_rate);
   void unloadRecord(int card,int stream);
@@ -73,6 +75,8 @@ class RDCae : public QObject
   void requestTimescale(int card);
   bool playPortActive(int card,int port,int except_stream=-1);
   void setPlayPortActive(int card,int port,int stream);
+  void beginBatch(unsigned delay=0);
+  unsigned commitBatch();
 
  signals:
   void isConnected(bool state);
@@ -84,12 +88,15 @@ class RDCae : public QObject
   void recordLoaded(int card,int stream);
   void recording(int card,int stream);
   void recordStopped(int card,int stream);
+  void recordAnalyzed(int card,int stream,int peak,int loudness);
   void recordUnloaded(int card,int stream,unsigned msecs);
   void gpiInputChanged(int line,bool state);
   void connected(bool state);
   void inputStatusChanged(int card,int stream,bool state);
   void playPositionChanged(int handle,unsigned sample);
+  void playMarker(int handle,int marker,unsigned pos,unsigned actual);
   void timescalingSupported(int card,bool state);
+  void batchCommitted(unsigned id,bool state);
 
  private slots:
   void readyData();
@@ -98,6 +105,7 @@ class RDCae : public QObject
   
  private:
   void SendCommand(QString cmd);
+  void WriteCommand(const QString &cmd);
   void DispatchCommand(RDCmdCache *cmd);
   int CardNumber(const char *arg);
   int StreamNumber(const char *arg);
@@ -121,6 +129,10 @@ class RDCae : public QObject
   unsigned cae_output_positions[RD_MAX_CARDS][RD_MAX_STREAMS];
   bool cae_output_status_flags[RD_MAX_CARDS][RD_MAX_PORTS][RD_MAX_STREAMS];
   std::vector<RDCmdCache> delayed_cmds;
+  int cae_batch_depth;
+  unsigned cae_batch_delay;
+  unsigned cae_batch_id;
+  QString cae_batch_cmds;
   RDStation *cae_station;
   RDConfig *cae_config;
 };
@@ -0,0 +1,362 @@
+// rdcapturewriter.cpp
+//
+// Background writer thread for captured audio
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "rdcapturewriter.h"
+
+//
+// Space that must be free in the output block before calling the encoder
+//
+#define RDCAPTUREWRITER_ENCODE_SPACE 16384
+
+//
+// How often the writer thread wakes up to drain the ring (mS)
+//
+#define RDCAPTUREWRITER_POLL_INTERVAL 50
+
+static inline int32_t ScaleSample(float sample,float scale,int32_t max)
+{
+  long v=lrintf(sample*scale);
+
+  if(v>max) {
+    return max;
+  }
+  if(v<(-max-1)) {
+    return -max-1;
+  }
+  return v;
+}
+
+
+RDCaptureWriter::RDCaptureWriter(RDWaveFile *wave,Format fmt,unsigned chans,
+				 unsigned ring_size)
+{
+  cap_wave=wave;
+  cap_format=fmt;
+  cap_channels=chans;
+  cap_running=false;
+  cap_exiting=false;
+  cap_frames_written=0;
+  cap_overruns=0;
+  cap_frames_dropped=0;
+  cap_write_error=false;
+  cap_out_len=0;
+
+  cap_ring=new RDRingBuffer(ring_size);
+  cap_ring->mlock();
+  cap_meter=new RDLoudnessMeter(cap_channels,cap_wave->getSamplesPerSec());
+  cap_pcm_frames=RD_CAPTURE_WRITE_SIZE/(sizeof(float)*cap_channels);
+  if(cap_pcm_frames<RD_CAPTURE_ENCODE_FRAMES) {
+    cap_pcm_frames=RD_CAPTURE_ENCODE_FRAMES;
+  }
+  cap_pcm_buffer=new float[cap_pcm_frames*cap_channels];
+  if(posix_memalign((void **)&cap_out_buffer,4096,
+		    RD_CAPTURE_WRITE_SIZE+RDCAPTUREWRITER_ENCODE_SPACE)!=0) {
+    cap_out_buffer=
+      (unsigned char *)malloc(RD_CAPTURE_WRITE_SIZE+
+			      RDCAPTUREWRITER_ENCODE_SPACE);
+  }
+  pthread_mutex_init(&cap_mutex,NULL);
+  pthread_cond_init(&cap_cond,NULL);
+}
+
+
+RDCaptureWriter::~RDCaptureWriter()
+{
+  stop();
+  pthread_cond_destroy(&cap_cond);
+  pthread_mutex_destroy(&cap_mutex);
+  free(cap_out_buffer);
+  delete[] cap_pcm_buffer;
+  delete cap_meter;
+  delete cap_ring;
+}
+
+
+RDWaveFile *RDCaptureWriter::wave() const
+{
+  return cap_wave;
+}
+
+
+RDCaptureWriter::Format RDCaptureWriter::format() const
+{
+  return cap_format;
+}
+
+
+unsigned RDCaptureWriter::channels() const
+{
+  return cap_channels;
+}
+
+
+bool RDCaptureWriter::start()
+{
+  pthread_attr_t pthread_attr;
+
+  if(cap_running) {
+    return true;
+  }
+  cap_exiting=false;
+  pthread_attr_init(&pthread_attr);
+  if(pthread_create(&cap_thread,&pthread_attr,
+		    RDCaptureWriter::ThreadCallback,this)!=0) {
+    pthread_attr_destroy(&pthread_attr);
+    return false;
+  }
+  pthread_attr_destroy(&pthread_attr);
+  cap_running=true;
+
+  return true;
+}
+
+
+void RDCaptureWriter::stop()
+{
+  if(cap_running) {
+    pthread_mutex_lock(&cap_mutex);
+    cap_exiting=true;
+    pthread_cond_signal(&cap_cond);
+    pthread_mutex_unlock(&cap_mutex);
+    pthread_join(cap_thread,NULL);
+    cap_running=false;
+  }
+  else {
+    Drain(true);
+  }
+}
+
+
+bool RDCaptureWriter::isRunning() const
+{
+  return cap_running;
+}
+
+
+unsigned RDCaptureWriter::writeFrames(const float *pcm,unsigned frames)
+{
+  //
+  // Called from the capture thread, so must never block. A block that
+  // does not fit is dropped whole so as to keep the stream frame-aligned.
+  //
+  size_t bytes=frames*cap_channels*sizeof(float);
+
+  if(cap_ring->writeSpace()<bytes) {
+    cap_overruns++;
+    cap_frames_dropped+=frames;
+    return 0;
+  }
+  cap_ring->write((char *)pcm,bytes);
+
+  return frames;
+}
+
+
+uint64_t RDCaptureWriter::framesWritten() const
+{
+  return cap_frames_written;
+}
+
+
+unsigned RDCaptureWriter::overruns() const
+{
+  return cap_overruns;
+}
+
+
+uint64_t RDCaptureWriter::framesDropped() const
+{
+  return cap_frames_dropped;
+}
+
+
+bool RDCaptureWriter::writeError() const
+{
+  return cap_write_error;
+}
+
+
+RDLoudnessMeter *RDCaptureWriter::loudnessMeter() const
+{
+  return cap_meter;
+}
+
+
+int RDCaptureWriter::encodeData(const float *pcm,unsigned frames,
+				unsigned char *data,int maxlen)
+{
+  return -1;
+}
+
+
+int RDCaptureWriter::flushEncoder(unsigned char *data,int maxlen)
+{
+  return 0;
+}
+
+
+ssize_t RDCaptureWriter::writeData(const void *data,size_t len)
+{
+  return cap_wave->writeWave((void *)data,len);
+}
+
+
+void *RDCaptureWriter::ThreadCallback(void *ptr)
+{
+  ((RDCaptureWriter *)ptr)->Run();
+
+  return NULL;
+}
+
+
+void RDCaptureWriter::Run()
+{
+  struct timespec ts;
+
+  pthread_mutex_lock(&cap_mutex);
+  while(!cap_exiting) {
+    clock_gettime(CLOCK_REALTIME,&ts);
+    ts.tv_nsec+=1000000*RDCAPTUREWRITER_POLL_INTERVAL;
+    if(ts.tv_nsec>=1000000000) {
+      ts.tv_sec++;
+      ts.tv_nsec-=1000000000;
+    }
+    pthread_cond_timedwait(&cap_cond,&cap_mutex,&ts);
+    pthread_mutex_unlock(&cap_mutex);
+    Drain(false);
+    pthread_mutex_lock(&cap_mutex);
+  }
+  pthread_mutex_unlock(&cap_mutex);
+  Drain(true);
+}
+
+
+void RDCaptureWriter::Drain(bool final)
+{
+  size_t frame_bytes=sizeof(float)*cap_channels;
+  unsigned avail;
+  unsigned frames;
+  int n;
+
+  while(true) {
+    avail=cap_ring->readSpace()/frame_bytes;
+    if(cap_format==RDCaptureWriter::Encoded) {
+      frames=RD_CAPTURE_ENCODE_FRAMES;
+      if(avail<frames) {
+	if((!final)||(avail==0)) {
+	  break;
+	}
+	frames=avail;
+      }
+    }
+    else {
+      frames=avail;
+      if(frames>cap_pcm_frames) {
+	frames=cap_pcm_frames;
+      }
+      if(frames==0) {
+	break;
+      }
+    }
+    cap_ring->read((char *)cap_pcm_buffer,frames*frame_bytes);
+    Process(cap_pcm_buffer,frames);
+  }
+  if(final) {
+    if(cap_format==RDCaptureWriter::Encoded) {
+      if((n=flushEncoder(cap_out_buffer+cap_out_len,
+			 RDCAPTUREWRITER_ENCODE_SPACE))>0) {
+	cap_out_len+=n;
+      }
+    }
+    Flush();
+  }
+}
+
+
+void RDCaptureWriter::Process(const float *pcm,unsigned frames)
+{
+  unsigned samples=frames*cap_channels;
+  unsigned char *out;
+  int32_t s;
+  int n;
+
+  switch(cap_format) {
+  case RDCaptureWriter::Pcm16:
+    if((cap_out_len+2*samples)>RD_CAPTURE_WRITE_SIZE) {
+      Flush();
+    }
+    out=cap_out_buffer+cap_out_len;
+    for(unsigned i=0;i<samples;i++) {
+      s=ScaleSample(pcm[i],32768.0,0x7FFF);
+      out[2*i]=s&0xFF;
+      out[2*i+1]=(s>>8)&0xFF;
+    }
+    cap_out_len+=2*samples;
+    break;
+
+  case RDCaptureWriter::Pcm24:
+    if((cap_out_len+3*samples)>RD_CAPTURE_WRITE_SIZE) {
+      Flush();
+    }
+    out=cap_out_buffer+cap_out_len;
+    for(unsigned i=0;i<samples;i++) {
+      s=ScaleSample(pcm[i],8388608.0,0x7FFFFF);
+      out[3*i]=s&0xFF;
+      out[3*i+1]=(s>>8)&0xFF;
+      out[3*i+2]=(s>>16)&0xFF;
+    }
+    cap_out_len+=3*samples;
+    break;
+
+  case RDCaptureWriter::Encoded:
+    if(cap_out_len>RD_CAPTURE_WRITE_SIZE) {
+      Flush();
+    }
+    if((n=encodeData(pcm,frames,cap_out_buffer+cap_out_len,
+		     RDCAPTUREWRITER_ENCODE_SPACE))<0) {
+      cap_write_error=true;
+      break;
+    }
+    cap_out_len+=n;
+    break;
+  }
+  cap_meter->process(pcm,frames);
+  cap_frames_written+=frames;
+  if(cap_out_len>=RD_CAPTURE_WRITE_SIZE) {
+    Flush();
+  }
+}
+
+
+void RDCaptureWriter::Flush()
+{
+  if(cap_out_len==0) {
+    return;
+  }
+  if(writeData(cap_out_buffer,cap_out_len)!=(ssize_t)cap_out_len) {
+    cap_write_error=true;
+  }
+  cap_out_len=0;
+}
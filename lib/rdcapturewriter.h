@@ -0,0 +1,101 @@
+// rdcapturewriter.h
+//
+// Background writer thread for captured audio
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDCAPTUREWRITER_H
+#define RDCAPTUREWRITER_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <rdloudnessmeter.h>
+#include <rdringbuffer.h>
+#include <rdwavefile.h>
+
+//
+// Size of the capture ring (bytes of interleaved float samples)
+// About ten seconds of stereo audio at 48 kHz.
+//
+#define RD_CAPTURE_RING_SIZE 4194304
+
+//
+// Size of the aligned blocks handed to the output file (bytes)
+//
+#define RD_CAPTURE_WRITE_SIZE 65536
+
+//
+// Number of frames passed to the encoder at a time
+//
+#define RD_CAPTURE_ENCODE_FRAMES 1152
+
+class RDCaptureWriter
+{
+ public:
+  enum Format {Pcm16=0,Pcm24=1,Encoded=2};
+  RDCaptureWriter(RDWaveFile *wave,Format fmt,unsigned chans,
+		  unsigned ring_size=RD_CAPTURE_RING_SIZE);
+  virtual ~RDCaptureWriter();
+  RDWaveFile *wave() const;
+  Format format() const;
+  unsigned channels() const;
+  bool start();
+  void stop();
+  bool isRunning() const;
+  unsigned writeFrames(const float *pcm,unsigned frames);
+  uint64_t framesWritten() const;
+  unsigned overruns() const;
+  uint64_t framesDropped() const;
+  bool writeError() const;
+  RDLoudnessMeter *loudnessMeter() const;
+
+ protected:
+  virtual int encodeData(const float *pcm,unsigned frames,
+			 unsigned char *data,int maxlen);
+  virtual int flushEncoder(unsigned char *data,int maxlen);
+  virtual ssize_t writeData(const void *data,size_t len);
+
+ private:
+  static void *ThreadCallback(void *ptr);
+  void Run();
+  void Drain(bool final);
+  void Process(const float *pcm,unsigned frames);
+  void Flush();
+  RDWaveFile *cap_wave;
+  Format cap_format;
+  unsigned cap_channels;
+  RDRingBuffer *cap_ring;
+  RDLoudnessMeter *cap_meter;
+  float *cap_pcm_buffer;
+  unsigned cap_pcm_frames;
+  unsigned char *cap_out_buffer;
+  size_t cap_out_len;
+  pthread_t cap_thread;
+  pthread_mutex_t cap_mutex;
+  pthread_cond_t cap_cond;
+  bool cap_running;
+  volatile bool cap_exiting;
+  volatile uint64_t cap_frames_written;
+  volatile unsigned cap_overruns;
+  volatile uint64_t cap_frames_dropped;
+  volatile bool cap_write_error;
+};
+
+
+#endif  // RDCAPTUREWRITER_H
@@ -34,6 +34,7 @@
 #include <rdconfig.h>
 #include <rdcart.h>
 #include <rdcut.h>
+#include <rdcutrotation.h>
 #include <rdescape_string.h>
 #include <rdformpost.h>
 #include <rdgroup.h>
@@ -84,6 +85,16 @@ bool RDCart::selectCut(QString *cut) const
 
 
 bool RDCart::selectCut(QString *cut,const QTime &time) const
+{
+  if(RDCutRotation::engine()!=NULL) {
+    return RDCutRotation::engine()->
+      selectCut(cart_number,QDateTime(QDate::currentDate(),time),cut);
+  }
+  return selectCutFromDatabase(cut,time);
+}
+
+
+bool RDCart::selectCutFromDatabase(QString *cut,const QTime &time) const
 {
   bool ret;
 
@@ -147,7 +158,7 @@ bool RDCart::selectCut(QString *cut,const QTime &time) const
       "CUT_NAME,"+
       "PLAY_ORDER,"+
       "WEIGHT,"+
-      "LOCAL_COUNTER "+
+      "LOCAL_COUNTER,"+
       "LAST_PLAY_DATETIME "+
       "from CUTS where "+
       QString().sprintf("(CART_NUMBER=%u)&&",cart_number)+
@@ -2391,9 +2402,8 @@ void RDCart::SetRow(const QString &param,const QString &value) const
   QString sql;
 
   sql=QString("update CART set ")+
-    param+"=\""+RDEscapeString(value)+"\" where "+
-    QString().sprintf("NUMBER=%u",cart_number);
-  q=new RDSqlQuery(sql);
+    param+"=? where NUMBER=?";
+  q=new RDSqlQuery(sql,QList<QVariant>()<<value<<cart_number);
   delete q;
 }
 
@@ -2404,8 +2414,8 @@ void RDCart::SetRow(const QString &param,unsigned value) const
   QString sql;
 
   sql=QString("update CART set ")+
-    param+QString().sprintf("=%d where NUMBER=%u",value,cart_number);
-  q=new RDSqlQuery(sql);
+    param+"=? where NUMBER=?";
+  q=new RDSqlQuery(sql,QList<QVariant>()<<(int)value<<cart_number);
   delete q;
 }
 
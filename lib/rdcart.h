@@ -49,6 +49,7 @@ class RDCart
   bool exists() const;
   bool selectCut(QString *cut) const;
   bool selectCut(QString *cut,const QTime &time) const;
+  bool selectCutFromDatabase(QString *cut,const QTime &time) const;
   RDCart::Type type() const;
   void setType(RDCart::Type type);
   unsigned number() const;
@@ -3,7 +3,7 @@
 // Generates a standardized SQL 'INNER JOIN' and 'WHERE' clause for
 // filtering Rivendell carts.
 //
-//   (C) Copyright 2002-2004,2016 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2004,2016,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -21,8 +21,42 @@
 
 #include <rdescape_string.h>
 #include <rdcart_search_text.h>
+#include <rdcartsearchindex.h>
 #include <rddb.h>
 
+//
+// Returns a predicate restricting the search to the carts found by the
+// search index, or an empty string if no index is available or it can't
+// narrow the search. The full 'like' clause is still applied to the
+// resulting carts, so the rows returned are exactly as before.
+//
+QString RDIndexSearchText(const QString &filter,const QStringList &groups,
+			  const QStringList &schedcodes,RDCart::Type type,
+			  bool incl_cuts)
+{
+  QString ret="";
+  QList<unsigned> carts;
+  RDCartSearchIndex *index=RDCartSearchIndex::engine();
+
+  if(index==NULL) {
+    return ret;
+  }
+  if(!index->search(&carts,filter,groups,schedcodes,type,incl_cuts)) {
+    return ret;
+  }
+  if(carts.size()==0) {
+    return QString(" (false)&&");
+  }
+  ret=" (CART.NUMBER in (";
+  for(int i=0;i<carts.size();i++) {
+    ret+=QString().sprintf("%u,",carts.at(i));
+  }
+  ret=ret.left(ret.length()-1)+"))&&";
+
+  return ret;
+}
+
+
 QString RDBaseSearchText(QString filter,bool incl_cuts)
 {
   QString edit_filter=filter;
@@ -129,12 +163,20 @@ QString RDSchedSearchText(const QStringList &schedcodes)
 
 
 QString RDCartSearchText(QString filter,const QString &group,
-			 const QString &schedcode,bool incl_cuts)
+			 const QString &schedcode,bool incl_cuts,
+			 RDCart::Type type)
 {
   QString ret="";
+  QStringList schedcodes;
 
+  if(!schedcode.isEmpty()) {
+    schedcodes.push_back(schedcode);
+  }
   ret+=RDSchedSearchText(schedcode);
-  ret+=QString(" where ")+RDBaseSearchText(filter,incl_cuts);
+  ret+=QString(" where ")+
+    RDIndexSearchText(filter,group.isEmpty()?QStringList():QStringList(group),
+		      schedcodes,type,incl_cuts)+
+    RDBaseSearchText(filter,incl_cuts);
   if(!group.isEmpty()) {
     ret+=QString("&&(CART.GROUP_NAME=\"")+RDEscapeString(group)+"\")";
   }
@@ -143,12 +185,16 @@ QString RDCartSearchText(QString filter,const QString &group,
 }
 
 QString RDCartSearchText(QString filter,const QString &group,
-			 const QStringList &schedcodes,bool incl_cuts)
+			 const QStringList &schedcodes,bool incl_cuts,
+			 RDCart::Type type)
 {
   QString ret="";
 
   ret+=RDSchedSearchText(schedcodes);
-  ret+=QString(" where ")+RDBaseSearchText(filter,incl_cuts);
+  ret+=QString(" where ")+
+    RDIndexSearchText(filter,group.isEmpty()?QStringList():QStringList(group),
+		      schedcodes,type,incl_cuts)+
+    RDBaseSearchText(filter,incl_cuts);
   if(!group.isEmpty()) {
     ret+=QString("&&(CART.GROUP_NAME=\"")+RDEscapeString(group)+"\")";
   }
@@ -158,11 +204,13 @@ QString RDCartSearchText(QString filter,const QString &group,
 
 
 QString RDAllCartSearchText(const QString &filter,const QString &schedcode,
-			    const QString &user,bool incl_cuts)
+			    const QString &user,bool incl_cuts,
+			    RDCart::Type type)
 {
   QString sql;
   RDSqlQuery *q;
   QString search="";
+  QStringList groups;
 
   search+=RDSchedSearchText(schedcode);
   search+=" where (";
@@ -172,20 +220,29 @@ QString RDAllCartSearchText(const QString &filter,const QString &schedcode,
   while(q->next()) {
     search+=QString("(CART.GROUP_NAME=\"")+
       RDEscapeString(q->value(0).toString())+"\")||";
+    groups.push_back(q->value(0).toString());
   }
   delete q;
   search=search.left(search.length()-2)+QString(")");
-  search+=QString("&&")+RDBaseSearchText(filter,incl_cuts);
+  search+=QString("&&");
+  if(groups.size()>0) {
+    search+=RDIndexSearchText(filter,groups,schedcode.isEmpty()?
+			      QStringList():QStringList(schedcode),
+			      type,incl_cuts);
+  }
+  search+=RDBaseSearchText(filter,incl_cuts);
 
   return search;
 }
 
 QString RDAllCartSearchText(const QString &filter,const QStringList &schedcodes,
-			    const QString &user,bool incl_cuts)
+			    const QString &user,bool incl_cuts,
+			    RDCart::Type type)
 {
   QString sql;
   RDSqlQuery *q;
   QString search="";
+  QStringList groups;
 
   search+=RDSchedSearchText(schedcodes);
   search+=" where (";
@@ -195,9 +252,14 @@ QString RDAllCartSearchText(const QString &filter,const QStringList &schedcodes,
   while(q->next()) {
     search+=QString("(CART.GROUP_NAME=\"")+
       RDEscapeString(q->value(0).toString())+"\")||";
+    groups.push_back(q->value(0).toString());
   }
   delete q;
   search=search.left(search.length()-2)+QString(")");
-  search+=QString("&&")+RDBaseSearchText(filter,incl_cuts);
+  search+=QString("&&");
+  if(groups.size()>0) {
+    search+=RDIndexSearchText(filter,groups,schedcodes,type,incl_cuts);
+  }
+  search+=RDBaseSearchText(filter,incl_cuts);
   return search;
 }
@@ -2,7 +2,7 @@
 //
 // Generates a standardized SQL 'WHERE' clause for filtering Rivendell carts.
 //
-//   (C) Copyright 2002-2004,2016 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2004,2016,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -24,17 +24,22 @@
 #include <qstring.h>
 #include <qstringlist.h>
 
+#include <rdcart.h>
 #include <rdstation.h>
 
 
 QString RDCartSearchText(QString filter,const QString &group,
-			 const QString &schedcode,bool incl_cuts);
+			 const QString &schedcode,bool incl_cuts,
+			 RDCart::Type type=RDCart::All);
 QString RDCartSearchText(QString filter,const QString &group,
-			 const QStringList &schedcodes,bool incl_cuts);
+			 const QStringList &schedcodes,bool incl_cuts,
+			 RDCart::Type type=RDCart::All);
 QString RDAllCartSearchText(const QString &filter,const QString &schedcode,
-			    const QString &user,bool incl_cuts);
+			    const QString &user,bool incl_cuts,
+			    RDCart::Type type=RDCart::All);
 QString RDAllCartSearchText(const QString &filter,const QStringList &schedcodes,
-			    const QString &user,bool incl_cuts);
+			    const QString &user,bool incl_cuts,
+			    RDCart::Type type=RDCart::All);
 
 
 #endif  // RDCART_SEARCH_TEXT_H
@@ -0,0 +1,618 @@
+// rdcartsearchindex.cpp
+//
+// In-memory token index for cart searches
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <algorithm>
+
+#include "rdapplication.h"
+#include "rdcartsearchindex.h"
+#include "rddb.h"
+
+//
+// Reduce a string to the form used for matching. This folds case and
+// strips diacritical marks, approximating the case- and accent-insensitive
+// collation used by 'like' in the database.
+//
+static QString Fold(const QString &str)
+{
+  QString ret;
+  QString norm=str.normalized(QString::NormalizationForm_D);
+
+  for(int i=0;i<norm.length();i++) {
+    if(norm.at(i).category()!=QChar::Mark_NonSpacing) {
+      ret+=norm.at(i).toLower();
+    }
+  }
+  return ret;
+}
+
+
+
+
+RDCartSearchIndexEntry::RDCartSearchIndexEntry()
+{
+  group_id=0;
+  type=0;
+}
+
+
+
+
+RDCartSearchIndex *RDCartSearchIndex::idx_engine=NULL;
+
+RDCartSearchIndex::RDCartSearchIndex(RDRipc *ripc,QObject *parent)
+  : QObject(parent)
+{
+  idx_loaded=false;
+
+  //
+  // Without an RDRipc connection we can't be kept in sync with the
+  // database, so the index is populated only through update().
+  //
+  idx_use_database=ripc!=NULL;
+  if(ripc!=NULL) {
+    connect(ripc,SIGNAL(notificationReceived(RDNotification *)),
+	    this,SLOT(notificationReceivedData(RDNotification *)));
+  }
+
+  idx_engine=this;
+}
+
+
+RDCartSearchIndex::~RDCartSearchIndex()
+{
+  if(idx_engine==this) {
+    idx_engine=NULL;
+  }
+}
+
+
+bool RDCartSearchIndex::search(QList<unsigned> *carts,const QString &filter,
+			       const QStringList &groups,
+			       const QStringList &schedcodes,
+			       RDCart::Type type,bool incl_cuts)
+{
+  std::vector<unsigned> matches;
+  std::set<unsigned> group_ids;
+  std::vector<unsigned> sched_ids;
+  QStringList terms;
+  unsigned stage;
+  unsigned advanced;
+  unsigned cartnum;
+
+  Refresh();
+  carts->clear();
+
+  //
+  // Every alphanumeric run in the filter must appear within a single
+  // token of a matching cart, whether the filter is quoted or not and
+  // whatever the surrounding punctuation or wildcards, so the index
+  // returns a superset of what 'like' would match.
+  //
+  QStringList words=RDCartSearchIndex::tokens(filter);
+  for(int i=0;i<words.size();i++) {
+    if(!terms.contains(words.at(i))) {
+      terms.push_back(words.at(i));
+    }
+  }
+  while(terms.size()>254) {
+    terms.removeLast();
+  }
+
+  //
+  // Groups and Scheduler Codes
+  //
+  for(int i=0;i<groups.size();i++) {
+    QHash<QString,unsigned>::const_iterator it=
+      idx_group_ids.find(groups.at(i).toLower());
+    if(it!=idx_group_ids.end()) {
+      group_ids.insert(it.value());
+    }
+  }
+  if((groups.size()>0)&&(group_ids.size()==0)) {
+    return true;
+  }
+  for(int i=0;i<schedcodes.size();i++) {
+    QHash<QString,unsigned>::const_iterator it=
+      idx_sched_ids.find(schedcodes.at(i).toLower());
+    if(it==idx_sched_ids.end()) {
+      return true;
+    }
+    sched_ids.push_back(it.value());
+  }
+  if(idx_carts.size()==0) {
+    return true;
+  }
+
+  //
+  // Find the carts containing each term in turn
+  //
+  if(terms.size()==0) {
+    for(std::map<unsigned,RDCartSearchIndexEntry>::const_iterator it=
+	  idx_carts.begin();it!=idx_carts.end();it++) {
+      matches.push_back(it->first);
+    }
+  }
+  else {
+    idx_marks.assign(idx_carts.rbegin()->first+1,0);
+    for(stage=0;stage<(unsigned)terms.size();stage++) {
+      QByteArray term=terms.at(stage).toUtf8();
+      advanced=0;
+      for(unsigned i=0;i<idx_tokens.size();i++) {
+	if(idx_tokens[i].contains(term)) {
+	  const std::vector<unsigned> &posts=idx_postings[i];
+	  for(unsigned j=0;j<posts.size();j++) {
+	    if(((posts[j]&1)==0)||incl_cuts) {
+	      cartnum=posts[j]>>1;
+	      if(idx_marks[cartnum]==stage) {
+		idx_marks[cartnum]=stage+1;
+		advanced++;
+		if(stage==((unsigned)terms.size()-1)) {
+		  matches.push_back(cartnum);
+		}
+	      }
+	    }
+	  }
+	}
+      }
+      if(advanced==0) {
+	return true;
+      }
+    }
+    std::sort(matches.begin(),matches.end());
+  }
+
+  //
+  // Apply the filters
+  //
+  for(unsigned i=0;i<matches.size();i++) {
+    const RDCartSearchIndexEntry &entry=idx_carts[matches[i]];
+    if((group_ids.size()>0)&&(group_ids.count(entry.group_id)==0)) {
+      continue;
+    }
+    if(!TypeMatches(entry.type,type)) {
+      continue;
+    }
+    bool found=true;
+    for(unsigned j=0;j<sched_ids.size();j++) {
+      if(std::find(entry.sched_ids.begin(),entry.sched_ids.end(),
+		   sched_ids[j])==entry.sched_ids.end()) {
+	found=false;
+	break;
+      }
+    }
+    if(!found) {
+      continue;
+    }
+    if(carts->size()>=RD_CART_SEARCH_INDEX_MAX_CARTS) {
+      carts->clear();
+      return false;
+    }
+    carts->push_back(matches[i]);
+  }
+
+  return true;
+}
+
+
+void RDCartSearchIndex::update(unsigned cartnum,const QString &group,int type,
+			       const QStringList &schedcodes,
+			       const QStringList &cart_fields,
+			       const QStringList &cut_fields)
+{
+  remove(cartnum);
+  AddCart(cartnum,group,type,schedcodes,cart_fields,cut_fields,false);
+}
+
+
+void RDCartSearchIndex::remove(unsigned cartnum)
+{
+  std::map<unsigned,RDCartSearchIndexEntry>::iterator it=
+    idx_carts.find(cartnum);
+  if(it==idx_carts.end()) {
+    return;
+  }
+  for(unsigned i=0;i<it->second.keys.size();i++) {
+    std::vector<unsigned> &posts=idx_postings[it->second.keys[i]>>1];
+    unsigned key=(cartnum<<1)|(it->second.keys[i]&1);
+    std::vector<unsigned>::iterator pos=
+      std::lower_bound(posts.begin(),posts.end(),key);
+    if((pos!=posts.end())&&(*pos==key)) {
+      posts.erase(pos);
+    }
+  }
+  idx_carts.erase(it);
+}
+
+
+void RDCartSearchIndex::invalidate(unsigned cartnum)
+{
+  if(idx_use_database) {
+    idx_pending_carts.insert(cartnum);
+  }
+  else {
+    remove(cartnum);
+  }
+}
+
+
+bool RDCartSearchIndex::load()
+{
+  QString sql;
+  RDSqlQuery *q=NULL;
+  QStringList fields;
+  std::map<unsigned,RDCartSearchIndexEntry>::iterator it;
+
+  clear();
+
+  //
+  // Carts
+  //
+  sql=QString("select ")+
+    "NUMBER,"+        // 00
+    "GROUP_NAME,"+    // 01
+    "TYPE,"+          // 02
+    "TITLE,"+         // 03
+    "ARTIST,"+        // 04
+    "CLIENT,"+        // 05
+    "AGENCY,"+        // 06
+    "ALBUM,"+         // 07
+    "LABEL,"+         // 08
+    "PUBLISHER,"+     // 09
+    "COMPOSER,"+      // 10
+    "CONDUCTOR,"+     // 11
+    "SONG_ID,"+       // 12
+    "USER_DEFINED "+  // 13
+    "from CART order by NUMBER";
+  q=new RDSqlQuery(sql);
+  if(!q->isActive()) {
+    delete q;
+    return false;
+  }
+  while(q->next()) {
+    fields.clear();
+    fields.push_back(q->value(0).toString());
+    for(int i=3;i<14;i++) {
+      fields.push_back(q->value(i).toString());
+    }
+    AddCart(q->value(0).toUInt(),q->value(1).toString(),q->value(2).toInt(),
+	    QStringList(),fields,QStringList(),true);
+  }
+  delete q;
+
+  //
+  // Cuts
+  //
+  sql=QString("select ")+
+    "CART_NUMBER,"+   // 00
+    "ISCI,"+          // 01
+    "ISRC,"+          // 02
+    "DESCRIPTION,"+   // 03
+    "OUTCUE "+        // 04
+    "from CUTS order by CART_NUMBER";
+  q=new RDSqlQuery(sql);
+  while(q->next()) {
+    if((it=idx_carts.find(q->value(0).toUInt()))!=idx_carts.end()) {
+      for(int i=1;i<5;i++) {
+	AddTokens(&it->second,it->first,q->value(i).toString(),true,true);
+      }
+    }
+  }
+  delete q;
+
+  //
+  // Scheduler Codes
+  //
+  sql=QString("select ")+
+    "CART_NUMBER,"+   // 00
+    "SCHED_CODE "+    // 01
+    "from CART_SCHED_CODES";
+  q=new RDSqlQuery(sql);
+  while(q->next()) {
+    if((it=idx_carts.find(q->value(0).toUInt()))!=idx_carts.end()) {
+      it->second.sched_ids.push_back(SchedId(q->value(1).toString()));
+    }
+  }
+  delete q;
+
+  //
+  // Bulk additions are appended unsorted, so tidy up now
+  //
+  for(unsigned i=0;i<idx_postings.size();i++) {
+    std::sort(idx_postings[i].begin(),idx_postings[i].end());
+    idx_postings[i].erase(std::unique(idx_postings[i].begin(),
+				      idx_postings[i].end()),
+			  idx_postings[i].end());
+  }
+  for(it=idx_carts.begin();it!=idx_carts.end();it++) {
+    std::sort(it->second.keys.begin(),it->second.keys.end());
+    it->second.keys.erase(std::unique(it->second.keys.begin(),
+				      it->second.keys.end()),
+			  it->second.keys.end());
+  }
+
+  idx_loaded=true;
+  idx_load_datetime=QDateTime::currentDateTime();
+  rda->syslog(LOG_DEBUG,"RDCartSearchIndex: indexed %u carts, %u tokens",
+	      size(),tokenQuantity());
+
+  return true;
+}
+
+
+void RDCartSearchIndex::clear()
+{
+  idx_tokens.clear();
+  idx_postings.clear();
+  idx_token_ids.clear();
+  idx_carts.clear();
+  idx_group_ids.clear();
+  idx_sched_ids.clear();
+  idx_marks.clear();
+  idx_pending_carts.clear();
+  idx_loaded=false;
+}
+
+
+unsigned RDCartSearchIndex::size() const
+{
+  return idx_carts.size();
+}
+
+
+unsigned RDCartSearchIndex::tokenQuantity() const
+{
+  return idx_tokens.size();
+}
+
+
+QStringList RDCartSearchIndex::tokens(const QString &str)
+{
+  QStringList ret;
+  QString folded=Fold(str);
+  int start=-1;
+
+  for(int i=0;i<=folded.length();i++) {
+    if((i<folded.length())&&folded.at(i).isLetterOrNumber()) {
+      if(start<0) {
+	start=i;
+      }
+    }
+    else {
+      if(start>=0) {
+	ret.push_back(folded.mid(start,i-start));
+	start=-1;
+      }
+    }
+  }
+
+  return ret;
+}
+
+
+RDCartSearchIndex *RDCartSearchIndex::engine()
+{
+  return idx_engine;
+}
+
+
+void RDCartSearchIndex::notificationReceivedData(RDNotification *notify)
+{
+  if(notify->type()==RDNotification::CartType) {
+    invalidate(notify->id().toUInt());
+  }
+}
+
+
+void RDCartSearchIndex::AddCart(unsigned cartnum,const QString &group,
+				int type,const QStringList &schedcodes,
+				const QStringList &cart_fields,
+				const QStringList &cut_fields,bool bulk)
+{
+  RDCartSearchIndexEntry *entry=&idx_carts[cartnum];
+
+  entry->group_id=GroupId(group);
+  entry->type=type;
+  for(int i=0;i<schedcodes.size();i++) {
+    entry->sched_ids.push_back(SchedId(schedcodes.at(i)));
+  }
+  for(int i=0;i<cart_fields.size();i++) {
+    AddTokens(entry,cartnum,cart_fields.at(i),false,bulk);
+  }
+  for(int i=0;i<cut_fields.size();i++) {
+    AddTokens(entry,cartnum,cut_fields.at(i),true,bulk);
+  }
+  if(!bulk) {
+    std::sort(entry->keys.begin(),entry->keys.end());
+    entry->keys.erase(std::unique(entry->keys.begin(),entry->keys.end()),
+		      entry->keys.end());
+  }
+}
+
+
+void RDCartSearchIndex::AddTokens(RDCartSearchIndexEntry *entry,
+				  unsigned cartnum,const QString &str,
+				  bool cut,bool bulk)
+{
+  QStringList words=RDCartSearchIndex::tokens(str);
+  unsigned id;
+  unsigned key=(cartnum<<1)|(cut?1:0);
+
+  for(int i=0;i<words.size();i++) {
+    QByteArray word=words.at(i).toUtf8();
+    QHash<QByteArray,unsigned>::const_iterator it=idx_token_ids.find(word);
+    if(it==idx_token_ids.end()) {
+      id=idx_tokens.size();
+      idx_tokens.push_back(word);
+      idx_postings.push_back(std::vector<unsigned>());
+      idx_token_ids[word]=id;
+    }
+    else {
+      id=it.value();
+    }
+    std::vector<unsigned> &posts=idx_postings[id];
+    if(bulk||posts.empty()||(posts.back()<key)) {
+      posts.push_back(key);
+    }
+    else {
+      std::vector<unsigned>::iterator pos=
+	std::lower_bound(posts.begin(),posts.end(),key);
+      if((pos==posts.end())||(*pos!=key)) {
+	posts.insert(pos,key);
+      }
+    }
+    entry->keys.push_back((id<<1)|(cut?1:0));
+  }
+}
+
+
+void RDCartSearchIndex::ReloadCart(unsigned cartnum)
+{
+  QString sql;
+  RDSqlQuery *q=NULL;
+  QString group;
+  int type=0;
+  QStringList schedcodes;
+  QStringList cart_fields;
+  QStringList cut_fields;
+
+  remove(cartnum);
+
+  sql=QString("select ")+
+    "GROUP_NAME,"+    // 00
+    "TYPE,"+          // 01
+    "TITLE,"+         // 02
+    "ARTIST,"+        // 03
+    "CLIENT,"+        // 04
+    "AGENCY,"+        // 05
+    "ALBUM,"+         // 06
+    "LABEL,"+         // 07
+    "PUBLISHER,"+     // 08
+    "COMPOSER,"+      // 09
+    "CONDUCTOR,"+     // 10
+    "SONG_ID,"+       // 11
+    "USER_DEFINED "+  // 12
+    "from CART where "+
+    QString().sprintf("NUMBER=%u",cartnum);
+  q=new RDSqlQuery(sql);
+  if(!q->first()) {  // Deleted
+    delete q;
+    return;
+  }
+  group=q->value(0).toString();
+  type=q->value(1).toInt();
+  cart_fields.push_back(QString().sprintf("%u",cartnum));
+  for(int i=2;i<13;i++) {
+    cart_fields.push_back(q->value(i).toString());
+  }
+  delete q;
+
+  sql=QString("select ")+
+    "ISCI,"+          // 00
+    "ISRC,"+          // 01
+    "DESCRIPTION,"+   // 02
+    "OUTCUE "+        // 03
+    "from CUTS where "+
+    QString().sprintf("CART_NUMBER=%u",cartnum);
+  q=new RDSqlQuery(sql);
+  while(q->next()) {
+    for(int i=0;i<4;i++) {
+      cut_fields.push_back(q->value(i).toString());
+    }
+  }
+  delete q;
+
+  sql=QString("select SCHED_CODE from CART_SCHED_CODES where ")+
+    QString().sprintf("CART_NUMBER=%u",cartnum);
+  q=new RDSqlQuery(sql);
+  while(q->next()) {
+    schedcodes.push_back(q->value(0).toString());
+  }
+  delete q;
+
+  AddCart(cartnum,group,type,schedcodes,cart_fields,cut_fields,false);
+}
+
+
+void RDCartSearchIndex::Refresh()
+{
+  if(!idx_use_database) {
+    return;
+  }
+  if((!idx_loaded)||(idx_load_datetime.secsTo(QDateTime::currentDateTime())>=
+		     RD_CART_SEARCH_INDEX_MAX_AGE)) {
+    load();
+    return;
+  }
+  for(std::set<unsigned>::const_iterator it=idx_pending_carts.begin();
+      it!=idx_pending_carts.end();it++) {
+    ReloadCart(*it);
+  }
+  idx_pending_carts.clear();
+}
+
+
+unsigned RDCartSearchIndex::GroupId(const QString &group)
+{
+  QString name=group.toLower();
+  QHash<QString,unsigned>::const_iterator it=idx_group_ids.find(name);
+
+  if(it!=idx_group_ids.end()) {
+    return it.value();
+  }
+  unsigned id=idx_group_ids.size();
+  idx_group_ids[name]=id;
+
+  return id;
+}
+
+
+unsigned RDCartSearchIndex::SchedId(const QString &schedcode)
+{
+  QString name=schedcode.toLower();
+  QHash<QString,unsigned>::const_iterator it=idx_sched_ids.find(name);
+
+  if(it!=idx_sched_ids.end()) {
+    return it.value();
+  }
+  unsigned id=idx_sched_ids.size();
+  idx_sched_ids[name]=id;
+
+  return id;
+}
+
+
+bool RDCartSearchIndex::TypeMatches(int type,RDCart::Type filter) const
+{
+  //
+  // Same grouping as used by the type filters in rdlibrary(1), where
+  // a TYPE of 3 is shown along with audio carts.
+  //
+  switch(filter) {
+  case RDCart::Audio:
+    return (type==RDCart::Audio)||(type==3);
+
+  case RDCart::Macro:
+    return type==RDCart::Macro;
+
+  case RDCart::All:
+    break;
+  }
+  return true;
+}
@@ -0,0 +1,110 @@
+// rdcartsearchindex.h
+//
+// In-memory token index for cart searches
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDCARTSEARCHINDEX_H
+#define RDCARTSEARCHINDEX_H
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include <qdatetime.h>
+#include <qhash.h>
+#include <qlist.h>
+#include <qobject.h>
+#include <qstringlist.h>
+
+#include <rdcart.h>
+#include <rdnotification.h>
+#include <rdripc.h>
+
+//
+// Maximum age of the index before it is rebuilt from scratch (seconds)
+//
+#define RD_CART_SEARCH_INDEX_MAX_AGE 3600
+
+//
+// Largest result set returned as a cart list. Searches matching more
+// carts than this are left to the database.
+//
+#define RD_CART_SEARCH_INDEX_MAX_CARTS 10000
+
+class RDCartSearchIndexEntry
+{
+ public:
+  RDCartSearchIndexEntry();
+  unsigned group_id;
+  int type;
+  std::vector<unsigned> sched_ids;
+  std::vector<unsigned> keys;
+};
+
+
+class RDCartSearchIndex : public QObject
+{
+  Q_OBJECT;
+ public:
+  RDCartSearchIndex(RDRipc *ripc,QObject *parent=0);
+  ~RDCartSearchIndex();
+  bool search(QList<unsigned> *carts,const QString &filter,
+	      const QStringList &groups,const QStringList &schedcodes,
+	      RDCart::Type type,bool incl_cuts);
+  void update(unsigned cartnum,const QString &group,int type,
+	      const QStringList &schedcodes,const QStringList &cart_fields,
+	      const QStringList &cut_fields);
+  void remove(unsigned cartnum);
+  void invalidate(unsigned cartnum);
+  bool load();
+  void clear();
+  unsigned size() const;
+  unsigned tokenQuantity() const;
+  static QStringList tokens(const QString &str);
+  static RDCartSearchIndex *engine();
+
+ private slots:
+  void notificationReceivedData(RDNotification *notify);
+
+ private:
+  void AddCart(unsigned cartnum,const QString &group,int type,
+	       const QStringList &schedcodes,const QStringList &cart_fields,
+	       const QStringList &cut_fields,bool bulk);
+  void AddTokens(RDCartSearchIndexEntry *entry,unsigned cartnum,
+		 const QString &str,bool cut,bool bulk);
+  void ReloadCart(unsigned cartnum);
+  void Refresh();
+  unsigned GroupId(const QString &group);
+  unsigned SchedId(const QString &schedcode);
+  bool TypeMatches(int type,RDCart::Type filter) const;
+  std::vector<QByteArray> idx_tokens;
+  std::vector<std::vector<unsigned> > idx_postings;
+  QHash<QByteArray,unsigned> idx_token_ids;
+  std::map<unsigned,RDCartSearchIndexEntry> idx_carts;
+  QHash<QString,unsigned> idx_group_ids;
+  QHash<QString,unsigned> idx_sched_ids;
+  std::vector<unsigned char> idx_marks;
+  std::set<unsigned> idx_pending_carts;
+  bool idx_loaded;
+  bool idx_use_database;
+  QDateTime idx_load_datetime;
+  static RDCartSearchIndex *idx_engine;
+};
+
+
+#endif  // RDCARTSEARCHINDEX_H
@@ -2,7 +2,7 @@
 //
 // The cart slot widget.
 //
-//   (C) Copyright 2012-2019 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2012-2019,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -23,6 +23,7 @@
 #include <qpainter.h>
 #include <qbitmap.h>
 
+#include "rdapplication.h"
 #include "rdconfig.h"
 #include "rdconf.h"
 #include "rdescape_string.h"
@@ -658,8 +659,6 @@ void RDCartSlot::LogPlayout(RDPlayDeck::State state)
   if(state==RDPlayDeck::Stopped) {
     action=RDAirPlayConf::TrafficStop;
   }
-  QString sql;
-  RDSqlQuery *q;
   QDateTime datetime=QDateTime(QDate::currentDate(),QTime::currentTime());
   int length=
     slot_logline->startTime(RDLogLine::Actual).msecsTo(datetime.time());
@@ -670,47 +669,45 @@ void RDCartSlot::LogPlayout(RDPlayDeck::State state)
   if(!slot_svcname.isEmpty()) {
     QDateTime eventDateTime(datetime.date(), 
           slot_logline->startTime(RDLogLine::Actual));
-    QString svctablename=slot_svcname;
-    svctablename.replace(" ","_");
-    sql=QString("insert into ELR_LINES set ")+
-      "SERVICE_NAME=\""+RDEscapeString(slot_svcname)+"\","+
-      QString().sprintf("LENGTH=%d,",length)+
-      QString().sprintf("LOG_ID=%d,",slot_number+1)+
-      QString().sprintf("CART_NUMBER=%u,",slot_logline->cartNumber())+
-      QString().sprintf("EVENT_TYPE=%d,",action)+
-      QString().sprintf("EVENT_SOURCE=%d,",slot_logline->source())+
-      QString().sprintf("EXT_LENGTH=%d,",slot_logline->extLength())+
-      QString().sprintf("PLAY_SOURCE=%d,",RDLogLine::CartSlot)+
-      QString().sprintf("CUT_NUMBER=%d,",slot_logline->cutNumber())+
-      QString().sprintf("USAGE_CODE=%d,",slot_logline->usageCode())+
-      QString().sprintf("START_SOURCE=%d,",slot_logline->startSource())+
-      "STATION_NAME=\""+RDEscapeString(slot_station->name())+"\","+
-      "EVENT_DATETIME="+RDCheckDateTime(eventDateTime,"yyyy-MM-dd hh:mm:ss")+
-      ","+
-      "EXT_START_TIME="+RDCheckDateTime(
-                 slot_logline->extStartTime(),"hh:mm:ss")+","+
-      "EXT_DATA=\""+RDEscapeString(slot_logline->extData())+"\","+
-      "EXT_EVENT_ID=\""+RDEscapeString(slot_logline->extEventId())+"\","+
-      "EXT_ANNC_TYPE=\""+RDEscapeString(slot_logline->extAnncType())+"\","+
-      "EXT_CART_NAME=\""+RDEscapeString(slot_logline->extCartName())+"\","+
-      "TITLE=\""+RDEscapeString(slot_logline->title())+"\","+
-      "ARTIST=\""+RDEscapeString(slot_logline->artist())+"\","+
-      "SCHEDULED_TIME="+
-      RDCheckDateTime(slot_logline->startTime(RDLogLine::Logged),"hh:mm:ss")+","+
-      "ISRC=\""+RDEscapeString(slot_logline->isrc())+"\","+
-      "PUBLISHER=\""+RDEscapeString(slot_logline->publisher())+"\","+
-      "COMPOSER=\""+RDEscapeString(slot_logline->composer())+"\","+
-      "ONAIR_FLAG=\""+RDYesNo(slot_ripc->onairFlag())+"\","+
-      "ALBUM=\""+RDEscapeString(slot_logline->album())+"\","+
-      "LABEL=\""+RDEscapeString(slot_logline->label())+"\","+
-      "CONDUCTOR=\""+RDEscapeString(slot_logline->conductor())+"\","+
-      "USER_DEFINED=\""+RDEscapeString(slot_logline->userDefined())+"\","+
-      "SONG_ID=\""+RDEscapeString(slot_logline->songId())+"\","+
-      "DESCRIPTION=\""+RDEscapeString(slot_logline->description())+"\","+
-      "OUTCUE=\""+RDEscapeString(slot_logline->outcue())+"\","+
-      "ISCI=\""+RDEscapeString(slot_logline->isci())+"\"";
-    q=new RDSqlQuery(sql);
-    delete q;
+    RDElrRecord rec;
+    rec.setValue("SERVICE_NAME",slot_svcname);
+    rec.setValue("LENGTH",length);
+    rec.setValue("LOG_ID",slot_number+1);
+    rec.setValue("CART_NUMBER",slot_logline->cartNumber());
+    rec.setValue("EVENT_TYPE",action);
+    rec.setValue("EVENT_SOURCE",slot_logline->source());
+    rec.setValue("EXT_LENGTH",slot_logline->extLength());
+    rec.setValue("PLAY_SOURCE",RDLogLine::CartSlot);
+    rec.setValue("CUT_NUMBER",slot_logline->cutNumber());
+    rec.setValue("USAGE_CODE",slot_logline->usageCode());
+    rec.setValue("START_SOURCE",slot_logline->startSource());
+    rec.setValue("STATION_NAME",slot_station->name());
+    rec.setLiteral("EVENT_DATETIME",
+		   RDCheckDateTime(eventDateTime,"yyyy-MM-dd hh:mm:ss"));
+    rec.setLiteral("EXT_START_TIME",
+		   RDCheckDateTime(slot_logline->extStartTime(),"hh:mm:ss"));
+    rec.setValue("EXT_DATA",slot_logline->extData());
+    rec.setValue("EXT_EVENT_ID",slot_logline->extEventId());
+    rec.setValue("EXT_ANNC_TYPE",slot_logline->extAnncType());
+    rec.setValue("EXT_CART_NAME",slot_logline->extCartName());
+    rec.setValue("TITLE",slot_logline->title());
+    rec.setValue("ARTIST",slot_logline->artist());
+    rec.setLiteral("SCHEDULED_TIME",
+		   RDCheckDateTime(slot_logline->startTime(RDLogLine::Logged),
+				   "hh:mm:ss"));
+    rec.setValue("ISRC",slot_logline->isrc());
+    rec.setValue("PUBLISHER",slot_logline->publisher());
+    rec.setValue("COMPOSER",slot_logline->composer());
+    rec.setValue("ONAIR_FLAG",RDYesNo(slot_ripc->onairFlag()));
+    rec.setValue("ALBUM",slot_logline->album());
+    rec.setValue("LABEL",slot_logline->label());
+    rec.setValue("CONDUCTOR",slot_logline->conductor());
+    rec.setValue("USER_DEFINED",slot_logline->userDefined());
+    rec.setValue("SONG_ID",slot_logline->songId());
+    rec.setValue("DESCRIPTION",slot_logline->description());
+    rec.setValue("OUTCUE",slot_logline->outcue());
+    rec.setValue("ISCI",slot_logline->isci());
+    rda->elrJournal()->append(rec);
   }
 }
 
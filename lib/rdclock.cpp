@@ -2,7 +2,7 @@
 //
 // Abstract a Rivendell Log Manager Clock.
 //
-//   (C) Copyright 2002-2019 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2019,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -295,12 +295,27 @@ bool RDClock::validate(const QTime &start_time,int length,int except_line)
 
 
 bool RDClock::generateLog(int hour,const QString &logname,
-			  const QString &svc_name,QString *errors)
+			  const QString &svc_name,QString *errors,
+			  RDLogTemplateCache *cache)
 {
   QString sql;
   RDSqlQuery *q;
   RDEventLine eventline(clock_station);
 
+  if(cache!=NULL) {
+    QList<RDLogTemplateCache::ClockLine> lines=cache->clockLines(clock_name);
+    for(int i=0;i<lines.size();i++) {
+      RDEventLine *evt=cache->eventLine(lines.at(i).event_name);
+      if(evt!=NULL) {
+	evt->setStartTime(QTime().addMSecs(lines.at(i).start_time).
+			  addSecs(3600*hour));
+	evt->setLength(lines.at(i).length);
+	evt->generateLog(logname,svc_name,errors,clock_name);
+      }
+    }
+    return true;
+  }
+
   sql=QString("select ")+
     "EVENT_NAME,"+  // 00
     "START_TIME,"+  // 01
@@ -2,7 +2,7 @@
 //
 // Abstract a Rivendell Log Manager Clock
 //
-//   (C) Copyright 2002-2019 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2019,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -24,6 +24,7 @@
 #include <vector>
 
 #include <rdevent_line.h>
+#include <rdlogtemplatecache.h>
 #include <rdstation.h>
 
 class RDClock
@@ -52,7 +53,7 @@ class RDClock
    void remove(int line);
    bool validate(const QTime &start_time,int length,int except_line=-1);
    bool generateLog(int hour,const QString &logname,const QString &svc_name,
-		    QString *errors);
+		    QString *errors,RDLogTemplateCache *cache=NULL);
 
   private:
    QString clock_name;
@@ -2,7 +2,7 @@
 //
 //  Small library for handling common configuration file tasks
 // 
-//   (C) Copyright 1996-2018 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 1996-2018,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU Library General Public License 
@@ -41,6 +41,7 @@
 #include "rdconf.h"
 #include "rddatetime.h"
 #include "rdescape_string.h"
+#include "rdsnapshot.h"
 
 #define BUFFER_SIZE 1024
 
@@ -492,9 +493,8 @@ bool RDDoesRowExist(const QString &table,const QString &name,
   RDSqlQuery *q;
   QString sql;
 
-  sql="select `"+name+"` from `"+table+"` where `"+name+"`="+
-    "\""+RDEscapeString(test)+"\"";
-  q=new RDSqlQuery(sql);
+  sql="select `"+name+"` from `"+table+"` where `"+name+"`=?";
+  q=new RDSqlQuery(sql,QList<QVariant>()<<test);
   if(q->first()) {
     delete q;
     return true;
@@ -510,9 +510,8 @@ bool RDDoesRowExist(const QString &table,const QString &name,unsigned test,
   RDSqlQuery *q;
   QString sql;
 
-  sql="select `"+name+"` from `"+table+"` where `"+name+"`="+
-    QString().sprintf("%d",test);
-  q=new RDSqlQuery(sql);
+  sql="select `"+name+"` from `"+table+"` where `"+name+"`=?";
+  q=new RDSqlQuery(sql,QList<QVariant>()<<test);
   if(q->size()>0) {
     delete q;
     return true;
@@ -530,9 +529,12 @@ QVariant RDGetSqlValue(const QString &table,const QString &name,
   QString sql;
   QVariant v;
 
-  sql="select `"+param+"` from `"+table+"` where `"+name+"`="+
-    "\""+RDEscapeString(test)+"\"";
-  q=new RDSqlQuery(sql);
+  if(RDSnapshot::value(table,name,test,param,&v,valid)) {
+    return v;
+  }
+
+  sql="select `"+param+"` from `"+table+"` where `"+name+"`=?";
+  q=new RDSqlQuery(sql,QList<QVariant>()<<test);
   if(q->isActive()) {
     q->first();
     v=q->value(0);
@@ -553,9 +555,8 @@ bool RDIsSqlNull(const QString &table,const QString &name,const QString &test,
   RDSqlQuery *q;
   QString sql;
 
-  sql="select `"+param+"` from `"+table+"` where `"+name+"`="+
-    "\""+RDEscapeString(test)+"\"";
-  q=new RDSqlQuery(sql);
+  sql="select `"+param+"` from `"+table+"` where `"+name+"`=?";
+  q=new RDSqlQuery(sql,QList<QVariant>()<<test);
   if(q->isActive()) {
     q->first();
     if(q->isNull(0)) {
@@ -578,9 +579,8 @@ bool RDIsSqlNull(const QString &table,const QString &name,unsigned test,
   RDSqlQuery *q;
   QString sql;
 
-  sql="select `"+param+"` from `"+table+"` where `"+name+"`="+
-    QString().sprintf("%d",test);
-  q=new RDSqlQuery(sql);
+  sql="select `"+param+"` from `"+table+"` where `"+name+"`=?";
+  q=new RDSqlQuery(sql,QList<QVariant>()<<test);
   if(q->isActive()) {
     q->first();
     if(q->isNull(0)) {
@@ -604,9 +604,12 @@ QVariant RDGetSqlValue(const QString &table,const QString &name,unsigned test,
   QString sql;
   QVariant v;
 
-  sql="select `"+param+"` from `"+table+"` where `"+name+"`="+
-    QString().sprintf("%u",test);
-  q=new RDSqlQuery(sql);
+  if(RDSnapshot::value(table,name,test,param,&v,valid)) {
+    return v;
+  }
+
+  sql="select `"+param+"` from `"+table+"` where `"+name+"`=?";
+  q=new RDSqlQuery(sql,QList<QVariant>()<<test);
   if(q->first()) {
     v=q->value(0);
     if(valid!=NULL) {
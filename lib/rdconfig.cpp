@@ -2,7 +2,7 @@
 //
 // A container class for a Rivendell Base Configuration
 //
-//   (C) Copyright 2002-2019 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2019,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -29,6 +29,7 @@
 #include <sys/types.h>
 
 #include <qdatetime.h>
+#include <qdir.h>
 #include <qmessagebox.h>
 #include <qobject.h>
 #include <qregexp.h>
@@ -218,6 +219,18 @@ QString RDConfig::mysqlEngine() const
 }
 
 
+QString RDConfig::mysqlQueryProfileDirectory() const
+{
+  return conf_mysql_query_profile_directory;
+}
+
+
+QString RDConfig::elrSpoolDirectory() const
+{
+  return conf_elr_spool_directory;
+}
+
+
 QString RDConfig::createTablePostfix() const
 {
   return conf_create_table_postfix;
@@ -478,6 +491,37 @@ QString RDConfig::tempDirectory()
   return conf_temp_directory;
 }
 
+
+QString RDConfig::exportCacheDirectory() const
+{
+  return conf_export_cache_directory;
+}
+
+
+qint64 RDConfig::exportCacheSize() const
+{
+  return conf_export_cache_size;
+}
+
+
+int RDConfig::notificationWindow() const
+{
+  return conf_notification_window;
+}
+
+
+bool RDConfig::binaryNotifications() const
+{
+  return conf_binary_notifications;
+}
+
+
+int RDConfig::pypadHostInstances() const
+{
+  return conf_pypad_host_instances;
+}
+
+
 QString RDConfig::sasStation() const
 {
   return conf_sas_station;
@@ -605,6 +649,11 @@ bool RDConfig::load()
 		      DEFAULT_MYSQL_HEARTBEAT_INTERVAL);
   conf_mysql_engine=
     profile->stringValue("mySQL","Engine",DEFAULT_MYSQL_ENGINE);
+  conf_mysql_query_profile_directory=
+    profile->stringValue("mySQL","QueryProfileDirectory");
+  conf_elr_spool_directory=
+    profile->stringValue("mySQL","ElrSpoolDirectory",
+			 QDir::homePath()+"/"+RD_ELR_SPOOL_DIR);
   conf_create_table_postfix=
     RDConfig::createTablePostfix(conf_mysql_engine);
 
@@ -668,6 +717,16 @@ bool RDConfig::load()
   conf_service_timeout=
     profile->intValue("Tuning","ServiceTimeout",RD_DEFAULT_SERVICE_TIMEOUT);
   conf_temp_directory=profile->stringValue("Tuning","TempDirectory","");
+  conf_export_cache_directory=
+    profile->stringValue("Tuning","ExportCacheDirectory","");
+  conf_export_cache_size=1048576LL*
+    profile->intValue("Tuning","ExportCacheSize",RD_DEFAULT_EXPORT_CACHE_SIZE);
+  conf_notification_window=profile->
+    intValue("Tuning","NotificationWindow",RD_DEFAULT_NOTIFICATION_WINDOW);
+  conf_binary_notifications=
+    profile->boolValue("Tuning","BinaryNotifications",false);
+  conf_pypad_host_instances=
+    profile->intValue("Tuning","PypadHostInstances",0);
   conf_sas_station=profile->stringValue("SASFilter","Station","");
   conf_sas_matrix=profile->intValue("SASFilter","Matrix",0);
   conf_sas_base_cart=profile->intValue("SASFilter","BaseCart",0);
@@ -721,6 +780,8 @@ void RDConfig::clear()
   conf_mysql_driver="";
   conf_mysql_heartbeat_interval=DEFAULT_MYSQL_HEARTBEAT_INTERVAL;
   conf_mysql_engine=DEFAULT_MYSQL_ENGINE;
+  conf_mysql_query_profile_directory="";
+  conf_elr_spool_directory="";
   conf_create_table_postfix="";
   conf_log_xload_debug_data=false;
   conf_provisioning_create_host=false;
@@ -775,6 +836,11 @@ void RDConfig::clear()
   conf_transcoding_delay=0;
   conf_service_timeout=RD_DEFAULT_SERVICE_TIMEOUT;
   conf_temp_directory="";
+  conf_export_cache_directory="";
+  conf_export_cache_size=1048576LL*RD_DEFAULT_EXPORT_CACHE_SIZE;
+  conf_notification_window=RD_DEFAULT_NOTIFICATION_WINDOW;
+  conf_binary_notifications=false;
+  conf_pypad_host_instances=0;
   conf_sas_station="";
   conf_sas_matrix=-1;
   conf_sas_base_cart=1;
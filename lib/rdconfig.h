@@ -2,7 +2,7 @@
 //
 // A container class for a Rivendell Base Configuration
 //
-//   (C) Copyright 2002-2019 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2019,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -63,6 +63,8 @@ class RDConfig
   QString mysqlDriver() const;
   int mysqlHeartbeatInterval() const;
   QString mysqlEngine() const;
+  QString mysqlQueryProfileDirectory() const;
+  QString elrSpoolDirectory() const;
   QString createTablePostfix() const;
   bool logXloadDebugData() const;
   bool provisioningCreateHost() const;
@@ -117,6 +119,11 @@ class RDConfig
   int transcodingDelay() const;
   int serviceTimeout() const;
   QString tempDirectory();
+  QString exportCacheDirectory() const;
+  qint64 exportCacheSize() const;
+  int notificationWindow() const;
+  bool binaryNotifications() const;
+  int pypadHostInstances() const;
   QString sasStation() const;
   int sasMatrix() const;
   unsigned sasBaseCart() const;
@@ -139,6 +146,8 @@ class RDConfig
   QString conf_mysql_engine;
   QString conf_create_table_postfix;
   int conf_mysql_heartbeat_interval;
+  QString conf_mysql_query_profile_directory;
+  QString conf_elr_spool_directory;
   bool conf_provisioning_create_host;
   QString conf_provisioning_host_template;
   QHostAddress conf_provisioning_host_ip_address;
@@ -193,6 +202,11 @@ class RDConfig
   int conf_realtime_priority;
   int conf_service_timeout;
   QString conf_temp_directory;
+  QString conf_export_cache_directory;
+  qint64 conf_export_cache_size;
+  int conf_notification_window;
+  bool conf_binary_notifications;
+  int conf_pypad_host_instances;
   QString conf_sas_station;
   int conf_sas_matrix;
   unsigned conf_sas_base_cart;
@@ -30,6 +30,7 @@
 #include "rdconfig.h"
 #include "rdcopyaudio.h"
 #include "rdcut.h"
+#include "rdcutrotation.h"
 #include "rddb.h"
 #include "rddisclookup.h"
 #include "rdescape_string.h"
@@ -864,6 +865,10 @@ int RDCut::effectiveEnd() const
 
 void RDCut::logPlayout() const
 {
+  if(RDCutRotation::engine()!=NULL) {
+    RDCutRotation::engine()->logPlayout(cut_name);
+    return;
+  }
   QString sql=
     QString("update CUTS set ")+
     "LAST_PLAY_DATETIME=now(),"+
@@ -1799,9 +1804,8 @@ void RDCut::SetRow(const QString &param,const QString &value) const
   QString sql;
 
   sql=QString("update CUTS set ")+
-    param+"=\""+RDEscapeString(value)+"\" where "+
-    "CUT_NAME=\""+RDEscapeString(cut_name)+"\"";
-  q=new RDSqlQuery(sql);
+    param+"=? where CUT_NAME=?";
+  q=new RDSqlQuery(sql,QList<QVariant>()<<value<<cut_name);
   delete q;
 }
 
@@ -1812,9 +1816,8 @@ void RDCut::SetRow(const QString &param,unsigned value) const
   QString sql;
 
   sql=QString("update CUTS set ")+
-    param+QString().sprintf("=%u where ",value)+
-    "CUT_NAME=\""+RDEscapeString(cut_name)+"\"";
-  q=new RDSqlQuery(sql);
+    param+"=? where CUT_NAME=?";
+  q=new RDSqlQuery(sql,QList<QVariant>()<<value<<cut_name);
   delete q;
 }
 
@@ -1825,9 +1828,8 @@ void RDCut::SetRow(const QString &param,int value) const
   QString sql;
 
   sql=QString("update CUTS set ")+
-    param+QString().sprintf("=%d where ",value)+
-    "CUT_NAME=\""+RDEscapeString(cut_name)+"\"";
-  q=new RDSqlQuery(sql);
+    param+"=? where CUT_NAME=?";
+  q=new RDSqlQuery(sql,QList<QVariant>()<<value<<cut_name);
   delete q;
 }
 
@@ -0,0 +1,505 @@
+// rdcutrotation.cpp
+//
+// In-memory cut rotation engine
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <algorithm>
+
+#include "rd.h"
+#include "rdapplication.h"
+#include "rdcart.h"
+#include "rdcut.h"
+#include "rdcutrotation.h"
+#include "rddb.h"
+
+//
+// Comparators reproducing the 'order by' clauses of the SQL
+// implementation in RDCart::selectCutFromDatabase(). MySQL sorts NULLs
+// first in ascending order and last in descending order.
+//
+static int CompareNullable(const QDateTime &a,const QDateTime &b)
+{
+  if(a.isNull()) {
+    return b.isNull()?0:-1;
+  }
+  if(b.isNull()) {
+    return 1;
+  }
+  if(a<b) {
+    return -1;
+  }
+  return (a==b)?0:1;
+}
+
+
+static bool WeightedOrder(const RDCutRotationCut *a,const RDCutRotationCut *b)
+{
+  int n;
+
+  if(a->local_counter!=b->local_counter) {
+    return a->local_counter<b->local_counter;
+  }
+  if(a->end_datetime.isNull()!=b->end_datetime.isNull()) {
+    return b->end_datetime.isNull();
+  }
+  if((n=CompareNullable(a->end_datetime,b->end_datetime))!=0) {
+    return n<0;
+  }
+  return CompareNullable(a->last_play_datetime,b->last_play_datetime)<0;
+}
+
+
+static bool SequentialOrder(const RDCutRotationCut *a,
+			    const RDCutRotationCut *b)
+{
+  int n;
+
+  if((n=CompareNullable(a->last_play_datetime,b->last_play_datetime))!=0) {
+    return n>0;
+  }
+  return a->play_order>b->play_order;
+}
+
+
+static bool EvergreenWeightedOrder(const RDCutRotationCut *a,
+				   const RDCutRotationCut *b)
+{
+  return a->local_counter<b->local_counter;
+}
+
+
+static bool EvergreenSequentialOrder(const RDCutRotationCut *a,
+				     const RDCutRotationCut *b)
+{
+  return CompareNullable(a->last_play_datetime,b->last_play_datetime)>0;
+}
+
+
+static QDateTime ReadDateTime(RDSqlQuery *q,int col)
+{
+  if(q->isNull(col)) {
+    return QDateTime();
+  }
+  QDateTime ret=q->value(col).toDateTime();
+  if(!ret.isValid()) {
+    // A zero date, which MySQL sorts and compares as the earliest of all
+    ret=QDateTime(QDate(1,1,1),QTime(0,0,0));
+  }
+  return ret;
+}
+
+
+
+
+RDCutRotationCut::RDCutRotationCut()
+{
+  play_order=0;
+  weight=0;
+  local_counter=0;
+  start_daypart_null=true;
+  end_daypart_null=true;
+  for(int i=0;i<7;i++) {
+    weekdays[i]=false;
+  }
+  evergreen=false;
+  length=0;
+}
+
+
+bool RDCutRotationCut::isEligible(const QDateTime &dt) const
+{
+  //
+  // Mirrors the 'where' clause of the SQL implementation, including its
+  // treatment of a NULL end value as a failed comparison.
+  //
+  if(evergreen||(length==0)) {
+    return false;
+  }
+  if(!weekdays[dt.date().dayOfWeek()-1]) {
+    return false;
+  }
+  if(!start_datetime.isNull()) {
+    if(end_datetime.isNull()||(start_datetime>dt)||(end_datetime<dt)) {
+      return false;
+    }
+  }
+  if(!start_daypart_null) {
+    if(end_daypart_null||(start_daypart>dt.time())||
+       (end_daypart<dt.time())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+
+
+RDCutRotationCart::RDCutRotationCart()
+{
+  audio=false;
+  use_weighting=true;
+}
+
+
+QString RDCutRotationCart::nextCut(const QDateTime &dt) const
+{
+  std::vector<const RDCutRotationCut *> eligible;
+  QString cutname;
+
+  //
+  // Compare at the one second resolution used by the SQL implementation
+  //
+  QDateTime now(dt.date(),QTime(dt.time().hour(),dt.time().minute(),
+				dt.time().second()));
+
+  if(audio) {
+    for(unsigned i=0;i<cuts.size();i++) {
+      if(cuts.at(i).isEligible(now)) {
+	eligible.push_back(&cuts.at(i));
+      }
+    }
+    if(use_weighting) {
+      std::stable_sort(eligible.begin(),eligible.end(),WeightedOrder);
+    }
+    else {
+      std::stable_sort(eligible.begin(),eligible.end(),SequentialOrder);
+    }
+    cutname=NextCut(&eligible);
+  }
+  if(cutname.isEmpty()) {   // No valid cuts, try the evergreen
+    eligible.clear();
+    for(unsigned i=0;i<cuts.size();i++) {
+      if(cuts.at(i).evergreen&&(cuts.at(i).length>0)) {
+	eligible.push_back(&cuts.at(i));
+      }
+    }
+    if(use_weighting) {
+      std::stable_sort(eligible.begin(),eligible.end(),
+		       EvergreenWeightedOrder);
+    }
+    else {
+      std::stable_sort(eligible.begin(),eligible.end(),
+		       EvergreenSequentialOrder);
+    }
+    cutname=NextCut(&eligible);
+  }
+
+  return cutname;
+}
+
+
+QString RDCutRotationCart::NextCut(
+  std::vector<const RDCutRotationCut *> *cuts) const
+{
+  //
+  // Same algorithm as RDCart::GetNextCut()
+  //
+  QString cutname;
+  double ratio;
+  double play_ratio=100000000.0;
+  int play=RD_MAX_CUT_NUMBER+1;
+  int last_play;
+
+  if(use_weighting) {
+    for(unsigned i=0;i<cuts->size();i++) {
+      if((ratio=(double)cuts->at(i)->local_counter/
+	  (double)cuts->at(i)->weight)<play_ratio) {
+	play_ratio=ratio;
+	cutname=cuts->at(i)->cut_name;
+      }
+    }
+  }
+  else {
+    if(cuts->size()>0) {
+      last_play=cuts->at(0)->play_order;
+      for(unsigned i=1;i<cuts->size();i++) {
+	if((cuts->at(i)->play_order>last_play)&&
+	   (cuts->at(i)->play_order<play)) {
+	  play=cuts->at(i)->play_order;
+	  cutname=cuts->at(i)->cut_name;
+	}
+      }
+      if(!cutname.isEmpty()) {
+	return cutname;
+      }
+    }
+    for(unsigned i=0;i<cuts->size();i++) {
+      if(cuts->at(i)->play_order<play) {
+	play=cuts->at(i)->play_order;
+	cutname=cuts->at(i)->cut_name;
+      }
+    }
+  }
+  return cutname;
+}
+
+
+
+
+RDCutRotation *RDCutRotation::rot_engine=NULL;
+
+RDCutRotation::RDCutRotation(RDRipc *ripc,QObject *parent)
+  : QObject(parent)
+{
+  rot_ripc=ripc;
+  rot_flush_timer=new QTimer(this);
+  rot_flush_timer->setSingleShot(true);
+  connect(rot_flush_timer,SIGNAL(timeout()),this,SLOT(flushData()));
+
+  if(ripc!=NULL) {
+    connect(ripc,SIGNAL(notificationReceived(RDNotification *)),
+	    this,SLOT(notificationReceivedData(RDNotification *)));
+  }
+
+  rot_engine=this;
+}
+
+
+RDCutRotation::~RDCutRotation()
+{
+  flush();
+  clear();
+  if(rot_engine==this) {
+    rot_engine=NULL;
+  }
+}
+
+
+bool RDCutRotation::selectCut(unsigned cartnum,const QDateTime &dt,
+			      QString *cutname)
+{
+  RDCutRotationCart *cart=NULL;
+  bool ret;
+
+  if((cart=GetCart(cartnum))==NULL) {
+    ret=(*cutname=="");
+    *cutname="";
+    rda->syslog(LOG_DEBUG,
+		"RDCutRotation::selectCut(): cart doesn't exist, CART=%06u",
+		cartnum);
+    return ret;
+  }
+  *cutname=cart->nextCut(dt);
+
+  return true;
+}
+
+
+void RDCutRotation::logPlayout(const QString &cutname,const QDateTime &dt)
+{
+  RDCutRotationCart *cart=NULL;
+
+  //
+  // Update our copy now, so that the next selection sees this play...
+  //
+  if((cart=rot_carts.value(RDCut::cartNumber(cutname),NULL))!=NULL) {
+    for(unsigned i=0;i<cart->cuts.size();i++) {
+      if(cart->cuts.at(i).cut_name==cutname) {
+	cart->cuts.at(i).local_counter++;
+	cart->cuts.at(i).last_play_datetime=
+	  QDateTime(dt.date(),QTime(dt.time().hour(),dt.time().minute(),
+				    dt.time().second()));
+      }
+    }
+  }
+
+  //
+  // ...and the database later, off of the playout path
+  //
+  rot_pending_plays[cutname]++;
+  if(!rot_flush_timer->isActive()) {
+    rot_flush_timer->start(RD_CUT_ROTATION_FLUSH_INTERVAL);
+  }
+}
+
+
+void RDCutRotation::invalidate(unsigned cartnum)
+{
+  QMap<unsigned,RDCutRotationCart *>::iterator it=rot_carts.find(cartnum);
+  if(it!=rot_carts.end()) {
+    delete it.value();
+    rot_carts.erase(it);
+  }
+}
+
+
+void RDCutRotation::clear()
+{
+  for(QMap<unsigned,RDCutRotationCart *>::const_iterator it=
+	rot_carts.begin();it!=rot_carts.end();it++) {
+    delete it.value();
+  }
+  rot_carts.clear();
+}
+
+
+void RDCutRotation::flush()
+{
+  QString sql;
+  RDNotification *notify=NULL;
+  QList<unsigned> cartnums;
+
+  rot_flush_timer->stop();
+  QMap<QString,int>::iterator it=rot_pending_plays.begin();
+  while(it!=rot_pending_plays.end()) {
+    sql=QString("update CUTS set ")+
+      "LAST_PLAY_DATETIME=now(),"+
+      "PLAY_COUNTER=PLAY_COUNTER+?,"+
+      "LOCAL_COUNTER=LOCAL_COUNTER+? "+
+      "where CUT_NAME=?";
+    if(!RDSqlQuery::apply(sql,QList<QVariant>()<<
+			  it.value()<<
+			  it.value()<<
+			  it.key())) {
+      it++;  // Keep it for the next try
+      continue;
+    }
+    if(!cartnums.contains(RDCut::cartNumber(it.key()))) {
+      cartnums.push_back(RDCut::cartNumber(it.key()));
+    }
+    it=rot_pending_plays.erase(it);
+  }
+  if(rot_pending_plays.size()>0) {
+    rot_flush_timer->start(RD_CUT_ROTATION_FLUSH_INTERVAL);
+  }
+
+  //
+  // Reload the carts written from the database, which has the server's
+  // play time, and have every other process (and host) do the same
+  //
+  for(int i=0;i<cartnums.size();i++) {
+    invalidate(cartnums.at(i));
+    if(rot_ripc!=NULL) {
+      if(notify==NULL) {
+	notify=new RDNotification(RDNotification::CartType,
+				  RDNotification::ModifyAction,
+				  cartnums.at(i));
+      }
+      else {
+	notify->addId(cartnums.at(i));
+      }
+    }
+  }
+  if(notify!=NULL) {
+    rot_ripc->sendNotification(*notify);
+    delete notify;
+  }
+}
+
+
+RDCutRotation *RDCutRotation::engine()
+{
+  return rot_engine;
+}
+
+
+void RDCutRotation::notificationReceivedData(RDNotification *notify)
+{
+  if(notify->type()==RDNotification::CartType) {
+    invalidate(notify->id().toUInt());
+  }
+}
+
+
+void RDCutRotation::flushData()
+{
+  flush();
+}
+
+
+RDCutRotationCart *RDCutRotation::GetCart(unsigned cartnum)
+{
+  QString sql;
+  RDSqlQuery *q=NULL;
+  RDCutRotationCart *cart=NULL;
+
+  if((cart=rot_carts.value(cartnum,NULL))!=NULL) {
+    if(cart->load_datetime.secsTo(QDateTime::currentDateTime())<
+       RD_CUT_ROTATION_MAX_AGE) {
+      return cart;
+    }
+    invalidate(cartnum);
+  }
+
+  //
+  // Make sure that our counters are current before (re)loading
+  //
+  flush();
+
+  sql=QString("select ")+
+    "CART.TYPE,"+                 // 00
+    "CART.USE_WEIGHTING,"+        // 01
+    "CUTS.CUT_NAME,"+             // 02
+    "CUTS.PLAY_ORDER,"+           // 03
+    "CUTS.WEIGHT,"+               // 04
+    "CUTS.LOCAL_COUNTER,"+        // 05
+    "CUTS.LAST_PLAY_DATETIME,"+   // 06
+    "CUTS.START_DATETIME,"+       // 07
+    "CUTS.END_DATETIME,"+         // 08
+    "CUTS.START_DAYPART,"+        // 09
+    "CUTS.END_DAYPART,"+          // 10
+    "CUTS.MON,"+                  // 11
+    "CUTS.TUE,"+                  // 12
+    "CUTS.WED,"+                  // 13
+    "CUTS.THU,"+                  // 14
+    "CUTS.FRI,"+                  // 15
+    "CUTS.SAT,"+                  // 16
+    "CUTS.SUN,"+                  // 17
+    "CUTS.EVERGREEN,"+            // 18
+    "CUTS.LENGTH "+               // 19
+    "from CART left join CUTS "+
+    "on CART.NUMBER=CUTS.CART_NUMBER "+
+    "where CART.NUMBER=? "+
+    "order by CUTS.CUT_NAME";
+  q=new RDSqlQuery(sql,QList<QVariant>()<<cartnum);
+  while(q->next()) {
+    if(cart==NULL) {
+      cart=new RDCutRotationCart();
+      cart->audio=(RDCart::Type)q->value(0).toUInt()==RDCart::Audio;
+      cart->use_weighting=q->value(1).toString()=="Y";
+      cart->load_datetime=QDateTime::currentDateTime();
+    }
+    if(!q->isNull(2)) {
+      RDCutRotationCut cut;
+      cut.cut_name=q->value(2).toString();
+      cut.play_order=q->value(3).toInt();
+      cut.weight=q->value(4).toInt();
+      cut.local_counter=q->value(5).toInt();
+      cut.last_play_datetime=ReadDateTime(q,6);
+      cut.start_datetime=ReadDateTime(q,7);
+      cut.end_datetime=ReadDateTime(q,8);
+      cut.start_daypart_null=q->isNull(9);
+      cut.start_daypart=q->value(9).toTime();
+      cut.end_daypart_null=q->isNull(10);
+      cut.end_daypart=q->value(10).toTime();
+      for(int i=0;i<7;i++) {
+	cut.weekdays[i]=q->value(11+i).toString()=="Y";
+      }
+      cut.evergreen=q->value(18).toString()=="Y";
+      cut.length=q->value(19).toUInt();
+      cart->cuts.push_back(cut);
+    }
+  }
+  delete q;
+  if(cart!=NULL) {
+    rot_carts[cartnum]=cart;
+  }
+
+  return cart;
+}
@@ -0,0 +1,109 @@
+// rdcutrotation.h
+//
+// In-memory cut rotation engine
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDCUTROTATION_H
+#define RDCUTROTATION_H
+
+#include <vector>
+
+#include <qdatetime.h>
+#include <qmap.h>
+#include <qobject.h>
+#include <qtimer.h>
+
+#include <rdnotification.h>
+#include <rdripc.h>
+
+//
+// Maximum age of a cached cart before it is reloaded (seconds)
+//
+#define RD_CUT_ROTATION_MAX_AGE 300
+
+//
+// Delay before queued play counter updates are written back (mS)
+//
+#define RD_CUT_ROTATION_FLUSH_INTERVAL 1000
+
+class RDCutRotationCut
+{
+ public:
+  RDCutRotationCut();
+  bool isEligible(const QDateTime &dt) const;
+  QString cut_name;
+  int play_order;
+  int weight;
+  int local_counter;
+  QDateTime last_play_datetime;
+  QDateTime start_datetime;
+  QDateTime end_datetime;
+  QTime start_daypart;
+  QTime end_daypart;
+  bool start_daypart_null;
+  bool end_daypart_null;
+  bool weekdays[7];
+  bool evergreen;
+  unsigned length;
+};
+
+
+class RDCutRotationCart
+{
+ public:
+  RDCutRotationCart();
+  QString nextCut(const QDateTime &dt) const;
+  bool audio;
+  bool use_weighting;
+  QDateTime load_datetime;
+  std::vector<RDCutRotationCut> cuts;
+
+ private:
+  QString NextCut(std::vector<const RDCutRotationCut *> *cuts) const;
+};
+
+
+class RDCutRotation : public QObject
+{
+  Q_OBJECT;
+ public:
+  RDCutRotation(RDRipc *ripc,QObject *parent=0);
+  ~RDCutRotation();
+  bool selectCut(unsigned cartnum,const QDateTime &dt,QString *cutname);
+  void logPlayout(const QString &cutname,
+		  const QDateTime &dt=QDateTime::currentDateTime());
+  void invalidate(unsigned cartnum);
+  void clear();
+  void flush();
+  static RDCutRotation *engine();
+
+ private slots:
+  void notificationReceivedData(RDNotification *notify);
+  void flushData();
+
+ private:
+  RDCutRotationCart *GetCart(unsigned cartnum);
+  QMap<unsigned,RDCutRotationCart *> rot_carts;
+  QMap<QString,int> rot_pending_plays;
+  QTimer *rot_flush_timer;
+  RDRipc *rot_ripc;
+  static RDCutRotation *rot_engine;
+};
+
+
+#endif  // RDCUTROTATION_H
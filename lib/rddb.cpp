@@ -3,7 +3,7 @@
 //   Database driver with automatic reconnect
 //
 //   (C) Copyright 2007 Dan Mills <dmills@exponent.myzen.co.uk>
-//   (C) Copyright 2018-2019 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2018-2019,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -34,21 +34,47 @@
 #include <QStringList>
 #include <QVariant>
 
+#include <QAtomicInt>
+#include <QHash>
+#include <QMutex>
+
 #include "rdapplication.h"
 #include "rddb.h"
 #include "rddbheartbeat.h"
+#include "rdsnapshot.h"
+#include "rdsqlprofiler.h"
+
+//
+// Prepared statement cache for the default connection, shared by the
+// whole process and keyed by SQL text
+//
+struct RDSqlStatement {
+  QSqlQuery *query;
+  bool busy;
+  quint64 serial;
+};
+static QMutex rddb_statement_mutex;
+static QHash<QString,RDSqlStatement> rddb_statements;
+static quint64 rddb_statement_serial=0;
+static QAtomicInt rddb_executed;
 
 RDSqlQuery::RDSqlQuery (const QString &query,bool reconnect):
-  QSqlQuery(query)
+  QSqlQuery(QString())
 {
   QSqlDatabase db;
   QString err;
   sql_columns=0;
+  sql_cache_serial=0;
+  uint64_t start=RDSqlProfiler::timestamp();
 
+  if(!query.isEmpty()) {
+    exec(query);
+  }
   if (!isActive() && reconnect) {
     db = QSqlDatabase::database();
 
     if (db.open()) {
+      RDSqlQuery::clearStatementCache();
       clear();
       exec(query);
       err=QObject::tr("DB connection re-established");
@@ -66,30 +92,85 @@ RDSqlQuery::RDSqlQuery (const QString &query,bool reconnect):
 
   if(isActive()) {
     //printf("QUERY: %s\n",(const char *)query.toUtf8());
-    QStringList f0=query.split(" ");
-    if(f0[0].toLower()=="select") {
-      for(int i=1;i<f0.size();i++) {
-	if(f0[i].toLower()=="from") {
-	  QString fields;
-	  for(int j=1;j<i;j++) {
-	    fields+=f0[j];
-	  }
-	  QStringList f1=fields.split(",");
-	  sql_columns=f1.size();
-	  continue;
-	}
-      }
+    SetColumns(query);
+    if(RDSqlProfiler::isActive()) {
+      RDSqlProfiler::addSample(query,false,start,
+			       isSelect()?size():numRowsAffected());
     }
   }
   else {
-    err=QObject::tr("invalid SQL or failed DB connection")+
-      +"["+lastError().text()+"]: "+query;
+    ReportError(query);
+  }
+  if((!query.isEmpty())&&(!isSelect())) {
+    RDSnapshot::invalidate(query);
+  }
+  rddb_executed.fetchAndAddRelaxed(1);
+}
+
+
+RDSqlQuery::RDSqlQuery(const QString &query,const QList<QVariant> &args,
+		       bool reconnect)
+  : QSqlQuery(QString())
+{
+  QSqlDatabase db;
+  QString err;
+  sql_columns=0;
+  sql_cache_serial=0;
+  uint64_t start=RDSqlProfiler::timestamp();
+
+  sql_cache_key=query;
+  ExecPrepared(args);
+  if (!isActive() && reconnect) {
+    db = QSqlDatabase::database();
+
+    if (db.open()) {
+      RDSqlQuery::clearStatementCache();
+      ExecPrepared(args);
+      err=QObject::tr("DB connection re-established");
+    }
+    else {
+      err=QObject::tr("Could not re-establish DB connection")+
+      +"["+db.lastError().text()+"]";
+    }
 
     fprintf(stderr,"%s\n",(const char *)err);
     if(rda!=NULL) {
       rda->syslog(LOG_ERR,(const char *)err);
     }
   }
+
+  if(isActive()) {
+    SetColumns(query);
+    if(RDSqlProfiler::isActive()) {
+      RDSqlProfiler::addSample(query,true,start,
+			       isSelect()?size():numRowsAffected());
+    }
+  }
+  else {
+    ReportError(query);
+  }
+  if((!query.isEmpty())&&(!isSelect())) {
+    RDSnapshot::invalidate(query);
+  }
+  rddb_executed.fetchAndAddRelaxed(1);
+}
+
+
+RDSqlQuery::~RDSqlQuery()
+{
+  //
+  // Hand the prepared statement back to the cache
+  //
+  if(sql_cache_serial!=0) {
+    finish();
+    rddb_statement_mutex.lock();
+    QHash<QString,RDSqlStatement>::iterator it=
+      rddb_statements.find(sql_cache_key);
+    if((it!=rddb_statements.end())&&(it.value().serial==sql_cache_serial)) {
+      it.value().busy=false;
+    }
+    rddb_statement_mutex.unlock();
+  }
 }
 
 
@@ -141,6 +222,38 @@ bool RDSqlQuery::apply(const QString &sql,QString *err_msg)
 }
 
 
+QVariant RDSqlQuery::run(const QString &sql,const QList<QVariant> &args,
+			 bool *ok)
+{
+  QVariant ret;
+
+  RDSqlQuery *q=new RDSqlQuery(sql,args);
+  if(ok!=NULL) {
+    *ok=q->isActive();
+  }
+  ret=q->lastInsertId();
+  delete q;
+
+  return ret;
+}
+
+
+bool RDSqlQuery::apply(const QString &sql,const QList<QVariant> &args,
+		       QString *err_msg)
+{
+  bool ret=false;
+
+  RDSqlQuery *q=new RDSqlQuery(sql,args);
+  ret=q->isActive();
+  if((err_msg!=NULL)&&(!ret)) {
+    *err_msg="sql error: "+q->lastError().text()+" query: "+sql;
+  }
+  delete q;
+
+  return ret;
+}
+
+
 int RDSqlQuery::rows(const QString &sql)
 {
   int ret=0;
@@ -153,6 +266,133 @@ int RDSqlQuery::rows(const QString &sql)
 }
 
 
+unsigned RDSqlQuery::executed()
+{
+  return (int)rddb_executed;
+}
+
+
+void RDSqlQuery::clearStatementCache()
+{
+  rddb_statement_mutex.lock();
+  for(QHash<QString,RDSqlStatement>::iterator it=rddb_statements.begin();
+      it!=rddb_statements.end();it++) {
+    delete it.value().query;
+  }
+  rddb_statements.clear();
+  rddb_statement_mutex.unlock();
+}
+
+
+void RDSqlQuery::ExecPrepared(const QList<QVariant> &args)
+{
+  QSqlQuery stmt;
+  bool cached=false;
+
+  //
+  // Find (or create) a server-side prepared statement for this query shape.
+  // If the cached copy is already in use further up the stack (e.g. an
+  // outer loop iterating the same shape) fall back to a private one.
+  //
+  sql_cache_serial=0;
+  rddb_statement_mutex.lock();
+  QHash<QString,RDSqlStatement>::iterator it=
+    rddb_statements.find(sql_cache_key);
+  if(it!=rddb_statements.end()) {
+    if(!it.value().busy) {
+      it.value().busy=true;
+      it.value().serial=++rddb_statement_serial;
+      sql_cache_serial=it.value().serial;
+      stmt=*(it.value().query);
+      cached=true;
+    }
+  }
+  else {
+    QSqlQuery *q=new QSqlQuery(QString());
+    if(q->prepare(sql_cache_key)) {
+      if(rddb_statements.size()>=RD_SQL_STATEMENT_CACHE_SIZE) {
+	QHash<QString,RDSqlStatement>::iterator oldest=rddb_statements.end();
+	for(QHash<QString,RDSqlStatement>::iterator it1=
+	      rddb_statements.begin();it1!=rddb_statements.end();it1++) {
+	  if((!it1.value().busy)&&((oldest==rddb_statements.end())||
+				   (it1.value().serial<oldest.value().serial))) {
+	    oldest=it1;
+	  }
+	}
+	if(oldest!=rddb_statements.end()) {
+	  delete oldest.value().query;
+	  rddb_statements.erase(oldest);
+	}
+      }
+      RDSqlStatement s;
+      s.query=q;
+      s.busy=true;
+      s.serial=++rddb_statement_serial;
+      sql_cache_serial=s.serial;
+      rddb_statements[sql_cache_key]=s;
+      stmt=*q;
+      cached=true;
+    }
+    else {
+      delete q;
+    }
+  }
+  rddb_statement_mutex.unlock();
+
+  if(cached) {
+    QSqlQuery::operator=(stmt);
+  }
+  else {
+    clear();
+    prepare(sql_cache_key);
+  }
+  for(int i=0;i<args.size();i++) {
+    //
+    // A null QString would bind as SQL NULL, whereas the quoted strings
+    // this replaces gave "", so bind those as empty strings
+    //
+    if((args.at(i).type()==QVariant::String)&&args.at(i).isNull()) {
+      bindValue(i,QString(""));
+    }
+    else {
+      bindValue(i,args.at(i));
+    }
+  }
+  exec();
+}
+
+
+void RDSqlQuery::SetColumns(const QString &query)
+{
+  QStringList f0=query.split(" ");
+  if(f0[0].toLower()=="select") {
+    for(int i=1;i<f0.size();i++) {
+      if(f0[i].toLower()=="from") {
+	QString fields;
+	for(int j=1;j<i;j++) {
+	  fields+=f0[j];
+	}
+	QStringList f1=fields.split(",");
+	sql_columns=f1.size();
+	continue;
+      }
+    }
+  }
+}
+
+
+void RDSqlQuery::ReportError(const QString &query)
+{
+  QString err=QObject::tr("invalid SQL or failed DB connection")+
+    +"["+lastError().text()+"]: "+query;
+
+  fprintf(stderr,"%s\n",(const char *)err);
+  if(rda!=NULL) {
+    rda->syslog(LOG_ERR,(const char *)err);
+  }
+}
+
+
 bool RDOpenDb (int *schema,QString *err_str,RDConfig *config)
 {
   QSqlDatabase db;
@@ -178,6 +418,8 @@ bool RDOpenDb (int *schema,QString *err_str,RDConfig *config)
     }
   }
   new RDDbHeartbeat(config->mysqlHeartbeatInterval());
+  RDSqlProfiler::start(config->mysqlQueryProfileDirectory(),
+		       config->moduleName());
   sql=QString("set NAMES utf8mb4 collate utf8mb4_general_ci");
   q=new QSqlQuery(sql);
   delete q;
@@ -3,7 +3,7 @@
 // Database driver with automatic error reporting and recovery
 //
 //   (C) Copyright 2007 Dan Mills <dmills@exponent.myzen.co.uk>
-//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2018,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -22,24 +22,44 @@
 #ifndef RDDB_H
 #define RDDB_H
 
+#include <QList>
 #include <QString>
 #include <QSqlQuery>
 #include <QVariant>
 
 #include <rdconfig.h>
 
+//
+// Maximum number of prepared statements kept in the process-wide cache
+//
+#define RD_SQL_STATEMENT_CACHE_SIZE 256
+
 class RDSqlQuery : public QSqlQuery
 {
  public:
   RDSqlQuery(const QString &query = QString::null,bool reconnect=true);
+  RDSqlQuery(const QString &query,const QList<QVariant> &args,
+	     bool reconnect=true);
+  ~RDSqlQuery();
   int columns() const;
   QVariant value(int index) const;
   static QVariant run(const QString &sql,bool *ok=NULL);
+  static QVariant run(const QString &sql,const QList<QVariant> &args,
+		      bool *ok=NULL);
   static bool apply(const QString &sql,QString *err_msg=NULL);
+  static bool apply(const QString &sql,const QList<QVariant> &args,
+		    QString *err_msg=NULL);
   static int rows(const QString &sql);
+  static unsigned executed();
+  static void clearStatementCache();
 
  private:
+  void ExecPrepared(const QList<QVariant> &args);
+  void SetColumns(const QString &query);
+  void ReportError(const QString &query);
   int sql_columns;
+  QString sql_cache_key;
+  quint64 sql_cache_serial;
 };
 
 bool RDOpenDb(int *schema,QString *err_str,RDConfig *config);
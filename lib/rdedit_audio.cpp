@@ -593,7 +593,7 @@ RDEditAudio::RDEditAudio(RDCart *cart,QString cut_name,int card,
   // Cut Gain Control
   //
   edit_gain_control=new Q3RangeControl();
-  edit_gain_control->setRange(-1000,1000);
+  edit_gain_control->setRange(RD_MIN_PLAY_GAIN,RD_MAX_PLAY_GAIN);
   edit_gain_control->setSteps(10,10);
   edit_gain_edit=new RDMarkerEdit(this);
   edit_gain_edit->setGeometry(398,529,70,21);
@@ -0,0 +1,898 @@
+// rdelrjournal.cpp
+//
+// Spooled, asynchronous writer for as-played (ELR) records
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <syslog.h>
+#include <unistd.h>
+
+#include <QDir>
+#include <QMap>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QVariant>
+
+#include "rdapplication.h"
+#include "rdelrjournal.h"
+#include "rdescape_string.h"
+
+RDElrRecord::RDElrRecord()
+{
+  rec_lookup=RDElrRecord::LookupNone;
+}
+
+
+void RDElrRecord::setValue(const QString &col,const QString &str)
+{
+  setLiteral(col,"\""+RDEscapeString(str)+"\"");
+}
+
+
+void RDElrRecord::setValue(const QString &col,int value)
+{
+  setLiteral(col,QString().sprintf("%d",value));
+}
+
+
+void RDElrRecord::setValue(const QString &col,unsigned value)
+{
+  setLiteral(col,QString().sprintf("%u",value));
+}
+
+
+void RDElrRecord::setLiteral(const QString &col,const QString &sql)
+{
+  int index=rec_columns.indexOf(col);
+
+  if(index<0) {
+    rec_columns.push_back(col);
+    rec_literals.push_back(sql);
+  }
+  else {
+    rec_literals[index]=sql;
+  }
+}
+
+
+RDElrRecord::Lookup RDElrRecord::lookup() const
+{
+  return rec_lookup;
+}
+
+
+QString RDElrRecord::lookupKey() const
+{
+  return rec_lookup_key;
+}
+
+
+void RDElrRecord::setLookup(Lookup type,const QString &key)
+{
+  //
+  // Metadata for the record is read from the CART/CUTS tables by the
+  // journal, rather than by the caller, so that the playout thread need
+  // not wait on the database. The record is discarded if the lookup
+  // finds nothing.
+  //
+  rec_lookup=type;
+  rec_lookup_key=key;
+}
+
+
+QStringList RDElrRecord::columns() const
+{
+  return rec_columns;
+}
+
+
+QStringList RDElrRecord::literals() const
+{
+  return rec_literals;
+}
+
+
+QString RDElrRecord::toString() const
+{
+  QStringList fields;
+
+  switch(rec_lookup) {
+  case RDElrRecord::LookupCut:
+    fields.push_back("@CUT="+Encode(rec_lookup_key));
+    break;
+
+  case RDElrRecord::LookupMacroCart:
+    fields.push_back("@MACRO="+Encode(rec_lookup_key));
+    break;
+
+  case RDElrRecord::LookupNone:
+    break;
+  }
+  for(int i=0;i<rec_columns.size();i++) {
+    fields.push_back(rec_columns.at(i)+"="+Encode(rec_literals.at(i)));
+  }
+
+  return fields.join("\t");
+}
+
+
+bool RDElrRecord::fromString(const QString &str)
+{
+  QStringList fields=str.split("\t",QString::SkipEmptyParts);
+  int offset;
+
+  rec_columns.clear();
+  rec_literals.clear();
+  rec_lookup=RDElrRecord::LookupNone;
+  rec_lookup_key="";
+  for(int i=0;i<fields.size();i++) {
+    if((offset=fields.at(i).indexOf("="))<1) {
+      return false;
+    }
+    QString name=fields.at(i).left(offset);
+    QString value=Decode(fields.at(i).mid(offset+1));
+    if(name=="@CUT") {
+      setLookup(RDElrRecord::LookupCut,value);
+    }
+    else {
+      if(name=="@MACRO") {
+	setLookup(RDElrRecord::LookupMacroCart,value);
+      }
+      else {
+	setLiteral(name,value);
+      }
+    }
+  }
+
+  return rec_columns.size()>0;
+}
+
+
+QString RDElrRecord::Encode(const QString &str)
+{
+  QString ret=str;
+
+  ret.replace("\\","\\\\");
+  ret.replace("\t","\\t");
+  ret.replace("\n","\\n");
+  ret.replace("\r","\\r");
+
+  return ret;
+}
+
+
+QString RDElrRecord::Decode(const QString &str)
+{
+  QString ret;
+
+  for(int i=0;i<str.length();i++) {
+    if((str.at(i)=='\\')&&(i<(str.length()-1))) {
+      i++;
+      switch(str.at(i).toAscii()) {
+      case 't':
+	ret+="\t";
+	break;
+
+      case 'n':
+	ret+="\n";
+	break;
+
+      case 'r':
+	ret+="\r";
+	break;
+
+      default:
+	ret+=str.at(i);
+	break;
+      }
+    }
+    else {
+      ret+=str.at(i);
+    }
+  }
+
+  return ret;
+}
+
+
+
+
+//
+// Records are appended to the spool file from the calling thread, one
+// line per record, and written to ELR_LINES by a background thread using
+// its own database connection. The offset of the first record not yet
+// written is kept in a companion '.pos' file, so that anything left in
+// the spool after a crash or a database outage is replayed by open().
+// A crash between the database commit and the update of the '.pos' file
+// can cause a batch to be written twice; records are never dropped.
+//
+RDElrJournal::RDElrJournal(RDConfig *config,const QString &spool_dir,
+			   const QString &name)
+{
+  jour_config=config;
+  jour_spool_dir=spool_dir;
+  jour_name=name;
+  jour_conn_name="rdelrjournal-"+name;
+  jour_fd=-1;
+  jour_committed=0;
+  jour_size=0;
+  jour_running=false;
+  jour_exiting=false;
+  jour_connected=false;
+  jour_outage=false;
+  jour_written=0;
+  pthread_mutex_init(&jour_mutex,NULL);
+  pthread_cond_init(&jour_cond,NULL);
+  pthread_cond_init(&jour_flushed_cond,NULL);
+}
+
+
+RDElrJournal::~RDElrJournal()
+{
+  close();
+  pthread_cond_destroy(&jour_flushed_cond);
+  pthread_cond_destroy(&jour_cond);
+  pthread_mutex_destroy(&jour_mutex);
+}
+
+
+QString RDElrJournal::spoolFile() const
+{
+  return jour_spool_dir+"/"+jour_name+".elr";
+}
+
+
+bool RDElrJournal::open(QString *err_msg)
+{
+  pthread_attr_t pthread_attr;
+
+  if(jour_running) {
+    return true;
+  }
+  if(!QDir().mkpath(jour_spool_dir)) {
+    *err_msg=QObject::tr("unable to create spool directory")+
+      " \""+jour_spool_dir+"\"";
+    return false;
+  }
+  if((jour_fd=::open(spoolFile().toUtf8(),O_RDWR|O_CREAT|O_APPEND|O_CLOEXEC,
+		     S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH))<0) {
+    *err_msg=QObject::tr("unable to open spool file")+
+      " \""+spoolFile()+"\" ["+strerror(errno)+"]";
+    return false;
+  }
+  if(flock(jour_fd,LOCK_EX|LOCK_NB)!=0) {
+    *err_msg=QObject::tr("spool file")+" \""+spoolFile()+"\" "+
+      QObject::tr("is in use by another process");
+    ::close(jour_fd);
+    jour_fd=-1;
+    return false;
+  }
+  if(!Replay(err_msg)) {
+    ::close(jour_fd);
+    jour_fd=-1;
+    return false;
+  }
+
+  jour_exiting=false;
+  pthread_attr_init(&pthread_attr);
+  if(pthread_create(&jour_thread,&pthread_attr,
+		    RDElrJournal::ThreadCallback,this)!=0) {
+    pthread_attr_destroy(&pthread_attr);
+    *err_msg=QObject::tr("unable to start journal thread");
+    ::close(jour_fd);
+    jour_fd=-1;
+    jour_queue.clear();
+    return false;
+  }
+  pthread_attr_destroy(&pthread_attr);
+  jour_running=true;
+
+  return true;
+}
+
+
+void RDElrJournal::close()
+{
+  if(jour_running) {
+    pthread_mutex_lock(&jour_mutex);
+    jour_exiting=true;
+    pthread_cond_signal(&jour_cond);
+    pthread_mutex_unlock(&jour_mutex);
+    pthread_join(jour_thread,NULL);
+    jour_running=false;
+  }
+  if(jour_fd>=0) {
+    ::close(jour_fd);
+    jour_fd=-1;
+  }
+  jour_queue.clear();
+}
+
+
+bool RDElrJournal::isOpen() const
+{
+  return jour_running;
+}
+
+
+void RDElrJournal::append(const RDElrRecord &rec)
+{
+  QString err_msg;
+  bool spooled=false;
+
+  if(jour_running) {
+    QByteArray data=(rec.toString()+"\n").toUtf8();
+    RDElrJournal::Entry entry;
+    entry.record=rec;
+
+    pthread_mutex_lock(&jour_mutex);
+    if(write(jour_fd,data.constData(),data.size())==data.size()) {
+      jour_size+=data.size();
+      entry.end_offset=jour_size;
+      jour_queue.push_back(entry);
+      if((jour_queue.size()==1)||
+	 (jour_queue.size()==RD_ELR_JOURNAL_BATCH_SIZE)) {
+	pthread_cond_signal(&jour_cond);
+      }
+      spooled=true;
+    }
+    else {
+      //
+      // Discard any partial line so as to keep the spool parseable
+      //
+      ftruncate(jour_fd,jour_size);
+    }
+    pthread_mutex_unlock(&jour_mutex);
+    if(spooled) {
+      return;
+    }
+    RDApplication::syslog(jour_config,LOG_WARNING,
+		      "unable to write ELR spool \"%s\" [%s], writing directly",
+			  spoolFile().toUtf8().constData(),strerror(errno));
+  }
+
+  //
+  // No spool, so write synchronously
+  //
+  std::vector<RDElrRecord> recs;
+  recs.push_back(rec);
+  if((!Resolve(QSqlDatabase::database(),&recs,&err_msg))||
+     (!Write(QSqlDatabase::database(),&recs,&err_msg))) {
+    RDApplication::syslog(jour_config,LOG_WARNING,
+			  "unable to write ELR record [%s]",
+			  err_msg.toUtf8().constData());
+  }
+}
+
+
+unsigned RDElrJournal::pending() const
+{
+  unsigned ret;
+
+  pthread_mutex_lock(&jour_mutex);
+  ret=jour_queue.size();
+  pthread_mutex_unlock(&jour_mutex);
+
+  return ret;
+}
+
+
+uint64_t RDElrJournal::recordsWritten() const
+{
+  uint64_t ret;
+
+  pthread_mutex_lock(&jour_mutex);
+  ret=jour_written;
+  pthread_mutex_unlock(&jour_mutex);
+
+  return ret;
+}
+
+
+bool RDElrJournal::waitForFlush(int msecs)
+{
+  struct timeval tv;
+  struct timespec deadline;
+  bool ret;
+
+  gettimeofday(&tv,NULL);
+  deadline.tv_sec=tv.tv_sec+msecs/1000;
+  deadline.tv_nsec=1000*tv.tv_usec+1000000*(msecs%1000);
+  if(deadline.tv_nsec>=1000000000) {
+    deadline.tv_sec++;
+    deadline.tv_nsec-=1000000000;
+  }
+  pthread_mutex_lock(&jour_mutex);
+  pthread_cond_signal(&jour_cond);
+  while(jour_running&&(!jour_queue.empty())) {
+    if(pthread_cond_timedwait(&jour_flushed_cond,&jour_mutex,&deadline)==
+       ETIMEDOUT) {
+      break;
+    }
+  }
+  ret=jour_queue.empty();
+  pthread_mutex_unlock(&jour_mutex);
+
+  return ret;
+}
+
+
+void *RDElrJournal::ThreadCallback(void *ptr)
+{
+  RDElrJournal *journal=(RDElrJournal *)ptr;
+
+  journal->Run();
+
+  return NULL;
+}
+
+
+void RDElrJournal::Run()
+{
+  struct timeval tv;
+  struct timespec deadline;
+  int interval;
+  bool ok=true;
+
+  {
+    QSqlDatabase db=
+      QSqlDatabase::addDatabase(jour_config->mysqlDriver(),jour_conn_name);
+    db.setHostName(jour_config->mysqlHostname());
+    db.setDatabaseName(jour_config->mysqlDbname());
+    db.setUserName(jour_config->mysqlUsername());
+    db.setPassword(jour_config->mysqlPassword());
+  }
+
+  pthread_mutex_lock(&jour_mutex);
+  while(!jour_exiting) {
+    if(jour_queue.empty()) {
+      pthread_cond_wait(&jour_cond,&jour_mutex);
+      continue;
+    }
+
+    //
+    // Give further records a chance to arrive, so that they can go out
+    // in the same insert. After a failure, wait before reconnecting.
+    //
+    interval=0;
+    if(!ok) {
+      interval=RD_ELR_JOURNAL_RETRY_INTERVAL;
+    }
+    else {
+      if(jour_queue.size()<RD_ELR_JOURNAL_BATCH_SIZE) {
+	interval=RD_ELR_JOURNAL_FLUSH_INTERVAL;
+      }
+    }
+    if(interval>0) {
+      gettimeofday(&tv,NULL);
+      deadline.tv_sec=tv.tv_sec+interval/1000;
+      deadline.tv_nsec=1000*tv.tv_usec+1000000*(interval%1000);
+      if(deadline.tv_nsec>=1000000000) {
+	deadline.tv_sec++;
+	deadline.tv_nsec-=1000000000;
+      }
+      pthread_cond_timedwait(&jour_cond,&jour_mutex,&deadline);
+      if(jour_exiting) {
+	break;
+      }
+    }
+    pthread_mutex_unlock(&jour_mutex);
+    while((ok=Flush())&&(pending()>0));
+    pthread_mutex_lock(&jour_mutex);
+  }
+  pthread_mutex_unlock(&jour_mutex);
+
+  //
+  // Last chance to write anything still pending. If the database is not
+  // available, the records stay in the spool for the next open().
+  //
+  if(jour_connected) {
+    while((pending()>0)&&Flush());
+  }
+  Disconnect();
+  QSqlDatabase::removeDatabase(jour_conn_name);
+}
+
+
+bool RDElrJournal::Flush()
+{
+  std::vector<RDElrRecord> recs;
+  unsigned count=0;
+  off_t end_offset=0;
+  off_t pos;
+  QString err_msg;
+
+  pthread_mutex_lock(&jour_mutex);
+  for(std::deque<RDElrJournal::Entry>::const_iterator it=jour_queue.begin();
+      (it!=jour_queue.end())&&(count<RD_ELR_JOURNAL_BATCH_SIZE);it++) {
+    recs.push_back(it->record);
+    end_offset=it->end_offset;
+    count++;
+  }
+  pthread_mutex_unlock(&jour_mutex);
+  if(count==0) {
+    return true;
+  }
+
+  fdatasync(jour_fd);
+  if((!jour_connected)&&(!Connect())) {
+    return false;
+  }
+  QSqlDatabase db=QSqlDatabase::database(jour_conn_name,false);
+  if((!Resolve(db,&recs,&err_msg))||(!Write(db,&recs,&err_msg))) {
+    if(!jour_outage) {
+      RDApplication::syslog(jour_config,LOG_WARNING,
+		     "unable to write ELR records, spooling to \"%s\" [%s]",
+			    spoolFile().toUtf8().constData(),
+			    err_msg.toUtf8().constData());
+      jour_outage=true;
+    }
+    Disconnect();
+    return false;
+  }
+  if(jour_outage) {
+    RDApplication::syslog(jour_config,LOG_INFO,
+			  "ELR writes resumed, %u records pending",pending());
+    jour_outage=false;
+  }
+
+  pthread_mutex_lock(&jour_mutex);
+  for(unsigned i=0;i<count;i++) {
+    jour_queue.pop_front();
+  }
+  jour_written+=recs.size();
+  jour_committed=end_offset;
+  if(jour_queue.empty()&&(jour_committed==jour_size)) {
+    //
+    // Everything is in the database, so start the spool over. Done with
+    // the lock held so that no record can be appended in between.
+    //
+    if(ftruncate(jour_fd,0)==0) {
+      jour_size=0;
+      jour_committed=0;
+      SavePosition(0);
+    }
+    pthread_cond_broadcast(&jour_flushed_cond);
+  }
+  pos=jour_committed;
+  pthread_mutex_unlock(&jour_mutex);
+  if(pos>0) {
+    SavePosition(pos);
+  }
+
+  return true;
+}
+
+
+bool RDElrJournal::Replay(QString *err_msg)
+{
+  FILE *f=NULL;
+  struct stat st;
+  long long pos=0;
+  QByteArray data;
+  char buffer[65536];
+  ssize_t n;
+  off_t offset;
+  int start;
+  int end;
+  RDElrJournal::Entry entry;
+
+  jour_queue.clear();
+  if((f=fopen((jour_spool_dir+"/"+jour_name+".pos").toUtf8(),"r"))!=NULL) {
+    if(fscanf(f,"%lld",&pos)!=1) {
+      pos=0;
+    }
+    fclose(f);
+  }
+  if(fstat(jour_fd,&st)!=0) {
+    *err_msg=QObject::tr("unable to stat spool file")+
+      " \""+spoolFile()+"\" ["+strerror(errno)+"]";
+    return false;
+  }
+  if((pos<0)||(pos>st.st_size)) {
+    pos=0;
+  }
+  offset=pos;
+  while((n=pread(jour_fd,buffer,65536,offset))>0) {
+    data.append(buffer,n);
+    offset+=n;
+  }
+
+  //
+  // Queue every complete line, and drop a trailing partial one left
+  // by an interrupted write.
+  //
+  start=0;
+  while((end=data.indexOf('\n',start))>=0) {
+    QString line=QString::fromUtf8(data.mid(start,end-start));
+    if(entry.record.fromString(line)) {
+      entry.end_offset=pos+end+1;
+      jour_queue.push_back(entry);
+    }
+    else {
+      RDApplication::syslog(jour_config,LOG_WARNING,
+			    "discarding malformed ELR spool record in \"%s\"",
+			    spoolFile().toUtf8().constData());
+    }
+    start=end+1;
+  }
+  jour_committed=pos;
+  jour_size=pos+start;
+  if(jour_size!=st.st_size) {
+    ftruncate(jour_fd,jour_size);
+  }
+  if(jour_queue.empty()&&(jour_size>0)) {
+    ftruncate(jour_fd,0);
+    jour_size=0;
+    jour_committed=0;
+    SavePosition(0);
+  }
+  if(jour_queue.size()>0) {
+    RDApplication::syslog(jour_config,LOG_INFO,
+			  "replaying %u ELR records from \"%s\"",
+			  (unsigned)jour_queue.size(),
+			  spoolFile().toUtf8().constData());
+  }
+
+  return true;
+}
+
+
+bool RDElrJournal::SavePosition(off_t offset)
+{
+  QString filename=jour_spool_dir+"/"+jour_name+".pos";
+  FILE *f=NULL;
+
+  if((f=fopen((filename+"-temp").toUtf8(),"w"))==NULL) {
+    return false;
+  }
+  fprintf(f,"%lld\n",(long long)offset);
+  fclose(f);
+
+  return rename((filename+"-temp").toUtf8(),filename.toUtf8())==0;
+}
+
+
+bool RDElrJournal::Connect()
+{
+  QSqlDatabase db=QSqlDatabase::database(jour_conn_name,false);
+
+  if(!db.open()) {
+    if(!jour_outage) {
+      RDApplication::syslog(jour_config,LOG_WARNING,
+	     "unable to connect to database, spooling ELR records to \"%s\"",
+			    spoolFile().toUtf8().constData());
+      jour_outage=true;
+    }
+    return false;
+  }
+  QSqlQuery q("set NAMES utf8mb4 collate utf8mb4_general_ci",db);
+  jour_connected=true;
+
+  return true;
+}
+
+
+void RDElrJournal::Disconnect()
+{
+  if(jour_connected) {
+    QSqlDatabase::database(jour_conn_name,false).close();
+    jour_connected=false;
+  }
+}
+
+
+bool RDElrJournal::Write(QSqlDatabase db,std::vector<RDElrRecord> *recs,
+			 QString *err_msg)
+{
+  QString sql;
+  QStringList cols;
+  unsigned rows=0;
+  QSqlQuery q(db);
+
+  if(recs->size()==0) {
+    return true;
+  }
+  if(!q.exec("start transaction")) {
+    *err_msg=q.lastError().text();
+    return false;
+  }
+
+  //
+  // One insert per run of records having the same set of columns, which
+  // in practice is one per batch.
+  //
+  for(unsigned i=0;i<recs->size();i++) {
+    if((rows>0)&&(recs->at(i).columns()!=cols)) {
+      if(!q.exec(sql)) {
+	*err_msg=q.lastError().text();
+	q.exec("rollback");
+	return false;
+      }
+      rows=0;
+    }
+    if(rows==0) {
+      cols=recs->at(i).columns();
+      sql=QString("insert into ELR_LINES (")+cols.join(",")+") values ";
+    }
+    else {
+      sql+=",";
+    }
+    sql+="("+recs->at(i).literals().join(",")+")";
+    rows++;
+  }
+  if(!q.exec(sql)) {
+    *err_msg=q.lastError().text();
+    q.exec("rollback");
+    return false;
+  }
+  if(!q.exec("commit")) {
+    *err_msg=q.lastError().text();
+    return false;
+  }
+
+  return true;
+}
+
+
+bool RDElrJournal::Resolve(QSqlDatabase db,std::vector<RDElrRecord> *recs,
+			   QString *err_msg)
+{
+  QStringList cutnames;
+  QStringList cartnums;
+  QMap<QString,QStringList> cuts;
+  QMap<QString,QStringList> carts;
+  std::vector<RDElrRecord> resolved;
+  QString sql;
+  QSqlQuery q(db);
+
+  for(unsigned i=0;i<recs->size();i++) {
+    switch(recs->at(i).lookup()) {
+    case RDElrRecord::LookupCut:
+      cutnames.push_back("\""+RDEscapeString(recs->at(i).lookupKey())+"\"");
+      break;
+
+    case RDElrRecord::LookupMacroCart:
+      cartnums.push_back(QString().
+			 sprintf("%u",recs->at(i).lookupKey().toUInt()));
+      break;
+
+    case RDElrRecord::LookupNone:
+      break;
+    }
+  }
+  if((cutnames.size()==0)&&(cartnums.size()==0)) {
+    return true;
+  }
+
+  if(cutnames.size()>0) {
+    sql=QString("select ")+
+      "CUTS.CUT_NAME,"+      // 00
+      "CART.TITLE,"+         // 01
+      "CART.ARTIST,"+        // 02
+      "CART.PUBLISHER,"+     // 03
+      "CART.COMPOSER,"+      // 04
+      "CART.USAGE_CODE,"+    // 05
+      "CUTS.ISRC,"+          // 06
+      "CART.ALBUM,"+         // 07
+      "CART.LABEL,"+         // 08
+      "CUTS.ISCI,"+          // 09
+      "CART.CONDUCTOR,"+     // 10
+      "CART.USER_DEFINED,"+  // 11
+      "CART.SONG_ID,"+       // 12
+      "CUTS.DESCRIPTION,"+   // 13
+      "CUTS.OUTCUE "+        // 14
+      "from CART left join CUTS "+
+      "on CART.NUMBER=CUTS.CART_NUMBER where "+
+      "CUTS.CUT_NAME in ("+cutnames.join(",")+")";
+    if(!q.exec(sql)) {
+      *err_msg=q.lastError().text();
+      return false;
+    }
+    while(q.next()) {
+      QStringList values;
+      for(int i=1;i<15;i++) {
+	values.push_back(q.value(i).toString());
+      }
+      cuts[q.value(0).toString()]=values;
+    }
+  }
+
+  if(cartnums.size()>0) {
+    sql=QString("select ")+
+      "NUMBER,"+         // 00
+      "TITLE,"+          // 01
+      "ARTIST,"+         // 02
+      "PUBLISHER,"+      // 03
+      "COMPOSER,"+       // 04
+      "USAGE_CODE,"+     // 05
+      "FORCED_LENGTH,"+  // 06
+      "ALBUM,"+          // 07
+      "LABEL "+          // 08
+      "from CART where "+
+      "NUMBER in ("+cartnums.join(",")+")";
+    if(!q.exec(sql)) {
+      *err_msg=q.lastError().text();
+      return false;
+    }
+    while(q.next()) {
+      QStringList values;
+      for(int i=1;i<9;i++) {
+	values.push_back(q.value(i).toString());
+      }
+      carts[q.value(0).toString()]=values;
+    }
+  }
+
+  for(unsigned i=0;i<recs->size();i++) {
+    RDElrRecord rec=recs->at(i);
+    QStringList v;
+    switch(rec.lookup()) {
+    case RDElrRecord::LookupCut:
+      if(!cuts.contains(rec.lookupKey())) {
+	continue;
+      }
+      v=cuts.value(rec.lookupKey());
+      rec.setValue("TITLE",v.at(0));
+      rec.setValue("ARTIST",v.at(1));
+      rec.setValue("PUBLISHER",v.at(2));
+      rec.setValue("COMPOSER",v.at(3));
+      rec.setValue("USAGE_CODE",v.at(4).toInt());
+      rec.setValue("ISRC",v.at(5));
+      rec.setValue("ALBUM",v.at(6));
+      rec.setValue("LABEL",v.at(7));
+      rec.setValue("ISCI",v.at(8));
+      rec.setValue("CONDUCTOR",v.at(9));
+      rec.setValue("USER_DEFINED",v.at(10));
+      rec.setValue("SONG_ID",v.at(11));
+      rec.setValue("DESCRIPTION",v.at(12));
+      rec.setValue("OUTCUE",v.at(13));
+      break;
+
+    case RDElrRecord::LookupMacroCart:
+      if(!carts.contains(QString().
+			 sprintf("%u",rec.lookupKey().toUInt()))) {
+	continue;
+      }
+      v=carts.value(QString().sprintf("%u",rec.lookupKey().toUInt()));
+      rec.setValue("LENGTH",v.at(5).toInt());
+      rec.setValue("TITLE",v.at(0));
+      rec.setValue("ARTIST",v.at(1));
+      rec.setValue("PUBLISHER",v.at(2));
+      rec.setValue("COMPOSER",v.at(3));
+      rec.setValue("USAGE_CODE",v.at(4).toInt());
+      rec.setValue("ALBUM",v.at(6));
+      rec.setValue("LABEL",v.at(7));
+      break;
+
+    case RDElrRecord::LookupNone:
+      break;
+    }
+    rec.setLookup(RDElrRecord::LookupNone,"");
+    resolved.push_back(rec);
+  }
+  *recs=resolved;
+
+  return true;
+}
@@ -0,0 +1,131 @@
+// rdelrjournal.h
+//
+// Spooled, asynchronous writer for as-played (ELR) records
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDELRJOURNAL_H
+#define RDELRJOURNAL_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <deque>
+#include <vector>
+
+#include <QSqlDatabase>
+#include <QStringList>
+
+#include <rdconfig.h>
+
+//
+// Maximum number of records written by a single multi-row insert
+//
+#define RD_ELR_JOURNAL_BATCH_SIZE 200
+
+//
+// Longest time a record waits in the spool before a flush is attempted
+// (mS)
+//
+#define RD_ELR_JOURNAL_FLUSH_INTERVAL 1000
+
+//
+// Time to wait before reconnecting after a database error (mS)
+//
+#define RD_ELR_JOURNAL_RETRY_INTERVAL 5000
+
+class RDElrRecord
+{
+ public:
+  enum Lookup {LookupNone=0,LookupCut=1,LookupMacroCart=2};
+  RDElrRecord();
+  void setValue(const QString &col,const QString &str);
+  void setValue(const QString &col,int value);
+  void setValue(const QString &col,unsigned value);
+  void setLiteral(const QString &col,const QString &sql);
+  Lookup lookup() const;
+  QString lookupKey() const;
+  void setLookup(Lookup type,const QString &key);
+  QStringList columns() const;
+  QStringList literals() const;
+  QString toString() const;
+  bool fromString(const QString &str);
+
+ private:
+  static QString Encode(const QString &str);
+  static QString Decode(const QString &str);
+  QStringList rec_columns;
+  QStringList rec_literals;
+  Lookup rec_lookup;
+  QString rec_lookup_key;
+};
+
+
+class RDElrJournal
+{
+ public:
+  RDElrJournal(RDConfig *config,const QString &spool_dir,const QString &name);
+  ~RDElrJournal();
+  QString spoolFile() const;
+  bool open(QString *err_msg);
+  void close();
+  bool isOpen() const;
+  void append(const RDElrRecord &rec);
+  unsigned pending() const;
+  uint64_t recordsWritten() const;
+  bool waitForFlush(int msecs);
+
+ private:
+  class Entry
+  {
+   public:
+    RDElrRecord record;
+    off_t end_offset;
+  };
+  static void *ThreadCallback(void *ptr);
+  void Run();
+  bool Flush();
+  bool Replay(QString *err_msg);
+  bool SavePosition(off_t offset);
+  bool Connect();
+  void Disconnect();
+  static bool Write(QSqlDatabase db,std::vector<RDElrRecord> *recs,
+		    QString *err_msg);
+  static bool Resolve(QSqlDatabase db,std::vector<RDElrRecord> *recs,
+		      QString *err_msg);
+  RDConfig *jour_config;
+  QString jour_spool_dir;
+  QString jour_name;
+  QString jour_conn_name;
+  int jour_fd;
+  off_t jour_committed;
+  off_t jour_size;
+  std::deque<RDElrJournal::Entry> jour_queue;
+  pthread_t jour_thread;
+  mutable pthread_mutex_t jour_mutex;
+  pthread_cond_t jour_cond;
+  pthread_cond_t jour_flushed_cond;
+  bool jour_running;
+  bool jour_exiting;
+  bool jour_connected;
+  bool jour_outage;
+  uint64_t jour_written;
+};
+
+
+#endif  // RDELRJOURNAL_H
@@ -2,7 +2,7 @@
 //
 // Abstract a Rivendell Log Manager Event
 //
-//   (C) Copyright 2002-2022 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2022,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -777,6 +777,7 @@ bool RDEventLine::generateLog(QString logname,const QString &svcname,
 	  sql=QString("select STACK_LINES.CART ")+
 	    "from STACK_LINES left join STACK_SCHED_CODES "+
 	    "on STACK_LINES.ID=STACK_SCHED_CODES.STACK_LINES_ID where "+
+	    "STACK_LINES.SERVICE_NAME=\""+RDEscapeString(svcname)+"\" && "+
 	    QString().sprintf("STACK_LINES.SCHED_STACK_ID=%d && ",stackid-1)+
 	    "STACK_SCHED_CODES.SCHED_CODE=\""+RDEscapeString(wstr)+"\"";
 	  q1=new RDSqlQuery(sql);
@@ -805,6 +806,7 @@ bool RDEventLine::generateLog(QString logname,const QString &svcname,
 	  sql=QString("select STACK_LINES.CART ")+
 	    "from STACK_LINES left join STACK_SCHED_CODES "+
 	    "on STACK_LINES.ID=STACK_SCHED_CODES.STACK_LINES_ID where "+
+	    "STACK_LINES.SERVICE_NAME=\""+RDEscapeString(svcname)+"\" && "+
 	    QString().sprintf("STACK_LINES.SCHED_STACK_ID=%d && ",stackid-1)+
 	    "STACK_SCHED_CODES.SCHED_CODE=\""+RDEscapeString(wstr)+"\"";
 	  q1=new RDSqlQuery(sql);
@@ -1039,33 +1041,21 @@ bool RDEventLine::linkLog(RDLogEvent *e,RDLog *log,const QString &svcname,
   //
   // Load Matching Events and Insert into Log
   //
-  sql=QString("select ")+
-    "CART_NUMBER,"+     // 00
-    "START_SECS,"+      // 01
-    "LENGTH,"+          // 02
-    "EXT_DATA,"+        // 03
-    "EXT_EVENT_ID,"+    // 04
-    "EXT_ANNC_TYPE,"+   // 05
-    "EXT_CART_NAME,"+   // 06
-    "TITLE,"+           // 07
-    "TYPE,"+            // 08
-    "LINK_START_TIME,"+ // 09
-    "LINK_LENGTH "+     // 10
-    "from IMPORTER_LINES where "+
-    "STATION_NAME=\""+RDEscapeString(event_station->name())+"\" && "+
-    QString().sprintf("PROCESS_ID=%u && ",getpid())+
-    QString().sprintf("(START_HOUR=%d)&&",start_start_hour)+
-    QString().sprintf("(START_SECS>=%d)&&",start_start_secs/1000)+
-    QString().sprintf("(START_SECS<=%d)&&",end_start_secs/1000)+
-    "(EVENT_USED=\"N\") order by LINE_ID";
-  q=new RDSqlQuery(sql);
-  while(q->next()) {
-    int length=GetLength(q->value(0).toUInt(),q->value(2).toInt());
+  for(unsigned i=0;i<lines->size();i++) {
+    RDImportLine *line=&(lines->at(i));
+    if((line->start_hour!=start_start_hour)||
+       (line->start_secs<start_start_secs/1000)||
+       (line->start_secs>end_start_secs/1000)||line->event_used) {
+      continue;
+    }
+    line->event_used=true;
+    int length=
+      GetLength(line->cart_number,(line->length<0)?0:line->length);
 
     //
     // Inline Traffic Break
     //
-    if(q->value(8).toUInt()==RDLogLine::TrafficLink) {
+    if(line->type==RDLogLine::TrafficLink) {
       if((!event_nested_event.isEmpty()&&(event_nested_event!=event_name))) {
 	e->insert(e->size(),1);
 	logline=e->logLine(e->size()-1);
@@ -1075,8 +1065,8 @@ bool RDEventLine::linkLog(RDLogEvent *e,RDLog *log,const QString &svcname,
 	logline->setSource(event_src);
 	logline->setEventLength(event_length);
 	logline->setLinkEventName(event_nested_event);
-	logline->setLinkStartTime(q->value(9).toTime());
-	logline->setLinkLength(q->value(10).toInt());
+	logline->setLinkStartTime(line->link_start_time);
+	logline->setLinkLength((line->link_length<0)?0:line->link_length);
 	logline->setLinkStartSlop(inline_start_slop);
 	logline->setLinkEndSlop(inline_end_slop);
 	logline->setLinkId(link_logline->linkId());
@@ -1087,14 +1077,14 @@ bool RDEventLine::linkLog(RDLogEvent *e,RDLog *log,const QString &svcname,
     //
     // Voicetrack Marker
     //
-    if(q->value(8).toUInt()==RDLogLine::Track) {
+    if(line->type==RDLogLine::Track) {
       e->insert(e->size(),1);
       logline=e->logLine(e->size()-1);
       logline->setId(e->nextId());
       logline->setStartTime(RDLogLine::Logged,time);
       logline->setType(RDLogLine::Track);
       logline->setSource(event_src);
-      logline->setMarkerComment(q->value(7).toString());
+      logline->setMarkerComment(line->title);
       logline->setEventLength(event_length);
       logline->setLinkEventName(event_name);
       logline->setLinkStartTime(link_logline->linkStartTime());
@@ -1108,14 +1098,14 @@ bool RDEventLine::linkLog(RDLogEvent *e,RDLog *log,const QString &svcname,
     //
     // Label/Note Cart
     //
-    if(q->value(8).toUInt()==RDLogLine::Marker) {
+    if(line->type==RDLogLine::Marker) {
       e->insert(e->size(),1);
       logline=e->logLine(e->size()-1);
       logline->setId(e->nextId());
       logline->setStartTime(RDLogLine::Logged,time);
       logline->setType(RDLogLine::Marker);
       logline->setSource(event_src);
-      logline->setMarkerComment(q->value(7).toString());
+      logline->setMarkerComment(line->title);
       logline->setEventLength(event_length);
       logline->setLinkEventName(event_name);
       logline->setLinkStartTime(link_logline->linkStartTime());
@@ -1129,23 +1119,23 @@ bool RDEventLine::linkLog(RDLogEvent *e,RDLog *log,const QString &svcname,
     //
     // Cart
     //
-    if(q->value(8).toUInt()==RDLogLine::Cart) {
+    if(line->type==RDLogLine::Cart) {
       e->insert(e->size(),1);
       logline=e->logLine(e->size()-1);
       logline->setId(e->nextId());
       logline->setSource(event_src);
       logline->
 	setStartTime(RDLogLine::Logged,
-		     QTime(start_start_hour,0,0).addSecs(q->value(1).toInt()));
+		     QTime(start_start_hour,0,0).addSecs(line->start_secs));
       logline->setType(RDLogLine::Cart);
-      logline->setCartNumber(q->value(0).toUInt());
+      logline->setCartNumber(line->cart_number);
       logline->setExtStartTime(QTime().addSecs(3600*start_start_hour+
-					       q->value(1).toInt()));
-      logline->setExtLength(q->value(2).toInt());
-      logline->setExtData(q->value(3).toString().trimmed());
-      logline->setExtEventId(q->value(4).toString().trimmed());
-      logline->setExtAnncType(q->value(5).toString().trimmed());
-      logline->setExtCartName(q->value(6).toString().trimmed());
+					       line->start_secs));
+      logline->setExtLength((line->length<0)?0:line->length);
+      logline->setExtData(line->ext_data.trimmed());
+      logline->setExtEventId(line->ext_event_id.trimmed());
+      logline->setExtAnncType(line->ext_annc_type.trimmed());
+      logline->setExtCartName(line->ext_cart_name.trimmed());
       logline->setEventLength(event_length);
       logline->setLinkEventName(event_name);
       logline->setLinkStartTime(link_logline->linkStartTime());
@@ -1173,21 +1163,6 @@ bool RDEventLine::linkLog(RDLogEvent *e,RDLog *log,const QString &svcname,
     trans_type=event_default_transtype;
     grace_time=-1;
   }
-  delete q;
-
-  //
-  // Mark Events as Used
-  //
-  sql=QString("update IMPORTER_LINES set ")+
-    "EVENT_USED=\"Y\" where "+
-    "STATION_NAME=\""+RDEscapeString(event_station->name())+"\" && "+
-    QString().sprintf("PROCESS_ID=%u && ",getpid())+
-    QString().sprintf("(START_HOUR=%d)&&",start_start_hour)+
-    QString().sprintf("(START_SECS>=%d)&&",start_start_secs/1000)+
-    QString().sprintf("(START_SECS<=%d)&&",end_start_secs/1000)+
-    "(EVENT_USED=\"N\")";
-  q=new RDSqlQuery(sql);
-  delete q;
 
   //
   // Autofill
@@ -2,7 +2,7 @@
 //
 // Abstract a Rivendell Log Manager Event
 //
-//   (C) Copyright 2002-2020 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2020,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -21,10 +21,13 @@
 #ifndef RDEVENT_LINE_H
 #define RDEVENT_LINE_H
 
+#include <vector>
+
 #include <qdatetime.h>
 
 #include <rdlog_event.h>
 #include <rdeventimportlist.h>
+#include <rdimportline.h>
 #include <rdlog.h>
 #include <rdlog_line.h>
 #include <rdstation.h>
@@ -79,7 +82,8 @@ class RDEventLine
   bool generateLog(QString logname,const QString &svcname,
 		   QString *errors,QString clockname);
   bool linkLog(RDLogEvent *e,RDLog *log,const QString &svcname,
-	       RDLogLine *link_logline,const QString &track_str,
+	       RDLogLine *link_logline,std::vector<RDImportLine> *lines,
+	       const QString &track_str,
 	       const QString &label_cart,const QString &track_cart,
 	       QString *errors);
   QString propertiesText() const;
@@ -0,0 +1,307 @@
+// rdexportcache.cpp
+//
+// Content-addressed cache of transcoded audio exports
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include <map>
+
+#include <qdir.h>
+#include <qstringlist.h>
+
+#include "rdexportcache.h"
+#include "rdhash.h"
+
+//
+// Abandoned temporary files older than this (seconds) are removed by prune()
+//
+#define RDEXPORTCACHE_STALE_TEMP_AGE 3600
+
+RDExportCache::RDExportCache(const QString &dir,qint64 max_bytes)
+{
+  cache_dir=dir;
+  cache_max_bytes=max_bytes;
+  if((!cache_dir.isEmpty())&&(!MakeDirectory(cache_dir))) {
+    cache_dir="";
+  }
+}
+
+
+bool RDExportCache::isEnabled() const
+{
+  return (!cache_dir.isEmpty())&&(cache_max_bytes>0);
+}
+
+
+QString RDExportCache::directory() const
+{
+  return cache_dir;
+}
+
+
+qint64 RDExportCache::maximumSize() const
+{
+  return cache_max_bytes;
+}
+
+
+QString RDExportCache::pathName(const QString &key) const
+{
+  return cache_dir+"/"+key.left(2)+"/"+key;
+}
+
+
+QString RDExportCache::tempPathName(const QString &key) const
+{
+  QString dirname=cache_dir+"/"+key.left(2);
+
+  MakeDirectory(dirname);
+  return dirname+"/"+key+QString().sprintf(".%d.tmp",getpid());
+}
+
+
+bool RDExportCache::lookup(const QString &key) const
+{
+  if(!isEnabled()) {
+    return false;
+  }
+  QString filename=pathName(key);
+  if(access(filename.toUtf8(),R_OK)!=0) {
+    return false;
+  }
+
+  //
+  // Freshen the timestamp so that prune() treats this entry as recently used
+  //
+  utime(filename.toUtf8(),NULL);
+
+  return true;
+}
+
+
+bool RDExportCache::commit(const QString &tempname,const QString &key)
+{
+  if(!isEnabled()) {
+    discard(tempname);
+    return false;
+  }
+  if(rename(tempname.toUtf8(),pathName(key).toUtf8())!=0) {
+    discard(tempname);
+    return false;
+  }
+  prune();
+
+  return true;
+}
+
+
+void RDExportCache::discard(const QString &tempname) const
+{
+  unlink(tempname.toUtf8());
+}
+
+
+void RDExportCache::prune()
+{
+  int lock_fd=-1;
+  struct stat st;
+  std::multimap<time_t,QString> entries;
+  qint64 total=0;
+  time_t now=time(NULL);
+
+  if(!isEnabled()) {
+    return;
+  }
+
+  //
+  // Only one pruner at a time; if someone else is already at it, let them
+  //
+  if((lock_fd=open((cache_dir+"/.lock").toUtf8(),O_RDONLY|O_CREAT,
+		   S_IRUSR|S_IWUSR))<0) {
+    return;
+  }
+  if(flock(lock_fd,LOCK_EX|LOCK_NB)!=0) {
+    close(lock_fd);
+    return;
+  }
+
+  QDir dir(cache_dir);
+  QStringList subdirs=dir.entryList(QDir::Dirs|QDir::NoDotAndDotDot);
+  for(int i=0;i<subdirs.size();i++) {
+    QDir subdir(cache_dir+"/"+subdirs.at(i));
+    QStringList files=subdir.entryList(QDir::Files);
+    for(int j=0;j<files.size();j++) {
+      QString filename=subdir.path()+"/"+files.at(j);
+      memset(&st,0,sizeof(st));
+      if(stat(filename.toUtf8(),&st)!=0) {
+	continue;
+      }
+      if(files.at(j).endsWith(".tmp")) {
+	if((now-st.st_mtime)>RDEXPORTCACHE_STALE_TEMP_AGE) {
+	  unlink(filename.toUtf8());
+	}
+	continue;
+      }
+      total+=st.st_size;
+      entries.insert(std::pair<time_t,QString>(st.st_mtime,filename));
+    }
+  }
+
+  //
+  // Evict least recently used entries until we're back under the limit
+  //
+  for(std::multimap<time_t,QString>::const_iterator it=entries.begin();
+      (it!=entries.end())&&(total>cache_max_bytes);it++) {
+    memset(&st,0,sizeof(st));
+    if(stat(it->second.toUtf8(),&st)==0) {
+      if(unlink(it->second.toUtf8())==0) {
+	total-=st.st_size;
+      }
+    }
+  }
+
+  flock(lock_fd,LOCK_UN);
+  close(lock_fd);
+}
+
+
+QString RDExportCache::key(const QString &src_hash,RDSettings *s,
+			   int start_pt,int end_pt,float speed_ratio,
+			   const QString &rdxl)
+{
+  QString str=src_hash+
+    QString().sprintf("|%d|%u|%u|%u|%u|%d|%d|%d|%.6f|",
+		      s->format(),
+		      s->channels(),
+		      s->sampleRate(),
+		      s->bitRate(),
+		      s->quality(),
+		      s->normalizationLevel(),
+		      start_pt,
+		      end_pt,
+		      speed_ratio);
+  if(!rdxl.isEmpty()) {
+    str+=RDSha1HashData(rdxl.toUtf8());
+  }
+
+  return RDSha1HashData(str.toUtf8());
+}
+
+
+QString RDExportCache::sourceHash(const QString &sha1,const QString &filename)
+{
+  struct stat st;
+
+  if(!sha1.isEmpty()) {
+    return sha1;
+  }
+
+  //
+  // No stored hash, so fall back to the identity of the file itself
+  //
+  memset(&st,0,sizeof(st));
+  if(stat(filename.toUtf8(),&st)!=0) {
+    return QString();
+  }
+  return RDSha1HashData((filename+
+			 QString().sprintf("|%lu|%ld|%ld",st.st_ino,
+					   st.st_size,st.st_mtime)).toUtf8());
+}
+
+
+bool RDExportCache::sendFile(int out_fd,int in_fd,off_t *offset,off_t len)
+{
+  ssize_t n;
+  char data[65536];
+
+  while(len>0) {
+    if((n=sendfile(out_fd,in_fd,offset,len))<0) {
+      if(errno==EINTR) {
+	continue;
+      }
+      if((errno!=EINVAL)&&(errno!=ENOSYS)) {
+	return false;
+      }
+
+      //
+      // Output can't take sendfile(), so do it the old fashioned way
+      //
+      if(lseek(in_fd,*offset,SEEK_SET)<0) {
+	return false;
+      }
+      while(len>0) {
+	n=read(in_fd,data,(len<(off_t)sizeof(data))?len:sizeof(data));
+	if(n<=0) {
+	  return false;
+	}
+	if(write(out_fd,data,n)!=n) {
+	  return false;
+	}
+	*offset+=n;
+	len-=n;
+      }
+      return true;
+    }
+    if(n==0) {
+      return false;
+    }
+    len-=n;
+  }
+
+  return true;
+}
+
+
+bool RDExportCache::sendFile(int out_fd,const QString &filename)
+{
+  int fd=-1;
+  struct stat st;
+  off_t offset=0;
+  bool ret=false;
+
+  if((fd=open(filename.toUtf8(),O_RDONLY))<0) {
+    return false;
+  }
+  memset(&st,0,sizeof(st));
+  if(fstat(fd,&st)==0) {
+    ret=RDExportCache::sendFile(out_fd,fd,&offset,st.st_size);
+  }
+  close(fd);
+
+  return ret;
+}
+
+
+bool RDExportCache::MakeDirectory(const QString &dirname) const
+{
+  if(mkdir(dirname.toUtf8(),S_IRWXU|S_IRGRP|S_IXGRP|S_IROTH|S_IXOTH)!=0) {
+    return errno==EEXIST;
+  }
+  return true;
+}
@@ -0,0 +1,56 @@
+// rdexportcache.h
+//
+// Content-addressed cache of transcoded audio exports
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDEXPORTCACHE_H
+#define RDEXPORTCACHE_H
+
+#include <sys/types.h>
+
+#include <qstring.h>
+
+#include <rdsettings.h>
+
+class RDExportCache
+{
+ public:
+  RDExportCache(const QString &dir,qint64 max_bytes);
+  bool isEnabled() const;
+  QString directory() const;
+  qint64 maximumSize() const;
+  QString pathName(const QString &key) const;
+  QString tempPathName(const QString &key) const;
+  bool lookup(const QString &key) const;
+  bool commit(const QString &tempname,const QString &key);
+  void discard(const QString &tempname) const;
+  void prune();
+  static QString key(const QString &src_hash,RDSettings *s,int start_pt,
+		     int end_pt,float speed_ratio,const QString &rdxl);
+  static QString sourceHash(const QString &sha1,const QString &filename);
+  static bool sendFile(int out_fd,int in_fd,off_t *offset,off_t len);
+  static bool sendFile(int out_fd,const QString &filename);
+
+ private:
+  bool MakeDirectory(const QString &dirname) const;
+  QString cache_dir;
+  qint64 cache_max_bytes;
+};
+
+
+#endif  // RDEXPORTCACHE_H
@@ -918,6 +918,18 @@ QString RDFeed::imageUrl(int img_id) const
 
 bool RDFeed::postXml()
 {
+  return postXml(rda->station()->webServiceUrl(rda->config()),
+		 rda->user()->name(),rda->user()->password());
+}
+
+
+bool RDFeed::postXml(const QString &ws_url,const QString &login_name,
+		     const QString &passwd) const
+{
+  //
+  // N.B. This does not touch the database, and so is safe to call from
+  // a worker thread.
+  //
   long response_code;
   CURL *curl=NULL;
   CURLcode curl_err;
@@ -933,11 +945,10 @@ bool RDFeed::postXml()
 	     (const char *)QString().sprintf("%u",RDXPORT_COMMAND_POST_RSS),
 	       CURLFORM_END);
   curl_formadd(&first,&last,CURLFORM_PTRNAME,"LOGIN_NAME",
-	       CURLFORM_COPYCONTENTS,rda->user()->name().toUtf8().constData(),
+	       CURLFORM_COPYCONTENTS,login_name.toUtf8().constData(),
 	       CURLFORM_END);
   curl_formadd(&first,&last,CURLFORM_PTRNAME,"PASSWORD",
-	       CURLFORM_COPYCONTENTS,
-	       rda->user()->password().toUtf8().constData(),CURLFORM_END);
+	       CURLFORM_COPYCONTENTS,passwd.toUtf8().constData(),CURLFORM_END);
   curl_formadd(&first,&last,CURLFORM_PTRNAME,"ID",
 	       CURLFORM_COPYCONTENTS,
 	       (const char *)QString().sprintf("%u",feed_id),
@@ -957,10 +968,9 @@ bool RDFeed::postXml()
 		   (const char *)rda->config()->userAgent());
   curl_easy_setopt(curl,CURLOPT_TIMEOUT,RD_CURL_TIMEOUT);
   curl_easy_setopt(curl,CURLOPT_NOPROGRESS,1);
-  curl_easy_setopt(curl,CURLOPT_URL,
-	    rda->station()->webServiceUrl(rda->config()).toUtf8().constData());
+  curl_easy_setopt(curl,CURLOPT_URL,ws_url.toUtf8().constData());
   rda->syslog(LOG_DEBUG,"using web service URL: %s",
-	   rda->station()->webServiceUrl(rda->config()).toUtf8().constData());
+	      ws_url.toUtf8().constData());
 
   //
   // Send it
@@ -1607,7 +1617,8 @@ QString RDFeed::rssXml(QString *err_msg,const QDateTime &now,bool *ok)
     "FEED_IMAGES.WIDTH,"+          // 24
     "FEED_IMAGES.HEIGHT,"+         // 25
     "FEED_IMAGES.DESCRIPTION,"+    // 26
-    "FEED_IMAGES.FILE_EXTENSION "+ // 27
+    "FEED_IMAGES.FILE_EXTENSION,"+ // 27
+    "FEEDS.RSS_SCHEMA "+           // 28
     "from FEEDS ";
   sql+="left join FEED_IMAGES ";
   sql+="on FEEDS.CHANNEL_IMAGE_ID=FEED_IMAGES.ID ";
@@ -1616,16 +1627,19 @@ QString RDFeed::rssXml(QString *err_msg,const QDateTime &now,bool *ok)
   chan_q=new RDSqlQuery(sql);
   if(!chan_q->first()) {
     *err_msg="no feed matches the supplied key name";
+    delete chan_q;
     return QString();
   }
 
   //
   // Load the XML Templates
   //
-  QString header_template=rda->rssSchemas()->headerTemplate(rssSchema());
-  QString channel_template=rda->rssSchemas()->channelTemplate(rssSchema());
-  QString item_template=rda->rssSchemas()->itemTemplate(rssSchema());
-  if(rssSchema()==RDRssSchemas::CustomSchema) {
+  RDRssSchemas::RssSchema schema=
+    (RDRssSchemas::RssSchema)chan_q->value(28).toUInt();
+  QString header_template=rda->rssSchemas()->headerTemplate(schema);
+  QString channel_template=rda->rssSchemas()->channelTemplate(schema);
+  QString item_template=rda->rssSchemas()->itemTemplate(schema);
+  if(schema==RDRssSchemas::CustomSchema) {
     header_template=chan_q->value(14).toString();
     channel_template=chan_q->value(15).toString();
     item_template=chan_q->value(16).toString();
@@ -2109,7 +2123,8 @@ QString RDFeed::ResolveItemWildcards(const QString &tmplt,RDSqlQuery *item_q,
   }
   ret.replace("%ITEM_EXPLICIT%",explicit_str);
   ret.replace("%ITEM_AUDIO_URL%",
-	      RDXmlEscape(audioUrl(item_q->value(14).toUInt())));
+	      RDXmlEscape(QUrl(item_q->value(15).toString()).toString()+"/"+
+			  item_q->value(10).toString()));
   ret.replace("%ITEM_AUDIO_LENGTH%",item_q->value(11).toString());
   ret.replace("%ITEM_AUDIO_TIME%",
 	      RDGetTimeLength(item_q->value(12).toInt(),false,false));
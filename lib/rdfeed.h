@@ -139,6 +139,8 @@ class RDFeed : public QObject
   QString audioUrl(unsigned cast_id);
   QString imageUrl(int img_id) const;
   bool postXml();
+  bool postXml(const QString &ws_url,const QString &login_name,
+	       const QString &passwd) const;
   bool postXmlConditional(const QString &caption,QWidget *widget);
   bool removeRss();
   bool postImage(int img_id) const;
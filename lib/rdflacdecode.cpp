@@ -30,6 +30,7 @@ RDFlacDecode::RDFlacDecode(SNDFILE *dst_sf)
   flac_sf_dst=dst_sf;
   flac_start_point=-1;
   flac_end_point=-1;
+  flac_meter=NULL;
 }
 
 
@@ -40,11 +41,12 @@ void RDFlacDecode::setRange(int start_pt,int end_pt)
 }
 
 
-void RDFlacDecode::decode(RDWaveFile *wave,float *peak)
+void RDFlacDecode::decode(RDWaveFile *wave,float *peak,RDLoudnessMeter *meter)
 {
   flac_active=true;
   flac_wavefile=wave;
   flac_peak_sample=peak;
+  flac_meter=meter;
   if(flac_start_point<0) {
     flac_start_sample=0;
   }
@@ -134,6 +136,9 @@ void RDFlacDecode::UpdatePeak(const float data[],ssize_t len)
       *flac_peak_sample=peak;
     }
   }
+  if(flac_meter!=NULL) {
+    flac_meter->process(data,len/flac_wavefile->getChannels());
+  }
 }
 
 #endif  // HAVE_FLAC
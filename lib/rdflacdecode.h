@@ -25,6 +25,7 @@
 #ifdef HAVE_FLAC
 #include <FLAC++/decoder.h>
 
+#include <rdloudnessmeter.h>
 #include <rdwavefile.h>
 
 class RDFlacDecode : public FLAC::Decoder::File
@@ -32,7 +33,7 @@ class RDFlacDecode : public FLAC::Decoder::File
  public:
   RDFlacDecode(SNDFILE *dst_sf);
   void setRange(int start_pt,int end_pt);
-  void decode(RDWaveFile *src_wave,float *peak);
+  void decode(RDWaveFile *src_wave,float *peak,RDLoudnessMeter *meter=NULL);
 
  protected:
   FLAC__StreamDecoderWriteStatus 
@@ -49,6 +50,7 @@ class RDFlacDecode : public FLAC::Decoder::File
   int flac_start_sample;
   int flac_end_sample;
   float *flac_peak_sample;
+  RDLoudnessMeter *flac_meter;
   int flac_total_frames;
   RDWaveFile *flac_wavefile;
   bool flac_active;
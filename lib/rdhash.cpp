@@ -57,3 +57,17 @@ QString RDSha1Hash(const QString &filename,bool throttle)
 
   return ret;
 }
+
+
+QString RDSha1HashData(const QByteArray &data)
+{
+  QString ret;
+  unsigned char md[SHA_DIGEST_LENGTH];
+
+  SHA1((const unsigned char *)data.constData(),data.size(),md);
+  for(int i=0;i<SHA_DIGEST_LENGTH;i++) {
+    ret+=QString().sprintf("%02x",0xff&md[i]);
+  }
+
+  return ret;
+}
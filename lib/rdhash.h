@@ -21,9 +21,11 @@
 #ifndef RDHASH_H
 #define RDHASH_H
 
+#include <qbytearray.h>
 #include <qstring.h>
 
 QString RDSha1Hash(const QString &filename,bool throttle=false);
+QString RDSha1HashData(const QByteArray &data);
 
 
 #endif  // RD_H
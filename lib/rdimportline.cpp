@@ -0,0 +1,58 @@
+// rdimportline.cpp
+//
+// A parsed line from a traffic or music scheduler import file
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include "rdimportline.h"
+
+RDImportLine::RDImportLine()
+{
+  clear();
+}
+
+
+bool RDImportLine::hasStartTime() const
+{
+  return (start_hour>=0)&&(start_secs>=0);
+}
+
+
+bool RDImportLine::hasTiming() const
+{
+  return hasStartTime()&&(length>=0);
+}
+
+
+void RDImportLine::clear()
+{
+  file_line=0;
+  line_id=0;
+  start_hour=-1;
+  start_secs=-1;
+  length=-1;
+  type=RDLogLine::UnknownType;
+  cart_number=0;
+  title=QString();
+  ext_data=QString();
+  ext_event_id=QString();
+  ext_annc_type=QString();
+  ext_cart_name=QString();
+  link_start_time=QTime();
+  link_length=-1;
+  event_used=false;
+}
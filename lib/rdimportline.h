@@ -0,0 +1,58 @@
+// rdimportline.h
+//
+// A parsed line from a traffic or music scheduler import file
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDIMPORTLINE_H
+#define RDIMPORTLINE_H
+
+#include <qdatetime.h>
+#include <qstring.h>
+
+#include <rdlog_line.h>
+
+//
+// One row of IMPORTER_LINES. Numeric values that are NULL in the table
+// are held as -1 (0 for 'cart_number'), strings as QString::null.
+//
+class RDImportLine
+{
+ public:
+  RDImportLine();
+  bool hasStartTime() const;
+  bool hasTiming() const;
+  void clear();
+  unsigned file_line;
+  int line_id;
+  int start_hour;
+  int start_secs;
+  int length;
+  RDLogLine::Type type;
+  unsigned cart_number;
+  QString title;
+  QString ext_data;
+  QString ext_event_id;
+  QString ext_annc_type;
+  QString ext_cart_name;
+  QTime link_start_time;
+  int link_length;
+  bool event_used;
+};
+
+
+#endif  // RDIMPORTLINE_H
@@ -2,7 +2,7 @@
 //
 // Abstract an RDLibrary Configuration.
 //
-//   (C) Copyright 2002-2022 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2022,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -24,6 +24,7 @@
 #include <rdconf.h>
 #include <rdlibrary_conf.h>
 #include <rdescape_string.h>
+#include <rdsnapshot.h>
 
 //
 // Logos
@@ -36,9 +37,14 @@ RDLibraryConf::RDLibraryConf(const QString &station)
 {
   RDSqlQuery *q;
   QString sql;
+  QVariant id;
 
   lib_station=station;
 
+  if(RDSnapshot::value("RDLIBRARY","STATION",lib_station,"ID",&id)) {
+    lib_id=id.toUInt();
+    return;
+  }
   sql=QString("select ID from RDLIBRARY where ")+
     "STATION=\""+RDEscapeString(lib_station)+"\"";
   q=new RDSqlQuery(sql);
@@ -2,7 +2,7 @@
 //
 // A container class for a Rivendell Log Line.
 //
-//   (C) Copyright 2002-2020 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2020,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -31,6 +31,7 @@
 #include "rdmacro_event.h"
 #include "rdweb.h"
 #include "rdescape_string.h"
+#include "rdstringpool.h"
 
 RDLogLine::RDLogLine()
 {
@@ -62,18 +63,18 @@ RDLogLine::RDLogLine(unsigned cartnum,int cutnum)
     QString().sprintf("NUMBER=%u",log_cart_number);
   q=new RDSqlQuery(sql);
   if(q->first()) {
-    log_group_name=q->value(0).toString();
-    log_title=q->value(1).toString();
-    log_artist=q->value(2).toString();
-    log_album=q->value(3).toString();
-    log_year=QDate(q->value(4).toInt(),1,1);
-    log_label=q->value(5).toString();
-    log_client=q->value(6).toString();
-    log_agency=q->value(7).toString();
-    log_composer=q->value(8).toString();
-    log_publisher=q->value(9).toString();
-    log_user_defined=q->value(10).toString();
-    log_cart_notes=q->value(11).toString();
+    log_meta->group_name=RDStringPool::intern(q->value(0).toString());
+    log_meta->title=RDStringPool::intern(q->value(1).toString());
+    log_meta->artist=RDStringPool::intern(q->value(2).toString());
+    log_meta->album=RDStringPool::intern(q->value(3).toString());
+    log_meta->year=QDate(q->value(4).toInt(),1,1);
+    log_meta->label=RDStringPool::intern(q->value(5).toString());
+    log_meta->client=RDStringPool::intern(q->value(6).toString());
+    log_meta->agency=RDStringPool::intern(q->value(7).toString());
+    log_meta->composer=RDStringPool::intern(q->value(8).toString());
+    log_meta->publisher=RDStringPool::intern(q->value(9).toString());
+    log_meta->user_defined=RDStringPool::intern(q->value(10).toString());
+    log_meta->cart_notes=RDStringPool::intern(q->value(11).toString());
   }
   delete q;
 
@@ -92,14 +93,14 @@ RDLogLine::RDLogLine(unsigned cartnum,int cutnum)
       "CUT_NAME=\""+RDEscapeString(RDCut::cutName(cartnum,cutnum))+"\"";
     q=new RDSqlQuery(sql);
     if(q->first()) {
-      log_description=q->value(0).toString();
+      log_meta->description=RDStringPool::intern(q->value(0).toString());
       log_start_datetime=q->value(1).toDateTime();
       log_end_datetime=q->value(2).toDateTime();
-      log_outcue=q->value(3).toString();
-      log_isci=q->value(4).toString();
-      log_isrc=q->value(5).toString();
-      log_recording_mbid=q->value(6).toString();
-      log_release_mbid=q->value(7).toString();
+      log_meta->outcue=RDStringPool::intern(q->value(3).toString());
+      log_meta->isci=RDStringPool::intern(q->value(4).toString());
+      log_meta->isrc=RDStringPool::intern(q->value(5).toString());
+      log_meta->recording_mbid=RDStringPool::intern(q->value(6).toString());
+      log_meta->release_mbid=RDStringPool::intern(q->value(7).toString());
     }
     delete q;
   }
@@ -115,6 +116,7 @@ void RDLogLine::clearModified(void)
 void RDLogLine::clear()
 {
   clearModified();
+  log_meta=RDLogLine::EmptyMetadata();
   log_id=-1;
   log_status=RDLogLine::Scheduled;
   log_state=RDLogLine::Ok;
@@ -126,8 +128,6 @@ void RDLogLine::clear()
     log_start_time[i]=QTime();
   }
   log_time_type=RDLogLine::Relative;
-  log_origin_user="";
-  log_origin_datetime=QDateTime();
   log_trans_type=RDLogLine::Play;
   for(unsigned i=0;i<2;i++) {
     log_start_point[i]=-1;
@@ -147,27 +147,6 @@ void RDLogLine::clear()
   log_hook_start=-1;
   log_hook_end=-1;
   log_cart_type=RDCart::Audio;
-  log_group_name="";
-  log_group_color=QColor();
-  log_title="";
-  log_artist="";
-  log_publisher="";
-  log_composer="";
-  log_isrc="";
-  log_recording_mbid="";
-  log_release_mbid="";
-  log_album="";
-  log_year=QDate();
-  log_isci="";
-  log_label="";
-  log_conductor="";
-  log_song_id="";
-  log_client="";
-  log_agency="";
-  log_outcue="";
-  log_description="";
-  log_user_defined="";
-  log_usage_code=RDCart::UsageFeature;
   log_forced_length=0;
   log_cut_quantity=0;
   log_last_cut_played=0;
@@ -186,9 +165,6 @@ void RDLogLine::clear()
   log_talk_length=-1;
   log_play_position=0;
   log_type=RDLogLine::Cart;
-  log_marker_comment="";
-  log_marker_label="";
-  log_marker_post_time=QTime();
   log_listview=NULL;
   log_grace_time=0;
   log_forced_stop=false;
@@ -196,10 +172,6 @@ void RDLogLine::clear()
   log_evergreen=false;
   log_ext_start_time=QTime();
   log_ext_length=-1;
-  log_ext_cart_name="";
-  log_ext_data="";
-  log_ext_event_id="";
-  log_ext_annc_type="";
   log_pause_card=-1;
   log_pause_port=-1;
   log_now_next_enabled=false;
@@ -212,7 +184,6 @@ void RDLogLine::clear()
   log_has_custom_transition=false;
   log_use_event_length=false;
   log_event_length=-1;
-  log_link_event_name="";
   log_link_start_time=QTime();
   log_link_length=0;
   log_link_start_slop=0;
@@ -228,9 +199,13 @@ void RDLogLine::clearExternalData()
 {
   log_ext_start_time=QTime();
   log_ext_length=-1;
-  log_ext_data="";
-  log_ext_event_id="";
-  log_ext_annc_type="";
+  if((!log_meta.constData()->ext_data.isEmpty())||
+     (!log_meta.constData()->ext_event_id.isEmpty())||
+     (!log_meta.constData()->ext_annc_type.isEmpty())) {
+    log_meta->ext_data="";
+    log_meta->ext_event_id="";
+    log_meta->ext_annc_type="";
+  }
 }
 
 
@@ -488,26 +463,26 @@ void RDLogLine::setTimeType(RDLogLine::TimeType type)
 
 QString RDLogLine::originUser() const
 {
-  return log_origin_user;
+  return log_meta->origin_user;
 }
 
 
 void RDLogLine::setOriginUser(const QString &username)
 {
-  log_origin_user=username;
+  log_meta->origin_user=RDStringPool::intern(username);
   modified=true;
 }
 
 
 QDateTime RDLogLine::originDateTime() const
 {
-  return log_origin_datetime;
+  return log_meta->origin_datetime;
 }
 
 
 void RDLogLine::setOriginDateTime(const QDateTime &datetime)
 {
-  log_origin_datetime=datetime;
+  log_meta->origin_datetime=datetime;
   modified=true;
 }
 
@@ -818,37 +793,37 @@ void RDLogLine::setAsyncronous(bool state)
 
 QString RDLogLine::groupName() const
 {
-  return log_group_name;
+  return log_meta->group_name;
 }
 
 
 void RDLogLine::setGroupName(const QString &name)
 {
-  log_group_name=name;
+  log_meta->group_name=RDStringPool::intern(name);
 }
 
 
 QColor RDLogLine::groupColor() const
 {
-  return log_group_color;
+  return log_meta->group_color;
 }
 
 
 void RDLogLine::setGroupColor(const QColor &color)
 {
-  log_group_color=color;
+  log_meta->group_color=color;
 }
 
 
 QString RDLogLine::title() const
 {
-  return log_title;
+  return log_meta->title;
 }
 
 
 void RDLogLine::setTitle(const QString &title)
 {
-  log_title=title;
+  log_meta->title=RDStringPool::intern(title);
 }
 
 
@@ -896,229 +871,229 @@ QString RDLogLine::titleText() const
 
 QString RDLogLine::artist() const
 {
-  return log_artist;
+  return log_meta->artist;
 }
 
 
 QString RDLogLine::publisher() const
 {
-  return log_publisher;
+  return log_meta->publisher;
 }
 
 
 void RDLogLine::setPublisher(const QString &pub)
 {
-  log_publisher=pub;
+  log_meta->publisher=RDStringPool::intern(pub);
 }
 
 
 QString RDLogLine::composer() const
 {
-  return log_composer;
+  return log_meta->composer;
 }
 
 
 void RDLogLine::setComposer(const QString &composer)
 {
-  log_composer=composer;
+  log_meta->composer=RDStringPool::intern(composer);
 }
 
 
 void RDLogLine::setArtist(const QString &artist)
 {
-  log_artist=artist;
+  log_meta->artist=RDStringPool::intern(artist);
 }
 
 
 QString RDLogLine::album() const
 {
-  return log_album;
+  return log_meta->album;
 }
 
 
 void RDLogLine::setAlbum(const QString &album)
 {
-  log_album=album;
+  log_meta->album=RDStringPool::intern(album);
 }
 
 
 QDate RDLogLine::year() const
 {
-  return log_year;
+  return log_meta->year;
 }
 
 
 void RDLogLine::setYear(QDate year)
 {
-  log_year=year;
+  log_meta->year=year;
 }
 
 
 QString RDLogLine::isrc() const
 {
-  return log_isrc;
+  return log_meta->isrc;
 }
 
 
 void RDLogLine::setIsrc(const QString &string)
 {
-  log_isrc=string;
+  log_meta->isrc=RDStringPool::intern(string);
 }
 
 
 QString RDLogLine::recordingMbId() const
 {
-  return log_recording_mbid;
+  return log_meta->recording_mbid;
 }
 
 
 void RDLogLine::setRecordingMbId(const QString &mbid)
 {
-  log_recording_mbid=mbid;
+  log_meta->recording_mbid=RDStringPool::intern(mbid);
 }
 
 
 QString RDLogLine::releaseMbId() const
 {
-  return log_release_mbid;
+  return log_meta->release_mbid;
 }
 
 
 void RDLogLine::setReleaseMbId(const QString &mbid)
 {
-  log_release_mbid=mbid;
+  log_meta->release_mbid=RDStringPool::intern(mbid);
 }
 
 
 QString RDLogLine::isci() const
 {
-  return log_isci;
+  return log_meta->isci;
 }
 
 
 void RDLogLine::setIsci(const QString &string)
 {
-  log_isci=string;
+  log_meta->isci=RDStringPool::intern(string);
 }
 
 
 QString RDLogLine::label() const
 {
-  return log_label;
+  return log_meta->label;
 }
 
 
 void RDLogLine::setLabel(const QString &label)
 {
-  log_label=label;
+  log_meta->label=RDStringPool::intern(label);
 }
 
 
 QString RDLogLine::conductor() const
 {
-  return log_conductor;
+  return log_meta->conductor;
 }
 
 
 void RDLogLine::setConductor(const QString &cond)
 {
-  log_conductor=cond;
+  log_meta->conductor=RDStringPool::intern(cond);
 }
 
 
 QString RDLogLine::songId() const
 {
-  return log_song_id;
+  return log_meta->song_id;
 }
 
 
 void RDLogLine::setSongId(const QString &id)
 {
-  log_song_id=id;
+  log_meta->song_id=RDStringPool::intern(id);
 }
 
 
 QString RDLogLine::client() const
 {
-  return log_client;
+  return log_meta->client;
 }
 
 
 void RDLogLine::setClient(const QString &client)
 {
-  log_client=client;
+  log_meta->client=RDStringPool::intern(client);
 }
 
 
 QString RDLogLine::agency() const
 {
-  return log_agency;
+  return log_meta->agency;
 }
 
 
 void RDLogLine::setAgency(const QString &agency)
 {
-  log_agency=agency;
+  log_meta->agency=RDStringPool::intern(agency);
 }
 
 
 QString RDLogLine::outcue() const
 {
-  return log_outcue;
+  return log_meta->outcue;
 }
 
 
 void RDLogLine::setOutcue(const QString &outcue)
 {
-  log_outcue=outcue;
+  log_meta->outcue=RDStringPool::intern(outcue);
 }
 
 
 QString RDLogLine::description() const
 {
-  return log_description;
+  return log_meta->description;
 }
 
 
 void RDLogLine::setDescription(const QString &desc)
 {
-  log_description=desc;
+  log_meta->description=RDStringPool::intern(desc);
 }
 
 
 QString RDLogLine::userDefined() const
 {
-  return log_user_defined;
+  return log_meta->user_defined;
 }
 
 
 void RDLogLine::setUserDefined(const QString &string)
 {
-  log_user_defined=string;
+  log_meta->user_defined=RDStringPool::intern(string);
 }
 
 
 QString RDLogLine::cartNotes() const
 {
-  return log_cart_notes;
+  return log_meta->cart_notes;
 }
 
 
 void RDLogLine::setCartNotes(const QString &str)
 {
-  log_cart_notes=str;
+  log_meta->cart_notes=RDStringPool::intern(str);
 }
 
 
 RDCart::UsageCode RDLogLine::usageCode() const
 {
-  return log_usage_code;
+  return log_meta->usage_code;
 }
 
 
 void RDLogLine::setUsageCode(RDCart::UsageCode code)
 {
-  log_usage_code=code;
+  log_meta->usage_code=code;
 }
 
 
@@ -1281,26 +1256,26 @@ void RDLogLine::setType(RDLogLine::Type type)
 
 QString RDLogLine::markerComment() const
 {
-  return log_marker_comment;
+  return log_meta->marker_comment;
 }
 
 
 void RDLogLine::setMarkerComment(const QString &str)
 {
-  log_marker_comment=str;
+  log_meta->marker_comment=str;
   modified=true;
 }
 
 
 QString RDLogLine::markerLabel() const
 {
-  return log_marker_label;
+  return log_meta->marker_label;
 }
 
 
 void RDLogLine::setMarkerLabel(const QString &str)
 {
-  log_marker_label=str;
+  log_meta->marker_label=str;
   modified=true;
 }
 
@@ -1381,52 +1356,52 @@ void RDLogLine::setExtLength(int length)
 
 QString RDLogLine::extCartName() const
 {
-  return log_ext_cart_name;
+  return log_meta->ext_cart_name;
 }
 
 
 void RDLogLine::setExtCartName(const QString &name)
 {
-  log_ext_cart_name=name;
+  log_meta->ext_cart_name=name;
   modified=true;
 }
 
 
 QString RDLogLine::extData() const
 {
-  return log_ext_data;
+  return log_meta->ext_data;
 }
 
 
 void RDLogLine::setExtData(const QString &data)
 {
-  log_ext_data=data;
+  log_meta->ext_data=data;
   modified=true;
 }
 
 
 QString RDLogLine::extEventId() const
 {
-  return log_ext_event_id;
+  return log_meta->ext_event_id;
 }
 
 
 void RDLogLine::setExtEventId(const QString &id)
 {
-  log_ext_event_id=id;
+  log_meta->ext_event_id=id;
   modified=true;
 }
 
 
 QString RDLogLine::extAnncType() const
 {
-  return log_ext_annc_type;
+  return log_meta->ext_annc_type;
 }
 
 
 void RDLogLine::setExtAnncType(const QString &type)
 {
-  log_ext_annc_type=type;
+  log_meta->ext_annc_type=RDStringPool::intern(type);
   modified=true;
 }
 
@@ -1645,13 +1620,13 @@ void RDLogLine::setEventLength(int msec)
 
 QString RDLogLine::linkEventName() const
 {
-  return log_link_event_name;
+  return log_meta->link_event_name;
 }
 
 
 void RDLogLine::setLinkEventName(const QString &name)
 {
-  log_link_event_name=name;
+  log_meta->link_event_name=RDStringPool::intern(name);
   modified=true;
 }
 
@@ -1990,12 +1965,12 @@ RDLogLine::State RDLogLine::setEvent(int mach,RDLogLine::TransType next_type,
       log_average_segue_length=segueStartPoint(RDLogLine::AutoPointer)-
        startPoint(RDLogLine::AutoPointer);
     }
-    log_outcue=q->value(10).toString();
-    log_isrc=q->value(11).toString();
-    log_isci=q->value(12).toString();
-    log_description=q->value(13).toString();
-    log_recording_mbid=q->value(14).toString();
-    log_release_mbid=q->value(15).toString();
+    log_meta->outcue=RDStringPool::intern(q->value(10).toString());
+    log_meta->isrc=RDStringPool::intern(q->value(11).toString());
+    log_meta->isci=RDStringPool::intern(q->value(12).toString());
+    log_meta->description=RDStringPool::intern(q->value(13).toString());
+    log_meta->recording_mbid=RDStringPool::intern(q->value(14).toString());
+    log_meta->release_mbid=RDStringPool::intern(q->value(15).toString());
     log_segue_gain_cut=q->value(5).toInt();
     delete q;
     delete cart;
@@ -2126,17 +2101,17 @@ void RDLogLine::loadCart(int cartnum,int cutnum)
       default:
 	break;
   }
-  log_group_name=q->value(1).toString();
-  log_title=q->value(2).toString();
-  log_artist=q->value(3).toString();
-  log_album=q->value(4).toString();
-  log_year=q->value(5).toDate();
-  log_label=q->value(6).toString();
-  log_client=q->value(7).toString();
-  log_agency=q->value(8).toString();
-  log_user_defined=q->value(9).toString();
-  log_conductor=q->value(10).toString();
-  log_song_id=q->value(11).toString();
+  log_meta->group_name=RDStringPool::intern(q->value(1).toString());
+  log_meta->title=RDStringPool::intern(q->value(2).toString());
+  log_meta->artist=RDStringPool::intern(q->value(3).toString());
+  log_meta->album=RDStringPool::intern(q->value(4).toString());
+  log_meta->year=q->value(5).toDate();
+  log_meta->label=RDStringPool::intern(q->value(6).toString());
+  log_meta->client=RDStringPool::intern(q->value(7).toString());
+  log_meta->agency=RDStringPool::intern(q->value(8).toString());
+  log_meta->user_defined=RDStringPool::intern(q->value(9).toString());
+  log_meta->conductor=RDStringPool::intern(q->value(10).toString());
+  log_meta->song_id=RDStringPool::intern(q->value(11).toString());
   log_cut_quantity=q->value(13).toUInt();
   log_last_cut_played=q->value(14).toUInt();
   log_play_order=(RDCart::PlayOrder)q->value(15).toInt();
@@ -2147,12 +2122,12 @@ void RDLogLine::loadCart(int cartnum,int cutnum)
   log_preserve_pitch=RDBool(q->value(19).toString());
   log_now_next_enabled=RDBool(q->value(20).toString());
   log_asyncronous=RDBool(q->value(21).toString());
-  log_publisher=q->value(22).toString();
-  log_composer=q->value(23).toString();
-  log_usage_code=(RDCart::UsageCode)q->value(24).toInt();
+  log_meta->publisher=RDStringPool::intern(q->value(22).toString());
+  log_meta->composer=RDStringPool::intern(q->value(23).toString());
+  log_meta->usage_code=(RDCart::UsageCode)q->value(24).toInt();
   log_average_segue_length=q->value(25).toInt();
-  log_cart_notes=q->value(26).toString();
-  log_group_color=QColor(q->value(27).toString());
+  log_meta->cart_notes=RDStringPool::intern(q->value(26).toString());
+  log_meta->group_color=QColor(q->value(27).toString());
   log_play_source=RDLogLine::UnknownSource;
   delete q;
 
@@ -2229,12 +2204,12 @@ void RDLogLine::loadCart(int cartnum,int cutnum)
        startPoint(RDLogLine::AutoPointer);
     }
     log_cut_number=cutnum;
-    log_outcue=q->value(10).toString();
-    log_isrc=q->value(11).toString();
-    log_isci=q->value(12).toString();
-    log_description=q->value(13).toString();
-    log_recording_mbid=q->value(14).toString();
-    log_release_mbid=q->value(15).toString();
+    log_meta->outcue=RDStringPool::intern(q->value(10).toString());
+    log_meta->isrc=RDStringPool::intern(q->value(11).toString());
+    log_meta->isci=RDStringPool::intern(q->value(12).toString());
+    log_meta->description=RDStringPool::intern(q->value(13).toString());
+    log_meta->recording_mbid=RDStringPool::intern(q->value(14).toString());
+    log_meta->release_mbid=RDStringPool::intern(q->value(15).toString());
     log_segue_gain_cut=q->value(5).toInt();
     delete q;
   }
@@ -2580,3 +2555,50 @@ void RDLogLine::setHoldover(bool b)
 {
   is_holdover = b;
 }
+
+
+QSharedDataPointer<RDLogLine::Metadata> RDLogLine::EmptyMetadata()
+{
+  //
+  // Cleared lines all share this until they are given metadata of their own
+  //
+  static QSharedDataPointer<RDLogLine::Metadata> meta(new Metadata());
+
+  return meta;
+}
+
+
+RDLogLine::Metadata::Metadata()
+{
+  origin_user="";
+  origin_datetime=QDateTime();
+  group_name="";
+  group_color=QColor();
+  title="";
+  artist="";
+  album="";
+  publisher="";
+  composer="";
+  isrc="";
+  recording_mbid="";
+  release_mbid="";
+  isci="";
+  year=QDate();
+  label="";
+  conductor="";
+  song_id="";
+  client="";
+  agency="";
+  outcue="";
+  description="";
+  user_defined="";
+  cart_notes="";
+  usage_code=RDCart::UsageFeature;
+  marker_comment="";
+  marker_label="";
+  ext_cart_name="";
+  ext_data="";
+  ext_event_id="";
+  ext_annc_type="";
+  link_event_name="";
+}
@@ -2,7 +2,7 @@
 //
 // A container class for a Rivendell Log Line.
 //
-//   (C) Copyright 2002-2020 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2020,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -25,6 +25,7 @@
 #include <qdatetime.h>
 #include <qmap.h>
 #include <qobject.h>
+#include <qshareddata.h>
 
 #include <rdcart.h>
 #include <rdlistviewitem.h>
@@ -281,19 +282,62 @@ class RDLogLine
   void setHoldover(bool);
 
  private:
-  bool modified;
+  //
+  // Descriptive fields, shared between copies of a line until one of them
+  // is changed
+  //
+  class Metadata : public QSharedData
+  {
+   public:
+    Metadata();
+    QString origin_user;
+    QDateTime origin_datetime;
+    QString group_name;
+    QColor group_color;
+    QString title;
+    QString artist;
+    QString album;
+    QString publisher;
+    QString composer;
+    QString isrc;
+    QString recording_mbid;
+    QString release_mbid;
+    QString isci;
+    QDate year;
+    QString label;
+    QString conductor;
+    QString song_id;
+    QString client;
+    QString agency;
+    QString outcue;
+    QString description;
+    QString user_defined;
+    QString cart_notes;
+    RDCart::UsageCode usage_code;
+    QString marker_comment;
+    QString marker_label;
+    QString ext_cart_name;
+    QString ext_data;
+    QString ext_event_id;
+    QString ext_annc_type;
+    QString link_event_name;
+  };
+  static QSharedDataPointer<Metadata> EmptyMetadata();
+  QSharedDataPointer<Metadata> log_meta;
+  RDListViewItem *log_listview;
+  QObject *log_play_deck;
+  QDateTime log_start_datetime;
+  QDateTime log_end_datetime;
+  QString log_port_name;
+  QString log_cut_name;
   int log_id;
-  RDLogLine::Status log_status;
-  RDLogLine::State log_state;
-  RDLogLine::Source log_source;
-  RDCart::Validity log_validity;
   unsigned log_pass;
   unsigned log_cart_number;
+  int log_cut_number;
   QTime log_start_time[5];
-  RDLogLine::TimeType log_time_type;
-  QString log_origin_user;
-  QDateTime log_origin_datetime;
-  RDLogLine::TransType log_trans_type;
+  QTime log_play_time;
+  QTime log_ext_start_time;
+  QTime log_link_start_time;
   int log_start_point[2];
   int log_end_point[2];
   int log_segue_start_point[2];
@@ -306,84 +350,50 @@ class RDLogLine
   int log_fadedown_gain;
   int log_duck_up_gain;
   int log_duck_down_gain;
-  bool log_hook_mode;
   int log_hook_start;
   int log_hook_end;
-  RDCart::Type log_cart_type;
-  QString log_group_name;
-  QColor log_group_color;
-  QString log_title;
-  QString log_artist;
-  QString log_album;
-  QString log_publisher;
-  QString log_composer;
-  QString log_isrc;
-  QString log_recording_mbid;
-  QString log_release_mbid;
-  QString log_isci;
-  QDate log_year;
-  QString log_label;
-  QString log_conductor;
-  QString log_song_id;
-  QString log_client;
-  QString log_agency;
-  QString log_outcue;
-  QString log_description;
-  QString log_user_defined;
-  QString log_cart_notes;
-  RDCart::UsageCode log_usage_code;
+  int log_talk_start;
+  int log_talk_end;
+  int log_talk_length;
+  int log_effective_length;
   unsigned log_forced_length;
+  int log_average_segue_length;
+  int log_event_length;
   unsigned log_cut_quantity;
   unsigned log_last_cut_played;
+  unsigned log_play_position;
+  int log_deck;
+  int log_grace_time;
+  int log_ext_length;
+  int log_pause_card;
+  int log_pause_port;
+  int log_link_length;
+  int log_link_start_slop;
+  int log_link_end_slop;
+  int log_link_id;
+  RDLogLine::Status log_status;
+  RDLogLine::State log_state;
+  RDLogLine::Source log_source;
+  RDCart::Validity log_validity;
+  RDLogLine::TimeType log_time_type;
+  RDLogLine::TransType log_trans_type;
+  RDCart::Type log_cart_type;
   RDCart::PlayOrder log_play_order;
+  RDLogLine::Type log_type;
+  StartSource log_start_source;
+  bool modified;
+  bool log_hook_mode;
   bool log_enforce_length;
   bool log_preserve_pitch;
-  QDateTime log_start_datetime;
-  QDateTime log_end_datetime;
-  int log_deck;
-  QTime log_play_time;
-  int log_cut_number;
-  int log_effective_length;
-  int log_talk_start;
-  int log_talk_end;
-  int log_talk_length;
-  unsigned log_play_position;
-  RDLogLine::Type log_type;
-  QString log_marker_comment;
-  QString log_marker_label;
-  QTime log_marker_post_time;
-  RDListViewItem *log_listview;
-  QString log_port_name;
-  int log_grace_time;
   bool log_forced_stop;
-  QObject *log_play_deck;
   bool log_play_position_changed;
   bool log_evergreen;
-  QTime log_ext_start_time;
-  int log_ext_length;
-  int log_average_segue_length;
-  QString log_ext_cart_name;
-  QString log_ext_data;
-  QString log_ext_event_id;
-  QString log_ext_annc_type;
-  int log_pause_card;
-  int log_pause_port;
   bool log_now_next_enabled;
-  PlaySource log_play_source;
-  StartSource log_start_source;
   bool log_zombified;
   bool log_timescaling_active;
   bool log_asyncronous;
-  QString log_cut_name;
   bool log_has_custom_transition;
   bool log_use_event_length;
-  int log_event_length;
-  QString log_link_event_name;
-  QTime log_link_start_time;
-  int log_link_length;
-  int log_link_start_slop;
-  int log_link_end_slop;
-  int log_link_id;
   bool log_link_embedded;
   bool is_holdover;
 };
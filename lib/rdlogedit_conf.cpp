@@ -2,7 +2,7 @@
 //
 // Abstract an RDLogedit Configuration.
 //
-//   (C) Copyright 2002-2005,2016-2018 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2005,2016-2018,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -21,6 +21,7 @@
 #include <rdconf.h>
 #include <rdlogedit_conf.h>
 #include <rdescape_string.h>
+#include <rdsnapshot.h>
 
 //
 // Global Classes
@@ -29,9 +30,13 @@ RDLogeditConf::RDLogeditConf(const QString &station)
 {
   QString sql;
   RDSqlQuery *q;
+  QVariant id;
   
   lib_station=station;
 
+  if(RDSnapshot::value("RDLOGEDIT","STATION",lib_station,"ID",&id)) {
+    return;
+  }
   sql=QString("select ID from RDLOGEDIT where ")+
     "STATION=\""+RDEscapeString(lib_station)+"\"";
   q=new RDSqlQuery(sql);
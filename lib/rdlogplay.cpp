@@ -2,7 +2,7 @@
 //
 // Rivendell Log Playout Machine
 //
-//   (C) Copyright 2002-2021 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2021,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -21,6 +21,8 @@
 #include <unistd.h>
 #include <syslog.h>
 
+#include <set>
+
 #include <qapplication.h>
 
 #include "rdapplication.h"
@@ -125,7 +127,7 @@ RDLogPlay::RDLogPlay(int id,RDEventPlayer *player,QObject *parent)
   //
   connect(rda->ripc(),SIGNAL(onairFlagChanged(bool)),
 	  this,SLOT(onairFlagChangedData(bool)));
-  connect(rda->ripc(),SIGNAL(notificationReceived(RDNotification *)),
+  connect(rda->ripc(),SIGNAL(notificationBatchReceived(RDNotification *)),
 	  this,SLOT(notificationReceivedData(RDNotification *)));
 
   //
@@ -1516,6 +1518,7 @@ void RDLogPlay::segueStartData(int id)
   int line=GetLineById(id);
   RDLogLine *logline;
   RDLogLine *next_logline=nextEvent();
+  int tail;
   if(next_logline==NULL) {
     return;
   }
@@ -1529,10 +1532,20 @@ void RDLogPlay::segueStartData(int id)
     if(!GetNextPlayable(&play_next_line,false)) {
       return;
     }
-    StartEvent(play_next_line,next_logline->transType(),
-	       logline->segueTail(next_logline->transType()),
-	       RDLogLine::StartSegue,-1,
-	       logline->segueTail(next_logline->transType()));
+
+    //
+    // Take off however late the segue marker was delivered, so the
+    // outgoing event still stops on its segue end point
+    //
+    tail=logline->segueTail(next_logline->transType());
+    if(logline->playDeck()!=NULL) {
+      tail-=((RDPlayDeck *)logline->playDeck())->lastMarkerDelay();
+      if(tail<0) {
+	tail=0;
+      }
+    }
+    StartEvent(play_next_line,next_logline->transType(),tail,
+	       RDLogLine::StartSegue,-1,tail);
     SetTransTimer();
   }
 }
@@ -1701,10 +1714,14 @@ void RDLogPlay::notificationReceivedData(RDNotification *notify)
   RDLogLine *next_ll=NULL;
 
   if(notify->type()==RDNotification::CartType) {
-    unsigned cartnum=notify->id().toUInt();
+    std::set<unsigned> cartnums;
+    for(int i=0;i<notify->idQuantity();i++) {
+      cartnums.insert(notify->id(i).toUInt());
+    }
     for(int i=0;i<size();i++) {
       if((ll=logLine(i))!=NULL) {
-	if((ll->cartNumber()==cartnum)&&(ll->status()==RDLogLine::Scheduled)&&
+	if((cartnums.count(ll->cartNumber())>0)&&
+	   (ll->status()==RDLogLine::Scheduled)&&
 	   ((ll->type()==RDLogLine::Cart)||(ll->type()==RDLogLine::Macro))) {
 	  switch(ll->state()) {
 	  case RDLogLine::Ok:
@@ -1733,7 +1750,13 @@ void RDLogPlay::notificationReceivedData(RDNotification *notify)
     //
     // Check Refreshability
     //
-    if((play_log!=NULL)&&(notify->id().toString()==play_log->name())) {
+    bool found=false;
+    for(int i=0;i<notify->idQuantity();i++) {
+      if((play_log!=NULL)&&(notify->id(i).toString()==play_log->name())) {
+	found=true;
+      }
+    }
+    if(found) {
       if((!play_log->exists())||(play_log->linkDatetime()!=play_link_datetime)||
 	 (play_log->modifiedDatetime()<=play_modified_datetime)) {
 	if(play_refreshable) {
@@ -1781,6 +1804,11 @@ bool RDLogPlay::StartEvent(int line,RDLogLine::TransType trans_type,
     return false;
   }
 
+  //
+  // Send the transition and the start to caed(8) together
+  //
+  play_cae->beginBatch();
+
   //
   // Transition running events
   //
@@ -1860,6 +1888,7 @@ bool RDLogPlay::StartEvent(int line,RDLogLine::TransType trans_type,
   case RDLogLine::Cart:
     if(!StartAudioEvent(line)) {
       rda->airplayConf()->setLogCurrentLine(play_id,nextLine());
+      play_cae->commitBatch();
       return false;
     }
     aport=GetNextChannel(mport,&card,&port);
@@ -1889,6 +1918,7 @@ bool RDLogPlay::StartEvent(int line,RDLogLine::TransType trans_type,
 		  "log engine: RDLogPlay::StartEvent(): no audio,CUT=%s",
 		  (const char *)logline->cutName().toUtf8());
       rda->airplayConf()->setLogCurrentLine(play_id,nextLine());
+      play_cae->commitBatch();
       return false;
     }
     emit modified(line);
@@ -2065,12 +2095,14 @@ bool RDLogPlay::StartEvent(int line,RDLogLine::TransType trans_type,
        (logline->state()==RDLogLine::NoCart)||
        (logline->state()==RDLogLine::NoCut)) {
       rda->airplayConf()->setLogCurrentLine(play_id,nextLine());
+      play_cae->commitBatch();
       return true;
     }
     play_next_line++;
   }
   play_next_line=-1;
   rda->airplayConf()->setLogCurrentLine(play_id,nextLine());
+  play_cae->commitBatch();
   return true;
 }
 
@@ -3127,7 +3159,6 @@ void RDLogPlay::LogTraffic(RDLogLine *logline,RDLogLine::PlaySource src,
 			   RDAirPlayConf::TrafficAction action,bool onair_flag)
   const
 {
-  QString sql;
   QDateTime datetime=QDateTime(QDate::currentDate(),QTime::currentTime());
   int length=logline->startTime(RDLogLine::Actual).msecsTo(datetime.time());
   if(length<0) {  // Event crossed midnight!
@@ -3145,41 +3176,43 @@ void RDLogPlay::LogTraffic(RDLogLine *logline,RDLogLine::PlaySource src,
     eventDateTimeSQL = RDCheckDateTime(QDateTime(datetime.date(),
           logline->startTime(RDLogLine::Actual)), "yyyy-MM-dd hh:mm:ss");
 
-  sql=QString("insert into ELR_LINES set ")+
-    "SERVICE_NAME=\""+RDEscapeString(serviceName())+"\","+
-    QString().sprintf("LENGTH=%d,",length)+
-    "LOG_NAME=\""+RDEscapeString(logName())+"\","+
-    QString().sprintf("LOG_ID=%d,",logline->id())+
-    QString().sprintf("CART_NUMBER=%u,",logline->cartNumber())+
-    "STATION_NAME=\""+RDEscapeString(rda->station()->name())+"\","+
-    "EVENT_DATETIME="+eventDateTimeSQL+","+
-    QString().sprintf("EVENT_TYPE=%d,",action)+
-    QString().sprintf("EVENT_SOURCE=%d,",logline->source())+
-    "EXT_START_TIME="+RDCheckDateTime(logline->extStartTime(),"hh:mm:ss")+","+
-    QString().sprintf("EXT_LENGTH=%d,",logline->extLength())+
-    "EXT_DATA=\""+RDEscapeString(logline->extData())+"\","+
-    "EXT_EVENT_ID=\""+RDEscapeString(logline->extEventId())+"\","+
-    "EXT_ANNC_TYPE=\""+RDEscapeString(logline->extAnncType())+"\","+
-    QString().sprintf("PLAY_SOURCE=%d,",src)+
-    QString().sprintf("CUT_NUMBER=%d,",logline->cutNumber())+
-    "EXT_CART_NAME=\""+RDEscapeString(logline->extCartName())+"\","+
-    "TITLE=\""+RDEscapeString(logline->title())+"\","+
-    "ARTIST=\""+RDEscapeString(logline->artist())+"\","+
-    "SCHEDULED_TIME="+RDCheckDateTime(logline->startTime(RDLogLine::Logged),
-				       "hh:mm:ss")+","+
-    "ISRC=\""+RDEscapeString(logline->isrc())+"\","+
-    "PUBLISHER=\""+RDEscapeString(logline->publisher())+"\","+
-    "COMPOSER=\""+RDEscapeString(logline->composer())+"\","+
-    QString().sprintf("USAGE_CODE=%d,",logline->usageCode())+
-    QString().sprintf("START_SOURCE=%d,",logline->startSource())+
-    "ONAIR_FLAG=\""+RDYesNo(onair_flag)+"\","+
-    "ALBUM=\""+RDEscapeString(logline->album())+"\","+
-    "LABEL=\""+RDEscapeString(logline->label())+"\","+
-    "USER_DEFINED=\""+RDEscapeString(logline->userDefined())+"\","+
-    "CONDUCTOR=\""+RDEscapeString(logline->conductor())+"\","+
-    "SONG_ID=\""+RDEscapeString(logline->songId())+"\","+
-    "DESCRIPTION=\""+RDEscapeString(logline->description())+"\","+
-    "OUTCUE=\""+RDEscapeString(logline->outcue())+"\","+
-    "ISCI=\""+RDEscapeString(logline->isci())+"\"";
-  RDSqlQuery::apply(sql);
+  RDElrRecord rec;
+  rec.setValue("SERVICE_NAME",serviceName());
+  rec.setValue("LENGTH",length);
+  rec.setValue("LOG_NAME",logName());
+  rec.setValue("LOG_ID",logline->id());
+  rec.setValue("CART_NUMBER",logline->cartNumber());
+  rec.setValue("STATION_NAME",rda->station()->name());
+  rec.setLiteral("EVENT_DATETIME",eventDateTimeSQL);
+  rec.setValue("EVENT_TYPE",action);
+  rec.setValue("EVENT_SOURCE",logline->source());
+  rec.setLiteral("EXT_START_TIME",
+		 RDCheckDateTime(logline->extStartTime(),"hh:mm:ss"));
+  rec.setValue("EXT_LENGTH",logline->extLength());
+  rec.setValue("EXT_DATA",logline->extData());
+  rec.setValue("EXT_EVENT_ID",logline->extEventId());
+  rec.setValue("EXT_ANNC_TYPE",logline->extAnncType());
+  rec.setValue("PLAY_SOURCE",src);
+  rec.setValue("CUT_NUMBER",logline->cutNumber());
+  rec.setValue("EXT_CART_NAME",logline->extCartName());
+  rec.setValue("TITLE",logline->title());
+  rec.setValue("ARTIST",logline->artist());
+  rec.setLiteral("SCHEDULED_TIME",
+		 RDCheckDateTime(logline->startTime(RDLogLine::Logged),
+				 "hh:mm:ss"));
+  rec.setValue("ISRC",logline->isrc());
+  rec.setValue("PUBLISHER",logline->publisher());
+  rec.setValue("COMPOSER",logline->composer());
+  rec.setValue("USAGE_CODE",logline->usageCode());
+  rec.setValue("START_SOURCE",logline->startSource());
+  rec.setValue("ONAIR_FLAG",RDYesNo(onair_flag));
+  rec.setValue("ALBUM",logline->album());
+  rec.setValue("LABEL",logline->label());
+  rec.setValue("USER_DEFINED",logline->userDefined());
+  rec.setValue("CONDUCTOR",logline->conductor());
+  rec.setValue("SONG_ID",logline->songId());
+  rec.setValue("DESCRIPTION",logline->description());
+  rec.setValue("OUTCUE",logline->outcue());
+  rec.setValue("ISCI",logline->isci());
+  rda->elrJournal()->append(rec);
 }
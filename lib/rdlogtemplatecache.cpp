@@ -0,0 +1,146 @@
+// rdlogtemplatecache.cpp
+//
+// Grid, clock and event definitions preloaded for log generation
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include "rddb.h"
+#include "rdescape_string.h"
+#include "rdevent_line.h"
+#include "rdlogtemplatecache.h"
+
+//
+// The cache is read-only once loaded, except that RDClock::generateLog()
+// sets the start time and length of each cached RDEventLine before
+// generating from it. Generators working in parallel must therefore each
+// use their own copy, as is the case for forked worker processes.
+//
+RDLogTemplateCache::RDLogTemplateCache(RDStation *station)
+{
+  cache_station=station;
+}
+
+
+RDLogTemplateCache::~RDLogTemplateCache()
+{
+  clear();
+}
+
+
+QString RDLogTemplateCache::clockName(const QString &svcname,int hour) const
+{
+  QMap<QString,QStringList>::const_iterator it=cache_grids.find(svcname);
+  if((it==cache_grids.end())||(hour<0)||(hour>=it.value().size())) {
+    return QString();
+  }
+  return it.value().at(hour);
+}
+
+
+QList<RDLogTemplateCache::ClockLine> RDLogTemplateCache::
+clockLines(const QString &clockname) const
+{
+  return cache_clocks.value(clockname);
+}
+
+
+RDEventLine *RDLogTemplateCache::eventLine(const QString &eventname) const
+{
+  return cache_events.value(eventname,NULL);
+}
+
+
+void RDLogTemplateCache::load(const QStringList &svcnames)
+{
+  QString sql;
+  RDSqlQuery *q=NULL;
+  RDLogTemplateCache::ClockLine line;
+
+  clear();
+
+  //
+  // Grids
+  //
+  for(int i=0;i<svcnames.size();i++) {
+    QStringList clocks;
+    for(int j=0;j<168;j++) {
+      clocks.push_back(QString());
+    }
+    sql=QString("select ")+
+      "HOUR,"+        // 00
+      "CLOCK_NAME "+  // 01
+      "from SERVICE_CLOCKS where "+
+      "SERVICE_NAME=\""+RDEscapeString(svcnames.at(i))+"\"";
+    q=new RDSqlQuery(sql);
+    while(q->next()) {
+      int hour=q->value(0).toInt();
+      if((hour>=0)&&(hour<168)) {
+	clocks[hour]=q->value(1).toString();
+      }
+    }
+    delete q;
+    cache_grids[svcnames.at(i)]=clocks;
+
+    //
+    // Clocks
+    //
+    for(int j=0;j<clocks.size();j++) {
+      if(clocks.at(j).isEmpty()||cache_clocks.contains(clocks.at(j))) {
+	continue;
+      }
+      QList<RDLogTemplateCache::ClockLine> lines;
+      sql=QString("select ")+
+	"EVENT_NAME,"+  // 00
+	"START_TIME,"+  // 01
+	"LENGTH "+      // 02
+	"from CLOCK_LINES where "+
+	"CLOCK_NAME=\""+RDEscapeString(clocks.at(j))+"\" "+
+	"order by START_TIME";
+      q=new RDSqlQuery(sql);
+      while(q->next()) {
+	line.event_name=q->value(0).toString();
+	line.start_time=q->value(1).toInt();
+	line.length=q->value(2).toInt();
+	lines.push_back(line);
+
+	//
+	// Events
+	//
+	if(!cache_events.contains(line.event_name)) {
+	  RDEventLine *evt=new RDEventLine(cache_station);
+	  evt->setName(line.event_name);
+	  evt->load();
+	  cache_events[line.event_name]=evt;
+	}
+      }
+      delete q;
+      cache_clocks[clocks.at(j)]=lines;
+    }
+  }
+}
+
+
+void RDLogTemplateCache::clear()
+{
+  for(QMap<QString,RDEventLine *>::iterator it=cache_events.begin();
+      it!=cache_events.end();it++) {
+    delete it.value();
+  }
+  cache_events.clear();
+  cache_clocks.clear();
+  cache_grids.clear();
+}
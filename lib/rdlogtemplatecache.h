@@ -0,0 +1,59 @@
+// rdlogtemplatecache.h
+//
+// Grid, clock and event definitions preloaded for log generation
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDLOGTEMPLATECACHE_H
+#define RDLOGTEMPLATECACHE_H
+
+#include <QList>
+#include <QMap>
+#include <QStringList>
+
+#include <rdstation.h>
+
+class RDEventLine;
+
+class RDLogTemplateCache
+{
+ public:
+  class ClockLine
+  {
+   public:
+    QString event_name;
+    int start_time;
+    int length;
+  };
+  RDLogTemplateCache(RDStation *station);
+  ~RDLogTemplateCache();
+  QString clockName(const QString &svcname,int hour) const;
+  QList<RDLogTemplateCache::ClockLine> clockLines(const QString &clockname)
+    const;
+  RDEventLine *eventLine(const QString &eventname) const;
+  void load(const QStringList &svcnames);
+  void clear();
+
+ private:
+  RDStation *cache_station;
+  QMap<QString,QStringList> cache_grids;
+  QMap<QString,QList<RDLogTemplateCache::ClockLine> > cache_clocks;
+  QMap<QString,RDEventLine *> cache_events;
+};
+
+
+#endif  // RDLOGTEMPLATECACHE_H
@@ -0,0 +1,254 @@
+// rdloudnessmeter.cpp
+//
+// Incremental peak and EBU R128 loudness measurement
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <math.h>
+#include <string.h>
+
+#include "rdloudnessmeter.h"
+
+//
+// This follows ITU-R BS.1770-4: a two stage 'K' weighting filter, mean
+// square over 400 mS blocks overlapping by 75%, then an absolute gate at
+// -70 LUFS and a relative gate 10 LU below the absolute-gated level.
+// Blocks are kept as they arrive, so the result does not depend upon how
+// the audio is divided up when passed to process().
+//
+RDLoudnessMeter::RDLoudnessMeter(unsigned chans,unsigned samprate)
+{
+  double K;
+  double Vh;
+  double Vb;
+  double Q;
+  double a0;
+
+  meter_stride=chans;
+  meter_channels=chans;
+  if(meter_channels>RD_LOUDNESS_MAX_CHANNELS) {
+    meter_channels=RD_LOUDNESS_MAX_CHANNELS;
+  }
+  meter_sample_rate=samprate;
+  meter_sub_block_size=samprate/10;
+
+  //
+  // Stage One -- High Shelf
+  //
+  K=tan(M_PI*1681.974450955533/(double)samprate);
+  Vh=pow(10.0,3.999843853973347/20.0);
+  Vb=pow(Vh,0.4996667741545416);
+  Q=0.7071752369554196;
+  a0=1.0+K/Q+K*K;
+  meter_hb[0]=(Vh+Vb*K/Q+K*K)/a0;
+  meter_hb[1]=2.0*(K*K-Vh)/a0;
+  meter_hb[2]=(Vh-Vb*K/Q+K*K)/a0;
+  meter_ha[0]=1.0;
+  meter_ha[1]=2.0*(K*K-1.0)/a0;
+  meter_ha[2]=(1.0-K/Q+K*K)/a0;
+
+  //
+  // Stage Two -- High Pass
+  //
+  K=tan(M_PI*38.13547087602444/(double)samprate);
+  Q=0.5003270373238773;
+  a0=1.0+K/Q+K*K;
+  meter_b[0]=1.0;
+  meter_b[1]=-2.0;
+  meter_b[2]=1.0;
+  meter_a[0]=1.0;
+  meter_a[1]=2.0*(K*K-1.0)/a0;
+  meter_a[2]=(1.0-K/Q+K*K)/a0;
+
+  reset();
+}
+
+
+unsigned RDLoudnessMeter::channels() const
+{
+  return meter_stride;
+}
+
+
+unsigned RDLoudnessMeter::sampleRate() const
+{
+  return meter_sample_rate;
+}
+
+
+void RDLoudnessMeter::reset()
+{
+  memset(meter_z,0,sizeof(meter_z));
+  memset(meter_sum,0,sizeof(meter_sum));
+  memset(meter_sub_blocks,0,sizeof(meter_sub_blocks));
+  meter_sub_block_frames=0;
+  meter_sub_block_count=0;
+  meter_blocks.clear();
+  meter_frames=0;
+  meter_peak_sample=0.0;
+}
+
+
+void RDLoudnessMeter::process(const float *pcm,unsigned frames)
+{
+  float peak;
+
+  for(unsigned i=0;i<frames;i++) {
+    for(unsigned j=0;j<meter_channels;j++) {
+      if((peak=fabsf(pcm[i*meter_stride+j]))>meter_peak_sample) {
+	meter_peak_sample=peak;
+      }
+      ProcessSample(j,pcm[i*meter_stride+j]);
+    }
+    if(++meter_sub_block_frames==meter_sub_block_size) {
+      EndSubBlock();
+    }
+  }
+  meter_frames+=frames;
+}
+
+
+void RDLoudnessMeter::process(const double *pcm,unsigned frames)
+{
+  float peak;
+
+  for(unsigned i=0;i<frames;i++) {
+    for(unsigned j=0;j<meter_channels;j++) {
+      if((peak=(float)fabs(pcm[i*meter_stride+j]))>meter_peak_sample) {
+	meter_peak_sample=peak;
+      }
+      ProcessSample(j,pcm[i*meter_stride+j]);
+    }
+    if(++meter_sub_block_frames==meter_sub_block_size) {
+      EndSubBlock();
+    }
+  }
+  meter_frames+=frames;
+}
+
+
+uint64_t RDLoudnessMeter::frames() const
+{
+  return meter_frames;
+}
+
+
+float RDLoudnessMeter::peakSample() const
+{
+  return meter_peak_sample;
+}
+
+
+double RDLoudnessMeter::peakLevel() const
+{
+  if(meter_peak_sample<=0.0) {
+    return RD_LOUDNESS_SILENCE;
+  }
+  return 20.0*log10((double)meter_peak_sample);
+}
+
+
+double RDLoudnessMeter::integratedLoudness() const
+{
+  double sum=0.0;
+  unsigned n=0;
+  double thres;
+
+  //
+  // Absolute Gate
+  //
+  thres=pow(10.0,(-70.0+0.691)/10.0);
+  for(unsigned i=0;i<meter_blocks.size();i++) {
+    if(meter_blocks[i]>thres) {
+      sum+=meter_blocks[i];
+      n++;
+    }
+  }
+  if(n==0) {
+    return RD_LOUDNESS_SILENCE;
+  }
+
+  //
+  // Relative Gate
+  //
+  thres=sum/(double)n*pow(10.0,-10.0/10.0);
+  sum=0.0;
+  n=0;
+  for(unsigned i=0;i<meter_blocks.size();i++) {
+    if(meter_blocks[i]>thres) {
+      sum+=meter_blocks[i];
+      n++;
+    }
+  }
+  if(n==0) {
+    return RD_LOUDNESS_SILENCE;
+  }
+
+  return -0.691+10.0*log10(sum/(double)n);
+}
+
+
+double RDLoudnessMeter::normalizationGain(int level,float peak_sample)
+{
+  //
+  // Same calculation as used by RDAudioConvert for peak normalization
+  //
+  if(peak_sample<=0.0) {
+    return 0.0;
+  }
+  return (double)level-20.0*log10f(peak_sample);
+}
+
+
+void RDLoudnessMeter::ProcessSample(unsigned chan,double sample)
+{
+  double *z=meter_z[chan];
+  double x;
+  double y;
+
+  //
+  // Direct Form II, one section per stage
+  //
+  x=sample-meter_ha[1]*z[0]-meter_ha[2]*z[1];
+  y=meter_hb[0]*x+meter_hb[1]*z[0]+meter_hb[2]*z[1];
+  z[1]=z[0];
+  z[0]=x;
+
+  x=y-meter_a[1]*z[2]-meter_a[2]*z[3];
+  y=meter_b[0]*x+meter_b[1]*z[2]+meter_b[2]*z[3];
+  z[3]=z[2];
+  z[2]=x;
+
+  meter_sum[chan]+=y*y;
+}
+
+
+void RDLoudnessMeter::EndSubBlock()
+{
+  double power=0.0;
+
+  for(unsigned i=0;i<meter_channels;i++) {
+    power+=meter_sum[i]/(double)meter_sub_block_size;
+    meter_sum[i]=0.0;
+  }
+  meter_sub_blocks[meter_sub_block_count%4]=power;
+  if(++meter_sub_block_count>=4) {
+    meter_blocks.push_back((meter_sub_blocks[0]+meter_sub_blocks[1]+
+			    meter_sub_blocks[2]+meter_sub_blocks[3])/4.0);
+  }
+  meter_sub_block_frames=0;
+}
@@ -0,0 +1,75 @@
+// rdloudnessmeter.h
+//
+// Incremental peak and EBU R128 loudness measurement
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDLOUDNESSMETER_H
+#define RDLOUDNESSMETER_H
+
+#include <stdint.h>
+
+#include <vector>
+
+//
+// Value returned for the level of silence (dBFS or LUFS)
+//
+#define RD_LOUDNESS_SILENCE -100.0
+
+//
+// Maximum number of channels metered
+//
+#define RD_LOUDNESS_MAX_CHANNELS 8
+
+class RDLoudnessMeter
+{
+ public:
+  RDLoudnessMeter(unsigned chans,unsigned samprate);
+  unsigned channels() const;
+  unsigned sampleRate() const;
+  void reset();
+  void process(const float *pcm,unsigned frames);
+  void process(const double *pcm,unsigned frames);
+  uint64_t frames() const;
+  float peakSample() const;
+  double peakLevel() const;
+  double integratedLoudness() const;
+  static double normalizationGain(int level,float peak_sample);
+
+ private:
+  void ProcessSample(unsigned chan,double sample);
+  void EndSubBlock();
+  unsigned meter_stride;
+  unsigned meter_channels;
+  unsigned meter_sample_rate;
+  unsigned meter_sub_block_size;
+  double meter_b[3];
+  double meter_a[3];
+  double meter_hb[3];
+  double meter_ha[3];
+  double meter_z[RD_LOUDNESS_MAX_CHANNELS][4];
+  double meter_sum[RD_LOUDNESS_MAX_CHANNELS];
+  unsigned meter_sub_block_frames;
+  double meter_sub_blocks[4];
+  unsigned meter_sub_block_count;
+  std::vector<double> meter_blocks;
+  uint64_t meter_frames;
+  float meter_peak_sample;
+};
+
+
+#endif  // RDLOUDNESSMETER_H
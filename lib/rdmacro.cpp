@@ -2,7 +2,7 @@
 //
 // A container class for a Rivendell Macro Language Command
 //
-//   (C) Copyright 2002-2018 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2018,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -275,28 +275,82 @@ void RDMacro::clear()
 RDMacro RDMacro::fromString(const QString &str,RDMacro::Role role)
 {
   RDMacro ret;
+
+  Parse(&ret,str.unicode(),str.length(),role);
+
+  return ret;
+}
+
+
+bool RDMacro::parseList(std::vector<RDMacro> *cmds,const QString &str,
+			RDMacro::Role role)
+{
+  const QChar *data=str.unicode();
+  int start=0;
+
+  //
+  // Each command runs up to and including its bang. Anything following
+  // the last bang is ignored.
+  //
+  for(int i=0;i<str.length();i++) {
+    if(data[i]=='!') {
+      cmds->push_back(RDMacro());
+      Parse(&cmds->back(),data+start,i-start+1,role);
+      if(cmds->back().isNull()) {
+	return false;
+      }
+      start=i+1;
+    }
+  }
+
+  return true;
+}
+
+
+void RDMacro::Parse(RDMacro *ret,const QChar *data,int len,
+		    RDMacro::Role role)
+{
   RDMacro::Command cmd=RDMacro::NN;
+  int start=0;
+  int end=len;
+  int offset;
 
-  ret.setRole(role);
+  //
+  // Works directly on the caller's characters, so that the only
+  // strings allocated are the arguments themselves.
+  //
+  ret->setRole(role);
 
   //
   // Check for bang
   //
-  QString str2=str.stripWhiteSpace();
-  if(str2.right(1)!="!") {
-    ret.setCommand(RDMacro::NN);
-    return ret;
+  while((start<end)&&data[start].isSpace()) {
+    start++;
+  }
+  while((end>start)&&data[end-1].isSpace()) {
+    end--;
+  }
+  if((end==start)||(data[end-1]!='!')) {
+    ret->setCommand(RDMacro::NN);
+    return;
+  }
+  end--;
+  while((start<end)&&data[start].isSpace()) {
+    start++;
+  }
+  while((end>start)&&data[end-1].isSpace()) {
+    end--;
   }
 
   //
   // Get Command
   //
-  QStringList f0=str2.left(str2.length()-1).trimmed().split(" ");
-  if(f0[0].length()!=2) {
-    ret.setCommand(RDMacro::NN);
-    return ret;
+  for(offset=start;(offset<end)&&(data[offset]!=' ');offset++);
+  if((offset-start)!=2) {
+    ret->setCommand(RDMacro::NN);
+    return;
   }
-  cmd=(RDMacro::Command)((f0[0].at(0).latin1()<<8)+f0[0].at(1).latin1());
+  cmd=(RDMacro::Command)((data[start].latin1()<<8)+data[start+1].latin1());
   switch(cmd) {
   case RDMacro::AG:
   case RDMacro::AL:
@@ -359,20 +413,20 @@ RDMacro RDMacro::fromString(const QString &str,RDMacro::Role role)
   case RDMacro::TA:
   case RDMacro::UO:
   case RDMacro::PD:
-    ret.setCommand(cmd);
+    ret->setCommand(cmd);
     break;
 	
   default:
-    ret.setCommand(RDMacro::NN);
-    return ret;
+    ret->setCommand(RDMacro::NN);
+    return;
   }
 
   //
   // Get Arguments
   //
-  for(int i=1;i<f0.size();i++) {
-    ret.addArg(f0[i]);
+  while(offset<end) {
+    start=++offset;
+    for(;(offset<end)&&(data[offset]!=' ');offset++);
+    ret->rml_args.push_back(QString(data+start,offset-start));
   }
-
-  return ret;
 }
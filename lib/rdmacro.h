@@ -2,7 +2,7 @@
 //
 // A container class for a Rivendell Macro Language Command
 //
-//   (C) Copyright 2002-2020 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2020,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -72,8 +72,11 @@ class RDMacro
   bool isNull() const;
   void clear();
   static RDMacro fromString(const QString &str,Role role=RDMacro::Cmd);
+  static bool parseList(std::vector<RDMacro> *cmds,const QString &str,
+			Role role=RDMacro::Cmd);
 
  private:
+  static void Parse(RDMacro *ret,const QChar *data,int len,Role role);
   RDMacro::Role rml_role;
   RDMacro::Command rml_cmd;
   QHostAddress rml_addr;
@@ -2,7 +2,7 @@
 //
 // A container class for a list of RML macros.
 //
-//   (C) Copyright 2002-2004,2016 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2004,2016,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -23,6 +23,7 @@
 #include <rddb.h>
 #include <rdescape_string.h>
 #include <rdmacro_event.h>
+#include <rdmacrocartcache.h>
 #include <rdstation.h>
 
 RDMacroEvent::RDMacroEvent(RDRipc *ripc,QObject *parent,const char *name)
@@ -110,30 +111,31 @@ unsigned RDMacroEvent::length() const
 
 bool RDMacroEvent::load(const QString &str)
 {
-  RDMacro cmd;
-  QString rmlstr="";
-
-  for(int i=0;i<str.length();i++) {
-    QChar c=str.at(i);
-    rmlstr+=c;
-    if(c=='!') {
-      cmd=RDMacro::fromString(rmlstr,RDMacro::Cmd);
-      if(cmd.isNull()) {
-	clear();
-	return false;
-      }
-      cmd.setAddress(event_address);
-      cmd.setEchoRequested(false);
-      event_cmds.push_back(new RDMacro(cmd));
-      rmlstr="";
-    }
+  std::vector<RDMacro> cmds;
+
+  if(!RDMacro::parseList(&cmds,str,RDMacro::Cmd)) {
+    clear();
+    return false;
   }
+  Append(cmds);
   return true;
 }
 
 
 bool RDMacroEvent::load(unsigned cartnum)
 {
+  std::vector<RDMacro> cmds;
+  RDMacroCartCache *cache=RDMacroCartCache::engine();
+
+  if(cache!=NULL) {
+    if(!cache->macros(cartnum,&cmds)) {
+      clear();
+      return false;
+    }
+    Append(cmds);
+    return true;
+  }
+
   QString sql=QString().
     sprintf("select MACROS from CART where (NUMBER=%d)&&(TYPE=2)",cartnum);
   RDSqlQuery *q=new RDSqlQuery(sql);
@@ -308,6 +310,17 @@ void RDMacroEvent::sleepTimerData()
 }
 
 
+void RDMacroEvent::Append(const std::vector<RDMacro> &cmds)
+{
+  for(unsigned i=0;i<cmds.size();i++) {
+    RDMacro *cmd=new RDMacro(cmds.at(i));
+    cmd->setAddress(event_address);
+    cmd->setEchoRequested(false);
+    event_cmds.push_back(cmd);
+  }
+}
+
+
 void RDMacroEvent::ExecList(int line)
 {
   if(line==0) {
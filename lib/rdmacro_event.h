@@ -2,7 +2,7 @@
 //
 // A container class for a list of RML macros.
 //
-//   (C) Copyright 2002-2003,2016 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2003,2016,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -71,6 +71,7 @@ class RDMacroEvent : public QObject
   void sleepTimerData();
 
  private:
+  void Append(const std::vector<RDMacro> &cmds);
   void ExecList(int line);
   std::vector<RDMacro *> event_cmds;
   RDRipc *event_ripc;
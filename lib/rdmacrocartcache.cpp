@@ -0,0 +1,184 @@
+// rdmacrocartcache.cpp
+//
+// Per-process cache of parsed macro carts
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include "rdcart.h"
+#include "rddb.h"
+#include "rdmacrocartcache.h"
+
+RDMacroCartCacheEntry::RDMacroCartCacheEntry()
+{
+  exists=false;
+  macro=false;
+  valid=false;
+  loaded=0;
+}
+
+
+
+
+RDMacroCartCache *RDMacroCartCache::cache_engine=NULL;
+
+RDMacroCartCache::RDMacroCartCache(RDRipc *ripc,QObject *parent)
+  : QObject(parent)
+{
+  cache_hits=0;
+  cache_misses=0;
+
+  //
+  // Without an RDRipc connection, changes to carts are picked up only
+  // when an entry reaches RD_MACRO_CART_CACHE_MAX_AGE.
+  //
+  if(ripc!=NULL) {
+    connect(ripc,SIGNAL(notificationReceived(RDNotification *)),
+	    this,SLOT(notificationReceivedData(RDNotification *)));
+  }
+
+  cache_engine=this;
+}
+
+
+RDMacroCartCache::~RDMacroCartCache()
+{
+  if(cache_engine==this) {
+    cache_engine=NULL;
+  }
+}
+
+
+bool RDMacroCartCache::exists(unsigned cartnum)
+{
+  return GetCart(cartnum)->exists;
+}
+
+
+bool RDMacroCartCache::isMacro(unsigned cartnum)
+{
+  return GetCart(cartnum)->macro;
+}
+
+
+bool RDMacroCartCache::macros(unsigned cartnum,std::vector<RDMacro> *cmds)
+{
+  const RDMacroCartCacheEntry *entry=GetCart(cartnum);
+
+  if(!entry->valid) {
+    return false;
+  }
+  if(cmds!=NULL) {
+    cmds->insert(cmds->end(),entry->cmds.begin(),entry->cmds.end());
+  }
+
+  return true;
+}
+
+
+void RDMacroCartCache::invalidate(unsigned cartnum)
+{
+  cache_carts.remove(cartnum);
+}
+
+
+void RDMacroCartCache::clear()
+{
+  cache_carts.clear();
+}
+
+
+unsigned RDMacroCartCache::size() const
+{
+  return cache_carts.size();
+}
+
+
+unsigned RDMacroCartCache::hits() const
+{
+  return cache_hits;
+}
+
+
+unsigned RDMacroCartCache::misses() const
+{
+  return cache_misses;
+}
+
+
+RDMacroCartCache *RDMacroCartCache::engine()
+{
+  return cache_engine;
+}
+
+
+void RDMacroCartCache::notificationReceivedData(RDNotification *notify)
+{
+  if(notify->type()==RDNotification::CartType) {
+    invalidate(notify->id().toUInt());
+  }
+}
+
+
+const RDMacroCartCacheEntry *RDMacroCartCache::GetCart(unsigned cartnum)
+{
+  QString sql;
+  RDSqlQuery *q=NULL;
+  time_t now=time(NULL);
+  QHash<unsigned,RDMacroCartCacheEntry>::const_iterator it=
+    cache_carts.find(cartnum);
+
+  if((it!=cache_carts.end())&&
+     ((now-it.value().loaded)<RD_MACRO_CART_CACHE_MAX_AGE)) {
+    cache_hits++;
+    return &it.value();
+  }
+  cache_misses++;
+  if(cache_carts.size()>=RD_MACRO_CART_CACHE_MAX_CARTS) {
+    cache_carts.clear();
+  }
+
+  //
+  // Carts that don't exist or aren't macro carts are cached too, so that
+  // a stray 'EX' doesn't cost a query every time.
+  //
+  RDMacroCartCacheEntry *entry=&cache_carts[cartnum];
+  entry->exists=false;
+  entry->macro=false;
+  entry->valid=false;
+  entry->loaded=now;
+  entry->cmds.clear();
+  sql=QString("select ")+
+    "TYPE,"+    // 00
+    "MACROS "+  // 01
+    "from CART where "+
+    QString().sprintf("NUMBER=%u",cartnum);
+  q=new RDSqlQuery(sql);
+  if(q->first()) {
+    entry->exists=true;
+    entry->macro=(q->value(0).toInt()==RDCart::Macro);
+    if(entry->macro) {
+      entry->valid=
+	RDMacro::parseList(&entry->cmds,q->value(1).toString());
+      if(!entry->valid) {
+	entry->cmds.clear();
+      }
+    }
+  }
+  delete q;
+
+  return entry;
+}
@@ -0,0 +1,86 @@
+// rdmacrocartcache.h
+//
+// Per-process cache of parsed macro carts
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDMACROCARTCACHE_H
+#define RDMACROCARTCACHE_H
+
+#include <time.h>
+
+#include <vector>
+
+#include <qhash.h>
+#include <qobject.h>
+
+#include <rdmacro.h>
+#include <rdnotification.h>
+#include <rdripc.h>
+
+//
+// Maximum age of a cache entry before it is reread from the database
+// (seconds)
+//
+#define RD_MACRO_CART_CACHE_MAX_AGE 300
+
+//
+// Maximum number of carts held in the cache
+//
+#define RD_MACRO_CART_CACHE_MAX_CARTS 4096
+
+class RDMacroCartCacheEntry
+{
+ public:
+  RDMacroCartCacheEntry();
+  bool exists;
+  bool macro;
+  bool valid;
+  time_t loaded;
+  std::vector<RDMacro> cmds;
+};
+
+
+class RDMacroCartCache : public QObject
+{
+  Q_OBJECT;
+ public:
+  RDMacroCartCache(RDRipc *ripc,QObject *parent=0);
+  ~RDMacroCartCache();
+  bool exists(unsigned cartnum);
+  bool isMacro(unsigned cartnum);
+  bool macros(unsigned cartnum,std::vector<RDMacro> *cmds);
+  void invalidate(unsigned cartnum);
+  void clear();
+  unsigned size() const;
+  unsigned hits() const;
+  unsigned misses() const;
+  static RDMacroCartCache *engine();
+
+ private slots:
+  void notificationReceivedData(RDNotification *notify);
+
+ private:
+  const RDMacroCartCacheEntry *GetCart(unsigned cartnum);
+  QHash<unsigned,RDMacroCartCacheEntry> cache_carts;
+  unsigned cache_hits;
+  unsigned cache_misses;
+  static RDMacroCartCache *cache_engine;
+};
+
+
+#endif  // RDMACROCARTCACHE_H
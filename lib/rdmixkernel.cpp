@@ -0,0 +1,757 @@
+// rdmixkernel.cpp
+//
+// Vectorized float kernels for realtime audio mixing
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <math.h>
+
+#if defined(__x86_64__)||defined(__i386__)
+#define RDMIXKERNEL_X86
+#include <immintrin.h>
+#endif  // __x86_64__ || __i386__
+
+#include "rdmixkernel.h"
+
+//
+// Each kernel comes in a scalar version and, on x86, SSE2 and AVX2
+// versions. The vector versions are built with per-function target
+// attributes so that the library as a whole does not require either
+// instruction set, and are selected at load time by what the CPU running
+// us supports. All versions do their arithmetic in the same order, with
+// separate multiplies and adds, so that they agree with the scalar
+// version when it is not compiled to use fused multiply-adds.
+//
+// Buffers need not be aligned.
+//
+
+//
+// Scalar Kernels
+//
+static void ScalarGainCopy(float *out,const float *in,float gain,
+			   unsigned frames)
+{
+  for(unsigned i=0;i<frames;i++) {
+    out[i]=gain*in[i];
+  }
+}
+
+
+static void ScalarGainSum(float *out,const float *in1,const float *in2,
+			  float gain,unsigned frames)
+{
+  for(unsigned i=0;i<frames;i++) {
+    out[i]=gain*(in1[i]+in2[i]);
+  }
+}
+
+
+static void ScalarGainAccumulate(float *out,const float *in,float gain,
+				 unsigned frames)
+{
+  for(unsigned i=0;i<frames;i++) {
+    out[i]=out[i]+gain*in[i];
+  }
+}
+
+
+static void ScalarMix(float *out,const float *const *ins,const float *gains,
+		      unsigned inputs,unsigned frames)
+{
+  float acc;
+
+  for(unsigned i=0;i<frames;i++) {
+    acc=out[i];
+    for(unsigned j=0;j<inputs;j++) {
+      acc=acc+gains[j]*ins[j][i];
+    }
+    out[i]=acc;
+  }
+}
+
+
+static void ScalarInterleave(float *out,const float *left,const float *right,
+			     float left_gain,float right_gain,unsigned frames)
+{
+  for(unsigned i=0;i<frames;i++) {
+    out[2*i]=left_gain*left[i];
+    out[2*i+1]=right_gain*right[i];
+  }
+}
+
+
+static void ScalarDeinterleaveAccumulate(float *left,float *right,
+					 const float *in,float gain,
+					 unsigned frames)
+{
+  for(unsigned i=0;i<frames;i++) {
+    left[i]=left[i]+gain*in[2*i];
+    right[i]=right[i]+gain*in[2*i+1];
+  }
+}
+
+
+static float ScalarPeak(const float *in,unsigned frames)
+{
+  float ret=0.0;
+
+  for(unsigned i=0;i<frames;i++) {
+    if(fabsf(in[i])>ret) {
+      ret=fabsf(in[i]);
+    }
+  }
+  return ret;
+}
+
+
+static void ScalarPeakInterleaved(float *left_peak,float *right_peak,
+				  const float *in,unsigned frames)
+{
+  *left_peak=0.0;
+  *right_peak=0.0;
+  for(unsigned i=0;i<frames;i++) {
+    if(fabsf(in[2*i])>*left_peak) {
+      *left_peak=fabsf(in[2*i]);
+    }
+    if(fabsf(in[2*i+1])>*right_peak) {
+      *right_peak=fabsf(in[2*i+1]);
+    }
+  }
+}
+
+
+static float ScalarMaximum(const float *in,unsigned frames)
+{
+  float ret=0.0;
+
+  for(unsigned i=0;i<frames;i++) {
+    if(in[i]>ret) {
+      ret=in[i];
+    }
+  }
+  return ret;
+}
+
+
+#ifdef RDMIXKERNEL_X86
+//
+// SSE2 Kernels
+//
+__attribute__((target("sse2")))
+static float Sse2HorizontalMax(__m128 v)
+{
+  v=_mm_max_ps(v,_mm_shuffle_ps(v,v,_MM_SHUFFLE(1,0,3,2)));
+  v=_mm_max_ps(v,_mm_shuffle_ps(v,v,_MM_SHUFFLE(2,3,0,1)));
+  return _mm_cvtss_f32(v);
+}
+
+
+__attribute__((target("sse2")))
+static void Sse2GainCopy(float *out,const float *in,float gain,
+			 unsigned frames)
+{
+  __m128 g=_mm_set1_ps(gain);
+  unsigned i=0;
+
+  for(i=0;(i+4)<=frames;i+=4) {
+    _mm_storeu_ps(out+i,_mm_mul_ps(g,_mm_loadu_ps(in+i)));
+  }
+  ScalarGainCopy(out+i,in+i,gain,frames-i);
+}
+
+
+__attribute__((target("sse2")))
+static void Sse2GainSum(float *out,const float *in1,const float *in2,
+			float gain,unsigned frames)
+{
+  __m128 g=_mm_set1_ps(gain);
+  unsigned i=0;
+
+  for(i=0;(i+4)<=frames;i+=4) {
+    _mm_storeu_ps(out+i,_mm_mul_ps(g,_mm_add_ps(_mm_loadu_ps(in1+i),
+						_mm_loadu_ps(in2+i))));
+  }
+  ScalarGainSum(out+i,in1+i,in2+i,gain,frames-i);
+}
+
+
+__attribute__((target("sse2")))
+static void Sse2GainAccumulate(float *out,const float *in,float gain,
+			       unsigned frames)
+{
+  __m128 g=_mm_set1_ps(gain);
+  unsigned i=0;
+
+  for(i=0;(i+4)<=frames;i+=4) {
+    _mm_storeu_ps(out+i,_mm_add_ps(_mm_loadu_ps(out+i),
+				   _mm_mul_ps(g,_mm_loadu_ps(in+i))));
+  }
+  ScalarGainAccumulate(out+i,in+i,gain,frames-i);
+}
+
+
+__attribute__((target("sse2")))
+static void Sse2Mix(float *out,const float *const *ins,const float *gains,
+		    unsigned inputs,unsigned frames)
+{
+  __m128 g[RD_MIX_KERNEL_MAX_INPUTS];
+  __m128 acc;
+  unsigned i=0;
+
+  for(unsigned j=0;j<inputs;j++) {
+    g[j]=_mm_set1_ps(gains[j]);
+  }
+  for(i=0;(i+4)<=frames;i+=4) {
+    acc=_mm_loadu_ps(out+i);
+    for(unsigned j=0;j<inputs;j++) {
+      acc=_mm_add_ps(acc,_mm_mul_ps(g[j],_mm_loadu_ps(ins[j]+i)));
+    }
+    _mm_storeu_ps(out+i,acc);
+  }
+  for(;i<frames;i++) {
+    float s=out[i];
+    for(unsigned j=0;j<inputs;j++) {
+      s=s+gains[j]*ins[j][i];
+    }
+    out[i]=s;
+  }
+}
+
+
+__attribute__((target("sse2")))
+static void Sse2Interleave(float *out,const float *left,const float *right,
+			   float left_gain,float right_gain,unsigned frames)
+{
+  __m128 lg=_mm_set1_ps(left_gain);
+  __m128 rg=_mm_set1_ps(right_gain);
+  __m128 l;
+  __m128 r;
+  unsigned i=0;
+
+  for(i=0;(i+4)<=frames;i+=4) {
+    l=_mm_mul_ps(lg,_mm_loadu_ps(left+i));
+    r=_mm_mul_ps(rg,_mm_loadu_ps(right+i));
+    _mm_storeu_ps(out+2*i,_mm_unpacklo_ps(l,r));
+    _mm_storeu_ps(out+2*i+4,_mm_unpackhi_ps(l,r));
+  }
+  ScalarInterleave(out+2*i,left+i,right+i,left_gain,right_gain,frames-i);
+}
+
+
+__attribute__((target("sse2")))
+static void Sse2DeinterleaveAccumulate(float *left,float *right,
+				       const float *in,float gain,
+				       unsigned frames)
+{
+  __m128 g=_mm_set1_ps(gain);
+  __m128 a;
+  __m128 b;
+  unsigned i=0;
+
+  for(i=0;(i+4)<=frames;i+=4) {
+    a=_mm_loadu_ps(in+2*i);
+    b=_mm_loadu_ps(in+2*i+4);
+    _mm_storeu_ps(left+i,_mm_add_ps(_mm_loadu_ps(left+i),
+	      _mm_mul_ps(g,_mm_shuffle_ps(a,b,_MM_SHUFFLE(2,0,2,0)))));
+    _mm_storeu_ps(right+i,_mm_add_ps(_mm_loadu_ps(right+i),
+	      _mm_mul_ps(g,_mm_shuffle_ps(a,b,_MM_SHUFFLE(3,1,3,1)))));
+  }
+  ScalarDeinterleaveAccumulate(left+i,right+i,in+2*i,gain,frames-i);
+}
+
+
+__attribute__((target("sse2")))
+static float Sse2Peak(const float *in,unsigned frames)
+{
+  __m128 mask=_mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+  __m128 p=_mm_setzero_ps();
+  float ret;
+  float tail;
+  unsigned i=0;
+
+  for(i=0;(i+4)<=frames;i+=4) {
+    p=_mm_max_ps(p,_mm_and_ps(mask,_mm_loadu_ps(in+i)));
+  }
+  ret=Sse2HorizontalMax(p);
+  if((tail=ScalarPeak(in+i,frames-i))>ret) {
+    ret=tail;
+  }
+  return ret;
+}
+
+
+__attribute__((target("sse2")))
+static void Sse2PeakInterleaved(float *left_peak,float *right_peak,
+				const float *in,unsigned frames)
+{
+  __m128 mask=_mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+  __m128 p=_mm_setzero_ps();
+  float lanes[4];
+  float tail[2];
+  unsigned i=0;
+
+  for(i=0;(i+2)<=frames;i+=2) {
+    p=_mm_max_ps(p,_mm_and_ps(mask,_mm_loadu_ps(in+2*i)));
+  }
+  _mm_storeu_ps(lanes,p);
+  ScalarPeakInterleaved(tail,tail+1,in+2*i,frames-i);
+  *left_peak=fmaxf(fmaxf(lanes[0],lanes[2]),tail[0]);
+  *right_peak=fmaxf(fmaxf(lanes[1],lanes[3]),tail[1]);
+}
+
+
+__attribute__((target("sse2")))
+static float Sse2Maximum(const float *in,unsigned frames)
+{
+  __m128 p=_mm_setzero_ps();
+  float ret;
+  float tail;
+  unsigned i=0;
+
+  for(i=0;(i+4)<=frames;i+=4) {
+    p=_mm_max_ps(p,_mm_loadu_ps(in+i));
+  }
+  ret=Sse2HorizontalMax(p);
+  if((tail=ScalarMaximum(in+i,frames-i))>ret) {
+    ret=tail;
+  }
+  return ret;
+}
+
+
+//
+// AVX2 Kernels
+//
+// The upper halves of the AVX registers are cleared before handing the
+// tail of a buffer to a scalar kernel, which is built without VEX
+// encoding and would otherwise pay a state transition penalty on every
+// instruction.
+//
+__attribute__((target("avx2")))
+static float Avx2HorizontalMax(__m256 v)
+{
+  __m128 h=_mm_max_ps(_mm256_castps256_ps128(v),_mm256_extractf128_ps(v,1));
+
+  h=_mm_max_ps(h,_mm_shuffle_ps(h,h,_MM_SHUFFLE(1,0,3,2)));
+  h=_mm_max_ps(h,_mm_shuffle_ps(h,h,_MM_SHUFFLE(2,3,0,1)));
+  return _mm_cvtss_f32(h);
+}
+
+
+__attribute__((target("avx2")))
+static void Avx2GainCopy(float *out,const float *in,float gain,
+			 unsigned frames)
+{
+  __m256 g=_mm256_set1_ps(gain);
+  unsigned i=0;
+
+  for(i=0;(i+8)<=frames;i+=8) {
+    _mm256_storeu_ps(out+i,_mm256_mul_ps(g,_mm256_loadu_ps(in+i)));
+  }
+  _mm256_zeroupper();
+  ScalarGainCopy(out+i,in+i,gain,frames-i);
+}
+
+
+__attribute__((target("avx2")))
+static void Avx2GainSum(float *out,const float *in1,const float *in2,
+			float gain,unsigned frames)
+{
+  __m256 g=_mm256_set1_ps(gain);
+  unsigned i=0;
+
+  for(i=0;(i+8)<=frames;i+=8) {
+    _mm256_storeu_ps(out+i,
+		     _mm256_mul_ps(g,_mm256_add_ps(_mm256_loadu_ps(in1+i),
+						   _mm256_loadu_ps(in2+i))));
+  }
+  _mm256_zeroupper();
+  ScalarGainSum(out+i,in1+i,in2+i,gain,frames-i);
+}
+
+
+__attribute__((target("avx2")))
+static void Avx2GainAccumulate(float *out,const float *in,float gain,
+			       unsigned frames)
+{
+  __m256 g=_mm256_set1_ps(gain);
+  unsigned i=0;
+
+  for(i=0;(i+8)<=frames;i+=8) {
+    _mm256_storeu_ps(out+i,_mm256_add_ps(_mm256_loadu_ps(out+i),
+				 _mm256_mul_ps(g,_mm256_loadu_ps(in+i))));
+  }
+  _mm256_zeroupper();
+  ScalarGainAccumulate(out+i,in+i,gain,frames-i);
+}
+
+
+__attribute__((target("avx2")))
+static void Avx2Mix(float *out,const float *const *ins,const float *gains,
+		    unsigned inputs,unsigned frames)
+{
+  __m256 g[RD_MIX_KERNEL_MAX_INPUTS];
+  __m256 acc;
+  unsigned i=0;
+
+  for(unsigned j=0;j<inputs;j++) {
+    g[j]=_mm256_set1_ps(gains[j]);
+  }
+  for(i=0;(i+8)<=frames;i+=8) {
+    acc=_mm256_loadu_ps(out+i);
+    for(unsigned j=0;j<inputs;j++) {
+      acc=_mm256_add_ps(acc,_mm256_mul_ps(g[j],_mm256_loadu_ps(ins[j]+i)));
+    }
+    _mm256_storeu_ps(out+i,acc);
+  }
+  for(;i<frames;i++) {
+    float s=out[i];
+    for(unsigned j=0;j<inputs;j++) {
+      s=s+gains[j]*ins[j][i];
+    }
+    out[i]=s;
+  }
+}
+
+
+__attribute__((target("avx2")))
+static void Avx2Interleave(float *out,const float *left,const float *right,
+			   float left_gain,float right_gain,unsigned frames)
+{
+  __m256 lg=_mm256_set1_ps(left_gain);
+  __m256 rg=_mm256_set1_ps(right_gain);
+  __m256 l;
+  __m256 r;
+  __m256 lo;
+  __m256 hi;
+  unsigned i=0;
+
+  for(i=0;(i+8)<=frames;i+=8) {
+    l=_mm256_mul_ps(lg,_mm256_loadu_ps(left+i));
+    r=_mm256_mul_ps(rg,_mm256_loadu_ps(right+i));
+    lo=_mm256_unpacklo_ps(l,r);  // L0 R0 L1 R1 | L4 R4 L5 R5
+    hi=_mm256_unpackhi_ps(l,r);  // L2 R2 L3 R3 | L6 R6 L7 R7
+    _mm256_storeu_ps(out+2*i,_mm256_permute2f128_ps(lo,hi,0x20));
+    _mm256_storeu_ps(out+2*i+8,_mm256_permute2f128_ps(lo,hi,0x31));
+  }
+  _mm256_zeroupper();
+  ScalarInterleave(out+2*i,left+i,right+i,left_gain,right_gain,frames-i);
+}
+
+
+__attribute__((target("avx2")))
+static void Avx2DeinterleaveAccumulate(float *left,float *right,
+				       const float *in,float gain,
+				       unsigned frames)
+{
+  __m256 g=_mm256_set1_ps(gain);
+  __m256 a;
+  __m256 b;
+  __m256 l;
+  __m256 r;
+  unsigned i=0;
+
+  for(i=0;(i+8)<=frames;i+=8) {
+    a=_mm256_loadu_ps(in+2*i);
+    b=_mm256_loadu_ps(in+2*i+8);
+    //
+    // The in-lane shuffles leave the frames in 0 1 4 5 2 3 6 7 order,
+    // fixed up by swapping the middle 64 bit pairs
+    //
+    l=_mm256_shuffle_ps(a,b,_MM_SHUFFLE(2,0,2,0));
+    r=_mm256_shuffle_ps(a,b,_MM_SHUFFLE(3,1,3,1));
+    l=_mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(l),
+					     _MM_SHUFFLE(3,1,2,0)));
+    r=_mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(r),
+					     _MM_SHUFFLE(3,1,2,0)));
+    _mm256_storeu_ps(left+i,_mm256_add_ps(_mm256_loadu_ps(left+i),
+					  _mm256_mul_ps(g,l)));
+    _mm256_storeu_ps(right+i,_mm256_add_ps(_mm256_loadu_ps(right+i),
+					   _mm256_mul_ps(g,r)));
+  }
+  _mm256_zeroupper();
+  ScalarDeinterleaveAccumulate(left+i,right+i,in+2*i,gain,frames-i);
+}
+
+
+__attribute__((target("avx2")))
+static float Avx2Peak(const float *in,unsigned frames)
+{
+  __m256 mask=_mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+  __m256 p=_mm256_setzero_ps();
+  float ret;
+  float tail;
+  unsigned i=0;
+
+  for(i=0;(i+8)<=frames;i+=8) {
+    p=_mm256_max_ps(p,_mm256_and_ps(mask,_mm256_loadu_ps(in+i)));
+  }
+  ret=Avx2HorizontalMax(p);
+  _mm256_zeroupper();
+  if((tail=ScalarPeak(in+i,frames-i))>ret) {
+    ret=tail;
+  }
+  return ret;
+}
+
+
+__attribute__((target("avx2")))
+static void Avx2PeakInterleaved(float *left_peak,float *right_peak,
+				const float *in,unsigned frames)
+{
+  __m256 mask=_mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+  __m256 p=_mm256_setzero_ps();
+  float lanes[8];
+  float tail[2];
+  unsigned i=0;
+
+  for(i=0;(i+4)<=frames;i+=4) {
+    p=_mm256_max_ps(p,_mm256_and_ps(mask,_mm256_loadu_ps(in+2*i)));
+  }
+  _mm256_storeu_ps(lanes,p);
+  _mm256_zeroupper();
+  ScalarPeakInterleaved(tail,tail+1,in+2*i,frames-i);
+  *left_peak=tail[0];
+  *right_peak=tail[1];
+  for(unsigned j=0;j<8;j+=2) {
+    *left_peak=fmaxf(*left_peak,lanes[j]);
+    *right_peak=fmaxf(*right_peak,lanes[j+1]);
+  }
+}
+
+
+__attribute__((target("avx2")))
+static float Avx2Maximum(const float *in,unsigned frames)
+{
+  __m256 p=_mm256_setzero_ps();
+  float ret;
+  float tail;
+  unsigned i=0;
+
+  for(i=0;(i+8)<=frames;i+=8) {
+    p=_mm256_max_ps(p,_mm256_loadu_ps(in+i));
+  }
+  ret=Avx2HorizontalMax(p);
+  _mm256_zeroupper();
+  if((tail=ScalarMaximum(in+i,frames-i))>ret) {
+    ret=tail;
+  }
+  return ret;
+}
+#endif  // RDMIXKERNEL_X86
+
+
+//
+// Dispatch
+//
+static RDMixKernel::Isa mix_isa=RDMixKernel::Scalar;
+static void (*mix_gain_copy)(float *,const float *,float,unsigned)=
+  ScalarGainCopy;
+static void (*mix_gain_sum)(float *,const float *,const float *,float,
+			    unsigned)=ScalarGainSum;
+static void (*mix_gain_accumulate)(float *,const float *,float,unsigned)=
+  ScalarGainAccumulate;
+static void (*mix_mix)(float *,const float *const *,const float *,unsigned,
+		       unsigned)=ScalarMix;
+static void (*mix_interleave)(float *,const float *,const float *,float,
+			      float,unsigned)=ScalarInterleave;
+static void (*mix_deinterleave_accumulate)(float *,float *,const float *,
+					   float,unsigned)=
+  ScalarDeinterleaveAccumulate;
+static float (*mix_peak)(const float *,unsigned)=ScalarPeak;
+static void (*mix_peak_interleaved)(float *,float *,const float *,unsigned)=
+  ScalarPeakInterleaved;
+static float (*mix_maximum)(const float *,unsigned)=ScalarMaximum;
+
+static bool SelectBestIsa()
+{
+  if(RDMixKernel::setIsa(RDMixKernel::Avx2)) {
+    return true;
+  }
+  return RDMixKernel::setIsa(RDMixKernel::Sse2);
+}
+
+static bool mix_isa_selected=SelectBestIsa();
+
+
+RDMixKernel::Isa RDMixKernel::isa()
+{
+  return mix_isa;
+}
+
+
+bool RDMixKernel::setIsa(Isa isa)
+{
+  if(!isaSupported(isa)) {
+    return false;
+  }
+  switch(isa) {
+  case RDMixKernel::Scalar:
+    mix_gain_copy=ScalarGainCopy;
+    mix_gain_sum=ScalarGainSum;
+    mix_gain_accumulate=ScalarGainAccumulate;
+    mix_mix=ScalarMix;
+    mix_interleave=ScalarInterleave;
+    mix_deinterleave_accumulate=ScalarDeinterleaveAccumulate;
+    mix_peak=ScalarPeak;
+    mix_peak_interleaved=ScalarPeakInterleaved;
+    mix_maximum=ScalarMaximum;
+    break;
+
+#ifdef RDMIXKERNEL_X86
+  case RDMixKernel::Sse2:
+    mix_gain_copy=Sse2GainCopy;
+    mix_gain_sum=Sse2GainSum;
+    mix_gain_accumulate=Sse2GainAccumulate;
+    mix_mix=Sse2Mix;
+    mix_interleave=Sse2Interleave;
+    mix_deinterleave_accumulate=Sse2DeinterleaveAccumulate;
+    mix_peak=Sse2Peak;
+    mix_peak_interleaved=Sse2PeakInterleaved;
+    mix_maximum=Sse2Maximum;
+    break;
+
+  case RDMixKernel::Avx2:
+    mix_gain_copy=Avx2GainCopy;
+    mix_gain_sum=Avx2GainSum;
+    mix_gain_accumulate=Avx2GainAccumulate;
+    mix_mix=Avx2Mix;
+    mix_interleave=Avx2Interleave;
+    mix_deinterleave_accumulate=Avx2DeinterleaveAccumulate;
+    mix_peak=Avx2Peak;
+    mix_peak_interleaved=Avx2PeakInterleaved;
+    mix_maximum=Avx2Maximum;
+    break;
+#endif  // RDMIXKERNEL_X86
+
+  default:
+    return false;
+  }
+  mix_isa=isa;
+
+  return true;
+}
+
+
+bool RDMixKernel::isaSupported(Isa isa)
+{
+  switch(isa) {
+  case RDMixKernel::Scalar:
+    return true;
+
+#ifdef RDMIXKERNEL_X86
+  case RDMixKernel::Sse2:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+
+  case RDMixKernel::Avx2:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif  // RDMIXKERNEL_X86
+
+  default:
+    break;
+  }
+  return false;
+}
+
+
+const char *RDMixKernel::isaText(Isa isa)
+{
+  switch(isa) {
+  case RDMixKernel::Scalar:
+    return "scalar";
+
+  case RDMixKernel::Sse2:
+    return "SSE2";
+
+  case RDMixKernel::Avx2:
+    return "AVX2";
+  }
+  return "unknown";
+}
+
+
+void RDMixKernel::gainCopy(float *out,const float *in,float gain,
+			   unsigned frames)
+{
+  mix_gain_copy(out,in,gain,frames);
+}
+
+
+void RDMixKernel::gainSum(float *out,const float *in1,const float *in2,
+			  float gain,unsigned frames)
+{
+  mix_gain_sum(out,in1,in2,gain,frames);
+}
+
+
+void RDMixKernel::gainAccumulate(float *out,const float *in,float gain,
+				 unsigned frames)
+{
+  mix_gain_accumulate(out,in,gain,frames);
+}
+
+
+void RDMixKernel::mix(float *out,const float *const *ins,const float *gains,
+		      unsigned inputs,unsigned frames)
+{
+  //
+  // Sum up to RD_MIX_KERNEL_MAX_INPUTS inputs in each pass over 'out'
+  //
+  for(unsigned i=0;i<inputs;i+=RD_MIX_KERNEL_MAX_INPUTS) {
+    unsigned n=inputs-i;
+    if(n>RD_MIX_KERNEL_MAX_INPUTS) {
+      n=RD_MIX_KERNEL_MAX_INPUTS;
+    }
+    mix_mix(out,ins+i,gains+i,n,frames);
+  }
+}
+
+
+void RDMixKernel::interleave(float *out,const float *left,const float *right,
+			     float left_gain,float right_gain,unsigned frames)
+{
+  mix_interleave(out,left,right,left_gain,right_gain,frames);
+}
+
+
+void RDMixKernel::deinterleaveAccumulate(float *left,float *right,
+					 const float *in,float gain,
+					 unsigned frames)
+{
+  mix_deinterleave_accumulate(left,right,in,gain,frames);
+}
+
+
+float RDMixKernel::peak(const float *in,unsigned frames)
+{
+  return mix_peak(in,frames);
+}
+
+
+void RDMixKernel::peakInterleaved(float *left_peak,float *right_peak,
+				  const float *in,unsigned frames)
+{
+  mix_peak_interleaved(left_peak,right_peak,in,frames);
+}
+
+
+float RDMixKernel::maximum(const float *in,unsigned frames)
+{
+  return mix_maximum(in,frames);
+}
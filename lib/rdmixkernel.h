@@ -0,0 +1,55 @@
+// rdmixkernel.h
+//
+// Vectorized float kernels for realtime audio mixing
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDMIXKERNEL_H
+#define RDMIXKERNEL_H
+
+//
+// Maximum number of inputs summed by a single call to mix()
+//
+#define RD_MIX_KERNEL_MAX_INPUTS 32
+
+class RDMixKernel
+{
+ public:
+  enum Isa {Scalar=0,Sse2=1,Avx2=2};
+  static Isa isa();
+  static bool setIsa(Isa isa);
+  static bool isaSupported(Isa isa);
+  static const char *isaText(Isa isa);
+  static void gainCopy(float *out,const float *in,float gain,unsigned frames);
+  static void gainSum(float *out,const float *in1,const float *in2,
+		      float gain,unsigned frames);
+  static void gainAccumulate(float *out,const float *in,float gain,
+			     unsigned frames);
+  static void mix(float *out,const float *const *ins,const float *gains,
+		  unsigned inputs,unsigned frames);
+  static void interleave(float *out,const float *left,const float *right,
+			 float left_gain,float right_gain,unsigned frames);
+  static void deinterleaveAccumulate(float *left,float *right,const float *in,
+				     float gain,unsigned frames);
+  static float peak(const float *in,unsigned frames);
+  static void peakInterleaved(float *left_peak,float *right_peak,
+			      const float *in,unsigned frames);
+  static float maximum(const float *in,unsigned frames);
+};
+
+
+#endif  // RDMIXKERNEL_H
@@ -2,7 +2,7 @@
 //
 // A container class for a Rivendell Notification message.
 //
-//   (C) Copyright 2018-2020 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2018-2020,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -26,7 +26,9 @@ RDNotification::RDNotification(Type type,Action action,const QVariant &id)
 {
   notify_type=type;
   notify_action=action;
-  notify_id=id;
+  if(id.isValid()) {
+    notify_ids.push_back(id);
+  }
 }
 
 
@@ -61,15 +63,48 @@ void RDNotification::setAction(RDNotification::Action action)
 }
 
 
-QVariant RDNotification::id() const
+QVariant RDNotification::id(int n) const
 {
-  return notify_id;
+  if((n<0)||(n>=notify_ids.size())) {
+    return QVariant();
+  }
+  return notify_ids.at(n);
 }
 
 
 void RDNotification::setId(const QVariant id)
 {
-  notify_id=id;
+  notify_ids.clear();
+  notify_ids.push_back(id);
+}
+
+
+int RDNotification::idQuantity() const
+{
+  return notify_ids.size();
+}
+
+
+void RDNotification::addId(const QVariant &id)
+{
+  notify_ids.push_back(id);
+}
+
+
+void RDNotification::clearIds()
+{
+  notify_ids.clear();
+}
+
+
+int RDNotification::frameSize() const
+{
+  int ret=7;
+
+  for(int i=0;i<notify_ids.size();i++) {
+    ret+=RDNotification::idSize(notify_type,notify_ids.at(i));
+  }
+  return ret;
 }
 
 
@@ -83,8 +118,11 @@ bool RDNotification::read(const QString &str)
 {
   notify_type=RDNotification::NullType;
   notify_action=RDNotification::NoAction;
-  notify_id=QVariant();
+  notify_ids.clear();
 
+  if(str.startsWith("NOTIFYB ")) {
+    return readFrame(QByteArray::fromBase64(str.mid(8).toAscii()));
+  }
   QStringList args=str.split(" ");
   if(args.size()==4) {
     if(args[0]!="NOTIFY") {
@@ -96,31 +134,31 @@ bool RDNotification::read(const QString &str)
 	notify_type=type;
 	switch(type) {
 	case RDNotification::CartType:
-	  notify_id=QVariant(args[3].toUInt());
+	  notify_ids.push_back(QVariant(args[3].toUInt()));
 	  break;
 
 	case RDNotification::LogType:
-	  notify_id=QVariant(args[3]);
+	  notify_ids.push_back(QVariant(args[3]));
 	  break;
 
 	case RDNotification::PypadType:
-	  notify_id=QVariant(args[3].toUInt());
+	  notify_ids.push_back(QVariant(args[3].toUInt()));
 	  break;
 
 	case RDNotification::DropboxType:
-	  notify_id=QVariant(args[3]);
+	  notify_ids.push_back(QVariant(args[3]));
 	  break;
 
 	case RDNotification::CatchEventType:
-	  notify_id=QVariant(args[3].toUInt());
+	  notify_ids.push_back(QVariant(args[3].toUInt()));
 	  break;
 
 	case RDNotification::FeedItemType:
-	  notify_id=QVariant(args[3].toUInt());
+	  notify_ids.push_back(QVariant(args[3].toUInt()));
 	  break;
 
 	case RDNotification::FeedType:
-	  notify_id=QVariant(args[3]);
+	  notify_ids.push_back(QVariant(args[3]));
 	  break;
 
 	case RDNotification::NullType:
@@ -155,31 +193,31 @@ QString RDNotification::write() const
   ret+=RDNotification::actionString(notify_action)+" ";
   switch(notify_type) {
   case RDNotification::CartType: 
-    ret+=QString().sprintf("%u",notify_id.toUInt());
+    ret+=QString().sprintf("%u",id().toUInt());
     break;
 
   case RDNotification::LogType: 
-    ret+=notify_id.toString();
+    ret+=id().toString();
     break;
 
   case RDNotification::PypadType: 
-    ret+=QString().sprintf("%u",notify_id.toUInt());
+    ret+=QString().sprintf("%u",id().toUInt());
     break;
 
   case RDNotification::DropboxType: 
-    ret+=notify_id.toString();
+    ret+=id().toString();
     break;
 
   case RDNotification::CatchEventType: 
-    ret+=QString().sprintf("%u",notify_id.toUInt());
+    ret+=QString().sprintf("%u",id().toUInt());
     break;
 
   case RDNotification::FeedItemType: 
-    ret+=QString().sprintf("%u",notify_id.toUInt());
+    ret+=QString().sprintf("%u",id().toUInt());
     break;
 
   case RDNotification::FeedType: 
-    ret+=notify_id.toString();
+    ret+=id().toString();
     break;
 
   case RDNotification::NullType:
@@ -190,6 +228,166 @@ QString RDNotification::write() const
 }
 
 
+QString RDNotification::writeBinary() const
+{
+  return QString("NOTIFYB ")+QString(frame().toBase64());
+}
+
+
+bool RDNotification::readFrame(const QByteArray &data)
+{
+  const unsigned char *d=(const unsigned char *)data.constData();
+  int len=data.size();
+  int offset=7;
+  int quan=0;
+  int size=0;
+
+  notify_type=RDNotification::NullType;
+  notify_action=RDNotification::NoAction;
+  notify_ids.clear();
+
+  //
+  // Header
+  //
+  if((len<7)||(d[0]!='R')||(d[1]!='N')||
+     (d[2]!=RD_NOTIFICATION_BINARY_VERSION)) {
+    return false;
+  }
+  if((d[3]==RDNotification::NullType)||(d[3]>=RDNotification::LastType)||
+     (d[4]==RDNotification::NoAction)||(d[4]>=RDNotification::LastAction)) {
+    return false;
+  }
+  quan=(d[5]<<8)|d[6];
+
+  //
+  // IDs
+  //
+  for(int i=0;i<quan;i++) {
+    if(RDNotification::isNumeric((RDNotification::Type)d[3])) {
+      if((offset+4)>len) {
+	notify_ids.clear();
+	return false;
+      }
+      notify_ids.push_back(QVariant(((unsigned)d[offset]<<24)|
+				    ((unsigned)d[offset+1]<<16)|
+				    ((unsigned)d[offset+2]<<8)|
+				    (unsigned)d[offset+3]));
+      offset+=4;
+    }
+    else {
+      if((offset+2)>len) {
+	notify_ids.clear();
+	return false;
+      }
+      size=(d[offset]<<8)|d[offset+1];
+      offset+=2;
+      if((offset+size)>len) {
+	notify_ids.clear();
+	return false;
+      }
+      notify_ids.
+	push_back(QVariant(QString::fromUtf8((const char *)d+offset,size)));
+      offset+=size;
+    }
+  }
+  notify_type=(RDNotification::Type)d[3];
+  notify_action=(RDNotification::Action)d[4];
+
+  return true;
+}
+
+
+QByteArray RDNotification::frame() const
+{
+  //
+  // Version 2 Frame Format
+  //
+  //   Offset  Size  Value
+  //        0     2  "RN"
+  //        2     1  Version (RD_NOTIFICATION_BINARY_VERSION)
+  //        3     1  RDNotification::Type
+  //        4     1  RDNotification::Action
+  //        5     2  Number of IDs (big endian)
+  //        7     -  IDs, each either a big endian 32 bit unsigned integer
+  //                 (numeric types) or a big endian 16 bit length followed
+  //                 by that many bytes of UTF-8 (string types)
+  //
+  QByteArray ret;
+  QByteArray str;
+  unsigned id=0;
+
+  ret.reserve(frameSize());
+  ret.append('R');
+  ret.append('N');
+  ret.append((char)RD_NOTIFICATION_BINARY_VERSION);
+  ret.append((char)notify_type);
+  ret.append((char)notify_action);
+  ret.append((char)(0xFF&(notify_ids.size()>>8)));
+  ret.append((char)(0xFF&notify_ids.size()));
+  for(int i=0;i<notify_ids.size();i++) {
+    if(RDNotification::isNumeric(notify_type)) {
+      id=notify_ids.at(i).toUInt();
+      ret.append((char)(0xFF&(id>>24)));
+      ret.append((char)(0xFF&(id>>16)));
+      ret.append((char)(0xFF&(id>>8)));
+      ret.append((char)(0xFF&id));
+    }
+    else {
+      str=notify_ids.at(i).toString().toUtf8();
+      ret.append((char)(0xFF&(str.size()>>8)));
+      ret.append((char)(0xFF&str.size()));
+      ret.append(str);
+    }
+  }
+
+  return ret;
+}
+
+
+QList<RDNotification> RDNotification::split() const
+{
+  QList<RDNotification> ret;
+
+  for(int i=0;i<notify_ids.size();i++) {
+    ret.push_back(RDNotification(notify_type,notify_action,notify_ids.at(i)));
+  }
+
+  return ret;
+}
+
+
+bool RDNotification::isNumeric(RDNotification::Type type)
+{
+  bool ret=false;
+
+  switch(type) {
+  case RDNotification::CartType:
+  case RDNotification::PypadType:
+  case RDNotification::CatchEventType:
+  case RDNotification::FeedItemType:
+    ret=true;
+    break;
+
+  case RDNotification::LogType:
+  case RDNotification::DropboxType:
+  case RDNotification::FeedType:
+  case RDNotification::NullType:
+  case RDNotification::LastType:
+    break;
+  }
+  return ret;
+}
+
+
+int RDNotification::idSize(RDNotification::Type type,const QVariant &id)
+{
+  if(RDNotification::isNumeric(type)) {
+    return 4;
+  }
+  return 2+id.toString().toUtf8().size();
+}
+
+
 QString RDNotification::typeString(RDNotification::Type type)
 {
   QString ret="UNKNOWN";
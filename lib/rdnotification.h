@@ -2,7 +2,7 @@
 //
 // A container class for a Rivendell Notification message.
 //
-//   (C) Copyright 2018-2020 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2018-2020,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -21,9 +21,22 @@
 #ifndef RDNOTIFICATION_H
 #define RDNOTIFICATION_H
 
+#include <qbytearray.h>
+#include <qlist.h>
 #include <qstring.h>
 #include <qvariant.h>
 
+//
+// Version of the binary notification encoding
+//
+#define RD_NOTIFICATION_BINARY_VERSION 2
+
+//
+// Largest binary notification frame (bytes), chosen so that the armored
+// form still fits in a single notification datagram
+//
+#define RD_NOTIFICATION_MAX_FRAME_SIZE 1024
+
 class RDNotification
 {
  public:
@@ -37,18 +50,28 @@ class RDNotification
   void setType(Type type);
   Action action() const;
   void setAction(Action action);
-  QVariant id() const;
+  QVariant id(int n=0) const;
   void setId(const QVariant id);
+  int idQuantity() const;
+  void addId(const QVariant &id);
+  void clearIds();
+  int frameSize() const;
   bool isValid() const;
   bool read(const QString &str);
   QString write() const;
+  QString writeBinary() const;
+  bool readFrame(const QByteArray &data);
+  QByteArray frame() const;
+  QList<RDNotification> split() const;
+  static bool isNumeric(Type type);
+  static int idSize(Type type,const QVariant &id);
   static QString typeString(Type type);
   static QString actionString(Action action);
 
  private:
   Type notify_type;
   Action notify_action;
-  QVariant notify_id;
+  QList<QVariant> notify_ids;
 };
 
 
@@ -0,0 +1,151 @@
+// rdnotificationcoalescer.cpp
+//
+// Merge Rivendell notifications into batches over a time window
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include "rdnotificationcoalescer.h"
+
+RDNotificationCoalescer::RDNotificationCoalescer(int msecs,QObject *parent)
+  : QObject(parent)
+{
+  coal_interval=msecs;
+  coal_pending=0;
+
+  coal_timer=new QTimer(this);
+  connect(coal_timer,SIGNAL(timeout()),this,SLOT(timeoutData()));
+}
+
+
+RDNotificationCoalescer::~RDNotificationCoalescer()
+{
+  for(int i=0;i<coal_batches.size();i++) {
+    delete coal_batches.at(i);
+  }
+}
+
+
+int RDNotificationCoalescer::interval() const
+{
+  return coal_interval;
+}
+
+
+void RDNotificationCoalescer::setInterval(int msecs)
+{
+  coal_interval=msecs;
+  if(coal_interval<=0) {
+    coal_timer->stop();
+    flush();
+  }
+}
+
+
+unsigned RDNotificationCoalescer::pending() const
+{
+  return coal_pending;
+}
+
+
+void RDNotificationCoalescer::append(const RDNotification &notify)
+{
+  for(int i=0;i<notify.idQuantity();i++) {
+    Queue(notify.type(),notify.action(),notify.id(i));
+  }
+
+  //
+  // The first notification after a quiet period goes out at once; any
+  // that follow within the window are held until it closes.
+  //
+  if((coal_interval<=0)||(!coal_timer->isActive())) {
+    flush();
+    if(coal_interval>0) {
+      coal_timer->start(coal_interval);
+    }
+  }
+}
+
+
+void RDNotificationCoalescer::flush()
+{
+  //
+  // Batches are removed before emitting, as a receiver may append
+  // further notifications from its slot.
+  //
+  QList<RDNotification *> batches=coal_batches;
+
+  coal_batches.clear();
+  coal_sizes.clear();
+  coal_actions.clear();
+  coal_pending=0;
+  for(int i=0;i<batches.size();i++) {
+    emit ready(batches.at(i));
+    delete batches.at(i);
+  }
+}
+
+
+void RDNotificationCoalescer::timeoutData()
+{
+  if(coal_batches.size()==0) {
+    coal_timer->stop();
+    return;
+  }
+  flush();
+}
+
+
+void RDNotificationCoalescer::Queue(RDNotification::Type type,
+				    RDNotification::Action action,
+				    const QVariant &id)
+{
+  QString key=QString().sprintf("%d:",type)+id.toString();
+  int size=RDNotification::idSize(type,id);
+  int batch=-1;
+
+  //
+  // Repeats of a pending change are dropped. A different action for
+  // an ID already pending releases everything queued so far, so that
+  // changes to any one object are always delivered in order.
+  //
+  QMap<QString,int>::const_iterator it=coal_actions.find(key);
+  if(it!=coal_actions.end()) {
+    if(it.value()==action) {
+      return;
+    }
+    flush();
+  }
+
+  for(int i=coal_batches.size()-1;i>=0;i--) {
+    if((coal_batches.at(i)->type()==type)&&
+       (coal_batches.at(i)->action()==action)) {
+      if((coal_sizes.at(i)+size)<=RD_NOTIFICATION_MAX_FRAME_SIZE) {
+	batch=i;
+      }
+      break;
+    }
+  }
+  if(batch<0) {
+    coal_batches.push_back(new RDNotification(type,action,QVariant()));
+    coal_sizes.push_back(coal_batches.back()->frameSize());
+    batch=coal_batches.size()-1;
+  }
+  coal_batches.at(batch)->addId(id);
+  coal_sizes[batch]+=size;
+  coal_actions[key]=action;
+  coal_pending++;
+}
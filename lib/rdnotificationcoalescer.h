@@ -0,0 +1,63 @@
+// rdnotificationcoalescer.h
+//
+// Merge Rivendell notifications into batches over a time window
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDNOTIFICATIONCOALESCER_H
+#define RDNOTIFICATIONCOALESCER_H
+
+#include <qlist.h>
+#include <qmap.h>
+#include <qobject.h>
+#include <qtimer.h>
+
+#include <rdnotification.h>
+
+class RDNotificationCoalescer : public QObject
+{
+  Q_OBJECT;
+ public:
+  RDNotificationCoalescer(int msecs,QObject *parent=0);
+  ~RDNotificationCoalescer();
+  int interval() const;
+  void setInterval(int msecs);
+  unsigned pending() const;
+  void append(const RDNotification &notify);
+
+ signals:
+  void ready(RDNotification *notify);
+
+ public slots:
+  void flush();
+
+ private slots:
+  void timeoutData();
+
+ private:
+  void Queue(RDNotification::Type type,RDNotification::Action action,
+	     const QVariant &id);
+  QList<RDNotification *> coal_batches;
+  QList<int> coal_sizes;
+  QMap<QString,int> coal_actions;
+  QTimer *coal_timer;
+  int coal_interval;
+  unsigned coal_pending;
+};
+
+
+#endif  // RDNOTIFICATIONCOALESCER_H
@@ -0,0 +1,286 @@
+// rdpanelmodel.cpp
+//
+// In-memory copy of the sound panel buttons belonging to one owner
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include "rddb.h"
+#include "rdescape_string.h"
+#include "rdpanelmodel.h"
+
+RDPanelModel::RDPanelModel(const QString &tablename,
+			   RDAirPlayConf::PanelType type,const QString &owner)
+{
+  model_tablename=tablename;
+  model_type=type;
+  model_owner=owner;
+}
+
+
+QString RDPanelModel::tableName() const
+{
+  return model_tablename;
+}
+
+
+RDAirPlayConf::PanelType RDPanelModel::type() const
+{
+  return model_type;
+}
+
+
+QString RDPanelModel::owner() const
+{
+  return model_owner;
+}
+
+
+void RDPanelModel::load(int panel)
+{
+  //
+  // Forget what the database held, keeping changes not yet saved
+  //
+  std::map<int,RDPanelModel::Button>::iterator it=model_buttons.begin();
+  while(it!=model_buttons.end()) {
+    if(((panel<0)||(Panel(it->first)==panel))&&
+       (model_pending.count(it->first)==0)) {
+      model_buttons.erase(it++);
+    }
+    else {
+      ++it;
+    }
+  }
+
+  //
+  // Buttons and the cart data they display, in a single pass
+  //
+  QString sql=QString("select ")+
+    model_tablename+".PANEL_NO,"+      // 00
+    model_tablename+".ROW_NO,"+        // 01
+    model_tablename+".COLUMN_NO,"+     // 02
+    model_tablename+".LABEL,"+         // 03
+    model_tablename+".CART,"+          // 04
+    model_tablename+".DEFAULT_COLOR,"+ // 05
+    "CART.FORCED_LENGTH,"+             // 06
+    "CART.AVERAGE_HOOK_LENGTH,"+       // 07
+    "CART.TYPE "+                      // 08
+    "from "+model_tablename+" left join CART "+
+    "on "+model_tablename+".CART=CART.NUMBER where "+
+    model_tablename+QString().sprintf(".TYPE=%d && ",model_type)+
+    model_tablename+".OWNER=\""+RDEscapeString(model_owner)+"\"";
+  if(panel>=0) {
+    sql+=" && "+model_tablename+QString().sprintf(".PANEL_NO=%d",panel);
+  }
+  RDSqlQuery *q=new RDSqlQuery(sql);
+  while(q->next()) {
+    int key=Key(q->value(0).toInt(),q->value(1).toInt(),q->value(2).toInt());
+    if(model_pending.count(key)==0) {
+      RDPanelModel::Button &button=model_buttons[key];
+      button.label=q->value(3).toString();
+      button.cart=q->value(4).toUInt();
+      button.color=q->value(5).toString();
+      button.forced_length=q->value(6).toInt();
+      button.hook_length=q->value(7).toInt();
+      button.cart_type=(RDCart::Type)q->value(8).toInt();
+    }
+  }
+  delete q;
+}
+
+
+bool RDPanelModel::exists(int panel,int row,int col) const
+{
+  return model_buttons.count(Key(panel,row,col))>0;
+}
+
+
+QString RDPanelModel::label(int panel,int row,int col) const
+{
+  std::map<int,RDPanelModel::Button>::const_iterator it=
+    model_buttons.find(Key(panel,row,col));
+  if(it==model_buttons.end()) {
+    return QString();
+  }
+  return it->second.label;
+}
+
+
+unsigned RDPanelModel::cart(int panel,int row,int col) const
+{
+  std::map<int,RDPanelModel::Button>::const_iterator it=
+    model_buttons.find(Key(panel,row,col));
+  if(it==model_buttons.end()) {
+    return 0;
+  }
+  return it->second.cart;
+}
+
+
+QString RDPanelModel::defaultColor(int panel,int row,int col) const
+{
+  std::map<int,RDPanelModel::Button>::const_iterator it=
+    model_buttons.find(Key(panel,row,col));
+  if(it==model_buttons.end()) {
+    return QString();
+  }
+  return it->second.color;
+}
+
+
+int RDPanelModel::forcedLength(int panel,int row,int col) const
+{
+  std::map<int,RDPanelModel::Button>::const_iterator it=
+    model_buttons.find(Key(panel,row,col));
+  if(it==model_buttons.end()) {
+    return 0;
+  }
+  return it->second.forced_length;
+}
+
+
+int RDPanelModel::averageHookLength(int panel,int row,int col) const
+{
+  std::map<int,RDPanelModel::Button>::const_iterator it=
+    model_buttons.find(Key(panel,row,col));
+  if(it==model_buttons.end()) {
+    return 0;
+  }
+  return it->second.hook_length;
+}
+
+
+RDCart::Type RDPanelModel::cartType(int panel,int row,int col) const
+{
+  std::map<int,RDPanelModel::Button>::const_iterator it=
+    model_buttons.find(Key(panel,row,col));
+  if(it==model_buttons.end()) {
+    return RDCart::All;
+  }
+  return it->second.cart_type;
+}
+
+
+void RDPanelModel::setButton(int panel,int row,int col,const QString &label,
+			     unsigned cartnum,const QString &color)
+{
+  int key=Key(panel,row,col);
+  RDPanelModel::Button &button=model_buttons[key];
+
+  if(button.cart!=cartnum) {
+    button.forced_length=0;
+    button.hook_length=0;
+    button.cart_type=RDCart::All;
+  }
+  button.label=label;
+  button.cart=cartnum;
+  button.color=color;
+  model_pending.insert(key);
+}
+
+
+bool RDPanelModel::isPending(int panel,int row,int col) const
+{
+  return model_pending.count(Key(panel,row,col))>0;
+}
+
+
+int RDPanelModel::pending() const
+{
+  return model_pending.size();
+}
+
+
+bool RDPanelModel::save(QString *err_msg)
+{
+  QString where;
+  QString values;
+  unsigned count=0;
+  unsigned n=0;
+
+  if(model_pending.size()==0) {
+    return true;
+  }
+
+  //
+  // Replace the rows for the changed buttons, which also removes any
+  // duplicates left by older versions
+  //
+  if(!RDSqlQuery::apply("start transaction",err_msg)) {
+    return false;
+  }
+  for(std::set<int>::const_iterator it=model_pending.begin();
+      it!=model_pending.end();it++) {
+    const RDPanelModel::Button &button=model_buttons[*it];
+    int panel=Panel(*it);
+    int row=(*it/100)%100;
+    int col=*it%100;
+    where+=QString().sprintf("(PANEL_NO=%d && ROW_NO=%d && COLUMN_NO=%d)||",
+			     panel,row,col);
+    values+=QString().sprintf("(%d,",model_type)+
+      "\""+RDEscapeString(model_owner)+"\","+
+      QString().sprintf("%d,%d,%d,",panel,row,col)+
+      "\""+RDEscapeString(button.label)+"\","+
+      QString().sprintf("%u,",button.cart)+
+      "\""+RDEscapeString(button.color)+"\"),";
+    n++;
+    if((++count==RD_PANEL_MODEL_SAVE_ROWS)||(n==model_pending.size())) {
+      QString sql=QString("delete from ")+model_tablename+" where "+
+	QString().sprintf("TYPE=%d && ",model_type)+
+	"OWNER=\""+RDEscapeString(model_owner)+"\" && "+
+	"("+where.left(where.length()-2)+")";
+      if(!RDSqlQuery::apply(sql,err_msg)) {
+	RDSqlQuery::apply("rollback");
+	return false;
+      }
+      sql=QString("insert into ")+model_tablename+" ("+
+	"TYPE,"+
+	"OWNER,"+
+	"PANEL_NO,"+
+	"ROW_NO,"+
+	"COLUMN_NO,"+
+	"LABEL,"+
+	"CART,"+
+	"DEFAULT_COLOR) values "+
+	values.left(values.length()-1);
+      if(!RDSqlQuery::apply(sql,err_msg)) {
+	RDSqlQuery::apply("rollback");
+	return false;
+      }
+      where="";
+      values="";
+      count=0;
+    }
+  }
+  if(!RDSqlQuery::apply("commit",err_msg)) {
+    return false;
+  }
+  model_pending.clear();
+
+  return true;
+}
+
+
+int RDPanelModel::Key(int panel,int row,int col)
+{
+  return 10000*panel+100*row+col;
+}
+
+
+int RDPanelModel::Panel(int key)
+{
+  return key/10000;
+}
@@ -0,0 +1,80 @@
+// rdpanelmodel.h
+//
+// In-memory copy of the sound panel buttons belonging to one owner
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDPANELMODEL_H
+#define RDPANELMODEL_H
+
+#include <map>
+#include <set>
+
+#include <qstring.h>
+
+#include <rdairplay_conf.h>
+#include <rdcart.h>
+
+//
+// Maximum number of buttons written by a single multi-row insert
+//
+#define RD_PANEL_MODEL_SAVE_ROWS 500
+
+class RDPanelModel
+{
+ public:
+  RDPanelModel(const QString &tablename,RDAirPlayConf::PanelType type,
+	       const QString &owner);
+  QString tableName() const;
+  RDAirPlayConf::PanelType type() const;
+  QString owner() const;
+  void load(int panel=-1);
+  bool exists(int panel,int row,int col) const;
+  QString label(int panel,int row,int col) const;
+  unsigned cart(int panel,int row,int col) const;
+  QString defaultColor(int panel,int row,int col) const;
+  int forcedLength(int panel,int row,int col) const;
+  int averageHookLength(int panel,int row,int col) const;
+  RDCart::Type cartType(int panel,int row,int col) const;
+  void setButton(int panel,int row,int col,const QString &label,
+		 unsigned cartnum,const QString &color);
+  bool isPending(int panel,int row,int col) const;
+  int pending() const;
+  bool save(QString *err_msg=NULL);
+
+ private:
+  class Button
+  {
+   public:
+    QString label;
+    unsigned cart;
+    QString color;
+    int forced_length;
+    int hook_length;
+    RDCart::Type cart_type;
+  };
+  static int Key(int panel,int row,int col);
+  static int Panel(int key);
+  QString model_tablename;
+  RDAirPlayConf::PanelType model_type;
+  QString model_owner;
+  std::map<int,RDPanelModel::Button> model_buttons;
+  std::set<int> model_pending;
+};
+
+
+#endif  // RDPANELMODEL_H
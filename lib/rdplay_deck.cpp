@@ -2,7 +2,7 @@
 //
 // Abstract a Rivendell Playback Deck
 //
-//   (C) Copyright 2003-2004,2016 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2003-2004,2016,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -18,8 +18,6 @@
 //   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 //
 
-#include <qsignalmapper.h>
-
 #include <rdplay_deck.h>
 #include <rdmixer.h>
 
@@ -45,6 +43,8 @@ RDPlayDeck::RDPlayDeck(RDCae *cae,int id,QObject *parent)
   play_duck_up_point=0;
   play_duck_down_state=false;
   play_fade_down_state=false;
+  play_audio_position=0;
+  play_marker_delay=0;
 
   //
   // CAE Connection
@@ -52,6 +52,10 @@ RDPlayDeck::RDPlayDeck(RDCae *cae,int id,QObject *parent)
   play_cae=cae;
   connect(play_cae,SIGNAL(playing(int)),this,SLOT(playingData(int)));
   connect(play_cae,SIGNAL(playStopped(int)),this,SLOT(playStoppedData(int)));
+  connect(play_cae,SIGNAL(playMarker(int,int,unsigned,unsigned)),
+	  this,SLOT(playMarkerData(int,int,unsigned,unsigned)));
+  connect(play_cae,SIGNAL(playPositionChanged(int,unsigned)),
+	  this,SLOT(playPositionData(int,unsigned)));
   play_cart=NULL;
   play_cut=NULL;
   play_card=-1;
@@ -60,20 +64,13 @@ RDPlayDeck::RDPlayDeck(RDCae *cae,int id,QObject *parent)
   //
   // Timers
   //
-  QSignalMapper *mapper=new QSignalMapper(this,"timer_mapper");
-  connect(mapper,SIGNAL(mapped(int)),this,SLOT(pointTimerData(int)));
-  for(int i=0;i<3;i++) {
-    play_point_timer[i]=new QTimer(this,"point_timer");
-    connect(play_point_timer[i],SIGNAL(timeout()),mapper,SLOT(map()));
-    mapper->setMapping(play_point_timer[i],i);
-  }
+  // Segue, hook, talk, fade and stop points are tracked by caed(8) as
+  // play markers against the audio actually played, so only the position
+  // display and the duck fades are timed here.
+  //
   play_position_timer=new QTimer(this,"play_position_timer");
   connect(play_position_timer,SIGNAL(timeout()),
 	  this,SLOT(positionTimerData()));
-  play_fade_timer=new QTimer(this,"play_fade_timer");
-  connect(play_fade_timer,SIGNAL(timeout()),this,SLOT(fadeTimerData()));
-  play_stop_timer=new QTimer(this,"play_stop_timer");
-  connect(play_stop_timer,SIGNAL(timeout()),this,SLOT(stop()));
   play_duck_timer=new QTimer(this,"play_duck_timer");
   connect(play_duck_timer,SIGNAL(timeout()),this,SLOT(duckTimerData()));
 }
@@ -128,7 +125,7 @@ bool RDPlayDeck::setCart(RDLogLine *logline,bool rotate)
     play_cut=NULL;
   }
   if(play_cart==NULL) {
-    StopTimers();
+    StopMarkers();
     play_cart=new RDCart(logline->cartNumber());
     if(!play_cart->exists()) {
       delete play_cart;
@@ -330,8 +327,7 @@ int RDPlayDeck::currentPosition() const
 {
   switch(play_state) {
       case RDPlayDeck::Playing:
-	return play_start_position+
-	  play_start_time.msecsTo(QTime::currentTime());
+	return AudioPosition();
 
       case RDPlayDeck::Paused:
 	return play_current_position+POSITION_INTERVAL;
@@ -349,9 +345,15 @@ int RDPlayDeck::lastStartPosition() const
 }
 
 
+int RDPlayDeck::lastMarkerDelay() const
+{
+  return play_marker_delay;
+}
+
+
 void RDPlayDeck::clear()
 {
-  StopTimers();
+  StopMarkers();
   switch(play_state) {
       case RDPlayDeck::Playing:
       case RDPlayDeck::Stopping:
@@ -372,7 +374,7 @@ void RDPlayDeck::clear()
 
 void RDPlayDeck::reset()
 {
-  StopTimers();
+  StopMarkers();
   switch(play_state) {
       case RDPlayDeck::Playing:
       case RDPlayDeck::Stopping:
@@ -424,9 +426,13 @@ void RDPlayDeck::play(unsigned pos,int segue_start,int segue_end,
   play_start_position=pos;
   play_current_position=pos;
   play_last_start_position=play_start_position;
+  play_audio_time=QTime();
+  play_marker_delay=0;
   stop_called=false;
   pause_called=false;
+  play_cae->beginBatch();
   play_cae->positionPlay(play_handle,play_audio_point[0]+pos);
+  StartMarkers(pos);
   play_cae->setPlayPortActive(play_card,play_port,play_stream);
   for(int i=0;i<RD_MAX_PORTS;i++) {
     play_cae->setOutputVolume(play_card,play_stream,i,RD_MUTE_DEPTH);
@@ -478,8 +484,8 @@ void RDPlayDeck::play(unsigned pos,int segue_start,int segue_end,
 	 (int)(100000.0*(double)(play_audio_point[1]-play_audio_point[0]-pos)/
 	 (double)play_timescale_speed),
 	 play_timescale_speed,false);
+  play_cae->commitBatch();
   play_start_time=QTime::currentTime();
-  StartTimers(pos);
   play_state=RDPlayDeck::Playing;
 }
 
@@ -555,7 +561,8 @@ void RDPlayDeck::stop(int interval,int gain)
 			       play_point_gain+play_cut_gain+play_duck_level,interval);
       }
     }
-    play_stop_timer->start(interval,true);
+    play_cae->setPlayMarker(play_handle,RDPlayDeck::StopMarker,
+			    play_audio_point[0]+currentPosition()+interval);
     stop_called=true;
     play_state=RDPlayDeck::Stopping;
   }
@@ -604,7 +611,7 @@ void RDPlayDeck::playStoppedData(int handle)
   }
   play_position_timer->stop();
   play_start_time=QTime();
-  StopTimers();
+  StopMarkers();
   if(pause_called) {
     play_state=RDPlayDeck::Paused;
     emit stateChanged(play_id,RDPlayDeck::Paused);
@@ -627,58 +634,76 @@ void RDPlayDeck::playStoppedData(int handle)
 }
 
 
-void RDPlayDeck::pointTimerData(int point)
+void RDPlayDeck::playMarkerData(int handle,int marker,unsigned pos,
+				unsigned actual)
 {
-  switch(point) {
-      case RDPlayDeck::Segue:
-	if(play_point_state[point]) {
-	  play_point_state[point]=false;
-	  emit segueEnd(play_id);
-	}
-	else {
-	  play_point_state[point]=true;
-	  play_point_timer[point]->
-	    start(play_point_value[point][1]-play_point_value[point][0],true);
-	  emit segueStart(play_id);
-	}
+  if(handle!=play_handle) {
+    return;
+  }
+
+  //
+  // Each marker also tells us exactly where the audio is
+  //
+  play_audio_position=actual;
+  play_audio_time=QTime::currentTime();
+  play_marker_delay=actual-pos;
+  switch(marker) {
+      case RDPlayDeck::SegueStartMarker:
+	emit segueStart(play_id);
 	break;
 
-      case RDPlayDeck::Hook:
-	if(play_point_state[point]) {
-	  play_point_state[point]=false;
-	  emit hookEnd(play_id);
-	}
-	else {
-	  play_point_state[point]=true;
-	  play_point_timer[point]->
-	    start(play_point_value[point][1]-play_point_value[point][0],true);
-	  emit hookStart(play_id);
-	}
+      case RDPlayDeck::SegueEndMarker:
+	emit segueEnd(play_id);
 	break;
 
-      case RDPlayDeck::Talk:
-	if(play_point_state[point]) {
-	  play_point_state[point]=false;
-	  emit talkEnd(play_id);
-	}
-	else {
-	  play_point_state[point]=true;
-	  play_point_timer[point]->
-	    start(play_point_value[point][1]-play_point_value[point][0],true);
-	  emit talkStart(play_id);
+      case RDPlayDeck::HookStartMarker:
+	emit hookStart(play_id);
+	break;
+
+      case RDPlayDeck::HookEndMarker:
+	emit hookEnd(play_id);
+	break;
+
+      case RDPlayDeck::TalkStartMarker:
+	emit talkStart(play_id);
+	break;
+
+      case RDPlayDeck::TalkEndMarker:
+	emit talkEnd(play_id);
+	break;
+
+      case RDPlayDeck::FadeDownMarker:
+	FadeDown();
+	break;
+
+      case RDPlayDeck::DuckUpMarker:
+	if(!play_duck_down_state) {
+	  duckTimerData();
 	}
 	break;
+
+      case RDPlayDeck::StopMarker:
+	stop();
+	break;
   }
 }
 
 
-void RDPlayDeck::positionTimerData()
+void RDPlayDeck::playPositionData(int handle,unsigned pos)
 {
-  play_current_position=
-    play_start_position+play_start_time.msecsTo(QTime::currentTime());
-  if(play_current_position<0) {       // Handle crossing midnight!
-    play_current_position+=86400000;
+  if((handle!=play_handle)||
+     ((play_state!=RDPlayDeck::Playing)&&
+      (play_state!=RDPlayDeck::Stopping))) {
+    return;
   }
+  play_audio_position=pos;
+  play_audio_time=QTime::currentTime();
+}
+
+
+void RDPlayDeck::positionTimerData()
+{
+  play_current_position=AudioPosition();
   if(play_hook_mode) {
     emit position(play_id,play_current_position-(play_point_value[RDPlayDeck::Hook][0]-play_audio_point[0]));
   }
@@ -688,17 +713,6 @@ void RDPlayDeck::positionTimerData()
 }
 
 
-void RDPlayDeck::fadeTimerData()
-{
-  if(!play_duck_down_state) {
-  play_cae->
-    fadeOutputVolume(play_card,play_stream,play_port,play_fade_gain[1]+play_cut_gain+play_duck_level,
-		     play_fade_down);
-  }
-  play_fade_down_state=true;
-}
-
-
 void RDPlayDeck::duckTimerData()
 {
   if (!play_duck_down_state) { //duck up
@@ -725,54 +739,86 @@ void RDPlayDeck::duckTimerData()
 }
 
 
-void RDPlayDeck::StartTimers(int offset)
+void RDPlayDeck::StartMarkers(int offset)
 {
-  int audio_point;
+  int start=play_audio_point[0]+offset;
+  int point[2];
 
+  //
+  // Marker positions are in msecs from the start of the audio file,
+  // as sent with RDCae::positionPlay()
+  //
+  play_cae->clearPlayMarkers(play_handle);
   for(int i=0;i<RDPlayDeck::SizeOf;i++) {
-    play_point_state[i]=false;
     if(play_point_value[i][0]!=-1) {
-      audio_point=(int)
-	(RD_TIMESCALE_DIVISOR*(double)play_audio_point[0]/
-	 (double)play_timescale_speed);
-      if((play_point_value[i][0]-audio_point-offset)>=0) {
-	play_point_timer[i]->
-	  start(play_point_value[i][0]-audio_point-offset,true);
-      }
-      else {
-	if((play_point_value[i][1]-audio_point-offset)>=0) {
-	  play_point_state[i]=true;
-	  play_point_timer[i]->
-	    start(play_point_value[i][1]-audio_point-offset,true);
+      for(int j=0;j<2;j++) {
+	point[j]=play_point_value[i][j];
+	if(i==RDPlayDeck::Talk) {
+	  point[j]=(int)((double)point[j]*(double)play_timescale_speed/
+			 RD_TIMESCALE_DIVISOR);
 	}
       }
+      if(point[1]<point[0]) {
+	point[1]=point[0];
+      }
+      if(point[0]>=start) {
+	play_cae->setPlayMarker(play_handle,2*i,point[0]);
+      }
+      if(point[1]>=start) {
+	play_cae->setPlayMarker(play_handle,2*i+1,point[1]);
+      }
     }
   }
-  if((play_fade_point[1]!=-1)&&(offset<play_fade_point[1])&&
+  if((play_fade_point[1]!=-1)&&(start<play_fade_point[1])&&
      ((play_fade_down=play_audio_point[1]-play_fade_point[1])>0)) {
-    play_fade_timer->start(play_fade_point[1]-play_audio_point[0]-offset,true);
+    play_cae->setPlayMarker(play_handle,RDPlayDeck::FadeDownMarker,
+			    play_fade_point[1]);
   }
   if(offset<play_duck_up_point){
-    play_duck_timer->
-      start(play_duck_up_point-offset,true);
+    play_cae->setPlayMarker(play_handle,RDPlayDeck::DuckUpMarker,
+			    play_audio_point[0]+play_duck_up_point);
   }
 }
 
 
-void RDPlayDeck::StopTimers()
+void RDPlayDeck::StopMarkers()
 {
-  for(int i=0;i<RDPlayDeck::SizeOf;i++) {
-    if(play_point_timer[i]->isActive()) {
-      play_point_timer[i]->stop();
-    }
-  }
-  if(play_fade_timer->isActive()) {
-    play_fade_timer->stop();
-  }
-  if(play_stop_timer->isActive()) {
-    play_stop_timer->stop();
+  if(play_handle>=0) {
+    play_cae->clearPlayMarkers(play_handle);
   }
   if(play_duck_timer->isActive()) {
     play_duck_timer->stop();
   }
 }
+
+
+void RDPlayDeck::FadeDown()
+{
+  if(!play_duck_down_state) {
+  play_cae->
+    fadeOutputVolume(play_card,play_stream,play_port,play_fade_gain[1]+play_cut_gain+play_duck_level,
+		     play_fade_down);
+  }
+  play_fade_down_state=true;
+}
+
+
+int RDPlayDeck::AudioPosition() const
+{
+  QTime base=play_start_time;
+  int ret=play_start_position;
+  int elapsed;
+
+  //
+  // The last position reported by caed(8), advanced by the time since.
+  // Until the first report arrives, the time since play() was called.
+  //
+  if(!play_audio_time.isNull()) {
+    base=play_audio_time;
+    ret=play_audio_position-play_audio_point[0];
+  }
+  if((elapsed=base.msecsTo(QTime::currentTime()))<0) {
+    elapsed+=86400000;    // Handle crossing midnight!
+  }
+  return ret+elapsed;
+}
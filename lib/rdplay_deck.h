@@ -2,7 +2,7 @@
 //
 // Abstract a Rivendell Playback Deck
 //
-//   (C) Copyright 2003,2016 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2003,2016,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -63,6 +63,7 @@ class RDPlayDeck : public QObject
   QTime startTime() const;
   int currentPosition() const;
   int lastStartPosition() const;
+  int lastMarkerDelay() const;
   void clear();
   void reset();
 
@@ -89,27 +90,28 @@ class RDPlayDeck : public QObject
  private slots:
   void playingData(int handle);
   void playStoppedData(int handle); 
-  void pointTimerData(int);
+  void playMarkerData(int handle,int marker,unsigned pos,unsigned actual);
+  void playPositionData(int handle,unsigned pos);
   void positionTimerData();
-  void fadeTimerData();
   void duckTimerData();
 
  private:
   enum Point {Segue=0,Hook=1,Talk=2,SizeOf=3};
-  void StartTimers(int offset);
-  void StopTimers();
+  enum Marker {SegueStartMarker=0,SegueEndMarker=1,HookStartMarker=2,
+	       HookEndMarker=3,TalkStartMarker=4,TalkEndMarker=5,
+	       FadeDownMarker=6,DuckUpMarker=7,StopMarker=8};
+  void StartMarkers(int offset);
+  void StopMarkers();
+  void FadeDown();
+  int AudioPosition() const;
   QTimer *play_position_timer;
   RDCart *play_cart;
   RDCut *play_cut;
   RDCae *play_cae;
-  QTimer *play_point_timer[3];
-  QTimer *play_stop_timer;
-  QTimer *play_fade_timer;
   QTimer *play_duck_timer;
   bool play_duck_down_state;
   bool play_fade_down_state;
   int play_segue_interval;
-  bool play_point_state[3];
   int play_point_value[3][2];
   int play_point_gain;
   int play_audio_point[2];
@@ -140,6 +142,9 @@ class RDPlayDeck : public QObject
   unsigned play_start_position;
   int play_last_start_position;
   int play_current_position;
+  int play_audio_position;
+  QTime play_audio_time;
+  int play_marker_delay;
   bool play_timescale_active;
   int play_timescale_speed;
 };
@@ -0,0 +1,531 @@
+// rdpurgeengine.cpp
+//
+// Purge expired cuts and ELR data in bounded batches
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <errno.h>
+#include <pthread.h>
+#include <syslog.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <qdatetime.h>
+#include <qsqlerror.h>
+#include <qstringlist.h>
+
+#include "rdapplication.h"
+#include "rdcart.h"
+#include "rdcut.h"
+#include "rddb.h"
+#include "rdescape_string.h"
+#include "rdnotification.h"
+#include "rdpurgeengine.h"
+
+//
+// An expired cut
+//
+class RDPurgeCut
+{
+ public:
+  QString cut_name;
+  QString filename;
+  unsigned cart_number;
+  bool delete_empty;
+  bool audio_removed;
+};
+
+
+//
+// Shared state for the threads unlinking audio
+//
+class RDPurgeQueue
+{
+ public:
+  std::vector<RDPurgeCut> *cuts;
+  unsigned next;
+  unsigned last;
+  pthread_mutex_t mutex;
+};
+
+
+void *__RDPurgeThreadCallback(void *priv)
+{
+  RDPurgeQueue *queue=(RDPurgeQueue *)priv;
+  RDPurgeCut *cut=NULL;
+  unsigned n;
+
+  while(1) {
+    pthread_mutex_lock(&queue->mutex);
+    n=queue->next++;
+    pthread_mutex_unlock(&queue->mutex);
+    if(n>=queue->last) {
+      return NULL;
+    }
+    cut=&queue->cuts->at(n);
+    cut->audio_removed=
+      (unlink(cut->filename.toUtf8())==0)||(errno==ENOENT);
+    if(cut->audio_removed) {
+      unlink((cut->filename+".energy").toUtf8());
+    }
+  }
+  return NULL;
+}
+
+
+RDPurgeEngine::RDPurgeEngine(RDStation *station,RDUser *user,
+			     RDConfig *config,RDRipc *ripc)
+{
+  purge_station=station;
+  purge_user=user;
+  purge_config=config;
+  purge_ripc=ripc;
+  purge_cut_batch_size=RD_PURGE_ENGINE_CUT_BATCH;
+  purge_elr_batch_size=RD_PURGE_ENGINE_ELR_BATCH;
+  purge_threads=RD_PURGE_ENGINE_MAX_THREADS;
+  purge_delete_audio=true;
+  purge_local_audio=false;
+  clearStatistics();
+}
+
+
+unsigned RDPurgeEngine::cutBatchSize() const
+{
+  return purge_cut_batch_size;
+}
+
+
+void RDPurgeEngine::setCutBatchSize(unsigned cuts)
+{
+  if(cuts>0) {
+    purge_cut_batch_size=cuts;
+  }
+}
+
+
+unsigned RDPurgeEngine::elrBatchSize() const
+{
+  return purge_elr_batch_size;
+}
+
+
+void RDPurgeEngine::setElrBatchSize(unsigned rows)
+{
+  if(rows>0) {
+    purge_elr_batch_size=rows;
+  }
+}
+
+
+unsigned RDPurgeEngine::threads() const
+{
+  return purge_threads;
+}
+
+
+void RDPurgeEngine::setThreads(unsigned threads)
+{
+  purge_threads=threads;
+  if(purge_threads>RD_PURGE_ENGINE_MAX_THREADS) {
+    purge_threads=RD_PURGE_ENGINE_MAX_THREADS;
+  }
+}
+
+
+bool RDPurgeEngine::deleteAudio() const
+{
+  return purge_delete_audio;
+}
+
+
+void RDPurgeEngine::setDeleteAudio(bool state)
+{
+  purge_delete_audio=state;
+}
+
+
+bool RDPurgeEngine::purgeCuts(const QString &group_name,QString *err_msg)
+{
+  QString sql;
+  RDSqlQuery *q;
+  std::vector<RDPurgeCut> cuts;
+  QString midnight=QDate::currentDate().toString("yyyy-MM-dd")+" 00:00:00";
+
+  //
+  // Find every expired cut at once
+  //
+  sql=QString("select ")+
+    "CUTS.CUT_NAME,"+           // 00
+    "CUTS.CART_NUMBER,"+        // 01
+    "GROUPS.DELETE_EMPTY_CARTS "+  // 02
+    "from CUTS "+
+    "inner join CART on CUTS.CART_NUMBER=CART.NUMBER "+
+    "inner join GROUPS on CART.GROUP_NAME=GROUPS.NAME where "+
+    "(GROUPS.CUT_SHELFLIFE>=0)&&";
+  if(!group_name.isEmpty()) {
+    sql+="(GROUPS.NAME=\""+RDEscapeString(group_name)+"\")&&";
+  }
+  sql+=QString("(CUTS.END_DATETIME<date_sub(\"")+midnight+"\","+
+    "interval GROUPS.CUT_SHELFLIFE day)) "+
+    "order by CUTS.CART_NUMBER,CUTS.CUT_NAME";
+  q=new RDSqlQuery(sql);
+  while(q->next()) {
+    cuts.push_back(RDPurgeCut());
+    RDPurgeCut *cut=&cuts.back();
+    cut->cut_name=q->value(0).toString();
+    cut->filename=RDCut::pathName(cut->cut_name);
+    cut->cart_number=q->value(1).toUInt();
+    cut->delete_empty=q->value(2).toString()=="Y";
+    cut->audio_removed=!purge_delete_audio;
+  }
+  delete q;
+
+  //
+  // Unlink audio ourselves when the audio store is writable here,
+  // otherwise go through the Web API
+  //
+  purge_local_audio=purge_delete_audio&&
+    (access(purge_config->audioRoot().toUtf8(),W_OK|X_OK)==0);
+
+  for(unsigned i=0;i<cuts.size();i+=purge_cut_batch_size) {
+    unsigned last=i+purge_cut_batch_size;
+    if(last>cuts.size()) {
+      last=cuts.size();
+    }
+    if(!PurgeCutBatch(&cuts,i,last,err_msg)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+bool RDPurgeEngine::purgeElr(const QString &svc_name,QString *err_msg)
+{
+  QString sql;
+  RDSqlQuery *q;
+  RDSqlQuery *q1;
+  QDateTime dt=QDateTime(QDate::currentDate(),QTime::currentTime());
+  uint64_t start;
+  int rows;
+
+  sql=QString("select ")+
+    "NAME,"+          // 00
+    "ELR_SHELFLIFE "+  // 01
+    "from SERVICES where "+
+    "(ELR_SHELFLIFE>=0)";
+  if(!svc_name.isEmpty()) {
+    sql+="&&(NAME=\""+RDEscapeString(svc_name)+"\")";
+  }
+  q=new RDSqlQuery(sql);
+  while(q->next()) {
+    //
+    // Bounded deletes, so that ELR_LINES is never held for long
+    //
+    sql=QString("delete from ELR_LINES where ")+
+      "SERVICE_NAME=\""+RDEscapeString(q->value(0).toString())+"\" && "+
+      "EVENT_DATETIME<\""+
+      dt.addDays(-q->value(1).toInt()).toString("yyyy-MM-dd")+" 00:00:00\" "+
+      QString().sprintf("limit %u",purge_elr_batch_size);
+    do {
+      start=Now();
+      q1=new RDSqlQuery(sql);
+      AddLockTime(Now()-start);
+      if(!q1->isActive()) {
+	if(err_msg!=NULL) {
+	  *err_msg="sql error: "+q1->lastError().text()+" query: "+sql;
+	}
+	delete q1;
+	delete q;
+	return false;
+      }
+      rows=q1->numRowsAffected();
+      purge_elr_lines_purged+=rows;
+      delete q1;
+    } while(rows==(int)purge_elr_batch_size);
+  }
+  delete q;
+
+  return true;
+}
+
+
+unsigned RDPurgeEngine::cutsPurged() const
+{
+  return purge_cuts_purged;
+}
+
+
+unsigned RDPurgeEngine::cutsFailed() const
+{
+  return purge_cuts_failed;
+}
+
+
+unsigned RDPurgeEngine::cartsDeleted() const
+{
+  return purge_carts_deleted;
+}
+
+
+unsigned RDPurgeEngine::elrLinesPurged() const
+{
+  return purge_elr_lines_purged;
+}
+
+
+unsigned RDPurgeEngine::transactions() const
+{
+  return purge_transactions;
+}
+
+
+uint64_t RDPurgeEngine::maximumLockTime() const
+{
+  return purge_maximum_lock_time;
+}
+
+
+uint64_t RDPurgeEngine::totalLockTime() const
+{
+  return purge_total_lock_time;
+}
+
+
+void RDPurgeEngine::clearStatistics()
+{
+  purge_cuts_purged=0;
+  purge_cuts_failed=0;
+  purge_carts_deleted=0;
+  purge_elr_lines_purged=0;
+  purge_transactions=0;
+  purge_maximum_lock_time=0;
+  purge_total_lock_time=0;
+}
+
+
+bool RDPurgeEngine::PurgeCutBatch(std::vector<RDPurgeCut> *cuts,
+				  unsigned first,unsigned last,
+				  QString *err_msg)
+{
+  QString sql;
+  RDSqlQuery *q;
+  QString cutnames;
+  QString cartnums;
+  QString empty_cartnums;
+  QString deleted_cartnums;
+  std::vector<unsigned> modified;
+  std::vector<unsigned> deleted;
+  unsigned cuts_purged=0;
+  uint64_t start;
+
+  if(purge_delete_audio) {
+    RemoveAudio(cuts,first,last);
+  }
+
+  //
+  // Cuts whose audio could not be removed keep their rows, as before
+  //
+  for(unsigned i=first;i<last;i++) {
+    const RDPurgeCut &cut=cuts->at(i);
+    if(!cut.audio_removed) {
+      rda->syslog(LOG_WARNING,"unable to purge cut %s: audio deletion error",
+		  (const char *)cut.cut_name.toUtf8());
+      purge_cuts_failed++;
+      continue;
+    }
+    cutnames+="\""+RDEscapeString(cut.cut_name)+"\",";
+    if((modified.size()==0)||(modified.back()!=cut.cart_number)) {
+      modified.push_back(cut.cart_number);
+      cartnums+=QString().sprintf("%u,",cut.cart_number);
+      if(cut.delete_empty) {
+	empty_cartnums+=QString().sprintf("%u,",cut.cart_number);
+      }
+    }
+    cuts_purged++;
+  }
+  if(cuts_purged==0) {
+    return true;
+  }
+  cutnames=cutnames.left(cutnames.length()-1);
+  cartnums=cartnums.left(cartnums.length()-1);
+  empty_cartnums=empty_cartnums.left(empty_cartnums.length()-1);
+
+  start=Now();
+  if(!RDSqlQuery::apply("start transaction",err_msg)) {
+    return false;
+  }
+  QStringList sqls;
+  sqls.push_back("delete from CUT_EVENTS where CUT_NAME in ("+cutnames+")");
+  sqls.push_back("delete from REPL_CUT_STATE where CUT_NAME in ("+
+		 cutnames+")");
+  sqls.push_back("delete from CUTS where CUT_NAME in ("+cutnames+")");
+  sqls.push_back(QString("update CART set ")+
+		 "CUT_QUANTITY=(select count(*) from CUTS "+
+		 "where CUTS.CART_NUMBER=CART.NUMBER),"+
+		 "METADATA_DATETIME=now() "+
+		 "where NUMBER in ("+cartnums+")");
+  for(int i=0;i<sqls.size();i++) {
+    if(!RDSqlQuery::apply(sqls.at(i),err_msg)) {
+      RDSqlQuery::apply("rollback");
+      return false;
+    }
+  }
+
+  //
+  // Carts left empty in groups that ask for it
+  //
+  if(!empty_cartnums.isEmpty()) {
+    sql=QString("select ")+
+      "CART.NUMBER "+  // 00
+      "from CART left join CUTS "+
+      "on CART.NUMBER=CUTS.CART_NUMBER where "+
+      "(CART.NUMBER in ("+empty_cartnums+"))&&"+
+      "(CUTS.CUT_NAME is null)";
+    q=new RDSqlQuery(sql);
+    while(q->next()) {
+      deleted.push_back(q->value(0).toUInt());
+      deleted_cartnums+=QString().sprintf("%u,",q->value(0).toUInt());
+    }
+    delete q;
+  }
+  if(deleted.size()>0) {
+    deleted_cartnums=deleted_cartnums.left(deleted_cartnums.length()-1);
+    sqls.clear();
+    sqls.push_back("delete from CART_SCHED_CODES where CART_NUMBER in ("+
+		   deleted_cartnums+")");
+    sqls.push_back("delete from REPL_CART_STATE where CART_NUMBER in ("+
+		   deleted_cartnums+")");
+    sqls.push_back("delete from CART where NUMBER in ("+deleted_cartnums+")");
+    for(int i=0;i<sqls.size();i++) {
+      if(!RDSqlQuery::apply(sqls.at(i),err_msg)) {
+	RDSqlQuery::apply("rollback");
+	return false;
+      }
+    }
+  }
+  if(!RDSqlQuery::apply("commit",err_msg)) {
+    return false;
+  }
+  AddLockTime(Now()-start);
+
+  //
+  // One line and one notification per batch, rather than per cut
+  //
+  purge_cuts_purged+=cuts_purged;
+  purge_carts_deleted+=deleted.size();
+  rda->syslog(LOG_INFO,"purged %u cuts from carts %06u - %06u",
+	      cuts_purged,modified.front(),modified.back());
+  if(deleted.size()>0) {
+    rda->syslog(LOG_INFO,"deleted %u purged carts",(unsigned)deleted.size());
+  }
+  for(unsigned i=0;i<deleted.size();i++) {
+    for(unsigned j=0;j<modified.size();j++) {
+      if(modified.at(j)==deleted.at(i)) {
+	modified.erase(modified.begin()+j);
+	break;
+      }
+    }
+  }
+  SendNotification(RDNotification::ModifyAction,modified);
+  SendNotification(RDNotification::DeleteAction,deleted);
+
+  return true;
+}
+
+
+void RDPurgeEngine::RemoveAudio(std::vector<RDPurgeCut> *cuts,
+				unsigned first,unsigned last)
+{
+  RDPurgeQueue queue;
+  pthread_t threads[RD_PURGE_ENGINE_MAX_THREADS];
+  unsigned thread_quan=purge_threads;
+
+  if(purge_local_audio) {
+    queue.cuts=cuts;
+    queue.next=first;
+    queue.last=last;
+    pthread_mutex_init(&queue.mutex,NULL);
+    if(thread_quan>(last-first)) {
+      thread_quan=last-first;
+    }
+    for(unsigned i=0;i<thread_quan;i++) {
+      if(pthread_create(&threads[i],NULL,__RDPurgeThreadCallback,&queue)!=0) {
+	thread_quan=i;
+	break;
+      }
+    }
+    if(thread_quan==0) {
+      __RDPurgeThreadCallback(&queue);
+    }
+    for(unsigned i=0;i<thread_quan;i++) {
+      pthread_join(threads[i],NULL);
+    }
+    pthread_mutex_destroy(&queue.mutex);
+  }
+
+  //
+  // Anything we could not unlink here goes through the Web API
+  //
+  for(unsigned i=first;i<last;i++) {
+    RDPurgeCut *cut=&cuts->at(i);
+    if(!cut->audio_removed) {
+      cut->audio_removed=
+	RDCart::removeCutAudio(purge_station,purge_user,cut->cart_number,
+			       cut->cut_name,purge_config);
+    }
+  }
+}
+
+
+void RDPurgeEngine::SendNotification(RDNotification::Action action,
+				     const std::vector<unsigned> &cartnums)
+  const
+{
+  if((purge_ripc==NULL)||(cartnums.size()==0)) {
+    return;
+  }
+  RDNotification *notify=
+    new RDNotification(RDNotification::CartType,action,cartnums.at(0));
+  for(unsigned i=1;i<cartnums.size();i++) {
+    notify->addId(cartnums.at(i));
+  }
+  purge_ripc->sendNotification(*notify);
+  purge_ripc->flushNotifications();
+  delete notify;
+}
+
+
+void RDPurgeEngine::AddLockTime(uint64_t usecs)
+{
+  purge_transactions++;
+  purge_total_lock_time+=usecs;
+  if(usecs>purge_maximum_lock_time) {
+    purge_maximum_lock_time=usecs;
+  }
+}
+
+
+uint64_t RDPurgeEngine::Now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return 1000000*(uint64_t)ts.tv_sec+(uint64_t)ts.tv_nsec/1000;
+}
@@ -0,0 +1,104 @@
+// rdpurgeengine.h
+//
+// Purge expired cuts and ELR data in bounded batches
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDPURGEENGINE_H
+#define RDPURGEENGINE_H
+
+#include <stdint.h>
+
+#include <vector>
+
+#include <qstring.h>
+
+#include <rdconfig.h>
+#include <rdripc.h>
+#include <rdstation.h>
+#include <rduser.h>
+
+//
+// Default number of cuts removed in each transaction
+//
+#define RD_PURGE_ENGINE_CUT_BATCH 500
+
+//
+// Default number of ELR_LINES rows removed by each DELETE
+//
+#define RD_PURGE_ENGINE_ELR_BATCH 5000
+
+//
+// Largest number of threads unlinking audio from the local audio store
+//
+#define RD_PURGE_ENGINE_MAX_THREADS 8
+
+class RDPurgeCut;
+
+class RDPurgeEngine
+{
+ public:
+  RDPurgeEngine(RDStation *station,RDUser *user,RDConfig *config,
+		RDRipc *ripc=NULL);
+  unsigned cutBatchSize() const;
+  void setCutBatchSize(unsigned cuts);
+  unsigned elrBatchSize() const;
+  void setElrBatchSize(unsigned rows);
+  unsigned threads() const;
+  void setThreads(unsigned threads);
+  bool deleteAudio() const;
+  void setDeleteAudio(bool state);
+  bool purgeCuts(const QString &group_name=QString(),QString *err_msg=NULL);
+  bool purgeElr(const QString &svc_name=QString(),QString *err_msg=NULL);
+  unsigned cutsPurged() const;
+  unsigned cutsFailed() const;
+  unsigned cartsDeleted() const;
+  unsigned elrLinesPurged() const;
+  unsigned transactions() const;
+  uint64_t maximumLockTime() const;
+  uint64_t totalLockTime() const;
+  void clearStatistics();
+
+ private:
+  bool PurgeCutBatch(std::vector<RDPurgeCut> *cuts,unsigned first,
+		     unsigned last,QString *err_msg);
+  void RemoveAudio(std::vector<RDPurgeCut> *cuts,unsigned first,
+		   unsigned last);
+  void SendNotification(RDNotification::Action action,
+			const std::vector<unsigned> &cartnums) const;
+  void AddLockTime(uint64_t usecs);
+  static uint64_t Now();
+  RDStation *purge_station;
+  RDUser *purge_user;
+  RDConfig *purge_config;
+  RDRipc *purge_ripc;
+  unsigned purge_cut_batch_size;
+  unsigned purge_elr_batch_size;
+  unsigned purge_threads;
+  bool purge_delete_audio;
+  bool purge_local_audio;
+  unsigned purge_cuts_purged;
+  unsigned purge_cuts_failed;
+  unsigned purge_carts_deleted;
+  unsigned purge_elr_lines_purged;
+  unsigned purge_transactions;
+  uint64_t purge_maximum_lock_time;
+  uint64_t purge_total_lock_time;
+};
+
+
+#endif  // RDPURGEENGINE_H
@@ -2,7 +2,7 @@
 //
 // Abstract a Rivendell Report Descriptor
 //
-//   (C) Copyright 2002-2004,2016-2018 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2004,2016-2018,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -37,6 +37,7 @@ RDReport::RDReport(const QString &rptname,RDStation *station,RDConfig *config,
   report_station=station;
   report_config=config;
   report_error_code=RDReport::ErrorOk;
+  report_mixdown_method=RDReport::SetMixdown;
 }
 
 
@@ -307,6 +308,18 @@ RDReport::ErrorCode RDReport::errorCode() const
 }
 
 
+RDReport::MixdownMethod RDReport::mixdownMethod() const
+{
+  return report_mixdown_method;
+}
+
+
+void RDReport::setMixdownMethod(RDReport::MixdownMethod method)
+{
+  report_mixdown_method=method;
+}
+
+
 bool RDReport::outputExists(const QDate &startdate)
 {
   QString out_path;
@@ -321,10 +334,9 @@ bool RDReport::generateReport(const QDate &startdate,const QDate &enddate,
 {
   QString sql;
   RDSqlQuery *q;
-  RDSqlQuery *q1;
-  RDSqlQuery *q2;
   RDSvc *svc;
   //  QString rec_name;
+  QString from_sql;
   QString daypart_sql;
   QString station_sql;
   QString group_sql;
@@ -454,43 +466,9 @@ bool RDReport::generateReport(const QDate &startdate,const QDate &enddate,
       }
 
       //
-      // Selected Fields
+      // Selected Rows
       //
-      sql=QString("select ")+
-	"LENGTH,"+                           // 00
-	"LOG_ID,"+                           // 01
-	"CART_NUMBER,"+                      // 02
-	"STATION_NAME,"+                     // 03
-	"EVENT_DATETIME,"+                   // 04
-	"EVENT_TYPE,"+                       // 05
-	"EXT_START_TIME,"+                   // 06
-	"EXT_LENGTH,"+                       // 07
-	"EXT_DATA,"+                         // 08
-	"EXT_EVENT_ID,"+                     // 09
-	"EXT_ANNC_TYPE,"+                    // 10
-	"PLAY_SOURCE,"+                      // 11
-	"CUT_NUMBER,"+                       // 12
-	"EVENT_SOURCE,"+            // 13
-	"EXT_CART_NAME,"+           // 14
-	"LOG_NAME,"+                // 15
-	"ELR_LINES.TITLE,"+         // 16
-	"ELR_LINES.ARTIST,"+        // 17
-	"SCHEDULED_TIME,"+          // 18
-	"START_SOURCE,"+            // 19
-	"ELR_LINES.PUBLISHER,"+     // 20
-	"ELR_LINES.COMPOSER,"+      // 21
-	"ELR_LINES.ALBUM,"+         // 22
-	"ELR_LINES.LABEL,"+         // 23
-	"ELR_LINES.ISRC,"+          // 24
-	"ELR_LINES.USAGE_CODE,"+    // 25
-	"ELR_LINES.ONAIR_FLAG,"+    // 26
-	"ELR_LINES.ISCI,"+          // 27
-	"ELR_LINES.CONDUCTOR,"+     // 28
-	"ELR_LINES.USER_DEFINED,"+  // 29
-	"ELR_LINES.SONG_ID,"+       // 30
-	"ELR_LINES.DESCRIPTION,"+   // 31
-	"ELR_LINES.OUTCUE "+        // 32
-	"from ELR_LINES left join CART "+
+      from_sql=QString("from ELR_LINES left join CART ")+
 	"on ELR_LINES.CART_NUMBER=CART.NUMBER where "+
 	"SERVICE_NAME=\""+RDEscapeString(q->value(0).toString())+"\" && ";
 
@@ -498,18 +476,18 @@ bool RDReport::generateReport(const QDate &startdate,const QDate &enddate,
       // OnAir Flag Filter
       //
       if(filterOnairFlag()) {
-	sql+="(ONAIR_FLAG=\"Y\")&&";
+	from_sql+="(ONAIR_FLAG=\"Y\")&&";
       }
 
       //
       // Group Filter
       //
-      sql+="(";
+      from_sql+="(";
       if(!group_sql.isEmpty()) {
-	sql+=QString("(")+group_sql+")&&";
+	from_sql+=QString("(")+group_sql+")&&";
       }
       if(!force_sql.isEmpty()) {
-	sql+=QString("(")+force_sql+")&&";
+	from_sql+=QString("(")+force_sql+")&&";
       }
 
       //
@@ -517,64 +495,25 @@ bool RDReport::generateReport(const QDate &startdate,const QDate &enddate,
       //
       if(daypart_sql.isEmpty()) {
     	  //TODO Do we need to escape on Select statement?
-	sql+=QString("(EVENT_DATETIME>=\"")+startdate.toString("yyyy-MM-dd")+
-	  " 00:00:00\")&&"+
+	from_sql+=QString("(EVENT_DATETIME>=\"")+
+	  startdate.toString("yyyy-MM-dd")+" 00:00:00\")&&"+
 	  "(EVENT_DATETIME<=\""+enddate.toString("yyyy-MM-dd")+
 	  " 23:59:59\")&&";
       }
       else {
-	sql+=(QString("(")+daypart_sql+")&&");
+	from_sql+=(QString("(")+daypart_sql+")&&");
       }
       if(!station_sql.isEmpty()) {
-	sql+=QString("(")+station_sql+")||";
+	from_sql+=QString("(")+station_sql+")||";
+      }
+      from_sql=from_sql.left(from_sql.length()-2);
+      from_sql+=")";
+      if(report_mixdown_method==RDReport::RowMixdown) {
+	RowMixdown(from_sql,mixname);
       }
-      sql=sql.left(sql.length()-2);
-      sql+=")";
-      q1=new RDSqlQuery(sql);
-      while(q1->next()) {
-	sql=QString("insert into ELR_LINES set ")+
-	  "SERVICE_NAME=\""+RDEscapeString(mixname)+"\","+
-	  QString().sprintf("LENGTH=%d,LOG_ID=%u,CART_NUMBER=%u,",
-			    q1->value(0).toInt(),
-			    q1->value(1).toUInt(),
-			    q1->value(2).toInt())+
-	  "STATION_NAME=\""+RDEscapeString(q1->value(3).toString())+"\","+
-	  "EVENT_DATETIME="+RDCheckDateTime(q1->value(4).toDateTime(),
-				     "yyyy-MM-dd hh:mm:ss")+","+
-	  QString().sprintf("EVENT_TYPE=%d,",q1->value(5).toInt())+
-	  "EXT_START_TIME=\""+RDEscapeString(q1->value(6).toString())+"\","+
-	  QString().sprintf("EXT_LENGTH=%d,",q1->value(7).toInt())+
-	  "EXT_DATA=\""+RDEscapeString(q1->value(8).toString())+"\","+
-	  "EXT_EVENT_ID=\""+RDEscapeString(q1->value(9).toString())+"\","+
-	  "EXT_ANNC_TYPE=\""+RDEscapeString(q1->value(10).toString())+"\","+
-	  QString().sprintf("PLAY_SOURCE=%d,CUT_NUMBER=%d,EVENT_SOURCE=%d,",
-			    q1->value(11).toInt(),
-			    q1->value(12).toInt(),
-			    q1->value(13).toInt())+
-	  "EXT_CART_NAME=\""+RDEscapeString(q1->value(14).toString())+"\","+
-	  "LOG_NAME=\""+RDEscapeString(q1->value(15).toString())+"\","+
-	  "TITLE=\""+RDEscapeString(q1->value(16).toString())+"\","+
-	  "ARTIST=\""+RDEscapeString(q1->value(17).toString())+"\","+
-	  "SCHEDULED_TIME="+
-	  RDCheckDateTime(q1->value(18).toDate(),"yyyy-MM-dd hh:mm:ss")+","+
-	  QString().sprintf("START_SOURCE=%d,",q1->value(19).toInt())+
-	  "PUBLISHER=\""+RDEscapeString(q1->value(20).toString())+"\","+
-	  "COMPOSER=\""+RDEscapeString(q1->value(21).toString())+"\","+
-	  "ALBUM=\""+RDEscapeString(q1->value(22).toString())+"\","+
-	  "LABEL=\""+RDEscapeString(q1->value(23).toString())+"\","+
-	  "ISRC=\""+RDEscapeString(q1->value(24).toString())+"\","+
-	  QString().sprintf("USAGE_CODE=%d,",q1->value(25).toInt())+
-	  "ONAIR_FLAG=\""+RDEscapeString(q1->value(26).toString())+"\","+
-	  "ISCI=\""+RDEscapeString(q1->value(27).toString())+"\","+
-	  "CONDUCTOR=\""+RDEscapeString(q1->value(28).toString())+"\","+
-	  "USER_DEFINED=\""+RDEscapeString(q1->value(29).toString())+"\","+
-	  "SONG_ID=\""+RDEscapeString(q1->value(30).toString())+"\","+
-	  "DESCRIPTION=\""+RDEscapeString(q1->value(31).toString())+"\","+
-	  "OUTCUE=\""+RDEscapeString(q1->value(32).toString())+"\"";
-	q2=new RDSqlQuery(sql);
-	delete q2;
+      else {
+	SetMixdown(from_sql,mixname);
       }
-      delete q1;
     }
     delete svc;
   }
@@ -894,6 +833,176 @@ QString RDReport::center(const QString &str,int width)
 }
 
 
+void RDReport::SetMixdown(const QString &from_sql,const QString &mixname)
+{
+  //
+  // Copy the selected rows in a single statement. NULLs are replaced
+  // with the same values as produced by RowMixdown(), so that the export
+  // filters see identical data. SCHEDULED_TIME is copied as-is, where
+  // RowMixdown() always writes NULL; none of the filters use it.
+  //
+  QString sql=QString("insert into ELR_LINES (")+
+    "SERVICE_NAME,"+
+    "LENGTH,"+
+    "LOG_ID,"+
+    "CART_NUMBER,"+
+    "STATION_NAME,"+
+    "EVENT_DATETIME,"+
+    "EVENT_TYPE,"+
+    "EXT_START_TIME,"+
+    "EXT_LENGTH,"+
+    "EXT_DATA,"+
+    "EXT_EVENT_ID,"+
+    "EXT_ANNC_TYPE,"+
+    "PLAY_SOURCE,"+
+    "CUT_NUMBER,"+
+    "EVENT_SOURCE,"+
+    "EXT_CART_NAME,"+
+    "LOG_NAME,"+
+    "TITLE,"+
+    "ARTIST,"+
+    "SCHEDULED_TIME,"+
+    "START_SOURCE,"+
+    "PUBLISHER,"+
+    "COMPOSER,"+
+    "ALBUM,"+
+    "LABEL,"+
+    "ISRC,"+
+    "USAGE_CODE,"+
+    "ONAIR_FLAG,"+
+    "ISCI,"+
+    "CONDUCTOR,"+
+    "USER_DEFINED,"+
+    "SONG_ID,"+
+    "DESCRIPTION,"+
+    "OUTCUE) "+
+    "select "+
+    "\""+RDEscapeString(mixname)+"\","+
+    "ifnull(ELR_LINES.LENGTH,0),"+
+    "ifnull(ELR_LINES.LOG_ID,0),"+
+    "ifnull(ELR_LINES.CART_NUMBER,0),"+
+    "ifnull(ELR_LINES.STATION_NAME,''),"+
+    "ELR_LINES.EVENT_DATETIME,"+
+    "ifnull(ELR_LINES.EVENT_TYPE,0),"+
+    "ifnull(ELR_LINES.EXT_START_TIME,'00:00:00'),"+
+    "ifnull(ELR_LINES.EXT_LENGTH,0),"+
+    "ifnull(ELR_LINES.EXT_DATA,''),"+
+    "ifnull(ELR_LINES.EXT_EVENT_ID,''),"+
+    "ifnull(ELR_LINES.EXT_ANNC_TYPE,''),"+
+    "ifnull(ELR_LINES.PLAY_SOURCE,0),"+
+    "ifnull(ELR_LINES.CUT_NUMBER,0),"+
+    "ifnull(ELR_LINES.EVENT_SOURCE,0),"+
+    "ifnull(ELR_LINES.EXT_CART_NAME,''),"+
+    "ifnull(ELR_LINES.LOG_NAME,''),"+
+    "ifnull(ELR_LINES.TITLE,''),"+
+    "ifnull(ELR_LINES.ARTIST,''),"+
+    "ELR_LINES.SCHEDULED_TIME,"+
+    "ifnull(ELR_LINES.START_SOURCE,0),"+
+    "ifnull(ELR_LINES.PUBLISHER,''),"+
+    "ifnull(ELR_LINES.COMPOSER,''),"+
+    "ifnull(ELR_LINES.ALBUM,''),"+
+    "ifnull(ELR_LINES.LABEL,''),"+
+    "ifnull(ELR_LINES.ISRC,''),"+
+    "ifnull(ELR_LINES.USAGE_CODE,0),"+
+    "ELR_LINES.ONAIR_FLAG,"+
+    "ifnull(ELR_LINES.ISCI,''),"+
+    "ifnull(ELR_LINES.CONDUCTOR,''),"+
+    "ifnull(ELR_LINES.USER_DEFINED,''),"+
+    "ifnull(ELR_LINES.SONG_ID,''),"+
+    "ifnull(ELR_LINES.DESCRIPTION,''),"+
+    "ifnull(ELR_LINES.OUTCUE,'') "+
+    from_sql;
+  RDSqlQuery::apply(sql);
+}
+
+
+void RDReport::RowMixdown(const QString &from_sql,const QString &mixname)
+{
+  QString sql;
+  RDSqlQuery *q;
+
+  sql=QString("select ")+
+    "LENGTH,"+                           // 00
+    "LOG_ID,"+                           // 01
+    "CART_NUMBER,"+                      // 02
+    "STATION_NAME,"+                     // 03
+    "EVENT_DATETIME,"+                   // 04
+    "EVENT_TYPE,"+                       // 05
+    "EXT_START_TIME,"+                   // 06
+    "EXT_LENGTH,"+                       // 07
+    "EXT_DATA,"+                         // 08
+    "EXT_EVENT_ID,"+                     // 09
+    "EXT_ANNC_TYPE,"+                    // 10
+    "PLAY_SOURCE,"+                      // 11
+    "CUT_NUMBER,"+                       // 12
+    "EVENT_SOURCE,"+            // 13
+    "EXT_CART_NAME,"+           // 14
+    "LOG_NAME,"+                // 15
+    "ELR_LINES.TITLE,"+         // 16
+    "ELR_LINES.ARTIST,"+        // 17
+    "SCHEDULED_TIME,"+          // 18
+    "START_SOURCE,"+            // 19
+    "ELR_LINES.PUBLISHER,"+     // 20
+    "ELR_LINES.COMPOSER,"+      // 21
+    "ELR_LINES.ALBUM,"+         // 22
+    "ELR_LINES.LABEL,"+         // 23
+    "ELR_LINES.ISRC,"+          // 24
+    "ELR_LINES.USAGE_CODE,"+    // 25
+    "ELR_LINES.ONAIR_FLAG,"+    // 26
+    "ELR_LINES.ISCI,"+          // 27
+    "ELR_LINES.CONDUCTOR,"+     // 28
+    "ELR_LINES.USER_DEFINED,"+  // 29
+    "ELR_LINES.SONG_ID,"+       // 30
+    "ELR_LINES.DESCRIPTION,"+   // 31
+    "ELR_LINES.OUTCUE "+        // 32
+    from_sql;
+  q=new RDSqlQuery(sql);
+  while(q->next()) {
+    sql=QString("insert into ELR_LINES set ")+
+      "SERVICE_NAME=\""+RDEscapeString(mixname)+"\","+
+      QString().sprintf("LENGTH=%d,LOG_ID=%u,CART_NUMBER=%u,",
+			q->value(0).toInt(),
+			q->value(1).toUInt(),
+			q->value(2).toInt())+
+      "STATION_NAME=\""+RDEscapeString(q->value(3).toString())+"\","+
+      "EVENT_DATETIME="+RDCheckDateTime(q->value(4).toDateTime(),
+					"yyyy-MM-dd hh:mm:ss")+","+
+      QString().sprintf("EVENT_TYPE=%d,",q->value(5).toInt())+
+      "EXT_START_TIME=\""+RDEscapeString(q->value(6).toString())+"\","+
+      QString().sprintf("EXT_LENGTH=%d,",q->value(7).toInt())+
+      "EXT_DATA=\""+RDEscapeString(q->value(8).toString())+"\","+
+      "EXT_EVENT_ID=\""+RDEscapeString(q->value(9).toString())+"\","+
+      "EXT_ANNC_TYPE=\""+RDEscapeString(q->value(10).toString())+"\","+
+      QString().sprintf("PLAY_SOURCE=%d,CUT_NUMBER=%d,EVENT_SOURCE=%d,",
+			q->value(11).toInt(),
+			q->value(12).toInt(),
+			q->value(13).toInt())+
+      "EXT_CART_NAME=\""+RDEscapeString(q->value(14).toString())+"\","+
+      "LOG_NAME=\""+RDEscapeString(q->value(15).toString())+"\","+
+      "TITLE=\""+RDEscapeString(q->value(16).toString())+"\","+
+      "ARTIST=\""+RDEscapeString(q->value(17).toString())+"\","+
+      "SCHEDULED_TIME="+
+      RDCheckDateTime(q->value(18).toDate(),"yyyy-MM-dd hh:mm:ss")+","+
+      QString().sprintf("START_SOURCE=%d,",q->value(19).toInt())+
+      "PUBLISHER=\""+RDEscapeString(q->value(20).toString())+"\","+
+      "COMPOSER=\""+RDEscapeString(q->value(21).toString())+"\","+
+      "ALBUM=\""+RDEscapeString(q->value(22).toString())+"\","+
+      "LABEL=\""+RDEscapeString(q->value(23).toString())+"\","+
+      "ISRC=\""+RDEscapeString(q->value(24).toString())+"\","+
+      QString().sprintf("USAGE_CODE=%d,",q->value(25).toInt())+
+      "ONAIR_FLAG=\""+RDEscapeString(q->value(26).toString())+"\","+
+      "ISCI=\""+RDEscapeString(q->value(27).toString())+"\","+
+      "CONDUCTOR=\""+RDEscapeString(q->value(28).toString())+"\","+
+      "USER_DEFINED=\""+RDEscapeString(q->value(29).toString())+"\","+
+      "SONG_ID=\""+RDEscapeString(q->value(30).toString())+"\","+
+      "DESCRIPTION=\""+RDEscapeString(q->value(31).toString())+"\","+
+      "OUTCUE=\""+RDEscapeString(q->value(32).toString())+"\"";
+    RDSqlQuery::apply(sql);
+  }
+  delete q;
+}
+
+
 void RDReport::SetRow(const QString &param,const QString &value) const
 {
   RDSqlQuery *q;
@@ -2,7 +2,7 @@
 //
 // Abstract a Rivendell Report Descriptor
 //
-//   (C) Copyright 2002-2021 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -43,6 +43,7 @@ class RDReport
   enum ExportType {Generic=0,Traffic=1,Music=2};
   enum StationType {TypeOther=0,TypeAm=1,TypeFm=2,TypeLast=3};
   enum ErrorCode {ErrorOk=0,ErrorCanceled=1,ErrorCantOpen=2};
+  enum MixdownMethod {SetMixdown=0,RowMixdown=1};
   RDReport(const QString &rptname,RDStation *station,RDConfig *config,
 	   QObject *parent=0);
   QString name() const;
@@ -86,6 +87,8 @@ class RDReport
   void setEndTime(const QTime &time) const;
   void setEndTime() const;
   RDReport::ErrorCode errorCode() const;
+  RDReport::MixdownMethod mixdownMethod() const;
+  void setMixdownMethod(RDReport::MixdownMethod method);
   bool outputExists(const QDate &startdate);
   bool generateReport(const QDate &startdate,const QDate &enddate,
 		      RDStation *station,QString *out_path);
@@ -127,6 +130,8 @@ class RDReport
 		    const QDate &enddate,const QString &mixtable);
   bool ExportResultsReport(const QString &filename,const QDate &startdate,
 			   const QDate &enddate,const QString &mixtable);
+  void SetMixdown(const QString &from_sql,const QString &mixname);
+  void RowMixdown(const QString &from_sql,const QString &mixname);
   void SetRow(const QString &param,const QString &value) const;
   void SetRow(const QString &param,int value) const;
   void SetRow(const QString &param,unsigned value) const;
@@ -139,6 +144,7 @@ class RDReport
   RDStation *report_station;
   RDConfig *report_config;
   RDReport::ErrorCode report_error_code;
+  RDReport::MixdownMethod report_mixdown_method;
 };
 
 
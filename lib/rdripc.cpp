@@ -2,7 +2,7 @@
 //
 // Connection to the Rivendell Interprocess Communication Daemon
 //
-//   (C) Copyright 2002-2019 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2019,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -42,6 +42,21 @@ RDRipc::RDRipc(RDStation *station,RDConfig *config,QObject *parent)
   debug=false;
 
   ripc_connected=false;
+  ripc_binary_notifications=false;
+
+  //
+  // Notification Batching
+  //
+  int window=RD_DEFAULT_NOTIFICATION_WINDOW;
+  if(config!=NULL) {
+    window=config->notificationWindow();
+  }
+  ripc_notify_out=new RDNotificationCoalescer(window,this);
+  connect(ripc_notify_out,SIGNAL(ready(RDNotification *)),
+	  this,SLOT(sendNotificationData(RDNotification *)));
+  ripc_notify_in=new RDNotificationCoalescer(window,this);
+  connect(ripc_notify_in,SIGNAL(ready(RDNotification *)),
+	  this,SLOT(receiveNotificationData(RDNotification *)));
 
   //
   // TCP Connection
@@ -150,7 +165,25 @@ void RDRipc::sendNotification(RDNotification::Type type,
 
 void RDRipc::sendNotification(const RDNotification &notify)
 {
-  SendCommand("ON "+notify.write()+"!");
+  ripc_notify_out->append(notify);
+}
+
+
+void RDRipc::setNotificationWindow(int msecs)
+{
+  ripc_notify_out->setInterval(msecs);
+  ripc_notify_in->setInterval(msecs);
+}
+
+
+bool RDRipc::flushNotifications(int msecs)
+{
+  ripc_notify_out->flush();
+  ripc_socket->flush();
+  if((msecs>0)&&(ripc_socket->bytesToWrite()>0)) {
+    return ripc_socket->waitForBytesWritten(msecs);
+  }
+  return ripc_socket->bytesToWrite()==0;
 }
 
 
@@ -235,6 +268,25 @@ void RDRipc::readyData()
 }
 
 
+void RDRipc::sendNotificationData(RDNotification *notify)
+{
+  if(ripc_binary_notifications) {
+    SendCommand("ON "+notify->writeBinary()+"!");
+    return;
+  }
+  QList<RDNotification> notifies=notify->split();
+  for(int i=0;i<notifies.size();i++) {
+    SendCommand("ON "+notifies.at(i).write()+"!");
+  }
+}
+
+
+void RDRipc::receiveNotificationData(RDNotification *notify)
+{
+  emit notificationBatchReceived(notify);
+}
+
+
 void RDRipc::SendCommand(const QString &cmd)
 {
   //  printf("RDRipc::SendCommand(%s)\n",(const char *)cmd.toUtf8());
@@ -256,6 +308,12 @@ void RDRipc::DispatchCommand()
   
   if(cmds[0]=="PW") {  // Password Response
     SendCommand("RU!");
+    SendCommand(QString().sprintf("NV %d!",RD_NOTIFICATION_BINARY_VERSION));
+  }
+
+  if((cmds[0]=="NV")&&(cmds.size()==2)) {  // Notification Version
+    ripc_binary_notifications=
+      cmds[1].toInt()>=RD_NOTIFICATION_BINARY_VERSION;
   }
 
   if((cmds[0]=="RU")&&(cmds.size()==2)) {  // User Identity
@@ -402,7 +460,7 @@ void RDRipc::DispatchCommand()
   }
 
   if(cmds[0]=="ON") {   // Notification Received
-    if(cmds.size()<4) {
+    if(cmds.size()<3) {
       return;
     }
     QString msg;
@@ -415,7 +473,11 @@ void RDRipc::DispatchCommand()
       delete notify;
       return;
     }
-    emit notificationReceived(notify);
+    QList<RDNotification> notifies=notify->split();
+    for(int i=0;i<notifies.size();i++) {
+      emit notificationReceived(&notifies[i]);
+    }
+    ripc_notify_in->append(*notify);
     delete notify;
   }
 }
@@ -2,7 +2,7 @@
 //
 // Connection to the Rivendell Interprocess Communication Daemon
 //
-//   (C) Copyright 2002-2004,2016-2018 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2004,2016-2018,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -28,6 +28,7 @@
 #include <rdconfig.h>
 #include <rdmacro.h>
 #include <rdnotification.h>
+#include <rdnotificationcoalescer.h>
 #include <rdstation.h>
 
 #ifndef RDRIPC_H
@@ -36,6 +37,7 @@
 #define RIPC_MAX_ARGS 100
 #define RIPC_MAX_LENGTH 256
 #define RIPC_START_DELAY 2000
+#define RIPC_FLUSH_TIMEOUT 1000
 
 class RDRipc : public QObject
 {
@@ -58,6 +60,8 @@ class RDRipc : public QObject
   void sendNotification(RDNotification::Type type,
 			RDNotification::Action action,const QVariant &id);
   void sendNotification(const RDNotification &notify);
+  void setNotificationWindow(int msecs);
+  bool flushNotifications(int msecs=0);
   void sendOnairFlag();
   void sendRml(RDMacro *macro);
   void reloadHeartbeat();
@@ -72,6 +76,7 @@ class RDRipc : public QObject
   void gpiCartChanged(int matrix,int line,int off_cartnum,int on_cartnum);
   void gpoCartChanged(int matrix,int line,int off_cartnum,int on_cartnum);
   void notificationReceived(RDNotification *notify);
+  void notificationBatchReceived(RDNotification *notify);
   void onairFlagChanged(bool state);
   void rmlReceived(RDMacro *rml);
   
@@ -79,6 +84,8 @@ class RDRipc : public QObject
   void connectedData();
   void errorData(QAbstractSocket::SocketError err);
   void readyData();
+  void sendNotificationData(RDNotification *notify);
+  void receiveNotificationData(RDNotification *notify);
 
  private:
   void SendCommand(const QString &cmd);
@@ -93,6 +100,9 @@ class RDRipc : public QObject
   bool debug;
   QString ripc_accum;
   bool ripc_connected;
+  RDNotificationCoalescer *ripc_notify_out;
+  RDNotificationCoalescer *ripc_notify_in;
+  bool ripc_binary_notifications;
 };
 
 
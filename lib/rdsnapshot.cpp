@@ -0,0 +1,202 @@
+// rdsnapshot.cpp
+//
+// Process-wide snapshot of configuration rows
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdint.h>
+#include <time.h>
+
+#include <qhash.h>
+#include <qmutex.h>
+#include <qsqlrecord.h>
+
+#include "rddb.h"
+#include "rdsnapshot.h"
+
+//
+// Rows are shared between the entries for each of their key columns
+//
+typedef QHash<QString,QVariant> RDSnapshotRow;
+static QHash<QString,RDSnapshotRow> __rdsnapshot_rows;
+static QStringList __rdsnapshot_tables;
+static QMutex __rdsnapshot_mutex;
+static uint64_t __rdsnapshot_deadline=0;
+static unsigned __rdsnapshot_hits=0;
+
+static uint64_t __RDSnapshot_Now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return 1000*(uint64_t)ts.tv_sec+(uint64_t)ts.tv_nsec/1000000;
+}
+
+
+static QString __RDSnapshot_Key(const QString &table,const QString &name,
+				const QString &test)
+{
+  return table+"\t"+name+"\t"+test;
+}
+
+
+int RDSnapshot::load(const QString &table,const QString &name,
+		     const QVariant &test,const QStringList &keys)
+{
+  QList<RDSnapshotRow> rows;
+  QString sql;
+  RDSqlQuery *q;
+
+  //
+  // An empty 'name' takes every row of the table, which is then found
+  // with an empty name and test value
+  //
+  if(name.isEmpty()) {
+    q=new RDSqlQuery("select * from `"+table+"`");
+  }
+  else {
+    q=new RDSqlQuery("select * from `"+table+"` where `"+name+"`=?",
+		     QList<QVariant>()<<test);
+  }
+  while(q->next()) {
+    QSqlRecord rec=q->record();
+    RDSnapshotRow row;
+    for(int i=0;i<rec.count();i++) {
+      row[rec.fieldName(i)]=q->value(i);
+    }
+    rows.push_back(row);
+  }
+  delete q;
+
+  QMutexLocker locker(&__rdsnapshot_mutex);
+  for(int i=0;i<rows.size();i++) {
+    if(keys.size()==0) {
+      __rdsnapshot_rows[__RDSnapshot_Key(table,"","")]=rows.at(i);
+    }
+    for(int j=0;j<keys.size();j++) {
+      __rdsnapshot_rows[__RDSnapshot_Key(table,keys.at(j),
+			      rows.at(i).value(keys.at(j)).toString())]=
+	rows.at(i);
+    }
+  }
+  if(!__rdsnapshot_tables.contains(table)) {
+    __rdsnapshot_tables.push_back(table);
+  }
+  __rdsnapshot_deadline=__RDSnapshot_Now()+RD_SNAPSHOT_LIFETIME;
+
+  return rows.size();
+}
+
+
+void RDSnapshot::bootstrap(const QString &station)
+{
+  load("STATIONS","NAME",station,QStringList()<<"NAME");
+  load("SYSTEM","",QVariant(),QStringList());
+  load("RDLIBRARY","STATION",station,QStringList()<<"ID"<<"STATION");
+  load("RDLOGEDIT","STATION",station,QStringList()<<"ID"<<"STATION");
+  load("RDAIRPLAY","STATION",station,QStringList()<<"ID"<<"STATION");
+  load("RDPANEL","STATION",station,QStringList()<<"ID"<<"STATION");
+}
+
+
+bool RDSnapshot::value(const QString &table,const QString &name,
+		       const QVariant &test,const QString &param,
+		       QVariant *value,bool *valid)
+{
+  QMutexLocker locker(&__rdsnapshot_mutex);
+
+  if(__rdsnapshot_rows.size()==0) {
+    return false;
+  }
+  if(__RDSnapshot_Now()>=__rdsnapshot_deadline) {
+    __rdsnapshot_rows.clear();
+    __rdsnapshot_tables.clear();
+    return false;
+  }
+  QHash<QString,RDSnapshotRow>::const_iterator it=
+    __rdsnapshot_rows.find(__RDSnapshot_Key(table,name,test.toString()));
+  if(it==__rdsnapshot_rows.end()) {
+    return false;
+  }
+  RDSnapshotRow::const_iterator it1=it.value().find(param);
+  if(it1==it.value().end()) {
+    return false;
+  }
+  *value=it1.value();
+  if(valid!=NULL) {
+    *valid=!it1.value().isNull();
+  }
+  __rdsnapshot_hits++;
+
+  return true;
+}
+
+
+void RDSnapshot::invalidate(const QString &sql)
+{
+  QMutexLocker locker(&__rdsnapshot_mutex);
+
+  if(__rdsnapshot_tables.size()==0) {
+    return;
+  }
+
+  //
+  // Anything that may have written to a table drops all of its rows
+  //
+  for(int i=__rdsnapshot_tables.size()-1;i>=0;i--) {
+    if(sql.contains(__rdsnapshot_tables.at(i),Qt::CaseInsensitive)) {
+      QString prefix=__rdsnapshot_tables.at(i)+"\t";
+      QHash<QString,RDSnapshotRow>::iterator it=__rdsnapshot_rows.begin();
+      while(it!=__rdsnapshot_rows.end()) {
+	if(it.key().startsWith(prefix)) {
+	  it=__rdsnapshot_rows.erase(it);
+	}
+	else {
+	  ++it;
+	}
+      }
+      __rdsnapshot_tables.removeAt(i);
+    }
+  }
+}
+
+
+void RDSnapshot::clear()
+{
+  QMutexLocker locker(&__rdsnapshot_mutex);
+
+  __rdsnapshot_rows.clear();
+  __rdsnapshot_tables.clear();
+}
+
+
+bool RDSnapshot::isActive()
+{
+  QMutexLocker locker(&__rdsnapshot_mutex);
+
+  return (__rdsnapshot_rows.size()>0)&&
+    (__RDSnapshot_Now()<__rdsnapshot_deadline);
+}
+
+
+unsigned RDSnapshot::hits()
+{
+  QMutexLocker locker(&__rdsnapshot_mutex);
+
+  return __rdsnapshot_hits;
+}
@@ -0,0 +1,49 @@
+// rdsnapshot.h
+//
+// Process-wide snapshot of configuration rows
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDSNAPSHOT_H
+#define RDSNAPSHOT_H
+
+#include <qstring.h>
+#include <qstringlist.h>
+#include <qvariant.h>
+
+//
+// Longest time (mS) that a snapshot is used after being loaded
+//
+#define RD_SNAPSHOT_LIFETIME 5000
+
+class RDSnapshot
+{
+ public:
+  static int load(const QString &table,const QString &name,
+		  const QVariant &test,const QStringList &keys);
+  static void bootstrap(const QString &station);
+  static bool value(const QString &table,const QString &name,
+		    const QVariant &test,const QString &param,QVariant *value,
+		    bool *valid=NULL);
+  static void invalidate(const QString &sql);
+  static void clear();
+  static bool isActive();
+  static unsigned hits();
+};
+
+
+#endif  // RDSNAPSHOT_H
@@ -2,7 +2,7 @@
 //
 // The sound panel widget for RDAirPlay
 //
-//   (C) Copyright 2002-2020 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2020,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -79,6 +79,15 @@ RDSoundPanel::RDSoundPanel(int cols,int rows,int station_panels,
     panel_timescaling_supported[i]=false;
   }
   panel_onair_flag=false;
+  panel_station_model=NULL;
+  panel_user_model=NULL;
+
+  //
+  // Button Edits, written back to the database in batches
+  //
+  panel_save_timer=new QTimer(this);
+  panel_save_timer->setSingleShot(true);
+  connect(panel_save_timer,SIGNAL(timeout()),this,SLOT(saveButtonsData()));
 
   //
   // Load Buttons
@@ -233,6 +242,9 @@ RDSoundPanel::RDSoundPanel(int cols,int rows,int station_panels,
 
 RDSoundPanel::~RDSoundPanel()
 {
+  SaveButtons();
+  delete panel_station_model;
+  delete panel_user_model;
   for(unsigned i=0;i<panel_buttons.size();i++) {
     delete panel_buttons[i];
   }
@@ -491,8 +503,14 @@ void RDSoundPanel::setButton(RDAirPlayConf::PanelType type,int panel,
   button->clear();
   if(cartnum>0) {
     button->setCart(cartnum);
-    RDCart *cart=new RDCart(cartnum);
-    if(cart->exists()) {
+    QString sql=QString("select ")+
+      "FORCED_LENGTH,"+        // 00
+      "AVERAGE_HOOK_LENGTH,"+  // 01
+      "TYPE "+                 // 02
+      "from CART where "+
+      QString().sprintf("NUMBER=%u",cartnum);
+    RDSqlQuery *q=new RDSqlQuery(sql);
+    if(q->first()) {
       if(title.isEmpty()) {
 	button->
 	  setText(RDLogLine::resolveWildcards(cartnum,panel_label_template));
@@ -500,15 +518,15 @@ void RDSoundPanel::setButton(RDAirPlayConf::PanelType type,int panel,
       else {
 	button->setText(title);
       }
-      button->setLength(false,cart->forcedLength());
-      if(cart->averageHookLength()>0) {
-	button->setLength(true,cart->averageHookLength());
+      button->setLength(false,q->value(0).toInt());
+      if(q->value(1).toInt()>0) {
+	button->setLength(true,q->value(1).toInt());
       }
       else {
-	button->setLength(true,cart->forcedLength());
+	button->setLength(true,q->value(0).toInt());
       }
       button->setHookMode(panel_playmode_box->currentItem()==1);
-      switch(cart->type()) {
+      switch((RDCart::Type)q->value(2).toInt()) {
       case RDCart::Audio:
 	if(button->length(button->hookMode())==0) {
 	  button->setActiveLength(-1);
@@ -519,7 +537,7 @@ void RDSoundPanel::setButton(RDAirPlayConf::PanelType type,int panel,
 	break;
 
       case RDCart::Macro:
-	button->setActiveLength(cart->forcedLength());
+	button->setActiveLength(q->value(0).toInt());
 	break;
 
       case RDCart::All:
@@ -535,7 +553,7 @@ void RDSoundPanel::setButton(RDAirPlayConf::PanelType type,int panel,
 	button->setText(title);
       }
     }
-    delete cart;
+    delete q;
   }
   SaveButton(type,panel,row,col);
 }
@@ -554,6 +572,7 @@ void RDSoundPanel::acceptCartDrop(int row,int col,unsigned cartnum,
 void RDSoundPanel::changeUser()
 {
   panel_config_panels=rda->user()->configPanels();
+  SaveButtons();
   LoadPanels();
   panel_buttons[PanelOffset(panel_type,panel_number)]->show();
 
@@ -673,6 +692,7 @@ void RDSoundPanel::playmodeActivatedData(int n)
 void RDSoundPanel::setupClickedData()
 {
   if(panel_setup_mode) {
+    SaveButtons();
     panel_setup_mode=false;
     panel_setup_button->setFlashingEnabled(false);
     panel_reset_button->setEnabled(true);
@@ -888,6 +908,12 @@ void RDSoundPanel::scanPanelData()
 }
 
 
+void RDSoundPanel::saveButtonsData()
+{
+  SaveButtons();
+}
+
+
 void RDSoundPanel::wheelEvent(QWheelEvent *e)
 {
   if(e->orientation()==Qt::Vertical) {
@@ -1203,6 +1229,19 @@ void RDSoundPanel::LoadPanels()
   }
   panel_buttons.clear();
 
+  //
+  // Load Models, one query per owner
+  //
+  delete panel_station_model;
+  panel_station_model=new RDPanelModel(panel_tablename,
+				       RDAirPlayConf::StationPanel,
+				       rda->station()->name());
+  panel_station_model->load();
+  delete panel_user_model;
+  panel_user_model=new RDPanelModel(panel_tablename,RDAirPlayConf::UserPanel,
+				    rda->user()->name());
+  panel_user_model->load();
+
   //
   // Load Buttons
   //
@@ -1218,7 +1257,7 @@ void RDSoundPanel::LoadPanels()
 			   j*panel_button_columns+k);
       }
     }
-    LoadPanel(RDAirPlayConf::StationPanel,i);
+    ShowPanel(RDAirPlayConf::StationPanel,i);
     panel_buttons.back()->setAllowDrags(rda->station()->enableDragdrop());
   }
   for(int i=0;i<panel_user_panels;i++) {
@@ -1234,179 +1273,110 @@ void RDSoundPanel::LoadPanels()
       }
     }
     panel_buttons.back()->setAllowDrags(rda->station()->enableDragdrop());
-    LoadPanel(RDAirPlayConf::UserPanel,i);
+    ShowPanel(RDAirPlayConf::UserPanel,i);
   }
 }
 
 
 void RDSoundPanel::LoadPanel(RDAirPlayConf::PanelType type,int panel)
 {
-  QString owner;
-  int offset=0;
-
-  switch(type) {
-  case RDAirPlayConf::UserPanel:
-    owner=rda->user()->name();
-    offset=panel_station_panels+panel;
-    break;
+  PanelModel(type)->load(panel);
+  ShowPanel(type,panel);
+}
 
-  case RDAirPlayConf::StationPanel:
-    owner=rda->station()->name();
-    offset=panel;
-    break;
-  }
 
-  QString sql=QString("select ")+panel_tablename+".ROW_NO,"+
-    panel_tablename+".COLUMN_NO,"+
-    panel_tablename+".LABEL,"+
-    panel_tablename+".CART,"+
-    panel_tablename+".DEFAULT_COLOR,"+
-    "CART.FORCED_LENGTH,CART.AVERAGE_HOOK_LENGTH,CART.TYPE from "+
-    panel_tablename+" left join CART on "+panel_tablename+".CART=CART.NUMBER "+
-    "where "+panel_tablename+QString().sprintf(".TYPE=%d && ",type)+
-    panel_tablename+".OWNER=\""+RDEscapeString(owner)+"\" && "+
-    panel_tablename+QString().sprintf(".PANEL_NO=%d ",panel)+
-    "order by "+panel_tablename+".COLUMN_NO,"+panel_tablename+".ROW_NO";
-  RDSqlQuery *q=new RDSqlQuery(sql);
-  while(q->next()) {
-    if(panel_buttons[offset]->panelButton(q->value(0).toInt(),
-	      q->value(1).toInt())->playDeck()==NULL) {
-      panel_buttons[offset]->
-	panelButton(q->value(0).toInt(),q->value(1).toInt())->
-	setText(q->value(2).toString());
-      panel_buttons[offset]->
-	panelButton(q->value(0).toInt(),q->value(1).toInt())->
-	setCart(q->value(3).toInt());
-      panel_buttons[offset]->
-	panelButton(q->value(0).toInt(),q->value(1).toInt())->
-	setLength(false,q->value(5).toInt());
-      panel_buttons[offset]->
-	panelButton(q->value(0).toInt(),q->value(1).toInt())->
-	setLength(true,q->value(6).toInt());
+void RDSoundPanel::ShowPanel(RDAirPlayConf::PanelType type,int panel)
+{
+  RDPanelModel *model=PanelModel(type);
+  RDButtonPanel *bpanel=panel_buttons[PanelOffset(type,panel)];
+  RDPanelButton *button=NULL;
+  QString color;
+
+  for(int i=0;i<panel_button_rows;i++) {
+    for(int j=0;j<panel_button_columns;j++) {
+      //
+      // Buttons with unsaved edits already show them
+      //
+      if((!model->exists(panel,i,j))||model->isPending(panel,i,j)) {
+	continue;
+      }
+      button=bpanel->panelButton(i,j);
+      if(button->playDeck()!=NULL) {
+	continue;
+      }
+      int forced_length=model->forcedLength(panel,i,j);
+      int hook_length=model->averageHookLength(panel,i,j);
+      button->setText(model->label(panel,i,j));
+      button->setCart(model->cart(panel,i,j));
+      button->setLength(false,forced_length);
+      button->setLength(true,hook_length);
       if((panel_playmode_box!=NULL)&&(panel_playmode_box->currentItem()==1)&&
-	 (q->value(6).toUInt()>0)) {
-	panel_buttons[offset]->
-	  panelButton(q->value(0).toInt(),q->value(1).toInt())->
-	  setActiveLength(q->value(6).toInt());
+	 (hook_length>0)) {
+	button->setActiveLength(hook_length);
       }
       else {
-	if(q->value(7).toInt()==RDCart::Macro) {
-	  panel_buttons[offset]->
-	    panelButton(q->value(0).toInt(),q->value(1).toInt())->
-	    setActiveLength(q->value(5).toInt());
+	if(model->cartType(panel,i,j)==RDCart::Macro) {
+	  button->setActiveLength(forced_length);
 	}
 	else {
-	  if(q->value(5).toInt()>0) {
-	    panel_buttons[offset]->
-	      panelButton(q->value(0).toInt(),q->value(1).toInt())->
-	      setActiveLength(q->value(5).toInt());
+	  if(forced_length>0) {
+	    button->setActiveLength(forced_length);
 	  }
 	  else {
-	    panel_buttons[offset]->
-	      panelButton(q->value(0).toInt(),q->value(1).toInt())->
-	      setActiveLength(-1);
+	    button->setActiveLength(-1);
 	  }
 	}
       }
-      if(q->value(4).toString().isEmpty()) {
-	panel_buttons[offset]->
-	  panelButton(q->value(0).toInt(),q->value(1).toInt())->
-	  setColor(palette().active().background());
-	panel_buttons[offset]->
-	  panelButton(q->value(0).toInt(),q->value(1).toInt())->
-	  setDefaultColor(palette().active().background());
+      if((color=model->defaultColor(panel,i,j)).isEmpty()) {
+	button->setColor(palette().active().background());
+	button->setDefaultColor(palette().active().background());
       }
       else {
-	panel_buttons[offset]->
-	  panelButton(q->value(0).toInt(),q->value(1).toInt())->
-	  setColor(QColor(q->value(4).toString()));
-	panel_buttons[offset]->
-	  panelButton(q->value(0).toInt(),q->value(1).toInt())->
-	  setDefaultColor(QColor(q->value(4).toString()));
+	button->setColor(QColor(color));
+	button->setDefaultColor(QColor(color));
       }
     }
   }
-  delete q;
 }
 
 
 void RDSoundPanel::SaveButton(RDAirPlayConf::PanelType type,
 			    int panel,int row,int col)
 {
-  QString sql;
-  QString sql1;
-  RDSqlQuery *q;
-  QString owner;
-  int offset=0;
-
-  switch(type) {
-  case RDAirPlayConf::UserPanel:
-    owner=rda->user()->name();
-    offset=panel_station_panels+panel;
-    break;
-
-  case RDAirPlayConf::StationPanel:
-    owner=rda->station()->name();
-    offset=panel;
-    break;
-  }
+  RDPanelButton *button=
+    panel_buttons[PanelOffset(type,panel)]->panelButton(row,col);
 
   //
-  // Determine if the button exists
+  // Edits are collected and written together once they stop arriving
   //
-  sql=QString("select LABEL from ")+panel_tablename+" where "+
-    QString().sprintf("TYPE=%d && ",type)+
-    "OWNER=\""+RDEscapeString(owner)+"\" && "+
-    QString().sprintf("PANEL_NO=%d && ",panel)+
-    QString().sprintf("ROW_NO=%d && ",row)+
-    QString().sprintf("COLUMN_NO=%d",col);
-  q=new RDSqlQuery(sql);
-  if(q->size()>0) {
-    //
-    // If so, update the record
-    //
-    delete q;
-    sql1=QString("update ")+panel_tablename+" set "+
-      "LABEL=\""+RDEscapeString(panel_buttons[offset]->panelButton(row,col)->
-				text())+"\","+
-      QString().sprintf("CART=%d,",
-			panel_buttons[PanelOffset(panel_type,panel_number)]->
-			panelButton(row,col)->cart())+
-      "DEFAULT_COLOR=\""+panel_buttons[offset]->panelButton(row,col)->
-      defaultColor().name()+"\" where "+
-      QString().sprintf("(TYPE=%d)&&",type)+
-      "(OWNER=\""+RDEscapeString(owner)+"\")&&"+
-      QString().sprintf("(PANEL_NO=%d)&&",panel)+
-      QString().sprintf("(ROW_NO=%d)&&",row)+
-      QString().sprintf("(COLUMN_NO=%d)",col);
-    q=new RDSqlQuery(sql1);
-    if(q->isActive()) {
-      delete q;
-      return;
-    }
-    delete q;
+  PanelModel(type)->setButton(panel,row,col,button->text(),button->cart(),
+			      button->defaultColor().name());
+  panel_save_timer->start(PANEL_SAVE_INTERVAL);
+}
+
+
+void RDSoundPanel::SaveButtons()
+{
+  QString err_msg;
+
+  panel_save_timer->stop();
+  if((panel_station_model!=NULL)&&(!panel_station_model->save(&err_msg))) {
+    rda->syslog(LOG_WARNING,"unable to save station panel buttons [%s]",
+		(const char *)err_msg.toUtf8());
   }
-  else {
-    delete q;
-    
-    //
-    // Otherwise, insert a new one
-    //
-    sql1=QString("insert into ")+panel_tablename+
-      " (TYPE,OWNER,PANEL_NO,ROW_NO,COLUMN_NO,LABEL,CART,DEFAULT_COLOR) "+
-      QString().sprintf("values (%d,",type)+
-      "\""+RDEscapeString(owner)+"\","+
-      QString().sprintf("%d,%d,%d,",panel,row,col)+
-      "\""+RDEscapeString(panel_buttons[offset]->
-			  panelButton(row,col)->text())+"\","+
-      QString().sprintf("%d,",
-			panel_buttons[PanelOffset(panel_type,panel_number)]->
-			panelButton(row,col)->cart())+
-      "\""+RDEscapeString(panel_buttons[offset]->
-			  panelButton(row,col)->defaultColor().name())+"\")";
-    q=new RDSqlQuery(sql1);
-    delete q;
+  if((panel_user_model!=NULL)&&(!panel_user_model->save(&err_msg))) {
+    rda->syslog(LOG_WARNING,"unable to save user panel buttons [%s]",
+		(const char *)err_msg.toUtf8());
+  }
+}
+
+
+RDPanelModel *RDSoundPanel::PanelModel(RDAirPlayConf::PanelType type) const
+{
+  if(type==RDAirPlayConf::UserPanel) {
+    return panel_user_model;
   }
+  return panel_station_model;
 }
 
 
@@ -1470,98 +1440,44 @@ void RDSoundPanel::LogTraffic(RDPanelButton *button)
     return;
   }
 
-  QString sql;
-  RDSqlQuery *q;
   QDateTime now=QDateTime::currentDateTime();
-
-  sql=QString("select ")+
-    "CART.TITLE,"+         // 00
-    "CART.ARTIST,"+        // 01
-    "CART.PUBLISHER,"+     // 02
-    "CART.COMPOSER,"+      // 03
-    "CART.USAGE_CODE,"+    // 04
-    "CUTS.ISRC,"+          // 05
-    "CART.ALBUM,"+         // 06
-    "CART.LABEL,"+         // 07
-    "CUTS.ISCI,"+          // 08
-    "CART.CONDUCTOR,"+     // 09
-    "CART.USER_DEFINED,"+  // 10
-    "CART.SONG_ID,"+       // 11
-    "CUTS.DESCRIPTION,"+   // 12
-    "CUTS.OUTCUE "+        // 13
-    "from CART left join CUTS "+
-    "on CART.NUMBER=CUTS.CART_NUMBER where "+
-    "CUTS.CUT_NAME=\""+RDEscapeString(button->cutName())+"\"";
-  q=new RDSqlQuery(sql);
-  if(q->first()) {
-    sql=QString("insert into ELR_LINES set ")+
-      "SERVICE_NAME=\""+RDEscapeString(panel_svcname)+"\","+
-      QString().sprintf("LENGTH=%d,",button->startTime().msecsTo(now.time()))+
-      QString().sprintf("CART_NUMBER=%u,",button->cart())+
-      "STATION_NAME=\""+RDEscapeString(rda->station()->name().utf8())+"\","+
-      "EVENT_DATETIME="+
-      RDCheckDateTime(QDateTime(now.date(),button->startTime()),
-		      "yyyy-MM-dd hh:mm:ss")+","+
-      QString().sprintf("EVENT_TYPE=%d,",RDAirPlayConf::TrafficStop)+
-      QString().sprintf("EVENT_SOURCE=%d,",RDLogLine::SoundPanel)+
-      QString().sprintf("PLAY_SOURCE=%d,",RDLogLine::SoundPanel)+
-      QString().sprintf("CUT_NUMBER=%d,",button->cutName().right(3).toInt())+
-      "TITLE=\""+RDEscapeString(q->value(0).toString().utf8())+"\","+
-      "ARTIST=\""+RDEscapeString(q->value(1).toString().utf8())+"\","+
-      "PUBLISHER=\""+RDEscapeString(q->value(2).toString().utf8())+"\","+
-      "COMPOSER=\""+RDEscapeString(q->value(3).toString().utf8())+"\","+
-      QString().sprintf("USAGE_CODE=%d,",q->value(4).toInt())+
-      "ISRC=\""+RDEscapeString(q->value(5).toString().utf8())+"\","+
-      QString().sprintf("START_SOURCE=%d,",button->startSource())+
-      "ALBUM=\""+RDEscapeString(q->value(6).toString().utf8())+"\","+
-      "LABEL=\""+RDEscapeString(q->value(7).toString().utf8())+"\","+
-      "ISCI=\""+RDEscapeString(q->value(8).toString().utf8())+"\","+
-      "DESCRIPTION=\""+RDEscapeString(q->value(12).toString().utf8())+"\","+
-      "OUTCUE=\""+RDEscapeString(q->value(13).toString().utf8())+"\","+
-      "CONDUCTOR=\""+RDEscapeString(q->value(9).toString().utf8())+"\","+
-      "USER_DEFINED=\""+RDEscapeString(q->value(10).toString().utf8())+"\","+
-      "SONG_ID=\""+RDEscapeString(q->value(11).toString().utf8())+"\","+
-      "ONAIR_FLAG=\""+RDYesNo(panel_onair_flag)+"\"";
-    delete q;
-    q=new RDSqlQuery(sql);
-  }
-  delete q;
+  RDElrRecord rec;
+
+  rec.setLookup(RDElrRecord::LookupCut,button->cutName());
+  rec.setValue("SERVICE_NAME",panel_svcname);
+  rec.setValue("LENGTH",button->startTime().msecsTo(now.time()));
+  rec.setValue("CART_NUMBER",button->cart());
+  rec.setValue("STATION_NAME",rda->station()->name());
+  rec.setLiteral("EVENT_DATETIME",
+		 RDCheckDateTime(QDateTime(now.date(),button->startTime()),
+				 "yyyy-MM-dd hh:mm:ss"));
+  rec.setValue("EVENT_TYPE",RDAirPlayConf::TrafficStop);
+  rec.setValue("EVENT_SOURCE",RDLogLine::SoundPanel);
+  rec.setValue("PLAY_SOURCE",RDLogLine::SoundPanel);
+  rec.setValue("CUT_NUMBER",button->cutName().right(3).toInt());
+  rec.setValue("START_SOURCE",button->startSource());
+  rec.setValue("ONAIR_FLAG",RDYesNo(panel_onair_flag));
+  rda->elrJournal()->append(rec);
 }
 
 
 void RDSoundPanel::LogTrafficMacro(RDPanelButton *button)
 {
-  QString sql;
-  RDSqlQuery *q;
   QDateTime datetime(QDate::currentDate(),QTime::currentTime());
-
-  sql=QString("select TITLE,ARTIST,PUBLISHER,COMPOSER,USAGE_CODE,")+
-    "FORCED_LENGTH,ALBUM,LABEL from CART where "+
-    QString().sprintf("NUMBER=%u",button->cart());
-  q=new RDSqlQuery(sql);
-  if(q->first()) {
-    sql=QString("insert into ELR_LINES set ")+
-      "SERVICE_NAME=\""+RDEscapeString(panel_svcname)+"\","+
-      QString().sprintf("LENGTH=%d,",q->value(5).toUInt())+
-      QString().sprintf("CART_NUMBER=%u,",button->cart())+
-      "STATION_NAME=\""+RDEscapeString(rda->station()->name().utf8())+"\","+
-      "EVENT_DATETIME=\""+datetime.toString("yyyy-MM-dd hh:mm:ss")+"\","+
-      QString().sprintf("EVENT_TYPE=%d,",RDAirPlayConf::TrafficMacro)+
-      QString().sprintf("EVENT_SOURCE=%d,",RDLogLine::SoundPanel)+
-      QString().sprintf("PLAY_SOURCE=%d,",RDLogLine::SoundPanel)+
-      "TITLE=\""+RDEscapeString(q->value(0).toString().utf8())+"\","+
-      "ARTIST=\""+RDEscapeString(q->value(1).toString().utf8())+"\","+
-      "PUBLISHER=\""+RDEscapeString(q->value(2).toString().utf8())+"\","+
-      "COMPOSER=\""+RDEscapeString(q->value(3).toString().utf8())+"\","+
-      QString().sprintf("USAGE_CODE=%d,",q->value(4).toInt())+
-      QString().sprintf("START_SOURCE=%d,",button->startSource())+
-      "ALBUM=\""+RDEscapeString(q->value(6).toString().utf8())+"\","+
-      "LABEL=\""+RDEscapeString(q->value(7).toString().utf8())+"\","+
-      "ONAIR_FLAG=\""+RDYesNo(panel_onair_flag)+"\"";
-    delete q;
-    q=new RDSqlQuery(sql);
-    delete q;
-  }
+  RDElrRecord rec;
+
+  rec.setLookup(RDElrRecord::LookupMacroCart,
+		QString().sprintf("%u",button->cart()));
+  rec.setValue("SERVICE_NAME",panel_svcname);
+  rec.setValue("CART_NUMBER",button->cart());
+  rec.setValue("STATION_NAME",rda->station()->name());
+  rec.setValue("EVENT_DATETIME",datetime.toString("yyyy-MM-dd hh:mm:ss"));
+  rec.setValue("EVENT_TYPE",RDAirPlayConf::TrafficMacro);
+  rec.setValue("EVENT_SOURCE",RDLogLine::SoundPanel);
+  rec.setValue("PLAY_SOURCE",RDLogLine::SoundPanel);
+  rec.setValue("START_SOURCE",button->startSource());
+  rec.setValue("ONAIR_FLAG",RDYesNo(panel_onair_flag));
+  rda->elrJournal()->append(rec);
 }
 
 
@@ -2,7 +2,7 @@
 //
 // The sound panel widget
 //
-//   (C) Copyright 2002-2019 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2019,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -35,6 +35,7 @@
 #include <rdcombobox.h>
 #include <rdevent_player.h>
 #include <rdpanel_button.h>
+#include <rdpanelmodel.h>
 #include <rdpushbutton.h>
 #include <rdwidget.h>
 
@@ -45,6 +46,7 @@
 #define PANEL_BUTTON_SIZE_Y 80
 #define PANEL_MAX_OUTPUTS 5
 #define PANEL_SCAN_INTERVAL 10000
+#define PANEL_SAVE_INTERVAL 1000
 
 class RDSoundPanel : public RDWidget
 {
@@ -115,6 +117,7 @@ class RDSoundPanel : public RDWidget
   void panelSetupData();
   void onairFlagChangedData(bool state);
   void scanPanelData();
+  void saveButtonsData();
 
  protected:
   void wheelEvent(QWheelEvent *e);
@@ -132,7 +135,10 @@ class RDSoundPanel : public RDWidget
   void StopButton(RDPlayDeck *deck);
   void LoadPanels();
   void LoadPanel(RDAirPlayConf::PanelType type,int panel);
+  void ShowPanel(RDAirPlayConf::PanelType type,int panel);
   void SaveButton(RDAirPlayConf::PanelType type,int panel,int row,int col);
+  void SaveButtons();
+  RDPanelModel *PanelModel(RDAirPlayConf::PanelType type) const;
   int PanelOffset(RDAirPlayConf::PanelType type,int panel);
   int GetFreeButtonDeck();
   int GetFreeOutput();
@@ -188,6 +194,9 @@ class RDSoundPanel : public RDWidget
   RDCartDialog *panel_cart_dialog;
   bool panel_onair_flag;
   QTimer *panel_scan_timer;
+  QTimer *panel_save_timer;
+  RDPanelModel *panel_station_model;
+  RDPanelModel *panel_user_model;
   QString panel_caption;
 };
 
@@ -0,0 +1,270 @@
+// rdsqlprofiler.cpp
+//
+// Per-query-shape database statistics
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <math.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <map>
+
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QRegExp>
+
+#include "rdsqlprofiler.h"
+
+struct RDSqlProfileEntry {
+  uint64_t calls;
+  uint64_t total_usecs;
+  uint64_t max_usecs;
+  uint64_t rows;
+  uint32_t buckets[RDSQLPROFILER_BUCKETS];
+};
+
+static QMutex *profiler_mutex=NULL;
+static QHash<QString,RDSqlProfileEntry> *profiler_entries=NULL;
+static QString profiler_filename;
+static QString profiler_module_name;
+static volatile sig_atomic_t profiler_dump_pending=0;
+
+static void ProfilerSigHandler(int signo)
+{
+  profiler_dump_pending=1;
+}
+
+
+static void ProfilerExit()
+{
+  RDSqlProfiler::dump();
+}
+
+
+void RDSqlProfiler::start(const QString &dirname,const QString &modname)
+{
+  if((profiler_entries!=NULL)||dirname.isEmpty()) {
+    return;
+  }
+  profiler_module_name=modname;
+  if(profiler_module_name.isEmpty()) {
+    profiler_module_name="rivendell";
+  }
+  profiler_filename=dirname+"/"+profiler_module_name+
+    QString().sprintf("-%d.sqlprofile",getpid());
+  profiler_mutex=new QMutex();
+  profiler_entries=new QHash<QString,RDSqlProfileEntry>();
+  ::signal(SIGUSR2,ProfilerSigHandler);
+  atexit(ProfilerExit);
+}
+
+
+bool RDSqlProfiler::isActive()
+{
+  return profiler_entries!=NULL;
+}
+
+
+uint64_t RDSqlProfiler::timestamp()
+{
+  struct timespec ts;
+
+  if(profiler_entries==NULL) {
+    return 0;
+  }
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return 1000000*(uint64_t)ts.tv_sec+(uint64_t)ts.tv_nsec/1000;
+}
+
+
+void RDSqlProfiler::addSample(const QString &sql,bool is_shape,uint64_t start,
+			      int rows)
+{
+  uint64_t usecs;
+  int bucket=0;
+
+  if(profiler_entries==NULL) {
+    return;
+  }
+  usecs=RDSqlProfiler::timestamp()-start;
+  if(usecs>0) {
+    bucket=(int)(4.0*log2((double)usecs));
+    if(bucket>=RDSQLPROFILER_BUCKETS) {
+      bucket=RDSQLPROFILER_BUCKETS-1;
+    }
+  }
+  QString key=sql;
+  if(!is_shape) {
+    key=RDSqlProfiler::shape(sql);
+  }
+
+  profiler_mutex->lock();
+  QHash<QString,RDSqlProfileEntry>::iterator it=profiler_entries->find(key);
+  if(it==profiler_entries->end()) {
+    RDSqlProfileEntry e;
+    memset(&e,0,sizeof(e));
+    it=profiler_entries->insert(key,e);
+  }
+  it.value().calls++;
+  it.value().total_usecs+=usecs;
+  if(usecs>it.value().max_usecs) {
+    it.value().max_usecs=usecs;
+  }
+  if(rows>0) {
+    it.value().rows+=rows;
+  }
+  it.value().buckets[bucket]++;
+  profiler_mutex->unlock();
+
+  if(profiler_dump_pending) {
+    profiler_dump_pending=0;
+    RDSqlProfiler::dump();
+  }
+}
+
+
+QString RDSqlProfiler::shape(const QString &sql)
+{
+  QString ret;
+  QChar quote;
+  int len=sql.length();
+  int i=0;
+
+  //
+  // Replace quoted strings and numeric literals with '?' and collapse
+  // whitespace, so that queries differing only by value map together.
+  //
+  while(i<len) {
+    QChar c=sql.at(i);
+    if((c=='"')||(c=='\'')) {
+      quote=c;
+      i++;
+      while((i<len)&&(sql.at(i)!=quote)) {
+	if(sql.at(i)=='\\') {
+	  i++;
+	}
+	i++;
+      }
+      i++;
+      ret+="?";
+      continue;
+    }
+    if(c=='`') {
+      do {
+	ret+=sql.at(i++);
+      } while((i<len)&&(sql.at(i)!='`'));
+      if(i<len) {
+	ret+=sql.at(i++);
+      }
+      continue;
+    }
+    QChar prev=ret.isEmpty()?QChar(' '):ret.at(ret.length()-1);
+    if(c.isDigit()&&(!prev.isLetterOrNumber())&&(prev!='_')) {
+      while((i<len)&&(sql.at(i).isDigit()||(sql.at(i)=='.'))) {
+	i++;
+      }
+      ret+="?";
+      continue;
+    }
+    if(c.isSpace()) {
+      if((!ret.isEmpty())&&(!ret.at(ret.length()-1).isSpace())) {
+	ret+=" ";
+      }
+      i++;
+      continue;
+    }
+    ret+=c;
+    i++;
+  }
+  ret.replace(QRegExp("\\?( ?, ?\\?)+"),"?,...");
+
+  return ret.trimmed();
+}
+
+
+bool RDSqlProfiler::dump()
+{
+  FILE *f=NULL;
+
+  if(profiler_entries==NULL) {
+    return false;
+  }
+  if((f=fopen(profiler_filename.toUtf8(),"w"))==NULL) {
+    return false;
+  }
+  RDSqlProfiler::dump(f);
+  fclose(f);
+
+  return true;
+}
+
+
+void RDSqlProfiler::dump(FILE *f)
+{
+  std::multimap<uint64_t,QString> order;
+  uint64_t threshold;
+  uint64_t count;
+  double p99;
+
+  if(profiler_entries==NULL) {
+    return;
+  }
+  profiler_mutex->lock();
+  for(QHash<QString,RDSqlProfileEntry>::const_iterator it=
+	profiler_entries->begin();it!=profiler_entries->end();it++) {
+    order.insert(std::pair<uint64_t,QString>(it.value().total_usecs,
+					     it.key()));
+  }
+  fprintf(f,"# SQL query profile for %s [pid %d], written %s\n",
+	  (const char *)profiler_module_name.toUtf8(),getpid(),
+	  (const char *)QDateTime::currentDateTime().
+	  toString("yyyy-MM-dd hh:mm:ss").toUtf8());
+  fprintf(f,"#%9s %12s %10s %10s %10s %12s  %s\n",
+	  "CALLS","TOTAL(ms)","AVG(ms)","P99(ms)","MAX(ms)","ROWS","SHAPE");
+  for(std::multimap<uint64_t,QString>::const_reverse_iterator it=
+	order.rbegin();it!=order.rend();it++) {
+    const RDSqlProfileEntry &e=profiler_entries->value(it->second);
+    threshold=(99*e.calls+99)/100;
+    count=0;
+    p99=0.0;
+    for(int i=0;i<RDSQLPROFILER_BUCKETS;i++) {
+      count+=e.buckets[i];
+      if(count>=threshold) {
+	p99=pow(2.0,(double)(i+1)/4.0);
+	if(p99>(double)e.max_usecs) {
+	  p99=(double)e.max_usecs;
+	}
+	break;
+      }
+    }
+    fprintf(f,"%10lu %12.3lf %10.3lf %10.3lf %10.3lf %12lu  %s\n",
+	    (unsigned long)e.calls,
+	    (double)e.total_usecs/1000.0,
+	    (double)e.total_usecs/(1000.0*(double)e.calls),
+	    p99/1000.0,
+	    (double)e.max_usecs/1000.0,
+	    (unsigned long)e.rows,
+	    (const char *)it->second.toUtf8());
+  }
+  profiler_mutex->unlock();
+}
@@ -0,0 +1,48 @@
+// rdsqlprofiler.h
+//
+// Per-query-shape database statistics
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDSQLPROFILER_H
+#define RDSQLPROFILER_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include <QString>
+
+//
+// Four histogram buckets per octave, covering 1 uS to ~70 minutes
+//
+#define RDSQLPROFILER_BUCKETS 128
+
+class RDSqlProfiler
+{
+ public:
+  static void start(const QString &dirname,const QString &modname);
+  static bool isActive();
+  static uint64_t timestamp();
+  static void addSample(const QString &sql,bool is_shape,uint64_t start,
+			int rows);
+  static QString shape(const QString &sql);
+  static bool dump();
+  static void dump(FILE *f);
+};
+
+
+#endif  // RDSQLPROFILER_H
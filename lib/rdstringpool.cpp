@@ -0,0 +1,79 @@
+// rdstringpool.cpp
+//
+// Share the storage of repeated strings
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <qmutex.h>
+#include <qset.h>
+
+#include "rdstringpool.h"
+
+static QSet<QString> __rdstringpool_strings;
+static QMutex __rdstringpool_mutex;
+static int __rdstringpool_prune_size=RD_STRING_POOL_MIN_PRUNE;
+
+QString RDStringPool::intern(const QString &str)
+{
+  if(str.isEmpty()) {
+    return str;
+  }
+  QMutexLocker locker(&__rdstringpool_mutex);
+  QSet<QString>::const_iterator it=__rdstringpool_strings.find(str);
+  if(it!=__rdstringpool_strings.end()) {
+    return *it;
+  }
+  if(__rdstringpool_strings.size()>=__rdstringpool_prune_size) {
+    locker.unlock();
+    prune();
+    locker.relock();
+  }
+  __rdstringpool_strings.insert(str);
+
+  return str;
+}
+
+
+int RDStringPool::size()
+{
+  QMutexLocker locker(&__rdstringpool_mutex);
+
+  return __rdstringpool_strings.size();
+}
+
+
+void RDStringPool::prune()
+{
+  QMutexLocker locker(&__rdstringpool_mutex);
+
+  //
+  // An entry whose storage is not shared is held only by the pool
+  //
+  QSet<QString>::iterator it=__rdstringpool_strings.begin();
+  while(it!=__rdstringpool_strings.end()) {
+    if(it->isDetached()) {
+      it=__rdstringpool_strings.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+  __rdstringpool_prune_size=2*__rdstringpool_strings.size();
+  if(__rdstringpool_prune_size<RD_STRING_POOL_MIN_PRUNE) {
+    __rdstringpool_prune_size=RD_STRING_POOL_MIN_PRUNE;
+  }
+}
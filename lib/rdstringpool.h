@@ -0,0 +1,40 @@
+// rdstringpool.h
+//
+// Share the storage of repeated strings
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDSTRINGPOOL_H
+#define RDSTRINGPOOL_H
+
+#include <qstring.h>
+
+//
+// Minimum pool size at which unused entries are pruned
+//
+#define RD_STRING_POOL_MIN_PRUNE 4096
+
+class RDStringPool
+{
+ public:
+  static QString intern(const QString &str);
+  static int size();
+  static void prune();
+};
+
+
+#endif  // RDSTRINGPOOL_H
@@ -2,7 +2,7 @@
 //
 // Abstract a Rivendell Service.
 //
-//   (C) Copyright 2002-2020 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2020,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -28,15 +28,23 @@
 #include "rd.h"
 #include "rdescape_string.h"
 #include "rdlog.h"
+#include "rdlogtemplatecache.h"
 #include "rdsvc.h"
 #include "rdweb.h"
 
+//
+// Maximum number of rows staged into IMPORTER_LINES per "insert"
+//
+#define RDSVC_IMPORT_STAGE_ROWS 500
+
 RDSvc::RDSvc(QString svcname,RDStation *station,RDConfig *config,QObject *parent)
   : QObject(parent)
 {
   svc_name=svcname;
   svc_station=station;
   svc_config=config;
+  svc_import_method=RDSvc::DirectImport;
+  svc_template_cache=NULL;
 }
 
 
@@ -414,6 +422,33 @@ QString RDSvc::importFilename(ImportSource src,const QDate &date) const
 
 bool RDSvc::import(ImportSource src,const QDate &date,const QString &break_str,
 		   const QString &track_str,bool resolve_implied_times) const
+{
+  std::vector<RDImportLine> lines;
+  QString err_msg;
+  QTime timer;
+
+  timer.start();
+  if(!import(src,date,break_str,track_str,resolve_implied_times,&lines)) {
+    return false;
+  }
+  int parse_msecs=timer.restart();
+  if(!StageImport(lines,&err_msg)) {
+    rda->syslog(LOG_WARNING,"unable to stage import for service \"%s\": %s",
+		(const char *)svc_name.toUtf8(),
+		(const char *)err_msg.toUtf8());
+    return false;
+  }
+  rda->syslog(LOG_DEBUG,"imported %lu lines for service \"%s\": "
+	      "parse %d mS, stage %d mS",lines.size(),
+	      (const char *)svc_name.toUtf8(),parse_msecs,timer.elapsed());
+
+  return true;
+}
+
+
+bool RDSvc::import(ImportSource src,const QDate &date,const QString &break_str,
+		   const QString &track_str,bool resolve_implied_times,
+		   std::vector<RDImportLine> *lines) const
 {
   FILE *infile;
   QString src_str;
@@ -436,6 +471,8 @@ bool RDSvc::import(ImportSource src,const QDate &date,const QString &break_str,
   QString sql;
   bool ok=false;
 
+  lines->clear();
+
   //
   // Set Import Source
   //
@@ -528,6 +565,7 @@ bool RDSvc::import(ImportSource src,const QDate &date,const QString &break_str,
   q=new RDSqlQuery(sql);
   if(!q->first()) {
     delete q;
+    fclose(infile);
     return false;
   }
   int cart_offset=q->value(0).toInt();
@@ -556,21 +594,14 @@ bool RDSvc::import(ImportSource src,const QDate &date,const QString &break_str,
   delete q;
 
   //
-  // Setup Data Source and Destination
-  //
-  sql=QString("delete from IMPORTER_LINES where ")+
-    "STATION_NAME=\""+RDEscapeString(svc_station->name())+"\" && "+
-    QString().sprintf("PROCESS_ID=%u",getpid());
-  RDSqlQuery::apply(sql);
-
-  //
-  // Parse and Save
+  // Parse
   //
   int line_id=0;
   bool cart_ok=false;
   bool start_time_ok=false;
   QString track_label;
   QTime link_time;
+  RDImportLine line;
 
   int file_line=0;
   while(fgets(buf,RD_MAX_IMPORT_LINE_LENGTH,infile)!=NULL) {
@@ -641,34 +672,31 @@ bool RDSvc::import(ImportSource src,const QDate &date,const QString &break_str,
     cartnum=cartname.toUInt(&cart_ok);
 
     //
-    // Common SQL Elements
+    // Common Elements
     //
-    sql=QString("insert into IMPORTER_LINES set ")+
-      "STATION_NAME=\""+RDEscapeString(svc_station->name())+"\","+
-      QString().sprintf("PROCESS_ID=%d,",getpid())+
-      QString().sprintf("FILE_LINE=%u,",file_line)+
-      QString().sprintf("LINE_ID=%d,",line_id);
+    line.clear();
+    line.file_line=file_line;
+    line.line_id=line_id;
     if(start_time_ok) {
-      sql+=QString().sprintf("START_HOUR=%d,",start_hour)+
-	QString().sprintf("START_SECS=%d,",
-			  60*start_minutes+start_seconds);
+      line.start_hour=start_hour;
+      line.start_secs=60*start_minutes+start_seconds;
     }
     if(cartlen>=0) {
-      sql+=QString().sprintf("LENGTH=%d,",cartlen);
+      line.length=cartlen;
     }
 
     //
     // Cart
     //
     if(start_time_ok&&cart_ok&&(cartnum>0)&&(cartnum<=RD_MAX_CART_NUMBER)) {
-      sql+=QString().sprintf("TYPE=%u,",RDLogLine::Cart)+
-	"EXT_DATA=\""+data_buf.trimmed()+"\","+
-	"EXT_EVENT_ID=\""+eventid_buf.trimmed()+"\","+
-	"EXT_ANNC_TYPE=\""+annctype_buf.trimmed()+"\","+
-	"EXT_CART_NAME=\""+cartname.trimmed()+"\","+
-	QString().sprintf("CART_NUMBER=%u,",cartnum)+
-	"TITLE=\""+RDEscapeString(title)+"\"";
-      RDSqlQuery::apply(sql);
+      line.type=RDLogLine::Cart;
+      line.ext_data=data_buf.trimmed();
+      line.ext_event_id=eventid_buf.trimmed();
+      line.ext_annc_type=annctype_buf.trimmed();
+      line.ext_cart_name=cartname.trimmed();
+      line.cart_number=cartnum;
+      line.title=title;
+      lines->push_back(line);
       line_id++;
       file_line++;
       continue;
@@ -679,8 +707,8 @@ bool RDSvc::import(ImportSource src,const QDate &date,const QString &break_str,
     //
     if((src==RDSvc::Music)&&(!break_str.isEmpty())) {
       if(str_buf.contains(break_str)) {
-	sql+=QString().sprintf("TYPE=%u ",RDLogLine::TrafficLink);
-	RDSqlQuery::apply(sql);
+	line.type=RDLogLine::TrafficLink;
+	lines->push_back(line);
 	line_id++;
 	file_line++;
 	continue;
@@ -691,17 +719,17 @@ bool RDSvc::import(ImportSource src,const QDate &date,const QString &break_str,
     // Track Marker
     //
     if((!track_str.isEmpty())&&(str_buf.contains(track_str))) {
-      sql+=QString().sprintf("TYPE=%u,",RDLogLine::Track);
+      line.type=RDLogLine::Track;
       switch(inherit) {
       case RDSvc::ParentEvent:
-	sql+="TITLE=\""+RDEscapeString(str_buf.simplified().trimmed())+"\"";
+	line.title=str_buf.simplified().trimmed();
 	break;
 
       case RDSvc::SchedFile:
-	sql+="TITLE=\""+RDEscapeString(title)+"\"";
+	line.title=title;
 	break;
       }
-      RDSqlQuery::apply(sql);
+      lines->push_back(line);
       line_id++;
       file_line++;
       continue;
@@ -711,17 +739,17 @@ bool RDSvc::import(ImportSource src,const QDate &date,const QString &break_str,
     // Label/Note Cart
     //
     if((!label_cart.isEmpty())&&(str_buf.contains(label_cart))) {
-      sql+=QString().sprintf("TYPE=%u,",RDLogLine::Marker);
+      line.type=RDLogLine::Marker;
       switch(inherit) {
       case RDSvc::ParentEvent:
-	sql+="TITLE=\""+RDEscapeString(str_buf.simplified().trimmed())+"\"";
+	line.title=str_buf.simplified().trimmed();
 	break;
 
       case RDSvc::SchedFile:
-	sql+="TITLE=\""+RDEscapeString(title)+"\"";
+	line.title=title;
 	break;
       }
-      RDSqlQuery::apply(sql);
+      lines->push_back(line);
       line_id++;
       file_line++;
       continue;
@@ -738,67 +766,43 @@ bool RDSvc::import(ImportSource src,const QDate &date,const QString &break_str,
   //
   // Resolve Implied Start Time/Duration for Inline Events
   //
-  if(resolve_implied_times&&subEventInheritance()==RDSvc::ParentEvent) {
+  if(resolve_implied_times&&(inherit==RDSvc::ParentEvent)) {
     int prev_hour=0;
     int prev_secs=0;
     int prev_length=0;
-    QList<unsigned> prev_ids;
+    std::vector<unsigned> prev_lines;
 
-    sql=QString("select ")+
-      "ID,"+          // 00
-      "START_HOUR,"+  // 01
-      "START_SECS,"+  // 02
-      "LENGTH "+      // 03
-      "from IMPORTER_LINES where "+
-      "STATION_NAME=\""+RDEscapeString(svc_station->name())+"\" && "+
-      QString().sprintf("PROCESS_ID=%d ",getpid())+
-      "order by FILE_LINE";
-    q=new RDSqlQuery(sql);
-    while(q->next()) {
-      if((!q->value(1).isNull())&&(!q->value(2).isNull())&&
-	 (!q->value(3).isNull())) {
-	if(prev_ids.size()>0) {
-	  int len=1000*(q->value(2).toInt()-prev_secs)-prev_length;
+    for(unsigned i=0;i<lines->size();i++) {
+      RDImportLine *l=&(lines->at(i));
+      if(l->hasTiming()) {
+	if(prev_lines.size()>0) {
+	  int len=1000*(l->start_secs-prev_secs)-prev_length;
 	  if(len<0) {
 	    len=0;
 	  }
-	  sql=QString("update IMPORTER_LINES set ")+
-	    QString().sprintf("START_HOUR=%d,",prev_hour)+
-	    QString().sprintf("START_SECS=%d,",prev_secs+prev_length/1000)+
-	    QString().sprintf("LENGTH=%d ",len)+
-	    "where ";
-	  for(int i=0;i<prev_ids.size();i++) {
-	    sql+=QString().sprintf("(ID=%u)||",prev_ids.at(i));
+	  for(unsigned j=0;j<prev_lines.size();j++) {
+	    lines->at(prev_lines.at(j)).start_hour=prev_hour;
+	    lines->at(prev_lines.at(j)).start_secs=prev_secs+prev_length/1000;
+	    lines->at(prev_lines.at(j)).length=len;
 	  }
-	  sql=sql.left(sql.length()-2);
-	  RDSqlQuery::apply(sql);
-	  prev_ids.clear();
+	  prev_lines.clear();
 	}
-	prev_hour=q->value(1).toInt();
-	prev_secs=q->value(2).toInt();
-	prev_length=q->value(3).toInt();
+	prev_hour=l->start_hour;
+	prev_secs=l->start_secs;
+	prev_length=l->length;
       }
       else {
-	prev_ids.push_back(q->value(0).toUInt());
+	prev_lines.push_back(i);
       }
     }
-    delete q;
 
     //
     // Handle trailing implied start time events
     //
-    if(prev_ids.size()>0) {
-      sql=QString("update IMPORTER_LINES set ")+
-	QString().sprintf("START_HOUR=%d,",prev_hour)+
-	QString().sprintf("START_SECS=%d,",prev_secs+prev_length/1000)+
-	"LENGTH=0 "+
-	"where ";
-      for(int i=0;i<prev_ids.size();i++) {
-	sql+=QString().sprintf("(ID=%u)||",prev_ids.at(i));
-      }
-      sql=sql.left(sql.length()-2);
-      RDSqlQuery::apply(sql);
-      prev_ids.clear();
+    for(unsigned j=0;j<prev_lines.size();j++) {
+      lines->at(prev_lines.at(j)).start_hour=prev_hour;
+      lines->at(prev_lines.at(j)).start_secs=prev_secs+prev_length/1000;
+      lines->at(prev_lines.at(j)).length=0;
     }
   }
 
@@ -806,6 +810,30 @@ bool RDSvc::import(ImportSource src,const QDate &date,const QString &break_str,
 }
 
 
+RDSvc::ImportMethod RDSvc::importMethod() const
+{
+  return svc_import_method;
+}
+
+
+void RDSvc::setImportMethod(RDSvc::ImportMethod method)
+{
+  svc_import_method=method;
+}
+
+
+RDLogTemplateCache *RDSvc::templateCache() const
+{
+  return svc_template_cache;
+}
+
+
+void RDSvc::setTemplateCache(RDLogTemplateCache *cache)
+{
+  svc_template_cache=cache;
+}
+
+
 bool RDSvc::generateLog(const QDate &date,const QString &logname,
 			const QString &nextname,QString *report,RDUser *user,
 			QString *err_msg)
@@ -851,6 +879,17 @@ bool RDSvc::generateLog(const QDate &date,const QString &logname,
   // Generate Events
   //
   for(int i=0;i<24;i++) {
+    if(svc_template_cache!=NULL) {
+      QString clockname=
+	svc_template_cache->clockName(svc_name,24*(date.dayOfWeek()-1)+i);
+      if(!clockname.isEmpty()) {
+	clock.setName(clockname);
+	clock.generateLog(i,logname,svc_name,report,svc_template_cache);
+	clock.clear();
+      }
+      emit generationProgress(1+i);
+      continue;
+    }
     sql=QString("select CLOCK_NAME from SERVICE_CLOCKS where ")+
       "(SERVICE_NAME=\""+RDEscapeString(svc_name)+"\")&&"+
       QString().sprintf("(HOUR=%d)",24*(date.dayOfWeek()-1)+i);
@@ -968,23 +1007,44 @@ bool RDSvc::linkLog(RDSvc::ImportSource src,const QDate &date,
   //
   // Import File
   //
-  if(!import(src,date,breakString(),trackString(src),true)) {
+  std::vector<RDImportLine> lines;
+  QTime timer;
+  int parse_msecs=0;
+  int resolve_msecs=0;
+  int stage_msecs=0;
+  int merge_msecs=0;
+  timer.start();
+  if(!import(src,date,breakString(),trackString(src),true,&lines)) {
     *err_msg=tr("Import failed");
     delete log_lock;
     return false;
   }
+  parse_msecs=timer.restart();
 
   //
   // Resolve embedded link parameters
   //
   if(src==RDSvc::Music) {
-    if(!ResolveInlineEvents(logname,err_msg)) {
+    if(!ResolveInlineEvents(logname,&lines,err_msg)) {
       delete log_lock;
       *err_msg=tr("Import file")+": \""+importFilename(src,date)+"\"\n\n"+
 	*err_msg;
       return false;
     }
   }
+  resolve_msecs=timer.restart();
+
+  //
+  // Stage the Import
+  //
+  if(svc_import_method==RDSvc::StagedImport) {
+    if(!StageImport(lines,err_msg)) {
+      delete log_lock;
+      return false;
+    }
+    LoadImport(&lines);
+    stage_msecs=timer.restart();
+  }
 
   //
   // Iterate Through the Log
@@ -998,8 +1058,8 @@ bool RDSvc::linkLog(RDSvc::ImportSource src,const QDate &date,
       RDEventLine *e=new RDEventLine(svc_station);
       e->setName(logline->linkEventName());
       e->load();
-      e->linkLog(dest_event,log,svc_name,logline,track_str,label_cart,
-		 track_cart,&autofill_errors);
+      e->linkLog(dest_event,log,svc_name,logline,&lines,track_str,
+		 label_cart,track_cart,&autofill_errors);
       delete e;
       emit generationProgress(1+(24*current_link++)/total_links);
     }
@@ -1010,6 +1070,7 @@ bool RDSvc::linkLog(RDSvc::ImportSource src,const QDate &date,
     }
   }
   dest_event->save(svc_config);
+  merge_msecs=timer.restart();
 
   //
   // Update the Log Link Status
@@ -1032,45 +1093,41 @@ bool RDSvc::linkLog(RDSvc::ImportSource src,const QDate &date,
   dest_event->validate(&missing_report,date);
   bool event=false;
   QString link_report=tr("The following events were not placed:\n");
-  sql=QString("select ")+
-    "IMPORTER_LINES.START_HOUR,"+   // 00
-    "IMPORTER_LINES.START_SECS,"+   // 01
-    "IMPORTER_LINES.TYPE,"+         // 02
-    "IMPORTER_LINES.CART_NUMBER,"+  // 03
-    "IMPORTER_LINES.TITLE,"+        // 04
-    "CART.TITLE "+                  // 05
-    "from IMPORTER_LINES left join CART "+
-    "on IMPORTER_LINES.CART_NUMBER=CART.NUMBER where "+
-    "IMPORTER_LINES.STATION_NAME=\""+
-    RDEscapeString(svc_station->name())+"\" && "+
-    QString().sprintf("IMPORTER_LINES.PROCESS_ID=%u && ",getpid())+
-    "IMPORTER_LINES.EVENT_USED=\"N\" "+
-    "order by LINE_ID";
-  q=new RDSqlQuery(sql);
-  while(q->next()) {
+  for(unsigned i=0;i<lines.size();i++) {
+    const RDImportLine &line=lines.at(i);
+    if(line.event_used) {
+      continue;
+    }
     event=true;
 
     link_report+=QString("  ")+
-      RDSvc::timeString(q->value(0).toInt(),q->value(1).toInt());
-    switch((RDLogLine::Type)q->value(2).toUInt()) {
+      RDSvc::timeString(line.hasStartTime()?line.start_hour:0,
+			line.hasStartTime()?line.start_secs:0);
+    switch(line.type) {
     case RDLogLine::Cart:
     case RDLogLine::Macro:
-      if(q->value(5).toString().isEmpty()) {
-	cartname=q->value(4).toString();
+      sql=QString("select ")+
+	"TITLE "+  // 00
+	"from CART where "+
+	QString().sprintf("NUMBER=%u",line.cart_number);
+      q=new RDSqlQuery(sql);
+      if(q->first()&&(!q->value(0).toString().isEmpty())) {
+	cartname=q->value(0).toString();
       }
       else {
-	cartname=q->value(5).toString();
+	cartname=line.title;
       }
+      delete q;
       link_report+=
-	QString().sprintf(" - %06u - ",q->value(3).toUInt())+cartname+"\n";
+	QString().sprintf(" - %06u - ",line.cart_number)+cartname+"\n";
       break;
 
     case RDLogLine::Marker:
-      link_report+=" - "+tr("Note Cart")+": \""+q->value(4).toString()+"\"\n";
+      link_report+=" - "+tr("Note Cart")+": \""+line.title+"\"\n";
       break;
 
     case RDLogLine::Track:
-      link_report+=" - "+tr("Track")+": \""+q->value(4).toString()+"\"\n";
+      link_report+=" - "+tr("Track")+": \""+line.title+"\"\n";
       break;
 
     case RDLogLine::TrafficLink:
@@ -1083,11 +1140,10 @@ bool RDSvc::linkLog(RDSvc::ImportSource src,const QDate &date,
     case RDLogLine::Chain:
     case RDLogLine::UnknownType:
       link_report+=" - "+tr("Unexpected event")+" \""+
-	RDLogLine::typeText((RDLogLine::Type)q->value(2).toUInt())+"\"\n";
+	RDLogLine::typeText(line.type)+"\"\n";
       break;
     }
   }
-  delete q;
   link_report+="\n";
 
   //
@@ -1111,13 +1167,17 @@ bool RDSvc::linkLog(RDSvc::ImportSource src,const QDate &date,
   delete src_event;
   delete dest_event;
 
-  sql=QString("delete from IMPORTER_LINES where ")+
-    "STATION_NAME=\""+RDEscapeString(svc_station->name())+"\" && "+
-    QString().sprintf("PROCESS_ID=%u",getpid());
-  //  printf("Importer Table Cleanup SQL: %s\n",(const char *)sql);
-  RDSqlQuery::apply(sql);
+  if(svc_import_method==RDSvc::StagedImport) {
+    ClearImport();
+  }
   delete log_lock;
 
+  rda->syslog(LOG_DEBUG,"linked %lu %s lines into log \"%s\": "
+	      "parse %d mS, resolve %d mS, stage %d mS, merge %d mS",
+	      lines.size(),(src==RDSvc::Music)?"music":"traffic",
+	      (const char *)logname.toUtf8(),parse_msecs,resolve_msecs,
+	      stage_msecs,merge_msecs);
+
   return true;
 }
 
@@ -1792,15 +1852,15 @@ QString RDSvc::MakeErrorLine(int indent,unsigned lineno,const QString &msg)
 }
 
 
-bool RDSvc::ResolveInlineEvents(const QString &logname,QString *err_msg)
-  const
+bool RDSvc::ResolveInlineEvents(const QString &logname,
+				std::vector<RDImportLine> *lines,
+				QString *err_msg) const
 {
   RDLogEvent *evt=NULL;
   RDLogLine *logline=NULL;
   QTime start;
-  QTime end;
-  QString sql;
-  RDSqlQuery *q=NULL;
+  int start_secs=0;
+  std::vector<unsigned> breaks;
   bool ok=false;
 
   switch(subEventInheritance()) {
@@ -1812,39 +1872,33 @@ bool RDSvc::ResolveInlineEvents(const QString &logname,QString *err_msg)
       logline=evt->logLine(i);
       if(logline->type()==RDLogLine::MusicLink) {
 	start=logline->linkStartTime();
-	end=logline->linkStartTime().addSecs(logline->linkLength());
-	sql=QString("select ")+
-	  "ID,"+          // 00
-	  "FILE_LINE "+   // 01
-	  "from IMPORTER_LINES where "+
-	  "IMPORTER_LINES.STATION_NAME=\""+
-	  RDEscapeString(svc_station->name())+"\" && "+
-	  QString().sprintf("IMPORTER_LINES.PROCESS_ID=%u && ",getpid())+
-	  QString().sprintf("TYPE=%u && ",RDLogLine::TrafficLink)+
-	  QString().sprintf("START_HOUR=%d && ",start.hour())+
-	  QString().sprintf("START_SECS>=%d && ",
-			    60*start.minute()+start.second())+
-	  QString().sprintf("START_SECS<%d",60*start.minute()+start.second()+logline->linkLength()/1000);
-	q=new RDSqlQuery(sql);
-	if(q->size()>1) {
+	start_secs=60*start.minute()+start.second();
+	breaks.clear();
+	for(unsigned j=0;j<lines->size();j++) {
+	  const RDImportLine &line=lines->at(j);
+	  if((line.type==RDLogLine::TrafficLink)&&
+	     (line.start_hour==start.hour())&&
+	     (line.start_secs>=start_secs)&&
+	     (line.start_secs<start_secs+logline->linkLength()/1000)) {
+	    breaks.push_back(j);
+	  }
+	}
+	if(breaks.size()>1) {
 	  *err_msg+=tr("In event")+" \""+logline->linkEventName()+"\"@"+
 	    logline->startTime(RDLogLine::Logged).toString("hh:mm:ss")+":\n";
-	  while(q->next()) {
-	    *err_msg+=MakeErrorLine(4,q->value(1).toUInt(),
+	  for(unsigned j=0;j<breaks.size();j++) {
+	    *err_msg+=MakeErrorLine(4,lines->at(breaks.at(j)).file_line,
 				    tr("multiple inline traffic breaks not permitted within the same music event"));
 	  }
 	  *err_msg+="\n";
 	  ok=false;
 	}
-	if(q->first()) {
-	  sql=QString("update IMPORTER_LINES set ")+
-	    "LINK_START_TIME=\""+
-	    logline->linkStartTime().toString("hh:mm:ss")+"\","+
-	    QString().sprintf("LINK_LENGTH=%d where ",logline->linkLength())+
-	    QString().sprintf("ID=%u",q->value(0).toUInt());
-	  RDSqlQuery::apply(sql);
+	if(breaks.size()>0) {
+	  RDImportLine *line=&(lines->at(breaks.at(0)));
+	  line->link_start_time=
+	    QTime(start.hour(),start.minute(),start.second());
+	  line->link_length=logline->linkLength();
 	}
-	delete q;
       }
     }
     delete evt;
@@ -1860,34 +1914,29 @@ bool RDSvc::ResolveInlineEvents(const QString &logname,QString *err_msg)
     // Verify that all inline traffic and voicetrack events have explicit
     // start times and length
     //
-    sql=QString("select ")+
-      "FILE_LINE,"+   // 00
-      "TYPE "+        // 01
-      "from IMPORTER_LINES where "+
-      "IMPORTER_LINES.STATION_NAME=\""+
-      RDEscapeString(svc_station->name())+"\" && "+
-      QString().sprintf("IMPORTER_LINES.PROCESS_ID=%u && ",getpid())+
-      QString().sprintf("((TYPE=%u) || ",RDLogLine::TrafficLink)+
-      QString().sprintf("(TYPE=%u) ||",RDLogLine::Marker)+
-      QString().sprintf("(TYPE=%u)) && ",RDLogLine::Track)+
-      "(START_HOUR is null || START_SECS is null || LENGTH is null)";
     ok=true;
-    q=new RDSqlQuery(sql);
-    while(q->next()) {
-      switch((RDLogLine::Type)q->value(1).toUInt()) {
+    for(unsigned i=0;i<lines->size();i++) {
+      const RDImportLine &line=lines->at(i);
+      if(line.hasTiming()) {
+	continue;
+      }
+      switch(line.type) {
       case RDLogLine::Marker:
-	*err_msg+=MakeErrorLine(0,q->value(0).toUInt(),
+	*err_msg+=MakeErrorLine(0,line.file_line,
 			       tr("invalid start time and/or length on note cart."));
+	ok=false;
 	break;
 
       case RDLogLine::TrafficLink:
-	*err_msg+=MakeErrorLine(0,q->value(0).toUInt(),
+	*err_msg+=MakeErrorLine(0,line.file_line,
 			       tr("invalid start time and/or length on inline traffic break."));
+	ok=false;
 	break;
 
       case RDLogLine::Track:
-	*err_msg+=MakeErrorLine(0,q->value(0).toUInt(),
+	*err_msg+=MakeErrorLine(0,line.file_line,
 			       tr("invalid start time and/or length on track marker."));
+	ok=false;
 	break;
 
       case RDLogLine::Cart:
@@ -1897,14 +1946,9 @@ bool RDSvc::ResolveInlineEvents(const QString &logname,QString *err_msg)
       case RDLogLine::Chain:
       case RDLogLine::MusicLink:
       case RDLogLine::UnknownType:
-	*err_msg+=MakeErrorLine(0,q->value(0).toUInt(),
-			       tr("unexpected event type")+
-			       " \""+RDLogLine::typeText((RDLogLine::Type)q->value(1).toUInt())+"\"");
 	break;
       }
-      ok=false;
     }
-    delete q;
     if(!ok) {
       return false;
     }
@@ -1912,25 +1956,165 @@ bool RDSvc::ResolveInlineEvents(const QString &logname,QString *err_msg)
     //
     // Resolve link parameters
     //
-    sql=QString("select ")+
-      "ID,"+          // 00
-      "START_HOUR,"+  // 01
-      "START_SECS,"+  // 02
-      "LENGTH "+      // 03
-      "from IMPORTER_LINES where "+
-      QString().sprintf("TYPE=%u",RDLogLine::TrafficLink);
-    q=new RDSqlQuery(sql);
-    while(q->next()) {
-      sql=QString("update IMPORTER_LINES set ")+
-	"LINK_START_TIME=\""+QTime(q->value(1).toInt(),0,0).
-	addSecs(q->value(2).toInt()).toString("hh:mm:ss")+"\","+
-	QString().sprintf("LINK_LENGTH=%d where ",q->value(3).toInt())+
-	QString().sprintf("ID=%u",q->value(0).toUInt());
-      RDSqlQuery::apply(sql);
+    for(unsigned i=0;i<lines->size();i++) {
+      RDImportLine *line=&(lines->at(i));
+      if(line->type==RDLogLine::TrafficLink) {
+	line->link_start_time=
+	  QTime(line->start_hour,0,0).addSecs(line->start_secs);
+	line->link_length=line->length;
+      }
     }
-    delete q;
     break;
   }
 
   return true;
 }
+
+
+void RDSvc::ClearImport() const
+{
+  QString sql=QString("delete from IMPORTER_LINES where ")+
+    "STATION_NAME=\""+RDEscapeString(svc_station->name())+"\" && "+
+    QString().sprintf("PROCESS_ID=%u",getpid());
+  RDSqlQuery::apply(sql);
+}
+
+
+bool RDSvc::StageImport(const std::vector<RDImportLine> &lines,
+			QString *err_msg) const
+{
+  QString sql;
+  QString values;
+  QString station=RDEscapeString(svc_station->name());
+  unsigned count=0;
+
+  ClearImport();
+  if(!RDSqlQuery::apply("start transaction",err_msg)) {
+    return false;
+  }
+  for(unsigned i=0;i<lines.size();i++) {
+    const RDImportLine &line=lines.at(i);
+    values+=QString("(\"")+station+"\","+
+      QString().sprintf("%u,%u,%d,",getpid(),line.file_line,line.line_id)+
+      StageValue(line.start_hour)+","+
+      StageValue(line.start_secs)+","+
+      StageValue(line.length)+","+
+      QString().sprintf("%u,",line.type)+
+      StageValue(line.cart_number==0?-1:(int)line.cart_number)+","+
+      StageValue(line.title)+","+
+      StageValue(line.ext_data)+","+
+      StageValue(line.ext_event_id)+","+
+      StageValue(line.ext_annc_type)+","+
+      StageValue(line.ext_cart_name)+",";
+    if(line.link_start_time.isValid()) {
+      values+="\""+line.link_start_time.toString("hh:mm:ss")+"\",";
+    }
+    else {
+      values+="NULL,";
+    }
+    values+=StageValue(line.link_length)+"),";
+    if((++count==RDSVC_IMPORT_STAGE_ROWS)||(i==(lines.size()-1))) {
+      sql=QString("insert into IMPORTER_LINES (")+
+	"STATION_NAME,"+
+	"PROCESS_ID,"+
+	"FILE_LINE,"+
+	"LINE_ID,"+
+	"START_HOUR,"+
+	"START_SECS,"+
+	"LENGTH,"+
+	"TYPE,"+
+	"CART_NUMBER,"+
+	"TITLE,"+
+	"EXT_DATA,"+
+	"EXT_EVENT_ID,"+
+	"EXT_ANNC_TYPE,"+
+	"EXT_CART_NAME,"+
+	"LINK_START_TIME,"+
+	"LINK_LENGTH) values "+
+	values.left(values.length()-1);
+      if(!RDSqlQuery::apply(sql,err_msg)) {
+	RDSqlQuery::apply("rollback");
+	return false;
+      }
+      values="";
+      count=0;
+    }
+  }
+
+  return RDSqlQuery::apply("commit",err_msg);
+}
+
+
+void RDSvc::LoadImport(std::vector<RDImportLine> *lines) const
+{
+  RDImportLine line;
+
+  lines->clear();
+  QString sql=QString("select ")+
+    "FILE_LINE,"+        // 00
+    "LINE_ID,"+          // 01
+    "START_HOUR,"+       // 02
+    "START_SECS,"+       // 03
+    "LENGTH,"+           // 04
+    "TYPE,"+             // 05
+    "CART_NUMBER,"+      // 06
+    "TITLE,"+            // 07
+    "EXT_DATA,"+         // 08
+    "EXT_EVENT_ID,"+     // 09
+    "EXT_ANNC_TYPE,"+    // 10
+    "EXT_CART_NAME,"+    // 11
+    "LINK_START_TIME,"+  // 12
+    "LINK_LENGTH "+      // 13
+    "from IMPORTER_LINES where "+
+    "STATION_NAME=\""+RDEscapeString(svc_station->name())+"\" && "+
+    QString().sprintf("PROCESS_ID=%u ",getpid())+
+    "order by LINE_ID";
+  RDSqlQuery *q=new RDSqlQuery(sql);
+  while(q->next()) {
+    line.clear();
+    line.file_line=q->value(0).toUInt();
+    line.line_id=q->value(1).toInt();
+    if(!q->value(2).isNull()) {
+      line.start_hour=q->value(2).toInt();
+    }
+    if(!q->value(3).isNull()) {
+      line.start_secs=q->value(3).toInt();
+    }
+    if(!q->value(4).isNull()) {
+      line.length=q->value(4).toInt();
+    }
+    line.type=(RDLogLine::Type)q->value(5).toUInt();
+    line.cart_number=q->value(6).toUInt();
+    line.title=q->value(7).toString();
+    line.ext_data=q->value(8).toString();
+    line.ext_event_id=q->value(9).toString();
+    line.ext_annc_type=q->value(10).toString();
+    line.ext_cart_name=q->value(11).toString();
+    if(!q->value(12).isNull()) {
+      line.link_start_time=q->value(12).toTime();
+    }
+    if(!q->value(13).isNull()) {
+      line.link_length=q->value(13).toInt();
+    }
+    lines->push_back(line);
+  }
+  delete q;
+}
+
+
+QString RDSvc::StageValue(int value)
+{
+  if(value<0) {
+    return QString("NULL");
+  }
+  return QString().sprintf("%d",value);
+}
+
+
+QString RDSvc::StageValue(const QString &str)
+{
+  if(str.isNull()) {
+    return QString("NULL");
+  }
+  return "\""+RDEscapeString(str)+"\"";
+}
@@ -2,7 +2,7 @@
 //
 // Abstract a Rivendell Service
 //
-//   (C) Copyright 2002-2004,2016-2017 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2004,2016-2017,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -27,6 +27,8 @@
 #include <qsqldatabase.h>
 
 #include "rdconfig.h"
+#include "rdimportline.h"
+#include "rdlogtemplatecache.h"
 #include "rdloglock.h"
 #include "rdstation.h"
 #include "rduser.h"
@@ -41,6 +43,7 @@ class RDSvc : public QObject
 		    LengthHours=10,LengthMinutes=11,LengthSeconds=12};
   enum ShelflifeOrigin {OriginAirDate=0,OriginCreationDate=1};
   enum SubEventInheritance {ParentEvent=0,SchedFile=1};
+  enum ImportMethod {DirectImport=0,StagedImport=1};
   RDSvc(QString svcname,RDStation *station,RDConfig *config,QObject *parent=0);
   QString name() const;
   bool exists() const;
@@ -91,6 +94,13 @@ class RDSvc : public QObject
   QString importFilename(ImportSource src,const QDate &date) const;
   bool import(ImportSource src,const QDate &date,const QString &break_str,
 	      const QString &track_str,bool resolve_implied_times) const;
+  bool import(ImportSource src,const QDate &date,const QString &break_str,
+	      const QString &track_str,bool resolve_implied_times,
+	      std::vector<RDImportLine> *lines) const;
+  RDSvc::ImportMethod importMethod() const;
+  void setImportMethod(RDSvc::ImportMethod method);
+  RDLogTemplateCache *templateCache() const;
+  void setTemplateCache(RDLogTemplateCache *cache);
   bool generateLog(const QDate &date,const QString &logname,
 		   const QString &nextname,QString *report,RDUser *user,
 		   QString *err_msg);
@@ -121,10 +131,20 @@ class RDSvc : public QObject
 			QString *label_cart,QString *track_cart);
   bool CheckId(std::vector<int> *v,int value);
   QString MakeErrorLine(int indent,unsigned lineno,const QString &msg) const;
-  bool ResolveInlineEvents(const QString &logname,QString *err_msg) const;
+  bool ResolveInlineEvents(const QString &logname,
+			   std::vector<RDImportLine> *lines,
+			   QString *err_msg) const;
+  void ClearImport() const;
+  bool StageImport(const std::vector<RDImportLine> &lines,
+		   QString *err_msg) const;
+  void LoadImport(std::vector<RDImportLine> *lines) const;
+  static QString StageValue(int value);
+  static QString StageValue(const QString &str);
   QString svc_name;
   RDStation *svc_station;
   RDConfig *svc_config;
+  RDSvc::ImportMethod svc_import_method;
+  RDLogTemplateCache *svc_template_cache;
 };
 
 
@@ -2,7 +2,7 @@
 //
 // System-wide Rivendell settings
 //
-//   (C) Copyright 2009,2016 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2009,2016,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -22,6 +22,7 @@
 #include "rddb.h"
 #include "rdconf.h"
 #include "rdescape_string.h"
+#include "rdsnapshot.h"
 #include "rdsystem.h"
 #include "rdweb.h"
 
@@ -229,6 +230,10 @@ QString RDSystem::xml() const
 QVariant RDSystem::GetValue(const QString &field) const
 {
   QVariant ret;
+
+  if(RDSnapshot::value("SYSTEM","",QVariant(),field,&ret)) {
+    return ret;
+  }
   QString sql=QString("select ")+
     field+" from SYSTEM";
   RDSqlQuery *q=new RDSqlQuery(sql);
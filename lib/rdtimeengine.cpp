@@ -2,7 +2,7 @@
 //
 //   An event timer engine.
 //
-//   (C) Copyright 2002-2004,2016 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2004,2016,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU Library General Public License 
@@ -19,13 +19,23 @@
 //
 
 #include <stdlib.h>
+#include <time.h>
 
 #include <rdtimeengine.h>
 
+//
+// Events scheduled within this interval before the last batch fired are
+// not scheduled again until the following day (mS)
+//
+#define RDTIMEENGINE_REFIRE_GUARD 1000
+
 RDTimeEngine::RDTimeEngine(QObject *parent)
   : QObject(parent)
 {
   engine_pending_id=-1;
+  engine_pending_msecs=-1;
+  engine_fired_msecs=-1;
+  engine_deadline=0;
   engine_timer=new QTimer(this,"engine_timer");
   engine_time_offset=0;
   connect(engine_timer,SIGNAL(timeout()),this,SLOT(timerData()));
@@ -43,20 +53,19 @@ void RDTimeEngine::clear()
 {
   engine_time_offset=0;
   engine_events.clear();
+  engine_ids.clear();
   SetTimer();
 }
 
 
 QTime RDTimeEngine::event(int id) const
 {
-  for(unsigned i=0;i<engine_events.size();i++) {
-    for(int j=0;j<engine_events[i].size();j++) {
-      if(id==engine_events[i].id(j)) {
-	return engine_events[i].time();
-      }
-    }
+  std::map<int,EventMap::iterator>::const_iterator it=engine_ids.find(id);
+
+  if(it==engine_ids.end()) {
+    return QTime();
   }
-  return QTime();
+  return QTime(0,0,0).addMSecs(it->second->first);
 }
 
 
@@ -75,37 +84,31 @@ void RDTimeEngine::setTimeOffset(int msecs)
 
 void RDTimeEngine::addEvent(int id,QTime time)
 {
-  for(unsigned i=0;i<engine_events.size();i++) {
-    if(time==engine_events[i].time()) {
-      engine_events[i].addId(id);
-      SetTimer();
-      return;
-    }
+  std::map<int,EventMap::iterator>::iterator it=engine_ids.find(id);
+
+  //
+  // An id can be scheduled only once, so adding it again moves it
+  //
+  if(it!=engine_ids.end()) {
+    engine_events.erase(it->second);
+    engine_ids.erase(it);
   }
-  engine_events.push_back(RDTimeEvent());
-  engine_events.back().setTime(time);
-  engine_events.back().addId(id);
+  engine_ids[id]=engine_events.
+    insert(std::pair<int,int>(QTime(0,0,0).msecsTo(time),id));
   SetTimer();
 }
 
 
 void RDTimeEngine::removeEvent(int id)
 {
-  for(unsigned i=0;i<engine_events.size();i++) {
-    for(int j=0;j<engine_events[i].size();j++) {
-      if(id==engine_events[i].id(j)) {
-	if(engine_events[i].size()==1) {
-	  std::vector<RDTimeEvent>::iterator it=engine_events.begin()+i;
-	  engine_events.erase(it,it+1);
-	}
-	else {
-	  engine_events[i].removeId(j);
-	}
-	SetTimer();
-	return;
-      }
-    }
+  std::map<int,EventMap::iterator>::iterator it=engine_ids.find(id);
+
+  if(it==engine_ids.end()) {
+    return;
   }
+  engine_events.erase(it->second);
+  engine_ids.erase(it);
+  SetTimer();
 }
 
 
@@ -115,61 +118,125 @@ int RDTimeEngine::next() const
 }
 
 
+unsigned RDTimeEngine::size() const
+{
+  return engine_ids.size();
+}
+
+
 void RDTimeEngine::timerData()
 {
-  for(unsigned i=0;i<engine_events.size();i++) {
-    for(int j=0;j<engine_events[i].size();j++) {
-      if(engine_pending_id==engine_events[i].id(j)) {
-	EmitEvents(i);
-	SetTimer();
-	return;
-      }
-    }
+  uint64_t now=MonotonicMsecs();
+
+  //
+  // Guard against the timer expiring ahead of its deadline
+  //
+  if(now<engine_deadline) {
+    engine_timer->start(engine_deadline-now,true);
+    return;
   }
+  engine_fired_msecs=CurrentMsecs();
+  EmitEvents(engine_pending_msecs,engine_fired_msecs);
+  SetTimer();
 }
 
 
-void RDTimeEngine::EmitEvents(int offset)
+void RDTimeEngine::EmitEvents(int from,int to)
 {
-//  for(int i=0;i<engine_events[offset].size();i++) {
-  for(int i=engine_events[offset].size()-1;i>=0;i--) {
-    emit timeout(engine_events[offset].id(i));
+  std::vector<int> ids;
+  std::vector<EventMap::iterator> ranges;
+
+  //
+  // Everything from the pending event up to the current time fires as
+  // a single batch, including events falling due while the timer was
+  // running late.
+  //
+  if(from<=to) {
+    ranges.push_back(engine_events.lower_bound(from));
+    ranges.push_back(engine_events.upper_bound(to));
+  }
+  else {
+    if((from-to)>43200000) {  // Passed midnight
+      ranges.push_back(engine_events.lower_bound(from));
+      ranges.push_back(engine_events.end());
+      ranges.push_back(engine_events.begin());
+      ranges.push_back(engine_events.upper_bound(to));
+    }
+    else {                    // Clock stepped backwards
+      ranges.push_back(engine_events.lower_bound(from));
+      ranges.push_back(engine_events.upper_bound(from));
+    }
+  }
+  for(unsigned i=0;i<ranges.size();i+=2) {
+    EventMap::iterator it=ranges[i];
+    while(it!=ranges[i+1]) {
+      EventMap::iterator end=engine_events.upper_bound(it->first);
+      EventMap::iterator last=end;
+      do {
+	--last;
+	ids.push_back(last->second);
+      } while(last!=it);
+      it=end;
+    }
+  }
+
+  //
+  // Slots may add or remove events, so check that each is still
+  // scheduled before emitting it.
+  //
+  for(unsigned i=0;i<ids.size();i++) {
+    if(engine_ids.find(ids[i])!=engine_ids.end()) {
+      emit timeout(ids[i]);
+    }
   }
 }
 
 
 void RDTimeEngine::SetTimer()
 {
+  EventMap::iterator it;
+  int diff;
+
   engine_timer->stop();
+  engine_pending_id=-1;
+  engine_pending_msecs=-1;
   if(engine_events.size()==0) {
     return;
   }
-  QTime current_time=QTime::currentTime().addMSecs(engine_time_offset);
-  int diff=GetNextDiff(current_time,&engine_pending_id);
-  if(diff!=86400001) {
-    engine_timer->start(diff,true);
-    return;
+  int now=CurrentMsecs();
+  if((now<=engine_fired_msecs)&&
+     ((engine_fired_msecs-now)<RDTIMEENGINE_REFIRE_GUARD)) {
+    it=engine_events.upper_bound(engine_fired_msecs);
   }
-  diff=GetNextDiff(QTime(),&engine_pending_id);
-  if(diff!=86400001) {
-    diff+=(current_time.msecsTo(QTime(23,59,59))+1000);
-    engine_timer->start(diff,true);
-    return;
+  else {
+    it=engine_events.lower_bound(now);
   }
+  if(it==engine_events.end()) {
+    it=engine_events.begin();
+    diff=86400000-now+it->first;
+  }
+  else {
+    diff=it->first-now;
+  }
+  engine_pending_msecs=it->first;
+  engine_pending_id=it->second;
+  engine_deadline=MonotonicMsecs()+diff;
+  engine_timer->start(diff,true);
 }
 
 
-int RDTimeEngine::GetNextDiff(QTime time,int *pending_id)
+int RDTimeEngine::CurrentMsecs() const
 {
-  int diff=86400001;
-  *pending_id=-1;
-
-  for(unsigned i=0;i<engine_events.size();i++) {
-    if(((time.msecsTo(engine_events[i].time()))>=0)&&
-       (time.msecsTo(engine_events[i].time())<diff)) {
-      diff=time.msecsTo(engine_events[i].time());
-      *pending_id=engine_events[i].id(0);
-    }
-  }
-  return diff;
+  return QTime(0,0,0).
+    msecsTo(QTime::currentTime().addMSecs(engine_time_offset));
+}
+
+
+uint64_t RDTimeEngine::MonotonicMsecs()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return 1000*(uint64_t)ts.tv_sec+(uint64_t)ts.tv_nsec/1000000;
 }
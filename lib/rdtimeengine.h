@@ -2,7 +2,7 @@
 //
 //   An event timer engine.
 //
-//   (C) Copyright 2002,2016 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002,2016,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU Library General Public License 
@@ -21,14 +21,15 @@
 #ifndef RDTIMEENGINE_H
 #define RDTIMEENGINE_H
 
+#include <stdint.h>
+
+#include <map>
 #include <vector>
 
 #include <qwidget.h>
 #include <qdatetime.h>
 #include <qtimer.h>
 
-#include <rdtimeevent.h>
-
 class RDTimeEngine : public QObject
 {
   Q_OBJECT
@@ -42,6 +43,7 @@ class RDTimeEngine : public QObject
   void addEvent(int id,QTime time);
   void removeEvent(int id);
   int next() const;
+  unsigned size() const;
   
  signals:
   void timeout(int id);
@@ -50,12 +52,18 @@ class RDTimeEngine : public QObject
   void timerData();
 
  private:
-  void EmitEvents(int offset);
+  typedef std::multimap<int,int> EventMap;
+  void EmitEvents(int from,int to);
   void SetTimer();
-  int GetNextDiff(QTime time,int *pending_id);
+  int CurrentMsecs() const;
+  static uint64_t MonotonicMsecs();
   QTimer *engine_timer;
-  std::vector<RDTimeEvent> engine_events;
+  EventMap engine_events;
+  std::map<int,EventMap::iterator> engine_ids;
   int engine_pending_id;
+  int engine_pending_msecs;
+  int engine_fired_msecs;
+  uint64_t engine_deadline;
   int engine_time_offset;
 };
 
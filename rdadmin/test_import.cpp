@@ -2,7 +2,7 @@
 //
 // Test a Rivendell Log Import
 //
-//   (C) Copyright 2002-2020 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2020,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -191,55 +191,40 @@ void TestImport::importData()
 {
   RDListViewItem *item;
   int next_line=0;
+  std::vector<RDImportLine> lines;
 
   test_events_list->clear();
   if(!test_svc->import(test_src,test_date_edit->date(),test_svc->breakString(),
-		       test_svc->trackString(test_src),true)) {
+		       test_svc->trackString(test_src),true,&lines)) {
     QMessageBox::information(this,tr("Import Error"),
 			     tr("There was an error during import\nplease check your settings and try again."));
     return;
   }
-  QString sql=QString("select ")+
-    "START_HOUR,"+     // 00
-    "START_SECS,"+     // 01
-    "EXT_CART_NAME,"+  // 02
-    "LENGTH,"+         // 03
-    "EXT_DATA,"+       // 04
-    "EXT_EVENT_ID,"+   // 05
-    "EXT_ANNC_TYPE,"+  // 06
-    "TITLE,"+          // 07
-    "TYPE,"+           // 08
-    "FILE_LINE "+      // 09
-    "from IMPORTER_LINES where "+
-    "STATION_NAME=\""+RDEscapeString(rda->station()->name())+"\" && "+
-    QString().sprintf("PROCESS_ID=%u ",getpid())+
-    "order by LINE_ID";
-  RDSqlQuery *q=new RDSqlQuery(sql);
-  while(q->next()) {
+  for(unsigned i=0;i<lines.size();i++) {
+    const RDImportLine &line=lines.at(i);
     item=new RDListViewItem(test_events_list);
     item->setLine(next_line++);
-    if((!q->value(0).isNull())&&(!q->value(1).isNull())) {
-      item->setText(1,RDSvc::timeString(q->value(0).toInt(),
-					q->value(1).toInt()));
+    if(line.hasStartTime()) {
+      item->setText(1,RDSvc::timeString(line.start_hour,line.start_secs));
     }
-    if(!q->value(3).isNull()) {
-      item->setText(3,RDGetTimeLength(q->value(3).toInt(),false,false));
+    if(line.length>=0) {
+      item->setText(3,RDGetTimeLength(line.length,false,false));
     }
-    item->setText(5,q->value(4).toString().trimmed());
-    item->setText(6,q->value(5).toString().trimmed());
-    item->setText(7,q->value(6).toString().trimmed());
-    item->setText(8,QString().sprintf("%u",1+q->value(9).toUInt()));
-    switch((RDLogLine::Type)q->value(8).toUInt()) {
+    item->setText(5,line.ext_data.trimmed());
+    item->setText(6,line.ext_event_id.trimmed());
+    item->setText(7,line.ext_annc_type.trimmed());
+    item->setText(8,QString().sprintf("%u",1+line.file_line));
+    switch(line.type) {
     case RDLogLine::Cart:
       item->setPixmap(0,*test_playout_map);
-      item->setText(2,q->value(2).toString());
-      item->setText(4,q->value(7).toString().trimmed());
+      item->setText(2,line.ext_cart_name);
+      item->setText(4,line.title.trimmed());
       break;
 
     case RDLogLine::Marker:
       item->setPixmap(0,*test_marker_map);
       item->setText(2,tr("NOTE"));
-      item->setText(4,q->value(7).toString().trimmed());
+      item->setText(4,line.title.trimmed());
       break;
 
     case RDLogLine::TrafficLink:
@@ -261,13 +246,6 @@ void TestImport::importData()
       break;
     }
   }
-  delete q;
-
-  sql=QString("delete from IMPORTER_LINES where ")+
-    "STATION_NAME=\""+RDEscapeString(rda->station()->name())+"\" && "+
-    QString().sprintf("PROCESS_ID=%u",getpid());
-  //  printf("IMPORTER_LINES cleanup SQL: %s\n",(const char *)sql);
-  RDSqlQuery::apply(sql);
 }
 
 
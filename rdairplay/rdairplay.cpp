@@ -2,7 +2,7 @@
 //
 // The On Air Playout Utility for Rivendell.
 //
-//   (C) Copyright 2002-2020 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -27,10 +27,13 @@
 #include <qmessagebox.h>
 #include <qtranslator.h>
 
+#include <rdcartsearchindex.h>
 #include <rdconf.h>
+#include <rdcutrotation.h>
 #include <rdgetpasswd.h>
 #include <rddatedecode.h>
 #include <rdescape_string.h>
+#include <rdmacrocartcache.h>
 
 #include "globals.h"
 #include "rdairplay.h"
@@ -746,6 +749,21 @@ MainWidget::MainWidget(RDConfig *config,QWidget *parent)
   //
   rda->ripc()->connectHost("localhost",RIPCD_TCP_PORT,rda->config()->password());
 
+  //
+  // Cut Rotation
+  //
+  new RDCutRotation(rda->ripc(),this);
+
+  //
+  // Cart Search Index
+  //
+  new RDCartSearchIndex(rda->ripc(),this);
+
+  //
+  // Macro Cart Cache
+  //
+  new RDMacroCartCache(rda->ripc(),this);
+
   //
   // (Perhaps) Lock Memory
   //
@@ -493,6 +493,12 @@ bool MainObject::Import(CatchEvent *evt)
   switch((conv_err=conv->convert())) {
   case RDAudioConvert::ErrorOk:
     CheckInRecording(evt->cutName(),evt,msecs,evt->trimThreshold());
+    if((evt->normalizeLevel()!=0)&&(conv->peakSample()>0.0)) {
+      rda->syslog(LOG_INFO,"normalized cut %s: peak: %5.2lf dBFS, "
+		  "loudness: %5.2lf LUFS",
+		  (const char *)evt->cutName().toUtf8(),
+		  20.0*log10(conv->peakSample()),conv->integratedLoudness());
+    }
     ret=true;
     break;
 
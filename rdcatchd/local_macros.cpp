@@ -2,7 +2,7 @@
 //
 // Local macros for the Rivendell netcatcher daemon
 //
-//   (C) Copyright 2002-2009,2016-2018 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2009,2016-2018,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -28,7 +28,6 @@
 
 void MainObject::RunLocalMacros(RDMacro *rml)
 {
-  RDCart *cart;
   RDCut *cut;
   RDDeck *deck;
   int chan;
@@ -111,14 +110,13 @@ void MainObject::RunLocalMacros(RDMacro *rml)
     break;
 
   case RDMacro::EX:
-    cart=new RDCart(rml->arg(0).toUInt());
-    if(cart->exists()) {
-      if(ExecuteMacroCart(cart)) {
+    cartnum=rml->arg(0).toUInt();
+    if(catch_macro_cache->exists(cartnum)) {
+      if(ExecuteMacroCart(cartnum)) {
 	if(rml->echoRequested()) {
 	  rml->acknowledge(true);
 	  rda->ripc()->sendRml(rml);
 	}
-	delete cart;
 	return;
       }
     }
@@ -128,7 +126,6 @@ void MainObject::RunLocalMacros(RDMacro *rml)
 	rda->ripc()->sendRml(rml);
       }
     }
-    delete cart;
     return;
     break;
 
@@ -2,7 +2,7 @@
 //
 // The Rivendell Netcatcher Daemon
 //
-//   (C) Copyright 2002-2019 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2019,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -45,6 +45,7 @@
 #include <rdapplication.h>
 #include <rdconf.h>
 #include <rdcut.h>
+#include <rdcutrotation.h>
 #include <rddatedecode.h>
 #include <rddb.h>
 #include <rdescape_string.h>
@@ -196,6 +197,10 @@ MainObject::MainObject(QObject *parent)
     catch_record_status[i]=false;
     catch_record_id[i]=0;
     catch_record_aborting[i]=false;
+    catch_record_direct[i]=false;
+    catch_record_analyzed[i]=false;
+    catch_record_peak[i]=0;
+    catch_record_loudness[i]=0;
     catch_playout_status[i]=false;
     catch_playout_event_id[i]=-1;
     catch_playout_id[i]=0;
@@ -279,6 +284,16 @@ MainObject::MainObject(QObject *parent)
   connect(rda->ripc(),SIGNAL(notificationReceived(RDNotification *)),
 	  this,SLOT(notificationReceivedData(RDNotification *)));
 
+  //
+  // Cut Rotation
+  //
+  new RDCutRotation(rda->ripc(),this);
+
+  //
+  // Macro Cart Cache
+  //
+  catch_macro_cache=new RDMacroCartCache(rda->ripc(),this);
+
   //
   // CAE Connection
   //
@@ -290,6 +305,8 @@ MainObject::MainObject(QObject *parent)
 	  this,SLOT(recordingData(int,int)));
   connect(rda->cae(),SIGNAL(recordStopped(int,int)),
 	  this,SLOT(recordStoppedData(int,int)));
+  connect(rda->cae(),SIGNAL(recordAnalyzed(int,int,int,int)),
+	  this,SLOT(recordAnalyzedData(int,int,int,int)));
   connect(rda->cae(),SIGNAL(recordUnloaded(int,int,unsigned)),
 	  this,SLOT(recordUnloadedData(int,int,unsigned)));
   connect(rda->cae(),SIGNAL(playLoaded(int)),
@@ -936,6 +953,19 @@ void MainObject::recordStoppedData(int card,int stream)
 }
 
 
+void MainObject::recordAnalyzedData(int card,int stream,int peak,
+				    int loudness)
+{
+  int deck=GetRecordDeck(card,stream);
+  if(deck<1) {
+    return;
+  }
+  catch_record_analyzed[deck-1]=true;
+  catch_record_peak[deck-1]=peak;
+  catch_record_loudness[deck-1]=loudness;
+}
+
+
 void MainObject::recordUnloadedData(int card,int stream,unsigned msecs)
 {
   int deck=GetRecordDeck(card,stream);
@@ -959,7 +989,12 @@ void MainObject::recordUnloadedData(int card,int stream,unsigned msecs)
 		     catch_record_threshold[deck-1]);
   }
   else {
-    StartBatch(catch_events[event].id());
+    if(catch_record_direct[deck-1]) {
+      CheckInNormalizedRecording(deck,&catch_events[event],msecs);
+    }
+    else {
+      StartBatch(catch_events[event].id());
+    }
   }
   if(catch_record_aborting[deck-1]) {
     rda->syslog(LOG_INFO,"record aborted: cut %s",
@@ -1082,11 +1117,9 @@ void MainObject::playUnloadedData(int handle)
 
 void MainObject::runCartData(int chan,int number,unsigned cartnum)
 {
-  RDCart *cart=new RDCart(cartnum);
-  if(cart->exists()&&(cart->type()==RDCart::Macro)) {
-    ExecuteMacroCart(cart);
+  if(catch_macro_cache->isMacro(cartnum)) {
+    ExecuteMacroCart(cartnum);
   }
-  delete cart;
   SendDeckEvent(chan,number);
 }
 
@@ -1154,11 +1187,9 @@ void MainObject::heartbeatData()
 
 void MainObject::sysHeartbeatData()
 {
-  RDCart *cart=new RDCart(catch_heartbeat_cart);
-  if(cart->exists()) {
-    ExecuteMacroCart(cart);
+  if(catch_macro_cache->exists(catch_heartbeat_cart)) {
+    ExecuteMacroCart(catch_heartbeat_cart);
   }
-  delete cart;
 }
 
 
@@ -1191,15 +1222,13 @@ void MainObject::startupCartData()
 {
   unsigned cartnum=rda->station()->startupCart();
   if(cartnum>0) {
-    RDCart *cart=new RDCart(cartnum);
-    if(cart->exists()) {
-      ExecuteMacroCart(cart);
+    if(catch_macro_cache->exists(cartnum)) {
+      ExecuteMacroCart(cartnum);
       rda->syslog(LOG_INFO,"ran startup cart %06u",cartnum);
     }
     else {
       rda->syslog(LOG_WARNING,"startup cart %06u was invalid",cartnum);
     }
-    delete cart;
   }
 }
 
@@ -1291,15 +1320,29 @@ bool MainObject::StartRecording(int event)
   //
   RDCae::AudioCoding format=catch_events[event].format();
   QString cut_name;
+  catch_record_direct[deck-1]=false;
+  catch_record_analyzed[deck-1]=false;
   if(catch_events[event].normalizeLevel()==0) {
     cut_name=catch_events[event].cutName();
   }
   else {
-    cut_name=QString().sprintf("rdcatchd-record-%d",catch_events[event].id());
-    catch_events[event].
-      setTempName(GetTempRecordingName(catch_events[event].id()));
-    catch_events[event].setDeleteTempFile(true);
-    format=RDCae::Pcm24;
+    if(rda->station()->cardDriver(catch_record_card[deck-1])==
+       RDStation::Alsa) {
+      //
+      // CAE meters the stream as it is captured, so record directly
+      // into the cut and normalize via play gain when unloaded.
+      //
+      cut_name=catch_events[event].cutName();
+      catch_record_direct[deck-1]=true;
+    }
+    else {
+      cut_name=
+	QString().sprintf("rdcatchd-record-%d",catch_events[event].id());
+      catch_events[event].
+	setTempName(GetTempRecordingName(catch_events[event].id()));
+      catch_events[event].setDeleteTempFile(true);
+      format=RDCae::Pcm24;
+    }
   }    
 
   //
@@ -1446,24 +1489,19 @@ void MainObject::StartPlayout(int event)
 
 void MainObject::StartMacroEvent(int event)
 {
-  RDCart *cart=new RDCart(catch_events[event].macroCart());
-  if(!cart->exists()) {
-    rda->syslog(LOG_WARNING,"cart %u does not exist!",
-		catch_events[event].macroCart());
-    delete cart;
+  unsigned cartnum=catch_events[event].macroCart();
+
+  if(!catch_macro_cache->exists(cartnum)) {
+    rda->syslog(LOG_WARNING,"cart %u does not exist!",cartnum);
     return;
   }
-  if(cart->type()!=RDCart::Macro) {
-    rda->syslog(LOG_WARNING,"%u is not a macro cart!",
-		catch_events[event].macroCart());
-    delete cart;
+  if(!catch_macro_cache->isMacro(cartnum)) {
+    rda->syslog(LOG_WARNING,"%u is not a macro cart!",cartnum);
     return;
   }
-  if(ExecuteMacroCart(cart,catch_events[event].id(),event)) {
-    rda->syslog(LOG_INFO,"executing macro cart: %u",
-		catch_events[event].macroCart());
+  if(ExecuteMacroCart(cartnum,catch_events[event].id(),event)) {
+    rda->syslog(LOG_INFO,"executing macro cart: %u",cartnum);
   }
-  delete cart;
 }
 
 
@@ -1515,7 +1553,7 @@ void MainObject::StartUploadEvent(int event)
 }
 
 
-bool MainObject::ExecuteMacroCart(RDCart *cart,int id,int event)
+bool MainObject::ExecuteMacroCart(unsigned cartnum,int id,int event)
 {
   int event_id=GetFreeEvent();
   if(event_id<0) {
@@ -1534,8 +1572,7 @@ bool MainObject::ExecuteMacroCart(RDCart *cart,int id,int event)
   catch_event_mapper->setMapping(catch_event_pool[event_id],event_id);
   connect(catch_event_pool[event_id],SIGNAL(finished()),
 	  catch_event_mapper,SLOT(map()));
-  QString cmd=cart->macros();
-  catch_event_pool[event_id]->load(cmd);
+  catch_event_pool[event_id]->load(cartnum);
   catch_event_pool[event_id]->exec();
   return true;
 }
@@ -2666,6 +2703,50 @@ void MainObject::SendNotification(RDNotification::Type type,
 }
 
 
+void MainObject::CheckInNormalizedRecording(int deck,CatchEvent *evt,
+					    unsigned msecs)
+{
+  int gain=100*(evt->normalizeLevel()/100)-catch_record_peak[deck-1];
+  int threshold=catch_record_threshold[deck-1];
+
+  //
+  // The trim threshold is relative to the normalized level
+  //
+  if(threshold>0) {
+    threshold+=gain;
+  }
+  if(catch_record_analyzed[deck-1]&&(gain>=RD_MIN_PLAY_GAIN)&&
+     (gain<=RD_MAX_PLAY_GAIN)&&
+     ((catch_record_threshold[deck-1]==0)||(threshold>0))) {
+    CheckInRecording(catch_record_name[deck-1],evt,msecs,threshold);
+    RDCut *cut=new RDCut(catch_record_name[deck-1]);
+    cut->setPlayGain(gain);
+    delete cut;
+    rda->syslog(LOG_INFO,"normalized cut %s: peak: %5.2lf dBFS, "
+		"loudness: %5.2lf LUFS, gain: %5.2lf dB",
+		(const char *)catch_record_name[deck-1].toUtf8(),
+		(double)catch_record_peak[deck-1]/100.0,
+		(double)catch_record_loudness[deck-1]/100.0,
+		(double)gain/100.0);
+    return;
+  }
+
+  //
+  // Gain out of range, fall back to a batch conversion
+  //
+  evt->setTempName(GetTempRecordingName(evt->id()));
+  evt->setDeleteTempFile(true);
+  if(rename(RDCut::pathName(catch_record_name[deck-1]).toUtf8(),
+	    evt->tempName().toUtf8())!=0) {
+    rda->syslog(LOG_WARNING,"unable to rename %s to %s [%s]",
+		(const char *)RDCut::pathName(catch_record_name[deck-1]).
+		toUtf8(),
+		(const char *)evt->tempName().toUtf8(),strerror(errno));
+  }
+  StartBatch(evt->id());
+}
+
+
 QString MainObject::GetTempRecordingName(int id) const
 {
   return QString().sprintf("%s/rdcatchd-record-%d.%s",
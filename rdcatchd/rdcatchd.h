@@ -2,7 +2,7 @@
 //
 // The Rivendell Netcatcher.
 //
-//   (C) Copyright 2002-2019 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2019,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -43,6 +43,7 @@
 #include <rdcmd_switch.h>
 #include <rddeck.h>
 #include <rdmacro_event.h>
+#include <rdmacrocartcache.h>
 #include <rdsocket.h>
 #include <rdsettings.h>
 #include <rdtimeengine.h>
@@ -109,6 +110,7 @@ class MainObject : public QObject
   void recordLoadedData(int card,int stream);
   void recordingData(int card,int stream);
   void recordStoppedData(int card,int stream);
+  void recordAnalyzedData(int card,int stream,int peak,int loudness);
   void recordUnloadedData(int card,int stream,unsigned msecs);
   void playLoadedData(int handle);
   void playingData(int handle);
@@ -154,7 +156,7 @@ class MainObject : public QObject
   void StartSwitchEvent(int event);
   void StartDownloadEvent(int event);
   void StartUploadEvent(int event);
-  bool ExecuteMacroCart(RDCart *cart,int id=-1,int event=-1);
+  bool ExecuteMacroCart(unsigned cartnum,int id=-1,int event=-1);
   void SendFullStatus(int ch);
   void SendMeterLevel(int deck,short levels[2]);
   void SendDeckEvent(int deck,int number);
@@ -178,6 +180,7 @@ class MainObject : public QObject
   void LoadHeartbeat();
   void CheckInRecording(QString cutname,CatchEvent *evt,unsigned msecs,
 			unsigned threshold);
+  void CheckInNormalizedRecording(int deck,CatchEvent *evt,unsigned msecs);
   void CheckInPodcast(CatchEvent *e) const;
   RDRecording::ExitCode ReadExitCode(int event);
   void WriteExitCode(int event,RDRecording::ExitCode code,
@@ -217,6 +220,10 @@ class MainObject : public QObject
   int catch_record_id[MAX_DECKS];
   QString catch_record_name[MAX_DECKS];
   bool catch_record_aborting[MAX_DECKS];
+  bool catch_record_direct[MAX_DECKS];
+  bool catch_record_analyzed[MAX_DECKS];
+  int catch_record_peak[MAX_DECKS];
+  int catch_record_loudness[MAX_DECKS];
 
   unsigned catch_record_pending_cartnum[MAX_DECKS];
   unsigned catch_record_pending_cutnum[MAX_DECKS];
@@ -247,6 +254,7 @@ class MainObject : public QObject
   gid_t catch_gid;
   bool catch_event_free[RDCATCHD_MAX_MACROS];
   RDMacroEvent *catch_event_pool[RDCATCHD_MAX_MACROS];
+  RDMacroCartCache *catch_macro_cache;
   int catch_macro_event_id[RDCATCHD_MAX_MACROS];
   QSignalMapper *catch_event_mapper;
   std::vector<CatchEvent> catch_events;
@@ -2,7 +2,7 @@
 //
 // The Library Utility for Rivendell.
 //
-//   (C) Copyright 2002-2020 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -20,8 +20,12 @@
 
 #include <sys/wait.h>
 
+#include <map>
+
+#include <q3header.h>
 #include <qapplication.h>
 #include <qmessagebox.h>
+#include <qscrollbar.h>
 #include <qshortcut.h>
 #include <qtranslator.h>
 
@@ -29,6 +33,7 @@
 
 #include <rdadd_cart.h>
 #include <rdcart_search_text.h>
+#include <rdcartsearchindex.h>
 #include <rdconf.h>
 #include <rdescape_string.h>
 #include <rdprofile.h>
@@ -140,7 +145,13 @@ MainWidget::MainWidget(RDConfig *c,QWidget *parent)
   rdaudioport_conf=new RDAudioPort(rda->config()->stationName(),
 				   rda->libraryConf()->inputCard());
   connect(rda,SIGNAL(userChanged()),this,SLOT(userData()));
-  connect(rda->ripc(),SIGNAL(notificationReceived(RDNotification *)),
+
+  //
+  // Search Index -- created ahead of our own notification handler so
+  // that it sees cart changes first
+  //
+  new RDCartSearchIndex(rda->ripc(),this);
+  connect(rda->ripc(),SIGNAL(notificationBatchReceived(RDNotification *)),
 	  this,SLOT(notificationReceivedData(RDNotification *)));
   rda->ripc()->
     connectHost("localhost",RIPCD_TCP_PORT,rda->config()->password());
@@ -309,6 +320,13 @@ MainWidget::MainWidget(RDConfig *c,QWidget *parent)
 	  this,SLOT(cartOnItemData(Q3ListViewItem *)));
   connect(lib_shownotes_box,SIGNAL(toggled(bool)),
   	  lib_cart_list,SLOT(enableNoteBubbles(bool)));
+  connect(lib_cart_list->verticalScrollBar(),SIGNAL(valueChanged(int)),
+	  this,SLOT(cartListScrolledData(int)));
+  connect(lib_cart_list->header(),SIGNAL(clicked(int)),
+	  this,SLOT(cartListSortedData(int)));
+  lib_last_cart=0;
+  lib_loaded_carts=0;
+  lib_list_matches=0;
   lib_cart_list->addColumn("");
   lib_cart_list->setColumnAlignment(Icon,Qt::AlignHCenter);
   lib_cart_list->addColumn(tr("Cart"));
@@ -1037,36 +1055,54 @@ void MainWidget::notificationReceivedData(RDNotification *notify)
   RDSqlQuery *q;
 
   if(notify->type()==RDNotification::CartType) {
-    unsigned cartnum=notify->id().toUInt();
     switch(notify->action()) {
     case RDNotification::AddAction:
-      sql=QString("select CART.NUMBER from CART ")+
+      //
+      // One query for the whole batch
+      //
+      sql=QString("select distinct CART.NUMBER from CART ")+
 	"left join CUTS on CART.NUMBER=CUTS.CART_NUMBER "+
-	WhereClause()+
-	QString().sprintf(" && CART.NUMBER=%u ",cartnum);
+	WhereClause()+" && CART.NUMBER in (";
+      for(int i=0;i<notify->idQuantity();i++) {
+	sql+=QString().sprintf("%u,",notify->id(i).toUInt());
+      }
+      sql=sql.left(sql.length()-1)+") ";
       q=new RDSqlQuery(sql);
-      if(q->first()) {
+      while(q->next()) {
+	//
+	// Carts beyond the last page loaded will arrive with a later page
+	//
+	if((lib_loaded_carts<lib_list_matches)&&
+	   (q->value(0).toUInt()>lib_last_cart)) {
+	  continue;
+	}
 	item=new RDListViewItem(lib_cart_list);
-	item->setText(Cart,QString().sprintf("%06u",cartnum));
+	item->setText(Cart,QString().sprintf("%06u",q->value(0).toUInt()));
 	RefreshLine(item);
       }
       delete q;
       break;
 
     case RDNotification::ModifyAction:
-      if((item=(RDListViewItem *)lib_cart_list->
-	  findItem(QString().sprintf("%06u",cartnum),Cart))!=NULL) {
-	RefreshLine(item);
+      for(int i=0;i<notify->idQuantity();i++) {
+	if((item=(RDListViewItem *)lib_cart_list->
+	    findItem(QString().sprintf("%06u",notify->id(i).toUInt()),Cart))!=
+	   NULL) {
+	  RefreshLine(item);
+	}
       }
       break;
 
     case RDNotification::DeleteAction:
-      if(lib_edit_pending) {
-	lib_deleted_carts.push_back(cartnum);
-      }
-      else {
-	if((item=(RDListViewItem *)lib_cart_list->findItem(QString().sprintf("%06u",cartnum),Cart))!=NULL) {
-	  delete item;
+      for(int i=0;i<notify->idQuantity();i++) {
+	unsigned cartnum=notify->id(i).toUInt();
+	if(lib_edit_pending) {
+	  lib_deleted_carts.push_back(cartnum);
+	}
+	else {
+	  if((item=(RDListViewItem *)lib_cart_list->findItem(QString().sprintf("%06u",cartnum),Cart))!=NULL) {
+	    delete item;
+	  }
 	}
       }
       break;
@@ -1079,6 +1115,25 @@ void MainWidget::notificationReceivedData(RDNotification *notify)
 }
 
 
+void MainWidget::cartListScrolledData(int value)
+{
+  QScrollBar *bar=lib_cart_list->verticalScrollBar();
+
+  if(value>=(bar->maximum()-bar->pageStep())) {
+    LoadPage();
+  }
+}
+
+
+void MainWidget::cartListSortedData(int section)
+{
+  //
+  // Sorting needs every match in the list
+  //
+  LoadAll();
+}
+
+
 void MainWidget::quitMainWidget()
 {
   SaveGeometry();
@@ -1147,14 +1202,11 @@ void MainWidget::resizeEvent(QResizeEvent *e)
 
 void MainWidget::RefreshCuts(RDListViewItem *p,unsigned cartnum)
 {
-  RDListViewItem *l=NULL;
   Q3ListViewItem *i=NULL;
   RDSqlQuery *q;
   QString sql;
   QDateTime current_datetime(QDate::currentDate(),QTime::currentTime());
-  QDateTime end_datetime;
   RDCart::Validity cart_validity=RDCart::NeverValid;
-  RDCart::Validity cut_validity=RDCart::NeverValid;
 
   while ((i=p->firstChild())) {
     delete i;
@@ -1183,37 +1235,9 @@ void MainWidget::RefreshCuts(RDListViewItem *p,unsigned cartnum)
   sql+=QString().sprintf("where CUTS.CART_NUMBER=%u ",cartnum);
   sql+="order by CUTS.CUT_NAME";
   q=new RDSqlQuery(sql);
-  if (q->size()>1) {
+  if(q->size()>0) {
     while(q->next()) {
-      l=new RDListViewItem(p);
-      l->setDragEnabled(false);
-      l->setText(Cart,q->value(1).toString());
-      l->setText(Length,RDGetTimeLength(q->value(5).toUInt()));
-      l->setText(Talk,RDGetTimeLength(q->value(4).toUInt()-q->value(3).toUInt()));
-      l->setText(Title,q->value(2).toString());
-      if(!q->value(7).toDateTime().isNull()) {
-        l->setText(Start,q->value(7).toDateTime().
-		   toString("MM/dd/yyyy hh:mm:ss"));
-      }
-      if(!q->value(8).toDateTime().isNull()) {
-        l->setText(End,q->value(8).toDateTime().
-		   toString("MM/dd/yyyy - hh:mm:ss"));
-      }
-      else {
-        l->setText(End,"TFN");
-      }
-      end_datetime=q->value(8).toDateTime();
-      cut_validity=ValidateCut(q,5,RDCart::NeverValid,current_datetime);
-      UpdateItemColor(l,cut_validity,end_datetime,current_datetime);
-      cart_validity=ValidateCut(q,5,cart_validity,current_datetime);
-      UpdateItemColor(p,cart_validity,end_datetime,current_datetime);
-    }
-  }
-  else if(q->size()==1){
-    if(q->next()) {
-      cart_validity=ValidateCut(q,5,cart_validity,current_datetime);
-      end_datetime=q->value(8).toDateTime();
-      UpdateItemColor(p,cart_validity,end_datetime,current_datetime);
+      RefreshCut(p,q,q->size(),&cart_validity,current_datetime);
     }
   }
   else {
@@ -1223,24 +1247,100 @@ void MainWidget::RefreshCuts(RDListViewItem *p,unsigned cartnum)
   delete q;
 }
 
+
+void MainWidget::RefreshCut(RDListViewItem *p,RDSqlQuery *q,int cuts,
+			    RDCart::Validity *cart_validity,
+			    const QDateTime &current_datetime)
+{
+  RDListViewItem *l=NULL;
+  QDateTime end_datetime=q->value(8).toDateTime();
+  RDCart::Validity cut_validity=RDCart::NeverValid;
+
+  //
+  // Carts with more than one cut show each of them as a child
+  //
+  if(cuts>1) {
+    l=new RDListViewItem(p);
+    l->setDragEnabled(false);
+    l->setText(Cart,q->value(1).toString());
+    l->setText(Length,RDGetTimeLength(q->value(5).toUInt()));
+    l->setText(Talk,RDGetTimeLength(q->value(4).toUInt()-q->value(3).toUInt()));
+    l->setText(Title,q->value(2).toString());
+    if(!q->value(7).toDateTime().isNull()) {
+      l->setText(Start,q->value(7).toDateTime().
+		 toString("MM/dd/yyyy hh:mm:ss"));
+    }
+    if(!end_datetime.isNull()) {
+      l->setText(End,end_datetime.toString("MM/dd/yyyy - hh:mm:ss"));
+    }
+    else {
+      l->setText(End,"TFN");
+    }
+    cut_validity=ValidateCut(q,5,RDCart::NeverValid,current_datetime);
+    UpdateItemColor(l,cut_validity,end_datetime,current_datetime);
+  }
+  *cart_validity=ValidateCut(q,5,*cart_validity,current_datetime);
+  UpdateItemColor(p,*cart_validity,end_datetime,current_datetime);
+}
+
+
 void MainWidget::RefreshList()
 {
-  RDSqlQuery *q;
   QString sql;
-  RDListViewItem *l=NULL;
-  QString type_filter;
-  QDateTime current_datetime(QDate::currentDate(),QTime::currentTime());
-  QDateTime end_datetime;
 
   lib_cart_list->clear();
+  lib_last_cart=0;
+  lib_loaded_carts=0;
+  lib_list_matches=0;
 
   lib_edit_button->setEnabled(false);
   lib_delete_button->setEnabled(false);
 
-  type_filter=GetTypeFilter();
-  if(type_filter.isEmpty()) {
+  if(GetTypeFilter().isEmpty()) {
     return;
   }
+
+  //
+  // Count the matches on the server, then load the list a page at a time
+  // as it is scrolled
+  //
+  sql=QString("select ")+
+    "count(distinct CART.NUMBER) "+  // 00
+    "from CART left join GROUPS on CART.GROUP_NAME=GROUPS.NAME "+
+    "left join CUTS on CART.NUMBER=CUTS.CART_NUMBER"+
+    WhereClause();
+  RDSqlQuery *q=new RDSqlQuery(sql);
+  if(q->first()) {
+    lib_list_matches=q->value(0).toInt();
+  }
+  delete q;
+  if(lib_showmatches_box->isChecked()&&
+     (lib_list_matches>RD_LIMITED_CART_SEARCH_QUANTITY)) {
+    lib_list_matches=RD_LIMITED_CART_SEARCH_QUANTITY;
+  }
+  lib_matches_edit->setText(QString().sprintf("%d",lib_list_matches));
+  LoadPage();
+}
+
+
+int MainWidget::LoadPage()
+{
+  RDSqlQuery *q;
+  QString sql;
+  RDListViewItem *l=NULL;
+  QDateTime current_datetime(QDate::currentDate(),QTime::currentTime());
+  std::map<unsigned,RDListViewItem *> audio_items;
+  std::map<unsigned,int> cut_counts;
+  std::map<unsigned,RDCart::Validity> validities;
+  int loaded=0;
+
+  if(lib_loaded_carts>=lib_list_matches) {
+    return 0;
+  }
+  int limit=lib_list_matches-lib_loaded_carts;
+  if(limit>RDLIBRARY_PAGE_SIZE) {
+    limit=RDLIBRARY_PAGE_SIZE;
+  }
   sql=QString("select ")+
     "CART.NUMBER,"+             // 00
     "CART.FORCED_LENGTH,"+      // 01
@@ -1267,23 +1367,17 @@ void MainWidget::RefreshList()
     "CART.VALIDITY,"+           // 22
     "GROUPS.COLOR,"+            // 23
     "CUTS.TALK_START_POINT,"+   // 24
-    "CUTS.TALK_END_POINT "+     // 25
+    "CUTS.TALK_END_POINT,"+     // 25
+    "(select count(*) from CUTS as CART_CUTS "+  // 26
+    "where CART_CUTS.CART_NUMBER=CART.NUMBER) "+
     "from CART left join GROUPS on CART.GROUP_NAME=GROUPS.NAME "+
     "left join CUTS on CART.NUMBER=CUTS.CART_NUMBER";
   sql+=WhereClause();
+  sql+=QString().sprintf(" && CART.NUMBER>%u",lib_last_cart);
   sql+=" group by CART.NUMBER order by CART.NUMBER";
-  if(lib_showmatches_box->isChecked()) {
-    sql+=QString().sprintf(" limit %d",RD_LIMITED_CART_SEARCH_QUANTITY);
-  }
+  sql+=QString().sprintf(" limit %d",limit);
   q=new RDSqlQuery(sql);
-  int step=0;
-  int count=0;
-  int matches=0;
-  lib_progress_dialog->setMaximum(q->size()/RDLIBRARY_STEP_SIZE);
-  lib_progress_dialog->setValue(0);
   while(q->next()) {
-    end_datetime=q->value(14).toDateTime();
-
     //
     // Start a new entry
     //
@@ -1359,23 +1453,93 @@ void MainWidget::RefreshList()
       }
     }
     if((RDCart::Type)q->value(15).toUInt()==RDCart::Audio) {
-      RefreshCuts(l,q->value(0).toUInt());
+      if(q->value(26).toInt()>0) {
+	audio_items[q->value(0).toUInt()]=l;
+	cut_counts[q->value(0).toUInt()]=q->value(26).toInt();
+      }
+      else {
+	l->setBackgroundColor(RD_CART_ERROR_COLOR);
+      }
     }
     else {
       l->setBackgroundColor(palette().color(QPalette::Active,QColorGroup::Base));
     }
-    matches++;
-    count++;
-
-    if(count>RDLIBRARY_STEP_SIZE) {
-      lib_progress_dialog->setValue(++step);
-      count=0;
-      qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
+    lib_last_cart=q->value(0).toUInt();
+    loaded++;
+  }
+  delete q;
+  lib_loaded_carts+=loaded;
+  if(loaded<limit) {
+    //
+    // Carts deleted since the count was taken
+    //
+    lib_list_matches=lib_loaded_carts;
+    lib_matches_edit->setText(QString().sprintf("%d",lib_list_matches));
+  }
+
+  //
+  // Cuts for every audio cart on the page in one query. Validity is
+  // worked out here, per cut, as it depends upon our clock and each
+  // cut's dayparts, and the cuts are needed anyway for the child items.
+  //
+  if(audio_items.size()>0) {
+    sql=QString("select ")+
+      "CUTS.CART_NUMBER,"+        // 00
+      "CUTS.CUT_NAME,"+           // 01
+      "CUTS.DESCRIPTION,"+        // 02
+      "CUTS.TALK_START_POINT,"+   // 03
+      "CUTS.TALK_END_POINT,"+     // 04
+      "CUTS.LENGTH,"+             // 05  offsets begin here
+      "CUTS.EVERGREEN,"+          // 06
+      "CUTS.START_DATETIME,"+     // 07
+      "CUTS.END_DATETIME,"+       // 08
+      "CUTS.START_DAYPART,"+      // 09
+      "CUTS.END_DAYPART,"+        // 10
+      "CUTS.MON,"+                // 11
+      "CUTS.TUE,"+                // 12
+      "CUTS.WED,"+                // 13
+      "CUTS.THU,"+                // 14
+      "CUTS.FRI,"+                // 15
+      "CUTS.SAT,"+                // 16
+      "CUTS.SUN "+                // 17
+      "from CUTS where CUTS.CART_NUMBER in (";
+    for(std::map<unsigned,RDListViewItem *>::const_iterator it=
+	  audio_items.begin();it!=audio_items.end();it++) {
+      sql+=QString().sprintf("%u,",it->first);
+    }
+    sql=sql.left(sql.length()-1)+") ";
+    sql+="order by CUTS.CART_NUMBER,CUTS.CUT_NAME";
+    q=new RDSqlQuery(sql);
+    while(q->next()) {
+      unsigned cartnum=q->value(0).toUInt();
+      if(validities.count(cartnum)==0) {
+	validities[cartnum]=RDCart::NeverValid;
+      }
+      RefreshCut(audio_items[cartnum],q,cut_counts[cartnum],
+		 &validities[cartnum],current_datetime);
     }
+    delete q;
+  }
+
+  return loaded;
+}
+
+
+void MainWidget::LoadAll()
+{
+  int step=0;
+
+  if(lib_loaded_carts>=lib_list_matches) {
+    return;
+  }
+  lib_progress_dialog->
+    setMaximum((lib_list_matches-lib_loaded_carts)/RDLIBRARY_PAGE_SIZE);
+  lib_progress_dialog->setValue(0);
+  while(LoadPage()>0) {
+    lib_progress_dialog->setValue(++step);
+    qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
   }
   lib_progress_dialog->reset();
-  lib_matches_edit->setText(QString().sprintf("%d",matches));
-  delete q;
 }
 
 
@@ -1391,14 +1555,18 @@ QString MainWidget::WhereClause() const
   if(lib_codes2_box->currentText()!=tr("ALL")) {
     schedcodes << lib_codes2_box->currentText();
   }
+  RDCart::Type type=RDCart::All;
+  if(lib_showaudio_box->isChecked()!=lib_showmacro_box->isChecked()) {
+    type=lib_showaudio_box->isChecked()?RDCart::Audio:RDCart::Macro;
+  }
   if(lib_group_box->currentText()==QString(tr("ALL"))) {
     sql=RDAllCartSearchText(lib_filter_edit->text(),schedcodes,
-			  rda->user()->name(),true)+" && "+type_filter;
+			  rda->user()->name(),true,type)+" && "+type_filter;
 
   }
   else {
     sql=RDCartSearchText(lib_filter_edit->text(),lib_group_box->currentText(),
-		       schedcodes,true)+" && "+type_filter;      
+		       schedcodes,true,type)+" && "+type_filter;      
   }
 
   return sql;
@@ -2,7 +2,7 @@
 //
 // Library Utility for Rivendell.
 //
-//   (C) Copyright 2002-2019 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2019,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -34,6 +34,7 @@
 
 #define RDLIBRARY_GEOMETRY_FILE ".rdlibrary"
 #define RDLIBRARY_STEP_SIZE 5000
+#define RDLIBRARY_PAGE_SIZE 500
 
 //
 // Cut Length Deviation Values
@@ -81,6 +82,8 @@ class MainWidget : public RDWidget
   void searchLimitChangedData(int state);
   void dragsChangedData(int state);
   void notificationReceivedData(RDNotification *notify);
+  void cartListScrolledData(int value);
+  void cartListSortedData(int section);
   void quitMainWidget();
 
  protected:
@@ -89,7 +92,12 @@ class MainWidget : public RDWidget
   
  private:
   void RefreshList();
+  int LoadPage();
+  void LoadAll();
   void RefreshCuts(RDListViewItem *p,unsigned cartnum);
+  void RefreshCut(RDListViewItem *p,RDSqlQuery *q,int cuts,
+		  RDCart::Validity *cart_validity,
+		  const QDateTime &current_datetime);
   QString WhereClause() const;
   void RefreshLine(RDListViewItem *item);
   void UpdateItemColor(RDListViewItem *item,RDCart::Validity validity,
@@ -153,6 +161,9 @@ class MainWidget : public RDWidget
   QTimer *lib_user_timer;
   bool lib_resize;
   std::vector<unsigned> lib_deleted_carts;
+  unsigned lib_last_cart;
+  int lib_loaded_carts;
+  int lib_list_matches;
 };
 
 
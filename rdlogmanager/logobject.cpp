@@ -2,7 +2,7 @@
 //
 // Generate/merge logs from the command line.
 //
-//   (C) Copyright 2018-2020 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2018-2020,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -18,30 +18,50 @@
 //   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 //
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
 
 #include <qapplication.h>
+#include <qhash.h>
+#include <qmap.h>
+#include <qsqldatabase.h>
 
-#include <rdapplication.h>
 #include <rddatedecode.h>
+#include <rddb.h>
 #include <rdlog.h>
 #include <rdsvc.h>
 
 #include "logobject.h"
 
-LogObject::LogObject(const QString &svcname,int start_offset,
-		     bool protect_existing,bool gen_log,bool merge_mus,
-		     bool merge_tfc,QObject *parent)
+LogObject::LogObject(const QStringList &svcnames,int start_offset,
+		     int end_offset,bool protect_existing,bool gen_log,
+		     bool merge_mus,bool merge_tfc,unsigned workers,
+		     bool use_seed,unsigned seed,QObject *parent)
   : QObject(parent)
 {
   QString err_msg;
 
-  log_service_name=svcname;
+  log_service_names=svcnames;
+  if(log_service_names.size()==0) {
+    log_service_names.push_back(QString());
+  }
   log_start_offset=start_offset;
+  log_end_offset=end_offset;
+  if(log_end_offset<log_start_offset) {
+    log_end_offset=log_start_offset;
+  }
   log_protect_existing=protect_existing;
   log_generate_log=gen_log;
   log_merge_music=merge_mus;
   log_merge_traffic=merge_tfc;
+  log_workers=workers;
+  log_use_seed=use_seed;
+  log_seed=seed;
+  log_notify=true;
+  log_template_cache=NULL;
 
   //
   // Open the Database
@@ -59,162 +79,318 @@ LogObject::LogObject(const QString &svcname,int start_offset,
   
 
 void LogObject::userData()
+{
+  RDApplication::ExitCode code=RDApplication::ExitOk;
+  QTime timer;
+
+  if(!rda->user()->createLog()) {
+    fprintf(stderr,"rdlogmanager: insufficient permissions\n");
+    exit(RDApplication::ExitNoPerms);
+  }
+
+  //
+  // Load the grids, clocks and events of all services once
+  //
+  timer.start();
+  if(log_generate_log) {
+    log_template_cache=new RDLogTemplateCache(rda->station());
+    log_template_cache->load(log_service_names);
+  }
+
+  if((log_workers>1)&&(log_service_names.size()>1)) {
+    code=RunWorkers();
+  }
+  else {
+    for(int i=0;i<log_service_names.size();i++) {
+      if((code=RunService(log_service_names.at(i)))!=RDApplication::ExitOk) {
+	exit(code);
+      }
+    }
+  }
+
+  //
+  // Report Throughput
+  //
+  if((code==RDApplication::ExitOk)&&
+     ((log_service_names.size()>1)||(log_end_offset>log_start_offset))) {
+    int logs=log_service_names.size()*(1+log_end_offset-log_start_offset);
+    int msecs=timer.elapsed();
+    if(msecs<1) {
+      msecs=1;
+    }
+    printf("rdlogmanager: processed %d logs in %.1f s (%.1f logs/min)\n",
+	   logs,(double)msecs/1000.0,60000.0*(double)logs/(double)msecs);
+  }
+
+  exit(code);
+}
+
+
+RDApplication::ExitCode LogObject::RunService(const QString &svcname)
+{
+  RDApplication::ExitCode code=RDApplication::ExitOk;
+
+  //
+  // Scheduler state (the service's stack and the random number sequence)
+  // carries over from one day to the next, so the days of a service are
+  // always generated in order by a single process.
+  //
+  if(log_use_seed) {
+    srand(log_seed+qHash(svcname));
+  }
+  for(int i=log_start_offset;i<=log_end_offset;i++) {
+    if((code=RunLog(svcname,i))!=RDApplication::ExitOk) {
+      return code;
+    }
+  }
+
+  return RDApplication::ExitOk;
+}
+
+
+RDApplication::ExitCode LogObject::RunLog(const QString &svcname,int offset)
 {
   QString err_msg;
   QString report;
   QString unused_report;
-  QString svcname_table=log_service_name;
-  svcname_table.replace(" ","_");
 
-  if(rda->user()->createLog()) {
-    //
-    // Some Basic Structures
-    //
-    RDSvc *svc=new RDSvc(log_service_name,rda->station(),rda->config());
-    if(!svc->exists()) {
-      fprintf(stderr,"rdlogmanager: no such service\n");
-      exit(RDApplication::ExitNoSvc);
-    }
-    QDate start_date=QDate::currentDate().addDays(1+log_start_offset);
-    QString logname=
-      RDDateDecode(svc->nameTemplate(),start_date,rda->station(),rda->config(),
-		   svc->name());
-    RDLog *log=new RDLog(logname);
+  //
+  // Some Basic Structures
+  //
+  RDSvc *svc=new RDSvc(svcname,rda->station(),rda->config());
+  if(!svc->exists()) {
+    fprintf(stderr,"rdlogmanager: no such service\n");
+    return RDApplication::ExitNoSvc;
+  }
+  svc->setTemplateCache(log_template_cache);
+  QDate start_date=QDate::currentDate().addDays(1+offset);
+  QString logname=
+    RDDateDecode(svc->nameTemplate(),start_date,rda->station(),rda->config(),
+		 svc->name());
+  RDLog *log=new RDLog(logname);
 
-    //
-    // Generate Log
-    //
-    if(log_generate_log) {
-      if(log_protect_existing&&log->exists()) {
-	fprintf(stderr,"log \"%s\" already exists\n",
-		log->name().utf8().constData());
-	exit(RDApplication::ExitOutputProtected);
-      }
+  //
+  // Generate Log
+  //
+  if(log_generate_log) {
+    if(log_protect_existing&&log->exists()) {
+      fprintf(stderr,"log \"%s\" already exists\n",
+	      log->name().utf8().constData());
+      return RDApplication::ExitOutputProtected;
+    }
+    if(log_notify) {
       SendNotification(RDNotification::DeleteAction,log->name());
-      log->removeTracks(rda->station(),rda->user(),rda->config());
+    }
+    log->removeTracks(rda->station(),rda->user(),rda->config());
+    if(!log_use_seed) {
       srand(QTime::currentTime().msec());
-      if(!svc->generateLog(start_date,
-			   RDDateDecode(svc->nameTemplate(),start_date,
-				   rda->station(),rda->config(),svc->name()),
-			   RDDateDecode(svc->nameTemplate(),start_date.addDays(1),
-				   rda->station(),rda->config(),svc->name()),
-			   &unused_report,rda->user(),&err_msg)) {
-	fprintf(stderr,"rdlogmanager: log generation failed\n");
-	printf("%s\n",err_msg.toUtf8().constData());
-	exit(RDApplication::ExitLogGenFailed);
-      }
-      log->updateTracks();
+    }
+    QString nextname=
+      RDDateDecode(svc->nameTemplate(),start_date.addDays(1),
+		   rda->station(),rda->config(),svc->name());
+    if(!svc->generateLog(start_date,logname,nextname,&unused_report,
+			 rda->user(),&err_msg)) {
+      fprintf(stderr,"rdlogmanager: log generation failed\n");
+      printf("%s\n",err_msg.toUtf8().constData());
+      return RDApplication::ExitLogGenFailed;
+    }
+    log->updateTracks();
+    if(log_notify) {
       SendNotification(RDNotification::AddAction,log->name());
-
-      //
-      // Generate Exception Report
-      //
-      RDLogEvent *event=new RDLogEvent(logname);
-      event->load();
-      if((event->validate(&report,start_date)!=0)||
-	 (!unused_report.isEmpty())) {
-	printf("%s\n\n%s",(const char*)report,(const char*)unused_report);
-      }
-      delete event;
     }
 
     //
-    // Merge Music
+    // Generate Exception Report
     //
-    if(log_merge_music) {
-      if(!log->exists()) {
-	fprintf(stderr,"rdlogmanager: log does not exist\n");
-	exit(RDApplication::ExitNoLog);
-      }
-      if(log_protect_existing&&
-	 (log->linkState(RDLog::SourceMusic)==RDLog::LinkDone)) {
-	fprintf(stderr,
-		"rdlogmanager: music for log \"%s\" is already imported\n",
-		log->name().utf8().constData());
-	exit(RDApplication::ExitLogLinkFailed);
-      }
-      if((!log->includeImportMarkers())&&
-	 (log->linkState(RDLog::SourceMusic)!=RDLog::LinkMissing)) {
-	fprintf(stderr,
-		"rdlogmanager: music for log \"%s\" cannot be reimported\n",
-		log->name().utf8().constData());
-	exit(RDApplication::ExitLogLinkFailed);
-      }
-      report="";
-      log->removeTracks(rda->station(),rda->user(),rda->config());
-      if(!svc->clearLogLinks(RDSvc::Traffic,logname,rda->user(),&err_msg)) {
-	fprintf(stderr,"rdlogmanager: music import failed\n");
-	printf("%s\n",err_msg.toUtf8().constData());
-	exit(RDApplication::ExitLogLinkFailed);
-      }
-      if(!svc->clearLogLinks(RDSvc::Music,logname,rda->user(),&err_msg)) {
-	fprintf(stderr,"rdlogmanager: music import failed\n");
-	printf("%s\n",err_msg.toUtf8().constData());
-	exit(RDApplication::ExitLogLinkFailed);
-      }
-      if(svc->linkLog(RDSvc::Music,start_date,logname,&report,rda->user(),
-		      &err_msg)) {
-	printf("%s\n",(const char*)report);
-      }
-      else {
-	fprintf(stderr,"rdlogmanager: music import failed\n");
-	printf("%s\n",err_msg.toUtf8().constData());
-	exit(RDApplication::ExitLogLinkFailed);
-      }
+    RDLogEvent *event=new RDLogEvent(logname);
+    event->load();
+    if((event->validate(&report,start_date)!=0)||
+       (!unused_report.isEmpty())) {
+      printf("%s\n\n%s",(const char*)report,(const char*)unused_report);
+    }
+    delete event;
+  }
+
+  //
+  // Merge Music
+  //
+  if(log_merge_music) {
+    if(!log->exists()) {
+      fprintf(stderr,"rdlogmanager: log does not exist\n");
+      return RDApplication::ExitNoLog;
+    }
+    if(log_protect_existing&&
+       (log->linkState(RDLog::SourceMusic)==RDLog::LinkDone)) {
+      fprintf(stderr,
+	      "rdlogmanager: music for log \"%s\" is already imported\n",
+	      log->name().utf8().constData());
+      return RDApplication::ExitLogLinkFailed;
+    }
+    if((!log->includeImportMarkers())&&
+       (log->linkState(RDLog::SourceMusic)!=RDLog::LinkMissing)) {
+      fprintf(stderr,
+	      "rdlogmanager: music for log \"%s\" cannot be reimported\n",
+	      log->name().utf8().constData());
+      return RDApplication::ExitLogLinkFailed;
+    }
+    report="";
+    log->removeTracks(rda->station(),rda->user(),rda->config());
+    if(!svc->clearLogLinks(RDSvc::Traffic,logname,rda->user(),&err_msg)) {
+      fprintf(stderr,"rdlogmanager: music import failed\n");
+      printf("%s\n",err_msg.toUtf8().constData());
+      return RDApplication::ExitLogLinkFailed;
+    }
+    if(!svc->clearLogLinks(RDSvc::Music,logname,rda->user(),&err_msg)) {
+      fprintf(stderr,"rdlogmanager: music import failed\n");
+      printf("%s\n",err_msg.toUtf8().constData());
+      return RDApplication::ExitLogLinkFailed;
+    }
+    if(svc->linkLog(RDSvc::Music,start_date,logname,&report,rda->user(),
+		    &err_msg)) {
+      printf("%s\n",(const char*)report);
+    }
+    else {
+      fprintf(stderr,"rdlogmanager: music import failed\n");
+      printf("%s\n",err_msg.toUtf8().constData());
+      return RDApplication::ExitLogLinkFailed;
+    }
+    if(log_notify) {
       SendNotification(RDNotification::ModifyAction,log->name());
     }
+  }
 
-    //
-    // Merge Traffic
-    //
-    if(log_merge_traffic) {
-      if(!log->exists()) {
-	fprintf(stderr,"rdlogmanager: log does not exist\n");
-	exit(RDApplication::ExitNoLog);
-      }
-      if(log_protect_existing&&
-	 (log->linkState(RDLog::SourceTraffic)==RDLog::LinkDone)) {
-	fprintf(stderr,
-		"rdlogmanager: traffic for log \"%s\" is already imported\n",
-		(const char *)log->name().utf8());
-	exit(RDApplication::ExitLogLinkFailed);
-      }
-      if((!log->includeImportMarkers())&&
-	 (log->linkState(RDLog::SourceTraffic)!=RDLog::LinkMissing)) {
-	fprintf(stderr,
-		"rdlogmanager: traffic for log \"%s\" cannot be reimported\n",
-		log->name().utf8().constData());
-	exit(RDApplication::ExitLogLinkFailed);
+  //
+  // Merge Traffic
+  //
+  if(log_merge_traffic) {
+    if(!log->exists()) {
+      fprintf(stderr,"rdlogmanager: log does not exist\n");
+      return RDApplication::ExitNoLog;
+    }
+    if(log_protect_existing&&
+       (log->linkState(RDLog::SourceTraffic)==RDLog::LinkDone)) {
+      fprintf(stderr,
+	      "rdlogmanager: traffic for log \"%s\" is already imported\n",
+	      (const char *)log->name().utf8());
+      return RDApplication::ExitLogLinkFailed;
+    }
+    if((!log->includeImportMarkers())&&
+       (log->linkState(RDLog::SourceTraffic)!=RDLog::LinkMissing)) {
+      fprintf(stderr,
+	      "rdlogmanager: traffic for log \"%s\" cannot be reimported\n",
+	      log->name().utf8().constData());
+      return RDApplication::ExitLogLinkFailed;
+    }
+    report="";
+    if(!svc->clearLogLinks(RDSvc::Traffic,logname,rda->user(),&err_msg)) {
+      fprintf(stderr,"rdlogmanager: traffic schedule import failed\n");
+      printf("%s\n",err_msg.toUtf8().constData());
+      return RDApplication::ExitLogLinkFailed;
+    }
+    if(svc->linkLog(RDSvc::Traffic,start_date,logname,&report,rda->user(),
+		    &err_msg)) {
+      printf("%s\n",report.toUtf8().constData());
+    }
+    else {
+      fprintf(stderr,"rdlogmanager: traffic import failed\n");
+      printf("%s\n",err_msg.toUtf8().constData());
+      delete log;
+      delete svc;
+      return RDApplication::ExitLogLinkFailed;
+    }
+    if(log_notify) {
+      SendNotification(RDNotification::ModifyAction,log->name());
+    }
+  }
+
+  //
+  // Clean Up
+  //
+  delete log;
+  delete svc;
+
+  return RDApplication::ExitOk;
+}
+
+
+RDApplication::ExitCode LogObject::RunWorkers()
+{
+  RDApplication::ExitCode code=RDApplication::ExitOk;
+  QMap<pid_t,QString> running;
+  QStringList done;
+  int next=0;
+  int status=0;
+  pid_t pid;
+
+  //
+  // Each worker process needs its own database connection, so the
+  // parent's is closed until the workers are finished. The preloaded
+  // templates are inherited by every worker.
+  //
+  RDSqlQuery::clearStatementCache();
+  QSqlDatabase::database().close();
+  fflush(NULL);
+  while((next<log_service_names.size())||(running.size()>0)) {
+    if((next<log_service_names.size())&&(running.size()<(int)log_workers)) {
+      if((pid=fork())==0) {
+	QSqlDatabase::database().open();
+	log_notify=false;
+	code=RunService(log_service_names.at(next));
+	fflush(NULL);
+	_exit(code);
       }
-      report="";
-      if(!svc->clearLogLinks(RDSvc::Traffic,logname,rda->user(),&err_msg)) {
-	fprintf(stderr,"rdlogmanager: traffic schedule import failed\n");
-	printf("%s\n",err_msg.toUtf8().constData());
-	exit(RDApplication::ExitLogLinkFailed);
+      if(pid<0) {
+	fprintf(stderr,"rdlogmanager: unable to start worker process\n");
+	code=RDApplication::ExitLogGenFailed;
+	break;
       }
-      if(svc->linkLog(RDSvc::Traffic,start_date,logname,&report,rda->user(),
-		      &err_msg)) {
-	printf("%s\n",report.toUtf8().constData());
+      running[pid]=log_service_names.at(next++);
+      continue;
+    }
+    if((pid=waitpid(-1,&status,0))>0) {
+      if(WIFEXITED(status)&&(WEXITSTATUS(status)==RDApplication::ExitOk)) {
+	done.push_back(running.value(pid));
       }
       else {
-	fprintf(stderr,"rdlogmanager: traffic import failed\n");
-	printf("%s\n",err_msg.toUtf8().constData());
-	delete log;
-	delete svc;
-	exit(RDApplication::ExitLogLinkFailed);
+	if(code==RDApplication::ExitOk) {
+	  code=WIFEXITED(status)?
+	    (RDApplication::ExitCode)WEXITSTATUS(status):
+	    RDApplication::ExitLogGenFailed;
+	}
       }
-      SendNotification(RDNotification::ModifyAction,log->name());
+      running.remove(pid);
     }
+  }
+  while((pid=waitpid(-1,&status,0))>0);
+  QSqlDatabase::database().open();
 
-    //
-    // Clean Up
-    //
-    delete log;
-    delete svc;
-    exit(RDApplication::ExitOk);
+  //
+  // Send the notifications withheld by the workers
+  //
+  for(int i=0;i<done.size();i++) {
+    SendNotifications(done.at(i));
+  }
+
+  return code;
+}
+
+
+void LogObject::SendNotifications(const QString &svcname)
+{
+  RDSvc *svc=new RDSvc(svcname,rda->station(),rda->config());
+  for(int i=log_start_offset;i<=log_end_offset;i++) {
+    QDate date=QDate::currentDate().addDays(1+i);
+    QString logname=RDDateDecode(svc->nameTemplate(),date,rda->station(),
+				 rda->config(),svc->name());
+    if(log_generate_log) {
+      SendNotification(RDNotification::DeleteAction,logname);
+      SendNotification(RDNotification::AddAction,logname);
+    }
+    if(log_merge_music||log_merge_traffic) {
+      SendNotification(RDNotification::ModifyAction,logname);
+    }
   }
-  fprintf(stderr,"rdlogmanager: insufficient permissions\n");
-  exit(RDApplication::ExitNoPerms);
+  delete svc;
 }
 
 
@@ -2,7 +2,7 @@
 //
 // The Log Manager Utility for Rivendell.
 //
-//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2018,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -22,27 +22,41 @@
 #define LOGOBJECT_H
 
 #include <qobject.h>
+#include <qstringlist.h>
 
+#include <rdapplication.h>
+#include <rdlogtemplatecache.h>
 #include <rdnotification.h>
 
 class LogObject : public QObject
 {
  Q_OBJECT
  public:
- LogObject(const QString &svcname,int start_offset,bool protect_existing,
-	   bool gen_log,bool merge_mus,bool merge_tfc,QObject *parent=0);
+ LogObject(const QStringList &svcnames,int start_offset,int end_offset,
+	   bool protect_existing,bool gen_log,bool merge_mus,bool merge_tfc,
+	   unsigned workers,bool use_seed,unsigned seed,QObject *parent=0);
   
  private slots:
   void userData();
 
  private:
+  RDApplication::ExitCode RunService(const QString &svcname);
+  RDApplication::ExitCode RunLog(const QString &svcname,int offset);
+  RDApplication::ExitCode RunWorkers();
+  void SendNotifications(const QString &svcname);
   void SendNotification(RDNotification::Action action,const QString &logname);
-  QString log_service_name;
+  QStringList log_service_names;
   int log_start_offset;
+  int log_end_offset;
   bool log_protect_existing;
   bool log_generate_log;
   bool log_merge_music;
   bool log_merge_traffic;
+  unsigned log_workers;
+  bool log_use_seed;
+  unsigned log_seed;
+  bool log_notify;
+  RDLogTemplateCache *log_template_cache;
 };
 
 
@@ -2,7 +2,7 @@
 //
 // The Log Generator Utility for Rivendell.
 //
-//   (C) Copyright 2002-2020 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2020,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -284,10 +284,14 @@ int main(int argc,char *argv[])
   bool cmd_generate=false;
   bool cmd_merge_music=false;
   bool cmd_merge_traffic=false;
-  QString cmd_service=NULL;
+  QStringList cmd_services;
   QString cmd_report=NULL;
   int cmd_start_offset=0;
   int cmd_end_offset=0;
+  unsigned cmd_workers=1;
+  bool cmd_use_seed=false;
+  unsigned cmd_seed=0;
+  bool ok=false;
 
   RDCmdSwitch *cmd=
     new RDCmdSwitch(argc,argv,"rdlogmanager",RDLOGMANAGER_USAGE);
@@ -315,7 +319,7 @@ int main(int argc,char *argv[])
     if(cmd->key(i)=="-s") {
       if((i+1)<cmd->keys()) {
 	i++;
-	cmd_service = cmd->key(i);
+	cmd_services.push_back(cmd->key(i));
       }
       else {
 	fprintf(stderr,"rdlogmanager: missing argument to \"-s\"\n");
@@ -356,6 +360,23 @@ int main(int argc,char *argv[])
       }
       cmd->setProcessed(i,true);
     }
+    if(cmd->key(i)=="--workers") {
+      cmd_workers=cmd->value(i).toUInt(&ok);
+      if((!ok)||(cmd_workers==0)) {
+	fprintf(stderr,"rdlogmanager: invalid argument to \"--workers\"\n");
+	exit(RDApplication::ExitInvalidOption);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--seed") {
+      cmd_seed=cmd->value(i).toUInt(&ok);
+      if(!ok) {
+	fprintf(stderr,"rdlogmanager: invalid argument to \"--seed\"\n");
+	exit(RDApplication::ExitInvalidOption);
+      }
+      cmd_use_seed=true;
+      cmd->setProcessed(i,true);
+    }
     if(!cmd->processed(i)) {
       fprintf(stderr,"rdlogmanager: unknown command option \"%s\"\n",
 	      (const char *)cmd->key(i));
@@ -372,8 +393,9 @@ int main(int argc,char *argv[])
 
   if(cmd_generate||cmd_merge_traffic||cmd_merge_music) {
     QApplication a(argc,argv,false);
-    new LogObject(cmd_service,cmd_start_offset,cmd_protect_existing,
-		  cmd_generate,cmd_merge_music,cmd_merge_traffic);
+    new LogObject(cmd_services,cmd_start_offset,cmd_end_offset,
+		  cmd_protect_existing,cmd_generate,cmd_merge_music,
+		  cmd_merge_traffic,cmd_workers,cmd_use_seed,cmd_seed);
     return a.exec();
  }
   if(!cmd_report.isEmpty()) {
@@ -0,0 +1,259 @@
+// pypad_host.cpp
+//
+// A shared Python interpreter running many PyPAD script instances
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <syslog.h>
+
+#include <qstringlist.h>
+
+#include <rdapplication.h>
+#include <rdpaths.h>
+
+#include "pypad_host.h"
+
+//
+// Most standard error output kept for reporting a failed host (bytes)
+//
+#define PYPAD_HOST_MAX_STDERR 65536
+
+PypadHost::PypadHost(int id,QObject *parent)
+  : QObject(parent)
+{
+  host_id=id;
+  host_running=0;
+  host_suspect=0;
+  host_hung=false;
+
+  host_process=new QProcess(this);
+  connect(host_process,SIGNAL(readyReadStandardOutput()),
+	  this,SLOT(readyReadStandardOutputData()));
+  connect(host_process,SIGNAL(readyReadStandardError()),
+	  this,SLOT(readyReadStandardErrorData()));
+  connect(host_process,SIGNAL(finished(int,QProcess::ExitStatus)),
+	  this,SLOT(finishedData(int,QProcess::ExitStatus)));
+
+  host_watchdog_timer=new QTimer(this);
+  host_watchdog_timer->setSingleShot(true);
+  connect(host_watchdog_timer,SIGNAL(timeout()),this,SLOT(watchdogData()));
+}
+
+
+PypadHost::~PypadHost()
+{
+  if(host_process->state()!=QProcess::NotRunning) {
+    host_process->kill();
+    host_process->waitForFinished(1000);
+  }
+}
+
+
+int PypadHost::id() const
+{
+  return host_id;
+}
+
+
+void PypadHost::start()
+{
+  QStringList args;
+
+  args.push_back("-m");
+  args.push_back("pypad_host");
+  args.push_back("localhost");
+  args.push_back(QString().sprintf("%u",RD_PAD_CLIENT_TCP_PORT));
+  host_process->start(RD_PYPAD_PYTHON_PATH,args);
+  rda->syslog(LOG_INFO,"starting PyPAD host %d: %s %s",host_id,
+	      RD_PYPAD_PYTHON_PATH,(const char *)args.join(" ").toUtf8());
+}
+
+
+bool PypadHost::isRunning() const
+{
+  return host_process->state()!=QProcess::NotRunning;
+}
+
+
+void PypadHost::load(unsigned id,const QString &script_path)
+{
+  host_instances.insert(id);
+  host_process->write((QString().sprintf("LOAD\t%u\t",id)+script_path+
+		       QString().sprintf("\t$%u\n",id)).toUtf8());
+}
+
+
+void PypadHost::unload(unsigned id)
+{
+  host_process->write(QString().sprintf("UNLOAD\t%u\n",id).toUtf8());
+}
+
+
+bool PypadHost::contains(unsigned id) const
+{
+  return host_instances.contains(id);
+}
+
+
+int PypadHost::instanceQuantity() const
+{
+  return host_instances.size();
+}
+
+
+QList<unsigned> PypadHost::instances() const
+{
+  return host_instances.toList();
+}
+
+
+unsigned PypadHost::suspect() const
+{
+  return host_suspect;
+}
+
+
+bool PypadHost::crashed() const
+{
+  return host_hung||(host_process->exitStatus()==QProcess::CrashExit);
+}
+
+
+int PypadHost::exitCode() const
+{
+  return host_process->exitCode();
+}
+
+
+QString PypadHost::standardErrorData() const
+{
+  return QString::fromUtf8(host_standard_error_data);
+}
+
+
+void PypadHost::terminate()
+{
+  host_process->closeWriteChannel();
+  host_process->terminate();
+}
+
+
+void PypadHost::readyReadStandardOutputData()
+{
+  int offset=0;
+
+  host_accum+=host_process->readAllStandardOutput();
+  while((offset=host_accum.indexOf('\n'))>=0) {
+    ProcessStatus(QString::fromUtf8(host_accum.left(offset)).split("\t"));
+    host_accum=host_accum.mid(offset+1);
+  }
+}
+
+
+void PypadHost::readyReadStandardErrorData()
+{
+  host_standard_error_data+=host_process->readAllStandardError();
+  if(host_standard_error_data.size()>PYPAD_HOST_MAX_STDERR) {
+    host_standard_error_data=
+      host_standard_error_data.right(PYPAD_HOST_MAX_STDERR);
+  }
+}
+
+
+void PypadHost::finishedData(int exit_code,QProcess::ExitStatus status)
+{
+  host_watchdog_timer->stop();
+  if((status==QProcess::CrashExit)&&(host_suspect==0)) {
+    host_suspect=host_running;
+  }
+  emit finished(host_id);
+}
+
+
+void PypadHost::watchdogData()
+{
+  //
+  // An instance has kept the interpreter busy for too long; since it
+  // is holding up every other instance in the host, take the whole host
+  // down and let the engine move the instance elsewhere.
+  //
+  host_suspect=host_running;
+  host_hung=true;
+  rda->syslog(LOG_WARNING,
+	      "PyPAD instance %u hung in PyPAD host %d, killing host",
+	      host_running,host_id);
+  host_process->kill();
+}
+
+
+void PypadHost::ProcessStatus(const QStringList &fields)
+{
+  unsigned id=0;
+
+  if(fields.size()>=2) {
+    id=fields.at(1).toUInt();
+  }
+  if((fields.at(0)=="RUN")&&(fields.size()==2)) {
+    host_running=id;
+    host_watchdog_timer->start(1000*RD_PYPAD_HOST_TIMEOUT);
+  }
+  if(fields.at(0)=="IDLE") {
+    host_running=0;
+    host_watchdog_timer->stop();
+  }
+  if((fields.at(0)=="STARTED")&&(fields.size()==2)) {
+    emit instanceStarted(id);
+  }
+  if((fields.at(0)=="STOPPED")&&(fields.size()==2)) {
+    host_instances.remove(id);
+    emit instanceStopped(id);
+  }
+  if((fields.at(0)=="FAILED")&&(fields.size()==4)) {
+    host_instances.remove(id);
+    emit instanceFailed(id,fields.at(2).toInt(),Unescape(fields.at(3)));
+  }
+}
+
+
+QString PypadHost::Unescape(const QString &str)
+{
+  QString ret;
+
+  for(int i=0;i<str.length();i++) {
+    if((str.at(i)=='\\')&&((i+1)<str.length())) {
+      i++;
+      switch(str.at(i).toAscii()) {
+      case 'n':
+	ret+="\n";
+	break;
+
+      case 't':
+	ret+="\t";
+	break;
+
+      default:
+	ret+=str.at(i);
+	break;
+      }
+    }
+    else {
+      ret+=str.at(i);
+    }
+  }
+
+  return ret;
+}
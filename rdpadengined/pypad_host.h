@@ -0,0 +1,77 @@
+// pypad_host.h
+//
+// A shared Python interpreter running many PyPAD script instances
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef PYPAD_HOST_H
+#define PYPAD_HOST_H
+
+#include <qlist.h>
+#include <qobject.h>
+#include <qprocess.h>
+#include <qset.h>
+#include <qtimer.h>
+
+class PypadHost : public QObject
+{
+  Q_OBJECT
+ public:
+  PypadHost(int id,QObject *parent=0);
+  ~PypadHost();
+  int id() const;
+  void start();
+  bool isRunning() const;
+  void load(unsigned id,const QString &script_path);
+  void unload(unsigned id);
+  bool contains(unsigned id) const;
+  int instanceQuantity() const;
+  QList<unsigned> instances() const;
+  unsigned suspect() const;
+  bool crashed() const;
+  int exitCode() const;
+  QString standardErrorData() const;
+  void terminate();
+
+ signals:
+  void instanceStarted(unsigned id);
+  void instanceStopped(unsigned id);
+  void instanceFailed(unsigned id,int exit_code,const QString &err_text);
+  void finished(int host_id);
+
+ private slots:
+  void readyReadStandardOutputData();
+  void readyReadStandardErrorData();
+  void finishedData(int exit_code,QProcess::ExitStatus status);
+  void watchdogData();
+
+ private:
+  void ProcessStatus(const QStringList &fields);
+  static QString Unescape(const QString &str);
+  int host_id;
+  QProcess *host_process;
+  QTimer *host_watchdog_timer;
+  QSet<unsigned> host_instances;
+  QByteArray host_accum;
+  QByteArray host_standard_error_data;
+  unsigned host_running;
+  unsigned host_suspect;
+  bool host_hung;
+};
+
+
+#endif  // PYPAD_HOST_H
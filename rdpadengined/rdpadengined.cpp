@@ -2,7 +2,7 @@
 //
 // Rivendell PAD Consolidation Server
 //
-//   (C) Copyright 2018-2019 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2018-2019,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -52,6 +52,8 @@ MainObject::MainObject(QObject *parent)
   QString err_msg;
   RDApplication::ErrorType err_type=RDApplication::ErrorOk;
 
+  pad_next_host_id=1;
+
   //
   // Open the Database
   //
@@ -161,7 +163,12 @@ void MainObject::notificationReceivedData(RDNotification *notify)
      break;
 
     case RDNotification::DeleteAction:
-      pad_instances.value(id)->setPrivateData((void *)true);  // No Restart
+      if(pad_instances.value(id)!=NULL) {
+	pad_instances.value(id)->setPrivateData((void *)true);  // No Restart
+      }
+      else {
+	pad_no_restart.insert(id);
+      }
       KillScript(id);
       break;
 
@@ -219,6 +226,88 @@ void MainObject::instanceFinishedData(int id)
 }
 
 
+void MainObject::hostInstanceStartedData(unsigned id)
+{
+  SetRunStatus(id,true);
+}
+
+
+void MainObject::hostInstanceStoppedData(unsigned id)
+{
+  SetRunStatus(id,false);
+  if(!pad_no_restart.remove(id)) {
+    StartScript(id);
+  }
+}
+
+
+void MainObject::hostInstanceFailedData(unsigned id,int exit_code,
+					const QString &err_text)
+{
+  //
+  // As for a script exiting in a process of its own
+  //
+  if(exit_code==0) {
+    SetRunStatus(id,false);
+    if(!pad_no_restart.remove(id)) {
+      StartScript(id);
+    }
+    return;
+  }
+  pad_no_restart.remove(id);
+  rda->syslog(LOG_WARNING,"PyPAD script ID %d exited with code %d",
+	      id,exit_code);
+  SetRunStatus(id,false,exit_code,err_text);
+}
+
+
+void MainObject::hostFinishedData(int host_id)
+{
+  PypadHost *host=NULL;
+
+  for(int i=0;i<pad_hosts.size();i++) {
+    if(pad_hosts.at(i)->id()==host_id) {
+      host=pad_hosts.at(i);
+      pad_hosts.removeAt(i);
+      break;
+    }
+  }
+  if((host==NULL)||global_pad_exiting) {
+    return;
+  }
+  if(!host->crashed()) {
+    rda->syslog(LOG_WARNING,"PyPAD host %d exited with code %d",
+		host_id,host->exitCode());
+  }
+  QList<unsigned> ids=host->instances();
+  for(int i=0;i<ids.size();i++) {
+    unsigned id=ids.at(i);
+    SetRunStatus(id,false);
+    if(pad_no_restart.remove(id)) {
+      continue;
+    }
+    if(host->crashed()) {
+      //
+      // Move the instance that brought the host down to a process of its
+      // own, restarting the others in a new host. If the culprit can't
+      // be identified, isolate them all.
+      //
+      if((host->suspect()==0)||(host->suspect()==id)) {
+	rda->syslog(LOG_WARNING,
+		    "PyPAD script ID %u moved out of PyPAD host %d",
+		    id,host_id);
+	pad_isolated.insert(id);
+      }
+      StartScript(id);
+    }
+    else {
+      SetRunStatus(id,false,host->exitCode(),host->standardErrorData());
+    }
+  }
+  host->deleteLater();
+}
+
+
 void MainObject::exitData()
 {
   if(global_pad_exiting) {
@@ -230,6 +319,9 @@ void MainObject::exitData()
       it.value()->setPrivateData((void *)true);  // No Restart
       it.value()->process()->terminate();
     }
+    for(int i=0;i<pad_hosts.size();i++) {
+      pad_hosts.at(i)->terminate();
+    }
 
     //
     // Update Database
@@ -250,6 +342,9 @@ bool MainObject::ScriptIsActive(unsigned id) const
   if(pad_instances.value(id)!=NULL) {
     ret=pad_instances.value(id)->process()->state()!=QProcess::NotRunning;
   }
+  if(HostOf(id)!=NULL) {
+    ret=true;
+  }
 
   return ret;
 }
@@ -262,6 +357,12 @@ void MainObject::StartScript(unsigned id)
     "STATION_NAME=\""+RDEscapeString(rda->station()->name())+"\"";
   RDSqlQuery *q=new RDSqlQuery(sql);
   if(q->first()) {
+    if((rda->config()->pypadHostInstances()>0)&&
+       (!pad_isolated.contains(id))) {
+      StartHostedScript(id,q->value(0).toString());
+      delete q;
+      return;
+    }
     RDProcess *proc=new RDProcess(id,this);
     pad_instances[id]=proc;
     connect(proc,SIGNAL(started(int)),this,SLOT(instanceStartedData(int)));
@@ -279,9 +380,58 @@ void MainObject::StartScript(unsigned id)
 }
 
 
+void MainObject::StartHostedScript(unsigned id,const QString &script_path)
+{
+  PypadHost *host=NULL;
+
+  for(int i=0;i<pad_hosts.size();i++) {
+    if(pad_hosts.at(i)->isRunning()&&
+       (pad_hosts.at(i)->instanceQuantity()<
+	rda->config()->pypadHostInstances())) {
+      host=pad_hosts.at(i);
+      break;
+    }
+  }
+  if(host==NULL) {
+    host=new PypadHost(pad_next_host_id++,this);
+    connect(host,SIGNAL(instanceStarted(unsigned)),
+	    this,SLOT(hostInstanceStartedData(unsigned)));
+    connect(host,SIGNAL(instanceStopped(unsigned)),
+	    this,SLOT(hostInstanceStoppedData(unsigned)));
+    connect(host,SIGNAL(instanceFailed(unsigned,int,const QString &)),
+	    this,SLOT(hostInstanceFailedData(unsigned,int,const QString &)));
+    connect(host,SIGNAL(finished(int)),this,SLOT(hostFinishedData(int)));
+    pad_hosts.push_back(host);
+    host->start();
+  }
+  host->load(id,script_path);
+  rda->syslog(LOG_INFO,"loading %s as ID %u in PyPAD host %d",
+	      (const char *)script_path.toUtf8(),id,host->id());
+}
+
+
+PypadHost *MainObject::HostOf(unsigned id) const
+{
+  for(int i=0;i<pad_hosts.size();i++) {
+    if(pad_hosts.at(i)->contains(id)) {
+      return pad_hosts.at(i);
+    }
+  }
+  return NULL;
+}
+
+
 void MainObject::KillScript(unsigned id)
 {
-  pad_instances.value(id)->process()->terminate();
+  PypadHost *host=NULL;
+
+  if((host=HostOf(id))!=NULL) {
+    host->unload(id);
+    return;
+  }
+  if(pad_instances.value(id)!=NULL) {
+    pad_instances.value(id)->process()->terminate();
+  }
 }
 
 
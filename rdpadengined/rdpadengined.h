@@ -2,7 +2,7 @@
 //
 // Rivendell PAD Consolidation Server
 //
-//   (C) Copyright 2018-2019 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2018-2019,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -21,14 +21,18 @@
 #ifndef RDPADENGINED_H
 #define RDPADENGINED_H
 
+#include <qlist.h>
 #include <qmap.h>
 #include <qobject.h>
 #include <qprocess.h>
+#include <qset.h>
 #include <qtimer.h>
 
 #include <rdnotification.h>
 #include <rdprocess.h>
 
+#include "pypad_host.h"
+
 #define RDPADENGINED_USAGE "\n\n"
 
 
@@ -43,15 +47,26 @@ class MainObject : public QObject
   void notificationReceivedData(RDNotification *notify);
   void instanceStartedData(int id);
   void instanceFinishedData(int id);
+  void hostInstanceStartedData(unsigned id);
+  void hostInstanceStoppedData(unsigned id);
+  void hostInstanceFailedData(unsigned id,int exit_code,
+			      const QString &err_text);
+  void hostFinishedData(int host_id);
   void exitData();
 
  private:
   bool ScriptIsActive(unsigned id) const;
   void StartScript(unsigned id);
+  void StartHostedScript(unsigned id,const QString &script_path);
+  PypadHost *HostOf(unsigned id) const;
   void KillScript(unsigned id);
   void SetRunStatus(unsigned id,bool state,int exit_code=0,
 		    const QString &err_text=QString()) const;
   QMap<unsigned,RDProcess *> pad_instances;
+  QList<PypadHost *> pad_hosts;
+  QSet<unsigned> pad_isolated;
+  QSet<unsigned> pad_no_restart;
+  int pad_next_host_id;
   QTimer *pad_exit_timer;
 };
 
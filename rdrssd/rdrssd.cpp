@@ -2,7 +2,7 @@
 //
 // Rivendell RSS Processor Service
 //
-//   (C) Copyright 2020-2022 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2020-2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -19,13 +19,16 @@
 //
 
 #include <errno.h>
+#include <pthread.h>
 #include <stdio.h>
 
+#include <curl/curl.h>
+
 #include <QCoreApplication>
 
 #include <rdapplication.h>
 #include <rdescape_string.h>
-#include <rdfeed.h>
+#include <rdhash.h>
 #include <rdpodcast.h>
 
 #include "rdrssd.h"
@@ -84,6 +87,11 @@ MainObject::MainObject(QObject *parent)
     }
   }
 
+  //
+  // Initialize CURL before any posting threads are started
+  //
+  curl_global_init(CURL_GLOBAL_ALL);
+
   //
   // Connect to ripcd(8)
   //
@@ -102,36 +110,111 @@ MainObject::MainObject(QObject *parent)
 }
 
 
+//
+// Shared state for the threads posting feed XML. The results are chars
+// rather than bools so that each thread writes a byte of its own.
+//
+class PostQueue
+{
+ public:
+  const std::vector<RDFeed *> *feeds;
+  std::vector<char> *results;
+  unsigned next;
+  pthread_mutex_t mutex;
+  QString ws_url;
+  QString login_name;
+  QString password;
+};
+
+
+void *__PostThreadCallback(void *priv)
+{
+  PostQueue *queue=(PostQueue *)priv;
+  unsigned n;
+
+  while(1) {
+    pthread_mutex_lock(&queue->mutex);
+    n=queue->next++;
+    pthread_mutex_unlock(&queue->mutex);
+    if(n>=queue->feeds->size()) {
+      return NULL;
+    }
+    (*queue->results)[n]=queue->feeds->at(n)->
+      postXml(queue->ws_url,queue->login_name,queue->password);
+  }
+  return NULL;
+}
+
+
 void MainObject::timeoutData()
 {
   QString sql;
   RDSqlQuery *q=NULL;
+  QDateTime now=QDateTime::currentDateTime();
+  std::vector<RDFeed *> feeds;
+  std::vector<char> results;
 
+  //
+  // Apply all changes first, collecting the feeds needing a repost
+  //
   sql=QString("select ")+
     "KEY_NAME "+  // 00
     "from FEEDS where "+
     "IS_SUPERFEED='N'";
   q=new RDSqlQuery(sql);
   while(q->next()) {
-    ProcessFeed(q->value(0).toString());
+    RDFeed *feed=new RDFeed(q->value(0).toString(),rda->config(),this);
+    if(ProcessFeed(feed,now)) {
+      feeds.push_back(feed);
+    }
+    else {
+      delete feed;
+    }
   }
   delete q;
 
+  //
+  // Post each changed feed once
+  //
+  PostFeeds(feeds,&results);
+  for(unsigned i=0;i<feeds.size();i++) {
+    QString key_name=feeds.at(i)->keyName();
+    if(results.at(i)) {
+      rda->syslog(LOG_DEBUG,"reposted XML for feed \"%s\"",
+		  key_name.toUtf8().constData());
+      d_xml_hashes[key_name]=d_pending_hashes.value(key_name);
+      d_build_datetimes[key_name]=feeds.at(i)->lastBuildDateTime();
+      rda->ripc()->sendNotification(RDNotification::FeedType,
+				    RDNotification::ModifyAction,key_name);
+    }
+    else {
+      rda->syslog(LOG_WARNING,"repost of XML for feed \"%s\" failed",
+		  key_name.toUtf8().constData());
+      d_xml_hashes.remove(key_name);
+      d_build_datetimes.remove(key_name);
+    }
+    delete feeds.at(i);
+  }
+  d_pending_hashes.clear();
+
   d_timer->start(d_process_interval);
 }
 
 
-void MainObject::ProcessFeed(const QString &key_name)
+bool MainObject::ProcessFeed(RDFeed *feed,const QDateTime &now)
 {
   QString sql;
   RDSqlQuery *q=NULL;
-  QDateTime now=QDateTime::currentDateTime();
   QString now_str="\""+now.toString("yyyy-MM-dd hh:mm:ss")+"\"";
+  QString key_name=feed->keyName();
   QString err_msg;
-  RDFeed *feed=new RDFeed(key_name,rda->config(),this);
+  int changes=0;
+  int deletes=0;
+  bool ok=false;
 
   //
-  // Update Posted XML
+  // Find casts that have become effective or have expired since the
+  // last build
   //
   sql=QString("select ")+
     "PODCASTS.ID,"+                   // 00
@@ -145,7 +228,7 @@ void MainObject::ProcessFeed(const QString &key_name)
     "(PODCASTS.EXPIRATION_DATETIME<"+now_str+"))";
   q=new RDSqlQuery(sql);
   while(q->next()) {
-    bool deleted=false;
+    changes++;
     if((!q->value(1).isNull())&&(q->value(1).toDateTime()<now)) {
       // Delete expired cast
       RDPodcast *cast=new RDPodcast(rda->config(),q->value(0).toUInt());
@@ -154,7 +237,7 @@ void MainObject::ProcessFeed(const QString &key_name)
 		    "audio purge failed for cast %u [%s] on feed \"%s\" [%s]",
 		    q->value(0).toUInt(),
 		    cast->itemTitle().toUtf8().constData(),
-		    feed->keyName().toUtf8().constData(),
+		    key_name.toUtf8().constData(),
 		    err_msg.toUtf8().constData());
       }
       sql=QString("delete from PODCASTS where ")+
@@ -162,38 +245,100 @@ void MainObject::ProcessFeed(const QString &key_name)
       RDSqlQuery::apply(sql);
       rda->syslog(LOG_INFO,"purged cast %u [%s] from feed \"%s\"",
 		  q->value(0).toUInt(),cast->itemTitle().toUtf8().constData(),
-		  feed->keyName().toUtf8().constData());
+		  key_name.toUtf8().constData());
       delete cast;
 
-      rda->ripc()->sendNotification(RDNotification::FeedType,
-				 RDNotification::ModifyAction,feed->keyName());
       rda->ripc()->sendNotification(RDNotification::FeedItemType,
 				    RDNotification::DeleteAction,
 				    q->value(0).toUInt());
-      deleted=true;
-    }
-    if(feed->postXml()) {
-      rda->syslog(LOG_DEBUG,
-		  "repost of XML for feed \"%s\" triggered by cast id %u",
-		  key_name.toUtf8().constData(),q->value(0).toUInt());
-      if(!deleted) {
-	rda->ripc()->sendNotification(RDNotification::FeedType,
-				      RDNotification::ModifyAction,
-				      feed->keyName());
-	rda->ripc()->sendNotification(RDNotification::FeedType,
-				      RDNotification::ModifyAction,
-				      feed->keyName());
-      }
-    }
-    else {
-      rda->syslog(LOG_WARNING,
-       	  "repost of XML for feed \"%s\" triggered by cast id %u failed",
-		  key_name.toUtf8().constData(),q->value(0).toUInt());
+      deletes++;
     }
   }
   delete q;
+  if(changes==0) {
+    return false;
+  }
+  rda->syslog(LOG_DEBUG,"feed \"%s\": %d cast(s) changed, %d purged",
+	      key_name.toUtf8().constData(),changes,deletes);
+
+  //
+  // Someone else has posted the feed since we last did, so our copy of
+  // the posted content can no longer be trusted
+  //
+  if(d_build_datetimes.value(key_name)!=feed->lastBuildDateTime()) {
+    d_xml_hashes.remove(key_name);
+    d_build_datetimes.remove(key_name);
+  }
+
+  //
+  // Render the content, less the build date, and compare it with what
+  // was last posted
+  //
+  QString hash=
+    RDSha1HashData(feed->rssXml(&err_msg,QDateTime(),&ok).toUtf8());
+  if(ok&&d_xml_hashes.contains(key_name)&&
+     (d_xml_hashes.value(key_name)==hash)) {
+    rda->syslog(LOG_DEBUG,
+		"XML for feed \"%s\" is unchanged, skipping repost",
+		key_name.toUtf8().constData());
+    feed->setLastBuildDateTime(now);
+    d_build_datetimes[key_name]=feed->lastBuildDateTime();
+    if(deletes>0) {
+      rda->ripc()->sendNotification(RDNotification::FeedType,
+				    RDNotification::ModifyAction,key_name);
+    }
+    return false;
+  }
+  if(ok) {
+    d_pending_hashes[key_name]=hash;
+  }
+
+  return true;
+}
+
+
+void MainObject::PostFeeds(const std::vector<RDFeed *> &feeds,
+			   std::vector<char> *results)
+{
+  PostQueue queue;
+  pthread_t threads[RDRSSD_MAX_POST_THREADS];
+  unsigned thread_quan=feeds.size();
+
+  results->clear();
+  if(feeds.size()==0) {
+    return;
+  }
+  results->resize(feeds.size(),0);
 
-  delete feed;
+  //
+  // The database is only accessed from here, not from the posting threads
+  //
+  queue.feeds=&feeds;
+  queue.results=results;
+  queue.next=0;
+  pthread_mutex_init(&queue.mutex,NULL);
+  queue.ws_url=rda->station()->webServiceUrl(rda->config());
+  queue.login_name=rda->user()->name();
+  queue.password=rda->user()->password();
+
+  if(thread_quan>RDRSSD_MAX_POST_THREADS) {
+    thread_quan=RDRSSD_MAX_POST_THREADS;
+  }
+  for(unsigned i=0;i<thread_quan;i++) {
+    if(pthread_create(&threads[i],NULL,__PostThreadCallback,&queue)!=0) {
+      rda->syslog(LOG_WARNING,"unable to start posting thread [%s]",
+		  strerror(errno));
+      thread_quan=i;
+      break;
+    }
+  }
+  if(thread_quan==0) {
+    __PostThreadCallback(&queue);
+  }
+  for(unsigned i=0;i<thread_quan;i++) {
+    pthread_join(threads[i],NULL);
+  }
+  pthread_mutex_destroy(&queue.mutex);
 }
 
 
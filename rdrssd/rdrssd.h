@@ -2,7 +2,7 @@
 //
 // Rivendell RSS Processor Service
 //
-//   (C) Copyright 2020-2022 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2020-2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -21,10 +21,17 @@
 #ifndef RDRSSD_H
 #define RDRSSD_H
 
+#include <vector>
+
+#include <QDateTime>
+#include <QMap>
 #include <QObject>
 #include <QTimer>
 
+#include <rdfeed.h>
+
 #define RDRSSD_DEFAULT_PROCESS_INTERVAL 30000
+#define RDRSSD_MAX_POST_THREADS 4
 #define RDRSSD_USAGE "[--process-interval=<secs>]\n\n"
 
 class MainObject : public QObject
@@ -37,9 +44,14 @@ class MainObject : public QObject
   void timeoutData();
 
  private:
-  void ProcessFeed(const QString &key_name);
+  bool ProcessFeed(RDFeed *feed,const QDateTime &now);
+  void PostFeeds(const std::vector<RDFeed *> &feeds,
+		 std::vector<char> *results);
   int d_process_interval;
   QTimer *d_timer;
+  QMap<QString,QString> d_xml_hashes;
+  QMap<QString,QString> d_pending_hashes;
+  QMap<QString,QDateTime> d_build_datetimes;
 };
 
 
@@ -2,7 +2,7 @@
 //
 // Headless log player
 //
-//   (C) Copyright 2018 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2018,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -29,9 +29,11 @@
 
 #include <rdapplication.h>
 #include <rdconf.h>
+#include <rdcutrotation.h>
 #include <rddatedecode.h>
 #include <rddbheartbeat.h>
 #include <rdescape_string.h>
+#include <rdmacrocartcache.h>
 #include <rdmixer.h>
 #include <rdweb.h>
 
@@ -106,6 +108,16 @@ MainObject::MainObject(QObject *parent)
   rda->ripc()->
     connectHost("localhost",RIPCD_TCP_PORT,rda->config()->password());
 
+  //
+  // Cut Rotation
+  //
+  new RDCutRotation(rda->ripc(),this);
+
+  //
+  // Macro Cart Cache
+  //
+  new RDMacroCartCache(rda->ripc(),this);
+
   //
   // Macro Player
   //
@@ -2,7 +2,7 @@
 //
 // Rivendell Interprocess Communication Daemon
 //
-//   (C) Copyright 2002-2020 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2020,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -252,8 +252,11 @@ void MainObject::notificationReceivedData(const QString &msg,
     delete notify;
     return;
   }
-  RunLocalNotifications(notify);
-  BroadcastCommand("ON "+msg+"!");
+  QList<RDNotification> notifies=notify->split();
+  for(int i=0;i<notifies.size();i++) {
+    RunLocalNotifications(&notifies[i]);
+  }
+  BroadcastNotification(notify);
 
   delete notify;
 }
@@ -622,18 +625,23 @@ bool MainObject::DispatchCommand(RipcdConnection *conn)
       delete notify;
       return true;
     }
-    RunLocalNotifications(notify);
-    BroadcastCommand("ON "+msg+"!",conn->id());
-    ripcd_notification_mcaster->
-      send(msg,rda->system()->notificationAddress(),RD_NOTIFICATION_PORT);
-    rda->syslog(LOG_DEBUG,"sent notification: \"%s\" to %s:%d",
-		(const char *)msg.toUtf8(),
-		(const char *)rda->system()->notificationAddress().
-		toString().toUtf8(),
-		RD_NOTIFICATION_PORT);
+    QList<RDNotification> notifies=notify->split();
+    for(int i=0;i<notifies.size();i++) {
+      RunLocalNotifications(&notifies[i]);
+    }
+    BroadcastNotification(notify,conn->id());
+    MulticastNotification(notify);
     delete notify;
   }
 
+  if((cmds[0]=="NV")&&(cmds.size()==2)) {  // Notification Version
+    if(cmds[1].toInt()>=RD_NOTIFICATION_BINARY_VERSION) {
+      conn->setNotificationVersion(RD_NOTIFICATION_BINARY_VERSION);
+    }
+    EchoCommand(conn->id(),
+		QString().sprintf("NV %d!",conn->notificationVersion()));
+  }
+
   if(cmds[0]=="TA") {  // Send Onair Flag State
     EchoCommand(conn->id(),QString().sprintf("TA %d!",ripc_onair_flag));
   }
@@ -663,6 +671,60 @@ void MainObject::BroadcastCommand(const QString &cmd,int except_ch)
 }
 
 
+void MainObject::BroadcastNotification(RDNotification *notify,int except_ch)
+{
+  QString binary;
+  QStringList texts;
+
+  for(unsigned i=0;i<ripcd_conns.size();i++) {
+    if(((int)i!=except_ch)&&(ripcd_conns[i]!=NULL)) {
+      if(ripcd_conns[i]->notificationVersion()>=
+	 RD_NOTIFICATION_BINARY_VERSION) {
+	if(binary.isEmpty()) {
+	  binary="ON "+notify->writeBinary()+"!";
+	}
+	EchoCommand(i,binary);
+      }
+      else {
+	if(texts.size()==0) {
+	  QList<RDNotification> notifies=notify->split();
+	  for(int j=0;j<notifies.size();j++) {
+	    texts.push_back("ON "+notifies.at(j).write()+"!");
+	  }
+	}
+	EchoCommand(i,texts.join(""));
+      }
+    }
+  }
+}
+
+
+void MainObject::MulticastNotification(RDNotification *notify)
+{
+  QStringList msgs;
+
+  if(rda->config()->binaryNotifications()) {
+    msgs.push_back(notify->writeBinary());
+  }
+  else {
+    QList<RDNotification> notifies=notify->split();
+    for(int i=0;i<notifies.size();i++) {
+      msgs.push_back(notifies.at(i).write());
+    }
+  }
+  for(int i=0;i<msgs.size();i++) {
+    ripcd_notification_mcaster->
+      send(msgs.at(i),rda->system()->notificationAddress(),
+	   RD_NOTIFICATION_PORT);
+    rda->syslog(LOG_DEBUG,"sent notification: \"%s\" to %s:%d",
+		(const char *)msgs.at(i).toUtf8(),
+		(const char *)rda->system()->notificationAddress().
+		toString().toUtf8(),
+		RD_NOTIFICATION_PORT);
+  }
+}
+
+
 void MainObject::ReadRmlSocket(QUdpSocket *sock,RDMacro::Role role,
 			       bool echo)
 {
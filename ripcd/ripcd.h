@@ -2,7 +2,7 @@
 //
 // Rivendell Interprocess Communication Daemon
 //
-//   (C) Copyright 2002-2020 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2002-2020,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -91,6 +91,8 @@ class MainObject : public QObject
   bool DispatchCommand(RipcdConnection *conn);
   void EchoCommand(int,const QString &cmd);
   void BroadcastCommand(const QString &cmd,int except_ch=-1);
+  void BroadcastNotification(RDNotification *notify,int except_ch=-1);
+  void MulticastNotification(RDNotification *notify);
   void ReadRmlSocket(QUdpSocket *sock,RDMacro::Role role,bool echo);
   QString StripPoint(QString);
   void LoadLocalMacros();
@@ -2,7 +2,7 @@
 //
 // Rivendell Interprocess Communication Daemon
 //
-//   (C) Copyright 2010,2016 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2010,2016,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -24,6 +24,7 @@ RipcdConnection::RipcdConnection(int id,QTcpSocket *sock)
 {
   ripcd_id=id;
   ripcd_authenticated=false;
+  ripcd_notification_version=1;
   accum="";
   ripcd_socket=sock;
   ripcd_closing=false;
@@ -60,6 +61,18 @@ void RipcdConnection::setAuthenticated(bool state)
 }
 
 
+int RipcdConnection::notificationVersion() const
+{
+  return ripcd_notification_version;
+}
+
+
+void RipcdConnection::setNotificationVersion(int ver)
+{
+  ripcd_notification_version=ver;
+}
+
+
 bool RipcdConnection::isClosing() const
 {
   return ripcd_closing;
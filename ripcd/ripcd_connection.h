@@ -2,7 +2,7 @@
 //
 // Rivendell Interprocess Communication Daemon
 //
-//   (C) Copyright 2010,2016 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2010,2016,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -36,6 +36,8 @@ class RipcdConnection
    QTcpSocket *socket() const;
    bool isAuthenticated() const;
    void setAuthenticated(bool state);
+   int notificationVersion() const;
+   void setNotificationVersion(int ver);
    bool isClosing() const;
    void close();
    QString accum;
@@ -43,6 +45,7 @@ class RipcdConnection
  private:
    int ripcd_id;
    bool ripcd_authenticated;
+   int ripcd_notification_version;
    QTcpSocket *ripcd_socket;
    bool ripcd_closing;
 };
@@ -0,0 +1,233 @@
+// bootstrap_test.cpp
+//
+// Count the queries made when opening the RDApplication accessors
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <qapplication.h>
+
+#include <rdairplay_conf.h>
+#include <rdapplication.h>
+#include <rddb.h>
+#include <rdlibrary_conf.h>
+#include <rdlogedit_conf.h>
+#include <rdsnapshot.h>
+#include <rdstation.h>
+#include <rdsystem.h>
+
+#include "bootstrap_test.h"
+
+MainObject::MainObject(QObject *parent)
+  :QObject(parent)
+{
+  QString err_msg;
+  unsigned iterations=100;
+  bool ok=false;
+  QStringList legacy;
+  QStringList current;
+  unsigned start_queries;
+  unsigned legacy_queries;
+  unsigned current_queries;
+  uint64_t start;
+  double legacy_secs;
+  double current_secs;
+  unsigned errors=0;
+
+  rda=new RDApplication("bootstrap_test","bootstrap_test",
+			BOOTSTRAP_TEST_USAGE,this);
+  if(!rda->open(&err_msg)) {
+    fprintf(stderr,"bootstrap_test: %s\n",(const char *)err_msg);
+    exit(1);
+  }
+
+  for(unsigned i=0;i<rda->cmdSwitch()->keys();i++) {
+    if(rda->cmdSwitch()->key(i)=="--iterations") {
+      iterations=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if((!ok)||(iterations==0)) {
+	fprintf(stderr,"bootstrap_test: invalid --iterations\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(!rda->cmdSwitch()->processed(i)) {
+      fprintf(stderr,"bootstrap_test: unknown command option \"%s\"\n",
+	      (const char *)rda->cmdSwitch()->key(i));
+      exit(2);
+    }
+  }
+
+  //
+  // Original path: a query for every value
+  //
+  start_queries=RDSqlQuery::executed();
+  start=Now();
+  for(unsigned i=0;i<iterations;i++) {
+    RDSnapshot::clear();
+    legacy=Read();
+  }
+  legacy_secs=(double)(Now()-start)/1000000.0;
+  legacy_queries=(RDSqlQuery::executed()-start_queries)/iterations;
+
+  //
+  // Bulk load, then read from the snapshot
+  //
+  start_queries=RDSqlQuery::executed();
+  start=Now();
+  for(unsigned i=0;i<iterations;i++) {
+    RDSnapshot::clear();
+    RDSnapshot::bootstrap(rda->config()->stationName());
+    current=Read();
+  }
+  current_secs=(double)(Now()-start)/1000000.0;
+  current_queries=(RDSqlQuery::executed()-start_queries)/iterations;
+  RDSnapshot::clear();
+
+  if(legacy.size()!=current.size()) {
+    printf("  %d values read originally, %d through the snapshot\n",
+	   legacy.size(),current.size());
+    errors++;
+  }
+  else {
+    for(int i=0;i<legacy.size();i++) {
+      if(legacy.at(i)!=current.at(i)) {
+	printf("  MISMATCH: value %d: \"%s\" vs. \"%s\"\n",i,
+	       (const char *)legacy.at(i).toUtf8(),
+	       (const char *)current.at(i).toUtf8());
+	errors++;
+      }
+    }
+  }
+
+  printf("%d values, %u iterations:\n",legacy.size(),iterations);
+  printf("  original:  %4u queries  %8.3lf mS\n",legacy_queries,
+	 1000.0*legacy_secs/(double)iterations);
+  printf("  snapshot:  %4u queries  %8.3lf mS\n",current_queries,
+	 1000.0*current_secs/(double)iterations);
+
+  if(errors>0) {
+    printf("FAILED: %u mismatch(es)\n",errors);
+    exit(1);
+  }
+  printf("PASSED\n");
+  exit(0);
+}
+
+
+QStringList MainObject::Read() const
+{
+  QStringList ret;
+  QString name=rda->config()->stationName();
+
+  //
+  // The accessors created by RDApplication::open() and the values
+  // commonly read from them when a module starts
+  //
+  RDStation *station=new RDStation(name);
+  RDSystem *system=new RDSystem();
+  RDLibraryConf *library=new RDLibraryConf(name);
+  RDLogeditConf *logedit=new RDLogeditConf(name);
+  RDAirPlayConf *airplay=new RDAirPlayConf(name,"RDAIRPLAY");
+  RDAirPlayConf *panel=new RDAirPlayConf(name,"RDPANEL");
+
+  ret.push_back(station->shortName());
+  ret.push_back(station->description());
+  ret.push_back(station->userName());
+  ret.push_back(station->defaultName());
+  ret.push_back(station->address().toString());
+  ret.push_back(station->httpStation());
+  ret.push_back(station->caeStation());
+  ret.push_back(QString().sprintf("%u",station->heartbeatCart()));
+  ret.push_back(QString().sprintf("%u",station->heartbeatInterval()));
+  ret.push_back(QString().sprintf("%u",station->startupCart()));
+  ret.push_back(station->editorPath());
+  ret.push_back(station->browserPath());
+  ret.push_back(QString().sprintf("%d",station->filterMode()));
+  ret.push_back(QString().sprintf("%d",station->startJack()));
+  ret.push_back(station->jackServerName());
+  ret.push_back(QString().sprintf("%d",station->cueCard()));
+  ret.push_back(QString().sprintf("%d",station->cuePort()));
+  ret.push_back(QString().sprintf("%d",station->cartSlotColumns()));
+  ret.push_back(QString().sprintf("%d",station->cartSlotRows()));
+  ret.push_back(QString().sprintf("%d",station->enableDragdrop()));
+  ret.push_back(QString().sprintf("%d",station->enforcePanelSetup()));
+
+  ret.push_back(QString().sprintf("%u",system->sampleRate()));
+  ret.push_back(QString().sprintf("%u",system->maxPostLength()));
+  ret.push_back(system->isciXreferencePath());
+
+  ret.push_back(QString().sprintf("%d",library->inputCard()));
+  ret.push_back(QString().sprintf("%d",library->outputCard()));
+  ret.push_back(QString().sprintf("%d",library->voxThreshold()));
+  ret.push_back(QString().sprintf("%u",library->defaultFormat()));
+  ret.push_back(QString().sprintf("%u",library->defaultChannels()));
+  ret.push_back(QString().sprintf("%u",library->maxLength()));
+  ret.push_back(library->ripperDevice());
+  ret.push_back(QString().sprintf("%d",library->paranoiaLevel()));
+  ret.push_back(library->cddbServer());
+  ret.push_back(QString().sprintf("%d",library->srcConverter()));
+  ret.push_back(QString().sprintf("%d",library->limitSearch()));
+
+  ret.push_back(QString().sprintf("%d",logedit->inputCard()));
+  ret.push_back(QString().sprintf("%d",logedit->outputCard()));
+  ret.push_back(QString().sprintf("%u",logedit->format()));
+  ret.push_back(QString().sprintf("%u",logedit->bitrate()));
+  ret.push_back(QString().sprintf("%u",logedit->maxLength()));
+  ret.push_back(QString().sprintf("%u",logedit->startCart()));
+
+  ret.push_back(QString().sprintf("%d",airplay->segueLength()));
+  ret.push_back(QString().sprintf("%d",airplay->transLength()));
+  ret.push_back(QString().sprintf("%d",airplay->pieCountLength()));
+  ret.push_back(QString().sprintf("%d",airplay->flashPanel()));
+  ret.push_back(airplay->buttonLabelTemplate());
+  ret.push_back(airplay->defaultSvc());
+  ret.push_back(airplay->titleTemplate());
+  ret.push_back(airplay->skinPath());
+  ret.push_back(QString().sprintf("%d",panel->flashPanel()));
+  ret.push_back(panel->buttonLabelTemplate());
+  ret.push_back(panel->skinPath());
+
+  delete panel;
+  delete airplay;
+  delete logedit;
+  delete library;
+  delete system;
+  delete station;
+
+  return ret;
+}
+
+
+uint64_t MainObject::Now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return 1000000*(uint64_t)ts.tv_sec+(uint64_t)ts.tv_nsec/1000;
+}
+
+
+int main(int argc,char *argv[])
+{
+  QApplication a(argc,argv,false);
+  new MainObject();
+  return a.exec();
+}
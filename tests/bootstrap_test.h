@@ -0,0 +1,42 @@
+// bootstrap_test.h
+//
+// Count the queries made when opening the RDApplication accessors
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef BOOTSTRAP_TEST_H
+#define BOOTSTRAP_TEST_H
+
+#include <stdint.h>
+
+#include <qobject.h>
+#include <qstringlist.h>
+
+#define BOOTSTRAP_TEST_USAGE "[options]\n\nCreate the configuration accessors opened by RDApplication and read the\nsettings typically used at program startup, first straight from the\ndatabase and then through an RDSnapshot, checking that both give the\nsame values and counting the queries and time taken by each.\n\nOptions are:\n--iterations=<num>\n     Number of times to repeat each method. Default is 100.\n\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  QStringList Read() const;
+  static uint64_t Now();
+};
+
+
+#endif  // BOOTSTRAP_TEST_H
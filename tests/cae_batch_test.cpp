@@ -0,0 +1,257 @@
+// cae_batch_test.cpp
+//
+// Check that playback started in a caed(8) batch lands together
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <qapplication.h>
+#include <qeventloop.h>
+#include <qtimer.h>
+
+#include <rdapplication.h>
+#include <rdcut.h>
+#include <rddb.h>
+
+#include "cae_batch_test.h"
+
+MainObject::MainObject(QObject *parent)
+  :QObject(parent)
+{
+  QString err_msg;
+  unsigned trials=5;
+  unsigned period=0;
+  bool ok=false;
+  int spread;
+  int max_spread[2]={0,0};
+  int total_spread[2]={0,0};
+
+  test_card=0;
+  test_decks=4;
+  test_delay=0;
+
+  rda=new RDApplication("cae_batch_test","cae_batch_test",
+			CAE_BATCH_TEST_USAGE,this);
+  if(!rda->open(&err_msg)) {
+    fprintf(stderr,"cae_batch_test: %s\n",(const char *)err_msg);
+    exit(1);
+  }
+  period=rda->config()->alsaPeriodSize();
+
+  for(unsigned i=0;i<rda->cmdSwitch()->keys();i++) {
+    if(rda->cmdSwitch()->key(i)=="--cut") {
+      unsigned cartnum=RDCut::cartNumber(rda->cmdSwitch()->value(i));
+      unsigned cutnum=RDCut::cutNumber(rda->cmdSwitch()->value(i));
+      if((cartnum==0)||(cartnum>RD_MAX_CART_NUMBER)||(cutnum==0)) {
+	fprintf(stderr,"cae_batch_test: invalid --cut\n");
+	exit(1);
+      }
+      test_cutname=RDCut::cutName(cartnum,cutnum);
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--card") {
+      test_card=rda->cmdSwitch()->value(i).toInt(&ok);
+      if((!ok)||(test_card<0)||(test_card>=RD_MAX_CARDS)) {
+	fprintf(stderr,"cae_batch_test: invalid --card\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--decks") {
+      test_decks=rda->cmdSwitch()->value(i).toInt(&ok);
+      if((!ok)||(test_decks<2)||(test_decks>RD_MAX_STREAMS)) {
+	fprintf(stderr,"cae_batch_test: invalid --decks\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--trials") {
+      trials=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if((!ok)||(trials==0)) {
+	fprintf(stderr,"cae_batch_test: invalid --trials\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--delay") {
+      test_delay=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if((!ok)||(test_delay>10000)) {
+	fprintf(stderr,"cae_batch_test: invalid --delay\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--period") {
+      period=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if((!ok)||(period==0)) {
+	fprintf(stderr,"cae_batch_test: invalid --period\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(!rda->cmdSwitch()->processed(i)) {
+      fprintf(stderr,"cae_batch_test: unknown command option \"%s\"\n",
+	      (const char *)rda->cmdSwitch()->key(i));
+      exit(2);
+    }
+  }
+  if(test_cutname.isEmpty()) {
+    QString sql=QString("select ")+
+      "CUT_NAME "+  // 00
+      "from CUTS where LENGTH>=30000 order by CUT_NAME limit 1";
+    RDSqlQuery *q=new RDSqlQuery(sql);
+    if(q->first()) {
+      test_cutname=q->value(0).toString();
+    }
+    delete q;
+  }
+  if(test_cutname.isEmpty()) {
+    fprintf(stderr,"cae_batch_test: no cut found, use --cut\n");
+    exit(1);
+  }
+
+  //
+  // Connect to caed(8)
+  //
+  QList<int> cards;
+  cards.push_back(test_card);
+  rda->cae()->connectHost();
+  rda->cae()->enableMetering(&cards);
+  Wait(500);
+
+  //
+  // One Play command per stream, then all of them in a batch
+  //
+  for(int i=0;i<2;i++) {
+    for(unsigned j=0;j<trials;j++) {
+      if((spread=Trial(i==1))<0) {
+	fprintf(stderr,"cae_batch_test: no play positions received\n");
+	exit(1);
+      }
+      total_spread[i]+=spread;
+      if(spread>max_spread[i]) {
+	max_spread[i]=spread;
+      }
+    }
+  }
+
+  //
+  // Positions are reported in whole milliseconds
+  //
+  double period_msecs=1000.0*(double)period/
+    (double)rda->system()->sampleRate();
+  printf("cut %s, %d streams on card %d, %u trials:\n",
+	 (const char *)test_cutname.toUtf8(),test_decks,test_card,trials);
+  printf("  one command each: %4.1lf mS average spread, %d mS maximum\n",
+	 (double)total_spread[0]/(double)trials,max_spread[0]);
+  printf("  batched:          %4.1lf mS average spread, %d mS maximum\n",
+	 (double)total_spread[1]/(double)trials,max_spread[1]);
+  printf("  one period:       %4.1lf mS\n",period_msecs);
+  if((double)max_spread[1]>(period_msecs+1.0)) {
+    printf("FAILED: batched streams started more than one period apart\n");
+    exit(1);
+  }
+  printf("PASSED\n");
+  exit(0);
+}
+
+
+int MainObject::Trial(bool batched)
+{
+  int streams[RD_MAX_STREAMS];
+  int handles[RD_MAX_STREAMS];
+  short levels[2];
+  int ret=-1;
+
+  for(int i=0;i<test_decks;i++) {
+    if(!rda->cae()->loadPlay(test_card,test_cutname,&streams[i],
+			     &handles[i])) {
+      fprintf(stderr,"cae_batch_test: unable to load cut %s on card %d\n",
+	      (const char *)test_cutname.toUtf8(),test_card);
+      exit(1);
+    }
+    for(int j=0;j<RD_MAX_PORTS;j++) {
+      rda->cae()->setOutputVolume(test_card,streams[i],j,RD_MUTE_DEPTH);
+    }
+  }
+
+  if(batched) {
+    rda->cae()->beginBatch(test_delay);
+  }
+  for(int i=0;i<test_decks;i++) {
+    rda->cae()->play(handles[i],0,RD_TIMESCALE_DIVISOR,false);
+  }
+  if(batched) {
+    rda->cae()->commitBatch();
+  }
+  Wait(test_delay+500);
+
+  //
+  // The offset between streams stays put while they play, so take the
+  // smallest spread seen in case an update arrives part way through
+  //
+  for(int i=0;i<10;i++) {
+    Wait(50);
+    rda->cae()->outputStreamMeterUpdate(test_card,streams[0],levels);
+    Wait(RD_METER_UPDATE_INTERVAL);
+    int min_pos=-1;
+    int max_pos=-1;
+    for(int j=0;j<test_decks;j++) {
+      int pos=rda->cae()->playPosition(handles[j]);
+      if((pos==0)||(pos==-1)) {
+	min_pos=-1;
+	break;
+      }
+      if((min_pos<0)||(pos<min_pos)) {
+	min_pos=pos;
+      }
+      if(pos>max_pos) {
+	max_pos=pos;
+      }
+    }
+    if((min_pos>=0)&&((ret<0)||((max_pos-min_pos)<ret))) {
+      ret=max_pos-min_pos;
+    }
+  }
+
+  for(int i=0;i<test_decks;i++) {
+    rda->cae()->stopPlay(handles[i]);
+    rda->cae()->unloadPlay(handles[i]);
+  }
+  Wait(200);
+
+  return ret;
+}
+
+
+void MainObject::Wait(int msecs)
+{
+  QEventLoop loop;
+
+  QTimer::singleShot(msecs,&loop,SLOT(quit()));
+  loop.exec();
+}
+
+
+int main(int argc,char *argv[])
+{
+  QApplication a(argc,argv,false);
+  new MainObject();
+  return a.exec();
+}
@@ -0,0 +1,43 @@
+// cae_batch_test.h
+//
+// Check that playback started in a caed(8) batch lands together
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef CAE_BATCH_TEST_H
+#define CAE_BATCH_TEST_H
+
+#include <qobject.h>
+
+#define CAE_BATCH_TEST_USAGE "[options]\n\nLoad the same cut into several playback streams and start them, first with\none Play command per stream and then with all of them in a single batch,\ncomparing the play positions reported by caed(8) to see how far apart the\nstreams started. The test passes if the batched streams start within one\naudio period of each other. The streams are muted while playing. Requires\na running caed(8).\n\nOptions are:\n--cut=<cart>_<cut>\n     Cut to play. Default is the first cut at least 30 seconds long.\n\n--card=<num>\n     Audio card to use. Default is 0.\n\n--decks=<num>\n     Number of streams to start together. Default is 4.\n\n--trials=<num>\n     Number of starts of each kind. Default is 5.\n\n--delay=<msecs>\n     Start delay to request for each batch. Default is 0.\n\n--period=<frames>\n     Audio period size. Default is the ALSA period size in rd.conf(5).\n\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  int Trial(bool batched);
+  void Wait(int msecs);
+  QString test_cutname;
+  int test_card;
+  int test_decks;
+  unsigned test_delay;
+};
+
+
+#endif  // CAE_BATCH_TEST_H
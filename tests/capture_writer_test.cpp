@@ -0,0 +1,213 @@
+// capture_writer_test.cpp
+//
+// Stress test for the RDCaptureWriter class
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <QCoreApplication>
+
+#include <rdcmd_switch.h>
+#include <rdwavefile.h>
+
+#include "capture_writer_test.h"
+
+//
+// Simulated capture parameters
+//
+#define CAPTURE_WRITER_TEST_SAMPLE_RATE 48000
+#define CAPTURE_WRITER_TEST_CHANNELS 2
+#define CAPTURE_WRITER_TEST_PERIOD 1024
+
+static uint64_t Now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return 1000*(uint64_t)ts.tv_sec+ts.tv_nsec/1000000;
+}
+
+
+ThrottledWriter::ThrottledWriter(RDWaveFile *wave,Format fmt,unsigned chans,
+				 unsigned ring_size,int stall_msecs,
+				 int interval_msecs)
+  : RDCaptureWriter(wave,fmt,chans,ring_size)
+{
+  throttle_stall_msecs=stall_msecs;
+  throttle_interval_msecs=interval_msecs;
+  throttle_next_stall=Now()+interval_msecs;
+}
+
+
+ssize_t ThrottledWriter::writeData(const void *data,size_t len)
+{
+  if((throttle_stall_msecs>0)&&(Now()>=throttle_next_stall)) {
+    usleep(1000*throttle_stall_msecs);
+    throttle_next_stall=Now()+throttle_interval_msecs-throttle_stall_msecs;
+  }
+  return RDCaptureWriter::writeData(data,len);
+}
+
+
+MainObject::MainObject(QObject *parent)
+  : QObject(parent)
+{
+  QString filename;
+  int seconds=30;
+  int stall=2000;
+  int interval=5000;
+  unsigned ring_size=RD_CAPTURE_RING_SIZE;
+  int bits=24;
+  bool ok=false;
+  RDWaveFile *wave=NULL;
+  ThrottledWriter *writer=NULL;
+  float pcm[CAPTURE_WRITER_TEST_PERIOD*CAPTURE_WRITER_TEST_CHANNELS];
+  double phase=0.0;
+  struct timespec ts;
+
+  RDCmdSwitch *cmd=new RDCmdSwitch(qApp->argc(),qApp->argv(),
+				   "capture_writer_test",
+				   CAPTURE_WRITER_TEST_USAGE);
+  for(unsigned i=0;i<cmd->keys();i++) {
+    if(cmd->key(i)=="--filename") {
+      filename=cmd->value(i);
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--seconds") {
+      seconds=cmd->value(i).toInt(&ok);
+      if((!ok)||(seconds<=0)) {
+	fprintf(stderr,"capture_writer_test: invalid --seconds\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--stall") {
+      stall=cmd->value(i).toInt(&ok);
+      if((!ok)||(stall<0)) {
+	fprintf(stderr,"capture_writer_test: invalid --stall\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--stall-interval") {
+      interval=cmd->value(i).toInt(&ok);
+      if((!ok)||(interval<=0)) {
+	fprintf(stderr,"capture_writer_test: invalid --stall-interval\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--ring-size") {
+      ring_size=cmd->value(i).toUInt(&ok);
+      if((!ok)||(ring_size==0)) {
+	fprintf(stderr,"capture_writer_test: invalid --ring-size\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--bits") {
+      bits=cmd->value(i).toInt(&ok);
+      if((!ok)||((bits!=16)&&(bits!=24))) {
+	fprintf(stderr,"capture_writer_test: invalid --bits\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(!cmd->processed(i)) {
+      fprintf(stderr,"capture_writer_test: unrecognized option \"%s\"\n",
+	      cmd->key(i).toUtf8().constData());
+      exit(1);
+    }
+  }
+  if(filename.isEmpty()) {
+    fprintf(stderr,
+	    "capture_writer_test: you must supply --filename=<name>\n");
+    exit(1);
+  }
+
+  //
+  // Create Output File
+  //
+  wave=new RDWaveFile(filename);
+  wave->setFormatTag(WAVE_FORMAT_PCM);
+  wave->setChannels(CAPTURE_WRITER_TEST_CHANNELS);
+  wave->setSamplesPerSec(CAPTURE_WRITER_TEST_SAMPLE_RATE);
+  wave->setBitsPerSample(bits);
+  wave->setBextChunk(true);
+  wave->setLevlChunk(true);
+  if(!wave->createWave()) {
+    fprintf(stderr,"capture_writer_test: unable to create \"%s\"\n",
+	    filename.toUtf8().constData());
+    exit(1);
+  }
+  writer=new ThrottledWriter(wave,(bits==24)?RDCaptureWriter::Pcm24:
+			     RDCaptureWriter::Pcm16,
+			     CAPTURE_WRITER_TEST_CHANNELS,ring_size,
+			     stall,interval);
+  if(!writer->start()) {
+    fprintf(stderr,"capture_writer_test: unable to start writer\n");
+    exit(1);
+  }
+
+  //
+  // Feed it in real time, as the capture callback would
+  //
+  uint64_t periods=(uint64_t)seconds*CAPTURE_WRITER_TEST_SAMPLE_RATE/
+    CAPTURE_WRITER_TEST_PERIOD;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  for(uint64_t i=0;i<periods;i++) {
+    for(int j=0;j<CAPTURE_WRITER_TEST_PERIOD;j++) {
+      pcm[2*j]=0.5*sin(phase);
+      pcm[2*j+1]=0.5*sin(phase);
+      phase+=2.0*M_PI*1000.0/(double)CAPTURE_WRITER_TEST_SAMPLE_RATE;
+    }
+    writer->writeFrames(pcm,CAPTURE_WRITER_TEST_PERIOD);
+    ts.tv_nsec+=(long)(1000000000.0*(double)CAPTURE_WRITER_TEST_PERIOD/
+		       (double)CAPTURE_WRITER_TEST_SAMPLE_RATE);
+    if(ts.tv_nsec>=1000000000) {
+      ts.tv_sec++;
+      ts.tv_nsec-=1000000000;
+    }
+    clock_nanosleep(CLOCK_MONOTONIC,TIMER_ABSTIME,&ts,NULL);
+  }
+  writer->stop();
+  wave->closeWave(writer->framesWritten());
+
+  printf("frames captured: %lu\n",
+	 (unsigned long)(periods*CAPTURE_WRITER_TEST_PERIOD));
+  printf("frames written: %lu\n",(unsigned long)writer->framesWritten());
+  printf("overruns: %u (%lu frames dropped)\n",writer->overruns(),
+	 (unsigned long)writer->framesDropped());
+  printf("write errors: %s\n",writer->writeError()?"yes":"no");
+
+  exit(writer->overruns()!=0);
+}
+
+
+int main(int argc,char *argv[])
+{
+  QCoreApplication a(argc,argv);
+
+  new MainObject();
+  return a.exec();
+}
@@ -0,0 +1,54 @@
+// capture_writer_test.h
+//
+// Stress test for the RDCaptureWriter class
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef CAPTURE_WRITER_TEST_H
+#define CAPTURE_WRITER_TEST_H
+
+#include <QObject>
+
+#include <rdcapturewriter.h>
+
+#define CAPTURE_WRITER_TEST_USAGE "--filename=<output-file> [options]\n\nFeed a real-time stream of captured audio into an RDCaptureWriter whose\noutput file periodically stalls, and report any overruns.\n\nOptions are:\n--seconds=<secs>\n     Length of the capture. Default is 30.\n\n--stall=<msecs>\n     Length of each simulated output stall. Default is 2000.\n\n--stall-interval=<msecs>\n     Time between the start of each stall. Default is 5000.\n\n--ring-size=<bytes>\n     Size of the writer ring. Use 524288 to model the capacity of the\n     16 bit ring previously drained from caed(8)'s main loop.\n\n--bits=16|24\n     Sample resolution of the output file. Default is 24.\n\n"
+
+class ThrottledWriter : public RDCaptureWriter
+{
+ public:
+  ThrottledWriter(RDWaveFile *wave,Format fmt,unsigned chans,
+		  unsigned ring_size,int stall_msecs,int interval_msecs);
+
+ protected:
+  ssize_t writeData(const void *data,size_t len);
+
+ private:
+  int throttle_stall_msecs;
+  int throttle_interval_msecs;
+  uint64_t throttle_next_stall;
+};
+
+
+class MainObject : public QObject
+{
+  Q_OBJECT;
+ public:
+  MainObject(QObject *parent=0);
+};
+
+
+#endif  // CAPTURE_WRITER_TEST_H
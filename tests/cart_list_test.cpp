@@ -0,0 +1,384 @@
+// cart_list_test.cpp
+//
+// Benchmark loading the RDLibrary cart list in pages
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <qapplication.h>
+
+#include <rdapplication.h>
+#include <rdcart.h>
+#include <rddb.h>
+#include <rdescape_string.h>
+
+#include "cart_list_test.h"
+
+MainObject::MainObject(QObject *parent)
+  :QObject(parent)
+{
+  QString err_msg;
+  unsigned carts=20000;
+  int page_size=500;
+  unsigned seed=time(NULL);
+  bool ok=false;
+  unsigned errors=0;
+  std::map<unsigned,int> legacy_cuts;
+  std::map<unsigned,int> paged_cuts;
+  std::vector<double> page_secs;
+  double legacy_secs;
+  double first_secs;
+  double total_secs;
+  double max_secs=0.0;
+  uint64_t start;
+  uint64_t page_start;
+
+  rda=new RDApplication("cart_list_test","cart_list_test",
+			CART_LIST_TEST_USAGE,this);
+  if(!rda->open(&err_msg)) {
+    fprintf(stderr,"cart_list_test: %s\n",(const char *)err_msg);
+    exit(1);
+  }
+
+  for(unsigned i=0;i<rda->cmdSwitch()->keys();i++) {
+    if(rda->cmdSwitch()->key(i)=="--carts") {
+      carts=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if((!ok)||(carts==0)) {
+	fprintf(stderr,"cart_list_test: invalid --carts\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--page-size") {
+      page_size=rda->cmdSwitch()->value(i).toInt(&ok);
+      if((!ok)||(page_size<=0)) {
+	fprintf(stderr,"cart_list_test: invalid --page-size\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--seed") {
+      seed=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if(!ok) {
+	fprintf(stderr,"cart_list_test: invalid --seed\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(!rda->cmdSwitch()->processed(i)) {
+      fprintf(stderr,"cart_list_test: unknown command option \"%s\"\n",
+	      (const char *)rda->cmdSwitch()->key(i));
+      exit(2);
+    }
+  }
+  srand(seed);
+  printf("seed: %u\n",seed);
+
+  test_group=QString().sprintf("LT%d",getpid()%100000000);
+  if(!Create(carts,&err_msg)) {
+    Clean();
+    fprintf(stderr,"cart_list_test: %s\n",(const char *)err_msg.toUtf8());
+    exit(1);
+  }
+
+  //
+  // Original path: nothing is shown until every cart has been read
+  //
+  legacy_secs=LegacyLoad(&legacy_cuts);
+
+  //
+  // Paged path: the first page is shown as soon as it arrives, the rest
+  // as the list is scrolled
+  //
+  start=Now();
+  QString sql=QString("select ")+
+    "count(distinct CART.NUMBER) "+  // 00
+    "from CART left join GROUPS on CART.GROUP_NAME=GROUPS.NAME "+
+    "left join CUTS on CART.NUMBER=CUTS.CART_NUMBER where "+
+    "CART.GROUP_NAME=\""+RDEscapeString(test_group)+"\"";
+  int matches=RDSqlQuery::run(sql).toInt();
+  unsigned last_cart=LoadPage(0,page_size,&paged_cuts);
+  first_secs=(double)(Now()-start)/1000000.0;
+  while((int)paged_cuts.size()<matches) {
+    page_start=Now();
+    unsigned cart=LoadPage(last_cart,page_size,&paged_cuts);
+    page_secs.push_back((double)(Now()-page_start)/1000000.0);
+    if(cart==last_cart) {
+      break;
+    }
+    last_cart=cart;
+  }
+  total_secs=(double)(Now()-start)/1000000.0;
+
+  if(matches!=(int)carts) {
+    printf("  counted %d carts\n",matches);
+    errors++;
+  }
+  if(legacy_cuts!=paged_cuts) {
+    printf("  carts or cuts differ: %lu carts originally, %lu paged\n",
+	   legacy_cuts.size(),paged_cuts.size());
+    errors++;
+  }
+  double sum=0.0;
+  for(unsigned i=0;i<page_secs.size();i++) {
+    sum+=page_secs.at(i);
+    if(page_secs.at(i)>max_secs) {
+      max_secs=page_secs.at(i);
+    }
+  }
+  Clean();
+
+  printf("%u carts, pages of %d:\n",carts,page_size);
+  printf("  original:  first results %8.3lf sec\n",legacy_secs);
+  printf("  paged:     first results %8.3lf sec  all pages %8.3lf sec\n",
+	 first_secs,total_secs);
+  if(page_secs.size()>0) {
+    printf("  scrolling: %lu pages, %.1lf mS average, %.1lf mS maximum\n",
+	   page_secs.size(),1000.0*sum/(double)page_secs.size(),
+	   1000.0*max_secs);
+  }
+
+  if(errors>0) {
+    printf("FAILED: %u error(s)\n",errors);
+    exit(1);
+  }
+  printf("PASSED\n");
+  exit(0);
+}
+
+
+bool MainObject::Create(unsigned carts,QString *err_msg)
+{
+  QString cart_values;
+  QString cut_values;
+
+  test_first_cart=1+RDSqlQuery::run("select max(NUMBER) from CART").toUInt();
+  test_last_cart=test_first_cart+carts-1;
+  if(test_last_cart>RD_MAX_CART_NUMBER) {
+    *err_msg=QString().sprintf("no room for %u carts above cart %06u",
+			       carts,test_first_cart-1);
+    return false;
+  }
+  for(unsigned i=test_first_cart;i<=test_last_cart;i++) {
+    int cuts=1+rand()%3;
+    cart_values+=QString().sprintf("(%u,%d,",i,RDCart::Audio)+
+      "\""+RDEscapeString(test_group)+"\","+
+      QString().sprintf("\"Title %u\",\"Artist %u\",%d,%d),",
+			i,rand()%1000,60000+rand()%180000,cuts);
+    for(int j=0;j<cuts;j++) {
+      cut_values+=QString().sprintf("(\"%06u_%03d\",%u,\"Cut %d\",%d,",
+				    i,j+1,i,j+1,60000+rand()%180000)+
+	"\"Y\"),";
+    }
+    if(((i-test_first_cart+1)%1000==0)||(i==test_last_cart)) {
+      QString sql=QString("insert into CART (")+
+	"NUMBER,"+
+	"TYPE,"+
+	"GROUP_NAME,"+
+	"TITLE,"+
+	"ARTIST,"+
+	"FORCED_LENGTH,"+
+	"CUT_QUANTITY) values "+
+	cart_values.left(cart_values.length()-1);
+      if(!RDSqlQuery::apply(sql,err_msg)) {
+	return false;
+      }
+      sql=QString("insert into CUTS (")+
+	"CUT_NAME,"+
+	"CART_NUMBER,"+
+	"DESCRIPTION,"+
+	"LENGTH,"+
+	"EVERGREEN) values "+
+	cut_values.left(cut_values.length()-1);
+      if(!RDSqlQuery::apply(sql,err_msg)) {
+	return false;
+      }
+      cart_values="";
+      cut_values="";
+    }
+  }
+
+  return true;
+}
+
+
+void MainObject::Clean()
+{
+  QString sql=QString("delete from CUTS where ")+
+    QString().sprintf("CART_NUMBER>=%u && CART_NUMBER<=%u",
+		      test_first_cart,test_last_cart);
+  RDSqlQuery::apply(sql);
+  sql=QString("delete from CART where ")+
+    "GROUP_NAME=\""+RDEscapeString(test_group)+"\"";
+  RDSqlQuery::apply(sql);
+}
+
+
+double MainObject::LegacyLoad(std::map<unsigned,int> *cuts)
+{
+  uint64_t start=Now();
+
+  //
+  // As in MainWidget::RefreshList() before paging
+  //
+  QString sql=CartFields()+" where "+
+    "CART.GROUP_NAME=\""+RDEscapeString(test_group)+"\" "+
+    "group by CART.NUMBER order by CART.NUMBER";
+  RDSqlQuery *q=new RDSqlQuery(sql);
+  while(q->next()) {
+    unsigned cartnum=q->value(0).toUInt();
+    (*cuts)[cartnum]=0;
+    sql=CutFields()+
+      QString().sprintf("where CUTS.CART_NUMBER=%u ",cartnum)+
+      "order by CUTS.CUT_NAME";
+    RDSqlQuery *q1=new RDSqlQuery(sql);
+    while(q1->next()) {
+      (*cuts)[cartnum]++;
+    }
+    delete q1;
+  }
+  delete q;
+
+  return (double)(Now()-start)/1000000.0;
+}
+
+
+unsigned MainObject::LoadPage(unsigned last_cart,int limit,
+			      std::map<unsigned,int> *cuts)
+{
+  QString carts;
+
+  //
+  // As in MainWidget::LoadPage()
+  //
+  QString sql=CartFields(true)+" where "+
+    "CART.GROUP_NAME=\""+RDEscapeString(test_group)+"\""+
+    QString().sprintf(" && CART.NUMBER>%u",last_cart)+
+    " group by CART.NUMBER order by CART.NUMBER"+
+    QString().sprintf(" limit %d",limit);
+  RDSqlQuery *q=new RDSqlQuery(sql);
+  while(q->next()) {
+    last_cart=q->value(0).toUInt();
+    (*cuts)[last_cart]=q->value(26).toInt();
+    carts+=QString().sprintf("%u,",last_cart);
+  }
+  delete q;
+  if(carts.isEmpty()) {
+    return last_cart;
+  }
+  sql=CutFields()+
+    "where CUTS.CART_NUMBER in ("+carts.left(carts.length()-1)+") "+
+    "order by CUTS.CART_NUMBER,CUTS.CUT_NAME";
+  q=new RDSqlQuery(sql);
+  while(q->next()) {
+    //
+    // Read for the timings only, as the counts come from the page query
+    //
+    q->value(1).toString();
+  }
+  delete q;
+
+  return last_cart;
+}
+
+
+QString MainObject::CartFields(bool cut_counts) const
+{
+  QString counts;
+
+  if(cut_counts) {
+    counts=QString(",(select count(*) from CUTS as CART_CUTS ")+  // 26
+      "where CART_CUTS.CART_NUMBER=CART.NUMBER)";
+  }
+  return QString("select ")+
+    "CART.NUMBER,"+             // 00
+    "CART.FORCED_LENGTH,"+      // 01
+    "CART.TITLE,"+              // 02
+    "CART.ARTIST,"+             // 03
+    "CART.ALBUM,"+              // 04
+    "CART.LABEL,"+              // 05
+    "CART.CLIENT,"+             // 06
+    "CART.AGENCY,"+             // 07
+    "CART.USER_DEFINED,"+       // 08
+    "CART.COMPOSER,"+           // 09
+    "CART.PUBLISHER,"+          // 10
+    "CART.CONDUCTOR,"+          // 11
+    "CART.GROUP_NAME,"+         // 12
+    "CART.START_DATETIME,"+     // 13
+    "CART.END_DATETIME,"+       // 14
+    "CART.TYPE,"+               // 15
+    "CART.CUT_QUANTITY,"+       // 16
+    "CART.LAST_CUT_PLAYED,"+    // 17
+    "CART.ENFORCE_LENGTH,"+     // 18
+    "CART.PRESERVE_PITCH,"+     // 19
+    "CART.LENGTH_DEVIATION,"+   // 20
+    "CART.OWNER,"+              // 21
+    "CART.VALIDITY,"+           // 22
+    "GROUPS.COLOR,"+            // 23
+    "CUTS.TALK_START_POINT,"+   // 24
+    "CUTS.TALK_END_POINT"+      // 25
+    counts+
+    " from CART left join GROUPS on CART.GROUP_NAME=GROUPS.NAME "+
+    "left join CUTS on CART.NUMBER=CUTS.CART_NUMBER";
+}
+
+
+QString MainObject::CutFields() const
+{
+  return QString("select ")+
+    "CUTS.CART_NUMBER,"+        // 00
+    "CUTS.CUT_NAME,"+           // 01
+    "CUTS.DESCRIPTION,"+        // 02
+    "CUTS.TALK_START_POINT,"+   // 03
+    "CUTS.TALK_END_POINT,"+     // 04
+    "CUTS.LENGTH,"+             // 05
+    "CUTS.EVERGREEN,"+          // 06
+    "CUTS.START_DATETIME,"+     // 07
+    "CUTS.END_DATETIME,"+       // 08
+    "CUTS.START_DAYPART,"+      // 09
+    "CUTS.END_DAYPART,"+        // 10
+    "CUTS.MON,"+                // 11
+    "CUTS.TUE,"+                // 12
+    "CUTS.WED,"+                // 13
+    "CUTS.THU,"+                // 14
+    "CUTS.FRI,"+                // 15
+    "CUTS.SAT,"+                // 16
+    "CUTS.SUN "+                // 17
+    "from CUTS ";
+}
+
+
+uint64_t MainObject::Now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return 1000000*(uint64_t)ts.tv_sec+(uint64_t)ts.tv_nsec/1000;
+}
+
+
+int main(int argc,char *argv[])
+{
+  QApplication a(argc,argv,false);
+  new MainObject();
+  return a.exec();
+}
@@ -0,0 +1,53 @@
+// cart_list_test.h
+//
+// Benchmark loading the RDLibrary cart list in pages
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef CART_LIST_TEST_H
+#define CART_LIST_TEST_H
+
+#include <stdint.h>
+
+#include <map>
+#include <vector>
+
+#include <qobject.h>
+
+#define CART_LIST_TEST_USAGE "[options]\n\nCreate a synthetic library of audio carts in a scratch group, then read it\nthe way RDLibrary used to fill its cart list (one query for every cart and\nanother for the cuts of each cart) and the way it does now (a count, then\npages of carts with the cuts for each page in one query), comparing the\nresults and timing each. The scratch carts are removed afterwards.\n\nOptions are:\n--carts=<num>\n     Number of carts to create. Default is 20000.\n\n--page-size=<num>\n     Number of carts per page. Default is 500.\n\n--seed=<num>\n     Random number seed.\n\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  bool Create(unsigned carts,QString *err_msg);
+  void Clean();
+  double LegacyLoad(std::map<unsigned,int> *cuts);
+  unsigned LoadPage(unsigned last_cart,int limit,
+		    std::map<unsigned,int> *cuts);
+  QString CartFields(bool cut_counts=false) const;
+  QString CutFields() const;
+  static uint64_t Now();
+  QString test_group;
+  unsigned test_first_cart;
+  unsigned test_last_cart;
+};
+
+
+#endif  // CART_LIST_TEST_H
@@ -0,0 +1,492 @@
+// cart_search_test.cpp
+//
+// Check and benchmark RDCartSearchIndex against a synthetic library
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <qapplication.h>
+
+#include <rdcartsearchindex.h>
+#include <rdcmd_switch.h>
+
+#include "cart_search_test.h"
+
+MainObject::MainObject(QObject *parent)
+  : QObject(parent)
+{
+  int carts=250000;
+  int queries=200;
+  unsigned seed=time(NULL);
+  bool ok=false;
+  bool pass=true;
+  uint64_t start;
+  uint64_t index_usecs=0;
+  uint64_t index_max_usecs=0;
+  uint64_t scan_usecs=0;
+  unsigned fallbacks=0;
+  unsigned exact=0;
+  QList<unsigned> found;
+  std::vector<unsigned> expected;
+
+  RDCmdSwitch *cmd=new RDCmdSwitch(qApp->argc(),qApp->argv(),
+				   "cart_search_test",CART_SEARCH_TEST_USAGE);
+  for(unsigned i=0;i<cmd->keys();i++) {
+    if(cmd->key(i)=="--carts") {
+      carts=cmd->value(i).toInt(&ok);
+      if((!ok)||(carts<=0)||(carts>300000)) {
+	fprintf(stderr,"cart_search_test: invalid --carts\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--queries") {
+      queries=cmd->value(i).toInt(&ok);
+      if((!ok)||(queries<=0)) {
+	fprintf(stderr,"cart_search_test: invalid --queries\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--seed") {
+      seed=cmd->value(i).toUInt(&ok);
+      if(!ok) {
+	fprintf(stderr,"cart_search_test: invalid --seed\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(!cmd->processed(i)) {
+      fprintf(stderr,"cart_search_test: unrecognized option \"%s\"\n",
+	      cmd->key(i).toUtf8().constData());
+      exit(1);
+    }
+  }
+  srandom(seed);
+
+  //
+  // Build the Library
+  //
+  Generate(carts);
+  RDCartSearchIndex *index=new RDCartSearchIndex(NULL,this);
+  start=Now();
+  for(unsigned i=0;i<test_carts.size();i++) {
+    const CartSearchTestCart &cart=test_carts.at(i);
+    QStringList cut_fields;
+    for(unsigned j=0;j<cart.cuts.size();j++) {
+      cut_fields+=cart.cuts.at(j);
+    }
+    index->update(cart.number,cart.group,cart.type,cart.schedcodes,
+		  cart.cart_fields,cut_fields);
+  }
+  printf("indexed %u carts, %u tokens in %.3lf sec\n",index->size(),
+	 index->tokenQuantity(),(double)(Now()-start)/1000000.0);
+
+  //
+  // Searches
+  //
+  for(int i=0;i<queries;i++) {
+    QString filter=Query();
+    QString group;
+    QStringList schedcodes;
+    RDCart::Type type=RDCart::All;
+    bool incl_cuts=random()%2;
+    if((random()%10)<3) {
+      group=test_groups.at(random()%test_groups.size());
+    }
+    if((random()%10)<2) {
+      schedcodes.push_back(test_schedcodes.at(random()%
+					       test_schedcodes.size()));
+    }
+    if((random()%10)<2) {
+      type=((random()%2)==0)?RDCart::Audio:RDCart::Macro;
+    }
+
+    start=Now();
+    ok=index->search(&found,filter,
+		     group.isEmpty()?QStringList():QStringList(group),
+		     schedcodes,type,incl_cuts);
+    uint64_t usecs=Now()-start;
+    index_usecs+=usecs;
+    if(usecs>index_max_usecs) {
+      index_max_usecs=usecs;
+    }
+
+    start=Now();
+    QStringList terms=Terms(filter);
+    expected.clear();
+    for(unsigned j=0;j<test_carts.size();j++) {
+      if(Matches(test_carts.at(j),terms,group,schedcodes,type,incl_cuts)) {
+	expected.push_back(test_carts.at(j).number);
+      }
+    }
+    scan_usecs+=Now()-start;
+
+    if(!ok) {
+      fallbacks++;
+      continue;
+    }
+    unsigned k=0;
+    for(unsigned j=0;j<expected.size();j++) {
+      while((k<(unsigned)found.size())&&(found.at(k)<expected.at(j))) {
+	k++;
+      }
+      if((k==(unsigned)found.size())||(found.at(k)!=expected.at(j))) {
+	printf("  FAILED: search \"%s\" [group: \"%s\"  codes: \"%s\"  "
+	       "type: %d  cuts: %d] missed cart %06u\n",
+	       filter.toUtf8().constData(),group.toUtf8().constData(),
+	       schedcodes.join(",").toUtf8().constData(),type,incl_cuts,
+	       expected.at(j));
+	pass=false;
+	break;
+      }
+    }
+    if((unsigned)found.size()==expected.size()) {
+      exact++;
+    }
+  }
+  printf("%d searches, %u left to the database, %u exact\n",
+	 queries,fallbacks,exact);
+  printf("  index: %.3lf mS average, %.3lf mS maximum\n",
+	 (double)index_usecs/(1000.0*(double)queries),
+	 (double)index_max_usecs/1000.0);
+  printf("  scan: %.3lf mS average\n",
+	 (double)scan_usecs/(1000.0*(double)queries));
+
+  //
+  // Updates
+  //
+  CartSearchTestCart &cart=test_carts.at(random()%test_carts.size());
+  cart.cart_fields[1]=QString("Zyzzogeton Title");
+  index->update(cart.number,cart.group,cart.type,cart.schedcodes,
+		cart.cart_fields,QStringList());
+  index->search(&found,"zyzzog",QStringList(),QStringList(),RDCart::All,
+		false);
+  if((found.size()!=1)||(found.at(0)!=cart.number)) {
+    printf("  FAILED: updated cart %06u not found\n",cart.number);
+    pass=false;
+  }
+  index->remove(cart.number);
+  index->search(&found,"zyzzog",QStringList(),QStringList(),RDCart::All,
+		false);
+  if(found.size()!=0) {
+    printf("  FAILED: removed cart %06u still found\n",cart.number);
+    pass=false;
+  }
+
+  delete index;
+  if(!pass) {
+    printf("FAILED [seed: %u]\n",seed);
+    exit(1);
+  }
+  printf("PASSED\n");
+  exit(0);
+}
+
+
+void MainObject::Generate(unsigned carts)
+{
+  const char *accents[]={"\xc3\xa9","\xc3\xbc","\xc3\xb1","\xc3\xb8"};
+  QString word;
+
+  for(int i=0;i<20000;i++) {
+    word="";
+    int len=3+random()%8;
+    for(int j=0;j<len;j++) {
+      if((random()%40)==0) {
+	word+=QString::fromUtf8(accents[random()%4]);
+      }
+      else {
+	word+=QChar('a'+random()%26);
+      }
+    }
+    test_words.push_back(word);
+  }
+  for(int i=0;i<20;i++) {
+    test_groups.push_back(QString().sprintf("GROUP%02d",i));
+  }
+  for(int i=0;i<30;i++) {
+    test_schedcodes.push_back(QString().sprintf("CODE%02d",i));
+  }
+
+  test_carts.resize(carts);
+  for(unsigned i=0;i<carts;i++) {
+    CartSearchTestCart &cart=test_carts.at(i);
+    cart.number=1+3*i;
+    cart.group=test_groups.at(random()%test_groups.size());
+    cart.type=((random()%10)==0)?RDCart::Macro:RDCart::Audio;
+    for(int j=random()%4;j>0;j--) {
+      QString code=test_schedcodes.at(random()%test_schedcodes.size());
+      if(!cart.schedcodes.contains(code)) {
+	cart.schedcodes.push_back(code);
+      }
+    }
+    //
+    // Number, Title, Artist, Client, Agency, Album, Label, Publisher,
+    // Composer, Conductor, Song ID and User Defined
+    //
+    cart.cart_fields.push_back(QString().sprintf("%u",cart.number));
+    cart.cart_fields.push_back(Phrase(1,4));
+    cart.cart_fields.push_back(Phrase(1,2));
+    cart.cart_fields.push_back(((random()%10)==0)?Phrase(1,2):"");
+    cart.cart_fields.push_back(((random()%10)==0)?Phrase(1,2):"");
+    cart.cart_fields.push_back(Phrase(1,3));
+    cart.cart_fields.push_back(((random()%3)==0)?Phrase(1,1):"");
+    cart.cart_fields.push_back(((random()%5)==0)?Phrase(1,2):"");
+    cart.cart_fields.push_back(((random()%5)==0)?Phrase(1,2):"");
+    cart.cart_fields.push_back(((random()%20)==0)?Phrase(1,2):"");
+    cart.cart_fields.push_back(((random()%3)==0)?
+			       QString().sprintf("SID-%06ld",random()%1000000):
+			       QString(""));
+    cart.cart_fields.push_back(((random()%10)==0)?Phrase(1,3):"");
+    if(cart.type==RDCart::Audio) {
+      for(int j=1+random()%3;j>0;j--) {
+	//
+	// ISCI, ISRC, Description and Outcue
+	//
+	QStringList cut;
+	cut.push_back(((random()%10)==0)?
+		      QString().sprintf("ISCI%05ld",random()%100000):
+		      QString(""));
+	cut.push_back(QString().sprintf("USRV1%07ld",random()%10000000));
+	cut.push_back(Phrase(0,2));
+	cut.push_back(((random()%5)==0)?Phrase(1,2):"");
+	cart.cuts.push_back(cut);
+      }
+    }
+    for(int j=0;j<cart.cart_fields.size();j++) {
+      cart.folded_fields.push_back(Fold(cart.cart_fields.at(j)));
+    }
+    for(unsigned j=0;j<cart.cuts.size();j++) {
+      cart.folded_cuts.push_back(QStringList());
+      for(int k=0;k<cart.cuts.at(j).size();k++) {
+	cart.folded_cuts.back().push_back(Fold(cart.cuts.at(j).at(k)));
+      }
+    }
+  }
+}
+
+
+QString MainObject::Phrase(int min,int max) const
+{
+  QString ret;
+  QString word;
+
+  for(int i=min+random()%(1+max-min);i>0;i--) {
+    word=test_words.at(random()%test_words.size());
+    ret+=word.left(1).toUpper()+word.right(word.length()-1)+" ";
+  }
+  return ret.trimmed();
+}
+
+
+QString MainObject::Query() const
+{
+  QString word=test_words.at(random()%test_words.size());
+  QString ret;
+  const CartSearchTestCart *cart=NULL;
+
+  switch(random()%6) {
+  case 0:   // Substring of a word
+    ret=word.mid(random()%word.length(),2+random()%4);
+    break;
+
+  case 1:   // Prefix of a word, as typed
+    ret=word.left(1+random()%6);
+    break;
+
+  case 2:   // One word plus a prefix of another
+    ret=word+" "+test_words.at(random()%test_words.size()).left(3);
+    break;
+
+  case 3:   // Quoted phrase from a title
+    cart=&test_carts.at(random()%test_carts.size());
+    ret="\""+cart->cart_fields.at(1).left(4+random()%12)+"\"";
+    break;
+
+  case 4:   // Part of a cart number
+    ret=QString().sprintf("%u",test_carts.at(random()%test_carts.size()).
+			  number).left(3+random()%3);
+    break;
+
+  case 5:   // Part of an ISRC
+    cart=&test_carts.at(random()%test_carts.size());
+    if(cart->cuts.size()>0) {
+      ret=cart->cuts.at(0).at(1).mid(2,6);
+    }
+    break;
+  }
+  if((random()%4)==0) {
+    ret=ret.toUpper();
+  }
+
+  return ret;
+}
+
+
+bool MainObject::Matches(const CartSearchTestCart &cart,
+			 const QStringList &terms,const QString &group,
+			 const QStringList &schedcodes,RDCart::Type type,
+			 bool incl_cuts) const
+{
+  bool found;
+
+  //
+  // Filters
+  //
+  if((!group.isEmpty())&&(cart.group.toLower()!=group.toLower())) {
+    return false;
+  }
+  for(int i=0;i<schedcodes.size();i++) {
+    if(!cart.schedcodes.contains(schedcodes.at(i),Qt::CaseInsensitive)) {
+      return false;
+    }
+  }
+  switch(type) {
+  case RDCart::Audio:
+    if(cart.type==RDCart::Macro) {
+      return false;
+    }
+    break;
+
+  case RDCart::Macro:
+    if(cart.type!=RDCart::Macro) {
+      return false;
+    }
+    break;
+
+  case RDCart::All:
+    break;
+  }
+
+  //
+  // Search terms, evaluated once for each row of the 'left join' with
+  // CUTS when cut fields are included
+  //
+  QStringList folded;
+  for(int i=0;i<terms.size();i++) {
+    folded.push_back(Fold(terms.at(i)));
+  }
+  unsigned rows=1;
+  if(incl_cuts&&(cart.cuts.size()>1)) {
+    rows=cart.cuts.size();
+  }
+  for(unsigned row=0;row<rows;row++) {
+    bool row_matches=true;
+    for(int i=0;i<folded.size();i++) {
+      const QString &term=folded.at(i);
+      found=false;
+      for(int j=0;j<cart.folded_fields.size();j++) {
+	if(cart.folded_fields.at(j).contains(term)) {
+	  found=true;
+	  break;
+	}
+      }
+      if((!found)&&incl_cuts&&(row<cart.cuts.size())) {
+	for(int j=0;j<cart.folded_cuts.at(row).size();j++) {
+	  if(cart.folded_cuts.at(row).at(j).contains(term)) {
+	    found=true;
+	    break;
+	  }
+	}
+      }
+      if(!found) {
+	row_matches=false;
+	break;
+      }
+    }
+    if(row_matches) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+QStringList MainObject::Terms(const QString &filter)
+{
+  QStringList ret;
+  QString edit_filter=filter.stripWhiteSpace();
+  QString str;
+  int pos;
+  char find;
+
+  //
+  // Same parsing as RDBaseSearchText()
+  //
+  while(!edit_filter.isEmpty()) {
+    if(edit_filter.startsWith("\"") && edit_filter.length()>1) {
+      edit_filter=edit_filter.remove(0,1);
+      find='\"';
+    }
+    else {
+      find=' ';
+    }
+    pos=edit_filter.find(find);
+    if(pos>=0) {
+      str=edit_filter.left(pos);
+      edit_filter=edit_filter.remove(0,pos);
+      if(find=='\"') {
+	edit_filter=edit_filter.remove(0,1);
+      }
+      edit_filter=edit_filter.stripWhiteSpace();
+    }
+    else {
+      str=edit_filter;
+      edit_filter=edit_filter.remove(0,edit_filter.length());
+    }
+    ret.push_back(str);
+  }
+
+  return ret;
+}
+
+
+QString MainObject::Fold(const QString &str)
+{
+  QString ret;
+  QString norm=str.normalized(QString::NormalizationForm_D);
+
+  for(int i=0;i<norm.length();i++) {
+    if(norm.at(i).category()!=QChar::Mark_NonSpacing) {
+      ret+=norm.at(i).toLower();
+    }
+  }
+  return ret;
+}
+
+
+uint64_t MainObject::Now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return 1000000*(uint64_t)ts.tv_sec+(uint64_t)ts.tv_nsec/1000;
+}
+
+
+int main(int argc,char *argv[])
+{
+  QApplication a(argc,argv,false);
+  new MainObject();
+  return a.exec();
+}
@@ -0,0 +1,71 @@
+// cart_search_test.h
+//
+// Check and benchmark RDCartSearchIndex against a synthetic library
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef CART_SEARCH_TEST_H
+#define CART_SEARCH_TEST_H
+
+#include <stdint.h>
+
+#include <vector>
+
+#include <qobject.h>
+#include <qstringlist.h>
+
+#include <rdcart.h>
+
+#define CART_SEARCH_TEST_USAGE "[options]\n\nBuild an RDCartSearchIndex over a synthetic cart library, then run random\nsearches through both the index and a direct scan reproducing the 'like'\nclauses of RDCartSearchText(), checking that the index never misses a\nmatching cart and reporting the time taken by each.\n\nOptions are:\n--carts=<num>\n     Number of carts in the synthetic library. Default is 250000.\n\n--queries=<num>\n     Number of searches to run. Default is 200.\n\n--seed=<num>\n     Random number seed.\n\n"
+
+class CartSearchTestCart
+{
+ public:
+  unsigned number;
+  QString group;
+  int type;
+  QStringList schedcodes;
+  QStringList cart_fields;
+  std::vector<QStringList> cuts;
+  QStringList folded_fields;
+  std::vector<QStringList> folded_cuts;
+};
+
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  void Generate(unsigned carts);
+  QString Phrase(int min,int max) const;
+  QString Query() const;
+  bool Matches(const CartSearchTestCart &cart,const QStringList &terms,
+	       const QString &group,const QStringList &schedcodes,
+	       RDCart::Type type,bool incl_cuts) const;
+  static QStringList Terms(const QString &filter);
+  static QString Fold(const QString &str);
+  static uint64_t Now();
+  std::vector<CartSearchTestCart> test_carts;
+  QStringList test_words;
+  QStringList test_groups;
+  QStringList test_schedcodes;
+};
+
+
+#endif  // CART_SEARCH_TEST_H
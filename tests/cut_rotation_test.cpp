@@ -0,0 +1,276 @@
+// cut_rotation_test.cpp
+//
+// Compare the in-memory cut rotation engine with RDCart::selectCut()
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdlib.h>
+#include <time.h>
+
+#include <QApplication>
+
+#include <rdapplication.h>
+#include <rdcart.h>
+#include <rdcut.h>
+#include <rdcutrotation.h>
+#include <rddb.h>
+
+#include "cut_rotation_test.h"
+
+//
+// Scheduling columns that are randomized (and restored) by the test
+//
+static const char *test_columns[]={"START_DATETIME","END_DATETIME",
+				   "START_DAYPART","END_DAYPART",
+				   "MON","TUE","WED","THU","FRI","SAT","SUN",
+				   "EVERGREEN","PLAY_ORDER","WEIGHT",
+				   "LOCAL_COUNTER","LAST_PLAY_DATETIME",NULL};
+
+MainObject::MainObject(QObject *parent)
+  :QObject(parent)
+{
+  QString err_msg;
+  unsigned iterations=100;
+  unsigned seed=time(NULL);
+  bool ok=false;
+  unsigned errors=0;
+  unsigned checks=0;
+
+  test_cart_number=0;
+
+  rda=new RDApplication("cut_rotation_test","cut_rotation_test",
+			CUT_ROTATION_TEST_USAGE,this);
+  if(!rda->open(&err_msg)) {
+    fprintf(stderr,"cut_rotation_test: %s\n",(const char *)err_msg);
+    exit(1);
+  }
+
+  for(unsigned i=0;i<rda->cmdSwitch()->keys();i++) {
+    if(rda->cmdSwitch()->key(i)=="--cart-number") {
+      test_cart_number=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if((!ok)||(test_cart_number==0)||
+	 (test_cart_number>RD_MAX_CART_NUMBER)) {
+	fprintf(stderr,"cut_rotation_test: invalid --cart-number\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--iterations") {
+      iterations=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if(!ok) {
+	fprintf(stderr,"cut_rotation_test: invalid --iterations\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--seed") {
+      seed=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if(!ok) {
+	fprintf(stderr,"cut_rotation_test: invalid --seed\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(!rda->cmdSwitch()->processed(i)) {
+      fprintf(stderr,"cut_rotation_test: unknown command option \"%s\"\n",
+	      (const char *)rda->cmdSwitch()->key(i));
+      exit(2);
+    }
+  }
+
+  //
+  // Sanity Checks
+  //
+  if(test_cart_number==0) {
+    fprintf(stderr,"cut_rotation_test: you must specify --cart-number\n");
+    exit(1);
+  }
+  RDCart *cart=new RDCart(test_cart_number);
+  if((!cart->exists())||(cart->type()!=RDCart::Audio)) {
+    fprintf(stderr,"cut_rotation_test: cart %06u is not an audio cart\n",
+	    test_cart_number);
+    exit(1);
+  }
+  RDSqlQuery *q=
+    new RDSqlQuery("select CUT_NAME from CUTS where CART_NUMBER=?",
+		   QList<QVariant>()<<test_cart_number);
+  while(q->next()) {
+    test_cut_names.push_back(q->value(0).toString());
+  }
+  delete q;
+  if(test_cut_names.size()==0) {
+    fprintf(stderr,"cut_rotation_test: cart %06u has no cuts\n",
+	    test_cart_number);
+    exit(1);
+  }
+  printf("cut_rotation_test: cart %06u, %d cuts, seed %u\n",
+	 test_cart_number,test_cut_names.size(),seed);
+  srandom(seed);
+  SaveSchedule();
+
+  //
+  // Run the Test
+  //
+  // The engine is instantiated without an RIPC connection, so it must be
+  // invalidated explicitly after each change made behind its back.
+  //
+  RDCutRotation *engine=new RDCutRotation(NULL,this);
+  for(unsigned i=0;i<iterations;i++) {
+    Randomize();
+    engine->invalidate(test_cart_number);
+    for(int j=0;j<2*test_cut_names.size();j++) {
+      QTime time=QTime(0,0,0).addSecs(random()%86400);
+      QString sql_cut;
+      QString mem_cut;
+      bool sql_ret=cart->selectCutFromDatabase(&sql_cut,time);
+      bool mem_ret=engine->
+	selectCut(test_cart_number,QDateTime(QDate::currentDate(),time),
+		  &mem_cut);
+      checks++;
+      if((sql_ret!=mem_ret)||(sql_cut!=mem_cut)) {
+	fprintf(stderr,
+		"MISMATCH: iteration %u, time %s: SQL=\"%s\", engine=\"%s\"\n",
+		i,(const char *)time.toString("hh:mm:ss").toUtf8(),
+		(const char *)sql_cut.toUtf8(),(const char *)mem_cut.toUtf8());
+	errors++;
+      }
+
+      //
+      // Log the play through the engine and write it back, so that
+      // counter and last-played ordering is exercised as well.
+      //
+      if(!mem_cut.isEmpty()) {
+	engine->logPlayout(mem_cut,QDateTime(QDate::currentDate(),time));
+	engine->flush();
+      }
+    }
+  }
+  delete engine;
+  RestoreSchedule();
+  delete cart;
+
+  printf("cut_rotation_test: %u checks, %u mismatches\n",checks,errors);
+
+  exit(errors!=0);
+}
+
+
+void MainObject::Randomize()
+{
+  QString sql;
+  QDateTime now=QDateTime::currentDateTime();
+
+  for(int i=0;i<test_cut_names.size();i++) {
+    QList<QVariant> args;
+    QDateTime start_dt=now.addSecs(-(random()%(3*86400)));
+    QDateTime end_dt=start_dt.addSecs(random()%(6*86400));
+    QTime start_dp=QTime(0,0,0).addSecs(random()%86400);
+    QTime end_dp=
+      start_dp.addSecs(random()%(86400-QTime(0,0,0).secsTo(start_dp)));
+    QDateTime last_dt=now.addSecs(-(random()%86400));
+
+    if((random()%3)==0) {
+      args.push_back(QVariant(QVariant::DateTime));
+      args.push_back(QVariant(QVariant::DateTime));
+    }
+    else {
+      args.push_back(start_dt);
+      args.push_back(end_dt);
+    }
+    if((random()%3)==0) {
+      args.push_back(QVariant(QVariant::Time));
+      args.push_back(QVariant(QVariant::Time));
+    }
+    else {
+      args.push_back(start_dp);
+      args.push_back(end_dp);
+    }
+    for(int j=0;j<7;j++) {
+      args.push_back(((random()%5)==0)?"N":"Y");
+    }
+    args.push_back(((random()%6)==0)?"Y":"N");
+    args.push_back((int)(random()%test_cut_names.size()));
+    args.push_back((int)(1+random()%4));
+    args.push_back((int)(random()%4));
+    if((random()%4)==0) {
+      args.push_back(QVariant(QVariant::DateTime));
+    }
+    else {
+      args.push_back(last_dt);
+    }
+    args.push_back(test_cut_names.at(i));
+    sql=QString("update CUTS set ");
+    for(int j=0;test_columns[j]!=NULL;j++) {
+      sql+=QString(test_columns[j])+"=?,";
+    }
+    sql=sql.left(sql.length()-1);
+    sql+=" where CUT_NAME=?";
+    RDSqlQuery::apply(sql,args);
+  }
+}
+
+
+void MainObject::SaveSchedule()
+{
+  QString sql;
+  RDSqlQuery *q;
+
+  sql=QString("select ");
+  for(int i=0;test_columns[i]!=NULL;i++) {
+    sql+=QString(test_columns[i])+",";
+  }
+  sql=sql.left(sql.length()-1);
+  sql+=" from CUTS where CUT_NAME=?";
+  for(int i=0;i<test_cut_names.size();i++) {
+    QList<QVariant> row;
+    q=new RDSqlQuery(sql,QList<QVariant>()<<test_cut_names.at(i));
+    if(q->first()) {
+      for(int j=0;test_columns[j]!=NULL;j++) {
+	row.push_back(q->value(j));
+      }
+    }
+    delete q;
+    test_saved_rows.push_back(row);
+  }
+}
+
+
+void MainObject::RestoreSchedule()
+{
+  QString sql;
+
+  sql=QString("update CUTS set ");
+  for(int i=0;test_columns[i]!=NULL;i++) {
+    sql+=QString(test_columns[i])+"=?,";
+  }
+  sql=sql.left(sql.length()-1);
+  sql+=" where CUT_NAME=?";
+  for(int i=0;i<test_cut_names.size();i++) {
+    if(test_saved_rows.at(i).size()>0) {
+      RDSqlQuery::apply(sql,QList<QVariant>(test_saved_rows.at(i))<<
+			test_cut_names.at(i));
+    }
+  }
+}
+
+
+int main(int argc,char *argv[])
+{
+  QApplication a(argc,argv,false);
+  new MainObject();
+  return a.exec();
+}
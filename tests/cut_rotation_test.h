@@ -0,0 +1,47 @@
+// cut_rotation_test.h
+//
+// Compare the in-memory cut rotation engine with RDCart::selectCut()
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef CUT_ROTATION_TEST_H
+#define CUT_ROTATION_TEST_H
+
+#include <QList>
+#include <QObject>
+#include <QStringList>
+#include <QVariant>
+
+#define CUT_ROTATION_TEST_USAGE "[options]\n\nCompare the cut selections made by the in-memory rotation engine with\nthose made by the SQL implementation, over randomized cut schedules.\nTHE SCHEDULING FIELDS OF THE SPECIFIED CART'S CUTS ARE MODIFIED DURING\nTHE TEST AND RESTORED AFTERWARD.\n\nOptions are:\n--cart-number=<num>\n     Cart to test against. Must be an audio cart with at least one cut.\n\n--iterations=<num>\n     Number of randomized schedules to test. Default is 100.\n\n--seed=<num>\n     Random number seed. Default is the current time.\n\n"
+
+class MainObject : public QObject
+{
+  Q_OBJECT
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  void Randomize();
+  void SaveSchedule();
+  void RestoreSchedule();
+  unsigned test_cart_number;
+  QStringList test_cut_names;
+  QList<QList<QVariant> > test_saved_rows;
+};
+
+
+#endif  // CUT_ROTATION_TEST_H
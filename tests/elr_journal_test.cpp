@@ -0,0 +1,339 @@
+// elr_journal_test.cpp
+//
+// Check RDElrJournal across database outages and restarts
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <QApplication>
+#include <QDateTime>
+#include <QDir>
+
+#include <rdapplication.h>
+#include <rddb.h>
+#include <rdescape_string.h>
+#include <rdlog_line.h>
+#include <rdsvc.h>
+
+#include "elr_journal_test.h"
+
+MainObject::MainObject(QObject *parent)
+  :QObject(parent)
+{
+  QString err_msg;
+  unsigned max_latency=20;
+  unsigned errors=0;
+  uint64_t max_usecs=0;
+  uint64_t total_usecs=0;
+  uint64_t stats[2];
+  int fds[2];
+  pid_t pid;
+  bool ok=false;
+
+  test_records=500;
+
+  rda=new RDApplication("elr_journal_test","elr_journal_test",
+			ELR_JOURNAL_TEST_USAGE,this);
+  if(!rda->open(&err_msg)) {
+    fprintf(stderr,"elr_journal_test: %s\n",(const char *)err_msg);
+    exit(1);
+  }
+
+  for(unsigned i=0;i<rda->cmdSwitch()->keys();i++) {
+    if(rda->cmdSwitch()->key(i)=="--service") {
+      test_service=rda->cmdSwitch()->value(i);
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--records") {
+      test_records=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if((!ok)||(test_records==0)) {
+	fprintf(stderr,"elr_journal_test: invalid --records\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--max-latency") {
+      max_latency=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if(!ok) {
+	fprintf(stderr,"elr_journal_test: invalid --max-latency\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(!rda->cmdSwitch()->processed(i)) {
+      fprintf(stderr,"elr_journal_test: unknown command option \"%s\"\n",
+	      (const char *)rda->cmdSwitch()->key(i));
+      exit(2);
+    }
+  }
+
+  //
+  // Sanity Checks
+  //
+  if(test_service.isEmpty()) {
+    fprintf(stderr,"elr_journal_test: you must specify --service\n");
+    exit(1);
+  }
+  if(!RDSvc::exists(test_service)) {
+    fprintf(stderr,"elr_journal_test: no such service \"%s\"\n",
+	    (const char *)test_service.toUtf8());
+    exit(1);
+  }
+  test_tag=QString().sprintf("ELR_JOURNAL_TEST_%d",getpid());
+  test_spool_dir=QString().sprintf("/tmp/elr_journal_test-%d",getpid());
+
+  //
+  // Phase 1: idle database
+  //
+  RDElrJournal *jour=
+    new RDElrJournal(rda->config(),test_spool_dir,"elr_journal_test");
+  if(!jour->open(&err_msg)) {
+    fprintf(stderr,"elr_journal_test: %s\n",(const char *)err_msg.toUtf8());
+    exit(1);
+  }
+  Append(jour,"a",&max_usecs,&total_usecs);
+  printf("append, idle database: mean %.1lf uS  max %.1lf uS\n",
+	 (double)total_usecs/(double)test_records,(double)max_usecs);
+  if(!jour->waitForFlush(30000)) {
+    printf("  timed out waiting for flush\n");
+  }
+  delete jour;
+  if(!Check("a","idle database")) {
+    errors++;
+  }
+
+  //
+  // Phase 2: write while the table is locked, then kill the writer
+  //
+  if(pipe(fds)!=0) {
+    perror("elr_journal_test");
+    exit(1);
+  }
+  LockTable(true);
+  if((pid=fork())==0) {
+    ::close(fds[0]);
+    jour=new RDElrJournal(rda->config(),test_spool_dir,"elr_journal_test");
+    if(!jour->open(&err_msg)) {
+      fprintf(stderr,"elr_journal_test: %s\n",(const char *)err_msg.toUtf8());
+      _exit(1);
+    }
+    stats[0]=0;
+    stats[1]=0;
+    Append(jour,"b",stats,stats+1);
+    write(fds[1],stats,sizeof(stats));
+    sleep(2);
+    raise(SIGKILL);
+  }
+  ::close(fds[1]);
+  stats[0]=0;
+  stats[1]=0;
+  read(fds[0],stats,sizeof(stats));
+  ::close(fds[0]);
+  waitpid(pid,NULL,0);
+  LockTable(false);
+  printf("append, locked database: mean %.1lf uS  max %.1lf uS\n",
+	 (double)stats[1]/(double)test_records,(double)stats[0]);
+  if(stats[0]>(1000*(uint64_t)max_latency)) {
+    printf("  FAILED: append took longer than %u mS\n",max_latency);
+    errors++;
+  }
+
+  //
+  // Restart, which should replay the spool
+  //
+  jour=new RDElrJournal(rda->config(),test_spool_dir,"elr_journal_test");
+  if(!jour->open(&err_msg)) {
+    fprintf(stderr,"elr_journal_test: %s\n",(const char *)err_msg.toUtf8());
+    Cleanup();
+    exit(1);
+  }
+  if(!jour->waitForFlush(30000)) {
+    printf("  timed out waiting for replay\n");
+  }
+  if(!Check("b","killed while locked, restarted")) {
+    errors++;
+  }
+
+  //
+  // Phase 3: lose the database connection in the middle of an insert
+  //
+  LockTable(true);
+  max_usecs=0;
+  total_usecs=0;
+  Append(jour,"c",&max_usecs,&total_usecs);
+  sleep(1+RD_ELR_JOURNAL_FLUSH_INTERVAL/1000);
+  if(!KillWriter()) {
+    printf("  journal insert not found in process list\n");
+  }
+  LockTable(false);
+  if(!jour->waitForFlush(30000+RD_ELR_JOURNAL_RETRY_INTERVAL)) {
+    printf("  timed out waiting for flush after reconnect\n");
+  }
+  delete jour;
+  if(!Check("c","connection killed mid-insert")) {
+    errors++;
+  }
+
+  Cleanup();
+  if(errors>0) {
+    printf("FAILED: %u check(s) failed\n",errors);
+    exit(1);
+  }
+  printf("PASSED\n");
+  exit(0);
+}
+
+
+void MainObject::Append(RDElrJournal *jour,const QString &phase,
+			uint64_t *max_usecs,uint64_t *total_usecs)
+{
+  uint64_t start;
+  uint64_t usecs;
+  QDateTime now=QDateTime::currentDateTime();
+
+  for(unsigned i=0;i<test_records;i++) {
+    RDElrRecord rec;
+    rec.setValue("SERVICE_NAME",test_service);
+    rec.setValue("LENGTH",(int)(1000*(i%300)));
+    rec.setValue("CART_NUMBER",(unsigned)(1+i%999999));
+    rec.setValue("STATION_NAME",rda->station()->name());
+    rec.setValue("EVENT_DATETIME",now.toString("yyyy-MM-dd hh:mm:ss"));
+    rec.setValue("EVENT_TYPE",RDAirPlayConf::TrafficFinish);
+    rec.setValue("PLAY_SOURCE",RDLogLine::MainLog);
+    rec.setValue("EXT_DATA",test_tag+"-"+phase+QString().sprintf("-%u",i));
+    rec.setValue("TITLE","Test \"record\"\twith\nodd\\characters");
+    start=Now();
+    jour->append(rec);
+    usecs=Now()-start;
+    *total_usecs+=usecs;
+    if(usecs>*max_usecs) {
+      *max_usecs=usecs;
+    }
+  }
+}
+
+
+bool MainObject::Check(const QString &phase,const QString &desc)
+{
+  unsigned rows=0;
+  unsigned distinct=0;
+  unsigned mangled=0;
+
+  QString sql=QString("select ")+
+    "count(*),"+                 // 00
+    "count(distinct EXT_DATA) "+  // 01
+    "from ELR_LINES where "+
+    "EXT_DATA like \""+RDEscapeString(test_tag+"-"+phase+"-")+"%\"";
+  RDSqlQuery *q=new RDSqlQuery(sql);
+  if(q->first()) {
+    rows=q->value(0).toUInt();
+    distinct=q->value(1).toUInt();
+  }
+  delete q;
+  sql=QString("select ")+
+    "count(*) "+  // 00
+    "from ELR_LINES where "+
+    "EXT_DATA like \""+RDEscapeString(test_tag+"-"+phase+"-")+"%\" && "+
+    "TITLE!=\""+RDEscapeString("Test \"record\"\twith\nodd\\characters")+"\"";
+  mangled=RDSqlQuery::run(sql).toUInt();
+
+  printf("  %-32s %u/%u records, %u duplicated, %u mangled",
+	 (const char *)desc.toUtf8(),distinct,test_records,rows-distinct,
+	 mangled);
+  if((distinct!=test_records)||(mangled>0)) {
+    printf("  FAILED\n");
+    return false;
+  }
+  if(rows!=distinct) {
+    //
+    // Possible if the writer died between commit and recording its
+    // position; not a loss, so report it without failing.
+    //
+    printf("  (duplicates)\n");
+    return true;
+  }
+  printf("\n");
+
+  return true;
+}
+
+
+void MainObject::LockTable(bool state)
+{
+  if(state) {
+    RDSqlQuery::apply("lock tables ELR_LINES write");
+  }
+  else {
+    RDSqlQuery::apply("unlock tables");
+  }
+}
+
+
+bool MainObject::KillWriter()
+{
+  bool ret=false;
+
+  RDSqlQuery *q=new RDSqlQuery("show processlist");
+  while(q->next()) {
+    if(q->value(7).toString().startsWith("insert into ELR_LINES")) {
+      RDSqlQuery::apply(QString().sprintf("kill %u",q->value(0).toUInt()));
+      ret=true;
+    }
+  }
+  delete q;
+
+  return ret;
+}
+
+
+void MainObject::Cleanup()
+{
+  QString sql=QString("delete from ELR_LINES where ")+
+    "EXT_DATA like \""+RDEscapeString(test_tag)+"-%\"";
+  RDSqlQuery::apply(sql);
+
+  QDir dir(test_spool_dir);
+  QStringList files=dir.entryList(QDir::Files);
+  for(int i=0;i<files.size();i++) {
+    dir.remove(files.at(i));
+  }
+  QDir().rmdir(test_spool_dir);
+}
+
+
+uint64_t MainObject::Now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return 1000000*(uint64_t)ts.tv_sec+(uint64_t)ts.tv_nsec/1000;
+}
+
+
+int main(int argc,char *argv[])
+{
+  QApplication a(argc,argv,false);
+  new MainObject();
+  return a.exec();
+}
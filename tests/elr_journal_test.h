@@ -0,0 +1,52 @@
+// elr_journal_test.h
+//
+// Check RDElrJournal across database outages and restarts
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef ELR_JOURNAL_TEST_H
+#define ELR_JOURNAL_TEST_H
+
+#include <stdint.h>
+
+#include <qobject.h>
+
+#include <rdelrjournal.h>
+
+#define ELR_JOURNAL_TEST_USAGE "[options]\n\nWrite synthetic as-played records through RDElrJournal while the ELR_LINES\ntable is write-locked, kill the writing process, then check that every\nrecord reaches the database after a restart; and that records survive the\njournal's database connection being killed mid-insert. The time taken by\neach append is reported for an idle and for a locked database.\nTHE ELR_LINES TABLE IS LOCKED FOR SEVERAL SECONDS DURING THE TEST.\n\nOptions are:\n--service=<name>\n     Service to which the records are credited.\n\n--records=<num>\n     Number of records written in each phase. Default is 500.\n\n--max-latency=<msecs>\n     Longest acceptable append while the database is locked. Default is 20.\n\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  void Append(RDElrJournal *jour,const QString &phase,uint64_t *max_usecs,
+	      uint64_t *total_usecs);
+  bool Check(const QString &phase,const QString &desc);
+  void LockTable(bool state);
+  bool KillWriter();
+  void Cleanup();
+  static uint64_t Now();
+  QString test_service;
+  QString test_tag;
+  QString test_spool_dir;
+  unsigned test_records;
+};
+
+
+#endif  // ELR_JOURNAL_TEST_H
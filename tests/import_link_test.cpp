@@ -0,0 +1,261 @@
+// import_link_test.cpp
+//
+// Compare log merges between the direct and staged import methods
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <QApplication>
+#include <QSqlRecord>
+#include <QStringList>
+#include <QTime>
+
+#include <rdapplication.h>
+#include <rddb.h>
+#include <rdescape_string.h>
+#include <rdlog.h>
+
+#include "import_link_test.h"
+
+MainObject::MainObject(QObject *parent)
+  :QObject(parent)
+{
+  QString err_msg;
+  QString svc_name;
+  QString music_file;
+  QString traffic_file;
+  bool ok=false;
+
+  test_date=QDate::currentDate();
+  test_log_name="IMPORT_LINK_TEST";
+  test_seed=1;
+
+  rda=new RDApplication("import_link_test","import_link_test",
+			IMPORT_LINK_TEST_USAGE,this);
+  if(!rda->open(&err_msg)) {
+    fprintf(stderr,"import_link_test: %s\n",(const char *)err_msg);
+    exit(1);
+  }
+
+  for(unsigned i=0;i<rda->cmdSwitch()->keys();i++) {
+    if(rda->cmdSwitch()->key(i)=="--service") {
+      svc_name=rda->cmdSwitch()->value(i);
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--date") {
+      test_date=QDate::fromString(rda->cmdSwitch()->value(i),"yyyy-MM-dd");
+      if(!test_date.isValid()) {
+	fprintf(stderr,"import_link_test: invalid --date\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--music-file") {
+      music_file=rda->cmdSwitch()->value(i);
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--traffic-file") {
+      traffic_file=rda->cmdSwitch()->value(i);
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--log") {
+      test_log_name=rda->cmdSwitch()->value(i);
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--seed") {
+      test_seed=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if(!ok) {
+	fprintf(stderr,"import_link_test: invalid --seed\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(!rda->cmdSwitch()->processed(i)) {
+      fprintf(stderr,"import_link_test: unknown command option \"%s\"\n",
+	      (const char *)rda->cmdSwitch()->key(i));
+      exit(2);
+    }
+  }
+
+  //
+  // Sanity Checks
+  //
+  if(svc_name.isEmpty()) {
+    fprintf(stderr,"import_link_test: you must specify --service\n");
+    exit(1);
+  }
+  test_svc=new RDSvc(svc_name,rda->station(),rda->config(),this);
+  if(!test_svc->exists()) {
+    fprintf(stderr,"import_link_test: no such service \"%s\"\n",
+	    (const char *)svc_name.toUtf8());
+    exit(1);
+  }
+  if(RDLog::exists(test_log_name)) {
+    fprintf(stderr,"import_link_test: log \"%s\" already exists\n",
+	    (const char *)test_log_name.toUtf8());
+    exit(1);
+  }
+  test_user=new RDUser(rda->station()->defaultName());
+  printf("import_link_test: service \"%s\", %s\n",
+	 (const char *)svc_name.toUtf8(),
+	 (const char *)test_date.toString("yyyy-MM-dd").toUtf8());
+
+  //
+  // Point the Service at the Fixtures
+  //
+  QString saved_music_path=test_svc->importPath(RDSvc::Music);
+  QString saved_traffic_path=test_svc->importPath(RDSvc::Traffic);
+  if(!music_file.isEmpty()) {
+    test_svc->setImportPath(RDSvc::Music,music_file);
+  }
+  if(!traffic_file.isEmpty()) {
+    test_svc->setImportPath(RDSvc::Traffic,traffic_file);
+  }
+
+  //
+  // Run the Test
+  //
+  QString direct_text;
+  QString staged_text;
+  int direct_msecs=0;
+  int staged_msecs=0;
+  bool direct_ok=Run(RDSvc::DirectImport,&direct_text,&direct_msecs,&err_msg);
+  if(!direct_ok) {
+    printf("  direct import: %s\n",(const char *)err_msg.toUtf8());
+  }
+  bool staged_ok=Run(RDSvc::StagedImport,&staged_text,&staged_msecs,&err_msg);
+  if(!staged_ok) {
+    printf("  staged import: %s\n",(const char *)err_msg.toUtf8());
+  }
+  printf("merge time: direct: %d mS  staged: %d mS\n",
+	 direct_msecs,staged_msecs);
+
+  //
+  // Clean Up
+  //
+  test_svc->setImportPath(RDSvc::Music,saved_music_path);
+  test_svc->setImportPath(RDSvc::Traffic,saved_traffic_path);
+
+  if((!direct_ok)||(!staged_ok)) {
+    printf("FAILED: unable to generate log\n");
+    exit(1);
+  }
+  if(direct_text!=staged_text) {
+    QStringList direct_lines=direct_text.split("\n");
+    QStringList staged_lines=staged_text.split("\n");
+    for(int i=0;i<direct_lines.size();i++) {
+      if((i>=staged_lines.size())||(direct_lines.at(i)!=staged_lines.at(i))) {
+	printf("  direct: %s\n",(const char *)direct_lines.at(i).toUtf8());
+	if(i<staged_lines.size()) {
+	  printf("  staged: %s\n",(const char *)staged_lines.at(i).toUtf8());
+	}
+	break;
+      }
+    }
+    printf("FAILED: merged logs differ\n");
+    exit(1);
+  }
+  printf("PASSED\n");
+  exit(0);
+}
+
+
+bool MainObject::Run(RDSvc::ImportMethod method,QString *text,int *msecs,
+		     QString *err_msg)
+{
+  QString report;
+  QTime timer;
+  const RDSvc::ImportSource srcs[]={RDSvc::Music,RDSvc::Traffic};
+
+  *text="";
+  *msecs=0;
+
+  //
+  // Generate the Log
+  //
+  srand(test_seed);
+  if(!test_svc->generateLog(test_date,test_log_name,"",&report,test_user,
+			    err_msg)) {
+    RDLog::remove(test_log_name,rda->station(),test_user,rda->config());
+    return false;
+  }
+  *text+="GENERATE\n"+report+"\n";
+
+  //
+  // Merge the Imports
+  //
+  test_svc->setImportMethod(method);
+  for(unsigned i=0;i<2;i++) {
+    if(test_svc->importPath(srcs[i]).isEmpty()) {
+      continue;
+    }
+    report="";
+    timer.start();
+    bool ok=test_svc->linkLog(srcs[i],test_date,test_log_name,&report,
+			      test_user,err_msg);
+    *msecs+=timer.elapsed();
+    if(srcs[i]==RDSvc::Music) {
+      *text+="MUSIC ";
+    }
+    else {
+      *text+="TRAFFIC ";
+    }
+    if(ok) {
+      *text+="OK\n"+report+"\n";
+    }
+    else {
+      *text+="FAILED\n"+*err_msg+"\n";
+    }
+  }
+  *text+=LogText();
+  RDLog::remove(test_log_name,rda->station(),test_user,rda->config());
+
+  return true;
+}
+
+
+QString MainObject::LogText() const
+{
+  QString ret;
+
+  QString sql=QString("select * from LOG_LINES where ")+
+    "LOG_NAME=\""+RDEscapeString(test_log_name)+"\" "+
+    "order by COUNT";
+  RDSqlQuery *q=new RDSqlQuery(sql);
+  while(q->next()) {
+    QSqlRecord rec=q->record();
+    for(int i=0;i<rec.count();i++) {
+      if(rec.fieldName(i)!="ID") {
+	ret+=rec.fieldName(i)+"="+q->value(i).toString()+" ";
+      }
+    }
+    ret+="\n";
+  }
+  delete q;
+
+  return ret;
+}
+
+
+int main(int argc,char *argv[])
+{
+  QApplication a(argc,argv,false);
+  new MainObject();
+  return a.exec();
+}
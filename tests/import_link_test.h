@@ -0,0 +1,50 @@
+// import_link_test.h
+//
+// Compare log merges between the direct and staged import methods
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef IMPORT_LINK_TEST_H
+#define IMPORT_LINK_TEST_H
+
+#include <QDate>
+#include <QObject>
+#include <QString>
+
+#include <rdsvc.h>
+#include <rduser.h>
+
+#define IMPORT_LINK_TEST_USAGE "[options]\n\nGenerate a scratch log for the specified service and merge the music and\ntraffic import files into it, once parsing the files straight into the\nmerge and once staging them through the IMPORTER_LINES table, and check\nthat the resulting logs and exception reports are identical.\nTHE IMPORT PATHS OF THE SERVICE ARE MODIFIED DURING THE TEST AND\nRESTORED AFTERWARD.\n\nOptions are:\n--service=<name>\n     Service to use.\n\n--date=<yyyy-MM-dd>\n     Date of the log. Default is today.\n\n--music-file=<path>\n     Music import fixture. Default is the service's music import path.\n\n--traffic-file=<path>\n     Traffic import fixture. Default is the service's traffic import path.\n\n--log=<name>\n     Name of the scratch log, which must not already exist. Default is\n     'IMPORT_LINK_TEST'.\n\n--seed=<num>\n     Random number seed used for log generation. Default is 1.\n\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  bool Run(RDSvc::ImportMethod method,QString *text,int *msecs,
+	   QString *err_msg);
+  QString LogText() const;
+  RDSvc *test_svc;
+  RDUser *test_user;
+  QDate test_date;
+  QString test_log_name;
+  unsigned test_seed;
+};
+
+
+#endif  // IMPORT_LINK_TEST_H
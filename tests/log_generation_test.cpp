@@ -0,0 +1,214 @@
+// log_generation_test.cpp
+//
+// Compare log generation with and without preloaded templates
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <QApplication>
+#include <QSqlRecord>
+#include <QTime>
+
+#include <rdapplication.h>
+#include <rddb.h>
+#include <rdescape_string.h>
+#include <rdlog.h>
+#include <rdsvc.h>
+
+#include "log_generation_test.h"
+
+MainObject::MainObject(QObject *parent)
+  :QObject(parent)
+{
+  QString err_msg;
+  QStringList svc_names;
+  unsigned errors=0;
+  bool ok=false;
+
+  test_date=QDate::currentDate();
+  test_days=1;
+  test_seed=1;
+
+  rda=new RDApplication("log_generation_test","log_generation_test",
+			LOG_GENERATION_TEST_USAGE,this);
+  if(!rda->open(&err_msg)) {
+    fprintf(stderr,"log_generation_test: %s\n",(const char *)err_msg);
+    exit(1);
+  }
+
+  for(unsigned i=0;i<rda->cmdSwitch()->keys();i++) {
+    if(rda->cmdSwitch()->key(i)=="--service") {
+      svc_names.push_back(rda->cmdSwitch()->value(i));
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--date") {
+      test_date=QDate::fromString(rda->cmdSwitch()->value(i),"yyyy-MM-dd");
+      if(!test_date.isValid()) {
+	fprintf(stderr,"log_generation_test: invalid --date\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--days") {
+      test_days=rda->cmdSwitch()->value(i).toInt(&ok);
+      if((!ok)||(test_days<1)) {
+	fprintf(stderr,"log_generation_test: invalid --days\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--seed") {
+      test_seed=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if(!ok) {
+	fprintf(stderr,"log_generation_test: invalid --seed\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(!rda->cmdSwitch()->processed(i)) {
+      fprintf(stderr,"log_generation_test: unknown command option \"%s\"\n",
+	      (const char *)rda->cmdSwitch()->key(i));
+      exit(2);
+    }
+  }
+
+  //
+  // Sanity Checks
+  //
+  if(svc_names.size()==0) {
+    fprintf(stderr,"log_generation_test: you must specify --service\n");
+    exit(1);
+  }
+  for(int i=0;i<svc_names.size();i++) {
+    if(!RDSvc::exists(svc_names.at(i))) {
+      fprintf(stderr,"log_generation_test: no such service \"%s\"\n",
+	      (const char *)svc_names.at(i).toUtf8());
+      exit(1);
+    }
+  }
+  test_user=new RDUser(rda->station()->defaultName());
+
+  //
+  // Run the Test
+  //
+  int db_msecs=0;
+  int cache_msecs=0;
+  QTime timer;
+  timer.start();
+  RDLogTemplateCache *cache=new RDLogTemplateCache(rda->station());
+  cache->load(svc_names);
+  int load_msecs=timer.elapsed();
+  for(int i=0;i<svc_names.size();i++) {
+    QString db_text=Generate(svc_names.at(i),NULL,&db_msecs);
+    QString cache_text=Generate(svc_names.at(i),cache,&cache_msecs);
+    printf("  %-32s ",(const char *)svc_names.at(i).toUtf8());
+    if(db_text==cache_text) {
+      printf("identical\n");
+    }
+    else {
+      printf("FAILED: generated logs differ\n");
+      errors++;
+    }
+  }
+  delete cache;
+  printf("generation time: per-hour loads: %d mS  preloaded: %d mS "
+	 "(+%d mS to load)\n",db_msecs,cache_msecs,load_msecs);
+
+  if(errors>0) {
+    printf("FAILED: %u service(s) differ\n",errors);
+    exit(1);
+  }
+  printf("PASSED\n");
+  exit(0);
+}
+
+
+QString MainObject::Generate(const QString &svcname,
+			     RDLogTemplateCache *cache,int *msecs)
+{
+  QString ret;
+  QString report;
+  QString err_msg;
+  QTime timer;
+  QString logname="LOG_GENERATION_TEST";
+  RDSvc *svc=new RDSvc(svcname,rda->station(),rda->config());
+
+  //
+  // Remember the scheduler stack, so it can be rewound afterward
+  //
+  QString sql=QString("select ")+
+    "MAX(ID) "+  // 00
+    "from STACK_LINES";
+  unsigned stack_id=RDSqlQuery::run(sql).toUInt();
+
+  svc->setTemplateCache(cache);
+  srand(test_seed+qHash(svcname));
+  for(int i=0;i<test_days;i++) {
+    report="";
+    timer.start();
+    if(!svc->generateLog(test_date.addDays(i),logname,"",&report,test_user,
+			 &err_msg)) {
+      ret+="FAILED: "+err_msg+"\n";
+    }
+    *msecs+=timer.elapsed();
+    ret+=report+"\n"+LogText(logname);
+    RDLog::remove(logname,rda->station(),test_user,rda->config());
+  }
+
+  sql=QString("delete from STACK_SCHED_CODES where ")+
+    QString().sprintf("STACK_LINES_ID>%u",stack_id);
+  RDSqlQuery::apply(sql);
+  sql=QString("delete from STACK_LINES where ")+
+    QString().sprintf("ID>%u",stack_id);
+  RDSqlQuery::apply(sql);
+  delete svc;
+
+  return ret;
+}
+
+
+QString MainObject::LogText(const QString &logname) const
+{
+  QString ret;
+
+  QString sql=QString("select * from LOG_LINES where ")+
+    "LOG_NAME=\""+RDEscapeString(logname)+"\" "+
+    "order by COUNT";
+  RDSqlQuery *q=new RDSqlQuery(sql);
+  while(q->next()) {
+    QSqlRecord rec=q->record();
+    for(int i=0;i<rec.count();i++) {
+      if(rec.fieldName(i)!="ID") {
+	ret+=rec.fieldName(i)+"="+q->value(i).toString()+" ";
+      }
+    }
+    ret+="\n";
+  }
+  delete q;
+
+  return ret;
+}
+
+
+int main(int argc,char *argv[])
+{
+  QApplication a(argc,argv,false);
+  new MainObject();
+  return a.exec();
+}
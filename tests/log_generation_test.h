@@ -0,0 +1,49 @@
+// log_generation_test.h
+//
+// Compare log generation with and without preloaded templates
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef LOG_GENERATION_TEST_H
+#define LOG_GENERATION_TEST_H
+
+#include <QDate>
+#include <QObject>
+#include <QStringList>
+
+#include <rdlogtemplatecache.h>
+#include <rduser.h>
+
+#define LOG_GENERATION_TEST_USAGE "[options]\n\nGenerate scratch logs for the specified services, once loading the grid,\nclocks and events from the database for every hour and once from a\npreloaded RDLogTemplateCache, and check that the resulting logs are\nidentical. Music scheduler entries added to the services' stacks by the\ntest are removed afterward.\n\nOptions are:\n--service=<name>\n     Service to use. May be given more than once.\n\n--date=<yyyy-MM-dd>\n     Date of the first log. Default is today.\n\n--days=<num>\n     Number of consecutive days to generate. Default is 1.\n\n--seed=<num>\n     Random number seed used for log generation. Default is 1.\n\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  QString Generate(const QString &svcname,RDLogTemplateCache *cache,
+		   int *msecs);
+  QString LogText(const QString &logname) const;
+  QDate test_date;
+  int test_days;
+  unsigned test_seed;
+  RDUser *test_user;
+};
+
+
+#endif  // LOG_GENERATION_TEST_H
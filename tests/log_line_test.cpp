@@ -0,0 +1,433 @@
+// log_line_test.cpp
+//
+// Measure the memory use and copy time of RDLogLine
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <qapplication.h>
+
+#include <rdapplication.h>
+#include <rdcmd_switch.h>
+#include <rdlog_event.h>
+#include <rdstringpool.h>
+
+#include "log_line_test.h"
+
+MainObject::MainObject(QObject *parent)
+  :QObject(parent)
+{
+  QString logname;
+  unsigned lines=10000;
+  unsigned carts=1500;
+  unsigned seed=time(NULL);
+  unsigned errors=0;
+  uint64_t start;
+  uint64_t heap;
+  bool ok=false;
+
+  RDCmdSwitch *cmd=new RDCmdSwitch(qApp->argc(),qApp->argv(),"log_line_test",
+				   LOG_LINE_TEST_USAGE);
+  for(unsigned i=0;i<cmd->keys();i++) {
+    if(cmd->key(i)=="--lines") {
+      lines=cmd->value(i).toUInt(&ok);
+      if((!ok)||(lines==0)) {
+	fprintf(stderr,"log_line_test: invalid --lines\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--carts") {
+      carts=cmd->value(i).toUInt(&ok);
+      if((!ok)||(carts==0)) {
+	fprintf(stderr,"log_line_test: invalid --carts\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--log") {
+      logname=cmd->value(i);
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--seed") {
+      seed=cmd->value(i).toUInt(&ok);
+      if(!ok) {
+	fprintf(stderr,"log_line_test: invalid --seed\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(!cmd->processed(i)) {
+      fprintf(stderr,"log_line_test: unknown command option \"%s\"\n",
+	      (const char *)cmd->key(i));
+      exit(2);
+    }
+  }
+  srand(seed);
+  printf("seed: %u\n",seed);
+  Catalogue(carts);
+  std::vector<unsigned> cartnums;
+  for(unsigned i=0;i<lines;i++) {
+    cartnums.push_back(rand()%carts);
+  }
+
+  printf("%u lines from %u carts\n",lines,carts);
+  printf("  sizeof(RDLogLine) was %u bytes, now %u bytes\n",
+	 (unsigned)sizeof(LegacyLogLine),(unsigned)sizeof(RDLogLine));
+  printf("                 bytes/line   fill (mS)   copy (mS)  "
+	 "copy bytes/line\n");
+
+  //
+  // Original layout
+  //
+  std::vector<LegacyLogLine *> legacy;
+  std::vector<LegacyLogLine *> legacy_copy;
+  heap=HeapUsed();
+  start=Now();
+  for(unsigned i=0;i<lines;i++) {
+    legacy.push_back(new LegacyLogLine());
+    FillLegacy(legacy.back(),i,cartnums.at(i));
+  }
+  double fill_msecs=(double)(Now()-start)/1000.0;
+  double fill_bytes=(double)(HeapUsed()-heap)/(double)lines;
+  heap=HeapUsed();
+  start=Now();
+  for(unsigned i=0;i<lines;i++) {
+    legacy_copy.push_back(new LegacyLogLine(*legacy.at(i)));
+  }
+  double copy_msecs=(double)(Now()-start)/1000.0;
+  double copy_bytes=(double)(HeapUsed()-heap)/(double)lines;
+  printf("  original     %12.0lf %11.1lf %11.1lf %16.0lf\n",
+	 fill_bytes,fill_msecs,copy_msecs,copy_bytes);
+
+  //
+  // Current layout
+  //
+  std::vector<RDLogLine *> current;
+  std::vector<RDLogLine *> current_copy;
+  heap=HeapUsed();
+  start=Now();
+  for(unsigned i=0;i<lines;i++) {
+    current.push_back(new RDLogLine());
+    Fill(current.back(),i,cartnums.at(i));
+  }
+  fill_msecs=(double)(Now()-start)/1000.0;
+  fill_bytes=(double)(HeapUsed()-heap)/(double)lines;
+  heap=HeapUsed();
+  start=Now();
+  for(unsigned i=0;i<lines;i++) {
+    current_copy.push_back(new RDLogLine(*current.at(i)));
+  }
+  copy_msecs=(double)(Now()-start)/1000.0;
+  copy_bytes=(double)(HeapUsed()-heap)/(double)lines;
+  printf("  current      %12.0lf %11.1lf %11.1lf %16.0lf\n",
+	 fill_bytes,fill_msecs,copy_msecs,copy_bytes);
+  printf("  %d strings in the pool\n",RDStringPool::size());
+
+  //
+  // Contents
+  //
+  for(unsigned i=0;i<lines;i++) {
+    if((!Compare(legacy.at(i),current.at(i)))||
+       (!Compare(legacy.at(i),current_copy.at(i)))) {
+      if(errors<10) {
+	printf("  MISMATCH: line %u\n",i);
+      }
+      errors++;
+    }
+  }
+
+  //
+  // Changing a copy must leave the original alone
+  //
+  current_copy.at(0)->setTitle("Changed Title");
+  current_copy.at(0)->clearExternalData();
+  if(!Compare(legacy.at(0),current.at(0))) {
+    printf("  FAILED: changing a copy changed the original\n");
+    errors++;
+  }
+  if(current_copy.at(0)->title()!="Changed Title") {
+    printf("  FAILED: copy not changed\n");
+    errors++;
+  }
+
+  for(unsigned i=0;i<lines;i++) {
+    delete legacy.at(i);
+    delete legacy_copy.at(i);
+    delete current.at(i);
+    delete current_copy.at(i);
+  }
+
+  if(!logname.isEmpty()) {
+    LoadLog(logname);
+  }
+
+  if(errors>0) {
+    printf("FAILED: %u line(s) differ\n",errors);
+    exit(1);
+  }
+  printf("PASSED\n");
+  exit(0);
+}
+
+
+void MainObject::Catalogue(unsigned carts)
+{
+  //
+  // Scheduled music repeats artists, albums and labels far more than
+  // titles, and a handful of groups and people cover everything
+  //
+  for(unsigned i=0;i<carts;i++) {
+    test_titles.push_back(QString().sprintf("Song Title Number %u",i));
+  }
+  for(unsigned i=0;i<(1+carts/4);i++) {
+    test_artists.push_back(QString().sprintf("Recording Artist %u",i));
+  }
+  for(unsigned i=0;i<(1+carts/3);i++) {
+    test_albums.push_back(QString().sprintf("Album Title %u",i));
+  }
+  for(unsigned i=0;i<40;i++) {
+    test_labels.push_back(QString().sprintf("Record Label %u",i));
+  }
+  for(unsigned i=0;i<12;i++) {
+    test_groups.push_back(QString().sprintf("GROUP%u",i));
+  }
+  for(unsigned i=0;i<200;i++) {
+    test_people.push_back(QString().sprintf("Composer Or Publisher %u",i));
+  }
+  for(unsigned i=0;i<25;i++) {
+    test_clients.push_back(QString().sprintf("Client %u",i));
+  }
+}
+
+
+void MainObject::FillLegacy(LegacyLogLine *ll,unsigned line,
+			    unsigned cart) const
+{
+  //
+  // As RDLogLine::clear() followed by the setters used by
+  // RDLogEvent::load(), with the original layout
+  //
+  ll->modified=false;
+  ll->log_id=line;
+  ll->log_status=RDLogLine::Scheduled;
+  ll->log_state=RDLogLine::Ok;
+  ll->log_source=RDLogLine::Music;
+  ll->log_validity=RDCart::AlwaysValid;
+  ll->log_pass=0;
+  ll->log_cart_number=1+cart;
+  for(int i=0;i<5;i++) {
+    ll->log_start_time[i]=QTime();
+  }
+  ll->log_start_time[RDLogLine::Logged]=QTime().addMSecs(1000*(line%86400));
+  ll->log_time_type=RDLogLine::Relative;
+  ll->log_origin_user=Value(test_people,0);
+  ll->log_origin_datetime=QDateTime(QDate(2026,1,1),QTime(12,0,0));
+  ll->log_trans_type=RDLogLine::Segue;
+  for(int i=0;i<2;i++) {
+    ll->log_start_point[i]=-1;
+    ll->log_end_point[i]=-1;
+    ll->log_segue_start_point[i]=-1;
+    ll->log_segue_end_point[i]=-1;
+    ll->log_fadeup_point[i]=-1;
+    ll->log_fadedown_point[i]=-1;
+  }
+  ll->log_cart_type=RDCart::Audio;
+  ll->log_group_name=Value(test_groups,cart);
+  ll->log_group_color=QColor(Qt::blue);
+  ll->log_title=Value(test_titles,cart);
+  ll->log_artist=Value(test_artists,cart);
+  ll->log_album=Value(test_albums,cart);
+  ll->log_publisher=Value(test_people,cart);
+  ll->log_composer=Value(test_people,cart+1);
+  ll->log_isrc="";
+  ll->log_recording_mbid="";
+  ll->log_release_mbid="";
+  ll->log_isci="";
+  ll->log_year=QDate(1970+cart%50,1,1);
+  ll->log_label=Value(test_labels,cart);
+  ll->log_conductor="";
+  ll->log_song_id="";
+  ll->log_client=Value(test_clients,cart);
+  ll->log_agency=Value(test_clients,cart+1);
+  ll->log_outcue="";
+  ll->log_description="";
+  ll->log_user_defined="";
+  ll->log_cart_notes="";
+  ll->log_usage_code=RDCart::UsageFeature;
+  ll->log_forced_length=180000+cart;
+  ll->log_start_datetime=QDateTime();
+  ll->log_end_datetime=QDateTime();
+  ll->log_type=RDLogLine::Cart;
+  ll->log_marker_comment="";
+  ll->log_marker_label="";
+  ll->log_port_name="";
+  ll->log_ext_cart_name=QString().sprintf("%06u",1+cart);
+  ll->log_ext_data=QString().sprintf("%u",line);
+  ll->log_ext_event_id=QString().sprintf("E%u",line);
+  ll->log_ext_annc_type="";
+  ll->log_cut_name="";
+  ll->log_link_event_name=Value(test_groups,0);
+}
+
+
+void MainObject::Fill(RDLogLine *ll,unsigned line,unsigned cart) const
+{
+  ll->clear();
+  ll->setId(line);
+  ll->setSource(RDLogLine::Music);
+  ll->setCartNumber(1+cart);
+  ll->setStartTime(RDLogLine::Logged,QTime().addMSecs(1000*(line%86400)));
+  ll->setOriginUser(Value(test_people,0));
+  ll->setOriginDateTime(QDateTime(QDate(2026,1,1),QTime(12,0,0)));
+  ll->setTransType(RDLogLine::Segue);
+  ll->setGroupName(Value(test_groups,cart));
+  ll->setGroupColor(QColor(Qt::blue));
+  ll->setTitle(Value(test_titles,cart));
+  ll->setArtist(Value(test_artists,cart));
+  ll->setAlbum(Value(test_albums,cart));
+  ll->setPublisher(Value(test_people,cart));
+  ll->setComposer(Value(test_people,cart+1));
+  ll->setYear(QDate(1970+cart%50,1,1));
+  ll->setLabel(Value(test_labels,cart));
+  ll->setClient(Value(test_clients,cart));
+  ll->setAgency(Value(test_clients,cart+1));
+  ll->setForcedLength(180000+cart);
+  ll->setExtCartName(QString().sprintf("%06u",1+cart));
+  ll->setExtData(QString().sprintf("%u",line));
+  ll->setExtEventId(QString().sprintf("E%u",line));
+  ll->setLinkEventName(Value(test_groups,0));
+}
+
+
+bool MainObject::Compare(const LegacyLogLine *legacy,
+			 const RDLogLine *ll) const
+{
+  return (legacy->log_id==ll->id())&&
+    (legacy->log_cart_number==ll->cartNumber())&&
+    (legacy->log_start_time[RDLogLine::Logged]==
+     ll->startTime(RDLogLine::Logged))&&
+    (legacy->log_trans_type==ll->transType())&&
+    (legacy->log_origin_user==ll->originUser())&&
+    (legacy->log_origin_datetime==ll->originDateTime())&&
+    (legacy->log_group_name==ll->groupName())&&
+    (legacy->log_group_color==ll->groupColor())&&
+    (legacy->log_title==ll->title())&&
+    (legacy->log_artist==ll->artist())&&
+    (legacy->log_album==ll->album())&&
+    (legacy->log_publisher==ll->publisher())&&
+    (legacy->log_composer==ll->composer())&&
+    (legacy->log_year==ll->year())&&
+    (legacy->log_label==ll->label())&&
+    (legacy->log_client==ll->client())&&
+    (legacy->log_agency==ll->agency())&&
+    (legacy->log_usage_code==ll->usageCode())&&
+    (legacy->log_forced_length==ll->forcedLength())&&
+    (legacy->log_ext_cart_name==ll->extCartName())&&
+    (legacy->log_ext_data==ll->extData())&&
+    (legacy->log_ext_event_id==ll->extEventId())&&
+    (legacy->log_ext_annc_type==ll->extAnncType())&&
+    (legacy->log_marker_comment==ll->markerComment())&&
+    (legacy->log_link_event_name==ll->linkEventName());
+}
+
+
+void MainObject::LoadLog(const QString &logname)
+{
+  QString err_msg;
+  uint64_t start;
+  uint64_t heap;
+
+  rda=new RDApplication("log_line_test","log_line_test",LOG_LINE_TEST_USAGE,
+			this);
+  if(!rda->open(&err_msg)) {
+    fprintf(stderr,"log_line_test: %s\n",(const char *)err_msg);
+    exit(1);
+  }
+
+  RDLogEvent *log=new RDLogEvent(logname);
+  heap=HeapUsed();
+  start=Now();
+  log->load();
+  double load_msecs=(double)(Now()-start)/1000.0;
+  if(log->size()==0) {
+    printf("log \"%s\" is empty or does not exist\n",
+	   (const char *)logname.toUtf8());
+    delete log;
+    return;
+  }
+  double load_bytes=(double)(HeapUsed()-heap)/(double)log->size();
+
+  std::vector<RDLogLine *> copies;
+  heap=HeapUsed();
+  start=Now();
+  for(int i=0;i<log->size();i++) {
+    copies.push_back(new RDLogLine(*log->logLine(i)));
+  }
+  double copy_msecs=(double)(Now()-start)/1000.0;
+  double copy_bytes=(double)(HeapUsed()-heap)/(double)log->size();
+  printf("log \"%s\", %d lines:\n",(const char *)logname.toUtf8(),
+	 log->size());
+  printf("  load: %.1lf mS, %.0lf bytes/line\n",load_msecs,load_bytes);
+  printf("  copy: %.1lf mS, %.0lf bytes/line\n",copy_msecs,copy_bytes);
+
+  for(unsigned i=0;i<copies.size();i++) {
+    delete copies.at(i);
+  }
+  delete log;
+}
+
+
+QString MainObject::Value(const QStringList &list,unsigned n) const
+{
+  //
+  // A new copy each time, as a value read from the database would be
+  //
+  return QString::fromUtf8(list.at(n%list.size()).toUtf8());
+}
+
+
+uint64_t MainObject::HeapUsed()
+{
+#if defined(__GLIBC__)&&((__GLIBC__>2)||(__GLIBC_MINOR__>=33))
+  return mallinfo2().uordblks;
+#else
+  return mallinfo().uordblks;
+#endif  // __GLIBC__
+}
+
+
+uint64_t MainObject::Now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return 1000000*(uint64_t)ts.tv_sec+(uint64_t)ts.tv_nsec/1000;
+}
+
+
+int main(int argc,char *argv[])
+{
+  QApplication a(argc,argv,false);
+  new MainObject();
+  return a.exec();
+}
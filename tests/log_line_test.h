@@ -0,0 +1,173 @@
+// log_line_test.h
+//
+// Measure the memory use and copy time of RDLogLine
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef LOG_LINE_TEST_H
+#define LOG_LINE_TEST_H
+
+#include <stdint.h>
+
+#include <vector>
+
+#include <qobject.h>
+#include <qstringlist.h>
+
+#include <rdlog_line.h>
+
+#define LOG_LINE_TEST_USAGE "[options]\n\nFill a synthetic log with lines drawn at random from a catalogue of carts,\nonce with the data members RDLogLine had before its metadata was made\nshared and once with RDLogLine itself, and report heap use per line and\nthe time taken to fill and to copy the log. The contents of the two logs\nare then compared.\n\nOptions are:\n--lines=<num>\n     Number of log lines. Default is 10000.\n\n--carts=<num>\n     Number of distinct carts in the catalogue. Default is 1500.\n\n--log=<name>\n     Also load the named log from the database with RDLogEvent::load()\n     and report its heap use and load and copy times.\n\n--seed=<num>\n     Random number seed.\n\n"
+
+//
+// The data members of RDLogLine before the metadata was split out
+//
+class LegacyLogLine
+{
+ public:
+  bool modified;
+  int log_id;
+  RDLogLine::Status log_status;
+  RDLogLine::State log_state;
+  RDLogLine::Source log_source;
+  RDCart::Validity log_validity;
+  unsigned log_pass;
+  unsigned log_cart_number;
+  QTime log_start_time[5];
+  RDLogLine::TimeType log_time_type;
+  QString log_origin_user;
+  QDateTime log_origin_datetime;
+  RDLogLine::TransType log_trans_type;
+  int log_start_point[2];
+  int log_end_point[2];
+  int log_segue_start_point[2];
+  int log_segue_end_point[2];
+  int log_segue_gain;
+  int log_segue_gain_cut;
+  int log_fadeup_point[2];
+  int log_fadeup_gain;
+  int log_fadedown_point[2];
+  int log_fadedown_gain;
+  int log_duck_up_gain;
+  int log_duck_down_gain;
+  bool log_hook_mode;
+  int log_hook_start;
+  int log_hook_end;
+  RDCart::Type log_cart_type;
+  QString log_group_name;
+  QColor log_group_color;
+  QString log_title;
+  QString log_artist;
+  QString log_album;
+  QString log_publisher;
+  QString log_composer;
+  QString log_isrc;
+  QString log_recording_mbid;
+  QString log_release_mbid;
+  QString log_isci;
+  QDate log_year;
+  QString log_label;
+  QString log_conductor;
+  QString log_song_id;
+  QString log_client;
+  QString log_agency;
+  QString log_outcue;
+  QString log_description;
+  QString log_user_defined;
+  QString log_cart_notes;
+  RDCart::UsageCode log_usage_code;
+  unsigned log_forced_length;
+  unsigned log_cut_quantity;
+  unsigned log_last_cut_played;
+  RDCart::PlayOrder log_play_order;
+  bool log_enforce_length;
+  bool log_preserve_pitch;
+  QDateTime log_start_datetime;
+  QDateTime log_end_datetime;
+  int log_deck;
+  QTime log_play_time;
+  int log_cut_number;
+  int log_effective_length;
+  int log_talk_start;
+  int log_talk_end;
+  int log_talk_length;
+  unsigned log_play_position;
+  RDLogLine::Type log_type;
+  QString log_marker_comment;
+  QString log_marker_label;
+  QTime log_marker_post_time;
+  RDListViewItem *log_listview;
+  QString log_port_name;
+  int log_grace_time;
+  bool log_forced_stop;
+  QObject *log_play_deck;
+  bool log_play_position_changed;
+  bool log_evergreen;
+  QTime log_ext_start_time;
+  int log_ext_length;
+  int log_average_segue_length;
+  QString log_ext_cart_name;
+  QString log_ext_data;
+  QString log_ext_event_id;
+  QString log_ext_annc_type;
+  int log_pause_card;
+  int log_pause_port;
+  bool log_now_next_enabled;
+  RDLogLine::PlaySource log_play_source;
+  RDLogLine::StartSource log_start_source;
+  bool log_zombified;
+  bool log_timescaling_active;
+  bool log_asyncronous;
+  QString log_cut_name;
+  bool log_has_custom_transition;
+  bool log_use_event_length;
+  int log_event_length;
+  QString log_link_event_name;
+  QTime log_link_start_time;
+  int log_link_length;
+  int log_link_start_slop;
+  int log_link_end_slop;
+  int log_link_id;
+  bool log_link_embedded;
+  bool is_holdover;
+};
+
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  void Catalogue(unsigned carts);
+  void FillLegacy(LegacyLogLine *ll,unsigned line,unsigned cart) const;
+  void Fill(RDLogLine *ll,unsigned line,unsigned cart) const;
+  bool Compare(const LegacyLogLine *legacy,const RDLogLine *ll) const;
+  void LoadLog(const QString &logname);
+  QString Value(const QStringList &list,unsigned n) const;
+  static uint64_t HeapUsed();
+  static uint64_t Now();
+  QStringList test_titles;
+  QStringList test_artists;
+  QStringList test_albums;
+  QStringList test_labels;
+  QStringList test_groups;
+  QStringList test_people;
+  QStringList test_clients;
+};
+
+
+#endif  // LOG_LINE_TEST_H
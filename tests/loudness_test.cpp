@@ -0,0 +1,322 @@
+// loudness_test.cpp
+//
+// Compare single-pass and two-pass loudness/peak analysis
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sndfile.h>
+
+#include <qapplication.h>
+
+#include <rdcmd_switch.h>
+#include <rdloudnessmeter.h>
+
+#include "loudness_test.h"
+
+//
+// Maximum difference allowed between the integrated loudness values (LU)
+//
+#define LOUDNESS_TEST_TOLERANCE 0.01
+
+MainObject::MainObject(QObject *parent)
+  : QObject(parent)
+{
+  QString filename;
+  unsigned chunk_size=0;
+  int level=-13;
+  unsigned seed=time(NULL);
+  bool ok=false;
+  std::vector<float> pcm;
+  unsigned chans=2;
+  unsigned samprate=48000;
+  SNDFILE *sf=NULL;
+  SF_INFO sf_info;
+  bool pass=true;
+
+  RDCmdSwitch *cmd=new RDCmdSwitch(qApp->argc(),qApp->argv(),"loudness_test",
+				   LOUDNESS_TEST_USAGE);
+  for(unsigned i=0;i<cmd->keys();i++) {
+    if(cmd->key(i)=="--filename") {
+      filename=cmd->value(i);
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--chunk-size") {
+      chunk_size=cmd->value(i).toUInt(&ok);
+      if((!ok)||(chunk_size==0)) {
+	fprintf(stderr,"loudness_test: invalid --chunk-size\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--level") {
+      level=cmd->value(i).toInt(&ok);
+      if((!ok)||(level>0)) {
+	fprintf(stderr,"loudness_test: invalid --level\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--seed") {
+      seed=cmd->value(i).toUInt(&ok);
+      if(!ok) {
+	fprintf(stderr,"loudness_test: invalid --seed\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(!cmd->processed(i)) {
+      fprintf(stderr,"loudness_test: unrecognized option \"%s\"\n",
+	      cmd->key(i).toUtf8().constData());
+      exit(1);
+    }
+  }
+  srandom(seed);
+
+  //
+  // Load Audio
+  //
+  if(filename.isEmpty()) {
+    Synthesize(&pcm,chans,samprate);
+  }
+  else {
+    memset(&sf_info,0,sizeof(sf_info));
+    if((sf=sf_open(filename.toUtf8(),SFM_READ,&sf_info))==NULL) {
+      fprintf(stderr,"loudness_test: unable to open \"%s\" [%s]\n",
+	      filename.toUtf8().constData(),sf_strerror(NULL));
+      exit(1);
+    }
+    chans=sf_info.channels;
+    samprate=sf_info.samplerate;
+    pcm.resize(sf_info.frames*chans);
+    pcm.resize(sf_readf_float(sf,&pcm[0],sf_info.frames)*chans);
+    sf_close(sf);
+  }
+  printf("%s: %lu frames, %u channels, %u samples/sec\n",
+	 filename.isEmpty()?"synthesized signal":filename.toUtf8().constData(),
+	 pcm.size()/chans,chans,samprate);
+
+  //
+  // Single Pass -- audio passed to the meter in pieces as it arrives
+  //
+  RDLoudnessMeter *meter=new RDLoudnessMeter(chans,samprate);
+  unsigned frames=pcm.size()/chans;
+  unsigned offset=0;
+  unsigned n=0;
+  while(offset<frames) {
+    if(chunk_size>0) {
+      n=chunk_size;
+    }
+    else {
+      n=1+random()%4096;
+    }
+    if((offset+n)>frames) {
+      n=frames-offset;
+    }
+    meter->process(&pcm[offset*chans],n);
+    offset+=n;
+  }
+
+  //
+  // Peak -- must be bit-identical
+  //
+  float ref_peak=ReferencePeak(pcm);
+  printf("  peak sample: two-pass: %.9f  single-pass: %.9f\n",
+	 ref_peak,meter->peakSample());
+  if(meter->peakSample()!=ref_peak) {
+    printf("    FAILED: peak sample mismatch\n");
+    pass=false;
+  }
+
+  //
+  // Normalization Gain -- as calculated by RDAudioConvert::Stage2Convert()
+  //
+  if(ref_peak>0.0) {
+    float ref_gain=(float)level-20.0*log10f(ref_peak);
+    float gain=RDLoudnessMeter::normalizationGain(level,meter->peakSample());
+    printf("  normalization gain: two-pass: %.6f dB  single-pass: %.6f dB\n",
+	   ref_gain,gain);
+    if(gain!=ref_gain) {
+      printf("    FAILED: normalization gain mismatch\n");
+      pass=false;
+    }
+  }
+
+  //
+  // Integrated Loudness -- must be within tolerance
+  //
+  if(samprate==48000) {
+    double ref_lufs=ReferenceLoudness(pcm,chans,samprate);
+    double lufs=meter->integratedLoudness();
+    printf("  integrated loudness: two-pass: %.4f LUFS  ",ref_lufs);
+    printf("single-pass: %.4f LUFS\n",lufs);
+    if(fabs(lufs-ref_lufs)>LOUDNESS_TEST_TOLERANCE) {
+      printf("    FAILED: integrated loudness differs by %.4f LU\n",
+	     fabs(lufs-ref_lufs));
+      pass=false;
+    }
+  }
+  else {
+    printf("  integrated loudness: single-pass: %.4f LUFS ",
+	   meter->integratedLoudness());
+    printf("(no reference at %u samples/sec)\n",samprate);
+  }
+
+  delete meter;
+  if(!pass) {
+    printf("FAILED [seed: %u]\n",seed);
+    exit(1);
+  }
+  printf("PASSED\n");
+  exit(0);
+}
+
+
+void MainObject::Synthesize(std::vector<float> *pcm,unsigned chans,
+			    unsigned samprate) const
+{
+  //
+  // 10 seconds of tone at -20 dBFS, 10 seconds at -35 dBFS then
+  // 3 seconds of silence, so that both gates are exercised.
+  //
+  unsigned loud=10*samprate;
+  unsigned quiet=20*samprate;
+  unsigned frames=23*samprate;
+  double ratio;
+
+  pcm->resize(frames*chans);
+  for(unsigned i=0;i<frames;i++) {
+    if(i<loud) {
+      ratio=pow(10.0,-20.0/20.0);
+    }
+    else {
+      if(i<quiet) {
+	ratio=pow(10.0,-35.0/20.0);
+      }
+      else {
+	ratio=0.0;
+      }
+    }
+    for(unsigned j=0;j<chans;j++) {
+      (*pcm)[i*chans+j]=ratio*sin(2.0*M_PI*(double)(1000/(j+1))*(double)i/
+				  (double)samprate);
+    }
+  }
+}
+
+
+float MainObject::ReferencePeak(const std::vector<float> &pcm) const
+{
+  float peak=0.0;
+
+  //
+  // Same scan as RDAudioConvert::UpdatePeak()
+  //
+  for(unsigned i=0;i<pcm.size();i++) {
+    if(fabsf(pcm[i])>peak) {
+      peak=fabsf(pcm[i]);
+    }
+  }
+  return peak;
+}
+
+
+double MainObject::ReferenceLoudness(const std::vector<float> &pcm,
+				     unsigned chans,unsigned samprate) const
+{
+  //
+  // ITU-R BS.1770-4, using the published 48 kHz filter coefficients
+  // and summing each 400 mS gating block directly.
+  //
+  const double b1[3]={1.53512485958697,-2.69169618940638,1.19839281085285};
+  const double a1[3]={1.0,-1.69065929318241,0.73248077421585};
+  const double b2[3]={1.0,-2.0,1.0};
+  const double a2[3]={1.0,-1.99004745483398,0.99007225036621};
+  unsigned frames=pcm.size()/chans;
+  unsigned block=4*samprate/10;
+  unsigned step=samprate/10;
+  std::vector<double> sq(frames,0.0);
+  std::vector<double> blocks;
+  double sum;
+  unsigned n;
+  double thres;
+
+  for(unsigned j=0;j<chans;j++) {
+    double x[3]={0.0,0.0,0.0};
+    double y[3]={0.0,0.0,0.0};
+    double z[3]={0.0,0.0,0.0};
+    for(unsigned i=0;i<frames;i++) {
+      x[2]=x[1];
+      x[1]=x[0];
+      x[0]=pcm[i*chans+j];
+      y[2]=y[1];
+      y[1]=y[0];
+      y[0]=b1[0]*x[0]+b1[1]*x[1]+b1[2]*x[2]-a1[1]*y[1]-a1[2]*y[2];
+      z[2]=z[1];
+      z[1]=z[0];
+      z[0]=b2[0]*y[0]+b2[1]*y[1]+b2[2]*y[2]-a2[1]*z[1]-a2[2]*z[2];
+      sq[i]+=z[0]*z[0];
+    }
+  }
+  for(unsigned i=0;(i+block)<=frames;i+=step) {
+    sum=0.0;
+    for(unsigned k=i;k<(i+block);k++) {
+      sum+=sq[k];
+    }
+    blocks.push_back(sum/(double)block);
+  }
+
+  thres=pow(10.0,(-70.0+0.691)/10.0);
+  sum=0.0;
+  n=0;
+  for(unsigned i=0;i<blocks.size();i++) {
+    if(blocks[i]>thres) {
+      sum+=blocks[i];
+      n++;
+    }
+  }
+  if(n==0) {
+    return RD_LOUDNESS_SILENCE;
+  }
+  thres=sum/(double)n/10.0;
+  sum=0.0;
+  n=0;
+  for(unsigned i=0;i<blocks.size();i++) {
+    if(blocks[i]>thres) {
+      sum+=blocks[i];
+      n++;
+    }
+  }
+  if(n==0) {
+    return RD_LOUDNESS_SILENCE;
+  }
+
+  return -0.691+10.0*log10(sum/(double)n);
+}
+
+
+int main(int argc,char *argv[])
+{
+  QApplication a(argc,argv,false);
+  new MainObject();
+  return a.exec();
+}
@@ -0,0 +1,44 @@
+// loudness_test.h
+//
+// Compare single-pass and two-pass loudness/peak analysis
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef LOUDNESS_TEST_H
+#define LOUDNESS_TEST_H
+
+#include <vector>
+
+#include <qobject.h>
+
+#define LOUDNESS_TEST_USAGE "[options]\n\nCompare the peak level, normalization gain and integrated loudness\nmeasured by RDLoudnessMeter as audio arrives in pieces with the same\nvalues measured over the complete audio in a second pass.\n\nOptions are:\n--filename=<audio-file>\n     File to process. If not given, a synthesized test signal is used.\n\n--chunk-size=<frames>\n     Number of frames passed to the meter at a time. If not given, random\n     chunk sizes between 1 and 4096 frames are used.\n\n--level=<dbfs>\n     Normalization level. Default is -13.\n\n--seed=<num>\n     Random number seed.\n\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  void Synthesize(std::vector<float> *pcm,unsigned chans,
+		  unsigned samprate) const;
+  float ReferencePeak(const std::vector<float> &pcm) const;
+  double ReferenceLoudness(const std::vector<float> &pcm,unsigned chans,
+			   unsigned samprate) const;
+};
+
+
+#endif  // LOUDNESS_TEST_H
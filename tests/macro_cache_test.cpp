@@ -0,0 +1,367 @@
+// macro_cache_test.cpp
+//
+// Check and benchmark RML parsing and RDMacroCartCache
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <qapplication.h>
+
+#include <rdapplication.h>
+#include <rdcart.h>
+#include <rddb.h>
+#include <rdmacro_event.h>
+#include <rdmacrocartcache.h>
+
+#include "macro_cache_test.h"
+
+MainObject::MainObject(QObject *parent)
+  :QObject(parent)
+{
+  QString err_msg;
+  unsigned cartnum=0;
+  unsigned iterations=10000;
+  unsigned strings=100000;
+  unsigned seed=time(NULL);
+  unsigned errors=0;
+  bool ok=false;
+
+  rda=new RDApplication("macro_cache_test","macro_cache_test",
+			MACRO_CACHE_TEST_USAGE,this);
+  if(!rda->open(&err_msg)) {
+    fprintf(stderr,"macro_cache_test: %s\n",(const char *)err_msg);
+    exit(1);
+  }
+
+  for(unsigned i=0;i<rda->cmdSwitch()->keys();i++) {
+    if(rda->cmdSwitch()->key(i)=="--cart") {
+      cartnum=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if((!ok)||(cartnum==0)||(cartnum>RD_MAX_CART_NUMBER)) {
+	fprintf(stderr,"macro_cache_test: invalid --cart\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--iterations") {
+      iterations=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if((!ok)||(iterations==0)) {
+	fprintf(stderr,"macro_cache_test: invalid --iterations\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--strings") {
+      strings=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if(!ok) {
+	fprintf(stderr,"macro_cache_test: invalid --strings\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--seed") {
+      seed=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if(!ok) {
+	fprintf(stderr,"macro_cache_test: invalid --seed\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(!rda->cmdSwitch()->processed(i)) {
+      fprintf(stderr,"macro_cache_test: unknown command option \"%s\"\n",
+	      (const char *)rda->cmdSwitch()->key(i));
+      exit(2);
+    }
+  }
+  srand(seed);
+  printf("seed: %u\n",seed);
+
+  //
+  // A mix of valid and invalid command names
+  //
+  test_cmds.push_back("EX");
+  test_cmds.push_back("PN");
+  test_cmds.push_back("SP");
+  test_cmds.push_back("GO");
+  test_cmds.push_back("LL");
+  test_cmds.push_back("NN");
+  test_cmds.push_back("ZZ");
+  test_cmds.push_back("ex");
+  test_cmds.push_back("EXX");
+  test_cmds.push_back("E");
+
+  //
+  // Parser
+  //
+  errors+=CompareParsers(strings);
+
+  //
+  // Macro Cart Loads
+  //
+  if(cartnum==0) {
+    QString sql=QString("select ")+
+      "NUMBER "+  // 00
+      "from CART where "+
+      QString().sprintf("TYPE=%d ",RDCart::Macro)+
+      "order by NUMBER limit 1";
+    cartnum=RDSqlQuery::run(sql).toUInt();
+  }
+  if(cartnum==0) {
+    printf("no macro cart found, skipping load benchmark\n");
+  }
+  else {
+    Benchmark(cartnum,iterations);
+  }
+
+  if(errors>0) {
+    printf("FAILED: %u string(s) parsed differently\n",errors);
+    exit(1);
+  }
+  printf("PASSED\n");
+  exit(0);
+}
+
+
+unsigned MainObject::CompareParsers(unsigned strings)
+{
+  unsigned errors=0;
+  QStringList rmls;
+  std::vector<RDMacro> legacy;
+  std::vector<RDMacro> current;
+  bool legacy_ok;
+  bool current_ok;
+  uint64_t start;
+  uint64_t legacy_usecs=0;
+  uint64_t current_usecs=0;
+
+  for(unsigned i=0;i<strings;i++) {
+    rmls.push_back(RandomRml());
+  }
+  for(int i=0;i<rmls.size();i++) {
+    legacy.clear();
+    current.clear();
+    start=Now();
+    legacy_ok=LegacyLoad(&legacy,rmls.at(i));
+    legacy_usecs+=Now()-start;
+    start=Now();
+    current_ok=RDMacro::parseList(&current,rmls.at(i));
+    current_usecs+=Now()-start;
+
+    bool same=(legacy_ok==current_ok)&&(legacy.size()==current.size());
+    for(unsigned j=0;same&&(j<legacy.size());j++) {
+      same=Dump(legacy.at(j))==Dump(current.at(j));
+    }
+    if(!same) {
+      if(errors<10) {
+	printf("  MISMATCH: \"%s\"\n",(const char *)rmls.at(i).toUtf8());
+      }
+      errors++;
+    }
+  }
+  printf("parsed %u strings: original %.3lf sec  current %.3lf sec  "
+	 "%u mismatches\n",strings,(double)legacy_usecs/1000000.0,
+	 (double)current_usecs/1000000.0,errors);
+
+  return errors;
+}
+
+
+void MainObject::Benchmark(unsigned cartnum,unsigned iterations)
+{
+  uint64_t start;
+  double legacy_secs;
+  double db_secs;
+  double cache_secs;
+  std::vector<RDMacro> cmds;
+  RDMacroEvent *event=new RDMacroEvent(NULL,this);
+
+  //
+  // Original path: query and character-by-character parse every time
+  //
+  start=Now();
+  for(unsigned i=0;i<iterations;i++) {
+    QString sql=QString().
+      sprintf("select MACROS from CART where (NUMBER=%d)&&(TYPE=2)",cartnum);
+    RDSqlQuery *q=new RDSqlQuery(sql);
+    if(q->first()) {
+      cmds.clear();
+      LegacyLoad(&cmds,q->value(0).toString());
+    }
+    delete q;
+  }
+  legacy_secs=(double)(Now()-start)/1000000.0;
+
+  //
+  // RDMacroEvent::load() with no cache
+  //
+  start=Now();
+  for(unsigned i=0;i<iterations;i++) {
+    event->clear();
+    event->load(cartnum);
+  }
+  db_secs=(double)(Now()-start)/1000000.0;
+
+  //
+  // RDMacroEvent::load() through the cache
+  //
+  RDMacroCartCache *cache=new RDMacroCartCache(NULL,this);
+  start=Now();
+  for(unsigned i=0;i<iterations;i++) {
+    event->clear();
+    event->load(cartnum);
+  }
+  cache_secs=(double)(Now()-start)/1000000.0;
+
+  printf("cart %06u (%d commands), %u loads:\n",cartnum,event->size(),
+	 iterations);
+  printf("  original:    %10.0lf loads/sec\n",(double)iterations/legacy_secs);
+  printf("  no cache:    %10.0lf loads/sec\n",(double)iterations/db_secs);
+  printf("  cached:      %10.0lf loads/sec  (%u hits, %u misses)\n",
+	 (double)iterations/cache_secs,cache->hits(),cache->misses());
+  delete cache;
+  delete event;
+}
+
+
+QString MainObject::RandomRml() const
+{
+  QString ret;
+  int cmds=rand()%6;
+
+  for(int i=0;i<cmds;i++) {
+    if((rand()%4)==0) {
+      ret+=QString(" \t").mid(rand()%2,1+rand()%2);
+    }
+    ret+=test_cmds.at(rand()%test_cmds.size());
+    int args=rand()%5;
+    for(int j=0;j<args;j++) {
+      switch(rand()%8) {
+      case 0:
+	ret+="  ";
+	break;
+
+      case 1:
+	ret+="\t";
+	break;
+
+      default:
+	ret+=" ";
+	break;
+      }
+      ret+=QString().sprintf("%d",rand()%1000);
+    }
+    if((rand()%5)==0) {
+      ret+=" ";
+    }
+    if((rand()%20)!=0) {
+      ret+="!";
+    }
+  }
+  if((rand()%4)==0) {
+    ret+=" trailing";
+  }
+
+  return ret;
+}
+
+
+bool MainObject::LegacyLoad(std::vector<RDMacro> *cmds,const QString &str)
+{
+  RDMacro cmd;
+  QString rmlstr="";
+
+  //
+  // As in RDMacroEvent::load() before the parsing rework
+  //
+  for(int i=0;i<str.length();i++) {
+    QChar c=str.at(i);
+    rmlstr+=c;
+    if(c=='!') {
+      cmd=LegacyFromString(rmlstr);
+      if(cmd.isNull()) {
+	cmds->clear();
+	return false;
+      }
+      cmds->push_back(cmd);
+      rmlstr="";
+    }
+  }
+  return true;
+}
+
+
+RDMacro MainObject::LegacyFromString(const QString &str)
+{
+  RDMacro ret;
+
+  //
+  // As in RDMacro::fromString() before the parsing rework
+  //
+  ret.setRole(RDMacro::Cmd);
+  QString str2=str.stripWhiteSpace();
+  if(str2.right(1)!="!") {
+    ret.setCommand(RDMacro::NN);
+    return ret;
+  }
+  QStringList f0=str2.left(str2.length()-1).trimmed().split(" ");
+  if(f0[0].length()!=2) {
+    ret.setCommand(RDMacro::NN);
+    return ret;
+  }
+  ret.setCommand(f0[0]);
+  if(ret.isNull()&&(f0[0]!="NN")) {
+    return ret;
+  }
+  for(int i=1;i<f0.size();i++) {
+    ret.addArg(f0[i]);
+  }
+
+  return ret;
+}
+
+
+QString MainObject::Dump(const RDMacro &rml)
+{
+  QString ret=QString().sprintf("%d:%04X:%d",rml.role(),rml.command(),
+				rml.argQuantity());
+
+  for(int i=0;i<rml.argQuantity();i++) {
+    ret+="|"+rml.arg(i);
+  }
+
+  return ret;
+}
+
+
+uint64_t MainObject::Now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return 1000000*(uint64_t)ts.tv_sec+(uint64_t)ts.tv_nsec/1000;
+}
+
+
+int main(int argc,char *argv[])
+{
+  QApplication a(argc,argv,false);
+  new MainObject();
+  return a.exec();
+}
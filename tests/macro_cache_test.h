@@ -0,0 +1,52 @@
+// macro_cache_test.h
+//
+// Check and benchmark RML parsing and RDMacroCartCache
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef MACRO_CACHE_TEST_H
+#define MACRO_CACHE_TEST_H
+
+#include <stdint.h>
+
+#include <vector>
+
+#include <qobject.h>
+#include <qstringlist.h>
+
+#include <rdmacro.h>
+
+#define MACRO_CACHE_TEST_USAGE "[options]\n\nParse random RML strings with both the original and the current RDMacro\nparser, checking that the results are identical, then time loading a macro\ncart through RDMacroEvent::load() the original way (a query and\ncharacter-by-character parse for every load) and through RDMacroCartCache.\n\nOptions are:\n--cart=<num>\n     Macro cart to load. Default is the lowest numbered macro cart.\n\n--iterations=<num>\n     Number of loads to time for each method. Default is 10000.\n\n--strings=<num>\n     Number of random RML strings to compare. Default is 100000.\n\n--seed=<num>\n     Random number seed.\n\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  unsigned CompareParsers(unsigned strings);
+  void Benchmark(unsigned cartnum,unsigned iterations);
+  QString RandomRml() const;
+  static bool LegacyLoad(std::vector<RDMacro> *cmds,const QString &str);
+  static RDMacro LegacyFromString(const QString &str);
+  static QString Dump(const RDMacro &rml);
+  static uint64_t Now();
+  QStringList test_cmds;
+};
+
+
+#endif  // MACRO_CACHE_TEST_H
@@ -0,0 +1,344 @@
+// mix_kernel_test.cpp
+//
+// Check and benchmark the RDMixKernel audio kernels
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__)||defined(__i386__)
+#include <x86intrin.h>
+#define MIX_KERNEL_TEST_TICKS "cycles"
+#else
+#define MIX_KERNEL_TEST_TICKS "nsec"
+#endif  // __x86_64__ || __i386__
+
+#include <qapplication.h>
+
+#include <rdcmd_switch.h>
+
+#include "mix_kernel_test.h"
+
+//
+// Largest relative difference allowed from the scalar kernels where the
+// compiler may have fused the scalar multiply-adds
+//
+#define MIX_KERNEL_TEST_TOLERANCE 1e-6
+
+//
+// Longest buffer compared, in frames
+//
+#define MIX_KERNEL_TEST_MAX_FRAMES 1100
+
+MainObject::MainObject(QObject *parent)
+  : QObject(parent)
+{
+  unsigned trials=1000;
+  unsigned frames=256;
+  unsigned streams=32;
+  unsigned ports=8;
+  unsigned periods=2000;
+  unsigned seed=time(NULL);
+  unsigned errors=0;
+  bool ok=false;
+
+  RDCmdSwitch *cmd=new RDCmdSwitch(qApp->argc(),qApp->argv(),
+				   "mix_kernel_test",MIX_KERNEL_TEST_USAGE);
+  for(unsigned i=0;i<cmd->keys();i++) {
+    if(cmd->key(i)=="--trials") {
+      trials=cmd->value(i).toUInt(&ok);
+      if(!ok) {
+	fprintf(stderr,"mix_kernel_test: invalid --trials\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--frames") {
+      frames=cmd->value(i).toUInt(&ok);
+      if((!ok)||(frames==0)) {
+	fprintf(stderr,"mix_kernel_test: invalid --frames\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--streams") {
+      streams=cmd->value(i).toUInt(&ok);
+      if((!ok)||(streams==0)) {
+	fprintf(stderr,"mix_kernel_test: invalid --streams\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--ports") {
+      ports=cmd->value(i).toUInt(&ok);
+      if((!ok)||(ports==0)) {
+	fprintf(stderr,"mix_kernel_test: invalid --ports\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--periods") {
+      periods=cmd->value(i).toUInt(&ok);
+      if((!ok)||(periods==0)) {
+	fprintf(stderr,"mix_kernel_test: invalid --periods\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--seed") {
+      seed=cmd->value(i).toUInt(&ok);
+      if(!ok) {
+	fprintf(stderr,"mix_kernel_test: invalid --seed\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(!cmd->processed(i)) {
+      fprintf(stderr,"mix_kernel_test: unrecognized option \"%s\"\n",
+	      cmd->key(i).toUtf8().constData());
+      exit(1);
+    }
+  }
+  srandom(seed);
+  printf("seed: %u  default instruction set: %s\n",seed,
+	 RDMixKernel::isaText(RDMixKernel::isa()));
+
+  //
+  // Results -- each vector instruction set against the scalar kernels
+  //
+  test_max_error=0.0;
+  for(int i=RDMixKernel::Sse2;i<=RDMixKernel::Avx2;i++) {
+    RDMixKernel::Isa isa=(RDMixKernel::Isa)i;
+    if(RDMixKernel::isaSupported(isa)) {
+      errors+=Compare(isa,trials);
+    }
+    else {
+      printf("%s: not supported on this CPU, skipped\n",
+	     RDMixKernel::isaText(isa));
+    }
+  }
+  printf("largest relative difference from scalar: %g\n",test_max_error);
+
+  //
+  // Timing
+  //
+  printf("%u streams into %u ports, %u frames per period, %u periods:\n",
+	 streams,ports,frames,periods);
+  for(int i=RDMixKernel::Scalar;i<=RDMixKernel::Avx2;i++) {
+    if(RDMixKernel::isaSupported((RDMixKernel::Isa)i)) {
+      Benchmark((RDMixKernel::Isa)i,frames,streams,ports,periods);
+    }
+  }
+
+  if(errors>0) {
+    printf("FAILED: %u mismatches [seed: %u]\n",errors,seed);
+    exit(1);
+  }
+  printf("PASSED\n");
+  exit(0);
+}
+
+
+unsigned MainObject::Compare(RDMixKernel::Isa isa,unsigned trials)
+{
+  unsigned errors=0;
+  unsigned max=2*MIX_KERNEL_TEST_MAX_FRAMES+8;
+  std::vector<float> in[RD_MIX_KERNEL_MAX_INPUTS+1];
+  std::vector<float> out_init(max);
+  std::vector<float> out[2][9];
+  const float *ins[RD_MIX_KERNEL_MAX_INPUTS+1];
+  float gains[RD_MIX_KERNEL_MAX_INPUTS+1];
+
+  for(unsigned i=0;i<=RD_MIX_KERNEL_MAX_INPUTS;i++) {
+    in[i].resize(max);
+  }
+  for(unsigned i=0;i<trials;i++) {
+    //
+    // Random lengths, gains and misalignments, so that both the vector
+    // loops and the scalar tails are exercised
+    //
+    unsigned frames=random()%MIX_KERNEL_TEST_MAX_FRAMES;
+    unsigned offset=random()%4;
+    unsigned inputs=1+random()%(RD_MIX_KERNEL_MAX_INPUTS+1);
+    float gain=(float)random()/(float)RAND_MAX;
+    for(unsigned j=0;j<=RD_MIX_KERNEL_MAX_INPUTS;j++) {
+      Randomize(&in[j]);
+      ins[j]=&in[j][random()%4];
+      gains[j]=(float)random()/(float)RAND_MAX;
+    }
+    Randomize(&out_init);
+    const float *in1=&in[0][offset];
+    const float *in2=&in[1][offset];
+
+    for(unsigned j=0;j<2;j++) {
+      RDMixKernel::setIsa(j==0?RDMixKernel::Scalar:isa);
+      for(unsigned k=0;k<9;k++) {
+	out[j][k]=out_init;
+      }
+      RDMixKernel::gainCopy(&out[j][0][offset],in1,gain,frames);
+      RDMixKernel::gainSum(&out[j][1][offset],in1,in2,gain,frames);
+      RDMixKernel::gainAccumulate(&out[j][2][offset],in1,gain,frames);
+      RDMixKernel::mix(&out[j][3][offset],ins,gains,inputs,frames);
+      RDMixKernel::interleave(&out[j][4][offset],in1,in2,gain,1.0-gain,
+			      frames);
+      RDMixKernel::deinterleaveAccumulate(&out[j][5][offset],
+					  &out[j][5][max/2],in1,gain,frames);
+      out[j][6][0]=RDMixKernel::peak(in1,frames);
+      RDMixKernel::peakInterleaved(&out[j][7][0],&out[j][7][1],in1,frames);
+      out[j][8][0]=RDMixKernel::maximum(in1,frames);
+    }
+    errors+=Check("gainCopy",out[0][0],out[1][0],true);
+    errors+=Check("gainSum",out[0][1],out[1][1],true);
+    errors+=Check("gainAccumulate",out[0][2],out[1][2],false);
+    errors+=Check("mix",out[0][3],out[1][3],false);
+    errors+=Check("interleave",out[0][4],out[1][4],true);
+    errors+=Check("deinterleaveAccumulate",out[0][5],out[1][5],false);
+    errors+=Check("peak",out[0][6],out[1][6],true);
+    errors+=Check("peakInterleaved",out[0][7],out[1][7],true);
+    errors+=Check("maximum",out[0][8],out[1][8],true);
+  }
+  RDMixKernel::setIsa(isa);
+  printf("%s: %u trials, %u mismatches\n",RDMixKernel::isaText(isa),trials,
+	 errors);
+
+  return errors;
+}
+
+
+unsigned MainObject::Check(const char *kernel,const std::vector<float> &ref,
+			   const std::vector<float> &vec,bool exact)
+{
+  unsigned errors=0;
+  float diff;
+
+  for(unsigned i=0;i<ref.size();i++) {
+    if(exact) {
+      if(memcmp(&ref[i],&vec[i],sizeof(float))==0) {
+	continue;
+      }
+    }
+    else {
+      diff=fabsf(ref[i]-vec[i])/fmaxf(1.0,fabsf(ref[i]));
+      if(diff>test_max_error) {
+	test_max_error=diff;
+      }
+      if(diff<=MIX_KERNEL_TEST_TOLERANCE) {
+	continue;
+      }
+    }
+    if(errors==0) {
+      printf("  %s: %s: sample %u is %.9g, scalar gives %.9g\n",
+	     RDMixKernel::isaText(RDMixKernel::isa()),kernel,i,vec[i],ref[i]);
+    }
+    errors++;
+  }
+
+  return errors;
+}
+
+
+void MainObject::Benchmark(RDMixKernel::Isa isa,unsigned frames,
+			   unsigned streams,unsigned ports,unsigned periods)
+{
+  std::vector<float> stream_bufs(streams*2*frames);
+  std::vector<float> input_bufs(ports*2*frames);
+  std::vector<float> output_bufs(ports*2*frames);
+  std::vector<float> record_buf(2*frames);
+  std::vector<const float *> pass_ins(ports);
+  std::vector<float> pass_gains(ports,0.5);
+  float meters[2];
+  uint64_t start;
+  uint64_t stream_ticks=0;
+  uint64_t period_ticks=0;
+
+  RDMixKernel::setIsa(isa);
+  Randomize(&stream_bufs);
+  Randomize(&input_bufs);
+
+  //
+  // Each output is fed by two inputs and streams are spread evenly
+  // across the outputs, as in JackProcess()
+  //
+  for(unsigned i=0;i<periods;i++) {
+    start=Ticks();
+    memset(&output_bufs[0],0,output_bufs.size()*sizeof(float));
+    for(unsigned j=0;j<ports;j++) {
+      for(unsigned k=0;k<2;k++) {
+	pass_ins[0]=&input_bufs[(2*j+k)*frames];
+	pass_ins[1]=&input_bufs[(2*((j+1)%ports)+k)*frames];
+	RDMixKernel::mix(&output_bufs[(2*j+k)*frames],&pass_ins[0],
+			 &pass_gains[0],ports>1?2:1,frames);
+      }
+      RDMixKernel::interleave(&record_buf[0],&input_bufs[2*j*frames],
+			      &input_bufs[(2*j+1)*frames],0.9,0.9,frames);
+    }
+    uint64_t stream_start=Ticks();
+    for(unsigned j=0;j<streams;j++) {
+      const float *pcm=&stream_bufs[j*2*frames];
+      unsigned port=j%ports;
+      RDMixKernel::peakInterleaved(meters,meters+1,pcm,frames);
+      RDMixKernel::deinterleaveAccumulate(&output_bufs[2*port*frames],
+					  &output_bufs[(2*port+1)*frames],
+					  pcm,0.7,frames);
+    }
+    stream_ticks+=Ticks()-stream_start;
+    for(unsigned j=0;j<2*ports;j++) {
+      meters[0]=RDMixKernel::maximum(&input_bufs[j*frames],frames);
+      meters[1]=RDMixKernel::maximum(&output_bufs[j*frames],frames);
+    }
+    period_ticks+=Ticks()-start;
+  }
+  printf("  %-6s  streams: %7.3f %s/frame/stream  period: %7.3f %s/frame\n",
+	 RDMixKernel::isaText(isa),
+	 (double)stream_ticks/((double)periods*frames*streams),
+	 MIX_KERNEL_TEST_TICKS,
+	 (double)period_ticks/((double)periods*frames),MIX_KERNEL_TEST_TICKS);
+}
+
+
+void MainObject::Randomize(std::vector<float> *data) const
+{
+  for(unsigned i=0;i<data->size();i++) {
+    data->at(i)=2.0*(float)random()/(float)RAND_MAX-1.0;
+  }
+}
+
+
+uint64_t MainObject::Ticks()
+{
+#if defined(__x86_64__)||defined(__i386__)
+  return __rdtsc();
+#else
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return 1000000000*(uint64_t)ts.tv_sec+(uint64_t)ts.tv_nsec;
+#endif  // __x86_64__ || __i386__
+}
+
+
+int main(int argc,char *argv[])
+{
+  QApplication a(argc,argv,false);
+  new MainObject();
+  return a.exec();
+}
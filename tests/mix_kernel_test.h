@@ -0,0 +1,51 @@
+// mix_kernel_test.h
+//
+// Check and benchmark the RDMixKernel audio kernels
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef MIX_KERNEL_TEST_H
+#define MIX_KERNEL_TEST_H
+
+#include <stdint.h>
+
+#include <vector>
+
+#include <qobject.h>
+
+#include <rdmixkernel.h>
+
+#define MIX_KERNEL_TEST_USAGE "[options]\n\nCompare the results of each vectorized RDMixKernel instruction set supported\nby this CPU with those of the scalar kernels, then time a simulated JACK\nprocess callback with each of them. Does not require a running Rivendell\nsystem.\n\nOptions are:\n--trials=<num>\n     Number of random buffers compared for each kernel. Default is 1000.\n\n--frames=<num>\n     Frames per simulated JACK period. Default is 256.\n\n--streams=<num>\n     Number of stereo play streams mixed in each period. Default is 32.\n\n--ports=<num>\n     Number of stereo output ports. Default is 8.\n\n--periods=<num>\n     Number of periods timed for each instruction set. Default is 2000.\n\n--seed=<num>\n     Random number seed.\n\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  unsigned Compare(RDMixKernel::Isa isa,unsigned trials);
+  unsigned Check(const char *kernel,const std::vector<float> &ref,
+		 const std::vector<float> &vec,bool exact);
+  void Benchmark(RDMixKernel::Isa isa,unsigned frames,unsigned streams,
+		 unsigned ports,unsigned periods);
+  void Randomize(std::vector<float> *data) const;
+  static uint64_t Ticks();
+  float test_max_error;
+};
+
+
+#endif  // MIX_KERNEL_TEST_H
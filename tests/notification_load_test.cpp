@@ -0,0 +1,281 @@
+// notification_load_test.cpp
+//
+// Measure notification traffic and refresh rates during a bulk change
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <QApplication>
+
+#include <rdapplication.h>
+
+#include "notification_load_test.h"
+
+MainObject::MainObject(QObject *parent)
+  :QObject(parent)
+{
+  QString err_msg;
+  bool ok=false;
+
+  test_carts=5000;
+  test_first_cart=990000;
+  test_rate=100;
+  test_window=-1;
+  test_sent=0;
+  test_text_msgs=0;
+  test_binary_msgs=0;
+  test_single_signals=0;
+  test_batch_signals=0;
+
+  rda=new RDApplication("notification_load_test","notification_load_test",
+			NOTIFICATION_LOAD_TEST_USAGE,this);
+  if(!rda->open(&err_msg)) {
+    fprintf(stderr,"notification_load_test: %s\n",(const char *)err_msg);
+    exit(1);
+  }
+
+  for(unsigned i=0;i<rda->cmdSwitch()->keys();i++) {
+    if(rda->cmdSwitch()->key(i)=="--carts") {
+      test_carts=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if((!ok)||(test_carts==0)) {
+	fprintf(stderr,"notification_load_test: invalid --carts\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--first-cart") {
+      test_first_cart=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if((!ok)||(test_first_cart==0)) {
+	fprintf(stderr,"notification_load_test: invalid --first-cart\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--rate") {
+      test_rate=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if(!ok) {
+	fprintf(stderr,"notification_load_test: invalid --rate\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--window") {
+      test_window=rda->cmdSwitch()->value(i).toInt(&ok);
+      if((!ok)||(test_window<0)) {
+	fprintf(stderr,"notification_load_test: invalid --window\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(!rda->cmdSwitch()->processed(i)) {
+      fprintf(stderr,
+	      "notification_load_test: unknown command option \"%s\"\n",
+	      (const char *)rda->cmdSwitch()->key(i));
+      exit(2);
+    }
+  }
+  if((test_first_cart+test_carts-1)>RD_MAX_CART_NUMBER) {
+    fprintf(stderr,"notification_load_test: cart range is too large\n");
+    exit(1);
+  }
+  if(test_window<0) {
+    test_window=rda->config()->notificationWindow();
+  }
+
+  //
+  // Sender
+  //
+  rda->ripc()->setNotificationWindow(test_window);
+  rda->ripc()->
+    connectHost("localhost",RIPCD_TCP_PORT,rda->config()->password());
+
+  //
+  // RDRipc Listener
+  //
+  test_receiver=new RDRipc(rda->station(),rda->config(),this);
+  test_receiver->setNotificationWindow(test_window);
+  connect(test_receiver,SIGNAL(notificationReceived(RDNotification *)),
+	  this,SLOT(notificationReceivedData(RDNotification *)));
+  connect(test_receiver,SIGNAL(notificationBatchReceived(RDNotification *)),
+	  this,SLOT(notificationBatchReceivedData(RDNotification *)));
+  test_receiver->
+    connectHost("localhost",RIPCD_TCP_PORT,rda->config()->password());
+
+  //
+  // Raw Listeners
+  //
+  test_text_socket=new QTcpSocket(this);
+  connect(test_text_socket,SIGNAL(readyRead()),this,SLOT(textReadyData()));
+  test_text_socket->connectToHost("localhost",RIPCD_TCP_PORT);
+  test_text_socket->write(("PW "+rda->config()->password()+"!").toUtf8());
+
+  test_binary_socket=new QTcpSocket(this);
+  connect(test_binary_socket,SIGNAL(readyRead()),
+	  this,SLOT(binaryReadyData()));
+  test_binary_socket->connectToHost("localhost",RIPCD_TCP_PORT);
+  test_binary_socket->write(("PW "+rda->config()->password()+"!"+
+	    QString().sprintf("NV %d!",RD_NOTIFICATION_BINARY_VERSION)).
+			    toUtf8());
+
+  test_send_timer=new QTimer(this);
+  connect(test_send_timer,SIGNAL(timeout()),this,SLOT(sendData()));
+
+  QTimer::singleShot(RIPC_START_DELAY,this,SLOT(startData()));
+}
+
+
+void MainObject::startData()
+{
+  printf("sending %u cart notifications",test_carts);
+  if(test_rate>0) {
+    printf(" at %u/sec",test_rate);
+  }
+  printf(", %d mS window\n",test_window);
+  test_start_datetime=QDateTime::currentDateTime();
+  if(test_rate==0) {
+    while(test_sent<test_carts) {
+      sendData();
+    }
+  }
+  else {
+    test_send_timer->start(1000/test_rate);
+  }
+}
+
+
+void MainObject::sendData()
+{
+  if(test_sent>=test_carts) {
+    return;
+  }
+  rda->ripc()->sendNotification(RDNotification::CartType,
+				RDNotification::ModifyAction,
+				QVariant(test_first_cart+test_sent));
+  if(++test_sent==test_carts) {
+    test_send_timer->stop();
+    test_end_datetime=QDateTime::currentDateTime();
+    QTimer::singleShot(2*test_window+2000,this,SLOT(finishData()));
+  }
+}
+
+
+void MainObject::finishData()
+{
+  unsigned errors=0;
+  double secs=(double)test_start_datetime.msecsTo(test_end_datetime)/1000.0;
+
+  if(secs<0.001) {
+    secs=0.001;
+  }
+  printf("sent %u notifications in %.1lf sec\n",test_sent,secs);
+  printf("  text listener:    %6u messages  %8.1lf/sec  %u carts\n",
+	 test_text_msgs,(double)test_text_msgs/secs,
+	 (unsigned)test_text_ids.size());
+  printf("  binary listener:  %6u messages  %8.1lf/sec  %u carts\n",
+	 test_binary_msgs,(double)test_binary_msgs/secs,
+	 (unsigned)test_binary_ids.size());
+  printf("  RDRipc listener:  %6u per-cart signals\n",test_single_signals);
+  printf("                    %6u refreshes  %8.1lf/sec  %u carts\n",
+	 test_batch_signals,(double)test_batch_signals/secs,
+	 (unsigned)test_batch_ids.size());
+
+  if(test_text_ids.size()!=test_carts) {
+    printf("FAILED: text listener missed %u cart(s)\n",
+	   test_carts-(unsigned)test_text_ids.size());
+    errors++;
+  }
+  if(test_binary_ids.size()!=test_carts) {
+    printf("FAILED: binary listener missed %u cart(s)\n",
+	   test_carts-(unsigned)test_binary_ids.size());
+    errors++;
+  }
+  if(test_batch_ids.size()!=test_carts) {
+    printf("FAILED: RDRipc listener missed %u cart(s)\n",
+	   test_carts-(unsigned)test_batch_ids.size());
+    errors++;
+  }
+  if(errors>0) {
+    exit(1);
+  }
+  printf("PASSED\n");
+  exit(0);
+}
+
+
+void MainObject::textReadyData()
+{
+  ReadSocket(test_text_socket,&test_text_accum,&test_text_msgs,
+	     &test_text_ids);
+}
+
+
+void MainObject::binaryReadyData()
+{
+  ReadSocket(test_binary_socket,&test_binary_accum,&test_binary_msgs,
+	     &test_binary_ids);
+}
+
+
+void MainObject::notificationReceivedData(RDNotification *notify)
+{
+  test_single_signals++;
+}
+
+
+void MainObject::notificationBatchReceivedData(RDNotification *notify)
+{
+  if(notify->type()==RDNotification::CartType) {
+    test_batch_signals++;
+    for(int i=0;i<notify->idQuantity();i++) {
+      test_batch_ids.insert(notify->id(i).toUInt());
+    }
+  }
+}
+
+
+void MainObject::ReadSocket(QTcpSocket *sock,QString *accum,unsigned *msgs,
+			    std::set<unsigned> *ids)
+{
+  RDNotification notify;
+  QString data=QString::fromUtf8(sock->readAll());
+
+  for(int i=0;i<data.length();i++) {
+    if(data.at(i)=='!') {
+      if(accum->startsWith("ON ")&&notify.read(accum->mid(3))&&
+	 (notify.type()==RDNotification::CartType)) {
+	(*msgs)++;
+	for(int j=0;j<notify.idQuantity();j++) {
+	  ids->insert(notify.id(j).toUInt());
+	}
+      }
+      *accum="";
+    }
+    else {
+      *accum+=data.at(i);
+    }
+  }
+}
+
+
+int main(int argc,char *argv[])
+{
+  QApplication a(argc,argv,false);
+  new MainObject();
+  return a.exec();
+}
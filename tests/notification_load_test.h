@@ -0,0 +1,76 @@
+// notification_load_test.h
+//
+// Measure notification traffic and refresh rates during a bulk change
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef NOTIFICATION_LOAD_TEST_H
+#define NOTIFICATION_LOAD_TEST_H
+
+#include <set>
+
+#include <QDateTime>
+#include <QObject>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include <rdripc.h>
+
+#define NOTIFICATION_LOAD_TEST_USAGE "[options]\n\nSend a burst of cart notifications through ripcd(8), as a bulk import\nwould, and report how many messages and refreshes they cause for a\nlistener using the text encoding, a listener using the binary encoding\nand an RDRipc client.\n\nOptions are:\n--carts=<num>\n     Number of cart notifications to send. Default is 5000.\n\n--first-cart=<num>\n     Number of the first cart to report. Default is 990000.\n\n--rate=<num>\n     Notifications sent per second, '0' for as fast as possible.\n     Default is 100.\n\n--window=<msecs>\n     Coalescing window to use in place of the 'NotificationWindow='\n     value in rd.conf(5).\n\n"
+
+class MainObject : public QObject
+{
+  Q_OBJECT
+ public:
+  MainObject(QObject *parent=0);
+
+ private slots:
+  void startData();
+  void sendData();
+  void finishData();
+  void textReadyData();
+  void binaryReadyData();
+  void notificationReceivedData(RDNotification *notify);
+  void notificationBatchReceivedData(RDNotification *notify);
+
+ private:
+  void ReadSocket(QTcpSocket *sock,QString *accum,unsigned *msgs,
+		  std::set<unsigned> *ids);
+  RDRipc *test_receiver;
+  QTcpSocket *test_text_socket;
+  QTcpSocket *test_binary_socket;
+  QString test_text_accum;
+  QString test_binary_accum;
+  QTimer *test_send_timer;
+  QDateTime test_start_datetime;
+  QDateTime test_end_datetime;
+  unsigned test_carts;
+  unsigned test_first_cart;
+  unsigned test_rate;
+  int test_window;
+  unsigned test_sent;
+  unsigned test_text_msgs;
+  unsigned test_binary_msgs;
+  unsigned test_single_signals;
+  unsigned test_batch_signals;
+  std::set<unsigned> test_text_ids;
+  std::set<unsigned> test_binary_ids;
+  std::set<unsigned> test_batch_ids;
+};
+
+
+#endif  // NOTIFICATION_LOAD_TEST_H
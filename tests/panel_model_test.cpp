@@ -0,0 +1,356 @@
+// panel_model_test.cpp
+//
+// Check and benchmark RDPanelModel
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <qapplication.h>
+
+#include <rdapplication.h>
+#include <rdbutton_panel.h>
+#include <rddb.h>
+#include <rdescape_string.h>
+
+#include "panel_model_test.h"
+
+MainObject::MainObject(QObject *parent)
+  :QObject(parent)
+{
+  QString err_msg;
+  bool ok=false;
+  unsigned errors=0;
+  unsigned rows=0;
+  uint64_t start;
+  double legacy_insert_secs;
+  double legacy_update_secs;
+  double legacy_load_secs;
+  double model_insert_secs;
+  double model_update_secs;
+  double model_load_secs;
+
+  test_tablename="PANELS";
+  test_panels=20;
+  test_rows=5;
+  test_columns=12;
+
+  rda=new RDApplication("panel_model_test","panel_model_test",
+			PANEL_MODEL_TEST_USAGE,this);
+  if(!rda->open(&err_msg)) {
+    fprintf(stderr,"panel_model_test: %s\n",(const char *)err_msg);
+    exit(1);
+  }
+
+  for(unsigned i=0;i<rda->cmdSwitch()->keys();i++) {
+    if(rda->cmdSwitch()->key(i)=="--panels") {
+      test_panels=rda->cmdSwitch()->value(i).toInt(&ok);
+      if((!ok)||(test_panels<=0)) {
+	fprintf(stderr,"panel_model_test: invalid --panels\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--rows") {
+      test_rows=rda->cmdSwitch()->value(i).toInt(&ok);
+      if((!ok)||(test_rows<=0)||(test_rows>PANEL_MAX_BUTTON_ROWS)) {
+	fprintf(stderr,"panel_model_test: invalid --rows\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--columns") {
+      test_columns=rda->cmdSwitch()->value(i).toInt(&ok);
+      if((!ok)||(test_columns<=0)||(test_columns>PANEL_MAX_BUTTON_COLUMNS)) {
+	fprintf(stderr,"panel_model_test: invalid --columns\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--extended") {
+      test_tablename="EXTENDED_PANELS";
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(!rda->cmdSwitch()->processed(i)) {
+      fprintf(stderr,"panel_model_test: unknown command option \"%s\"\n",
+	      (const char *)rda->cmdSwitch()->key(i));
+      exit(2);
+    }
+  }
+  test_owner=QString().sprintf("panel_model_test-%d",getpid());
+  Clean();
+
+  //
+  // Original path: a lookup and an insert or update for every button,
+  // and a query for every panel
+  //
+  start=Now();
+  for(int i=0;i<test_panels;i++) {
+    for(int j=0;j<test_rows;j++) {
+      for(int k=0;k<test_columns;k++) {
+	LegacySave(i,j,k,Label(i,j,k,0),Cart(i,j,k),Color(i,j,k,0));
+      }
+    }
+  }
+  legacy_insert_secs=(double)(Now()-start)/1000000.0;
+  start=Now();
+  for(int i=0;i<test_panels;i++) {
+    for(int j=0;j<test_rows;j++) {
+      for(int k=0;k<test_columns;k++) {
+	LegacySave(i,j,k,Label(i,j,k,1),Cart(i,j,k),Color(i,j,k,1));
+      }
+    }
+  }
+  legacy_update_secs=(double)(Now()-start)/1000000.0;
+  start=Now();
+  for(int i=0;i<test_panels;i++) {
+    rows+=LegacyLoad(i);
+  }
+  legacy_load_secs=(double)(Now()-start)/1000000.0;
+  if(rows!=(unsigned)(test_panels*test_rows*test_columns)) {
+    printf("  original path loaded %u buttons\n",rows);
+    errors++;
+  }
+  Clean();
+
+  //
+  // RDPanelModel
+  //
+  RDPanelModel *model=
+    new RDPanelModel(test_tablename,RDAirPlayConf::UserPanel,test_owner);
+  start=Now();
+  for(int i=0;i<test_panels;i++) {
+    for(int j=0;j<test_rows;j++) {
+      for(int k=0;k<test_columns;k++) {
+	model->setButton(i,j,k,Label(i,j,k,0),Cart(i,j,k),Color(i,j,k,0));
+      }
+    }
+  }
+  if(!model->save(&err_msg)) {
+    printf("  save failed [%s]\n",(const char *)err_msg.toUtf8());
+    errors++;
+  }
+  model_insert_secs=(double)(Now()-start)/1000000.0;
+  if(model->pending()!=0) {
+    printf("  %d buttons still pending after save\n",model->pending());
+    errors++;
+  }
+  start=Now();
+  for(int i=0;i<test_panels;i++) {
+    for(int j=0;j<test_rows;j++) {
+      for(int k=0;k<test_columns;k++) {
+	model->setButton(i,j,k,Label(i,j,k,1),Cart(i,j,k),Color(i,j,k,1));
+      }
+    }
+  }
+  if(!model->save(&err_msg)) {
+    printf("  save failed [%s]\n",(const char *)err_msg.toUtf8());
+    errors++;
+  }
+  model_update_secs=(double)(Now()-start)/1000000.0;
+  delete model;
+
+  model=new RDPanelModel(test_tablename,RDAirPlayConf::UserPanel,test_owner);
+  start=Now();
+  model->load();
+  model_load_secs=(double)(Now()-start)/1000000.0;
+  errors+=Verify(model,1);
+
+  //
+  // Reloading a single panel keeps edits not yet saved
+  //
+  model->setButton(0,0,0,"pending",0,"#000000");
+  model->load(0);
+  if(model->label(0,0,0)!="pending") {
+    printf("  reload discarded a pending edit\n");
+    errors++;
+  }
+  delete model;
+
+  //
+  // Every button is stored exactly once
+  //
+  QString sql=QString("select ")+
+    "count(*) "+  // 00
+    "from "+test_tablename+" where "+
+    QString().sprintf("TYPE=%d && ",RDAirPlayConf::UserPanel)+
+    "OWNER=\""+RDEscapeString(test_owner)+"\"";
+  rows=RDSqlQuery::run(sql).toUInt();
+  if(rows!=(unsigned)(test_panels*test_rows*test_columns)) {
+    printf("  %u rows stored\n",rows);
+    errors++;
+  }
+  Clean();
+
+  printf("%d panels of %dx%d buttons:\n",test_panels,test_rows,test_columns);
+  printf("  insert:  original %.3lf sec  model %.3lf sec\n",
+	 legacy_insert_secs,model_insert_secs);
+  printf("  update:  original %.3lf sec  model %.3lf sec\n",
+	 legacy_update_secs,model_update_secs);
+  printf("  load:    original %.3lf sec  model %.3lf sec\n",
+	 legacy_load_secs,model_load_secs);
+
+  if(errors>0) {
+    printf("FAILED: %u error(s)\n",errors);
+    exit(1);
+  }
+  printf("PASSED\n");
+  exit(0);
+}
+
+
+void MainObject::LegacySave(int panel,int row,int col,const QString &label,
+			    unsigned cartnum,const QString &color)
+{
+  //
+  // As in RDSoundPanel::SaveButton() before RDPanelModel
+  //
+  QString sql=QString("select LABEL from ")+test_tablename+" where "+
+    QString().sprintf("TYPE=%d && ",RDAirPlayConf::UserPanel)+
+    "OWNER=\""+RDEscapeString(test_owner)+"\" && "+
+    QString().sprintf("PANEL_NO=%d && ",panel)+
+    QString().sprintf("ROW_NO=%d && ",row)+
+    QString().sprintf("COLUMN_NO=%d",col);
+  RDSqlQuery *q=new RDSqlQuery(sql);
+  if(q->size()>0) {
+    sql=QString("update ")+test_tablename+" set "+
+      "LABEL=\""+RDEscapeString(label)+"\","+
+      QString().sprintf("CART=%u,",cartnum)+
+      "DEFAULT_COLOR=\""+RDEscapeString(color)+"\" where "+
+      QString().sprintf("(TYPE=%d)&&",RDAirPlayConf::UserPanel)+
+      "(OWNER=\""+RDEscapeString(test_owner)+"\")&&"+
+      QString().sprintf("(PANEL_NO=%d)&&",panel)+
+      QString().sprintf("(ROW_NO=%d)&&",row)+
+      QString().sprintf("(COLUMN_NO=%d)",col);
+  }
+  else {
+    sql=QString("insert into ")+test_tablename+
+      " (TYPE,OWNER,PANEL_NO,ROW_NO,COLUMN_NO,LABEL,CART,DEFAULT_COLOR) "+
+      QString().sprintf("values (%d,",RDAirPlayConf::UserPanel)+
+      "\""+RDEscapeString(test_owner)+"\","+
+      QString().sprintf("%d,%d,%d,",panel,row,col)+
+      "\""+RDEscapeString(label)+"\","+
+      QString().sprintf("%u,",cartnum)+
+      "\""+RDEscapeString(color)+"\")";
+  }
+  delete q;
+  RDSqlQuery::apply(sql);
+}
+
+
+unsigned MainObject::LegacyLoad(int panel)
+{
+  unsigned ret=0;
+
+  //
+  // As in RDSoundPanel::LoadPanel() before RDPanelModel
+  //
+  QString sql=QString("select ")+test_tablename+".ROW_NO,"+
+    test_tablename+".COLUMN_NO,"+
+    test_tablename+".LABEL,"+
+    test_tablename+".CART,"+
+    test_tablename+".DEFAULT_COLOR,"+
+    "CART.FORCED_LENGTH,CART.AVERAGE_HOOK_LENGTH,CART.TYPE from "+
+    test_tablename+" left join CART on "+test_tablename+".CART=CART.NUMBER "+
+    "where "+test_tablename+
+    QString().sprintf(".TYPE=%d && ",RDAirPlayConf::UserPanel)+
+    test_tablename+".OWNER=\""+RDEscapeString(test_owner)+"\" && "+
+    test_tablename+QString().sprintf(".PANEL_NO=%d ",panel)+
+    "order by "+test_tablename+".COLUMN_NO,"+test_tablename+".ROW_NO";
+  RDSqlQuery *q=new RDSqlQuery(sql);
+  while(q->next()) {
+    ret++;
+  }
+  delete q;
+
+  return ret;
+}
+
+
+unsigned MainObject::Verify(RDPanelModel *model,int pass)
+{
+  unsigned ret=0;
+
+  for(int i=0;i<test_panels;i++) {
+    for(int j=0;j<test_rows;j++) {
+      for(int k=0;k<test_columns;k++) {
+	if((!model->exists(i,j,k))||
+	   (model->label(i,j,k)!=Label(i,j,k,pass))||
+	   (model->cart(i,j,k)!=Cart(i,j,k))||
+	   (model->defaultColor(i,j,k)!=Color(i,j,k,pass))) {
+	  if(ret<10) {
+	    printf("  MISMATCH: panel %d, row %d, column %d\n",i,j,k);
+	  }
+	  ret++;
+	}
+      }
+    }
+  }
+  if(model->exists(test_panels,0,0)) {
+    printf("  button loaded for a panel that was never written\n");
+    ret++;
+  }
+
+  return ret;
+}
+
+
+QString MainObject::Label(int panel,int row,int col,int pass) const
+{
+  return QString().sprintf("Button \"%d\" %d:%d:%d",pass,panel,row,col);
+}
+
+
+unsigned MainObject::Cart(int panel,int row,int col) const
+{
+  return 1+(panel*test_rows+row)*test_columns+col;
+}
+
+
+QString MainObject::Color(int panel,int row,int col,int pass) const
+{
+  return QString().sprintf("#%02x%02x%02x",(panel*16+pass)%256,row*8,col*8);
+}
+
+
+void MainObject::Clean()
+{
+  QString sql=QString("delete from ")+test_tablename+" where "+
+    "OWNER=\""+RDEscapeString(test_owner)+"\"";
+  RDSqlQuery::apply(sql);
+}
+
+
+uint64_t MainObject::Now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return 1000000*(uint64_t)ts.tv_sec+(uint64_t)ts.tv_nsec/1000;
+}
+
+
+int main(int argc,char *argv[])
+{
+  QApplication a(argc,argv,false);
+  new MainObject();
+  return a.exec();
+}
@@ -0,0 +1,55 @@
+// panel_model_test.h
+//
+// Check and benchmark RDPanelModel
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef PANEL_MODEL_TEST_H
+#define PANEL_MODEL_TEST_H
+
+#include <stdint.h>
+
+#include <qobject.h>
+
+#include <rdpanelmodel.h>
+
+#define PANEL_MODEL_TEST_USAGE "[options]\n\nWrite and read back a set of sound panel buttons belonging to a scratch\nowner, first one button and one panel at a time as RDSoundPanel used to\nand then through RDPanelModel, checking that both give the same contents\nand timing each. The scratch rows are removed afterwards.\n\nOptions are:\n--panels=<num>\n     Number of panels to write. Default is 20.\n\n--rows=<num>\n     Number of button rows per panel. Default is 5.\n\n--columns=<num>\n     Number of button columns per panel. Default is 12.\n\n--extended\n     Use the EXTENDED_PANELS table rather than PANELS.\n\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  void LegacySave(int panel,int row,int col,const QString &label,
+		  unsigned cartnum,const QString &color);
+  unsigned LegacyLoad(int panel);
+  unsigned Verify(RDPanelModel *model,int pass);
+  QString Label(int panel,int row,int col,int pass) const;
+  unsigned Cart(int panel,int row,int col) const;
+  QString Color(int panel,int row,int col,int pass) const;
+  void Clean();
+  static uint64_t Now();
+  QString test_tablename;
+  QString test_owner;
+  int test_panels;
+  int test_rows;
+  int test_columns;
+};
+
+
+#endif  // PANEL_MODEL_TEST_H
@@ -0,0 +1,642 @@
+// play_marker_test.cpp
+//
+// Check when RDPlayDeck reports segue points against the audio clock
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+
+#include <qapplication.h>
+#include <qdatetime.h>
+#include <qeventloop.h>
+
+#include <rdapplication.h>
+#include <rdcut.h>
+#include <rddb.h>
+
+#include "play_marker_test.h"
+
+MainObject::MainObject(QObject *parent)
+  :QObject(parent)
+{
+  QString err_msg;
+  QString cutname;
+  unsigned trials=5;
+  unsigned period=0;
+  bool fake_cae=false;
+  bool ok=false;
+  int max_delay;
+  int delay;
+
+  test_deck=NULL;
+  test_card=0;
+  test_segue=5000;
+  test_load=20;
+  test_pending=0;
+  test_finished=false;
+
+  rda=new RDApplication("play_marker_test","play_marker_test",
+			PLAY_MARKER_TEST_USAGE,this);
+  if(!rda->open(&err_msg)) {
+    fprintf(stderr,"play_marker_test: %s\n",(const char *)err_msg);
+    exit(1);
+  }
+  period=rda->config()->alsaPeriodSize();
+
+  for(unsigned i=0;i<rda->cmdSwitch()->keys();i++) {
+    if(rda->cmdSwitch()->key(i)=="--cut") {
+      unsigned cartnum=RDCut::cartNumber(rda->cmdSwitch()->value(i));
+      unsigned cutnum=RDCut::cutNumber(rda->cmdSwitch()->value(i));
+      if((cartnum==0)||(cartnum>RD_MAX_CART_NUMBER)||(cutnum==0)) {
+	fprintf(stderr,"play_marker_test: invalid --cut\n");
+	exit(1);
+      }
+      cutname=RDCut::cutName(cartnum,cutnum);
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--card") {
+      test_card=rda->cmdSwitch()->value(i).toInt(&ok);
+      if((!ok)||(test_card<0)||(test_card>=RD_MAX_CARDS)) {
+	fprintf(stderr,"play_marker_test: invalid --card\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--trials") {
+      trials=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if((!ok)||(trials==0)) {
+	fprintf(stderr,"play_marker_test: invalid --trials\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--segue") {
+      test_segue=rda->cmdSwitch()->value(i).toInt(&ok);
+      if((!ok)||(test_segue<0)) {
+	fprintf(stderr,"play_marker_test: invalid --segue\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--load") {
+      test_load=rda->cmdSwitch()->value(i).toInt(&ok);
+      if((!ok)||(test_load<0)) {
+	fprintf(stderr,"play_marker_test: invalid --load\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--period") {
+      period=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if((!ok)||(period==0)) {
+	fprintf(stderr,"play_marker_test: invalid --period\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--fake-caed") {
+      fake_cae=true;
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(!rda->cmdSwitch()->processed(i)) {
+      fprintf(stderr,"play_marker_test: unknown command option \"%s\"\n",
+	      (const char *)rda->cmdSwitch()->key(i));
+      exit(2);
+    }
+  }
+  if(cutname.isEmpty()) {
+    QString sql=QString("select ")+
+      "CUT_NAME "+  // 00
+      "from CUTS where LENGTH>=30000 order by CUT_NAME limit 1";
+    RDSqlQuery *q=new RDSqlQuery(sql);
+    if(q->first()) {
+      cutname=q->value(0).toString();
+    }
+    delete q;
+  }
+  if(cutname.isEmpty()) {
+    fprintf(stderr,"play_marker_test: no cut found, use --cut\n");
+    exit(1);
+  }
+
+  //
+  // Segue points are set on the log line, in msecs from the start of
+  // the audio file
+  //
+  RDCut *cut=new RDCut(cutname);
+  if((!cut->exists())||
+     ((cut->endPoint()-cut->startPoint())<(test_segue+2000))) {
+    fprintf(stderr,"play_marker_test: cut %s is too short\n",
+	    (const char *)cutname.toUtf8());
+    exit(1);
+  }
+  test_logline=new RDLogLine();
+  test_logline->loadCart(RDCut::cartNumber(cutname),
+			 RDCut::cutNumber(cutname));
+  test_logline->setCutName(cutname);
+  test_logline->setSegueStartPoint(cut->startPoint()+test_segue,
+				   RDLogLine::LogPointer);
+  test_logline->setSegueEndPoint(cut->startPoint()+test_segue+1000,
+				 RDLogLine::LogPointer);
+  delete cut;
+
+  test_load_timer=new QTimer(this);
+  connect(test_load_timer,SIGNAL(timeout()),this,SLOT(loadData()));
+
+  //
+  // Connect to caed(8)
+  //
+  if(fake_cae&&(!StartFakeCae(period,&err_msg))) {
+    fprintf(stderr,"play_marker_test: %s\n",(const char *)err_msg.toUtf8());
+    exit(1);
+  }
+  rda->cae()->connectHost();
+  Wait(500);
+
+  for(unsigned i=0;i<trials;i++) {
+    Trial();
+  }
+
+  //
+  // caed(8) checks play markers every 5 mS, against positions that
+  // advance one audio period at a time
+  //
+  double period_msecs=1000.0*(double)period/
+    (double)rda->system()->sampleRate();
+  printf("cut %s, segue at %d mS on card %d, %u trials, %d mS load%s:\n",
+	 (const char *)cutname.toUtf8(),test_segue,test_card,trials,
+	 test_load,fake_cae?", fake caed(8)":"");
+  max_delay=Summarize("segue start, marker reported",test_marker_delays[0]);
+  if((delay=Summarize("segue end, marker reported",test_marker_delays[1]))>
+     max_delay) {
+    max_delay=delay;
+  }
+  Summarize("segue start, marker handled",test_handled_delays[0]);
+  Summarize("segue end, marker handled",test_handled_delays[1]);
+  Summarize("segue start, legacy timer",test_legacy_delays[0]);
+  Summarize("segue end, legacy timer",test_legacy_delays[1]);
+  printf("  one period: %4.1lf mS\n",period_msecs);
+  if((double)max_delay>(period_msecs+10.0)) {
+    printf("FAILED: markers reported more than one period late\n");
+    exit(1);
+  }
+  printf("PASSED\n");
+  exit(0);
+}
+
+
+void MainObject::segueStartData(int id)
+{
+  test_marker_delays[0].push_back(test_deck->lastMarkerDelay());
+  test_handled_delays[0].push_back(test_deck->currentPosition()-test_segue);
+  test_pending--;
+}
+
+
+void MainObject::segueEndData(int id)
+{
+  test_marker_delays[1].push_back(test_deck->lastMarkerDelay());
+  test_handled_delays[1].
+    push_back(test_deck->currentPosition()-test_segue-1000);
+  test_pending--;
+}
+
+
+void MainObject::legacyStartData()
+{
+  test_legacy_delays[0].push_back(test_deck->currentPosition()-test_segue);
+  test_pending--;
+}
+
+
+void MainObject::legacyEndData()
+{
+  test_legacy_delays[1].
+    push_back(test_deck->currentPosition()-test_segue-1000);
+  test_pending--;
+}
+
+
+void MainObject::stateChangedData(int id,RDPlayDeck::State state)
+{
+  if((state==RDPlayDeck::Stopped)||(state==RDPlayDeck::Finished)) {
+    test_finished=true;
+  }
+}
+
+
+void MainObject::loadData()
+{
+  QTime start=QTime::currentTime();
+  int msecs=random()%(test_load+1);
+
+  while(start.msecsTo(QTime::currentTime())<msecs);
+}
+
+
+void MainObject::Trial()
+{
+  test_deck=new RDPlayDeck(rda->cae(),0,this);
+  connect(test_deck,SIGNAL(segueStart(int)),this,SLOT(segueStartData(int)));
+  connect(test_deck,SIGNAL(segueEnd(int)),this,SLOT(segueEndData(int)));
+  connect(test_deck,SIGNAL(stateChanged(int,RDPlayDeck::State)),
+	  this,SLOT(stateChangedData(int,RDPlayDeck::State)));
+  test_deck->setCard(test_card);
+  test_deck->setPort(0);
+  if(!test_deck->setCart(test_logline,false)) {
+    fprintf(stderr,"play_marker_test: unable to load cut %s on card %d\n",
+	    (const char *)test_logline->cutName().toUtf8(),test_card);
+    exit(1);
+  }
+  test_deck->duckVolume(RD_MUTE_DEPTH,0);
+  test_pending=4;
+  test_finished=false;
+
+  //
+  // The legacy timers start when play is called, as RDPlayDeck's own
+  // point timers did
+  //
+  test_deck->play(0);
+  QTimer::singleShot(test_segue,this,SLOT(legacyStartData()));
+  QTimer::singleShot(test_segue+1000,this,SLOT(legacyEndData()));
+  test_load_timer->start(0);
+  for(int i=0;(i<((test_segue+6000)/50))&&(test_pending>0);i++) {
+    Wait(50);
+  }
+  test_load_timer->stop();
+  if(test_pending>0) {
+    fprintf(stderr,"play_marker_test: segue markers not received\n");
+    exit(1);
+  }
+  test_deck->stop();
+  for(int i=0;(i<100)&&(!test_finished);i++) {
+    Wait(50);
+  }
+  delete test_deck;
+  test_deck=NULL;
+  Wait(200);
+}
+
+
+int MainObject::Summarize(const char *label,
+			  const std::vector<int> &delays) const
+{
+  int total=0;
+  int max=0;
+
+  for(unsigned i=0;i<delays.size();i++) {
+    total+=abs(delays.at(i));
+    if(abs(delays.at(i))>max) {
+      max=abs(delays.at(i));
+    }
+  }
+  printf("  %s: %4.1lf mS average, %d mS maximum\n",label,
+	 (double)total/(double)delays.size(),max);
+  return max;
+}
+
+
+void MainObject::Wait(int msecs)
+{
+  QEventLoop loop;
+
+  QTimer::singleShot(msecs,&loop,SLOT(quit()));
+  loop.exec();
+}
+
+
+bool MainObject::StartFakeCae(unsigned period,QString *err_msg)
+{
+  int sock;
+  int opt=1;
+  struct sockaddr_in sa;
+  unsigned samprate=rda->system()->sampleRate();
+  pid_t pid;
+
+  //
+  // Bind here, so that a caed(8) already holding the port is reported
+  // before we fork
+  //
+  if((sock=socket(AF_INET,SOCK_STREAM,0))<0) {
+    *err_msg=QString("unable to create socket: ")+strerror(errno);
+    return false;
+  }
+  setsockopt(sock,SOL_SOCKET,SO_REUSEADDR,&opt,sizeof(opt));
+  memset(&sa,0,sizeof(sa));
+  sa.sin_family=AF_INET;
+  sa.sin_port=htons(CAED_TCP_PORT);
+  sa.sin_addr.s_addr=
+    htonl(rda->station()->caeAddress(rda->config()).toIPv4Address());
+  if(bind(sock,(struct sockaddr *)&sa,sizeof(sa))<0) {
+    *err_msg=QString().sprintf("unable to bind port %d: ",CAED_TCP_PORT)+
+      strerror(errno)+" (is caed(8) running?)";
+    ::close(sock);
+    return false;
+  }
+  if(listen(sock,1)<0) {
+    *err_msg=QString("unable to listen: ")+strerror(errno);
+    ::close(sock);
+    return false;
+  }
+  if((pid=fork())<0) {
+    *err_msg=QString("unable to fork: ")+strerror(errno);
+    ::close(sock);
+    return false;
+  }
+  if(pid==0) {
+    //
+    // No database calls from here on, as we share the parent's connection
+    //
+    prctl(PR_SET_PDEATHSIG,SIGKILL);
+    test_fake_period=period;
+    test_fake_samprate=samprate;
+    RunFakeCae(sock);
+    _exit(0);
+  }
+  ::close(sock);
+
+  return true;
+}
+
+
+void MainObject::RunFakeCae(int listen_sock)
+{
+  int sock;
+  char buf[1024];
+  QString accum;
+  fd_set fds;
+  struct timeval tv;
+  int n;
+
+  if((sock=accept(listen_sock,NULL,NULL))<0) {
+    return;
+  }
+  ::close(listen_sock);
+  test_fake_batching=false;
+  test_fake_next_handle=0;
+  while(true) {
+    FD_ZERO(&fds);
+    FD_SET(sock,&fds);
+    tv.tv_sec=0;
+    tv.tv_usec=1000*PLAY_MARKER_TEST_FAKE_INTERVAL;
+    if(select(sock+1,&fds,NULL,NULL,&tv)>0) {
+      if((n=read(sock,buf,1024))<=0) {
+	return;  // Our parent has gone
+      }
+      for(int i=0;i<n;i++) {
+	if(buf[i]=='!') {
+	  QStringList cmd=accum.split(" ",QString::SkipEmptyParts);
+	  if(cmd.size()>0) {
+	    FakeCaeCommand(sock,cmd);
+	  }
+	  accum="";
+	}
+	else {
+	  accum+=buf[i];
+	}
+      }
+    }
+    FakeCaeCheck(sock);
+  }
+}
+
+
+void MainObject::FakeCaeCommand(int sock,const QStringList &cmd)
+{
+  std::map<int,FakeCaeStream>::iterator it;
+  int handle=-1;
+
+  //
+  // Batches are run when they end, as caed(8) does
+  //
+  if(cmd.at(0)=="BB") {
+    test_fake_batching=true;
+    test_fake_batch.clear();
+    return;
+  }
+  if(cmd.at(0)=="BE") {
+    QList<QStringList> batch=test_fake_batch;
+    test_fake_batching=false;
+    test_fake_batch.clear();
+    for(int i=0;i<batch.size();i++) {
+      FakeCaeCommand(sock,batch.at(i));
+    }
+    FakeCaeSend(sock,cmd.join(" ")+" +!");
+    return;
+  }
+  if(test_fake_batching) {
+    test_fake_batch.push_back(cmd);
+    return;
+  }
+
+  if(cmd.at(0)=="PW") {
+    FakeCaeSend(sock,"PW +!");
+    return;
+  }
+
+  if((cmd.at(0)=="LP")&&(cmd.size()==3)) {
+    FakeCaeStream strm;
+    strm.card=cmd.at(1).toInt();
+    for(strm.stream=0;strm.stream<RD_MAX_STREAMS;strm.stream++) {
+      bool used=false;
+      for(it=test_fake_streams.begin();it!=test_fake_streams.end();it++) {
+	if((it->second.card==strm.card)&&(it->second.stream==strm.stream)) {
+	  used=true;
+	}
+      }
+      if(!used) {
+	break;
+      }
+    }
+    if(strm.stream==RD_MAX_STREAMS) {
+      FakeCaeSend(sock,cmd.join(" ")+" -1 -1 -!");
+      return;
+    }
+    handle=test_fake_next_handle++;
+    test_fake_streams[handle]=strm;
+    FakeCaeSend(sock,cmd.join(" ")+
+		QString().sprintf(" %d %d +!",strm.stream,handle));
+    return;
+  }
+
+  //
+  // Everything else we answer is addressed by handle
+  //
+  if(cmd.size()>=2) {
+    handle=cmd.at(1).toInt();
+  }
+  if((it=test_fake_streams.find(handle))==test_fake_streams.end()) {
+    if((cmd.at(0)=="UP")||(cmd.at(0)=="PP")||(cmd.at(0)=="PY")||
+       (cmd.at(0)=="SP")||(cmd.at(0)=="MK")) {
+      FakeCaeSend(sock,cmd.join(" ")+" -!");
+    }
+    return;
+  }
+  FakeCaeStream *strm=&it->second;
+
+  if(cmd.at(0)=="UP") {
+    test_fake_streams.erase(it);
+    FakeCaeSend(sock,cmd.join(" ")+" +!");
+    return;
+  }
+
+  if((cmd.at(0)=="PP")&&(cmd.size()==3)) {
+    strm->start_pos=cmd.at(2).toUInt();
+    clock_gettime(CLOCK_MONOTONIC,&strm->start_time);
+    FakeCaeSend(sock,cmd.join(" ")+" +!");
+  }
+
+  if((cmd.at(0)=="PY")&&(cmd.size()==5)) {
+    if(strm->playing) {
+      FakeCaeSend(sock,cmd.join(" ")+" -!");
+      return;
+    }
+    strm->length=(unsigned)((uint64_t)cmd.at(2).toUInt()*
+			    cmd.at(3).toUInt()/100000);
+    strm->playing=true;
+    clock_gettime(CLOCK_MONOTONIC,&strm->start_time);
+    FakeCaeSend(sock,QString("PY ")+cmd.at(1)+" "+cmd.at(2)+" "+cmd.at(3)+
+		" +!");
+  }
+
+  if(cmd.at(0)=="SP") {
+    if(!strm->playing) {
+      FakeCaeSend(sock,cmd.join(" ")+" -!");
+      return;
+    }
+    strm->start_pos=FakeCaePosition(*strm);
+    strm->playing=false;
+    strm->markers.clear();
+    FakeCaeSend(sock,cmd.join(" ")+" +!");
+  }
+
+  if((cmd.at(0)=="MK")&&(cmd.size()==4)) {
+    strm->markers[cmd.at(2).toInt()]=cmd.at(3).toUInt();
+  }
+
+  if(cmd.at(0)=="MC") {
+    strm->markers.clear();
+    FakeCaeSend(sock,cmd.join(" ")+" +!");
+  }
+}
+
+
+unsigned MainObject::FakeCaePosition(const FakeCaeStream &strm) const
+{
+  struct timespec now;
+  int64_t nsecs;
+  uint64_t frames;
+
+  if(!strm.playing) {
+    return strm.start_pos;
+  }
+
+  //
+  // Audio leaves a real card one period at a time
+  //
+  clock_gettime(CLOCK_MONOTONIC,&now);
+  nsecs=1000000000*(int64_t)(now.tv_sec-strm.start_time.tv_sec)+
+    now.tv_nsec-strm.start_time.tv_nsec;
+  frames=(uint64_t)nsecs*test_fake_samprate/1000000000;
+  if(test_fake_period>0) {
+    frames-=frames%test_fake_period;
+  }
+  if((1000*frames/test_fake_samprate)>strm.length) {
+    return strm.start_pos+strm.length;
+  }
+  return strm.start_pos+(unsigned)(1000*frames/test_fake_samprate);
+}
+
+
+void MainObject::FakeCaeSend(int sock,const QString &msg)
+{
+  QByteArray data=msg.toUtf8();
+
+  write(sock,data.constData(),data.size());
+}
+
+
+void MainObject::FakeCaeCheck(int sock)
+{
+  std::map<int,unsigned>::iterator next;
+  unsigned pos;
+
+  for(std::map<int,FakeCaeStream>::iterator it=test_fake_streams.begin();
+      it!=test_fake_streams.end();it++) {
+    FakeCaeStream *strm=&it->second;
+    if(!strm->playing) {
+      continue;
+    }
+    pos=FakeCaePosition(*strm);
+
+    //
+    // Markers reached together go out in the order they occur in the audio
+    //
+    while(true) {
+      next=strm->markers.end();
+      for(std::map<int,unsigned>::iterator jt=strm->markers.begin();
+	  jt!=strm->markers.end();jt++) {
+	if((jt->second<=pos)&&
+	   ((next==strm->markers.end())||(jt->second<next->second))) {
+	  next=jt;
+	}
+      }
+      if(next==strm->markers.end()) {
+	break;
+      }
+      FakeCaeSend(sock,QString().sprintf("MK %d %d %u %u!",it->first,
+					 next->first,next->second,pos));
+      strm->markers.erase(next);
+    }
+    if(pos>=(strm->start_pos+strm->length)) {
+      strm->start_pos=pos;
+      strm->playing=false;
+      strm->markers.clear();
+      FakeCaeSend(sock,QString().sprintf("SP %d +!",it->first));
+    }
+  }
+}
+
+
+FakeCaeStream::FakeCaeStream()
+{
+  card=0;
+  stream=0;
+  playing=false;
+  start_pos=0;
+  length=0;
+  start_time.tv_sec=0;
+  start_time.tv_nsec=0;
+}
+
+
+int main(int argc,char *argv[])
+{
+  QApplication a(argc,argv,false);
+  new MainObject();
+  return a.exec();
+}
@@ -0,0 +1,104 @@
+// play_marker_test.h
+//
+// Check when RDPlayDeck reports segue points against the audio clock
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef PLAY_MARKER_TEST_H
+#define PLAY_MARKER_TEST_H
+
+#include <time.h>
+
+#include <map>
+#include <vector>
+
+#include <qobject.h>
+#include <qstringlist.h>
+#include <qtimer.h>
+
+#include <rdlog_line.h>
+#include <rdplay_deck.h>
+
+//
+// Longest time the fake caed(8) waits between marker checks (mS)
+//
+#define PLAY_MARKER_TEST_FAKE_INTERVAL 5
+
+#define PLAY_MARKER_TEST_USAGE "[options]\n\nPlay a cut through an RDPlayDeck with a segue set part way into it while the\nevent loop is kept busy, and see how late the segue start and end are\nreported. The caed(8) play markers used by RDPlayDeck are compared with\nQTimers started when play is called, as RDPlayDeck used before. The test\npasses if every marker is reported within one audio period and two marker\nintervals of the audio reaching it. The deck is muted while playing.\nRequires a running caed(8), unless --fake-caed is given.\n\nOptions are:\n--cut=<cart>_<cut>\n     Cut to play. Default is the first cut at least 30 seconds long.\n\n--card=<num>\n     Audio card to use. Default is 0.\n\n--trials=<num>\n     Number of plays. Default is 5.\n\n--segue=<msecs>\n     Start of the segue, from the start of the cut. The segue lasts one\n     second. Default is 5000.\n\n--load=<msecs>\n     Longest time the event loop is kept busy at a stretch. Default is 20.\n\n--period=<frames>\n     Audio period size. Default is the ALSA period size in rd.conf(5).\n\n--fake-caed\n     Play against a stand-in for caed(8), run in a child process on the\n     caed(8) port, that advances each stream one period at a time on the\n     system clock without touching any audio hardware. Use this where no\n     caed(8) or audio card is available.\n\n"
+
+//
+// One play stream of the fake caed(8)
+//
+class FakeCaeStream
+{
+ public:
+  FakeCaeStream();
+  int card;
+  int stream;
+  bool playing;
+  unsigned start_pos;
+  unsigned length;
+  struct timespec start_time;
+  std::map<int,unsigned> markers;
+};
+
+
+class MainObject : public QObject
+{
+  Q_OBJECT
+ public:
+  MainObject(QObject *parent=0);
+
+ private slots:
+  void segueStartData(int id);
+  void segueEndData(int id);
+  void legacyStartData();
+  void legacyEndData();
+  void stateChangedData(int id,RDPlayDeck::State state);
+  void loadData();
+
+ private:
+  void Trial();
+  int Summarize(const char *label,const std::vector<int> &delays) const;
+  void Wait(int msecs);
+  bool StartFakeCae(unsigned period,QString *err_msg);
+  void RunFakeCae(int listen_sock);
+  void FakeCaeCommand(int sock,const QStringList &cmd);
+  unsigned FakeCaePosition(const FakeCaeStream &strm) const;
+  void FakeCaeSend(int sock,const QString &msg);
+  void FakeCaeCheck(int sock);
+  RDPlayDeck *test_deck;
+  RDLogLine *test_logline;
+  QTimer *test_load_timer;
+  int test_card;
+  int test_segue;
+  int test_load;
+  int test_pending;
+  bool test_finished;
+  std::vector<int> test_marker_delays[2];
+  std::vector<int> test_handled_delays[2];
+  std::vector<int> test_legacy_delays[2];
+  std::map<int,FakeCaeStream> test_fake_streams;
+  QList<QStringList> test_fake_batch;
+  bool test_fake_batching;
+  int test_fake_next_handle;
+  unsigned test_fake_period;
+  unsigned test_fake_samprate;
+};
+
+
+#endif  // PLAY_MARKER_TEST_H
@@ -0,0 +1,488 @@
+// purge_engine_test.cpp
+//
+// Run RDPurgeEngine against a synthetic library and ELR
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <QApplication>
+#include <QDateTime>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+#include <rd.h>
+#include <rdapplication.h>
+#include <rdcut.h>
+#include <rddb.h>
+#include <rdescape_string.h>
+
+#include "purge_engine_test.h"
+
+//
+// A second connection writing to the tables being purged
+//
+class Probe
+{
+ public:
+  RDConfig *config;
+  QString sql;
+  bool running;
+  unsigned count;
+  uint64_t max_usecs;
+  uint64_t total_usecs;
+  pthread_t thread;
+  pthread_mutex_t mutex;
+};
+
+Probe test_probe;
+
+
+uint64_t __Now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return 1000000*(uint64_t)ts.tv_sec+(uint64_t)ts.tv_nsec/1000;
+}
+
+
+void *__ProbeCallback(void *priv)
+{
+  Probe *probe=(Probe *)priv;
+  uint64_t start;
+  uint64_t usecs;
+  bool running=true;
+
+  {
+    QSqlDatabase db=
+      QSqlDatabase::addDatabase(probe->config->mysqlDriver(),"probe");
+    db.setHostName(probe->config->mysqlHostname());
+    db.setDatabaseName(probe->config->mysqlDbname());
+    db.setUserName(probe->config->mysqlUsername());
+    db.setPassword(probe->config->mysqlPassword());
+    if(!db.open()) {
+      fprintf(stderr,"purge_engine_test: probe unable to connect\n");
+      return NULL;
+    }
+    QSqlQuery q(db);
+    while(running) {
+      start=__Now();
+      q.exec(probe->sql);
+      usecs=__Now()-start;
+      pthread_mutex_lock(&probe->mutex);
+      probe->count++;
+      probe->total_usecs+=usecs;
+      if(usecs>probe->max_usecs) {
+	probe->max_usecs=usecs;
+      }
+      running=probe->running;
+      pthread_mutex_unlock(&probe->mutex);
+      usleep(10000);
+    }
+    db.close();
+  }
+  QSqlDatabase::removeDatabase("probe");
+
+  return NULL;
+}
+
+
+MainObject::MainObject(QObject *parent)
+  :QObject(parent)
+{
+  QString err_msg;
+  QString sql;
+  unsigned elr_lines=1000000;
+  unsigned errors=0;
+  uint64_t start;
+  bool baseline=false;
+  bool ok=false;
+
+  test_first_cart=900000;
+  test_carts=20000;
+  test_max_lock=0;
+
+  rda=new RDApplication("purge_engine_test","purge_engine_test",
+			PURGE_ENGINE_TEST_USAGE,this);
+  if(!rda->open(&err_msg)) {
+    fprintf(stderr,"purge_engine_test: %s\n",(const char *)err_msg);
+    exit(1);
+  }
+  RDPurgeEngine *engine=
+    new RDPurgeEngine(rda->station(),NULL,rda->config());
+  engine->setDeleteAudio(false);
+
+  for(unsigned i=0;i<rda->cmdSwitch()->keys();i++) {
+    if(rda->cmdSwitch()->key(i)=="--first-cart") {
+      test_first_cart=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if((!ok)||(test_first_cart==0)) {
+	fprintf(stderr,"purge_engine_test: invalid --first-cart\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--carts") {
+      test_carts=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if((!ok)||(test_carts==0)) {
+	fprintf(stderr,"purge_engine_test: invalid --carts\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--elr-lines") {
+      elr_lines=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if(!ok) {
+	fprintf(stderr,"purge_engine_test: invalid --elr-lines\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--cut-batch") {
+      engine->setCutBatchSize(rda->cmdSwitch()->value(i).toUInt(&ok));
+      if(!ok) {
+	fprintf(stderr,"purge_engine_test: invalid --cut-batch\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--elr-batch") {
+      engine->setElrBatchSize(rda->cmdSwitch()->value(i).toUInt(&ok));
+      if(!ok) {
+	fprintf(stderr,"purge_engine_test: invalid --elr-batch\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--threads") {
+      engine->setThreads(rda->cmdSwitch()->value(i).toUInt(&ok));
+      if(!ok) {
+	fprintf(stderr,"purge_engine_test: invalid --threads\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--delete-audio") {
+      engine->setDeleteAudio(true);
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--baseline") {
+      baseline=true;
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--max-lock") {
+      test_max_lock=1000*(uint64_t)rda->cmdSwitch()->value(i).toUInt(&ok);
+      if(!ok) {
+	fprintf(stderr,"purge_engine_test: invalid --max-lock\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(!rda->cmdSwitch()->processed(i)) {
+      fprintf(stderr,"purge_engine_test: unknown command option \"%s\"\n",
+	      (const char *)rda->cmdSwitch()->key(i));
+      exit(2);
+    }
+  }
+
+  //
+  // Sanity Checks
+  //
+  if((test_first_cart+test_carts-1)>RD_MAX_CART_NUMBER) {
+    fprintf(stderr,"purge_engine_test: cart range exceeds %u\n",
+	    RD_MAX_CART_NUMBER);
+    exit(1);
+  }
+  sql=QString("select NUMBER from CART where ")+
+    QString().sprintf("(NUMBER>=%u)&&(NUMBER<%u)",
+		      test_first_cart,test_first_cart+test_carts);
+  if(RDSqlQuery::rows(sql)>0) {
+    fprintf(stderr,"purge_engine_test: cart range %06u - %06u is not free\n",
+	    test_first_cart,test_first_cart+test_carts-1);
+    exit(1);
+  }
+  test_group=QString().sprintf("PT%d",getpid()%100000000);
+  test_service=test_group;
+  test_probe.config=rda->config();
+  pthread_mutex_init(&test_probe.mutex,NULL);
+
+  //
+  // Synthetic Data
+  //
+  printf("loading %u carts and %u ELR lines...\n",test_carts,elr_lines);
+  sql=QString("insert into GROUPS set ")+
+    "NAME=\""+RDEscapeString(test_group)+"\","+
+    "DESCRIPTION=\"purge_engine_test\","+
+    "CUT_SHELFLIFE=30,"+
+    "DELETE_EMPTY_CARTS=\"Y\"";
+  RDSqlQuery::apply(sql);
+  sql=QString("insert into SERVICES set ")+
+    "NAME=\""+RDEscapeString(test_service)+"\","+
+    "DESCRIPTION=\"purge_engine_test\","+
+    "ELR_SHELFLIFE=30";
+  RDSqlQuery::apply(sql);
+  LoadCuts();
+  LoadElr(elr_lines,60);
+  LoadElr(1000,0);
+
+  //
+  // Purge Cuts
+  //
+  StartProbe(QString("update CART set METADATA_DATETIME=now() where ")+
+	     QString().sprintf("NUMBER=%u",test_first_cart));
+  start=__Now();
+  if(!engine->purgeCuts(test_group,&err_msg)) {
+    printf("  purgeCuts() failed: %s\n",(const char *)err_msg.toUtf8());
+    errors++;
+  }
+  Report("cuts",engine,__Now()-start);
+  StopProbe("update CART");
+  sql=QString("select CUT_NAME from CUTS where ")+
+    QString().sprintf("(CART_NUMBER>=%u)&&(CART_NUMBER<%u)",
+		      test_first_cart,test_first_cart+test_carts);
+  errors+=!Check("cuts remaining",RDSqlQuery::rows(sql),test_kept_cuts);
+  sql=QString("select NUMBER from CART where ")+
+    "GROUP_NAME=\""+RDEscapeString(test_group)+"\"";
+  errors+=!Check("carts remaining",RDSqlQuery::rows(sql),test_kept_carts);
+  sql=QString("select NUMBER from CART where ")+
+    "(GROUP_NAME=\""+RDEscapeString(test_group)+"\")&&"+
+    "(CUT_QUANTITY!=(select count(*) from CUTS "+
+    "where CUTS.CART_NUMBER=CART.NUMBER))";
+  errors+=!Check("wrong cut quantities",RDSqlQuery::rows(sql),0);
+  errors+=!Check("cuts purged",engine->cutsPurged(),test_expired_cuts);
+
+  //
+  // Purge ELR
+  //
+  engine->clearStatistics();
+  StartProbe(QString("insert into ELR_LINES set ")+
+	     "SERVICE_NAME=\""+RDEscapeString(test_service)+"\","+
+	     "EVENT_DATETIME=now(),"+
+	     "EXT_DATA=\"PROBE\"");
+  start=__Now();
+  if(!engine->purgeElr(test_service,&err_msg)) {
+    printf("  purgeElr() failed: %s\n",(const char *)err_msg.toUtf8());
+    errors++;
+  }
+  Report("ELR",engine,__Now()-start);
+  StopProbe("insert ELR_LINES");
+  sql=QString("select ID from ELR_LINES where ")+
+    "(SERVICE_NAME=\""+RDEscapeString(test_service)+"\")&&"+
+    "(EXT_DATA=\"EXPIRED\")";
+  errors+=!Check("expired ELR lines remaining",RDSqlQuery::rows(sql),0);
+  sql=QString("select ID from ELR_LINES where ")+
+    "(SERVICE_NAME=\""+RDEscapeString(test_service)+"\")&&"+
+    "(EXT_DATA=\"FRESH\")";
+  errors+=!Check("current ELR lines remaining",RDSqlQuery::rows(sql),1000);
+  errors+=!Check("ELR lines purged",engine->elrLinesPurged(),elr_lines);
+
+  //
+  // Unbounded DELETE, for comparison
+  //
+  if(baseline) {
+    printf("reloading %u ELR lines...\n",elr_lines);
+    LoadElr(elr_lines,60);
+    StartProbe(QString("insert into ELR_LINES set ")+
+	       "SERVICE_NAME=\""+RDEscapeString(test_service)+"\","+
+	       "EVENT_DATETIME=now(),"+
+	       "EXT_DATA=\"PROBE\"");
+    sql=QString("delete from ELR_LINES where ")+
+      "SERVICE_NAME=\""+RDEscapeString(test_service)+"\" && "+
+      "EVENT_DATETIME<\""+QDate::currentDate().addDays(-30).
+      toString("yyyy-MM-dd")+" 00:00:00\"";
+    start=__Now();
+    RDSqlQuery::apply(sql);
+    printf("ELR, single DELETE: %.1lf S\n",(double)(__Now()-start)/1000000.0);
+    StopProbe("insert ELR_LINES");
+  }
+
+  Cleanup();
+  delete engine;
+  if(errors>0) {
+    printf("FAILED: %u check(s) failed\n",errors);
+    exit(1);
+  }
+  printf("PASSED\n");
+  exit(0);
+}
+
+
+void MainObject::LoadCuts()
+{
+  QStringList carts;
+  QStringList cuts;
+  QString expired=QDateTime::currentDateTime().addDays(-60).
+    toString("yyyy-MM-dd hh:mm:ss");
+  unsigned cartnum;
+  bool last;
+
+  //
+  // Of every four carts, one keeps both cuts, one keeps one and two lose
+  // both, and so are deleted.
+  //
+  test_kept_cuts=0;
+  test_kept_carts=0;
+  for(unsigned i=0;i<test_carts;i++) {
+    cartnum=test_first_cart+i;
+    last=i==(test_carts-1);
+    carts.push_back(QString().sprintf("(%u,1,",cartnum)+
+		    "\""+RDEscapeString(test_group)+"\","+
+		    QString().sprintf("\"Purge Test %u\",2)",cartnum));
+    for(int j=1;j<=2;j++) {
+      bool keep=((i%4)==0)||(((i%4)==1)&&(j==2));
+      cuts.push_back("(\""+RDCut::cutName(cartnum,j)+"\","+
+		     QString().sprintf("%u,\"Cut %d\",60000,",cartnum,j)+
+		     (keep?QString("null"):("\""+expired+"\""))+")");
+      if(keep) {
+	test_kept_cuts++;
+      }
+    }
+    if((i%4)<2) {
+      test_kept_carts++;
+    }
+    Insert("CART","NUMBER,TYPE,GROUP_NAME,TITLE,CUT_QUANTITY",&carts,last);
+    Insert("CUTS","CUT_NAME,CART_NUMBER,DESCRIPTION,LENGTH,END_DATETIME",
+	   &cuts,last);
+  }
+  test_expired_cuts=2*test_carts-test_kept_cuts;
+}
+
+
+void MainObject::LoadElr(unsigned lines,int days_ago)
+{
+  QStringList values;
+  QString ext_data=(days_ago==0)?"FRESH":"EXPIRED";
+  QDateTime dt=QDateTime::currentDateTime().addDays(-days_ago);
+
+  for(unsigned i=0;i<lines;i++) {
+    values.push_back("(\""+RDEscapeString(test_service)+"\","+
+		     "\""+dt.addSecs(-(i%86400)).
+		     toString("yyyy-MM-dd hh:mm:ss")+"\","+
+		     QString().sprintf("%u,%u,",1000*(i%300),1+i%999999)+
+		     "\"Purge Test\","+
+		     "\""+ext_data+"\")");
+    Insert("ELR_LINES",
+	   "SERVICE_NAME,EVENT_DATETIME,LENGTH,CART_NUMBER,TITLE,EXT_DATA",
+	   &values,i==(lines-1));
+  }
+}
+
+
+void MainObject::Insert(const QString &table,const QString &cols,
+			QStringList *values,bool flush)
+{
+  if((values->size()>=1000)||(flush&&(values->size()>0))) {
+    RDSqlQuery::apply("insert into "+table+" ("+cols+") values "+
+		      values->join(","));
+    values->clear();
+  }
+}
+
+
+void MainObject::StartProbe(const QString &sql)
+{
+  test_probe.sql=sql;
+  test_probe.running=true;
+  test_probe.count=0;
+  test_probe.max_usecs=0;
+  test_probe.total_usecs=0;
+  pthread_create(&test_probe.thread,NULL,__ProbeCallback,&test_probe);
+}
+
+
+void MainObject::StopProbe(const QString &desc)
+{
+  pthread_mutex_lock(&test_probe.mutex);
+  test_probe.running=false;
+  pthread_mutex_unlock(&test_probe.mutex);
+  pthread_join(test_probe.thread,NULL);
+  if(test_probe.count>0) {
+    printf("  concurrent %s: %u writes, mean %.1lf mS, max %.1lf mS\n",
+	   (const char *)desc.toUtf8(),test_probe.count,
+	   (double)test_probe.total_usecs/(1000.0*(double)test_probe.count),
+	   (double)test_probe.max_usecs/1000.0);
+  }
+}
+
+
+void MainObject::Report(const QString &desc,RDPurgeEngine *engine,
+			uint64_t usecs)
+{
+  printf("%s: %.1lf S, %u transactions\n",(const char *)desc.toUtf8(),
+	 (double)usecs/1000000.0,engine->transactions());
+  if(engine->transactions()>0) {
+    printf("  lock hold time: mean %.1lf mS, max %.1lf mS\n",
+	   (double)engine->totalLockTime()/
+	   (1000.0*(double)engine->transactions()),
+	   (double)engine->maximumLockTime()/1000.0);
+  }
+  if((test_max_lock>0)&&(engine->maximumLockTime()>test_max_lock)) {
+    printf("  FAILED: a transaction took longer than %u mS\n",
+	   (unsigned)(test_max_lock/1000));
+    Cleanup();
+    exit(1);
+  }
+}
+
+
+bool MainObject::Check(const QString &desc,unsigned value,unsigned expected)
+{
+  printf("  %-32s %u/%u",(const char *)desc.toUtf8(),value,expected);
+  if(value!=expected) {
+    printf("  FAILED\n");
+    return false;
+  }
+  printf("\n");
+
+  return true;
+}
+
+
+void MainObject::Cleanup()
+{
+  QString sql;
+
+  sql=QString("delete from CUTS where ")+
+    QString().sprintf("(CART_NUMBER>=%u)&&(CART_NUMBER<%u)",
+		      test_first_cart,test_first_cart+test_carts);
+  RDSqlQuery::apply(sql);
+  sql=QString("delete from CART where ")+
+    "GROUP_NAME=\""+RDEscapeString(test_group)+"\"";
+  RDSqlQuery::apply(sql);
+  sql=QString("delete from GROUPS where ")+
+    "NAME=\""+RDEscapeString(test_group)+"\"";
+  RDSqlQuery::apply(sql);
+  sql=QString("delete from ELR_LINES where ")+
+    "SERVICE_NAME=\""+RDEscapeString(test_service)+"\"";
+  RDSqlQuery::apply(sql);
+  sql=QString("delete from SERVICES where ")+
+    "NAME=\""+RDEscapeString(test_service)+"\"";
+  RDSqlQuery::apply(sql);
+}
+
+
+int main(int argc,char *argv[])
+{
+  QApplication a(argc,argv,false);
+  new MainObject();
+  return a.exec();
+}
@@ -0,0 +1,59 @@
+// purge_engine_test.h
+//
+// Run RDPurgeEngine against a synthetic library and ELR
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef PURGE_ENGINE_TEST_H
+#define PURGE_ENGINE_TEST_H
+
+#include <stdint.h>
+
+#include <qobject.h>
+#include <qstringlist.h>
+
+#include <rdpurgeengine.h>
+
+#define PURGE_ENGINE_TEST_USAGE "[options]\n\nCreate a scratch group and service holding synthetic carts, cuts and ELR\nlines, purge them with RDPurgeEngine, then check what is left. The time\nfor which each purge transaction held its locks is reported, along with\nthe latency seen by another connection writing to the same tables while\nthe purge runs. All of the synthetic data is removed afterwards.\n\nOptions are:\n--first-cart=<num>\n     First cart number used. The range must be free. Default is 900000.\n\n--carts=<num>\n     Number of carts created, with two cuts each. Three quarters of them\n     hold expired cuts. Default is 20000.\n\n--elr-lines=<num>\n     Number of expired ELR lines created. Default is 1000000.\n\n--cut-batch=<num>\n     Cuts removed in each transaction.\n\n--elr-batch=<num>\n     ELR lines removed by each DELETE.\n\n--threads=<num>\n     Threads used to unlink audio.\n\n--delete-audio\n     Unlink (nonexistent) audio for each cut, as rdmaint(8) does.\n\n--baseline\n     Also time a single unbounded ELR DELETE, as used before.\n\n--max-lock=<msecs>\n     Fail if any purge transaction takes longer than this.\n\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  void LoadCuts();
+  void LoadElr(unsigned lines,int days_ago);
+  void Insert(const QString &table,const QString &cols,QStringList *values,
+	      bool flush);
+  void StartProbe(const QString &sql);
+  void StopProbe(const QString &desc);
+  void Report(const QString &desc,RDPurgeEngine *engine,uint64_t usecs);
+  bool Check(const QString &desc,unsigned value,unsigned expected);
+  void Cleanup();
+  QString test_group;
+  QString test_service;
+  unsigned test_first_cart;
+  unsigned test_carts;
+  unsigned test_kept_cuts;
+  unsigned test_kept_carts;
+  unsigned test_expired_cuts;
+  uint64_t test_max_lock;
+};
+
+
+#endif  // PURGE_ENGINE_TEST_H
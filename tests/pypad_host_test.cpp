@@ -0,0 +1,472 @@
+// pypad_host_test.cpp
+//
+// Compare PyPAD instances run one per process with hosted instances
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QEventLoop>
+#include <QFile>
+#include <QStringList>
+#include <QTimer>
+
+#include <rdcmd_switch.h>
+#include <rdpaths.h>
+#include <rdweb.h>
+
+#include "pypad_host_test.h"
+
+//
+// Longest time to wait for instances to start or updates to arrive (mS)
+//
+#define PYPAD_HOST_TEST_TIMEOUT 60000
+
+MainObject::MainObject(QObject *parent)
+  : QObject(parent)
+{
+  bool ok=false;
+
+  test_script=QString(RD_PYPAD_SCRIPT_DIR)+"/pypad_udp.py";
+  test_instances=20;
+  test_updates=100;
+  test_per_host=0;
+  test_received=0;
+
+  RDCmdSwitch *cmd=new RDCmdSwitch(qApp->argc(),qApp->argv(),
+				   "pypad_host_test",PYPAD_HOST_TEST_USAGE);
+  for(unsigned i=0;i<cmd->keys();i++) {
+    if(cmd->key(i)=="--script") {
+      test_script=cmd->value(i);
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--instances") {
+      test_instances=cmd->value(i).toUInt(&ok);
+      if((!ok)||(test_instances==0)) {
+	fprintf(stderr,"pypad_host_test: invalid --instances\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--updates") {
+      test_updates=cmd->value(i).toUInt(&ok);
+      if((!ok)||(test_updates==0)) {
+	fprintf(stderr,"pypad_host_test: invalid --updates\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--per-host") {
+      test_per_host=cmd->value(i).toUInt(&ok);
+      if((!ok)||(test_per_host==0)) {
+	fprintf(stderr,"pypad_host_test: invalid --per-host\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(!cmd->processed(i)) {
+      fprintf(stderr,"pypad_host_test: unknown command option \"%s\"\n",
+	      (const char *)cmd->key(i));
+      exit(2);
+    }
+  }
+  if(test_per_host==0) {
+    test_per_host=test_instances;
+  }
+  if(!QFile::exists(test_script)) {
+    fprintf(stderr,"pypad_host_test: script \"%s\" not found\n",
+	    (const char *)test_script.toUtf8());
+    exit(1);
+  }
+
+  //
+  // Simulated rdpadd(8) and the UDP destination for the script
+  //
+  test_server=new QTcpServer(this);
+  connect(test_server,SIGNAL(newConnection()),this,SLOT(newConnectionData()));
+  if(!test_server->listen(QHostAddress::LocalHost)) {
+    fprintf(stderr,"pypad_host_test: unable to listen for PAD clients\n");
+    exit(1);
+  }
+  test_udp_socket=new QUdpSocket(this);
+  connect(test_udp_socket,SIGNAL(readyRead()),this,SLOT(readyReadData()));
+  if(!test_udp_socket->bind(QHostAddress::LocalHost,0)) {
+    fprintf(stderr,"pypad_host_test: unable to bind UDP socket\n");
+    exit(1);
+  }
+
+  //
+  // Script Configuration
+  //
+  test_config=QString().sprintf("/tmp/pypad_host_test-%d.conf",getpid());
+  FILE *f=NULL;
+  if((f=fopen(test_config.toUtf8(),"w"))==NULL) {
+    perror("pypad_host_test");
+    exit(1);
+  }
+  fprintf(f,"[Udp1]\n");
+  fprintf(f,"IpAddress=127.0.0.1\n");
+  fprintf(f,"UdpPort=%u\n",test_udp_socket->localPort());
+  fprintf(f,"FormatString=%%n: %%t - %%a\n");
+  fprintf(f,"Encoding=0\n");
+  fprintf(f,"ProcessNullUpdates=0\n");
+  fprintf(f,"MasterLog=Yes\n");
+  fprintf(f,"Aux1Log=No\n");
+  fprintf(f,"Aux2Log=No\n");
+  for(int i=0;i<20;i++) {
+    fprintf(f,"VLog%d=No\n",101+i);
+  }
+  fprintf(f,"\n[NowGroups]\n\n[NextGroups]\n");
+  fclose(f);
+
+  printf("%u instances of %s, %u updates\n",test_instances,
+	 (const char *)test_script.toUtf8(),test_updates);
+  Result results[2];
+  results[0]=Run(false);
+  results[1]=Run(true);
+  unlink(test_config.toUtf8());
+
+  printf("\n");
+  printf("                  processes    RSS (MB)  start (s)    CPU (s)  "
+	 "update (s)  received\n");
+  for(int i=0;i<2;i++) {
+    printf("  %-14s %10u %10.1lf %10.2lf %10.2lf %10.2lf %6u/%u\n",
+	   (i==0)?"per-process":"hosted",results[i].processes,
+	   (double)results[i].rss_kb/1024.0,results[i].startup_secs,
+	   results[i].cpu_secs,results[i].update_secs,results[i].received,
+	   test_instances*test_updates);
+  }
+  if(results[0].rss_kb>0) {
+    printf("  hosted memory use is %.0lf%% of per-process\n",
+	   100.0*(double)results[1].rss_kb/(double)results[0].rss_kb);
+  }
+  for(int i=0;i<2;i++) {
+    if((!results[i].ok)||
+       (results[i].received!=(test_instances*test_updates))) {
+      printf("FAILED\n");
+      exit(1);
+    }
+  }
+  printf("PASSED\n");
+  exit(0);
+}
+
+
+void MainObject::newConnectionData()
+{
+  while(test_server->hasPendingConnections()) {
+    test_connections.push_back(test_server->nextPendingConnection());
+  }
+}
+
+
+void MainObject::readyReadData()
+{
+  char data[1500];
+
+  while(test_udp_socket->hasPendingDatagrams()) {
+    test_udp_socket->readDatagram(data,1500);
+    test_received++;
+  }
+}
+
+
+MainObject::Result MainObject::Run(bool hosted)
+{
+  Result ret;
+  QList<QProcess *> procs;
+  unsigned started=0;
+  unsigned failed=0;
+  uint64_t start;
+  uint64_t ticks=0;
+
+  ret.ok=false;
+  ret.processes=0;
+  ret.rss_kb=0;
+  ret.startup_secs=0.0;
+  ret.cpu_secs=0.0;
+  ret.update_secs=0.0;
+  ret.received=0;
+  test_received=0;
+
+  //
+  // Start the instances
+  //
+  printf("%s: starting...\n",hosted?"hosted":"per-process");
+  fflush(stdout);
+  start=Now();
+  if(hosted) {
+    for(unsigned i=0;i<test_instances;i+=test_per_host) {
+      QProcess *proc=new QProcess(this);
+      proc->setReadChannelMode(QProcess::ForwardedErrorChannel);
+      QStringList args;
+      args.push_back("-m");
+      args.push_back("pypad_host");
+      args.push_back("127.0.0.1");
+      args.push_back(QString().sprintf("%u",test_server->serverPort()));
+      proc->start(RD_PYPAD_PYTHON_PATH,args);
+      for(unsigned j=i;(j<(i+test_per_host))&&(j<test_instances);j++) {
+	proc->write(QString().sprintf("LOAD\t%u\t",j+1).toUtf8()+
+		    test_script.toUtf8()+"\t"+test_config.toUtf8()+"\n");
+      }
+      procs.push_back(proc);
+    }
+  }
+  else {
+    for(unsigned i=0;i<test_instances;i++) {
+      QProcess *proc=new QProcess(this);
+      proc->setReadChannelMode(QProcess::ForwardedChannels);
+      QStringList args;
+      args.push_back(test_script);
+      args.push_back("127.0.0.1");
+      args.push_back(QString().sprintf("%u",test_server->serverPort()));
+      args.push_back(test_config);
+      proc->start(RD_PYPAD_PYTHON_PATH,args);
+      procs.push_back(proc);
+    }
+  }
+
+  //
+  // Wait for them to connect and, when hosted, to report in
+  //
+  while(((unsigned)test_connections.size()<(unsigned)procs.size())||
+	(hosted&&((started+failed)<test_instances))) {
+    if((Now()-start)>(1000*(uint64_t)PYPAD_HOST_TEST_TIMEOUT)) {
+      printf("  timed out waiting for instances to start\n");
+      Stop(&procs);
+      return ret;
+    }
+    Wait(10);
+    if(hosted) {
+      for(int i=0;i<procs.size();i++) {
+	while(procs.at(i)->canReadLine()) {
+	  QString line=QString::fromUtf8(procs.at(i)->readLine()).trimmed();
+	  if(line.startsWith("STARTED\t")) {
+	    started++;
+	  }
+	  if(line.startsWith("FAILED\t")) {
+	    printf("  %s\n",(const char *)line.toUtf8());
+	    failed++;
+	  }
+	}
+      }
+    }
+  }
+  ret.startup_secs=(double)(Now()-start)/1000000.0;
+  if(failed>0) {
+    Stop(&procs);
+    return ret;
+  }
+
+  //
+  // Give per-process instances time to finish starting up, then take the
+  // baseline
+  //
+  Wait(1000);
+  ret.processes=procs.size();
+  for(int i=0;i<procs.size();i++) {
+    ticks+=CpuTicks(procs.at(i)->pid());
+  }
+
+  //
+  // Send the updates
+  //
+  start=Now();
+  for(unsigned i=0;i<test_updates;i++) {
+    QByteArray data=Update(i).toUtf8();
+    for(int j=0;j<test_connections.size();j++) {
+      test_connections.at(j)->write(data);
+    }
+    Wait(0);
+  }
+  while(test_received<(test_instances*test_updates)) {
+    if((Now()-start)>(1000*(uint64_t)PYPAD_HOST_TEST_TIMEOUT)) {
+      printf("  timed out waiting for updates\n");
+      break;
+    }
+    Wait(10);
+  }
+  ret.update_secs=(double)(Now()-start)/1000000.0;
+  Wait(500);
+  ret.received=test_received;
+
+  //
+  // Measure
+  //
+  uint64_t end_ticks=0;
+  for(int i=0;i<procs.size();i++) {
+    end_ticks+=CpuTicks(procs.at(i)->pid());
+    ret.rss_kb+=Rss(procs.at(i)->pid());
+  }
+  ret.cpu_secs=(double)(end_ticks-ticks)/(double)sysconf(_SC_CLK_TCK);
+  ret.ok=true;
+
+  Stop(&procs);
+
+  return ret;
+}
+
+
+void MainObject::Stop(QList<QProcess *> *procs)
+{
+  for(int i=0;i<procs->size();i++) {
+    procs->at(i)->closeWriteChannel();
+    procs->at(i)->terminate();
+  }
+  for(int i=0;i<procs->size();i++) {
+    if(!procs->at(i)->waitForFinished(5000)) {
+      procs->at(i)->kill();
+      procs->at(i)->waitForFinished(5000);
+    }
+    delete procs->at(i);
+  }
+  procs->clear();
+  for(int i=0;i<test_connections.size();i++) {
+    test_connections.at(i)->deleteLater();
+  }
+  test_connections.clear();
+}
+
+
+void MainObject::Wait(int msecs)
+{
+  QEventLoop loop;
+
+  QTimer::singleShot(msecs,&loop,SLOT(quit()));
+  loop.exec();
+}
+
+
+QString MainObject::Update(unsigned n) const
+{
+  QString ret;
+
+  //
+  // As sent by RDLogPlay, with only those fields that are meaningful here
+  //
+  ret+="{\r\n";
+  ret+="    \"padUpdate\": {\r\n";
+  ret+=RDJsonField("dateTime",QDateTime::currentDateTime(),8);
+  ret+=RDJsonField("hostName",QString("pypad_host_test"),8);
+  ret+=RDJsonField("shortHostName",QString("pypad_host_test"),8);
+  ret+=RDJsonField("machine",1,8);
+  ret+=RDJsonField("onairFlag",false,8);
+  ret+=RDJsonField("mode",QString("Automatic"),8);
+  ret+=RDJsonNullField("service",8);
+  ret+="        \"log\": {\r\n";
+  ret+=RDJsonField("name",QString("pypad_host_test"),12,true);
+  ret+="        },\r\n";
+  for(int i=0;i<2;i++) {
+    ret+=QString("        \"")+((i==0)?"now":"next")+"\": {\r\n";
+    ret+=RDJsonNullField("startDateTime",12);
+    ret+=RDJsonField("lineNumber",(int)n+i,12);
+    ret+=RDJsonField("lineId",(int)n+i,12);
+    ret+=RDJsonField("cartNumber",(unsigned)(1+n+i),12);
+    ret+=RDJsonField("cartType",QString("Audio"),12);
+    ret+=RDJsonField("cutNumber",1,12);
+    ret+=RDJsonField("length",180000,12);
+    ret+=RDJsonNullField("year",12);
+    ret+=RDJsonField("groupName",QString("MUSIC"),12);
+    ret+=RDJsonField("title",QString().sprintf("Title %u",n+i),12);
+    ret+=RDJsonField("artist",QString().sprintf("Artist %u",n+i),12);
+    ret+=RDJsonField("publisher",QString(),12);
+    ret+=RDJsonField("composer",QString(),12);
+    ret+=RDJsonField("album",QString(),12);
+    ret+=RDJsonField("label",QString(),12);
+    ret+=RDJsonField("client",QString(),12);
+    ret+=RDJsonField("agency",QString(),12);
+    ret+=RDJsonField("conductor",QString(),12);
+    ret+=RDJsonField("userDefined",QString(),12);
+    ret+=RDJsonField("songId",QString(),12);
+    ret+=RDJsonField("outcue",QString(),12);
+    ret+=RDJsonField("description",QString(),12);
+    ret+=RDJsonField("isrc",QString(),12);
+    ret+=RDJsonField("isci",QString(),12);
+    ret+=RDJsonField("recordingMbId",QString(),12);
+    ret+=RDJsonField("releaseMbId",QString(),12);
+    ret+=RDJsonField("externalEventId",QString(),12);
+    ret+=RDJsonField("externalData",QString(),12);
+    ret+=RDJsonField("externalAnncType",QString(),12,true);
+    ret+=QString("        }")+((i==0)?",":"")+"\r\n";
+  }
+  ret+="    }\r\n";
+  ret+="}\r\n\r\n";
+
+  return ret;
+}
+
+
+uint64_t MainObject::Rss(pid_t pid)
+{
+  uint64_t ret=0;
+  QFile file(QString().sprintf("/proc/%d/status",pid));
+
+  if(file.open(QIODevice::ReadOnly)) {
+    QStringList lines=QString(file.readAll()).split("\n");
+    for(int i=0;i<lines.size();i++) {
+      if(lines.at(i).startsWith("VmRSS:")) {
+	ret=lines.at(i).mid(6).trimmed().split(" ").at(0).toULongLong();
+      }
+    }
+  }
+
+  return ret;
+}
+
+
+uint64_t MainObject::CpuTicks(pid_t pid)
+{
+  QFile file(QString().sprintf("/proc/%d/stat",pid));
+
+  if(!file.open(QIODevice::ReadOnly)) {
+    return 0;
+  }
+
+  //
+  // utime and stime are the 12th and 13th fields after the command name
+  //
+  QString str(file.readAll());
+  QStringList f0=str.mid(str.lastIndexOf(")")+2).split(" ");
+  if(f0.size()<13) {
+    return 0;
+  }
+
+  return f0.at(11).toULongLong()+f0.at(12).toULongLong();
+}
+
+
+uint64_t MainObject::Now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return 1000000*(uint64_t)ts.tv_sec+(uint64_t)ts.tv_nsec/1000;
+}
+
+
+int main(int argc,char *argv[])
+{
+  QCoreApplication a(argc,argv);
+  new MainObject();
+  return a.exec();
+}
@@ -0,0 +1,77 @@
+// pypad_host_test.h
+//
+// Compare PyPAD instances run one per process with hosted instances
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef PYPAD_HOST_TEST_H
+#define PYPAD_HOST_TEST_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <QList>
+#include <QObject>
+#include <QProcess>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QUdpSocket>
+
+#define PYPAD_HOST_TEST_USAGE "[options]\n\nStart a number of instances of a PyPAD script, first as one Python\nprocess per instance and then loaded into shared pypad_host interpreters,\nfeed each set the same PAD updates from a simulated rdpadd(8) and compare\nmemory use, CPU time and delivery. The script must send a UDP datagram\nfor each update, as pypad_udp.py does. Does not require a running\nRivendell system, but /etc/rd.conf must exist.\n\nOptions are:\n--script=<path>\n     PyPAD script to run. Default is pypad_udp.py in the PyPAD script\n     directory.\n\n--instances=<num>\n     Number of script instances to start. Default is 20.\n\n--updates=<num>\n     Number of PAD updates to send. Default is 100.\n\n--per-host=<num>\n     Number of instances loaded into each shared interpreter. Default is\n     the value of --instances.\n\n"
+
+class MainObject : public QObject
+{
+  Q_OBJECT
+ public:
+  MainObject(QObject *parent=0);
+
+ private slots:
+  void newConnectionData();
+  void readyReadData();
+
+ private:
+  class Result
+  {
+   public:
+    bool ok;
+    unsigned processes;
+    uint64_t rss_kb;
+    double startup_secs;
+    double cpu_secs;
+    double update_secs;
+    unsigned received;
+  };
+  Result Run(bool hosted);
+  void Stop(QList<QProcess *> *procs);
+  void Wait(int msecs);
+  QString Update(unsigned n) const;
+  static uint64_t Rss(pid_t pid);
+  static uint64_t CpuTicks(pid_t pid);
+  static uint64_t Now();
+  QString test_script;
+  QString test_config;
+  unsigned test_instances;
+  unsigned test_updates;
+  unsigned test_per_host;
+  QTcpServer *test_server;
+  QList<QTcpSocket *> test_connections;
+  QUdpSocket *test_udp_socket;
+  unsigned test_received;
+};
+
+
+#endif  // PYPAD_HOST_TEST_H
@@ -0,0 +1,382 @@
+// report_filter_test.cpp
+//
+// Compare report filter output between the ELR mixdown methods
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <QApplication>
+#include <QDir>
+#include <QFile>
+#include <QTime>
+
+#include <rd.h>
+#include <rdapplication.h>
+#include <rddb.h>
+#include <rdescape_string.h>
+#include <rdlog_line.h>
+
+#include "report_filter_test.h"
+
+MainObject::MainObject(QObject *parent)
+  :QObject(parent)
+{
+  QString err_msg;
+  QString report_name;
+  unsigned fixture_rows=0;
+  unsigned seed=time(NULL);
+  bool ok=false;
+  unsigned errors=0;
+  QString out_path;
+  uint64_t set_msecs=0;
+  uint64_t row_msecs=0;
+  QTime timer;
+
+  test_start_date=QDate::currentDate().addDays(-1);
+
+  rda=new RDApplication("report_filter_test","report_filter_test",
+			REPORT_FILTER_TEST_USAGE,this);
+  if(!rda->open(&err_msg)) {
+    fprintf(stderr,"report_filter_test: %s\n",(const char *)err_msg);
+    exit(1);
+  }
+
+  for(unsigned i=0;i<rda->cmdSwitch()->keys();i++) {
+    if(rda->cmdSwitch()->key(i)=="--report") {
+      report_name=rda->cmdSwitch()->value(i);
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--start-date") {
+      test_start_date=
+	QDate::fromString(rda->cmdSwitch()->value(i),"yyyy-MM-dd");
+      if(!test_start_date.isValid()) {
+	fprintf(stderr,"report_filter_test: invalid --start-date\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--end-date") {
+      test_end_date=
+	QDate::fromString(rda->cmdSwitch()->value(i),"yyyy-MM-dd");
+      if(!test_end_date.isValid()) {
+	fprintf(stderr,"report_filter_test: invalid --end-date\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--fixture-rows") {
+      fixture_rows=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if(!ok) {
+	fprintf(stderr,"report_filter_test: invalid --fixture-rows\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--seed") {
+      seed=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if(!ok) {
+	fprintf(stderr,"report_filter_test: invalid --seed\n");
+	exit(1);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(!rda->cmdSwitch()->processed(i)) {
+      fprintf(stderr,"report_filter_test: unknown command option \"%s\"\n",
+	      (const char *)rda->cmdSwitch()->key(i));
+      exit(2);
+    }
+  }
+
+  //
+  // Sanity Checks
+  //
+  if(report_name.isEmpty()) {
+    fprintf(stderr,"report_filter_test: you must specify --report\n");
+    exit(1);
+  }
+  if(!test_end_date.isValid()) {
+    test_end_date=test_start_date;
+  }
+  if(test_end_date<test_start_date) {
+    fprintf(stderr,
+	    "report_filter_test: --end-date is before --start-date\n");
+    exit(1);
+  }
+  test_report=new RDReport(report_name,rda->station(),rda->config());
+  if(!test_report->exists()) {
+    fprintf(stderr,"report_filter_test: no such report \"%s\"\n",
+	    (const char *)report_name.toUtf8());
+    exit(1);
+  }
+  QString tempdir=QDir::tempPath()+
+    QString().sprintf("/report_filter_test-%d",getpid());
+  if(!QDir().mkpath(tempdir)) {
+    fprintf(stderr,"report_filter_test: unable to create \"%s\"\n",
+	    (const char *)tempdir.toUtf8());
+    exit(1);
+  }
+  printf("report_filter_test: report \"%s\", %s - %s, seed %u\n",
+	 (const char *)report_name.toUtf8(),
+	 (const char *)test_start_date.toString("yyyy-MM-dd").toUtf8(),
+	 (const char *)test_end_date.toString("yyyy-MM-dd").toUtf8(),seed);
+  srandom(seed);
+
+  //
+  // Save the Report Settings
+  //
+  RDReport::ExportFilter saved_filter=test_report->filter();
+  QString saved_path=test_report->exportPath(RDReport::Linux);
+  QString saved_cmd=test_report->postExportCommand(RDReport::Linux);
+  test_report->setPostExportCommand(RDReport::Linux,"");
+  AddFixtures(fixture_rows);
+
+  //
+  // Run the Test
+  //
+  for(int i=0;i<RDReport::LastFilter;i++) {
+    RDReport::ExportFilter filter=(RDReport::ExportFilter)i;
+    QString set_name=tempdir+QString().sprintf("/%02d-set.txt",i);
+    QString row_name=tempdir+QString().sprintf("/%02d-row.txt",i);
+    test_report->setFilter(filter);
+
+    test_report->setExportPath(RDReport::Linux,row_name);
+    test_report->setMixdownMethod(RDReport::RowMixdown);
+    timer.start();
+    bool row_ok=test_report->generateReport(test_start_date,test_end_date,
+					    rda->station(),&out_path);
+    row_msecs+=timer.elapsed();
+
+    test_report->setExportPath(RDReport::Linux,set_name);
+    test_report->setMixdownMethod(RDReport::SetMixdown);
+    timer.start();
+    bool set_ok=test_report->generateReport(test_start_date,test_end_date,
+					    rda->station(),&out_path);
+    set_msecs+=timer.elapsed();
+
+    printf("  %-48s ",(const char *)RDReport::filterText(filter).toUtf8());
+    if(row_ok!=set_ok) {
+      printf("FAILED: generateReport() returned %d, original returned %d\n",
+	     set_ok,row_ok);
+      errors++;
+    }
+    else {
+      if(!row_ok) {
+	printf("skipped\n");
+      }
+      else {
+	if(Compare(row_name,set_name,&err_msg)) {
+	  printf("identical\n");
+	}
+	else {
+	  printf("FAILED: %s\n",(const char *)err_msg.toUtf8());
+	  errors++;
+	}
+      }
+    }
+    unlink(set_name.toUtf8());
+    unlink(row_name.toUtf8());
+  }
+  printf("mixdown time: set-based: %lu mS  row-by-row: %lu mS\n",
+	 (unsigned long)set_msecs,(unsigned long)row_msecs);
+
+  //
+  // Clean Up
+  //
+  RemoveFixtures();
+  test_report->setFilter(saved_filter);
+  test_report->setExportPath(RDReport::Linux,saved_path);
+  test_report->setPostExportCommand(RDReport::Linux,saved_cmd);
+  QDir().rmdir(tempdir);
+
+  if(errors>0) {
+    printf("FAILED: %u filter(s) differ [seed: %u]\n",errors,seed);
+    exit(1);
+  }
+  printf("PASSED\n");
+  exit(0);
+}
+
+
+void MainObject::AddFixtures(unsigned rows)
+{
+  QString sql;
+  RDSqlQuery *q=NULL;
+  QStringList svcs;
+  QStringList stations;
+  QList<unsigned> carts;
+  const int sources[]={RDLogLine::Manual,RDLogLine::Traffic,
+		       RDLogLine::Music,RDLogLine::Template};
+
+  if(rows==0) {
+    return;
+  }
+  sql=QString("select SERVICE_NAME from REPORT_SERVICES where ")+
+    "REPORT_NAME=\""+RDEscapeString(test_report->name())+"\"";
+  q=new RDSqlQuery(sql);
+  while(q->next()) {
+    svcs.push_back(q->value(0).toString());
+  }
+  delete q;
+  sql=QString("select STATION_NAME from REPORT_STATIONS where ")+
+    "REPORT_NAME=\""+RDEscapeString(test_report->name())+"\"";
+  q=new RDSqlQuery(sql);
+  while(q->next()) {
+    stations.push_back(q->value(0).toString());
+  }
+  delete q;
+  if(stations.size()==0) {
+    stations.push_back(rda->station()->name());
+  }
+  q=new RDSqlQuery("select NUMBER from CART order by rand() limit 1000");
+  while(q->next()) {
+    carts.push_back(q->value(0).toUInt());
+  }
+  delete q;
+  carts.push_back(RD_MAX_CART_NUMBER);  // Nonexistent cart
+
+  int secs=86400*(1+test_start_date.daysTo(test_end_date));
+  for(int i=0;i<svcs.size();i++) {
+    for(unsigned j=0;j<rows;j++) {
+      QDateTime dt=QDateTime(test_start_date,QTime(0,0,0)).
+	addSecs(random()%secs);
+      sql=QString("insert into ELR_LINES set ")+
+	"SERVICE_NAME=\""+RDEscapeString(svcs.at(i))+"\","+
+	"EVENT_DATETIME=\""+dt.toString("yyyy-MM-dd hh:mm:ss")+"\","+
+	"STATION_NAME=\""+
+	RDEscapeString(stations.at(random()%stations.size()))+"\","+
+	QString().sprintf("CART_NUMBER=%u,",carts.at(random()%carts.size()))+
+	QString().sprintf("CUT_NUMBER=%ld,",1+random()%5)+
+	QString().sprintf("LENGTH=%ld,",random()%600000)+
+	QString().sprintf("EVENT_SOURCE=%d,",sources[random()%4])+
+	QString().sprintf("START_SOURCE=%ld,",random()%4)+
+	QString().sprintf("PLAY_SOURCE=%ld,",random()%3)+
+	QString().sprintf("USAGE_CODE=%ld,",random()%6)+
+	"ONAIR_FLAG=\""+(((random()%4)==0)?"N":"Y")+"\","+
+	"LOG_NAME=\""+RDEscapeString(Text())+"\","+
+	"TITLE=\""+RDEscapeString(Text())+"\","+
+	"ARTIST=\""+RDEscapeString(Text())+"\","+
+	"ALBUM=\""+RDEscapeString(Text())+"\","+
+	"LABEL=\""+RDEscapeString(Text())+"\","+
+	"COMPOSER=\""+RDEscapeString(Text())+"\","+
+	"PUBLISHER=\""+RDEscapeString(Text())+"\","+
+	"CONDUCTOR=\""+RDEscapeString(Text())+"\","+
+	"USER_DEFINED=\""+RDEscapeString(Text())+"\","+
+	"SONG_ID=\""+RDEscapeString(Text().left(32))+"\","+
+	"DESCRIPTION=\""+RDEscapeString(Text())+"\","+
+	"OUTCUE=\""+RDEscapeString(Text())+"\","+
+	QString().sprintf("ISRC=\"USRV1%07ld\",",random()%10000000);
+      if((random()%3)==0) {
+	sql+=QString().sprintf("EXT_START_TIME=\"%02ld:%02ld:%02ld\",",
+			       random()%24,random()%60,random()%60)+
+	  QString().sprintf("EXT_LENGTH=%ld,",random()%600000)+
+	  QString().sprintf("EXT_CART_NAME=\"%06ld\",",random()%1000000)+
+	  QString().sprintf("EXT_DATA=\"%ld\",",random())+
+	  QString().sprintf("EXT_EVENT_ID=\"%ld\",",random()%100000)+
+	  "EXT_ANNC_TYPE=\"C\",";
+      }
+      sql+=QString().sprintf("EVENT_TYPE=%ld",random()%3);
+      if(RDSqlQuery::apply(sql)) {
+	test_fixture_ids.
+	  push_back(RDSqlQuery::run("select LAST_INSERT_ID()").toUInt());
+      }
+    }
+  }
+  printf("added %d fixture rows\n",test_fixture_ids.size());
+}
+
+
+void MainObject::RemoveFixtures()
+{
+  for(int i=0;i<test_fixture_ids.size();i++) {
+    RDSqlQuery::apply("delete from ELR_LINES where ID=?",
+		      QList<QVariant>()<<test_fixture_ids.at(i));
+  }
+  test_fixture_ids.clear();
+}
+
+
+QString MainObject::Text() const
+{
+  //
+  // Mostly plain words, with empty values and characters that need
+  // escaping thrown in
+  //
+  const char *words[]={"Alpha","bravo","Charlie's","\"delta\"","echo\\",
+		       "Fox-trot","golf,","HOTEL","india;","Juliett"};
+  QString ret;
+
+  switch(random()%8) {
+  case 0:
+    return QString();
+
+  case 1:
+    return QString::fromUtf8("Caf\xc3\xa9 M\xc3\xbcller");
+  }
+  for(int i=1+random()%4;i>0;i--) {
+    ret+=QString(words[random()%10])+" ";
+  }
+  return ret.trimmed();
+}
+
+
+bool MainObject::Compare(const QString &name1,const QString &name2,
+			 QString *err_msg) const
+{
+  QFile file1(name1);
+  QFile file2(name2);
+
+  if(!file1.open(QIODevice::ReadOnly)) {
+    *err_msg=QString("unable to open \"")+name1+"\"";
+    return false;
+  }
+  if(!file2.open(QIODevice::ReadOnly)) {
+    *err_msg=QString("unable to open \"")+name2+"\"";
+    return false;
+  }
+  QByteArray data1=file1.readAll();
+  QByteArray data2=file2.readAll();
+  if(data1==data2) {
+    return true;
+  }
+  int line=1;
+  int len=(data1.size()<data2.size())?data1.size():data2.size();
+  for(int i=0;i<len;i++) {
+    if(data1.at(i)!=data2.at(i)) {
+      break;
+    }
+    if(data1.at(i)=='\n') {
+      line++;
+    }
+  }
+  *err_msg=QString().sprintf("output differs at line %d (%d/%d bytes)",
+			     line,data2.size(),data1.size());
+
+  return false;
+}
+
+
+int main(int argc,char *argv[])
+{
+  QApplication a(argc,argv,false);
+  new MainObject();
+  return a.exec();
+}
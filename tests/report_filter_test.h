@@ -0,0 +1,51 @@
+// report_filter_test.h
+//
+// Compare report filter output between the ELR mixdown methods
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef REPORT_FILTER_TEST_H
+#define REPORT_FILTER_TEST_H
+
+#include <QDate>
+#include <QList>
+#include <QObject>
+#include <QStringList>
+
+#include <rdreport.h>
+
+#define REPORT_FILTER_TEST_USAGE "[options]\n\nGenerate the specified report with every export filter, once using the\nset-based ELR mixdown and once using the original row-by-row mixdown,\nand check that the output files are byte-for-byte identical.\nTHE EXPORT FILTER, EXPORT PATH AND POST-EXPORT COMMAND OF THE REPORT ARE\nMODIFIED DURING THE TEST AND RESTORED AFTERWARD.\n\nOptions are:\n--report=<name>\n     Report to generate.\n\n--start-date=<yyyy-MM-dd>\n     First day of the report. Default is yesterday.\n\n--end-date=<yyyy-MM-dd>\n     Last day of the report. Default is the start date.\n\n--fixture-rows=<num>\n     Add <num> synthetic ELR lines to each of the report's services\n     within the report dates, removing them afterward. Default is 0.\n\n--seed=<num>\n     Random number seed for the fixture rows.\n\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  void AddFixtures(unsigned rows);
+  void RemoveFixtures();
+  QString Text() const;
+  bool Compare(const QString &name1,const QString &name2,
+	       QString *err_msg) const;
+  RDReport *test_report;
+  QDate test_start_date;
+  QDate test_end_date;
+  QList<unsigned> test_fixture_ids;
+};
+
+
+#endif  // REPORT_FILTER_TEST_H
@@ -0,0 +1,251 @@
+// time_engine_test.cpp
+//
+// Test and benchmark the RDTimeEngine class
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <vector>
+
+#include <qapplication.h>
+#include <qtimer.h>
+
+#include <rdcmd_switch.h>
+
+#include "time_engine_test.h"
+
+MainObject::MainObject(QObject *parent)
+  : QObject(parent)
+{
+  int events=100000;
+  int live_events=1000;
+  int live_times=20;
+  int spread=2000;
+  unsigned seed=time(NULL);
+  bool ok=false;
+
+  test_max_lateness=0;
+  test_pass=true;
+
+  RDCmdSwitch *cmd=new RDCmdSwitch(qApp->argc(),qApp->argv(),
+				   "time_engine_test",TIME_ENGINE_TEST_USAGE);
+  for(unsigned i=0;i<cmd->keys();i++) {
+    if(cmd->key(i)=="--events") {
+      events=cmd->value(i).toInt(&ok);
+      if((!ok)||(events<=0)) {
+	fprintf(stderr,"time_engine_test: invalid --events\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--live-events") {
+      live_events=cmd->value(i).toInt(&ok);
+      if((!ok)||(live_events<=0)) {
+	fprintf(stderr,"time_engine_test: invalid --live-events\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--live-times") {
+      live_times=cmd->value(i).toInt(&ok);
+      if((!ok)||(live_times<=0)) {
+	fprintf(stderr,"time_engine_test: invalid --live-times\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--spread") {
+      spread=cmd->value(i).toInt(&ok);
+      if((!ok)||(spread<=0)) {
+	fprintf(stderr,"time_engine_test: invalid --spread\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--seed") {
+      seed=cmd->value(i).toUInt(&ok);
+      if(!ok) {
+	fprintf(stderr,"time_engine_test: invalid --seed\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(!cmd->processed(i)) {
+      fprintf(stderr,"time_engine_test: unrecognized option \"%s\"\n",
+	      cmd->key(i).toUtf8().constData());
+      exit(1);
+    }
+  }
+  srandom(seed);
+  printf("seed: %u\n",seed);
+
+  Benchmark(events);
+
+  //
+  // Live Check -- schedule events sharing a small number of times, a
+  // second or so from now.
+  //
+  test_engine=new RDTimeEngine(this);
+  connect(test_engine,SIGNAL(timeout(int)),this,SLOT(timeoutData(int)));
+  QTime base=QTime::currentTime().addMSecs(1000);
+  uint64_t now=Now();
+  std::vector<int> offsets;
+  for(int i=0;i<live_times;i++) {
+    offsets.push_back(random()%spread);
+  }
+  for(int i=0;i<live_events;i++) {
+    int offset=offsets[random()%offsets.size()];
+    test_engine->addEvent(i,base.addMSecs(offset));
+    test_deadlines[i]=now+1000+offset;
+  }
+  printf("live check: %d events at %d times over %d mS\n",
+	 live_events,live_times,spread);
+  QTimer::singleShot(1000+spread+2000,this,SLOT(finishedData()));
+}
+
+
+void MainObject::timeoutData(int id)
+{
+  uint64_t now=Now();
+
+  if(test_deadlines.find(id)==test_deadlines.end()) {
+    printf("  FAILED: unknown event %d fired\n",id);
+    test_pass=false;
+    return;
+  }
+  test_fired[id]++;
+  test_batches[now]++;
+  if((now>test_deadlines[id])&&
+     ((now-test_deadlines[id])>test_max_lateness)) {
+    test_max_lateness=now-test_deadlines[id];
+  }
+}
+
+
+void MainObject::finishedData()
+{
+  unsigned fired=0;
+
+  for(std::map<int,uint64_t>::const_iterator it=test_deadlines.begin();
+      it!=test_deadlines.end();it++) {
+    if(test_fired[it->first]!=1) {
+      printf("  FAILED: event %d fired %d times\n",
+	     it->first,test_fired[it->first]);
+      test_pass=false;
+    }
+    fired+=test_fired[it->first];
+  }
+  printf("  %u events fired in %lu wakeups, maximum lateness: %lu mS\n",
+	 fired,(unsigned long)test_batches.size(),
+	 (unsigned long)test_max_lateness);
+  if(!test_pass) {
+    printf("FAILED\n");
+    exit(1);
+  }
+  printf("PASSED\n");
+  exit(0);
+}
+
+
+void MainObject::Benchmark(int events)
+{
+  RDTimeEngine *engine=new RDTimeEngine(this);
+  std::vector<QTime> times;
+  uint64_t start;
+  int msecs=QTime(0,0,0).msecsTo(QTime::currentTime());
+  int first=86400001;
+  int first_id=-1;
+
+  //
+  // Schedule all events on one day, avoiding the next few seconds so that
+  // none fire during the run.
+  //
+  for(int i=0;i<events;i++) {
+    times.push_back(QTime(0,0,0).
+		    addMSecs((msecs+10000+random()%86000000)%86400000));
+    int diff=(QTime(0,0,0).msecsTo(times.back())-msecs+86400000)%86400000;
+    if(diff<first) {
+      first=diff;
+      first_id=i;
+    }
+  }
+
+  printf("benchmark: %d events\n",events);
+  start=Now();
+  for(int i=0;i<events;i++) {
+    engine->addEvent(i,times[i]);
+  }
+  printf("  add:    %8lu mS\n",(unsigned long)(Now()-start));
+  if((int)engine->size()!=events) {
+    printf("  FAILED: %u events scheduled\n",engine->size());
+    test_pass=false;
+  }
+  if(engine->event(engine->next())!=times[first_id]) {
+    printf("  FAILED: next event is %d, expected %d\n",
+	   engine->next(),first_id);
+    test_pass=false;
+  }
+
+  start=Now();
+  for(int i=0;i<events;i++) {
+    if(engine->event(i)!=times[i]) {
+      printf("  FAILED: event %d has the wrong time\n",i);
+      test_pass=false;
+      break;
+    }
+  }
+  printf("  lookup: %8lu mS\n",(unsigned long)(Now()-start));
+
+  start=Now();
+  for(int i=0;i<events;i++) {
+    engine->addEvent(i,times[(i+1)%events]);
+  }
+  printf("  move:   %8lu mS\n",(unsigned long)(Now()-start));
+
+  start=Now();
+  for(int i=0;i<events;i++) {
+    engine->removeEvent(i);
+  }
+  printf("  remove: %8lu mS\n",(unsigned long)(Now()-start));
+  if((engine->size()!=0)||(engine->next()!=-1)) {
+    printf("  FAILED: events remain after removal\n");
+    test_pass=false;
+  }
+
+  delete engine;
+}
+
+
+uint64_t MainObject::Now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return 1000*(uint64_t)ts.tv_sec+(uint64_t)ts.tv_nsec/1000000;
+}
+
+
+int main(int argc,char *argv[])
+{
+  QApplication a(argc,argv,false);
+  new MainObject();
+  return a.exec();
+}
@@ -0,0 +1,56 @@
+// time_engine_test.h
+//
+// Test and benchmark the RDTimeEngine class
+//
+//   (C) Copyright 2026 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef TIME_ENGINE_TEST_H
+#define TIME_ENGINE_TEST_H
+
+#include <stdint.h>
+
+#include <map>
+
+#include <qobject.h>
+
+#include <rdtimeengine.h>
+
+#define TIME_ENGINE_TEST_USAGE "[options]\n\nBenchmark scheduling operations of RDTimeEngine, then check the firing\nof a group of live events.\n\nOptions are:\n--events=<num>\n     Number of events used for the scheduling benchmark. Default is\n     100000.\n\n--live-events=<num>\n     Number of events scheduled to fire in the live check. Default is\n     1000.\n\n--live-times=<num>\n     Number of distinct times shared by the live events. Default is 20.\n\n--spread=<msecs>\n     Interval over which the live events are spread. Default is 2000.\n\n--seed=<num>\n     Random number seed.\n\n"
+
+class MainObject : public QObject
+{
+  Q_OBJECT;
+ public:
+  MainObject(QObject *parent=0);
+
+ private slots:
+  void timeoutData(int id);
+  void finishedData();
+
+ private:
+  void Benchmark(int events);
+  static uint64_t Now();
+  RDTimeEngine *test_engine;
+  std::map<int,uint64_t> test_deadlines;
+  std::map<int,int> test_fired;
+  std::map<uint64_t,int> test_batches;
+  uint64_t test_max_lateness;
+  bool test_pass;
+};
+
+
+#endif  // TIME_ENGINE_TEST_H
@@ -2,7 +2,7 @@
 //
 // Check Rivendell Cuts for Valid Audio
 //
-//   (C) Copyright 2012-2018 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2012-2018,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -18,27 +18,134 @@
 //   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 //
 
+#include <errno.h>
+#include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 #include <qapplication.h>
+#include <qstringlist.h>
 
 #include <rdapplication.h>
 #include <rdaudioinfo.h>
-#include <rdcart.h>
 #include <rdcut.h>
 #include <rddb.h>
+#include <rdescape_string.h>
+#include <rdhash.h>
+#include <rdwavefile.h>
 
 #include <rdcheckcuts.h>
 
+//
+// A cut to check, with the values needed for the report
+//
+class CheckCut
+{
+ public:
+  QString cut_name;
+  unsigned cart_number;
+  int end_point;
+  QString description;
+  QString title;
+  int coding_format;
+  unsigned sample_rate;
+  unsigned channels;
+  QString sha1_hash;
+  bool missing;
+  QStringList mismatches;
+};
+
+
+//
+// Shared state for the threads checking the audio store
+//
+class CheckQueue
+{
+ public:
+  std::vector<CheckCut> *cuts;
+  unsigned next;
+  bool verify;
+  bool verify_hash;
+  pthread_mutex_t mutex;
+};
+
+
+void __CheckAudio(CheckCut *cut,bool verify,bool verify_hash)
+{
+  QString filename=RDCut::pathName(cut->cut_name);
+  bool format_ok=false;
+
+  RDWaveFile *wave=new RDWaveFile(filename);
+  if(!wave->openWave()) {
+    cut->missing=true;
+    delete wave;
+    return;
+  }
+  cut->missing=false;
+  if(verify) {
+    switch(wave->getFormatTag()) {
+    case WAVE_FORMAT_PCM:
+      format_ok=cut->coding_format==0;
+      break;
+
+    case WAVE_FORMAT_MPEG:
+      format_ok=cut->coding_format==1;
+      break;
+    }
+    if(!format_ok) {
+      cut->mismatches.push_back("format");
+    }
+    if(wave->getSamplesPerSec()!=cut->sample_rate) {
+      cut->mismatches.push_back("sample rate");
+    }
+    if(wave->getChannels()!=cut->channels) {
+      cut->mismatches.push_back("channels");
+    }
+    if(cut->end_point>
+       ((int)wave->getExtTimeLength()+RDCHECKCUTS_LENGTH_TOLERANCE)) {
+      cut->mismatches.push_back("length");
+    }
+  }
+  wave->closeWave();
+  delete wave;
+  if(verify_hash&&(!cut->sha1_hash.isEmpty())&&
+     (RDSha1Hash(filename)!=cut->sha1_hash)) {
+    cut->mismatches.push_back("SHA1 hash");
+  }
+}
+
+
+void *__CheckThreadCallback(void *priv)
+{
+  CheckQueue *queue=(CheckQueue *)priv;
+  unsigned n;
+
+  while(1) {
+    pthread_mutex_lock(&queue->mutex);
+    n=queue->next++;
+    pthread_mutex_unlock(&queue->mutex);
+    if(n>=queue->cuts->size()) {
+      return NULL;
+    }
+    __CheckAudio(&queue->cuts->at(n),queue->verify,queue->verify_hash);
+  }
+  return NULL;
+}
+
+
 MainObject::MainObject(QObject *parent)
   : QObject(parent)
 {
   std::vector<QString> group_names;
-  std::vector<QString> bad_cuts;
+  std::vector<CheckCut> cuts;
   QString sql;
   RDSqlQuery *q;
   QString err_msg;
-  
+
+  check_verify=false;
+  check_verify_hash=false;
+
   //
   // Open the Database
   //
@@ -56,6 +163,14 @@ MainObject::MainObject(QObject *parent)
       group_names.push_back(rda->cmdSwitch()->value(i));
       rda->cmdSwitch()->setProcessed(i,true);
     }
+    if(rda->cmdSwitch()->key(i)=="--verify") {
+      check_verify=true;
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--verify-hash") {
+      check_verify_hash=true;
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
     if(!rda->cmdSwitch()->processed(i)) {
       fprintf(stderr,"rdcheckcuts: unknown command option \"%s\"\n",
 	      (const char *)rda->cmdSwitch()->key(i));
@@ -64,89 +179,148 @@ MainObject::MainObject(QObject *parent)
   }
 
   //
-  // Build Group List
+  // Load all of the cuts to check, in group order
   //
+  sql=QString("select ")+
+    "CUTS.CUT_NAME,"+       // 00
+    "CUTS.CART_NUMBER,"+    // 01
+    "CUTS.END_POINT,"+      // 02
+    "CUTS.DESCRIPTION,"+    // 03
+    "CUTS.CODING_FORMAT,"+  // 04
+    "CUTS.SAMPLE_RATE,"+    // 05
+    "CUTS.CHANNELS,"+       // 06
+    "CUTS.SHA1_HASH,"+      // 07
+    "CART.TITLE "+          // 08
+    "from CUTS left join CART on CUTS.CART_NUMBER=CART.NUMBER "+
+    "where (CUTS.LENGTH>0)&&";
   if(group_names.size()==0) {
-    sql="select NAME from GROUPS order by NAME";
-    q=new RDSqlQuery(sql);
-    while(q->next()) {
-      group_names.push_back(q->value(0).toString());
+    sql+=QString("(CART.GROUP_NAME in (select NAME from GROUPS)) ")+
+      "order by CART.GROUP_NAME,";
+  }
+  else {
+    QString groups;
+    for(unsigned i=0;i<group_names.size();i++) {
+      groups+="\""+RDEscapeString(group_names[i])+"\",";
     }
-    delete q;
+    groups=groups.left(groups.length()-1);
+    sql+="(CART.GROUP_NAME in ("+groups+")) "+
+      "order by field(CART.GROUP_NAME,"+groups+"),";
   }
+  sql+="CUTS.CART_NUMBER,CUTS.CUT_NAME";
+  q=new RDSqlQuery(sql);
+  while(q->next()) {
+    cuts.push_back(CheckCut());
+    CheckCut *cut=&cuts.back();
+    cut->cut_name=q->value(0).toString();
+    cut->cart_number=q->value(1).toUInt();
+    cut->end_point=q->value(2).toInt();
+    cut->description=q->value(3).toString();
+    cut->coding_format=q->value(4).toInt();
+    cut->sample_rate=q->value(5).toUInt();
+    cut->channels=q->value(6).toUInt();
+    cut->sha1_hash=q->value(7).toString();
+    cut->title=q->value(8).toString();
+    cut->missing=true;
+  }
+  delete q;
 
   //
   // Scan Cuts
   //
-  for(unsigned i=0;i<group_names.size();i++) {
-    ValidateGroup(group_names[i],&bad_cuts);
+  if(access(rda->config()->audioRoot().toUtf8(),R_OK|X_OK)==0) {
+    CheckLocal(&cuts);
   }
+  CheckRemote(&cuts);
 
   //
   // Render Output
   //
-  for(unsigned i=0;i<bad_cuts.size();i++) {
-    RenderCut(bad_cuts[i]);
+  for(unsigned i=0;i<cuts.size();i++) {
+    RenderCut(cuts[i]);
   }
 
   exit(0);
 }
 
 
-void MainObject::RenderCut(const QString &cutname)
+void MainObject::RenderCut(const CheckCut &cut)
 {
-  RDCut *cut=new RDCut(cutname);
-  RDCart *cart=new RDCart(cut->cartNumber());
-
-  printf("Cut %03d [%s] in cart %06u [%s] is missing audio\n",
-	 cut->cutNumber(),
-	 (const char *)cut->description(),
-	 cart->number(),
-	 (const char *)cart->title());
-  delete cart;
-  delete cut;
+  if(cut.missing) {
+    printf("Cut %03d [%s] in cart %06u [%s] is missing audio\n",
+	   RDCut::cutNumber(cut.cut_name),
+	   (const char *)cut.description,
+	   cut.cart_number,
+	   (const char *)cut.title);
+    return;
+  }
+  if(cut.mismatches.size()>0) {
+    printf("Cut %03d [%s] in cart %06u [%s] does not match its audio [%s]\n",
+	   RDCut::cutNumber(cut.cut_name),
+	   (const char *)cut.description,
+	   cut.cart_number,
+	   (const char *)cut.title,
+	   (const char *)cut.mismatches.join(", "));
+  }
 }
 
 
-bool MainObject::ValidateGroup(const QString &groupname,
-			       std::vector<QString> *cutnames)
+void MainObject::CheckLocal(std::vector<CheckCut> *cuts)
+{
+  CheckQueue queue;
+  pthread_t threads[RDCHECKCUTS_MAX_THREADS];
+  unsigned thread_quan=cuts->size();
+
+  if(cuts->size()==0) {
+    return;
+  }
+
+  //
+  // The database is only accessed from here, not from the checking threads
+  //
+  queue.cuts=cuts;
+  queue.next=0;
+  queue.verify=check_verify;
+  queue.verify_hash=check_verify_hash;
+  pthread_mutex_init(&queue.mutex,NULL);
+
+  if(thread_quan>RDCHECKCUTS_MAX_THREADS) {
+    thread_quan=RDCHECKCUTS_MAX_THREADS;
+  }
+  for(unsigned i=0;i<thread_quan;i++) {
+    if(pthread_create(&threads[i],NULL,__CheckThreadCallback,&queue)!=0) {
+      fprintf(stderr,"rdcheckcuts: unable to start checking thread [%s]\n",
+	      strerror(errno));
+      thread_quan=i;
+      break;
+    }
+  }
+  if(thread_quan==0) {
+    __CheckThreadCallback(&queue);
+  }
+  for(unsigned i=0;i<thread_quan;i++) {
+    pthread_join(threads[i],NULL);
+  }
+  pthread_mutex_destroy(&queue.mutex);
+}
+
+
+void MainObject::CheckRemote(std::vector<CheckCut> *cuts)
 {
-  bool ret=true;
-  QString sql;
-  RDSqlQuery *q;
   RDAudioInfo *info=new RDAudioInfo(this);
-  RDAudioInfo::ErrorCode err_code;
-  
-  sql=QString("select CUTS.CUT_NAME,CUTS.CART_NUMBER,CUTS.LENGTH ")+
-    "from CUTS left join CART on CUTS.CART_NUMBER=CART.NUMBER "+
-    "where CART.GROUP_NAME=\""+groupname+"\" order by CART_NUMBER";
-  q=new RDSqlQuery(sql);
-  while(q->next()) {
-    if(q->value(2).toInt()>0) {
-      info->setCartNumber(q->value(1).toUInt());
-      info->setCutNumber(RDCut::cutNumber(q->value(0).toString()));
-      err_code=info->runInfo("user","");
-      switch(err_code) {
-      case RDAudioInfo::ErrorOk:
-	break;
-	
-      case RDAudioInfo::ErrorNoAudio:
-	cutnames->push_back(q->value(0).toString());
-	ret=false;
-	break;
-	
-      case RDAudioInfo::ErrorInternal:
-      case RDAudioInfo::ErrorUrlInvalid:
-      case RDAudioInfo::ErrorService:
-      case RDAudioInfo::ErrorInvalidUser:
-	ret=false;
-	break;
-      }
+
+  //
+  // Confirm the cuts not found locally through rdxport(8), so that a
+  // host without the audio store reports them as before
+  //
+  for(unsigned i=0;i<cuts->size();i++) {
+    CheckCut *cut=&cuts->at(i);
+    if(cut->missing) {
+      info->setCartNumber(cut->cart_number);
+      info->setCutNumber(RDCut::cutNumber(cut->cut_name));
+      cut->missing=info->runInfo("user","")==RDAudioInfo::ErrorNoAudio;
     }
   }
   delete info;
-  
-  return ret;
 }
 
 
@@ -2,7 +2,7 @@
 //
 // Check Rivendell Cuts for Valid Audio
 //
-//   (C) Copyright 2012-2018 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2012-2018,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -25,7 +25,19 @@
 
 #include <qobject.h>
 
-#define RDCHECKCUTS_USAGE "[options]\n\nCheck Rivendell cuts for valid audio\n\n--group=<group-name>\n     Name of group to scan.  This option may be given multiple times.\n     If no group is specified, then ALL groups will be scanned.\n"
+#define RDCHECKCUTS_USAGE "[options]\n\nCheck Rivendell cuts for valid audio\n\n--group=<group-name>\n     Name of group to scan.  This option may be given multiple times.\n     If no group is specified, then ALL groups will be scanned.\n\n--verify\n     Also check the format, sample rate, channels and length of the audio\n     against the database.\n\n--verify-hash\n     Also check the SHA1 hash of the audio against the database.  This\n     reads all of the audio, so is much slower.\n"
+
+//
+// Number of threads checking audio in the local audio store
+//
+#define RDCHECKCUTS_MAX_THREADS 8
+
+//
+// How far an end marker may lie past the end of the audio (mS)
+//
+#define RDCHECKCUTS_LENGTH_TOLERANCE 50
+
+class CheckCut;
 
 class MainObject : public QObject
 {
@@ -33,8 +45,11 @@ class MainObject : public QObject
   MainObject(QObject *parent=0);
 
  private:
-  void RenderCut(const QString &cutname);
-  bool ValidateGroup(const QString &groupname,std::vector<QString> *cutnames);
+  void RenderCut(const CheckCut &cut);
+  void CheckLocal(std::vector<CheckCut> *cuts);
+  void CheckRemote(std::vector<CheckCut> *cuts);
+  bool check_verify;
+  bool check_verify_hash;
 };
 
 
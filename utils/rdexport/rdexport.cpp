@@ -2,7 +2,7 @@
 //
 // A Batch Exporter for Rivendell.
 //
-//   (C) Copyright 2016-2018 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2016-2018,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -18,9 +18,16 @@
 //   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 //
 
+#include <errno.h>
+#include <pthread.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <list>
 
 #include <qapplication.h>
 #include <qdir.h>
@@ -32,9 +39,11 @@
 #include <rdaudioexport.h>
 #include <rdaudioinfo.h>
 #include <rdcart.h>
+#include <rdconf.h>
 #include <rdescape_string.h>
 #include <rdgroup.h>
 #include <rdschedcode.h>
+#include <rdwavedata.h>
 
 #include "rdexport.h"
 
@@ -53,6 +62,16 @@ MainObject::MainObject(QObject *parent)
   export_quality=3;
   export_xml=false;
   export_verbose=false;
+  export_manifest=NULL;
+  export_queue=NULL;
+  long cpus=sysconf(_SC_NPROCESSORS_ONLN);
+  if(cpus<1) {
+    cpus=1;
+  }
+  if(cpus>RDEXPORT_MAX_THREADS) {
+    cpus=RDEXPORT_MAX_THREADS;
+  }
+  export_threads=cpus;
 
   //
   // Open the Database
@@ -168,6 +187,10 @@ MainObject::MainObject(QObject *parent)
       export_schedcodes.push_back(rda->cmdSwitch()->value(i));
       rda->cmdSwitch()->setProcessed(i,true);
     }
+    if(rda->cmdSwitch()->key(i)=="--manifest") {
+      export_manifest_name=rda->cmdSwitch()->value(i);
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
     if(rda->cmdSwitch()->key(i)=="--metadata-pattern") {
       export_metadata_pattern=rda->cmdSwitch()->value(i);
       rda->cmdSwitch()->setProcessed(i,true);
@@ -190,6 +213,15 @@ MainObject::MainObject(QObject *parent)
       }
       rda->cmdSwitch()->setProcessed(i,true);
     }
+    if(rda->cmdSwitch()->key(i)=="--threads") {
+      bool ok=false;
+      export_threads=rda->cmdSwitch()->value(i).toUInt(&ok);
+      if((!ok)||(export_threads>RDEXPORT_MAX_THREADS)) {
+	fprintf(stderr,"rdexport: invalid --threads argument\n");
+	exit(256);
+      }
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
     if(rda->cmdSwitch()->key(i)=="--title") {
       export_titles.push_back(rda->cmdSwitch()->value(i));
       rda->cmdSwitch()->setProcessed(i,true);
@@ -215,6 +247,7 @@ MainObject::MainObject(QObject *parent)
     fprintf(stderr,"rdexport: no such output directory\n");
     exit(256);
   }
+  LoadManifest();
 
   //
   // Validate Group List
@@ -267,8 +300,151 @@ MainObject::MainObject(QObject *parent)
 }
 
 
+
+
+//
+// A cut to be transcoded from the local audio store
+//
+class ExportJob
+{
+ public:
+  QString cut_name;
+  QString src_file;
+  QString dst_file;
+  QString xml_file;
+  QString rdxl;
+  RDSettings settings;
+  RDWaveData wavedata;
+  float speed_ratio;
+};
+
+
+//
+// Shared state for the transcoding threads
+//
+class ExportQueue
+{
+ public:
+  std::list<ExportJob *> jobs;
+  bool finished;
+  bool aborting;
+  bool continue_after_error;
+  unsigned exported;
+  unsigned failed;
+  FILE *manifest;
+  pthread_mutex_t mutex;
+  pthread_cond_t job_ready;
+  pthread_cond_t job_taken;
+};
+
+
+class ExportThread
+{
+ public:
+  ExportQueue *queue;
+  RDAudioConvert *conv;
+  pthread_t thread;
+};
+
+
+//
+// Called with the queue mutex held
+//
+void __ExportReport(ExportQueue *queue,const QString &cutname,
+		    const QString &filename)
+{
+  QStringList f0=filename.split("/");
+  printf("%s\n",(const char *)f0.at(f0.size()-1).toUtf8());
+  fflush(stdout);
+  if(queue->manifest!=NULL) {
+    fprintf(queue->manifest,"%s\t%s\n",(const char *)cutname.toUtf8(),
+	    (const char *)filename.toUtf8());
+    fflush(queue->manifest);
+  }
+  queue->exported++;
+}
+
+
+void *__ExportThreadCallback(void *priv)
+{
+  ExportThread *thread=(ExportThread *)priv;
+  ExportQueue *queue=thread->queue;
+  ExportJob *job=NULL;
+  RDAudioConvert::ErrorCode err;
+  QString tmpfile;
+  FILE *f=NULL;
+
+  while(1) {
+    pthread_mutex_lock(&queue->mutex);
+    while(queue->jobs.empty()&&(!queue->finished)&&(!queue->aborting)) {
+      pthread_cond_wait(&queue->job_ready,&queue->mutex);
+    }
+    if(queue->aborting||queue->jobs.empty()) {
+      pthread_mutex_unlock(&queue->mutex);
+      return NULL;
+    }
+    job=queue->jobs.front();
+    queue->jobs.pop_front();
+    pthread_cond_signal(&queue->job_taken);
+    pthread_mutex_unlock(&queue->mutex);
+
+    //
+    // Transcode to a temporary name, so that an interrupted run never
+    // leaves a partial file under the final one
+    //
+    tmpfile=job->dst_file+".part";
+    thread->conv->setSourceFile(job->src_file);
+    thread->conv->setDestinationFile(tmpfile);
+    thread->conv->setDestinationSettings(&job->settings);
+    thread->conv->setDestinationWaveData(&job->wavedata);
+    thread->conv->setDestinationRdxl(job->rdxl);
+    thread->conv->setRange(-1,-1);
+    thread->conv->setSpeedRatio(job->speed_ratio);
+    if(((err=thread->conv->convert())==RDAudioConvert::ErrorOk)&&
+       (rename(tmpfile.toUtf8(),job->dst_file.toUtf8())!=0)) {
+      err=RDAudioConvert::ErrorInternal;
+    }
+    if((err==RDAudioConvert::ErrorOk)&&(!job->xml_file.isEmpty())) {
+      if((f=fopen(job->xml_file.toUtf8(),"w"))!=NULL) {
+	fprintf(f,"%s\n",(const char *)job->rdxl.toUtf8());
+	fclose(f);
+      }
+    }
+
+    pthread_mutex_lock(&queue->mutex);
+    if(err==RDAudioConvert::ErrorOk) {
+      __ExportReport(queue,job->cut_name,job->dst_file);
+    }
+    else {
+      unlink(tmpfile.toUtf8());
+      fprintf(stderr,"rdexport: exporter error for output file \"%s\" [%s]\n",
+	      (const char *)job->dst_file.toUtf8(),
+	      (const char *)RDAudioConvert::errorText(err).toUtf8());
+      queue->failed++;
+      if(!queue->continue_after_error) {
+	queue->aborting=true;
+	pthread_cond_broadcast(&queue->job_ready);
+	pthread_cond_broadcast(&queue->job_taken);
+      }
+    }
+    pthread_mutex_unlock(&queue->mutex);
+    delete job;
+  }
+  return NULL;
+}
+
+
 void MainObject::userData()
 {
+  QString sql;
+  RDSqlQuery *q;
+  RDCart *cart=NULL;
+  RDCut *cut=NULL;
+  float speed_ratio;
+  unsigned skipped=0;
+  bool aborting=false;
+  time_t start_time;
+
   //
   // Get User Context
   //
@@ -282,120 +458,209 @@ void MainObject::userData()
 	    (const char *)rda->user()->name().toUtf8());
     exit(256);
   }
-
-  //
-  // Process Titles
-  //
-  for(unsigned i=0;i<export_titles.size();i++) {
-    Verbose("Processing title \""+export_titles[i]+"\"...");
-    ExportTitle(export_titles[i]);
+  QString filter=CutFilter();
+  if(filter.isEmpty()) {
+    exit(0);
   }
 
   //
-  // Process Groups
+  // Find all of the cuts to export, with the same permission check
+  // as rdxport(8) makes for each one
   //
-  for(unsigned i=0;i<export_groups.size();i++) {
-    Verbose("Processing group \""+export_groups[i]+"\"...");
-    ExportGroup(export_groups[i]);
-  }
+  sql=QString("select ")+
+    "CUTS.CUT_NAME,"+          // 00
+    "CUTS.CART_NUMBER,"+       // 01
+    "CUTS.LENGTH,"+            // 02
+    "CART.FORCED_LENGTH,"+     // 03
+    "CART.ENFORCE_LENGTH,"+    // 04
+    "USER_PERMS.USER_NAME "+   // 05
+    "from CUTS left join CART "+
+    "on CUTS.CART_NUMBER=CART.NUMBER "+
+    "left join USER_PERMS "+
+    "on (CART.GROUP_NAME=USER_PERMS.GROUP_NAME)&&"+
+    "(USER_PERMS.USER_NAME=\""+RDEscapeString(rda->user()->name())+"\") "+
+    QString().sprintf("where (CART.TYPE=%u)&&(",RDCart::Audio)+filter+") "+
+    "order by CUTS.CART_NUMBER,CUTS.CUT_NAME";
+  q=new RDSqlQuery(sql);
+  Verbose(QString().sprintf("Found %d cut(s) to export",q->size()));
 
   //
-  // Process Scheduler Codes
+  // Cuts found in the local audio store are transcoded here by the
+  // thread pool, the rest are sent through rdxport(8)
   //
-  for(unsigned i=0;i<export_schedcodes.size();i++) {
-    Verbose("Processing scheduler code \""+export_schedcodes[i]+"\"...");
-    ExportSchedCode(export_schedcodes[i]);
+  StartThreads();
+  start_time=time(NULL);
+  while(q->next()&&(!aborting)) {
+    if(export_manifest_cuts.contains(q->value(0).toString())) {
+      skipped++;
+      continue;
+    }
+    if((cart==NULL)||(cart->number()!=q->value(1).toUInt())) {
+      delete cart;
+      cart=new RDCart(q->value(1).toUInt());
+    }
+    cut=new RDCut(q->value(0).toString());
+    speed_ratio=1.0;
+    if(RDBool(q->value(4).toString())&&(q->value(3).toUInt()>0)) {
+      speed_ratio=(float)q->value(2).toUInt()/(float)q->value(3).toUInt();
+    }
+    if(q->value(5).isNull()||(!QueueCut(cart,cut,speed_ratio))) {
+      ExportCut(cart,cut);
+    }
+    delete cut;
+    pthread_mutex_lock(&export_queue->mutex);
+    aborting=export_queue->aborting;
+    pthread_mutex_unlock(&export_queue->mutex);
   }
+  delete q;
+  delete cart;
+  StopThreads();
 
   //
-  // Process Cart Ranges
+  // Report Throughput
   //
-  for(unsigned i=0;i<export_start_carts.size();i++) {
-    for(unsigned j=export_start_carts[i];j<=export_end_carts[i];j++) {
-      ExportCart(j);
-    }
+  double minutes=(double)(time(NULL)-start_time)/60.0;
+  if(minutes<(1.0/60.0)) {
+    minutes=1.0/60.0;
   }
+  fprintf(stderr,"rdexport: %u cut(s) exported, %u failed, %u skipped, ",
+	  export_queue->exported,export_queue->failed,skipped);
+  fprintf(stderr,"%.1lf cuts/minute\n",
+	  (double)export_queue->exported/minutes);
 
   //
   // Clean Up and Exit
   //
+  if(export_manifest!=NULL) {
+    fclose(export_manifest);
+  }
+  if(export_queue->aborting) {
+    exit(256);
+  }
   exit(0);
 }
 
 
-void MainObject::ExportTitle(const QString &title)
+QString MainObject::CutFilter() const
 {
   QString sql;
-  RDSqlQuery *q;
 
-  sql=QString("select NUMBER from CART where ")+
-    "(TITLE=\""+RDEscapeString(title)+"\")&&"+
-    QString().sprintf("(TYPE=%u) ",RDCart::Audio)+
-    "order by NUMBER";
-  q=new RDSqlQuery(sql);
-  while(q->next()) {
-    ExportCart(q->value(0).toUInt());
+  for(unsigned i=0;i<export_titles.size();i++) {
+    sql+="(CART.TITLE=\""+RDEscapeString(export_titles[i])+"\")||";
   }
-  delete q;
+  for(unsigned i=0;i<export_groups.size();i++) {
+    sql+="(CART.GROUP_NAME=\""+RDEscapeString(export_groups[i])+"\")||";
+  }
+  for(unsigned i=0;i<export_schedcodes.size();i++) {
+    sql+=QString("(CART.NUMBER in (select CART_NUMBER ")+
+      "from CART_SCHED_CODES where "+
+      "SCHED_CODE=\""+RDEscapeString(export_schedcodes[i])+"\"))||";
+  }
+  for(unsigned i=0;i<export_start_carts.size();i++) {
+    sql+=QString().sprintf("((CART.NUMBER>=%u)&&(CART.NUMBER<=%u))||",
+			   export_start_carts[i],export_end_carts[i]);
+  }
+
+  return sql.left(sql.length()-2);
 }
 
 
-void MainObject::ExportGroup(const QString &groupname)
+bool MainObject::QueueCut(RDCart *cart,RDCut *cut,float speed_ratio)
 {
-  QString sql;
-  RDSqlQuery *q;
+  RDWaveFile::Format format=RDWaveFile::Pcm16;
 
-  sql=QString("select NUMBER from CART where ")+
-    "(GROUP_NAME=\""+RDEscapeString(groupname)+"\")&&"+
-    QString().sprintf("(TYPE=%u) ",RDCart::Audio)+
-    "order by NUMBER";
-  q=new RDSqlQuery(sql);
-  while(q->next()) {
-    ExportCart(q->value(0).toUInt());
+  if(export_threads==0) {
+    return false;
   }
-  delete q;
-}
 
+  //
+  // Get Audio Parameters, as rdxport(8) does
+  //
+  ExportJob *job=new ExportJob();
+  job->cut_name=cut->cutName();
+  job->src_file=RDCut::pathName(cut->cutName());
+  job->speed_ratio=speed_ratio;
+  RDWaveFile *wave=new RDWaveFile(job->src_file);
+  if(!wave->openWave()) {
+    delete wave;
+    delete job;
+    return false;
+  }
+  switch(wave->getFormatTag()) {
+  case WAVE_FORMAT_PCM:
+    format=RDWaveFile::Pcm16;
+    break;
+
+  case WAVE_FORMAT_IEEE_FLOAT:
+    format=RDWaveFile::Float32;
+    break;
+
+  case WAVE_FORMAT_MPEG:
+    switch(wave->getHeadLayer()) {
+    case 1:
+      format=RDWaveFile::MpegL1;
+      break;
 
-void MainObject::ExportSchedCode(const QString &schedcode)
-{
-  QString sql;
-  RDSqlQuery *q;
+    case 2:
+      format=RDWaveFile::MpegL2;
+      break;
 
-  sql=QString("select CART_NUMBER from CART_SCHED_CODES where ")+
-    "SCHED_CODE=\""+RDEscapeString(schedcode)+"\" "+
-    "order by CART_NUMBER";
-  q=new RDSqlQuery(sql);
-  while(q->next()) {
-    ExportCart(q->value(0).toUInt());
-  }
-  delete q;
-}
+    case 3:
+      format=RDWaveFile::MpegL3;
+      break;
+    }
+    break;
 
+  default:
+    wave->closeWave();
+    delete wave;
+    delete job;
+    return false;
+  }
+  bool ok=ExportSettings(&job->settings,format,wave->getChannels(),
+			 wave->getSamplesPerSec(),wave->getHeadBitRate());
+  wave->closeWave();
+  delete wave;
+  if(!ok) {
+    delete job;
+    return true;
+  }
+  Verbose(QString("exporting cart/cut ")+
+	  QString().sprintf("%06u/%03d",RDCut::cartNumber(cut->cutName()),
+		    RDCut::cutNumber(cut->cutName()))+" ["+cart->title()+"]");
 
-void MainObject::ExportCart(unsigned cartnum)
-{
-  RDCart *cart=new RDCart(cartnum);
-  QString sql;
-  RDSqlQuery *q;
+  //
+  // Metadata, for embedding and the XML sidecar
+  //
+  cart->getMetadata(&job->wavedata);
+  cut->getMetadata(&job->wavedata);
+  job->rdxl=cart->xml(true,true,&job->settings,cut->cutNumber());
+  job->dst_file=ResolveOutputName(cart,cut,
+		    RDSettings::defaultExtension(job->settings.format()));
+  if(export_xml) {
+    job->xml_file=SidecarName(job->dst_file);
+  }
 
-  if(cart->exists()&&(cart->type()==RDCart::Audio)) {
-    sql=QString().sprintf("select CUT_NAME from CUTS where CART_NUMBER=%u",
-			  cartnum);
-    q=new RDSqlQuery(sql);
-    while(q->next()) {
-      RDCut *cut=new RDCut(q->value(0).toString());
-      ExportCut(cart,cut);
-    }
-    delete q;
+  pthread_mutex_lock(&export_queue->mutex);
+  while((export_queue->jobs.size()>=(RDEXPORT_QUEUE_DEPTH*export_threads))&&
+	(!export_queue->aborting)) {
+    pthread_cond_wait(&export_queue->job_taken,&export_queue->mutex);
   }
-  delete cart;
+  if(export_queue->aborting) {
+    delete job;
+  }
+  else {
+    export_queue->jobs.push_back(job);
+    pthread_cond_signal(&export_queue->job_ready);
+  }
+  pthread_mutex_unlock(&export_queue->mutex);
+
+  return true;
 }
 
 
 void MainObject::ExportCut(RDCart *cart,RDCut *cut)
 {
-  RDAudioExport *conv=new RDAudioExport(this);
   RDAudioExport::ErrorCode export_err;
   RDAudioConvert::ErrorCode conv_err;
   RDAudioInfo::ErrorCode info_err;
@@ -410,107 +675,208 @@ void MainObject::ExportCut(RDCart *cart,RDCut *cut)
      RDAudioInfo::ErrorOk) {
     fprintf(stderr,"rdexport: error getting cut info [%s]\n",
 	    (const char *)RDAudioInfo::errorText(info_err).toUtf8());
-    if(export_continue_after_error) {
-      return;
-    }
-    else {
-      exit(256);
-    }
+    delete info;
+    ExportFailed();
+    return;
   }
   RDSettings settings;
+  if(!ExportSettings(&settings,info->format(),info->channels(),
+		     info->sampleRate(),info->bitRate())) {
+    delete info;
+    return;
+  }
+  delete info;
+  Verbose(QString("exporting cart/cut ")+
+	  QString().sprintf("%06u/%03d",RDCut::cartNumber(cut->cutName()),
+		    RDCut::cutNumber(cut->cutName()))+" ["+cart->title()+"]");
+  RDAudioExport *conv=new RDAudioExport(this);
+  conv->setCartNumber(cart->number());
+  conv->setCutNumber(RDCut::cutNumber(cut->cutName()));
+  conv->setDestinationSettings(&settings);
+  conv->setDestinationFile(ResolveOutputName(cart,cut,
+			   RDSettings::defaultExtension(settings.format())));
+  conv->setEnableMetadata(true);
+
+  if((export_err=conv->runExport(rda->user()->name(),rda->user()->password(),
+				 &conv_err))==RDAudioExport::ErrorOk) {
+    if(export_xml) {
+      FILE *f=NULL;
+      if((f=fopen(SidecarName(conv->destinationFile()),"w"))!=NULL) {
+	fprintf(f,"%s\n",
+		(const char *)cart->xml(true,true,&settings,cut->cutNumber()).
+		toUtf8());
+	fclose(f);
+      }
+    }
+    pthread_mutex_lock(&export_queue->mutex);
+    __ExportReport(export_queue,cut->cutName(),conv->destinationFile());
+    pthread_mutex_unlock(&export_queue->mutex);
+  }
+  else {
+    pthread_mutex_lock(&export_queue->mutex);
+    fprintf(stderr,"rdexport: exporter error for output file \"%s\" [%s]\n",
+	    (const char *)conv->destinationFile().toUtf8(),
+	    (const char *)RDAudioExport::errorText(export_err,conv_err).
+	    toUtf8());
+    pthread_mutex_unlock(&export_queue->mutex);
+    ExportFailed();
+  }
+
+  delete conv;
+}
+
+
+bool MainObject::ExportSettings(RDSettings *settings,
+				RDWaveFile::Format format,unsigned chans,
+				unsigned samprate,unsigned bitrate)
+{
   if(export_format.isEmpty()) {
-    switch(info->format()) {
+    switch(format) {
     case RDWaveFile::Pcm16:
-      settings.setFormat(RDSettings::Pcm16);
+      settings->setFormat(RDSettings::Pcm16);
       break;
 
     case RDWaveFile::Pcm24:
-      settings.setFormat(RDSettings::Pcm24);
+      settings->setFormat(RDSettings::Pcm24);
       break;
 
     case RDWaveFile::MpegL2:
-      settings.setFormat(RDSettings::MpegL2);
+      settings->setFormat(RDSettings::MpegL2);
       break;
 
     default:
       fprintf(stderr,"rdexport: unsupported source audio format\n");
-      if(export_continue_after_error) {
-	return;
-      }
-      else {
-	exit(256);
-      }
+      ExportFailed();
+      return false;
     }
   }
   else {
-    settings.setFormat(export_set_format);
+    settings->setFormat(export_set_format);
   }
   if(export_channels==0) {
-    settings.setChannels(info->channels());
+    settings->setChannels(chans);
   }
   else {
-    settings.setChannels(export_channels);
+    settings->setChannels(export_channels);
   }
   if(export_samplerate==0) {
-    settings.setSampleRate(info->sampleRate());
+    settings->setSampleRate(samprate);
   }
   else {
-    settings.setSampleRate(export_samplerate);
+    settings->setSampleRate(export_samplerate);
   }
   if(export_bitrate==0) {
-    if(info->bitRate()==0) {
-      settings.setBitRate(256000);
+    if(bitrate==0) {
+      settings->setBitRate(256000);
     }
     else {
-      settings.setBitRate(info->bitRate());
+      settings->setBitRate(bitrate);
     }
   }
   else {
-    settings.setBitRate(export_bitrate);
+    settings->setBitRate(export_bitrate);
   }
-  settings.setQuality(export_quality);
-  Verbose(QString("exporting cart/cut ")+
-	  QString().sprintf("%06u/%03d",RDCut::cartNumber(cut->cutName()),
-		    RDCut::cutNumber(cut->cutName()))+" ["+cart->title()+"]");
-  conv->setCartNumber(cart->number());
-  conv->setCutNumber(RDCut::cutNumber(cut->cutName()));
-  conv->setDestinationSettings(&settings);
-  conv->setDestinationFile(ResolveOutputName(cart,cut,
-			   RDSettings::defaultExtension(settings.format())));
-  conv->setEnableMetadata(true);
+  settings->setQuality(export_quality);
 
-  if((export_err=conv->runExport(rda->user()->name(),rda->user()->password(),
-				 &conv_err))==RDAudioExport::ErrorOk) {
-    QStringList f0=conv->destinationFile().split("/");
-    printf("%s\n",(const char *)f0.at(f0.size()-1).toUtf8());
-    if(export_xml) {
-      FILE *f=NULL;
-      f0=conv->destinationFile().split(".",QString::KeepEmptyParts);
-      QString filename;
-      for(int i=0;i<f0.size()-1;i++) {
-	filename+=f0[i]+".";
-      }
-      filename+="xml";
-      if((f=fopen(filename,"w"))!=NULL) {
-	fprintf(f,"%s\n",
-		(const char *)cart->xml(true,true,&settings,cut->cutNumber()).
-		toUtf8());
-	fclose(f);
-      }
-    }
+  return true;
+}
+
+
+void MainObject::ExportFailed()
+{
+  pthread_mutex_lock(&export_queue->mutex);
+  export_queue->failed++;
+  if(!export_continue_after_error) {
+    export_queue->aborting=true;
+    pthread_cond_broadcast(&export_queue->job_ready);
+    pthread_cond_broadcast(&export_queue->job_taken);
   }
-  else {
-    fprintf(stderr,"rdexport: exporter error for output file \"%s\" [%s]\n",
-	    (const char *)conv->destinationFile().toUtf8(),
-	    (const char *)RDAudioExport::errorText(export_err,conv_err).
-	    toUtf8());
-    if(!export_continue_after_error) {
-      exit(256);
+  pthread_mutex_unlock(&export_queue->mutex);
+}
+
+
+void MainObject::StartThreads()
+{
+  ExportThread *thread=NULL;
+
+  export_queue=new ExportQueue();
+  export_queue->finished=false;
+  export_queue->aborting=false;
+  export_queue->continue_after_error=export_continue_after_error;
+  export_queue->exported=0;
+  export_queue->failed=0;
+  export_queue->manifest=export_manifest;
+  pthread_mutex_init(&export_queue->mutex,NULL);
+  pthread_cond_init(&export_queue->job_ready,NULL);
+  pthread_cond_init(&export_queue->job_taken,NULL);
+
+  //
+  // The converters read their configuration from the database, so are
+  // created here rather than in the threads
+  //
+  for(unsigned i=0;i<export_threads;i++) {
+    thread=new ExportThread();
+    thread->queue=export_queue;
+    thread->conv=new RDAudioConvert();
+    if(pthread_create(&thread->thread,NULL,__ExportThreadCallback,
+		      thread)!=0) {
+      fprintf(stderr,"rdexport: unable to start transcoding thread [%s]\n",
+	      strerror(errno));
+      delete thread->conv;
+      delete thread;
+      export_threads=i;
+      break;
     }
+    export_pool.push_back(thread);
   }
+}
 
-  delete conv;
-  delete info;
+
+void MainObject::StopThreads()
+{
+  pthread_mutex_lock(&export_queue->mutex);
+  export_queue->finished=true;
+  pthread_cond_broadcast(&export_queue->job_ready);
+  pthread_mutex_unlock(&export_queue->mutex);
+  for(unsigned i=0;i<export_pool.size();i++) {
+    pthread_join(export_pool.at(i)->thread,NULL);
+    delete export_pool.at(i)->conv;
+    delete export_pool.at(i);
+  }
+  export_pool.clear();
+  while(!export_queue->jobs.empty()) {
+    delete export_queue->jobs.front();
+    export_queue->jobs.pop_front();
+  }
+}
+
+
+void MainObject::LoadManifest()
+{
+  FILE *f=NULL;
+  char line[1024];
+
+  if(export_manifest_name.isEmpty()) {
+    return;
+  }
+
+  //
+  // Cuts listed in the manifest were exported by an earlier run
+  //
+  if((f=fopen(export_manifest_name.toUtf8(),"r"))!=NULL) {
+    while(fgets(line,1024,f)!=NULL) {
+      QString cutname=QString::fromUtf8(line).split("\t").at(0).trimmed();
+      if(!cutname.isEmpty()) {
+	export_manifest_cuts.insert(cutname);
+      }
+    }
+    fclose(f);
+  }
+  if((export_manifest=fopen(export_manifest_name.toUtf8(),"a"))==NULL) {
+    fprintf(stderr,"rdexport: unable to open manifest \"%s\" [%s]\n",
+	    (const char *)export_manifest_name.toUtf8(),strerror(errno));
+    exit(256);
+  }
 }
 
 
@@ -521,17 +887,34 @@ QString MainObject::ResolveOutputName(RDCart *cart,RDCut *cut,
     RDLogLine::resolveWildcards(cart->number(),export_metadata_pattern,
 				cut->cutNumber());
   QString ret=SanitizePath(name);
-  if(!export_allow_clobber) {
-    int count=1;
-    while(QFile::exists(export_output_to+"/"+ret+"."+exten)) {
-      ret=name+QString().sprintf("[%d]",count++);
-    }
+
+  //
+  // Names given out earlier in this run may not have been written yet
+  //
+  int count=1;
+  while(((!export_allow_clobber)&&
+	 QFile::exists(export_output_to+"/"+ret+"."+exten))||
+	export_output_names.contains(ret+"."+exten)) {
+    ret=name+QString().sprintf("[%d]",count++);
   }
+  export_output_names.insert(ret+"."+exten);
 
   return export_output_to+"/"+ret+"."+exten;
 }
 
 
+QString MainObject::SidecarName(const QString &filename) const
+{
+  QStringList f0=filename.split(".",QString::KeepEmptyParts);
+  QString ret;
+
+  for(int i=0;i<f0.size()-1;i++) {
+    ret+=f0[i]+".";
+  }
+  return ret+"xml";
+}
+
+
 QString MainObject::SanitizePath(const QString &pathname) const
 {
   //
@@ -2,7 +2,7 @@
 //
 // A Batch Exporter for Rivendell.
 //
-//   (C) Copyright 2016-2018 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2016-2018,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -21,16 +21,33 @@
 #ifndef RDEXPORT_H
 #define RDEXPORT_H
 
+#include <stdio.h>
+
 #include <vector>
 
 #include <qobject.h>
+#include <qset.h>
 
 #include <rdcart.h>
 #include <rdcut.h>
 #include <rddb.h>
+#include <rdwavefile.h>
 
 #define RDEXPORT_USAGE "[options] <output-dir>\n"
 
+//
+// Maximum number of threads transcoding from the local audio store
+//
+#define RDEXPORT_MAX_THREADS 16
+
+//
+// Number of cuts queued ahead for each transcoding thread
+//
+#define RDEXPORT_QUEUE_DEPTH 4
+
+class ExportQueue;
+class ExportThread;
+
 class MainObject : public QObject
 {
   Q_OBJECT;
@@ -41,12 +58,17 @@ class MainObject : public QObject
   void userData();
 
  private:
-  void ExportTitle(const QString &title);
-  void ExportGroup(const QString &groupname);
-  void ExportSchedCode(const QString &schedcode);
-  void ExportCart(unsigned cartnum);
+  QString CutFilter() const;
+  bool QueueCut(RDCart *cart,RDCut *cut,float speed_ratio);
   void ExportCut(RDCart *cart,RDCut *cut);
+  bool ExportSettings(RDSettings *settings,RDWaveFile::Format format,
+		      unsigned chans,unsigned samprate,unsigned bitrate);
+  void ExportFailed();
+  void StartThreads();
+  void StopThreads();
+  void LoadManifest();
   QString ResolveOutputName(RDCart *cart,RDCut *cut,const QString &exten);
+  QString SidecarName(const QString &filename) const;
   QString SanitizePath(const QString &pathname) const;
   void Verbose(const QString &msg);
   std::vector<unsigned> export_start_carts;
@@ -67,6 +89,13 @@ class MainObject : public QObject
   QString export_escape_string;
   bool export_continue_after_error;
   bool export_allow_clobber;
+  unsigned export_threads;
+  QString export_manifest_name;
+  FILE *export_manifest;
+  QSet<QString> export_manifest_cuts;
+  QSet<QString> export_output_names;
+  ExportQueue *export_queue;
+  std::vector<ExportThread *> export_pool;
 };
 
 
@@ -2,7 +2,7 @@
 //
 // A Utility for running periodic system maintenance.
 //
-//   (C) Copyright 2008-2021 Fred Gleason <fredg@paravelsystems.com>
+//   (C) Copyright 2008-2021,2026 Fred Gleason <fredg@paravelsystems.com>
 //
 //   This program is free software; you can redistribute it and/or modify
 //   it under the terms of the GNU General Public License version 2 as
@@ -42,6 +42,7 @@
 #include <rdlog.h>
 #include <rdmaint.h>
 #include <rdpodcast.h>
+#include <rdpurgeengine.h>
 #include <rdrehash.h>
 #include <rdurl.h>
 
@@ -145,56 +146,20 @@ void MainObject::PurgeCuts()
 {
   PrintMessage("Starting PurgeCuts()");
 
-  QString sql;
-  RDSqlQuery *q;
-  RDSqlQuery *q1;
-  RDSqlQuery *q2;
-  QDateTime dt=QDateTime(QDate::currentDate(),QTime::currentTime());
+  QString err_msg;
+  RDPurgeEngine *engine=
+    new RDPurgeEngine(rda->station(),rda->user(),rda->config(),rda->ripc());
 
-  sql=QString("select ")+
-    "NAME,"+                // 00
-    "CUT_SHELFLIFE,"+       // 01
-    "DELETE_EMPTY_CARTS "+  // 02
-    "from GROUPS where "+
-    "CUT_SHELFLIFE>=0";
-  q=new RDSqlQuery(sql);
-  while(q->next()) {
-    sql=QString("select ")+
-      "CART.NUMBER,"+    // 00
-      "CUTS.CUT_NAME "+  // 01
-      "from CUTS left join CART "+
-      "on CUTS.CART_NUMBER=CART.NUMBER where "+
-      "(CART.GROUP_NAME=\""+RDEscapeString(q->value(0).toString())+"\")&&"+
-      "(CUTS.END_DATETIME<\""+
-      RDEscapeString(dt.addDays(-q->value(1).toInt()).toString("yyyy-MM-dd"))+
-      " 00:00:00\")";
-    q1=new RDSqlQuery(sql);
-    while(q1->next()) {
-      RDCart *cart=new RDCart(q1->value(0).toUInt());
-      if(cart->removeCut(rda->station(),rda->user(),q1->value(1).toString(),
-			 rda->config())) {
-	rda->syslog(LOG_INFO,"purged cut %s",
-		    (const char *)q1->value(1).toString().toUtf8());
-      }
-      else {
-	rda->syslog(LOG_WARNING,"unable to purge cut %s: audio deletion error",
-		    (const char *)q1->value(1).toString().toUtf8());
-      }
-      if(q->value(2).toString()=="Y") {  // Delete Empty Cart
-	sql=QString("select CUT_NAME from CUTS where ")+
-	  QString().sprintf("CART_NUMBER=%u",q1->value(0).toUInt());
-	q2=new RDSqlQuery(sql);
-	if(!q2->first()) {
-	  cart->remove(rda->station(),rda->user(),rda->config());
-	  rda->syslog(LOG_INFO,"deleted purged cart %06u",cart->number());
-	}
-	delete q2;
-      }
-      delete cart;
-    }
-    delete q1;
+  if(!engine->purgeCuts(QString(),&err_msg)) {
+    rda->syslog(LOG_WARNING,"cut purge failed [%s]",
+		(const char *)err_msg.toUtf8());
   }
-  delete q;
+  PrintMessage(QString().sprintf("Purged %u cuts, deleted %u carts, ",
+				 engine->cutsPurged(),engine->cartsDeleted())+
+	       QString().sprintf("%u failed, longest transaction %u mS",
+				 engine->cutsFailed(),
+				 (unsigned)(engine->maximumLockTime()/1000)));
+  delete engine;
 
   PrintMessage("Completed PurgeCuts()");
 }
@@ -230,24 +195,20 @@ void MainObject::PurgeElr()
 {
   PrintMessage("Starting PurgeElr()");
 
-  QString sql;
-  RDSqlQuery *q;
-  QDateTime dt=QDateTime(QDate::currentDate(),QTime::currentTime());
+  QString err_msg;
+  RDPurgeEngine *engine=
+    new RDPurgeEngine(rda->station(),rda->user(),rda->config(),rda->ripc());
 
-  sql=QString("select ")+
-    "NAME,"+
-    "ELR_SHELFLIFE "+
-    "from SERVICES where "+
-    "ELR_SHELFLIFE>=0";
-  q=new RDSqlQuery(sql);
-  while(q->next()) {
-    sql=QString("delete from ELR_LINES where ")+
-      "SERVICE_NAME=\""+RDEscapeString(q->value(0).toString())+"\" && "+
-      "EVENT_DATETIME<\""+
-      dt.addDays(-q->value(1).toInt()).toString("yyyy-MM-dd")+" 00:00:00\"";
-    RDSqlQuery::apply(sql);
+  if(!engine->purgeElr(QString(),&err_msg)) {
+    rda->syslog(LOG_WARNING,"ELR purge failed [%s]",
+		(const char *)err_msg.toUtf8());
   }
-  delete q;
+  PrintMessage(QString().sprintf("Purged %u ELR lines in %u batches, ",
+				 engine->elrLinesPurged(),
+				 engine->transactions())+
+	       QString().sprintf("longest batch %u mS",
+				 (unsigned)(engine->maximumLockTime()/1000)));
+  delete engine;
 
   PrintMessage("Completed PurgeElr()");
 }
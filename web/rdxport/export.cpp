@@ -20,21 +20,139 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <string.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
 
 #include <rdapplication.h>
 #include <rdaudioconvert.h>
 #include <rdcart.h>
 #include <rdconf.h>
+#include <rdexportcache.h>
 #include <rdformpost.h>
 #include <rdsettings.h>
 #include <rdtempdirectory.h>
+#include <rdwavefile.h>
 #include <rdweb.h>
 
 #include "rdxport.h"
 
+//
+// How often to check for new transcoded data when streamed (uS)
+//
+#define RDXPORT_EXPORT_STREAM_INTERVAL 50000
+
+struct ExportConversion {
+  RDAudioConvert *conv;
+  RDAudioConvert::ErrorCode err;
+  volatile bool finished;
+};
+
+
+void *ExportConversionCallback(void *ptr)
+{
+  struct ExportConversion *xc=(struct ExportConversion *)ptr;
+
+  xc->err=xc->conv->convert();
+  xc->finished=true;
+
+  return NULL;
+}
+
+
+QString ExportContentType(RDSettings::Format fmt)
+{
+  switch(fmt) {
+  case RDSettings::Pcm16:
+  case RDSettings::Pcm24:
+    return QString("audio/x-wav");
+
+  case RDSettings::MpegL1:
+  case RDSettings::MpegL2:
+  case RDSettings::MpegL2Wav:
+  case RDSettings::MpegL3:
+    return QString("audio/x-mpeg");
+
+  case RDSettings::OggVorbis:
+    return QString("audio/ogg");
+
+  case RDSettings::Flac:
+    return QString("audio/flac");
+  }
+  return QString("application/octet-stream");
+}
+
+
+bool ExportIsStreamable(RDSettings::Format fmt)
+{
+  //
+  // Formats whose encoders only ever append to the output file, and so
+  // can be sent to the client while the transcode is still in progress.
+  //
+  switch(fmt) {
+  case RDSettings::MpegL2:
+  case RDSettings::MpegL3:
+  case RDSettings::OggVorbis:
+    return true;
+
+  case RDSettings::Pcm16:
+  case RDSettings::Pcm24:
+  case RDSettings::MpegL1:
+  case RDSettings::MpegL2Wav:
+  case RDSettings::Flac:
+    break;
+  }
+  return false;
+}
+
+
+bool ExportSourceMatches(const QString &srcfile,RDSettings *s,
+			 int start_pt,int end_pt)
+{
+  bool ret=false;
+
+  RDWaveFile *wave=new RDWaveFile(srcfile);
+  if(!wave->openWave()) {
+    delete wave;
+    return false;
+  }
+  if((wave->getChannels()==s->channels())&&
+     (wave->getSamplesPerSec()==s->sampleRate())&&(start_pt<=0)&&
+     ((end_pt<0)||(end_pt>=(int)wave->getExtTimeLength()))) {
+    switch(s->format()) {
+    case RDSettings::Pcm16:
+      ret=(wave->getFormatTag()==WAVE_FORMAT_PCM)&&
+	(wave->getBitsPerSample()==16);
+      break;
+
+    case RDSettings::Pcm24:
+      ret=(wave->getFormatTag()==WAVE_FORMAT_PCM)&&
+	(wave->getBitsPerSample()==24);
+      break;
+
+    case RDSettings::MpegL2Wav:
+      ret=(wave->getFormatTag()==WAVE_FORMAT_MPEG)&&
+	(wave->getHeadLayer()==2)&&(wave->getHeadBitRate()==s->bitRate());
+      break;
+
+    case RDSettings::MpegL1:
+    case RDSettings::MpegL2:
+    case RDSettings::MpegL3:
+    case RDSettings::OggVorbis:
+    case RDSettings::Flac:
+      break;
+    }
+  }
+  wave->closeWave();
+  delete wave;
+
+  return ret;
+}
+
+
 void Xport::Export()
 {
   RDAudioConvert::ErrorCode conv_err=RDAudioConvert::ErrorOk;
@@ -134,58 +252,139 @@ void Xport::Export()
     delete cart;
   }
 
+  //
+  // Pass Through Source Audio That Already Matches
+  //
+  QString srcfile=RDCut::pathName(cartnum,cutnum);
+  if((wavedata==NULL)&&(normalization_level==0)&&(speed_ratio==1.0)&&
+     ExportSourceMatches(srcfile,settings,start_point,end_point)) {
+    printf("Content-type: %s\n\n",
+	   (const char *)ExportContentType(settings->format()).toUtf8());
+    fflush(NULL);
+    RDExportCache::sendFile(1,srcfile);
+    Exit(0);
+  }
+
+  //
+  // Check the Export Cache
+  //
+  QString cache_key;
+  RDExportCache *cache=new RDExportCache(rda->config()->exportCacheDirectory(),
+					 rda->config()->exportCacheSize());
+  if(cache->isEnabled()) {
+    RDCut *cut=new RDCut(cartnum,cutnum);
+    cache_key=RDExportCache::key(RDExportCache::sourceHash(cut->sha1Hash(),
+							   srcfile),
+				 settings,start_point,end_point,speed_ratio,
+				 rdxl);
+    delete cut;
+    if(cache->lookup(cache_key)) {
+      printf("Content-type: %s\n\n",
+	     (const char *)ExportContentType(settings->format()).toUtf8());
+      fflush(NULL);
+      RDExportCache::sendFile(1,cache->pathName(cache_key));
+      Exit(0);
+    }
+  }
+
   //
   // Export Cut
   //
-  int fd;
-  ssize_t n;
-  uint8_t data[2048];
   QString err_msg;
+  QString tmpfile;
   RDTempDirectory *tempdir=new RDTempDirectory("rdxport-export");
-  if(!tempdir->create(&err_msg)) {
-    XmlExit("unable to create temporary directory ["+err_msg+"]",500);
+  if(cache->isEnabled()) {
+    tmpfile=cache->tempPathName(cache_key);
   }
-  QString tmpfile=tempdir->path()+"/exported_audio";
+  else {
+    if(!tempdir->create(&err_msg)) {
+      XmlExit("unable to create temporary directory ["+err_msg+"]",500);
+    }
+    tmpfile=tempdir->path()+"/exported_audio";
+  }
+  unlink(tmpfile.toUtf8());
   RDAudioConvert *conv=new RDAudioConvert();
-  conv->setSourceFile(RDCut::pathName(cartnum,cutnum));
+  conv->setSourceFile(srcfile);
   conv->setDestinationFile(tmpfile);
   conv->setDestinationSettings(settings);
   conv->setDestinationWaveData(wavedata);
   conv->setDestinationRdxl(rdxl);
   conv->setRange(start_point,end_point);
   conv->setSpeedRatio(speed_ratio);
-  switch(conv_err=conv->convert()) {
-  case RDAudioConvert::ErrorOk:
-    switch(settings->format()) {
-    case RDSettings::Pcm16:
-    case RDSettings::Pcm24:
-      printf("Content-type: audio/x-wav\n\n");
-      break;
-
-    case RDSettings::MpegL1:
-    case RDSettings::MpegL2:
-    case RDSettings::MpegL2Wav:
-    case RDSettings::MpegL3:
-      printf("Content-type: audio/x-mpeg\n\n");
-      break;
-
-    case RDSettings::OggVorbis:
-      printf("Content-type: audio/ogg\n\n");
-      break;
+  bool streamed=false;
+  if((wavedata==NULL)&&ExportIsStreamable(settings->format())) {
+    //
+    // Send data to the client as the encoder produces it
+    //
+    pthread_t thread;
+    struct ExportConversion xc;
+    int fd=-1;
+    off_t offset=0;
+    struct stat st;
+    bool finished=false;
 
-    case RDSettings::Flac:
-      printf("Content-type: audio/flac\n\n");
-      break;
+    xc.conv=conv;
+    xc.err=RDAudioConvert::ErrorOk;
+    xc.finished=false;
+    if(pthread_create(&thread,NULL,ExportConversionCallback,&xc)!=0) {
+      XmlExit("unable to start conversion thread",500,"export.cpp",
+	      LINE_NUMBER);
     }
-    fflush(NULL);
-    if((fd=open(tmpfile,O_RDONLY))>=0) {
-      while((n=read(fd,data,2048))>0) {
-	write(1,data,n);
+    do {
+      finished=xc.finished;
+      if(fd<0) {
+	fd=open(tmpfile.toUtf8(),O_RDONLY);
+      }
+      if(fd>=0) {
+	memset(&st,0,sizeof(st));
+	if((fstat(fd,&st)==0)&&(st.st_size>offset)) {
+	  if(!streamed) {
+	    printf("Content-type: %s\n\n",
+		   (const char *)ExportContentType(settings->format()).toUtf8());
+	    fflush(NULL);
+	    streamed=true;
+	  }
+	  RDExportCache::sendFile(1,fd,&offset,st.st_size-offset);
+	}
+      }
+      if(!finished) {
+	usleep(RDXPORT_EXPORT_STREAM_INTERVAL);
       }
+    } while(!finished);
+    pthread_join(thread,NULL);
+    if(fd>=0) {
+      close(fd);
+    }
+    conv_err=xc.err;
+    if(streamed&&(conv_err!=RDAudioConvert::ErrorOk)) {
+      //
+      // Too late to send an error response, so all we can do is log it
+      //
+      rda->syslog(LOG_WARNING,"export of cut %06u_%03d failed mid-stream [%s]",
+		  cartnum,cutnum,
+		  (const char *)RDAudioConvert::errorText(conv_err).toUtf8());
+      cache->discard(tmpfile);
+      delete tempdir;
+      Exit(0);
+    }
+  }
+  else {
+    conv_err=conv->convert();
+  }
+  switch(conv_err) {
+  case RDAudioConvert::ErrorOk:
+    if(!streamed) {
+      printf("Content-type: %s\n\n",
+	     (const char *)ExportContentType(settings->format()).toUtf8());
+      fflush(NULL);
+      RDExportCache::sendFile(1,tmpfile);
+    }
+    if(cache->isEnabled()) {
+      cache->commit(tmpfile,cache_key);
+    }
+    else {
+      unlink(tmpfile.toUtf8());
     }
-    close(fd);
-    unlink(tmpfile);
-    //    rmdir(tmpdir);
     delete tempdir;
     Exit(0);
     break;
@@ -210,6 +409,8 @@ void Xport::Export()
     resp_code=500;
     break;
   }
+  cache->discard(tmpfile);
+  delete cache;
   delete conv;
   delete settings;
   if(wavedata!=NULL) {
@@ -469,12 +469,12 @@ void Xport::PostRss()
   }
 
   ret=PostRssElemental(feed,now,&err_msg);
-  delete feed;
 
   //
   // Update Enclosing Superfeeds
   //
   QStringList superfeeds=feed->isSubfeedOf();
+  delete feed;
   for(int i=0;i<superfeeds.size();i++) {
     QString err_msg2;
     RDFeed *feed=new RDFeed(superfeeds.at(i),rda->config(),this);